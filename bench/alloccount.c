@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#define BENCH_ALLOCCOUNT_NO_MACROS
+#include "alloccount.h"
+#include <stdatomic.h>
+
+/* Allocations made by the library, and the bytes they requested (the thread pool allocates from its threads too) */
+static atomic_size_t bench_allocations = 0;
+static atomic_size_t bench_bytes = 0;
+
+/**
+ * Counting version of malloc
+ */
+void* bench_malloc(size_t size) {
+
+	atomic_fetch_add_explicit(&bench_allocations, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&bench_bytes, size, memory_order_relaxed);
+	return malloc(size);
+}
+
+/**
+ * Counting version of calloc
+ */
+void* bench_calloc(size_t count, size_t size) {
+
+	atomic_fetch_add_explicit(&bench_allocations, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&bench_bytes, count * size, memory_order_relaxed);
+	return calloc(count, size);
+}
+
+/**
+ * Counting version of realloc, every call counts as an allocation
+ */
+void* bench_realloc(void* block, size_t size) {
+
+	atomic_fetch_add_explicit(&bench_allocations, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&bench_bytes, size, memory_order_relaxed);
+	return realloc(block, size);
+}
+
+/**
+ * Counting version of free, frees aren't counted
+ */
+void bench_free(void* block) {
+
+	free(block);
+	return;
+}
+
+/**
+ * Copies in allocations and bytes the number of allocations made so far, and the bytes they requested
+ */
+void bench_alloc_counters(size_t* allocations, size_t* bytes) {
+
+	if (allocations) *allocations = atomic_load_explicit(&bench_allocations, memory_order_relaxed);
+	if (bytes) *bytes = atomic_load_explicit(&bench_bytes, memory_order_relaxed);
+	return;
+}
\ No newline at end of file
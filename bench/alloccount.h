@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BENCH_ALLOCCOUNT__H
+#define BENCH_ALLOCCOUNT__H
+
+/**
+ * Header included (by the build, before anything else) in every source of the
+ * library built for the benchmarks, so that the allocations it makes can be counted
+ *
+ * stdlib.h is included first, then malloc and the others are replaced by
+ * functions that count the call and the requested bytes before calling them
+ */
+#include <stdlib.h>
+
+/**
+ * Counting versions of malloc, calloc, realloc and free
+ */
+void* bench_malloc(size_t size);
+void* bench_calloc(size_t count, size_t size);
+void* bench_realloc(void* block, size_t size);
+void bench_free(void* block);
+
+/**
+ * Copies in allocations and bytes the number of allocations made so far, and the bytes they requested
+ */
+void bench_alloc_counters(size_t* allocations, size_t* bytes);
+
+#ifndef BENCH_ALLOCCOUNT_NO_MACROS
+#define malloc(size) bench_malloc(size)
+#define calloc(count, size) bench_calloc(count, size)
+#define realloc(block, size) bench_realloc(block, size)
+#define free(block) bench_free(block)
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "bench.h"
+#define BENCH_ALLOCCOUNT_NO_MACROS
+#include "alloccount.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Sizes measured when none are given */
+#define BENCH_DEFAULT_SIZES "1000,10000,100000,1000000"
+
+/* The rounds of a size are enough to run this many operations, between 1 and BENCH_MAX_ROUNDS */
+#define BENCH_ROUND_OPS 1000000
+#define BENCH_MAX_ROUNDS 10
+
+/* Biggest number of sizes that can be given */
+#define BENCH_MAX_SIZES 32
+
+/**
+ * Measurement recorded by bench_stop, the fastest round is kept
+ */
+typedef struct bench_record {
+
+	const char* suite;
+	const char* op;
+	size_t n;
+	size_t ops;
+	uint64_t ns;
+	size_t allocations;
+	size_t bytes;
+} bench_record;
+
+/* Records of the size being measured */
+bench_record* bench_records = NULL;
+size_t bench_record_count = 0;
+size_t bench_record_capacity = 0;
+
+/* Round being run, the first one adds the records and the others keep the fastest */
+size_t bench_round = 0;
+
+/* Whether or not to print JSON lines */
+bool bench_json = false;
+
+volatile size_t bench_sink = 0;
+
+/* Utility function that returns the current time, in nanoseconds */
+uint64_t bench_util_now(void);
+
+/* Utility function that prints (and then drops) the records of the size that was measured */
+void bench_util_report(void);
+
+/* Utility function that reads the comma separated sizes in text, returns how many there are */
+size_t bench_util_parse_sizes(const char* text, size_t* sizes, size_t max);
+
+/**
+ * Runs every suite (whose name contains the filter, if given) on every size
+ *
+ * Options:
+ *   --json -> prints a JSON object per line instead of a table
+ *   --sizes a,b,c -> sizes to measure (default 1000,10000,100000,1000000)
+ *   --filter text -> only runs the suites whose name contains text
+ *   --rounds r -> runs every size r times (default: enough rounds for 10^6 operations, at most 10)
+ */
+int main(int argc, char** argv) {
+
+	size_t sizes[BENCH_MAX_SIZES];
+	size_t size_count = bench_util_parse_sizes(BENCH_DEFAULT_SIZES, sizes, BENCH_MAX_SIZES);
+	const char* filter = NULL;
+	size_t rounds = 0;
+
+	for (int i = 1; i < argc; i++) {
+
+		if (strcmp(argv[i], "--json") == 0) bench_json = true;
+		else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) size_count = bench_util_parse_sizes(argv[++i], sizes, BENCH_MAX_SIZES);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+		else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = (size_t)strtoull(argv[++i], NULL, 10);
+		else {
+
+			fprintf(stderr, "usage: %s [--json] [--sizes a,b,c] [--filter text] [--rounds r]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	size_t suite_count = 0;
+	const bench_suite* suites = bench_get_suites(&suite_count);
+
+	if (!bench_json) printf("%-24s %-10s %12s %14s %12s %14s\n", "suite", "op", "n", "ns/op", "allocs/op", "bytes/op");
+
+	for (size_t s = 0; s < suite_count; s++) {
+
+		if (filter && !strstr(suites[s].name, filter)) continue;
+
+		for (size_t i = 0; i < size_count; i++) {
+
+			size_t n = sizes[i];
+			if (n == 0 || n > suites[s].max_size) continue;
+
+			size_t r = rounds > 0 ? rounds : BENCH_ROUND_OPS / n;
+			if (rounds == 0 && r > BENCH_MAX_ROUNDS) r = BENCH_MAX_ROUNDS;
+			if (r == 0) r = 1;
+
+			for (bench_round = 0; bench_round < r; bench_round++) suites[s].run(n);
+			bench_util_report();
+			fflush(stdout);
+		}
+	}
+
+	free(bench_records);
+	return 0;
+}
+
+/**
+ * Starts measuring an operation
+ */
+void bench_start(bench_timer* t) {
+
+	bench_alloc_counters(&t->allocations, &t->bytes);
+	t->start = bench_util_now();
+	return;
+}
+
+/**
+ * Stops measuring the operation of the given suite, run ops times on a container of n elements, and records it
+ */
+void bench_stop(bench_timer* t, const char* suite, const char* op, size_t n, size_t ops) {
+
+	uint64_t end = bench_util_now();
+	bench_record record = { suite, op, n, ops > 0 ? ops : 1, end - t->start, 0, 0 };
+
+	bench_alloc_counters(&record.allocations, &record.bytes);
+	record.allocations -= t->allocations;
+	record.bytes -= t->bytes;
+
+	// Later rounds only replace the record of the same operation if they were faster
+	for (size_t i = 0; i < bench_record_count; i++) {
+
+		bench_record* old = &bench_records[i];
+		if (strcmp(old->suite, suite) == 0 && strcmp(old->op, op) == 0 && old->n == n) {
+
+			if (record.ns * old->ops < old->ns * record.ops) *old = record;
+			return;
+		}
+	}
+
+	if (bench_record_count == bench_record_capacity) {
+
+		size_t capacity = bench_record_capacity ? bench_record_capacity * 2 : 16;
+		bench_record* records = (bench_record*)realloc(bench_records, capacity * sizeof(bench_record));
+		if (!records) return;
+
+		bench_records = records;
+		bench_record_capacity = capacity;
+	}
+	bench_records[bench_record_count++] = record;
+	return;
+}
+
+/**
+ * Returns the numbers from 0 to n - 1 in random order (the same on every run), to be freed by the caller
+ */
+size_t* bench_shuffled(size_t n, uint64_t seed) {
+
+	size_t* numbers = (size_t*)malloc((n > 0 ? n : 1) * sizeof(size_t));
+
+	if (numbers) {
+
+		for (size_t i = 0; i < n; i++) numbers[i] = i;
+
+		// Fisher-Yates shuffle
+		for (size_t i = n; i > 1; i--) {
+
+			size_t j = (size_t)(bench_random(&seed) % i);
+			size_t tmp = numbers[i - 1];
+			numbers[i - 1] = numbers[j];
+			numbers[j] = tmp;
+		}
+	}
+	return numbers;
+}
+
+/**
+ * Returns the next number of the random sequence whose state is pointed to by state (splitmix64)
+ */
+uint64_t bench_random(uint64_t* state) {
+
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/* Utility function that returns the current time, in nanoseconds */
+uint64_t bench_util_now(void) {
+
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Prints (and then drops) the records of the size that was measured, as a table or as JSON lines
+ */
+void bench_util_report(void) {
+
+	for (size_t i = 0; i < bench_record_count; i++) {
+
+		bench_record* r = &bench_records[i];
+		double ns = (double)r->ns / (double)r->ops;
+		double allocations = (double)r->allocations / (double)r->ops;
+		double bytes = (double)r->bytes / (double)r->ops;
+
+		if (bench_json) {
+
+			printf("{\"suite\":\"%s\",\"op\":\"%s\",\"n\":%zu,\"ops\":%zu,\"ns_per_op\":%.3f,\"allocs_per_op\":%.4f,\"bytes_per_op\":%.2f}\n",
+				r->suite, r->op, r->n, r->ops, ns, allocations, bytes);
+		}
+		else printf("%-24s %-10s %12zu %14.2f %12.4f %14.2f\n", r->suite, r->op, r->n, ns, allocations, bytes);
+	}
+	bench_record_count = 0;
+	return;
+}
+
+/* Utility function that reads the comma separated sizes in text, returns how many there are */
+size_t bench_util_parse_sizes(const char* text, size_t* sizes, size_t max) {
+
+	size_t count = 0;
+
+	while (*text && count < max) {
+
+		char* end = NULL;
+		unsigned long long n = strtoull(text, &end, 10);
+
+		if (end == text) break;
+		sizes[count++] = (size_t)n;
+		text = *end == ',' ? end + 1 : end;
+	}
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BENCH__H
+#define BENCH__H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Microbenchmark harness
+ *
+ * Every benchmark executable is made of the harness (bench.c) and one file of suites,
+ * a suite measures the operations of a container on n elements, one timer per operation;
+ * the harness runs each suite on every size (more rounds for the small ones, keeping the
+ * fastest) and reports ns/op, allocations/op and bytes allocated/op, as text or JSON lines
+ */
+
+/**
+ * A suite: name of the container, function that measures its operations on n elements
+ * and biggest n it's run on (SIZE_MAX if there's no limit)
+ */
+typedef struct bench_suite {
+
+	const char* name;
+	void (*run)(size_t n);
+	size_t max_size;
+} bench_suite;
+
+/**
+ * State of a measurement: start time and counters of the allocations made by the library
+ */
+typedef struct bench_timer {
+
+	uint64_t start;
+	size_t allocations;
+	size_t bytes;
+} bench_timer;
+
+/**
+ * Returns the suites of the executable, and their number in count
+ *
+ * Defined by the file of suites each benchmark executable is built with
+ */
+const bench_suite* bench_get_suites(size_t* count);
+
+/**
+ * Starts measuring an operation
+ */
+void bench_start(bench_timer* t);
+
+/**
+ * Stops measuring the operation of the given suite, run ops times on a container of n elements, and records it
+ */
+void bench_stop(bench_timer* t, const char* suite, const char* op, size_t n, size_t ops);
+
+/**
+ * Returns the numbers from 0 to n - 1 in random order (the same on every run), to be freed by the caller
+ */
+size_t* bench_shuffled(size_t n, uint64_t seed);
+
+/**
+ * Returns the next number of the random sequence whose state is pointed to by state
+ */
+uint64_t bench_random(uint64_t* state);
+
+/**
+ * Value the results of the measured operations are added to, so the compiler can't drop them
+ */
+extern volatile size_t bench_sink;
+
+#endif
\ No newline at end of file
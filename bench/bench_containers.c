@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "bench.h"
+#include "../include/linear/vector.h"
+#include "../include/linear/ringbuffer.h"
+#include "../include/linear/bitset.h"
+#include "../include/linear/skiplist.h"
+#include "../include/non-linear/hashmap.h"
+#include "../include/non-linear/BST.h"
+#include "../include/non-linear/AVL.h"
+
+/* Levels of the skip lists, enough for 2^32 elements with probability 1/2 */
+#define BENCH_SKIPLIST_LEVELS 32
+
+/* Sum of the elements visited by the callbacks of the iterations */
+size_t bench_total = 0;
+
+/* Utility functions used by the suites: comparison of two size_t, and callback that adds the element to bench_total */
+int bench_util_compare(void* a, void* b);
+void bench_util_add(void* x);
+
+/* Suites, each one measures its container on n elements */
+void bench_vector(size_t n);
+void bench_hashmap(size_t n);
+void bench_hashmap_interned(size_t n);
+void bench_skiplist(size_t n);
+void bench_BST(size_t n);
+void bench_AVL(size_t n);
+void bench_ringbuffer(size_t n);
+void bench_bitset(size_t n);
+
+/**
+ * Returns the suites of the containers, and their number in count
+ */
+const bench_suite* bench_get_suites(size_t* count) {
+
+	static const bench_suite suites[] = {
+
+		{ "vector", bench_vector, SIZE_MAX },
+		{ "hashmap", bench_hashmap, SIZE_MAX },
+		{ "hashmap_interned", bench_hashmap_interned, SIZE_MAX },
+		{ "skiplist", bench_skiplist, SIZE_MAX },
+		{ "BST", bench_BST, SIZE_MAX },
+		{ "AVL", bench_AVL, SIZE_MAX },
+		{ "ringbuffer", bench_ringbuffer, SIZE_MAX },
+		{ "bitset", bench_bitset, SIZE_MAX }
+	};
+
+	*count = sizeof(suites) / sizeof(suites[0]);
+	return suites;
+}
+
+/**
+ * Vector: push_back from an empty vector, random reads, for_each, pop_back
+ */
+void bench_vector(size_t n) {
+
+	bench_timer t;
+	size_t* order = bench_shuffled(n, 1);
+	vector* v = vec_create(1, sizeof(size_t));
+	size_t sum = 0;
+
+	if (order && v) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) vec_push_back(v, &i);
+		bench_stop(&t, "vector", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += *(size_t*)vec_get_at(v, order[i]);
+		bench_stop(&t, "vector", "lookup", n, n);
+
+		bench_start(&t);
+		vec_for_each(v, bench_util_add);
+		bench_stop(&t, "vector", "iterate", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) vec_pop_back(v);
+		bench_stop(&t, "vector", "delete", n, n);
+	}
+
+	vec_delete(&v);
+	free(order);
+	bench_sink += sum + bench_total;
+	return;
+}
+
+/**
+ * Hashmap: insertion of keys in random order (from a small table), lookups in another order, removals
+ *
+ * Keys are the 8 bytes of a size_t, the hashmap takes the keys it's given (and frees them)
+ * so every key is copied beforehand, outside of the measurement; the hashmap has no iteration
+ */
+void bench_hashmap(size_t n) {
+
+	bench_timer t;
+	size_t* numbers = bench_shuffled(n, 2);
+	size_t* order = bench_shuffled(n, 3);
+	size_t** keys = (size_t**)calloc(n > 0 ? n : 1, sizeof(size_t*));
+	hashmap* h = hash_create(16, sizeof(size_t));
+	size_t sum = 0;
+	size_t copied = 0;
+
+	if (numbers && order && keys) {
+
+		while (copied < n && (keys[copied] = (size_t*)malloc(sizeof(size_t)))) {
+
+			*keys[copied] = numbers[copied];
+			copied++;
+		}
+	}
+
+	if (copied == n && h) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) hash_put_n(h, keys[i], sizeof(size_t), &i);
+		bench_stop(&t, "hashmap", "insert", n, n);
+		copied = 0;
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) {
+
+			size_t* value = (size_t*)hash_get_n(h, &order[i], sizeof(size_t));
+			if (value) sum += *value;
+		}
+		bench_stop(&t, "hashmap", "lookup", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) hash_remove_n(h, &order[i], sizeof(size_t));
+		bench_stop(&t, "hashmap", "delete", n, n);
+	}
+
+	// Keys that didn't get in the hashmap
+	for (size_t i = 0; i < copied; i++) free(keys[i]);
+
+	hash_delete(&h);
+	free(keys);
+	free(numbers);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * Hashmap that interns its keys: the same operations of bench_hashmap, the keys are
+ * read straight from the shuffled numbers since the hashmap copies them (in the slots)
+ */
+void bench_hashmap_interned(size_t n) {
+
+	bench_timer t;
+	size_t* numbers = bench_shuffled(n, 2);
+	size_t* order = bench_shuffled(n, 3);
+	hashmap* h = hash_create_interned(16, sizeof(size_t));
+	size_t sum = 0;
+
+	if (numbers && order && h) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) hash_put_n(h, &numbers[i], sizeof(size_t), &i);
+		bench_stop(&t, "hashmap_interned", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) {
+
+			size_t* value = (size_t*)hash_get_n(h, &order[i], sizeof(size_t));
+			if (value) sum += *value;
+		}
+		bench_stop(&t, "hashmap_interned", "lookup", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) hash_remove_n(h, &order[i], sizeof(size_t));
+		bench_stop(&t, "hashmap_interned", "delete", n, n);
+	}
+
+	hash_delete(&h);
+	free(numbers);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * Skip list: insertion in random order, searches in another order, iteration, removals
+ */
+void bench_skiplist(size_t n) {
+
+	bench_timer t;
+	size_t* keys = bench_shuffled(n, 4);
+	size_t* order = bench_shuffled(n, 5);
+	skiplist* sl = sl_create(sizeof(size_t), BENCH_SKIPLIST_LEVELS, 0.5, bench_util_compare);
+	size_t sum = 0;
+
+	if (keys && order && sl) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sl_insert(sl, &keys[i]);
+		bench_stop(&t, "skiplist", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += sl_search(sl, &order[i]) != NULL;
+		bench_stop(&t, "skiplist", "lookup", n, n);
+
+		sl_iterator it;
+		bench_start(&t);
+		sl_iterator_init(sl, &it, NULL, NULL);
+		while (sl_iterator_has_next(&it)) sum += *(size_t*)sl_iterator_next(&it);
+		bench_stop(&t, "skiplist", "iterate", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sl_remove(sl, &order[i]);
+		bench_stop(&t, "skiplist", "delete", n, n);
+	}
+
+	sl_delete(&sl);
+	free(keys);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * BST: insertion in random order, searches in another order, in order iteration, removals
+ */
+void bench_BST(size_t n) {
+
+	bench_timer t;
+	size_t* keys = bench_shuffled(n, 6);
+	size_t* order = bench_shuffled(n, 7);
+	BST* bst = BST_create(sizeof(size_t), bench_util_compare);
+	size_t sum = 0;
+
+	if (keys && order && bst) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) BST_insert(bst, &keys[i]);
+		bench_stop(&t, "BST", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += BST_search(bst, &order[i]) != NULL;
+		bench_stop(&t, "BST", "lookup", n, n);
+
+		BST_iterator it;
+		bench_start(&t);
+		BST_iterator_init(bst, &it, NULL, NULL);
+		while (BST_iterator_has_next(&it)) sum += *(size_t*)BST_iterator_next(&it);
+		bench_stop(&t, "BST", "iterate", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) BST_remove(bst, &order[i]);
+		bench_stop(&t, "BST", "delete", n, n);
+	}
+
+	BST_delete(&bst);
+	free(keys);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * AVL: insertion in random order, searches in another order, in order iteration, removals
+ */
+void bench_AVL(size_t n) {
+
+	bench_timer t;
+	size_t* keys = bench_shuffled(n, 8);
+	size_t* order = bench_shuffled(n, 9);
+	AVL* avl = AVL_create(sizeof(size_t), bench_util_compare);
+	size_t sum = 0;
+
+	if (keys && order && avl) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) AVL_insert(avl, &keys[i]);
+		bench_stop(&t, "AVL", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += AVL_search(avl, &order[i]) != NULL;
+		bench_stop(&t, "AVL", "lookup", n, n);
+
+		AVL_iterator it;
+		bench_start(&t);
+		AVL_iterator_init(avl, &it, NULL, NULL);
+		while (AVL_iterator_has_next(&it)) sum += *(size_t*)AVL_iterator_next(&it);
+		bench_stop(&t, "AVL", "iterate", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) AVL_remove(avl, &order[i]);
+		bench_stop(&t, "AVL", "delete", n, n);
+	}
+
+	AVL_delete(&avl);
+	free(keys);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * Ring buffer: enqueue until full, peek, dequeue until empty, then the same with the batch functions
+ */
+void bench_ringbuffer(size_t n) {
+
+	bench_timer t;
+	ringbuffer* r = ring_create(n, sizeof(size_t));
+	size_t* buf = (size_t*)malloc(n * sizeof(size_t));
+	size_t sum = 0;
+
+	if (r && buf) {
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) ring_enqueue(r, &i);
+		bench_stop(&t, "ringbuffer", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += *(size_t*)ring_peek(r);
+		bench_stop(&t, "ringbuffer", "lookup", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) {
+
+			size_t x;
+			ring_deque_2(r, &x);
+			sum += x;
+		}
+		bench_stop(&t, "ringbuffer", "delete", n, n);
+
+		for (size_t i = 0; i < n; i++) buf[i] = i;
+
+		bench_start(&t);
+		ring_enqueue_n(r, buf, n);
+		bench_stop(&t, "ringbuffer", "insert_n", n, n);
+
+		bench_start(&t);
+		ring_deque_n(r, buf, n);
+		bench_stop(&t, "ringbuffer", "delete_n", n, n);
+	}
+
+	ring_delete(&r);
+	free(buf);
+	bench_sink += sum;
+	return;
+}
+
+/**
+ * Bitset: setting bits in random order, reads in another order, iteration over the set bits, unsetting
+ */
+void bench_bitset(size_t n) {
+
+	bench_timer t;
+	size_t* bits = bench_shuffled(n, 10);
+	size_t* order = bench_shuffled(n, 11);
+	bitset* b = bitset_create(n);
+	size_t sum = 0;
+
+	if (bits && order && b) {
+
+		// Every other bit, so that the iteration has something to skip
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) if (bits[i] % 2 == 0) bitset_set(b, bits[i]);
+		bench_stop(&t, "bitset", "insert", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) sum += bitset_get(b, order[i]);
+		bench_stop(&t, "bitset", "lookup", n, n);
+
+		bench_start(&t);
+		for (size_t i = bitset_find_first(b); i < n; i = bitset_find_next(b, i)) sum += i;
+		bench_stop(&t, "bitset", "iterate", n, n);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) bitset_unset(b, order[i]);
+		bench_stop(&t, "bitset", "delete", n, n);
+	}
+
+	bitset_delete(&b);
+	free(bits);
+	free(order);
+	bench_sink += sum;
+	return;
+}
+
+/* Utility function that compares two size_t */
+int bench_util_compare(void* a, void* b) {
+
+	size_t x = *(size_t*)a, y = *(size_t*)b;
+	return (x > y) - (x < y);
+}
+
+/* Utility function that adds the element to bench_total */
+void bench_util_add(void* x) {
+
+	bench_total += *(size_t*)x;
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "bench.h"
+#include "../include/non-linear/graph.h"
+
+/**
+ * Suite of the graph, built once per engine: the build defines the engine
+ * (GRAPH_WITH_...), the name of the suite and the biggest size it's run on,
+ * and BENCH_GRAPH_NO_TRAVERSAL for the engines that don't implement the traversal
+ */
+#ifndef BENCH_GRAPH_NAME
+#define BENCH_GRAPH_NAME "graph"
+#endif
+
+#ifndef BENCH_GRAPH_MAX_SIZE
+#define BENCH_GRAPH_MAX_SIZE SIZE_MAX
+#endif
+
+/* Average number of arches of every node */
+#define BENCH_GRAPH_DEGREE 8
+
+/* Arches searched and removed at most, removing costs O(arches) with some engines */
+#define BENCH_GRAPH_SAMPLE 1000
+
+/* Sum of the nodes visited by the traversal */
+size_t bench_total = 0;
+
+/* Utility function that adds the node to bench_total */
+void bench_util_add(void* x);
+
+/* Suite of the graph, on n arches between n / BENCH_GRAPH_DEGREE nodes */
+void bench_graph(size_t n);
+
+/**
+ * Returns the suite of the graph engine the executable was built with
+ */
+const bench_suite* bench_get_suites(size_t* count) {
+
+	static const bench_suite suites[] = {
+
+		{ BENCH_GRAPH_NAME, bench_graph, BENCH_GRAPH_MAX_SIZE }
+	};
+
+	*count = sizeof(suites) / sizeof(suites[0]);
+	return suites;
+}
+
+/**
+ * Graph (not oriented, not weighted): insertion of the nodes and of n random arches,
+ * searches and removals of a sample of them, breadth-first traversal
+ */
+void bench_graph(size_t n) {
+
+	bench_timer t;
+	size_t nodes = n / BENCH_GRAPH_DEGREE > 2 ? n / BENCH_GRAPH_DEGREE : 2;
+	size_t sample = n < BENCH_GRAPH_SAMPLE ? n : BENCH_GRAPH_SAMPLE;
+	size_t* labels = bench_shuffled(nodes, 13);
+	size_t* ends = (size_t*)malloc(2 * n * sizeof(size_t));
+	graph* g = graph_create(sizeof(size_t), 0);
+	uint64_t seed = 12;
+	size_t found = 0;
+
+	if (labels && ends && g) {
+
+		// Ends of the arches, as positions in labels (the edge list keeps the pointers it's given)
+		for (size_t i = 0; i < 2 * n; i++) ends[i] = (size_t)(bench_random(&seed) % nodes);
+
+		bench_start(&t);
+		for (size_t i = 0; i < nodes; i++) graph_insert_node(g, &labels[i]);
+		bench_stop(&t, BENCH_GRAPH_NAME, "insert_node", n, nodes);
+
+		bench_start(&t);
+		for (size_t i = 0; i < n; i++) graph_insert_arch(g, &labels[ends[2 * i]], &labels[ends[2 * i + 1]], 1);
+		bench_stop(&t, BENCH_GRAPH_NAME, "insert", n, n);
+
+		// Engines that build their rows lazily (CSR) do it here, outside of the measured searches
+		graph_search_arch(g, &labels[ends[0]], &labels[ends[1]]);
+
+		bench_start(&t);
+		for (size_t i = 0; i < sample; i++) found += graph_search_arch(g, &labels[ends[2 * i]], &labels[ends[2 * i + 1]]) != NULL;
+		bench_stop(&t, BENCH_GRAPH_NAME, "lookup", n, sample);
+
+#ifndef BENCH_GRAPH_NO_TRAVERSAL
+		bench_start(&t);
+		graph_BFS(g, bench_util_add);
+		bench_stop(&t, BENCH_GRAPH_NAME, "iterate", n, nodes);
+#endif
+
+		bench_start(&t);
+		for (size_t i = 0; i < sample; i++) graph_remove_arch(g, &labels[ends[2 * i]], &labels[ends[2 * i + 1]]);
+		bench_stop(&t, BENCH_GRAPH_NAME, "delete", n, sample);
+	}
+
+	graph_delete(&g);
+	free(labels);
+	free(ends);
+	bench_sink += found + bench_total;
+	return;
+}
+
+/* Utility function that adds the node to bench_total */
+void bench_util_add(void* x) {
+
+	bench_total += *(size_t*)x;
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+# Runs the benchmark executables (BENCH_EXECUTABLES, separated by |) on BENCH_SIZES
+#
+# Without BENCH_OUTPUT the tables are printed, with it the executables are run
+# with --json and their lines are written in BENCH_OUTPUT
+
+string(REPLACE "|" ";" executables "${BENCH_EXECUTABLES}")
+
+if(DEFINED BENCH_OUTPUT)
+	file(WRITE ${BENCH_OUTPUT} "")
+endif()
+
+foreach(executable IN LISTS executables)
+	if(DEFINED BENCH_OUTPUT)
+		execute_process(COMMAND ${executable} --json --sizes ${BENCH_SIZES} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+		file(APPEND ${BENCH_OUTPUT} "${output}")
+	else()
+		execute_process(COMMAND ${executable} --sizes ${BENCH_SIZES} RESULT_VARIABLE result)
+	endif()
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "${executable} failed: ${result}")
+	endif()
+endforeach()
+
+if(DEFINED BENCH_OUTPUT)
+	message(STATUS "Results written in ${BENCH_OUTPUT}")
+endif()
\ No newline at end of file
@@ -7,7 +7,7 @@
  */
 
 #ifndef BITSET__H
-#define BITSED__H
+#define BITSET__H
 
 #include <stdint.h>
 #include <stddef.h>
@@ -44,7 +44,7 @@ void bitset_set_full(bitset* b);
 void bitset_unset(bitset* b, size_t i);
 
 /**
- *  Sets all the bits of the set to 1
+ *  Sets all the bits of the set to 0
  */
 void bitset_unset_full(bitset* b);
 
@@ -65,12 +65,94 @@ void bitset_toggle_full(bitset* b);
 
 /**
  *  Returns the number of positive bits in the set
+ *
+ *  The value is cached, so this is O(1)
  */
 size_t bitset_count(bitset* b);
 
 /**
- *  Toggles the number of bits in the set
+ *  Counts again the positive bits in the set, a word at a time, and returns them
+ */
+size_t bitset_recount(bitset* b);
+
+/**
+ *  Returns the number of positive bits in the range [from, to)
+ */
+size_t bitset_count_range(bitset* b, size_t from, size_t to);
+
+/**
+ *  Sets all the bits in the range [from, to) to 1
+ */
+void bitset_set_range(bitset* b, size_t from, size_t to);
+
+/**
+ *  Sets all the bits in the range [from, to) to 0
+ */
+void bitset_unset_range(bitset* b, size_t from, size_t to);
+
+/**
+ *  Returns the number of bits in the set
  */
 size_t bitset_get_size(bitset* b);
 
-#endif
+/**
+ *  Returns the position of the first bit set to 1 starting from the given one (included),
+ *  or the size of the set if there's none
+ *
+ *  Whole words are skipped at a time, so iterating the positive bits
+ *  costs one step per word plus one per positive bit
+ */
+size_t bitset_next_set(bitset* b, size_t from);
+
+/**
+ *  Changes the number of bits in the set, the new bits are set to 0
+ */
+void bitset_resize(bitset* b, size_t size);
+
+/**
+ *  Sets to 0 every bit of the set that's 0 in other (b = b & other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_and(bitset* b, bitset* other);
+
+/**
+ *  Sets to 1 every bit of the set that's 1 in other (b = b | other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_or(bitset* b, bitset* other);
+
+/**
+ *  Toggles every bit of the set that's 1 in other (b = b ^ other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_xor(bitset* b, bitset* other);
+
+/**
+ *  Sets to 0 every bit of the set that's 1 in other (b = b & ~other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_and_not(bitset* b, bitset* other);
+
+/**
+ *  Returns the position of the first bit set to 1, or the size of the set if there's none
+ */
+size_t bitset_find_first(bitset* b);
+
+/**
+ *  Returns the position of the first bit set to 1 after the given one (excluded),
+ *  or the size of the set if there's none
+ */
+size_t bitset_find_next(bitset* b, size_t i);
+
+/**
+ *  Calls f with the position of every bit set to 1, in increasing order
+ *
+ *  f must not modify the set
+ */
+void bitset_for_each_set(bitset* b, void (*f)(size_t));
+
+#endif
\ No newline at end of file
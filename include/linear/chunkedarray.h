@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CHUNKEDARRAY__H
+#define CHUNKEDARRAY__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/**
+ * Struct that represent a chunked array (deque of blocks) that can store
+ * a generic type value
+ *
+ * Elements live in fixed size blocks, reached from a circular map of block pointers,
+ * so insertions and removals at both ends are O(1) and never move the elements
+ *
+ * A block that becomes empty is kept as a spare and reused by the next block
+ * that's needed, so a structure that grows and shrinks around the same size
+ * never reaches the allocator
+ */
+typedef struct chunkedarray chunkedarray;
+
+/**
+ * Creates a chunked array ready to store elements that are as big as the given size
+ */
+chunkedarray* ca_create(size_t element_size);
+
+/**
+ * Creates a chunked array whose first block, big enough for inline_length elements,
+ * is stored in the same allocation as the chunked array itself
+ *
+ * The length of every block becomes inline_length, rounded up to a power of two
+ * (and capped to the usual block length), so it suits structures that stay small
+ */
+chunkedarray* ca_create_inline(size_t element_size, size_t inline_length);
+
+/**
+ * Deletes the given chunked array, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for every block is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void ca_delete(chunkedarray** ca);
+
+/**
+ * Inserts a copy of the element pointed to by x before the first element
+ */
+void ca_push_front(chunkedarray* ca, void* x);
+
+/**
+ * Inserts a copy of the element pointed to by x after the last element
+ */
+void ca_push_back(chunkedarray* ca, void* x);
+
+/**
+ * Removes the first element, copying it in the given buffer (if it's not NULL)
+ */
+void ca_pop_2_front(chunkedarray* ca, void* buf);
+
+/**
+ * Removes the last element, copying it in the given buffer (if it's not NULL)
+ */
+void ca_pop_2_back(chunkedarray* ca, void* buf);
+
+/**
+ * Returns a pointer to the first element, NULL if there are none
+ */
+void* ca_get_front(chunkedarray* ca);
+
+/**
+ * Returns a pointer to the last element, NULL if there are none
+ */
+void* ca_get_back(chunkedarray* ca);
+
+/**
+ * Returns a pointer to the element at the given position (0 is the first element),
+ * NULL if the position is out of bounds
+ */
+void* ca_get_at(chunkedarray* ca, size_t i);
+
+/**
+ * Returns the number of elements inside the chunked array
+ */
+size_t ca_get_size(chunkedarray* ca);
+
+/**
+ * Returns the size of each element of the chunked array
+ */
+size_t ca_get_element_size(chunkedarray* ca);
+
+/**
+ * Removes every element from the chunked array
+ * (the struct itself is not deleted)
+ */
+void ca_clear(chunkedarray* ca);
+
+/**
+ * Checks whether or not the chunked array is empty
+ */
+bool ca_is_empty(chunkedarray* ca);
+
+#endif
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "stats.h"
 
  /**
   * Struct that represent a circular list of elements of a generic type value
@@ -107,6 +108,12 @@ size_t cl_get_size(clinkedlist* cl);
  */
 size_t cl_get_element_size(clinkedlist* cl);
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void cl_get_stats(clinkedlist* cl, node_stats* stats);
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
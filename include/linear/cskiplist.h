@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CSKIPLIST__H
+#define CSKIPLIST__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "stats.h"
+
+/* Most levels a concurrent skip list can have */
+#define CSL_MAX_LEVELS 32
+
+/**
+ * Struct that represent a skip list of elements of a generic type value that
+ * any number of threads can read and modify at the same time, without locks
+ *
+ * Nodes are linked with compare and swap, they're removed by first marking their
+ * pointers (logical deletion) and then unlinking them; every thread that finds a marked
+ * node on its way helps unlinking it
+ *
+ * Unlinked nodes are freed only once no thread can still be looking at them (epoch based reclamation),
+ * levels are drawn from a random generator that each thread has for itself
+ *
+ * Two elements that the compare function considers equal are the same element, the list holds at most one of them
+ */
+typedef struct cskiplist cskiplist;
+
+/**
+ * Creates a concurrent skip list ready to store elements that are as big as the given size
+ *
+ * max_levels is capped at CSL_MAX_LEVELS
+ */
+cskiplist* csl_create(size_t element_size, size_t max_levels, double probability, int (*cmp)(void*, void*));
+
+/**
+ * Deletes the given list, no other thread can be using it
+ */
+void csl_delete(cskiplist** csl);
+
+/**
+ * Inserts the element pointed to by x in the list
+ *
+ * Returns whether or not it was inserted (false if an equal element is already in the list)
+ */
+bool csl_insert(cskiplist* csl, void* x);
+
+/**
+ * Removes x from the list (if present)
+ *
+ * Returns whether or not it was removed by this call
+ */
+bool csl_remove(cskiplist* csl, void* x);
+
+/**
+ * Checks if the element pointed to by x is present in the list
+ */
+bool csl_contains(cskiplist* csl, void* x);
+
+/**
+ * Copies the element equal to x in the buffer
+ *
+ * Returns whether or not there was such an element, pointers to the elements aren't
+ * given out since another thread could remove (and free) them at any time
+ */
+bool csl_search_2(cskiplist* csl, void* x, void* buf);
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side; elements inserted or removed by
+ * other threads during the traversal may or may not be visited, the pointer given
+ * to the callback is only valid during the call
+ */
+void csl_range(cskiplist* csl, void* lo, void* hi, void (*callback)(void*));
+
+/**
+ * Returns the number of elements of the list (a snapshot, if other threads are modifying it)
+ */
+size_t csl_get_size(cskiplist* csl);
+
+/**
+ * Returns the size of the elements of the list
+ */
+size_t csl_get_element_size(cskiplist* csl);
+
+/**
+ * Checks whether the list contains at least one element or not
+ */
+bool csl_is_empty(cskiplist* csl);
+
+/**
+ * Removes every element from the list, no other thread can be using it
+ * (the list struct itself is not deleted)
+ */
+void csl_clear(cskiplist* csl);
+
+/**
+ * Copies in stats the allocation counters of the nodes of the list, the sentinel included
+ * (always zero unless built with CDS_WITH_STATS, nodes in use aswell)
+ *
+ * Each node is allocated on its own, so every allocation is also a chunk; removed nodes
+ * are in use until they're freed, once no thread can be looking at them
+ */
+void csl_get_stats(cskiplist* csl, node_stats* stats);
+
+#endif
\ No newline at end of file
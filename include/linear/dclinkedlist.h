@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "stats.h"
 
  /**
   * Struct that represent a double linked circular list of elements of a generic type value
@@ -107,6 +108,12 @@ size_t dcl_get_size(dclinkedlist* dcl);
  */
 size_t dcl_get_element_size(dclinkedlist* dcl);
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void dcl_get_stats(dclinkedlist* dcl, node_stats* stats);
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
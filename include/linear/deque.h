@@ -9,6 +9,7 @@
 #ifndef deque__H
 #define deque__H
 
+#include <stdlib.h>
 #include <stdbool.h>
 
  /**
@@ -50,6 +51,8 @@ void* deque_pop_front(deque* d);
 
 /**
  * Removes the first element of the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void deque_pop_2_front(deque* d, void* buf);
 
@@ -60,6 +63,8 @@ void* deque_pop_back(deque* d);
 
 /**
  * Removes the last element of the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void deque_pop_2_back(deque* d, void* buf);
 
@@ -11,12 +11,33 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "stats.h"
 
  /**
   * Struct that represent a double linked list of elements of a generic type value
   */
 typedef struct dlinkedlist dlinkedlist;
 
+/**
+ * Struct used to walk the list in order, inserting and removing elements on the way in O(1)
+ *
+ * It's meant to be declared by the caller (for example on the stack) and initialized
+ * with dll_iter_begin, its fields shouldn't be modified directly; the list must not be
+ * modified while it's being walked, other than through the iterator
+ */
+typedef struct dll_iterator {
+
+	/* List being walked */
+	dlinkedlist* list;
+
+	/* Node holding the next element, and the one holding the last element returned (NULL if there's none) */
+	void* node;
+	void* last;
+
+	/* Index of the next element */
+	size_t index;
+} dll_iterator;
+
 /**
  *  Creates a double linked list ready to store elements that are as big as the given size
  */
@@ -63,6 +84,8 @@ void dll_remove_tail(dlinkedlist* dll);
 
 /**
  * Returns a pointer to the i -th element of the list
+ *
+ * The list remembers the last position it reached, so accessing the elements in order costs O(1) each
  */
 void* dll_get_at(dlinkedlist* dll, size_t i);
 
@@ -107,6 +130,12 @@ size_t dll_get_size(dlinkedlist* dll);
  */
 size_t dll_get_element_size(dlinkedlist* dll);
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void dll_get_stats(dlinkedlist* dll, node_stats* stats);
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -132,10 +161,48 @@ void dll_clear(dlinkedlist* dll);
  */
 void dll_for_each(dlinkedlist* dll, void (*f)(void*));
 
+/**
+ * Applies the function f to every element of the double linked list dll, using (at most) the given number of threads
+ *
+ * The positions of the elements are collected first, then they're split in chunks
+ * handled by the threads, f gets a copy of the element (like in dll_for_each)
+ * and is called by many threads at the same time, so it must be thread safe
+ */
+void dll_parallel_for_each(dlinkedlist* dll, void (*f)(void*), size_t threads);
+
 /**
  * Returns a double linked list obtained by applying
  * the function f to every element of the original list dll
  */
 dlinkedlist* dll_map(dlinkedlist* dll, void* (*f)(void*));
 
+/**
+ * Initializes the iterator so that it starts from the head of the list
+ */
+void dll_iter_begin(dlinkedlist* dll, dll_iterator* it);
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool dll_iter_has_next(dll_iterator* it);
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* dll_iter_next(dll_iterator* it);
+
+/**
+ * Inserts the element pointed to by x before the next element (at the end, if there's none)
+ *
+ * The next element returned is still the one that would have been returned before
+ */
+void dll_iter_insert(dll_iterator* it, void* x);
+
+/**
+ * Removes the last element returned by dll_iter_next
+ *
+ * It can be done once per element returned, and not after an insertion
+ */
+void dll_iter_remove(dll_iterator* it);
+
 #endif
\ No newline at end of file
@@ -10,6 +10,7 @@
 #define DNODE__H
 
 #include <stdlib.h>
+#include "pool.h"
 
 /**
  * Struct that represent a node that can store
@@ -21,6 +22,8 @@
  * The node itself has three components, a value stored,
  * a pointer to the next node in the list, and a pointer
  * to the previous node
+ *
+ * The value is stored right after the struct, in the same allocation
  */
 typedef struct dnode dnode;
 
@@ -32,14 +35,36 @@ typedef struct dnode dnode;
  */
 dnode* dnode_create(void* value, size_t value_size);
 
+/**
+ * Creates a node like dnode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least dnode_get_footprint(value_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+dnode* dnode_create_in(pool* p, void* value, size_t value_size);
+
 /**
  * Deletes the given node
- * 
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ *
+ * The value is stored with the struct
+ * so a single free releases both
  */
 void dnode_delete(dnode** dn);
 
+/**
+ * Deletes the given node, created by dnode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void dnode_delete_in(pool* p, dnode** dn);
+
+/**
+ * Returns the number of bytes used by a node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t dnode_get_footprint(size_t value_size);
+
 /**
  * Returns a pointer to the value stored in the
  * node
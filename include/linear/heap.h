@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef HEAP__H
+#define HEAP__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Id returned when the heap is empty */
+#define HEAP_NO_ID ((size_t)-1)
+
+/**
+ * Struct that represent an indexed heap (min priority queue) of ids
+ *
+ * Every id (an integer in [0, n), usually the index of something stored elsewhere)
+ * is in the heap at most once with its priority, the position of each id is tracked
+ * so its priority can be changed in O(log n) (decrease key)
+ *
+ * Each node has 4 children, so the tree is shallower and the children of a node
+ * share a cache line, which makes sifting faster than with a binary heap
+ */
+typedef struct heap heap;
+
+/**
+ * Creates a heap with room for the ids in [0, capacity), bigger ids make it grow
+ */
+heap* heap_create(size_t capacity);
+
+/**
+ * Deletes the given heap, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for the ids and their positions is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void heap_delete(heap** h);
+
+/**
+ * Inserts the id with the given priority, if it's already in the heap its priority is replaced
+ */
+void heap_push(heap* h, size_t id, double priority);
+
+/**
+ * Lowers the priority of the id to the given one, or inserts it if it's not in the heap
+ *
+ * Returns whether or not the priority changed (false if the id already had a lower, or the same, priority)
+ */
+bool heap_decrease_key(heap* h, size_t id, double priority);
+
+/**
+ * Removes the id with the lowest priority and returns it, HEAP_NO_ID if the heap is empty
+ *
+ * Its priority is copied in the given buffer (if it's not NULL)
+ */
+size_t heap_pop(heap* h, double* priority);
+
+/**
+ * Returns the id with the lowest priority without removing it, HEAP_NO_ID if the heap is empty
+ *
+ * Its priority is copied in the given buffer (if it's not NULL)
+ */
+size_t heap_peek(heap* h, double* priority);
+
+/**
+ * Removes the given id from the heap
+ */
+void heap_remove(heap* h, size_t id);
+
+/**
+ * Checks whether or not the id is in the heap
+ */
+bool heap_contains(heap* h, size_t id);
+
+/**
+ * Returns the priority of the id, 0 if it's not in the heap
+ */
+double heap_get_priority(heap* h, size_t id);
+
+/**
+ * Returns the number of ids in the heap
+ */
+size_t heap_get_size(heap* h);
+
+/**
+ * Removes every id from the heap
+ * (the heap struct itself is not deleted)
+ */
+void heap_clear(heap* h);
+
+/**
+ * Checks whether or not the heap is empty
+ */
+bool heap_is_empty(heap* h);
+
+#endif
\ No newline at end of file
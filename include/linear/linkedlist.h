@@ -11,17 +11,56 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "stats.h"
 
  /**
   * Struct that represent a list of elements of a generic type value
+  *
+  * Two engines implement this interface:
+  *   default -> one element per node (linkedlist.c)
+  *   LINKEDLIST_WITH_UNROLLED_NODES -> nodes of up to 256 bytes holding an array of elements each (unrolledlinkedlist.c)
   */
 typedef struct linkedlist linkedlist;
 
+/**
+ * Struct used to walk the list in order, inserting and removing elements on the way in O(1)
+ *
+ * It's meant to be declared by the caller (for example on the stack) and initialized
+ * with ll_iter_begin, its fields shouldn't be modified directly; the list must not be
+ * modified while it's being walked, other than through the iterator
+ */
+typedef struct ll_iterator {
+
+	/* List being walked */
+	linkedlist* list;
+
+	/* Nodes holding the next element, the one before it and the one before that (NULL if there's none, or they aren't known) */
+	void* node;
+	void* prev;
+	void* before;
+
+	/* Position of the next element within its node (nodes hold more elements with the unrolled engine) */
+	size_t offset;
+
+	/* Index of the next element */
+	size_t index;
+
+	/* Whether the last element returned can be removed */
+	bool removable;
+} ll_iterator;
+
 /**
  *  Creates a linked list ready to store elements that are as big as the given size
  */
 linkedlist* ll_create(size_t element_size);
 
+/**
+ * Creates a linked list whose first inline_length nodes are stored in the same allocation as their pool
+ *
+ * A list that never holds more than inline_length elements doesn't allocate its nodes one by one
+ */
+linkedlist* ll_create_inline(size_t element_size, size_t inline_length);
+
 /**
  * Deletes the given list, since memory is allocated dinamically
  * the following actions are performed:
@@ -63,6 +102,8 @@ void ll_remove_tail(linkedlist* ll);
 
 /**
  * Returns a pointer to the i -th element of the list
+ *
+ * The list remembers the last position it reached, so accessing the elements in order costs O(1) each
  */
 void* ll_get_at(linkedlist* ll, size_t i);
 
@@ -107,6 +148,14 @@ size_t ll_get_size(linkedlist* ll);
  */
 size_t ll_get_element_size(linkedlist* ll);
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * With unrolled nodes a node holds more than one element
+ */
+void ll_get_stats(linkedlist* ll, node_stats* stats);
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -132,10 +181,57 @@ void ll_clear(linkedlist* ll);
  */
 void ll_for_each(linkedlist* ll, void (*f)(void*));
 
+/**
+ * Applies the function f to every element of the linked list ll, using (at most) the given number of threads
+ *
+ * The positions of the elements are collected first, then they're split in chunks
+ * handled by the threads, f gets a copy of the element (like in ll_for_each)
+ * and is called by many threads at the same time, so it must be thread safe
+ */
+void ll_parallel_for_each(linkedlist* ll, void (*f)(void*), size_t threads);
+
+/**
+ * Sorts the elements of the list according to the compare function, equal elements keep their order
+ *
+ * Bottom-up merge sort that relinks the existing nodes, so it takes O(n log n) time and no extra memory
+ * (the unrolled engine sorts each node in place and merges the sorted runs of nodes, reusing the nodes
+ * it empties, it only needs three spare nodes, and the list is left unchanged if they can't be allocated)
+ */
+void ll_sort(linkedlist* ll, int (*compare)(void*, void*));
+
 /**
  * Returns a linked list obtained by applying
  * the function f to every element of the original list ll
  */
 linkedlist* ll_map(linkedlist* ll, void* (*f)(void*));
 
+/**
+ * Initializes the iterator so that it starts from the head of the list
+ */
+void ll_iter_begin(linkedlist* ll, ll_iterator* it);
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool ll_iter_has_next(ll_iterator* it);
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* ll_iter_next(ll_iterator* it);
+
+/**
+ * Inserts the element pointed to by x before the next element (at the end, if there's none)
+ *
+ * The next element returned is still the one that would have been returned before
+ */
+void ll_iter_insert(ll_iterator* it, void* x);
+
+/**
+ * Removes the last element returned by ll_iter_next
+ *
+ * It can be done once per element returned, and not after an insertion
+ */
+void ll_iter_remove(ll_iterator* it);
+
 #endif
\ No newline at end of file
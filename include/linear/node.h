@@ -10,6 +10,7 @@
 #define NODE__H
 
 #include <stdlib.h>
+#include "pool.h"
 
 /**
  * Struct that represent a node that can store
@@ -19,6 +20,8 @@
  * 
  * The node itself has two components, a value stored, and
  * a pointer to the next node in the list
+ *
+ * The value is stored right after the struct, in the same allocation
  */
 typedef struct node node;
 
@@ -30,14 +33,36 @@ typedef struct node node;
  */
 node* node_create(void* value, size_t value_size);
 
+/**
+ * Creates a node like node_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least node_get_footprint(value_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+node* node_create_in(pool* p, void* value, size_t value_size);
+
 /**
  * Deletes the given node
- * 
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ *
+ * The value is stored with the struct
+ * so a single free releases both
  */
 void node_delete(node** n);
 
+/**
+ * Deletes the given node, created by node_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void node_delete_in(pool* p, node** n);
+
+/**
+ * Returns the number of bytes used by a node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t node_get_footprint(size_t value_size);
+
 /**
  * Returns a pointer to the value stored in the
  * node
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PARALLEL__H
+#define PARALLEL__H
+
+#include <stdlib.h>
+
+/**
+ * Chunked parallel loop, used by the parallel operations of the containers
+ *
+ * The indices from 0 to n are split in chunks of grain indices, the calling
+ * thread and threads - 1 tasks of the shared thread pool (threadpool.h) repeatedly
+ * take the next chunk that nobody took yet, so that threads that get cheaper chunks
+ * simply take more of them
+ */
+
+/* Body of a parallel loop, applied to the indices from 'from' (included) to 'to' (excluded) */
+typedef void (*parallel_body)(void* context, size_t from, size_t to);
+
+/**
+ * Applies body to every chunk of grain indices from 0 to n (the last one can be shorter),
+ * using at most the given number of threads, and returns when every chunk is done
+ *
+ * The body can be called at the same time on different chunks, so it must only write
+ * data that belongs to its chunk. The chunks are always the same (however many threads
+ * run them), with a single thread (or without the shared pool) they're run in order by
+ * the calling one, which also runs other queued tasks while it waits for the last chunks
+ */
+void parallel_util_for(size_t n, size_t grain, size_t threads, parallel_body body, void* context);
+
+#endif
\ No newline at end of file
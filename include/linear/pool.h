@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef POOL__H
+#define POOL__H
+
+#include <stdlib.h>
+#include "stats.h"
+
+/**
+ * Struct that represent a pool (slab allocator) of fixed size blocks
+ *
+ * Memory is requested from malloc in chunks holding many blocks,
+ * blocks are handed out one at a time and freed blocks are kept
+ * in a free list to be reused, so that most allocations never reach malloc
+ *
+ * A container that owns a pool can release all of its blocks
+ * at once with pool_clear, without visiting them
+ */
+typedef struct pool pool;
+
+/**
+ * Creates a pool that hands out blocks that are (at least) block_size bytes big
+ *
+ * Every block is aligned to POOL_ALIGNMENT
+ */
+pool* pool_create(size_t block_size);
+
+/**
+ * Creates a pool whose first chunk, with room for the given number of blocks,
+ * is stored in the same allocation as the pool itself
+ *
+ * Containers that stay that small never reach malloc for their nodes
+ */
+pool* pool_create_inline(size_t block_size, size_t blocks);
+
+/**
+ * Deletes the given pool, every chunk is freed
+ * so every block still in use becomes invalid
+ */
+void pool_delete(pool** p);
+
+/**
+ * Returns a block of memory, NULL if it couldn't be allocated
+ */
+void* pool_alloc(pool* p);
+
+/**
+ * Gives the block back to the pool, to be reused by later allocations
+ *
+ * The block must have been returned by pool_alloc on the same pool
+ */
+void pool_free(pool* p, void* block);
+
+/**
+ * Releases every block at once, the chunks are kept to be reused
+ * so the cost depends only on the number of chunks
+ */
+void pool_clear(pool* p);
+
+/**
+ * Returns the size of the blocks, after alignment
+ */
+size_t pool_get_block_size(pool* p);
+
+/**
+ * Returns the number of blocks currently in use
+ */
+size_t pool_get_count(pool* p);
+
+/**
+ * Adds the counters of the pool to stats, so that a container can sum the ones of all its pools
+ *
+ * Blocks released by pool_clear count as given back
+ */
+void pool_add_stats(pool* p, node_stats* stats);
+
+#endif
\ No newline at end of file
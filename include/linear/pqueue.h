@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PQUEUE__H
+#define PQUEUE__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Handle returned when an element couldn't be inserted */
+#define PQ_NO_HANDLE SIZE_MAX
+
+/**
+ * Struct that represent a priority queue of elements of generic type
+ *
+ * Elements come out in the order given by the compare function (the smallest first,
+ * pass a reversed compare function for a max queue), like in the BST it returns
+ * a negative value if the first element is smaller than the second
+ *
+ * The queue is a d-ary heap (d is 2 or 4) layed out in a vector: with 4 children
+ * the tree is half as deep and the children of a node are next to each other,
+ * which makes pops cheaper on big queues
+ *
+ * Every inserted element gets a handle, that stays the same while the element moves
+ * in the heap, so that its priority can be changed in O(log n) (decrease key)
+ */
+typedef struct pqueue pqueue;
+
+/**
+ * Creates a priority queue that stores elements that are as big as element_size,
+ * ordered by the compare function, in a heap where every node has arity (2 or 4) children
+ */
+pqueue* pq_create(size_t element_size, int (*compare)(void*, void*), size_t arity);
+
+/**
+ * Deletes the given priority queue
+ */
+void pq_delete(pqueue** pq);
+
+/**
+ * Inserts a copy of the element pointed to by x, and returns its handle (PQ_NO_HANDLE if it couldn't be inserted)
+ */
+size_t pq_push(pqueue* pq, void* x);
+
+/**
+ * Inserts the n elements (that are contiguous) pointed to by elements at once, and builds
+ * the heap again bottom-up, which takes O(n + size) time instead of O(n log(n + size))
+ *
+ * If handles isn't NULL the handle of each element is stored in it
+ */
+void pq_build(pqueue* pq, void* elements, size_t n, size_t* handles);
+
+/**
+ * Removes the first element
+ */
+void pq_pop(pqueue* pq);
+
+/**
+ * Removes the first element and copies it in the given buffer
+ */
+void pq_pop_2(pqueue* pq, void* buf);
+
+/**
+ * Returns a pointer to the first element, NULL if the queue is empty
+ *
+ * The element must not be modified in a way that changes its order (see pq_update)
+ */
+void* pq_peek(pqueue* pq);
+
+/**
+ * Returns the handle of the first element, PQ_NO_HANDLE if the queue is empty
+ */
+size_t pq_peek_handle(pqueue* pq);
+
+/**
+ * Replaces the element with the given handle with the one pointed to by x, only if x comes before it
+ *
+ * Returns whether or not the element was replaced
+ */
+bool pq_decrease_key(pqueue* pq, size_t handle, void* x);
+
+/**
+ * Replaces the element with the given handle with the one pointed to by x, whatever their order
+ */
+void pq_update(pqueue* pq, size_t handle, void* x);
+
+/**
+ * Removes the element with the given handle
+ */
+void pq_remove(pqueue* pq, size_t handle);
+
+/**
+ * Returns a pointer to the element with the given handle, NULL if it's not in the queue
+ */
+void* pq_get(pqueue* pq, size_t handle);
+
+/**
+ * Checks whether or not the element with the given handle is in the queue
+ *
+ * Handles of elements that left the queue are given to new elements
+ */
+bool pq_contains(pqueue* pq, size_t handle);
+
+/**
+ * Returns the number of elements in the queue
+ */
+size_t pq_get_size(pqueue* pq);
+
+/**
+ * Checks whether or not the queue is empty
+ */
+bool pq_is_empty(pqueue* pq);
+
+/**
+ * Returns the size of the elements stored in the queue
+ */
+size_t pq_get_element_size(pqueue* pq);
+
+/**
+ * Returns the number of children of every node of the heap
+ */
+size_t pq_get_arity(pqueue* pq);
+
+/**
+ * Removes every element, the memory is kept
+ */
+void pq_clear(pqueue* pq);
+
+#endif
\ No newline at end of file
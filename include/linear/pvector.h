@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PVECTOR__H
+#define PVECTOR__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "versioncell.h"
+
+ /**
+  * Struct that represent a persistent vector, every version is immutable
+  *
+  * Elements are stored in the leaves of a trie with 32 children per node, so reading
+  * any position takes O(log32 n). Appending, removing the last element or setting one
+  * doesn't modify the vector, it returns a new version that shares every untouched node
+  * with the old one and copies only the O(log32 n) nodes on the path to the changed leaf.
+  * Each version has to be deleted on its own, nodes are reference counted and freed once
+  * no version uses them
+  *
+  * Since versions never change, any number of threads can read them without locks,
+  * a vcell can be used to publish the latest version to the readers
+  */
+typedef struct pvector pvector;
+
+/**
+ * Creates an empty vector storing elements that are as big as element_size
+ */
+pvector* pvec_create(size_t element_size);
+
+/**
+ * Releases the given version, the nodes that no other version uses are freed
+ */
+void pvec_delete(pvector** pv);
+
+/**
+ * Returns another reference to the same version, that has to be deleted on its own
+ */
+pvector* pvec_retain(pvector* pv);
+
+/**
+ * Returns a new version with x appended after the last element
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_push_back(pvector* pv, void* x);
+
+/**
+ * Returns a new version without the last element (another reference to the same version if it is empty)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_pop_back(pvector* pv);
+
+/**
+ * Returns a new version in which the i -th element is x (another reference to the same version if i is out of bounds)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_set_at(pvector* pv, void* x, size_t i);
+
+/**
+ * Returns a pointer to the i -th element (NULL if i is out of bounds)
+ *
+ * The element is valid as long as the version is, and must not be written
+ */
+void* pvec_get_at(pvector* pv, size_t i);
+
+/**
+ * Copies the i -th element in buf, if i is within bounds
+ */
+void pvec_get_2_at(pvector* pv, size_t i, void* buf);
+
+/**
+ * Applies f to every element, in order, the elements must not be written
+ */
+void pvec_for_each(pvector* pv, void (*f)(void*));
+
+/**
+ * Returns the number of elements of this version
+ */
+size_t pvec_get_length(pvector* pv);
+
+/**
+ * Returns the size of the elements stored in the vector
+ */
+size_t pvec_get_element_size(pvector* pv);
+
+/**
+ * Checks whether or not this version is empty
+ */
+bool pvec_is_empty(pvector* pv);
+
+#endif
\ No newline at end of file
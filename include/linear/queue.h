@@ -9,6 +9,7 @@
 #ifndef QUEUE__H
 #define QUEUE__H
 
+#include <stdlib.h>
 #include <stdbool.h>
 
  /**
@@ -46,6 +47,8 @@ void* queue_dequeue(queue* q);
 
 /**
  * Removes an element from the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when dequeuing often
  */
 void queue_dequeue_2(queue* q, void* buf);
 
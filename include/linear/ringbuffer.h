@@ -9,6 +9,7 @@
 #ifndef RINGBUFFER__H
 #define RINGBUFFER__H
 
+#include <stdlib.h>
 #include <stdbool.h>
 
  /**
@@ -24,6 +25,30 @@ typedef struct ringbuffer ringbuffer;
  */
 ringbuffer* ring_create(size_t max_capacity, size_t element_size);
 
+/**
+ * Creates a ring buffer that one producer thread and one consumer thread
+ * can use at the same time, without locks
+ *
+ * The capacity is rounded up to a power of two, enqueue and dequeue
+ * never block and fail when the ring is full or empty
+ *
+ * The overwrite policy is ignored, the producer never moves the head
+ * (that would make it a second consumer), so enqueuing on a full ring fails
+ */
+ringbuffer* ring_create_spsc(size_t max_capacity, size_t element_size);
+
+/**
+ * Creates a ring buffer that any number of producer and consumer threads
+ * can use at the same time, without locks
+ *
+ * The capacity is rounded up to a power of two, enqueue and dequeue
+ * never block and fail when the ring is full or empty
+ *
+ * With the overwrite policy enabled, enqueuing on a full ring
+ * drops the first element and tries again
+ */
+ringbuffer* ring_create_mpmc(size_t max_capacity, size_t element_size);
+
 /**
  * Deletes the given ring buffer, since memory is allocated dinamically
  * the following actions are performed:
@@ -42,6 +67,16 @@ void ring_delete(ringbuffer** s);
  */
 void ring_enqueue(ringbuffer* r, void* x);
 
+/**
+ * Insert the element pointed to by x at the end of the ring buffer,
+ * returns whether or not it was inserted
+ *
+ * If the given ring is full, either the first element
+ * will be overwritten or the insertion will fail, depending
+ * on the overwrite policy
+ */
+bool ring_try_enqueue(ringbuffer* r, void* x);
+
 /**
  * Removes an element the first element of the ring and 
  * returns a pointer to (a copy of) it
@@ -58,10 +93,22 @@ void* ring_deque(ringbuffer* r);
  */
 void ring_deque_2(ringbuffer* r, void* buf);
 
+/**
+ * Removes the first element of the ring and copies it in the given buffer,
+ * returns whether or not an element was removed
+ *
+ * If the given ring is empty, false is returned and the buffer is left untouched
+ */
+bool ring_try_deque(ringbuffer* r, void* buf);
+
 /**
  * Returns the first element of the ring without removing it
  *
  * If the given ring is empty, NULL is returned
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring NULL is always returned, since another
+ * consumer could take the element while it's being read
  */
 void* ring_peek(ringbuffer* r);
 
@@ -69,11 +116,75 @@ void* ring_peek(ringbuffer* r);
  * Copies the first element of the ring in the given buffer, without removing it
  *
  * If the given ring is empty, NULL is returned
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring nothing is copied
  */
 void ring_peek_2(ringbuffer* r, void* buf);
 
+/**
+ * Inserts the n elements stored contiguously in xs at the end of the ring buffer,
+ * returns the number of elements inserted
+ *
+ * Elements are copied in (at most) two spans, before and after the wrap point
+ *
+ * If the ring gets full, either the first elements will be overwritten
+ * (only the last elements are kept if n is bigger than the ring) or the
+ * remaining elements are not inserted, depending on the overwrite policy
+ */
+size_t ring_enqueue_n(ringbuffer* r, const void* xs, size_t n);
+
+/**
+ * Removes (up to) n elements from the start of the ring and copies them contiguously in buf,
+ * returns the number of elements removed
+ *
+ * Elements are copied in (at most) two spans, before and after the wrap point
+ */
+size_t ring_deque_n(ringbuffer* r, void* buf, size_t n);
+
+/**
+ * Returns a pointer to the free slots after the last element of the ring, so that the
+ * caller can write (up to) n elements directly into the buffer, they're inserted by ring_commit
+ *
+ * The number of contiguous slots that can be written (n at most, less if the ring
+ * is almost full or the span reaches the wrap point) is stored in reserved, NULL is
+ * returned when there's none
+ *
+ * On a single producer/single consumer ring only the producer may reserve,
+ * on a multi producer/multi consumer ring NULL is always returned
+ */
+void* ring_reserve(ringbuffer* r, size_t n, size_t* reserved);
+
+/**
+ * Inserts the n elements written in the span returned by ring_reserve
+ * (n can't be bigger than the number of slots reserved)
+ */
+void ring_commit(ringbuffer* r, size_t n);
+
+/**
+ * Returns a pointer to the first element of the ring, so that the caller can read
+ * (up to) n elements directly from the buffer, they're removed by ring_release
+ *
+ * The number of contiguous elements that can be read (n at most, less if the ring
+ * has fewer elements or the span reaches the wrap point) is stored in count, NULL is
+ * returned when there's none
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring NULL is always returned
+ */
+void* ring_peek_span(ringbuffer* r, size_t n, size_t* count);
+
+/**
+ * Removes the first n elements of the ring, usually after reading them
+ * from the span returned by ring_peek_span
+ * (n can't be bigger than the number of elements in the ring)
+ */
+void ring_release(ringbuffer* r, size_t n);
+
 /**
  * Returns the number of elements inside the ring
+ *
+ * On concurrent rings it's a snapshot, other threads may change it right after
  */
 size_t ring_get_cur_size(ringbuffer* r);
 
@@ -99,11 +210,15 @@ bool ring_is_full(ringbuffer* r);
 
 /**
  * Enables the overwrite policy on full rings
+ *
+ * On concurrent rings the policy must be set before the ring is shared
  */
 void ring_enable_overwrite(ringbuffer* r);
 
 /**
  * Disables the overwrite policy on full rings
+ *
+ * On concurrent rings the policy must be set before the ring is shared
  */
 void ring_disable_overwrite(ringbuffer* r);
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef ROARING__H
+#define ROARING__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Struct that represent a compressed bitset over the whole range of 32 bit integers
+ *
+ * The range is split in chunks of 65536 bits, only the chunks with at least one positive bit
+ * are stored, each one in the smallest of three forms: a sorted array of its positive bits
+ * (up to 4096 of them), a plain bitmap, or a list of runs of consecutive positive bits
+ *
+ * Runs are only made by roaring_optimize, changing a chunk stored as runs turns it back into one of the other forms
+ */
+typedef struct roaring roaring;
+
+/**
+ *  Creates an empty compressed bitset
+ */
+roaring* roaring_create(void);
+
+/**
+ *  Deletes the given bitset
+ */
+void roaring_delete(roaring** r);
+
+/**
+ *  Sets the i -th bit of the set to 1
+ */
+void roaring_set(roaring* r, uint32_t i);
+
+/**
+ *  Sets the i -th bit of the set to 0
+ */
+void roaring_unset(roaring* r, uint32_t i);
+
+/**
+ *  Returns the value of the i -th bit of the set
+ */
+bool roaring_get(roaring* r, uint32_t i);
+
+/**
+ *  Toggles the i -th bit of the set
+ */
+void roaring_toggle(roaring* r, uint32_t i);
+
+/**
+ *  Returns the number of positive bits in the set
+ *
+ *  The value is cached, so this is O(1)
+ */
+uint64_t roaring_count(roaring* r);
+
+/**
+ *  Sets to 0 every bit of the set that's 0 in other (r = r & other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_and(roaring* r, roaring* other);
+
+/**
+ *  Sets to 1 every bit of the set that's 1 in other (r = r | other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_or(roaring* r, roaring* other);
+
+/**
+ *  Toggles every bit of the set that's 1 in other (r = r ^ other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_xor(roaring* r, roaring* other);
+
+/**
+ *  Sets to 0 every bit of the set that's 1 in other (r = r & ~other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_and_not(roaring* r, roaring* other);
+
+/**
+ *  Returns the position of the first bit set to 1 starting from the given one (included)
+ *
+ *  Returns whether or not there was one, its position is written in next
+ */
+bool roaring_next_set(roaring* r, uint32_t from, uint32_t* next);
+
+/**
+ *  Calls f with the position of every bit set to 1, in increasing order
+ *
+ *  f must not modify the set
+ */
+void roaring_for_each_set(roaring* r, void (*f)(uint32_t));
+
+/**
+ *  Stores as runs every chunk that takes less memory that way
+ */
+void roaring_optimize(roaring* r);
+
+/**
+ *  Returns the number of bytes used by the set
+ */
+size_t roaring_get_memory(roaring* r);
+
+/**
+ *  Sets all the bits of the set to 0
+ */
+void roaring_clear(roaring* r);
+
+/**
+ *  Checks whether the set has at least one positive bit or not
+ */
+bool roaring_is_empty(roaring* r);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef SEARCHKERNELS__H
+#define SEARCHKERNELS__H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Linear search kernels over contiguous storage, used by the containers
+ * that keep their elements packed (vector, the unrolled linkedlist, ..)
+ *
+ * Every kernel looks for the element pointed to by x among the count elements
+ * (each element_size bytes long) starting at base, and returns the index of the
+ * first equal one, or count if none of them is equal to x
+ *
+ * The 1, 2, 4 and 8 bytes kernels compare whole vectors of elements at a time
+ * (SSE2 / AVX2, when the compiler targets them), every other size uses memcmp
+ */
+
+/* Signature shared by every search kernel */
+typedef size_t (*search_kernel)(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Search kernel for elements that are 1 byte long
+ */
+size_t search_util_find_8(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Search kernel for elements that are 2 bytes long
+ */
+size_t search_util_find_16(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Search kernel for elements that are 4 bytes long
+ */
+size_t search_util_find_32(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Search kernel for elements that are 8 bytes long
+ */
+size_t search_util_find_64(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Search kernel for elements of any size, compares one element at a time with memcmp
+ */
+size_t search_util_find_generic(const void* base, size_t count, size_t element_size, const void* x);
+
+/**
+ * Returns the fastest kernel for elements that are element_size bytes long
+ *
+ * Meant to be called once, when the container is created, and stored
+ */
+search_kernel search_util_select(size_t element_size);
+
+#endif
\ No newline at end of file
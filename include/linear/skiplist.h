@@ -11,17 +11,66 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "stats.h"
+
+/* Number of entries of the level histogram of sl_stats */
+#define SL_STATS_LEVELS 64
 
  /**
   * Struct that represent a list of elements of a generic type value
   */
 typedef struct skiplist skiplist;
 
+/**
+ * Struct used to walk the list in order, from a value up to a bound, without allocating anything
+ *
+ * It's meant to be declared by the caller (for example on the stack) and initialized
+ * with sl_iterator_init, its fields shouldn't be modified directly; the list must not
+ * be modified while it's being walked
+ */
+typedef struct sl_iterator {
+
+	/* Node holding the next value, NULL when there are no more values */
+	struct snode* node;
+
+	/* Last value the iterator can return (NULL if there's no upper bound) */
+	void* hi;
+
+	/* Function used to compare the values with the bound */
+	int (*compare)(void*, void*);
+} sl_iterator;
+
+/**
+ * Counters of a skip list, the ones of the nodes are zero unless built with CDS_WITH_STATS
+ */
+typedef struct sl_stats {
+
+	/* Allocations of the nodes, from all the pools */
+	node_stats nodes;
+
+	/* Histogram of the levels, levels[i] is the number of nodes that are in i + 1 levels
+	 * (the last entry also counts the taller nodes)
+	 */
+	size_t levels[SL_STATS_LEVELS];
+
+	/* Number of levels of the tallest node */
+	size_t height;
+} sl_stats;
+
 /**
  *  Creates a linked list ready to store elements that are as big as the given size
  */
 skiplist* sl_create(size_t element_size, size_t max_levels, double probability, int (*cmp)(void*, void*));
 
+/**
+ * Creates a list holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * Every node is appended at the end in O(1), so it takes O(n) time without comparing any element;
+ * levels aren't random, one node every 1/probability in each level goes up to the next one, so the list is perfectly balanced
+ */
+skiplist* sl_from_sorted(size_t element_size, size_t max_levels, double probability, int (*cmp)(void*, void*), void* elements, size_t n);
+
 /**
  * Deletes the given list
  */
@@ -42,6 +91,55 @@ void sl_remove(skiplist* sl, void* x);
  */
 void* sl_search(skiplist* sl, void* x);
 
+/**
+ * Returns a pointer to the first element that is not less than x, NULL if there's none
+ */
+void* sl_lower_bound(skiplist* sl, void* x);
+
+/**
+ * Returns a pointer to the first element that is greater than x, NULL if there's none
+ */
+void* sl_upper_bound(skiplist* sl, void* x);
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) expected time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void sl_range(skiplist* sl, void* lo, void* hi, void (*callback)(void*));
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void sl_iterator_init(skiplist* sl, sl_iterator* it, void* lo, void* hi);
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool sl_iterator_has_next(sl_iterator* it);
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* sl_iterator_next(sl_iterator* it);
+
+/**
+ * Returns a pointer to the k-th smallest element (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(log n) expected time, since every pointer knows how many nodes it moves over
+ */
+void* sl_select(skiplist* sl, size_t k);
+
+/**
+ * Returns the number of elements in the list that are less than x (x doesn't need to be in the list)
+ *
+ * It takes O(log n) expected time, since every pointer knows how many nodes it moves over
+ */
+size_t sl_rank(skiplist* sl, void* x);
+
 /**
  * Returns the number of elements of the list
  */
@@ -57,6 +155,13 @@ size_t sl_get_element_size(skiplist* sl);
  */
 size_t sl_get_max_levels(skiplist* sl);
 
+/**
+ * Copies in stats the counters of the skip list
+ *
+ * Nodes of each level come from their own pool, so the histogram costs O(max levels)
+ */
+void sl_get_stats(skiplist* sl, sl_stats* stats);
+
 /**
  * Checks if the element pointed to by x is present in the list
  */
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef SNAPSHOT__H
+#define SNAPSHOT__H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/**
+ * Snapshots, binary images of a container that can be mapped back read-only and used in place
+ *
+ * A snapshot starts with a header (magic, version, kind of container, byte order and
+ * sizes of the machine that wrote it), followed by sections aligned to SNAPSHOT_ALIGNMENT
+ * and ends with a descriptor, a struct defined by each container that holds the positions of its
+ * sections. Every position is an offset from the start of the file, so that the image is
+ * valid wherever it gets mapped, and files written by a different version (or machine) are refused
+ *
+ * Maps of keys to values are stored as tables: open addressing (linear probing) over
+ * fixed slots, followed by the values and the key bytes, hashed by a function that
+ * doesn't depend on the process (the seed is stored in the table)
+ */
+
+/* Version of the format, snapshots written by other versions are refused */
+#define SNAPSHOT_VERSION 1
+
+/* Alignment of every section, so that mapped arrays can be read in place */
+#define SNAPSHOT_ALIGNMENT 64
+
+/* Kinds of container a snapshot can hold */
+#define SNAPSHOT_VECTOR 1
+#define SNAPSHOT_HASHMAP 2
+#define SNAPSHOT_GRAPH 3
+
+/* Key position of the empty slots of a table */
+#define SNAPSHOT_EMPTY UINT64_MAX
+
+/* Mapped (read-only) snapshot */
+typedef struct snapshot snapshot;
+
+/**
+ * Snapshot being written, the position is the number of bytes written so far
+ */
+typedef struct snapshot_writer {
+
+	FILE* file;
+	const char* path;
+	uint64_t position;
+	bool failed;
+} snapshot_writer;
+
+/**
+ * Couple <key, value> to be written in a table
+ */
+typedef struct snapshot_entry {
+
+	const void* key;
+	size_t key_length;
+	const void* value;
+} snapshot_entry;
+
+/**
+ * Slot of a table as it's stored, positions are relative to the start of the table
+ */
+typedef struct snapshot_slot {
+
+	uint64_t hash;
+	uint64_t key;
+	uint64_t key_length;
+	uint64_t value;
+} snapshot_slot;
+
+/**
+ * Table read in place from a mapped snapshot
+ */
+typedef struct snapshot_table {
+
+	/* Start of the table and number of mapped bytes from there on */
+	const char* base;
+	size_t size;
+
+	const snapshot_slot* slots;
+	size_t capacity;
+	size_t count;
+	size_t value_size;
+
+	/* Seed the keys were hashed with */
+	uint64_t seed;
+} snapshot_table;
+
+/**
+ * Maps the snapshot in the given file, which must hold the given kind of container,
+ * and copies its descriptor (that is descriptor_size bytes long) in descriptor
+ *
+ * NULL is returned if the file can't be mapped or isn't a valid snapshot
+ */
+snapshot* snapshot_util_open(const char* path, uint32_t kind, void* descriptor, size_t descriptor_size);
+
+/**
+ * Unmaps the snapshot, every pointer into it is no longer valid
+ */
+void snapshot_util_close(snapshot** s);
+
+/**
+ * Returns a pointer to the length bytes at the given position of the snapshot,
+ * NULL if they're not all inside of it
+ */
+const void* snapshot_util_at(snapshot* s, uint64_t position, uint64_t length);
+
+/**
+ * Reads the table at the given position of the snapshot in t, returns false if it isn't valid
+ */
+bool snapshot_util_open_table(snapshot* s, uint64_t position, snapshot_table* t);
+
+/**
+ * Returns a pointer to the value mapped by the len bytes pointed to by key
+ * (whose hash, computed with the seed of the table, is h) NULL if there's none
+ */
+const void* snapshot_util_find(const snapshot_table* t, const void* key, size_t len, uint64_t h);
+
+/**
+ * Starts writing a snapshot of the given kind in the given file (which is replaced),
+ * whose descriptor will be descriptor_size bytes long
+ */
+bool snapshot_util_begin(snapshot_writer* w, const char* path, uint32_t kind, size_t descriptor_size);
+
+/**
+ * Starts a new section, and returns its position
+ */
+uint64_t snapshot_util_section(snapshot_writer* w);
+
+/**
+ * Writes length bytes at the end of the snapshot
+ */
+void snapshot_util_write(snapshot_writer* w, const void* data, size_t length);
+
+/**
+ * Writes the n entries as a new table, and returns its position
+ *
+ * Every value is value_size bytes long, keys are hashed with hash and the given seed, and
+ * if key_positions isn't NULL the position of the key of each entry is stored in it
+ */
+uint64_t snapshot_util_write_table(snapshot_writer* w, const snapshot_entry* entries, size_t n, size_t value_size,
+	size_t (*hash)(const void*, size_t, uint64_t), uint64_t seed, uint64_t* key_positions);
+
+/**
+ * Ends the snapshot with its descriptor and closes the file
+ *
+ * Returns whether or not every write succeeded, the file is removed otherwise
+ */
+bool snapshot_util_end(snapshot_writer* w, const void* descriptor, size_t descriptor_size);
+
+#endif
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include "pool.h"
 
 /**
  * Struct that represent a node that can store
@@ -20,6 +21,8 @@
  * 
  * The node itself has two components, a value stored, and
  * an array of pointers to the nodes at the next levels
+ *
+ * The pointers, the spans and the value are stored right after the struct, in the same allocation
  */
 typedef struct snode snode;
 
@@ -31,14 +34,37 @@ typedef struct snode snode;
  */
 snode* snode_create(void* value, size_t value_size, size_t level);
 
+/**
+ * Creates a node like snode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least snode_get_footprint(value_size, level) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+snode* snode_create_in(pool* p, void* value, size_t value_size, size_t level);
+
 /**
  * Deletes the given node
- * 
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ *
+ * The pointers and the value are stored with the struct
+ * so a single free releases everything
  */
 void snode_delete(snode** sn);
 
+/**
+ * Deletes the given node, created by snode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void snode_delete_in(pool* p, snode** sn);
+
+/**
+ * Returns the number of bytes used by a node with the given
+ * number of levels, storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t snode_get_footprint(size_t value_size, size_t level);
+
 /**
  * Returns a pointer to the value stored in the
  * node
@@ -67,7 +93,21 @@ size_t snode_get_level(snode* sn);
 
 /**
  * Sets the level of the node inside the list it is part of
+ *
+ * It can't be more than the level the node was created with
  */
 void snode_set_level(snode* sn, size_t level);
 
+/**
+ * Returns how many nodes the pointer of the given level moves forward on the bottom level
+ *
+ * Skip lists keep it up to date to find the position of a node in O(log n)
+ */
+size_t snode_get_span(snode* sn, size_t level);
+
+/**
+ * Sets how many nodes the pointer of the given level moves forward on the bottom level
+ */
+void snode_set_span(snode* sn, size_t span, size_t level);
+
 #endif
\ No newline at end of file
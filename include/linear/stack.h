@@ -9,6 +9,7 @@
 #ifndef STACK__H
 #define STACK__H
 
+#include <stdlib.h>
 #include <stdbool.h>
 
  /**
@@ -25,6 +26,13 @@ typedef struct stack stack;
  */
 stack* stack_create(size_t element_size);
 
+/**
+ *  Creates a stack whose first inline_length elements are stored in the same allocation as its chunked array
+ *
+ * Meant for stacks that stay small, see ca_create_inline
+ */
+stack* stack_create_inline(size_t element_size, size_t inline_length);
+
 /**
  * Deletes the given stack, since memory is allocated dinamically
  * the following actions are performed:
@@ -46,6 +54,8 @@ void* stack_pop(stack* s);
 
 /**
  * Removes an element from the stack and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void stack_pop_2(stack* s, void* buf);
 
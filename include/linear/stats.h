@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef STATS__H
+#define STATS__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/**
+ * Instrumentation counters, compiled in only when CDS_WITH_STATS is defined
+ *
+ * Without it the counters aren't stored nor updated (the macros expand to nothing),
+ * the *_get_stats functions still report what can be read from the container itself
+ * (sizes, heights, load) and leave the counters at zero, with enabled set to false
+ */
+#ifdef CDS_WITH_STATS
+#define STATS_ENABLED true
+#define STATS_INC(counter) ((counter)++)
+#define STATS_ADD(counter, n) ((counter) += (n))
+#define STATS_MAX(counter, value) ((counter) = (counter) < (value) ? (value) : (counter))
+#else
+#define STATS_ENABLED false
+#define STATS_INC(counter) ((void)0)
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_MAX(counter, value) ((void)0)
+#endif
+
+/**
+ * Allocation counters of a node based container, its nodes come from one or more pools
+ */
+typedef struct node_stats {
+
+	/* Nodes handed out, and given back, since the container was created */
+	size_t allocations;
+	size_t frees;
+
+	/* Chunks requested from malloc to hold the nodes, and their bytes */
+	size_t chunks;
+	size_t bytes;
+
+	/* Nodes in use */
+	size_t live;
+
+	/* Whether or not the counters were compiled in */
+	bool enabled;
+} node_stats;
+
+#endif
\ No newline at end of file
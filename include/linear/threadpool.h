@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef THREADPOOL__H
+#define THREADPOOL__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "parallel.h"
+
+/**
+ * Struct that represent a pool of worker threads that run tasks
+ *
+ * Every worker has its own double ended queue of tasks (Chase-Lev), it pushes and takes the
+ * tasks it creates at the bottom (so it works depth first, on data that is still in its cache)
+ * and, when it runs out of them, steals the oldest ones from the top of the queue of another worker
+ * (that are the biggest pieces of work, in a recursive split). Tasks created by threads that aren't
+ * workers go to a shared queue
+ *
+ * Workers that can't find tasks sleep until new ones are submitted
+ */
+typedef struct threadpool threadpool;
+
+/**
+ * Group of tasks that can be waited for together
+ *
+ * It is owned by the caller (it can be a local variable), initialized with tp_group_init,
+ * and needs to be waited for (tp_group_wait) before it goes out of scope
+ */
+typedef struct tp_group {
+
+	threadpool* tp;
+
+	/* Number of tasks of the group that didn't finish yet */
+	atomic_size_t pending;
+} tp_group;
+
+/**
+ * Creates a pool with the given number of worker threads, 0 means one for each processor
+ */
+threadpool* tp_create(size_t threads);
+
+/**
+ * Deletes the given pool, waiting for the workers to finish the task they're running
+ *
+ * The tasks that are still queued are not run, so every group should be waited for first
+ */
+void tp_delete(threadpool** tp);
+
+/**
+ * Returns the pool shared by the whole library (used by parallel_util_for), created the first
+ * time it's needed with one worker for each processor, or as many as set by tp_set_shared_threads
+ *
+ * It is never deleted, NULL is returned if it couldn't be created
+ */
+threadpool* tp_get_shared(void);
+
+/**
+ * Sets the number of workers of the shared pool, it has effect only if called before it is created
+ */
+void tp_set_shared_threads(size_t threads);
+
+/**
+ * Returns the number of worker threads of the pool
+ */
+size_t tp_get_threads(threadpool* tp);
+
+/**
+ * Prepares the group to hold tasks run by the given pool
+ */
+void tp_group_init(threadpool* tp, tp_group* g);
+
+/**
+ * Runs task(arg) in the pool, as part of the group g
+ *
+ * If memory for the task can't be allocated, it is run right away by the calling thread
+ */
+void tp_group_run(tp_group* g, void (*task)(void*), void* arg);
+
+/**
+ * Waits until every task of the group (and the ones they added to it) finished
+ *
+ * The calling thread runs queued tasks in the meantime (of any group), so
+ * tasks can wait for the groups they create without exhausting the workers
+ */
+void tp_group_wait(tp_group* g);
+
+/**
+ * Applies body to the indices from 0 to n using the pool, the range is split in half
+ * recursively until the pieces have at most grain indices, and returns when every piece is done
+ *
+ * The two halves of each split can be run by different threads, so body must only
+ * write data that belongs to its range
+ */
+void tp_parallel_for(threadpool* tp, size_t n, size_t grain, parallel_body body, void* context);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TIMERWHEEL__H
+#define TIMERWHEEL__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "stats.h"
+
+/* Handle returned when a timer couldn't be scheduled */
+#define TW_NO_HANDLE SIZE_MAX
+
+/**
+ * Struct that represent a hierarchical timing wheel, that holds timers
+ * (elements of generic type, each with a deadline) until their deadline is reached
+ *
+ * Time is counted in ticks, whatever unit the user picks (milliseconds, seconds, ...)
+ *
+ * The wheel has 4 levels of 256 slots, each slot is a list of timers: level 0 holds the timers
+ * due in the next 256 ticks, one slot per tick, level 1 the ones due in the next 65536 ticks,
+ * one slot per 256 ticks and so on; when a slot of a higher level is reached its timers are
+ * moved to the lower levels. Timers further than 2^32 ticks wait in the last slot of level 3
+ *
+ * Scheduling, cancelling and rescheduling are O(1), advancing costs O(1) per tick
+ * plus the timers that are moved or expire, whatever the number of timers
+ */
+typedef struct timerwheel timerwheel;
+
+/**
+ * Creates a timing wheel that stores elements that are as big as element_size, whose time starts at now
+ */
+timerwheel* tw_create(size_t element_size, uint64_t now);
+
+/**
+ * Deletes the given timing wheel, the timers still in it are dropped
+ */
+void tw_delete(timerwheel** tw);
+
+/**
+ * Schedules a copy of the element pointed to by x, to expire at the given deadline (in ticks),
+ * and returns its handle (TW_NO_HANDLE if it couldn't be scheduled)
+ *
+ * Deadlines that are already passed expire on the next tick
+ */
+size_t tw_schedule(timerwheel* tw, uint64_t deadline, void* x);
+
+/**
+ * Moves the timer with the given handle to a new deadline
+ *
+ * Returns whether or not the timer was still scheduled
+ */
+bool tw_reschedule(timerwheel* tw, size_t handle, uint64_t deadline);
+
+/**
+ * Cancels the timer with the given handle, its element is dropped
+ *
+ * Returns whether or not the timer was still scheduled
+ */
+bool tw_cancel(timerwheel* tw, size_t handle);
+
+/**
+ * Moves the time of the wheel forward to now, the timers whose deadline is reached
+ * expire and their elements are passed to expire in batches: every call gets n
+ * (contiguous) elements, context is passed to each call
+ *
+ * The handles of the expired timers are free before expire is called, so expire
+ * can schedule new timers (they expire on a later call) but not advance the wheel
+ *
+ * Returns the number of expired timers
+ */
+size_t tw_advance(timerwheel* tw, uint64_t now, void (*expire)(void* elements, size_t n, void* context), void* context);
+
+/**
+ * Returns a pointer to the element of the timer with the given handle, NULL if it's not scheduled
+ */
+void* tw_get(timerwheel* tw, size_t handle);
+
+/**
+ * Returns the deadline of the timer with the given handle, 0 if it's not scheduled
+ */
+uint64_t tw_get_deadline(timerwheel* tw, size_t handle);
+
+/**
+ * Checks whether or not the timer with the given handle is scheduled
+ *
+ * Handles of timers that expired or were cancelled are given to new timers
+ */
+bool tw_contains(timerwheel* tw, size_t handle);
+
+/**
+ * Returns the current time of the wheel
+ */
+uint64_t tw_get_time(timerwheel* tw);
+
+/**
+ * Returns the number of scheduled timers
+ */
+size_t tw_get_count(timerwheel* tw);
+
+/**
+ * Returns the size of the elements stored in the wheel
+ */
+size_t tw_get_element_size(timerwheel* tw);
+
+/**
+ * Checks whether or not there are no scheduled timers
+ */
+bool tw_is_empty(timerwheel* tw);
+
+/**
+ * Drops every timer, the time of the wheel stays the same
+ */
+void tw_clear(timerwheel* tw);
+
+/**
+ * Copies in stats the allocation counters of the nodes of the timers
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void tw_get_stats(timerwheel* tw, node_stats* stats);
+
+#endif
\ No newline at end of file
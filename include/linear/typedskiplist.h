@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TYPEDSKIPLIST__H
+#define TYPEDSKIPLIST__H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pool.h"
+
+/**
+ * Type specialized skiplist, generated by macro for a given element type and compare function
+ *
+ * Same algorithm and semantics of skiplist (skiplist.h): elements are kept in order,
+ * duplicates are allowed, every node is promoted to the next level with the given
+ * probability and nodes of each level come from their own pool. Elements are typed
+ * values and the compare is inlined, instead of being called through a function pointer
+ *
+ *   DEFINE_SKIPLIST(int, cmp)                   generates the type sl_int and sl_int_create, ..
+ *   DEFINE_SKIPLIST_NAMED(points, point, cmp)   generates the type points, for a type name that isn't a single identifier
+ *
+ * cmp(a, b) takes two values and returns a negative number, zero or a positive
+ * number if a is less, equal or greater than b, it can be a macro or a function
+ * (TYPED_COMPARE works for any type that can be compared with < and >)
+ *
+ * The generated struct is defined in the header, since every function using it is inlined,
+ * it should still only be accessed through the functions
+ */
+
+/* Compare for types that can be compared with < and > */
+#ifndef TYPED_COMPARE
+#define TYPED_COMPARE(a, b) (((a) > (b)) - ((a) < (b)))
+#endif
+
+/* Maximum number of levels of a typed skiplist, the search paths are kept on the stack */
+#define TYPED_SKIPLIST_MAX_LEVELS 64
+
+#define DEFINE_SKIPLIST(T, cmp) DEFINE_SKIPLIST_NAMED(sl_##T, T, cmp)
+
+#define DEFINE_SKIPLIST_NAMED(name, T, cmp)                                                              \
+                                                                                                         \
+/* Node of the list, followed by one pointer for each of its levels */                                   \
+typedef struct name##_node {                                                                             \
+	T value;                                                                                             \
+	size_t level;                                                                                        \
+	struct name##_node* next[];                                                                          \
+} name##_node;                                                                                           \
+                                                                                                         \
+/* Struct that represent a skiplist of T */                                                              \
+typedef struct name {                                                                                    \
+                                                                                                         \
+	/* Sentinel node, linked in every level, that doesn't hold a value */                               \
+	name##_node* sentinel;                                                                               \
+	size_t element_count;                                                                                \
+                                                                                                         \
+	/* Levels a node can have, and levels currently used by at least one node */                        \
+	size_t max_levels;                                                                                   \
+	size_t levels;                                                                                       \
+                                                                                                         \
+	/* Probability of promoting a node to the next level, and state of the generator of the levels */   \
+	double probability;                                                                                  \
+	uint64_t random_state;                                                                               \
+                                                                                                         \
+	/* One pool for each level (created when first needed) */                                           \
+	pool* nodes[TYPED_SKIPLIST_MAX_LEVELS];                                                              \
+} name;                                                                                                  \
+                                                                                                         \
+/* Utility function used to generate a level for a node (xorshift64*, one generator per list) */         \
+static inline size_t name##_util_random_level(name* sl) {                                                \
+                                                                                                         \
+	size_t level = 1;                                                                                    \
+                                                                                                         \
+	while (level < sl->max_levels) {                                                                     \
+		sl->random_state ^= sl->random_state >> 12;                                                      \
+		sl->random_state ^= sl->random_state << 25;                                                      \
+		sl->random_state ^= sl->random_state >> 27;                                                      \
+		if ((double)((sl->random_state * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0) >= sl->probability) \
+			break;                                                                                       \
+		level++;                                                                                         \
+	}                                                                                                    \
+	return level;                                                                                        \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function that stores in update the last node before x (or, if strict, not greater than x) on every level */ \
+static inline name##_node* name##_util_path(name* sl, T x, bool strict, name##_node** update) {          \
+                                                                                                         \
+	name##_node* tmp = sl->sentinel;                                                                     \
+                                                                                                         \
+	for (size_t i = sl->levels; i > 0; i--) {                                                            \
+		while (tmp->next[i - 1] && (strict ? cmp(tmp->next[i - 1]->value, x) <= 0 : cmp(tmp->next[i - 1]->value, x) < 0)) \
+			tmp = tmp->next[i - 1];                                                                      \
+		if (update) update[i - 1] = tmp;                                                                 \
+	}                                                                                                    \
+	return tmp->next[0];                                                                                 \
+}                                                                                                        \
+                                                                                                         \
+/* Creates an empty list, whose nodes have at most max_levels levels (at most TYPED_SKIPLIST_MAX_LEVELS) */ \
+static inline name* name##_create(size_t max_levels, double probability) {                               \
+                                                                                                         \
+	name* sl = NULL;                                                                                     \
+                                                                                                         \
+	if (0 < max_levels && max_levels <= TYPED_SKIPLIST_MAX_LEVELS && 0.0 < probability && probability < 1.0) { \
+                                                                                                         \
+		sl = (name*)calloc(1, sizeof(name));                                                             \
+		if (sl) {                                                                                        \
+			sl->max_levels = max_levels;                                                                 \
+			sl->levels = 1;                                                                              \
+			sl->probability = probability;                                                               \
+			sl->random_state = 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)sl;                           \
+			sl->sentinel = (name##_node*)calloc(1, sizeof(name##_node) + max_levels * sizeof(name##_node*)); \
+                                                                                                         \
+			if (sl->sentinel) sl->sentinel->level = max_levels;                                          \
+			else {                                                                                       \
+				free(sl);                                                                                \
+				sl = NULL;                                                                               \
+			}                                                                                            \
+		}                                                                                                \
+	}                                                                                                    \
+	return sl;                                                                                           \
+}                                                                                                        \
+                                                                                                         \
+/* Deletes the list, and sets the pointer to NULL */                                                     \
+static inline void name##_delete(name** sl) {                                                            \
+                                                                                                         \
+	if (sl && *sl) {                                                                                     \
+		for (size_t i = 0; i < (*sl)->max_levels; i++) pool_delete(&(*sl)->nodes[i]);                    \
+		free((*sl)->sentinel);                                                                           \
+		free(*sl);                                                                                       \
+		*sl = NULL;                                                                                      \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Inserts x in the list, before the values not less than it */                                          \
+static inline void name##_insert(name* sl, T x) {                                                        \
+                                                                                                         \
+	if (sl) {                                                                                            \
+		name##_node* update[TYPED_SKIPLIST_MAX_LEVELS];                                                  \
+		name##_util_path(sl, x, false, update);                                                          \
+                                                                                                         \
+		size_t level = name##_util_random_level(sl);                                                     \
+		if (!sl->nodes[level - 1])                                                                       \
+			sl->nodes[level - 1] = pool_create(sizeof(name##_node) + level * sizeof(name##_node*));      \
+                                                                                                         \
+		name##_node* n = sl->nodes[level - 1] ? (name##_node*)pool_alloc(sl->nodes[level - 1]) : NULL;   \
+		if (n) {                                                                                         \
+			/* The levels that weren't used until now start from the sentinel */                        \
+			for (; sl->levels < level; sl->levels++) update[sl->levels] = sl->sentinel;                  \
+                                                                                                         \
+			n->value = x;                                                                                \
+			n->level = level;                                                                            \
+			for (size_t i = 0; i < level; i++) {                                                         \
+				n->next[i] = update[i]->next[i];                                                         \
+				update[i]->next[i] = n;                                                                  \
+			}                                                                                            \
+			sl->element_count++;                                                                         \
+		}                                                                                                \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes (the first occurrence of) x from the list, if it is present */                                \
+static inline void name##_remove(name* sl, T x) {                                                        \
+                                                                                                         \
+	if (sl) {                                                                                            \
+		name##_node* update[TYPED_SKIPLIST_MAX_LEVELS];                                                  \
+		name##_node* n = name##_util_path(sl, x, false, update);                                         \
+                                                                                                         \
+		if (n && cmp(n->value, x) == 0) {                                                                \
+			for (size_t i = 0; i < n->level; i++) update[i]->next[i] = n->next[i];                       \
+			pool_free(sl->nodes[n->level - 1], n);                                                       \
+			sl->element_count--;                                                                         \
+                                                                                                         \
+			while (sl->levels > 1 && !sl->sentinel->next[sl->levels - 1]) sl->levels--;                  \
+		}                                                                                                \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the first value not less than x, NULL if there's none */                         \
+static inline T* name##_lower_bound(name* sl, T x) {                                                     \
+                                                                                                         \
+	name##_node* n = sl ? name##_util_path(sl, x, false, NULL) : NULL;                                   \
+	return n ? &n->value : NULL;                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the first value greater than x, NULL if there's none */                          \
+static inline T* name##_upper_bound(name* sl, T x) {                                                     \
+                                                                                                         \
+	name##_node* n = sl ? name##_util_path(sl, x, true, NULL) : NULL;                                    \
+	return n ? &n->value : NULL;                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to a value equal to x, NULL if there's none */                                      \
+static inline T* name##_search(name* sl, T x) {                                                          \
+                                                                                                         \
+	T* res = name##_lower_bound(sl, x);                                                                  \
+	return (res && cmp(*res, x) == 0) ? res : NULL;                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Checks whether x is present in the list */                                                            \
+static inline bool name##_contains(name* sl, T x) {                                                      \
+                                                                                                         \
+	return name##_search(sl, x) != NULL;                                                                 \
+}                                                                                                        \
+                                                                                                         \
+/* Applies callback, in order, to each value between lo and hi (both included) */                        \
+static inline void name##_range(name* sl, T lo, T hi, void (*callback)(T*)) {                            \
+                                                                                                         \
+	if (sl && callback) {                                                                                \
+		for (name##_node* n = name##_util_path(sl, lo, false, NULL); n && cmp(n->value, hi) <= 0; n = n->next[0]) \
+			callback(&n->value);                                                                         \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of values in the list */                                                           \
+static inline size_t name##_get_size(name* sl) {                                                         \
+                                                                                                         \
+	return sl ? sl->element_count : 0;                                                                   \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of levels a node can have */                                                       \
+static inline size_t name##_get_max_levels(name* sl) {                                                   \
+                                                                                                         \
+	return sl ? sl->max_levels : 0;                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Checks whether the list contains at least one value */                                                \
+static inline bool name##_is_empty(name* sl) {                                                           \
+                                                                                                         \
+	return sl ? sl->element_count == 0 : false;                                                          \
+}                                                                                                        \
+                                                                                                         \
+/* Removes every value, the list itself is not deleted */                                                \
+static inline void name##_clear(name* sl) {                                                              \
+                                                                                                         \
+	if (sl) {                                                                                            \
+		for (size_t i = 0; i < sl->max_levels; i++)                                                      \
+			if (sl->nodes[i]) pool_clear(sl->nodes[i]);                                                  \
+		for (size_t i = 0; i < sl->max_levels; i++) sl->sentinel->next[i] = NULL;                        \
+		sl->levels = 1;                                                                                  \
+		sl->element_count = 0;                                                                           \
+	}                                                                                                    \
+	return;                                                                                              \
+}
+
+#endif
\ No newline at end of file
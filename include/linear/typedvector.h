@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TYPEDVECTOR__H
+#define TYPEDVECTOR__H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Type specialized vector, generated by macro for a given element type
+ *
+ * Same algorithm and semantics of vector (vector.h), but elements are
+ * typed values instead of void* copied with memcpy, so every operation is
+ * a static inline function the compiler can inline, unroll and vectorize
+ *
+ *   DEFINE_VECTOR(int)                       generates the type vec_int and vec_int_create, vec_int_push_back, ..
+ *   DEFINE_VECTOR_NAMED(points, point, eq)   generates the type points, for a type name that isn't a single
+ *                                            identifier, or for types that can't be compared with ==
+ *                                            (eq(a, b) is true when a and b are equal, a macro or a function)
+ *
+ * The generated struct is defined in the header, since every function using it is inlined,
+ * it should still only be accessed through the functions
+ *
+ * The macro is meant to be used once per type, in a header or a source file,
+ * it doesn't replace the generic vector, that can be used alongside it
+ */
+
+/* Equality used by DEFINE_VECTOR, for types that can be compared with == */
+#ifndef TYPED_EQUAL
+#define TYPED_EQUAL(a, b) ((a) == (b))
+#endif
+
+/* Growth factor used by newly created typed vectors */
+#define TYPED_VECTOR_DEFAULT_GROWTH_FACTOR 2.0
+
+#define DEFINE_VECTOR(T) DEFINE_VECTOR_NAMED(vec_##T, T, TYPED_EQUAL)
+
+#define DEFINE_VECTOR_NAMED(name, T, equal)                                                              \
+                                                                                                         \
+/* Struct that represent a vector of T */                                                                \
+typedef struct name {                                                                                    \
+                                                                                                         \
+	/* Buffer of vector_size elements, the first length are live */                                      \
+	T* elements;                                                                                         \
+	size_t vector_size;                                                                                  \
+	size_t length;                                                                                       \
+                                                                                                         \
+	/* Factor by which the capacity gets multiplied when the buffer is full */                           \
+	double growth_factor;                                                                                \
+} name;                                                                                                  \
+                                                                                                         \
+/* Utility function used to reallocate the buffer to exactly new_capacity elements (zeroing the new ones) */ \
+static inline bool name##_util_reallocate(name* v, size_t new_capacity) {                                \
+                                                                                                         \
+	T* elements = (T*)realloc(v->elements, new_capacity * sizeof(T));                                    \
+	bool success = (elements != NULL);                                                                   \
+                                                                                                         \
+	if (success) {                                                                                       \
+		if (new_capacity > v->vector_size)                                                               \
+			memset(elements + v->vector_size, 0, (new_capacity - v->vector_size) * sizeof(T));           \
+		if (v->length > new_capacity) v->length = new_capacity;                                          \
+		v->elements = elements;                                                                          \
+		v->vector_size = new_capacity;                                                                   \
+	}                                                                                                    \
+	return success;                                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to enlarge the buffer so that it can hold at least min_capacity elements */    \
+static inline bool name##_util_grow(name* v, size_t min_capacity) {                                      \
+                                                                                                         \
+	size_t max_capacity = SIZE_MAX / sizeof(T);                                                          \
+	size_t new_capacity = max_capacity;                                                                  \
+                                                                                                         \
+	if ((double)v->vector_size * v->growth_factor < (double)max_capacity)                                \
+		new_capacity = (size_t)((double)v->vector_size * v->growth_factor);                              \
+	if (new_capacity < min_capacity) new_capacity = min_capacity;                                        \
+                                                                                                         \
+	return min_capacity <= max_capacity && name##_util_reallocate(v, new_capacity);                      \
+}                                                                                                        \
+                                                                                                         \
+/* Creates a vector that can hold vector_size elements (at least 1) before growing */                    \
+static inline name* name##_create(size_t vector_size) {                                                  \
+                                                                                                         \
+	name* v = NULL;                                                                                      \
+                                                                                                         \
+	if (vector_size > 0 && vector_size <= SIZE_MAX / sizeof(T)) {                                        \
+                                                                                                         \
+		v = (name*)malloc(sizeof(name));                                                                 \
+		if (v != NULL) {                                                                                 \
+			v->vector_size = vector_size;                                                                \
+			v->length = 0;                                                                               \
+			v->growth_factor = TYPED_VECTOR_DEFAULT_GROWTH_FACTOR;                                       \
+			v->elements = (T*)calloc(vector_size, sizeof(T));                                            \
+                                                                                                         \
+			if (v->elements == NULL) {                                                                   \
+				free(v);                                                                                 \
+				v = NULL;                                                                                \
+			}                                                                                            \
+		}                                                                                                \
+	}                                                                                                    \
+	return v;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Deletes the vector, and sets the pointer to NULL */                                                   \
+static inline void name##_delete(name** v) {                                                             \
+                                                                                                         \
+	if (v != NULL && *v != NULL) {                                                                       \
+		free((*v)->elements);                                                                            \
+		free(*v);                                                                                        \
+		*v = NULL;                                                                                       \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Writes x in the i -th position (bounded by the capacity), extending the length if needed */           \
+static inline void name##_insert_at(name* v, T x, size_t i) {                                            \
+                                                                                                         \
+	if (v != NULL && i < v->vector_size) {                                                               \
+		v->elements[i] = x;                                                                              \
+		if (i >= v->length) v->length = i + 1;                                                           \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Zeroes the i -th element */                                                                           \
+static inline void name##_remove_at(name* v, size_t i) {                                                 \
+                                                                                                         \
+	if (v != NULL && i < v->vector_size) memset(v->elements + i, 0, sizeof(T));                          \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the i -th element, NULL if i isn't less than the capacity */                     \
+static inline T* name##_get_at(name* v, size_t i) {                                                      \
+                                                                                                         \
+	return (v != NULL && i < v->vector_size) ? v->elements + i : NULL;                                   \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the buffer of the vector, valid until the next operation that can grow it */                  \
+static inline T* name##_data(name* v) {                                                                  \
+                                                                                                         \
+	return v != NULL ? v->elements : NULL;                                                               \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the capacity of the vector */                                                                 \
+static inline size_t name##_get_size(name* v) {                                                          \
+                                                                                                         \
+	return v != NULL ? v->vector_size : 0;                                                               \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of live elements */                                                                \
+static inline size_t name##_get_length(name* v) {                                                        \
+                                                                                                         \
+	return v != NULL ? v->length : 0;                                                                    \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the position of the first live element equal to x, SIZE_MAX if there is none */              \
+static inline size_t name##_find_index(name* v, T x) {                                                   \
+                                                                                                         \
+	if (v != NULL) {                                                                                     \
+		for (size_t i = 0; i < v->length; i++)                                                           \
+			if (equal(v->elements[i], x)) return i;                                                      \
+	}                                                                                                    \
+	return SIZE_MAX;                                                                                     \
+}                                                                                                        \
+                                                                                                         \
+/* Checks if x is one of the live elements, returning its position from 1 to length (0 if absent) */     \
+static inline short name##_contains(name* v, T x) {                                                      \
+                                                                                                         \
+	size_t index = name##_find_index(v, x);                                                              \
+	return index != SIZE_MAX ? (short)(index + 1) : 0;                                                   \
+}                                                                                                        \
+                                                                                                         \
+/* Zeroes every element and sets the length to 0, the memory is not deallocated */                       \
+static inline void name##_clear(name* v) {                                                               \
+                                                                                                         \
+	if (v != NULL) {                                                                                     \
+		memset(v->elements, 0, v->vector_size * sizeof(T));                                              \
+		v->length = 0;                                                                                   \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Applies f to every live element */                                                                    \
+static inline void name##_for_each(name* v, void (*f)(T*)) {                                             \
+                                                                                                         \
+	if (v != NULL && f != NULL) {                                                                        \
+		for (size_t i = 0; i < v->length; i++) f(v->elements + i);                                       \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Appends x after the last live element, growing the buffer if it is full */                           \
+static inline void name##_push_back(name* v, T x) {                                                      \
+                                                                                                         \
+	if (v != NULL && (v->length < v->vector_size || name##_util_grow(v, v->length + 1))) {               \
+		v->elements[v->length++] = x;                                                                    \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes the last live element */                                                                      \
+static inline void name##_pop_back(name* v) {                                                            \
+                                                                                                         \
+	if (v != NULL && v->length > 0) {                                                                    \
+		v->length--;                                                                                     \
+		memset(v->elements + v->length, 0, sizeof(T));                                                   \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes the last live element and copies it in buf */                                                 \
+static inline void name##_pop_2_back(name* v, T* buf) {                                                  \
+                                                                                                         \
+	if (v != NULL && buf != NULL && v->length > 0) {                                                     \
+		*buf = v->elements[v->length - 1];                                                               \
+		name##_pop_back(v);                                                                              \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Makes sure the vector can hold at least capacity elements without reallocating */                     \
+static inline void name##_reserve(name* v, size_t capacity) {                                            \
+                                                                                                         \
+	if (v != NULL && capacity > v->vector_size && capacity <= SIZE_MAX / sizeof(T))                      \
+		name##_util_reallocate(v, capacity);                                                             \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Changes the length of the vector, new elements are zeroed */                                          \
+static inline void name##_resize(name* v, size_t new_length) {                                           \
+                                                                                                         \
+	if (v != NULL) {                                                                                     \
+		if (new_length < v->length) {                                                                    \
+			memset(v->elements + new_length, 0, (v->length - new_length) * sizeof(T));                   \
+			v->length = new_length;                                                                      \
+		}                                                                                                \
+		else if (new_length <= v->vector_size ||                                                         \
+			(new_length <= SIZE_MAX / sizeof(T) && name##_util_reallocate(v, new_length))) {             \
+			v->length = new_length;                                                                      \
+		}                                                                                                \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Reduces the capacity to the length (keeping room for at least one element) */                        \
+static inline void name##_shrink_to_fit(name* v) {                                                       \
+                                                                                                         \
+	if (v != NULL) {                                                                                     \
+		size_t new_capacity = v->length > 0 ? v->length : 1;                                             \
+		if (new_capacity < v->vector_size) name##_util_reallocate(v, new_capacity);                      \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Sets the growth factor, only values greater than 1 are accepted */                                    \
+static inline void name##_set_growth_factor(name* v, double growth_factor) {                             \
+                                                                                                         \
+	if (v != NULL && growth_factor > 1.0) v->growth_factor = growth_factor;                              \
+	return;                                                                                              \
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef UNIONFIND__H
+#define UNIONFIND__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+/**
+ * Struct that represent a union-find (disjoint set forest) over the elements [0, n)
+ *
+ * Sets are merged by size and paths are halved while looking for a representative,
+ * so every operation takes nearly constant amortized time
+ */
+typedef struct unionfind unionfind;
+
+/**
+ * Creates a union-find of the given size, where every element is in its own set
+ */
+unionfind* uf_create(size_t size);
+
+/**
+ * Deletes the given union-find, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for the parents and the set sizes is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void uf_delete(unionfind** uf);
+
+/**
+ * Adds a new element in its own set and returns it, (size_t)-1 if it couldn't be added
+ */
+size_t uf_add(unionfind* uf);
+
+/**
+ * Returns the representative of the set the element is in, (size_t)-1 if the element is out of range
+ */
+size_t uf_find(unionfind* uf, size_t x);
+
+/**
+ * Merges the sets of the two elements
+ *
+ * Returns whether or not they were in different sets
+ */
+bool uf_union(unionfind* uf, size_t x, size_t y);
+
+/**
+ * Checks whether or not the two elements are in the same set
+ */
+bool uf_connected(unionfind* uf, size_t x, size_t y);
+
+/**
+ * Returns the number of elements in the set the element is in
+ */
+size_t uf_get_set_size(unionfind* uf, size_t x);
+
+/**
+ * Returns the number of disjoint sets
+ */
+size_t uf_get_set_count(unionfind* uf);
+
+/**
+ * Returns the number of elements
+ */
+size_t uf_get_size(unionfind* uf);
+
+/**
+ * Puts every element back in its own set
+ * (the union-find struct itself is not deleted)
+ */
+void uf_clear(unionfind* uf);
+
+#endif
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * Struct that represent a generic type vector
@@ -22,9 +23,19 @@ typedef struct vector vector;
 
 /**
  *  Creates a vector with the given size, ready to store elements that are 'element_size' long
+ *
+ * Buffers up to 64 bytes are stored in the same allocation as the vector (see vec_create_inline)
  */
 vector* vec_create(size_t vector_size, size_t element_size);
 
+/**
+ * Creates a vector that stores its first inline_capacity elements in the same allocation as the vector itself
+ *
+ * The capacity starts at inline_capacity, when the vector grows past it the elements move to
+ * a buffer of their own (and back in, if it shrinks to fit them). Most small vectors never allocate again
+ */
+vector* vec_create_inline(size_t inline_capacity, size_t element_size);
+
 /**
  * Deletes the given vector, since memory is allocated dinamically
  * the following actions are performed:
@@ -75,10 +86,16 @@ void* vec_get_at(vector* v, size_t i);
 void vec_get_2_at(vector* v, size_t i, void* buf);
 
 /**
- * Returns the vector size of v
+ * Returns the vector size of v, that is the number of
+ * elements it can hold without reallocating (capacity)
  */
 size_t vec_get_size(vector* v);
 
+/**
+ * Returns the logical length of v, that is the number of live elements
+ */
+size_t vec_get_length(vector* v);
+
 /**
  * Returns the element size of v
  */
@@ -87,11 +104,20 @@ size_t vec_get_element_size(vector* v);
 /**
  * Checks if the element pointed to by x is present in the vector
  *
- * The value returned is actually it's position in the array
- * from 1 to vec_get_size (needs to be adjusted by subtracting one when accessing the vector)
+ * Only the live elements are checked, the value returned is actually it's position in the array
+ * from 1 to vec_get_length (needs to be adjusted by subtracting one when accessing the vector)
  */
 short vec_contains(vector* v, void* x);
 
+/**
+ * Returns the position (from 0 to vec_get_length - 1) of the first live element equal to the one pointed to by x
+ *
+ * SIZE_MAX is returned if no element is equal to x (or the pointers are invalid)
+ *
+ * For elements that are 1, 2, 4 or 8 bytes long, many elements are compared at a time
+ */
+size_t vec_find_index(vector* v, void* x);
+
 /**
  * Checks if the i -th element of the vector is empty or not
  *
@@ -106,15 +132,146 @@ short vec_is_index_empty(vector* v, size_t i);
 void vec_clear(vector* v);
 
 /**
- * Applies the function f to every element
+ * Applies the function f to every live element
  * of the vector v
  */
 void vec_for_each(vector* v, void (*f)(void*));
 
 /**
  * Returns a vector obtained by applying 
- * the function f to every element of the vector v
+ * the function f to every live element of the vector v
  */
 vector* vec_map(vector* v, void* (*f)(void*));
 
+/**
+ * Applies the function f to every live element of the vector v, splitting
+ * the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * f gets a copy of the element, like in vec_for_each, and is called
+ * by many threads at the same time, so it must be thread safe
+ */
+void vec_parallel_for_each(vector* v, void (*f)(void*), size_t threads);
+
+/**
+ * Returns a vector obtained by applying the function f to every live element
+ * of the vector v, splitting the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * f is called by many threads at the same time, so it must be thread safe
+ * (and return a pointer that stays valid until it's called again by the same thread)
+ */
+vector* vec_parallel_map(vector* v, void* (*f)(void*), size_t threads);
+
+/**
+ * Combines every live element of the vector v into buf, starting from the value pointed to by identity,
+ * splitting the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * combine(acc, x) folds the element x into the accumulator acc (both element_size bytes), it must be
+ * associative and identity must be its neutral element, since each chunk is folded on its own
+ * and the partial results are then combined in order (so combine doesn't need to be commutative)
+ */
+void vec_reduce(vector* v, void* identity, void (*combine)(void*, void*), void* buf, size_t threads);
+
+/**
+ * Appends the element pointed to by x after the last live element
+ *
+ * If the buffer is full, its capacity is multiplied by the growth factor,
+ * so that a sequence of n appends costs O(n) amortized
+ */
+void vec_push_back(vector* v, void* x);
+
+/**
+ * Removes the last live element of the vector
+ */
+void vec_pop_back(vector* v);
+
+/**
+ * Removes the last live element of the vector and copies it in the given buffer
+ */
+void vec_pop_2_back(vector* v, void* buf);
+
+/**
+ * Makes sure the vector can hold at least capacity elements
+ * without reallocating, the length is not modified
+ */
+void vec_reserve(vector* v, size_t capacity);
+
+/**
+ * Sets the logical length of the vector to new_length
+ *
+ * If the vector grows, the new elements are all zeros
+ * If it shrinks, the removed elements are zeroed
+ */
+void vec_resize(vector* v, size_t new_length);
+
+/**
+ * Reduces the capacity of the vector to its length
+ * (a vector always keeps room for at least one element)
+ */
+void vec_shrink_to_fit(vector* v);
+
+/**
+ * Sets the factor used to enlarge the buffer when appending to a full vector
+ *
+ * The factor has to be greater than 1, otherwise the call is ignored
+ */
+void vec_set_growth_factor(vector* v, double growth_factor);
+
+/**
+ * Returns the growth factor of v
+ */
+double vec_get_growth_factor(vector* v);
+
+/**
+ * Sorts the live elements of the vector according to the compare function (not stable)
+ *
+ * Introsort: quicksort with a median of three pivot, that switches to heapsort when the
+ * recursion gets too deep (so it's always O(n log n)) and to insertion sort on small ranges
+ */
+void vec_sort(vector* v, int (*compare)(void*, void*));
+
+/**
+ * Sorts the live elements of the vector, treating them as integers (signed or unsigned)
+ *
+ * LSD radix sort on 8 bit digits, it takes O(n) time for each byte of the elements and makes no
+ * comparisons, only vectors whose elements are 1, 2, 4 or 8 bytes long are sorted, and the vector is
+ * left unchanged if the buffer needed for the passes can't be allocated
+ */
+void vec_radix_sort(vector* v, bool is_signed);
+
+/**
+ * Sorts the live elements of the vector according to the compare function, equal elements keep their order
+ *
+ * Bottom-up merge sort on runs sorted by insertion sort, it needs a buffer as big as the live elements
+ * (without it, the vector is sorted by insertion sort alone)
+ */
+void vec_stable_sort(vector* v, int (*compare)(void*, void*));
+
+/**
+ * Sorts the live elements of the vector according to the compare function (not stable), using (at most) the given number of threads
+ *
+ * The elements are split in blocks that are sorted by introsort at the same time,
+ * then the blocks are merged in pairs, many merges at the same time, until one is left
+ *
+ * The compare function is called by many threads at the same time, so it must be thread safe
+ */
+void vec_sort_parallel(vector* v, int (*compare)(void*, void*), size_t threads);
+
+/**
+ * Writes the live elements of the vector in a snapshot in the given file (which is replaced)
+ *
+ * The snapshot can be mapped back by vec_open_mmap, true is returned if it was written entirely
+ */
+bool vec_save(vector* v, const char* path);
+
+/**
+ * Maps the snapshot written by vec_save in the given file, and returns a vector that reads its elements in place
+ *
+ * Nothing is copied, so opening takes the same time whatever the length, and only the pages that are
+ * read get loaded. The vector is read-only: the functions that would modify it leave it unchanged,
+ * and the elements pointed to by vec_get_at must not be written. Deleting it unmaps the file
+ *
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of a vector
+ */
+vector* vec_open_mmap(const char* path);
+
 #endif
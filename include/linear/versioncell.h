@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef VERSIONCELL__H
+#define VERSIONCELL__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/**
+ * Header every persistent structure (PAVL, pvector) starts with
+ *
+ * Versions are reference counted, each handle the user holds is one reference,
+ * when the last one is released destroy frees the version
+ */
+typedef struct vcell_version {
+
+	/* Number of references to the version */
+	atomic_size_t refs;
+
+	/* Function that frees the version, called when the last reference is released */
+	void (*destroy)(void*);
+} vcell_version;
+
+/**
+ * Struct that represent a cell holding the current version of a persistent structure
+ *
+ * Writers build a new version aside and publish it, readers acquire the current one:
+ * acquiring never waits for writers (it takes a few atomic operations), and a reader
+ * keeps its version, unchanged, for as long as it wants. A replaced version is released
+ * once every reader that may have been reading the cell meanwhile has left it
+ */
+typedef struct vcell vcell;
+
+/**
+ * Creates a cell holding the given version (a PAVL or a pvector), the reference of the caller is moved into the cell
+ */
+vcell* vcell_create(void* version);
+
+/**
+ * Deletes the given cell, releasing the version it holds
+ *
+ * No reader nor writer may be using the cell meanwhile
+ */
+void vcell_delete(vcell** cell);
+
+/**
+ * Returns the current version, with a new reference the caller has to release (PAVL_delete, pvec_delete)
+ */
+void* vcell_acquire(vcell* cell);
+
+/**
+ * Replaces the current version with the given one, the reference of the caller is moved into the cell
+ *
+ * The replaced version is released after the readers that could be retaining it have left,
+ * so the call waits for them (only the readers inside vcell_acquire, never the ones holding a version)
+ */
+void vcell_publish(vcell* cell, void* version);
+
+/**
+ * Adds a reference to a version, returns the version itself
+ */
+void* vcell_retain(void* version);
+
+/**
+ * Releases a reference to a version, freeing it if it was the last one
+ */
+void vcell_release(void* version);
+
+#endif
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "binarynode.h"
+#include "BST.h"
 
  /**
   * Struct that implements an AVL tree, a struct that is used to store and then search
@@ -27,11 +28,47 @@
   */
 typedef struct AVL AVL;
 
+/**
+ * Struct used to walk the tree in order without allocating anything, see BST_iterator
+ */
+typedef BST_iterator AVL_iterator;
+
+/**
+ * Counters of a tree, the ones of the nodes and the rotations are zero unless built with CDS_WITH_STATS
+ */
+typedef struct AVL_stats {
+
+	/* Allocations of the nodes */
+	node_stats nodes;
+
+	/* Height of the tree */
+	size_t height;
+
+	/* Rotations made to keep the tree balanced (a double rotation counts as two) */
+	size_t rotations;
+} AVL_stats;
+
 /**
  * Creates a binary node that can store elements of the given size
  */
 AVL* AVL_create(size_t element_size, int (*compare)(void*, void*));
 
+/**
+ * Creates a tree holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * The tree is perfectly balanced and it's built in O(n) time, without comparing any element
+ */
+AVL* AVL_from_sorted(size_t element_size, int (*compare)(void*, void*), void* elements, size_t n);
+
+/**
+ * Creates a tree holding the elements of both trees (that need to store elements of the same size, ordered the
+ * same way), the two trees aren't modified
+ *
+ * The elements are merged in order and the new tree is built from them, so it's perfectly balanced and it takes O(n + m) time
+ */
+AVL* AVL_merge(AVL* a, AVL* b);
+
 /**
  * Deletes the given binary node
  */
@@ -87,6 +124,55 @@ binarynode* AVL_predecessor(AVL* avl, binarynode* bn);
  */
 binarynode* AVL_successor(AVL* avl, binarynode* bn);
 
+/**
+ * Returns the first node (in order) holding a value that is not less than x, NULL if there's none
+ */
+binarynode* AVL_lower_bound(AVL* avl, void* x);
+
+/**
+ * Returns the first node (in order) holding a value that is greater than x, NULL if there's none
+ */
+binarynode* AVL_upper_bound(AVL* avl, void* x);
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void AVL_range(AVL* avl, void* lo, void* hi, void (*callback)(void*));
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void AVL_iterator_init(AVL* avl, AVL_iterator* it, void* lo, void* hi);
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool AVL_iterator_has_next(AVL_iterator* it);
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* AVL_iterator_next(AVL_iterator* it);
+
+/**
+ * Returns the node holding the k-th smallest value (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(log n) time, since every node knows the size of its subtree
+ */
+binarynode* AVL_select(AVL* avl, size_t k);
+
+/**
+ * Returns the number of values in the tree that are less than x (x doesn't need to be in the tree)
+ *
+ * It takes O(log n) time, since every node knows the size of its subtree
+ */
+size_t AVL_rank(AVL* avl, void* x);
+
 /**
  * Traverses the tree in preorder, applying the function callback to each element
  */
@@ -132,4 +218,9 @@ void* AVL_get_compare_func(AVL* avl);
  */
 size_t AVL_get_height(AVL* avl);
 
+/**
+ * Copies in stats the counters of the tree avl
+ */
+void AVL_get_stats(AVL* avl, AVL_stats* stats);
+
 #endif
\ No newline at end of file
@@ -24,11 +24,58 @@
   */
 typedef struct BST BST;
 
+/**
+ * Struct used to walk the tree in order, from a value up to a bound, without allocating anything
+ *
+ * It's meant to be declared by the caller (for example on the stack) and initialized
+ * with BST_iterator_init, its fields shouldn't be modified directly; the tree must not
+ * be modified while it's being walked
+ */
+typedef struct BST_iterator {
+
+	/* Node holding the next value, NULL when there are no more values */
+	binarynode* node;
+
+	/* Last value the iterator can return (NULL if there's no upper bound) */
+	void* hi;
+
+	/* Function used to compare the values with the bound */
+	int (*compare)(void*, void*);
+} BST_iterator;
+
+/**
+ * Counters of a tree, the ones of the nodes are zero unless built with CDS_WITH_STATS
+ */
+typedef struct BST_stats {
+
+	/* Allocations of the nodes */
+	node_stats nodes;
+
+	/* Height of the tree */
+	size_t height;
+} BST_stats;
+
 /**
  * Creates a binary node that can store elements of the given size
  */
 BST* BST_create(size_t element_size, int (*compare)(void*, void*));
 
+/**
+ * Creates a tree holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * The tree is perfectly balanced and it's built in O(n) time, without comparing any element
+ */
+BST* BST_from_sorted(size_t element_size, int (*compare)(void*, void*), void* elements, size_t n);
+
+/**
+ * Creates a tree holding the elements of both trees (that need to store elements of the same size, ordered the
+ * same way), the two trees aren't modified
+ *
+ * The elements are merged in order and the new tree is built from them, so it's perfectly balanced and it takes O(n + m) time
+ */
+BST* BST_merge(BST* a, BST* b);
+
 /**
  * Deletes the given binary node
  */
@@ -44,7 +91,8 @@ binarynode* BST_insert(BST* bst, void* x);
 /**
  * Removes the value x from the BST, if it is present
  * 
- * Returns a pointer to the parent of the deleted node
+ * Returns a pointer to the deepest node whose subtree changed (the parent of the deleted node,
+ * or of the node that took its place when it had two children)
  */
 binarynode* BST_remove(BST* bst, void* x);
 
@@ -88,6 +136,66 @@ binarynode* BST_predecessor(BST* bst, binarynode* bn);
  */
 binarynode* BST_successor(BST* bst, binarynode* bn);
 
+/**
+ * Returns the first node (in order) holding a value that is not less than x, NULL if there's none
+ */
+binarynode* BST_lower_bound(BST* bst, void* x);
+
+/**
+ * Returns the first node (in order) holding a value that is greater than x, NULL if there's none
+ */
+binarynode* BST_upper_bound(BST* bst, void* x);
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void BST_range(BST* bst, void* lo, void* hi, void (*callback)(void*));
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void BST_iterator_init(BST* bst, BST_iterator* it, void* lo, void* hi);
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool BST_iterator_has_next(BST_iterator* it);
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* BST_iterator_next(BST_iterator* it);
+
+/**
+ * Returns the node holding the k-th smallest value (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(height) time, since every node knows the size of its subtree
+ */
+binarynode* BST_select(BST* bst, size_t k);
+
+/**
+ * Returns the number of values in the tree that are less than x (x doesn't need to be in the tree)
+ *
+ * It takes O(height) time, since every node knows the size of its subtree
+ */
+size_t BST_rank(BST* bst, void* x);
+
+/**
+ * Returns the root of the tree
+ */
+binarynode* BST_get_root(BST* bst);
+
+/**
+ * Sets the root of the tree, used by the trees built on top of the BST
+ * (such as the AVL) when they restructure it
+ */
+void BST_set_root(BST* bst, binarynode* root);
+
 /**
  * Traverses the tree in preorder, applying the function callback to each element
  */
@@ -133,4 +241,9 @@ void* BST_get_compare_func(BST* bst);
  */
 size_t BST_get_height(BST* bst);
 
+/**
+ * Copies in stats the counters of the tree bst
+ */
+void BST_get_stats(BST* bst, BST_stats* stats);
+
 #endif
\ No newline at end of file
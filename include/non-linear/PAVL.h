@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PAVL__H
+#define PAVL__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../linear/versioncell.h"
+
+ /**
+  * Struct that implements a persistent AVL tree, every version is immutable
+  *
+  * Inserting or removing doesn't modify the tree, it returns a new version that shares
+  * every untouched subtree with the old one, and copies only the O(log n) nodes on the
+  * path from the root to the changed one (path copying). Each version has to be deleted
+  * on its own, nodes are reference counted and freed once no version uses them
+  *
+  * Since versions never change, any number of threads can read them without locks,
+  * a vcell can be used to publish the latest version to the readers
+  *
+  * An AVL is a BST in which each node has a balance (difference between the left subtree's height and the right subtree's height)
+  * of either -1, 0 or 1
+  *
+  * This has a generic type value, so a compare function needs to be given
+  */
+typedef struct PAVL PAVL;
+
+/**
+ * Creates an empty tree storing elements that are as big as element_size, ordered by the compare function
+ */
+PAVL* PAVL_create(size_t element_size, int (*compare)(void*, void*));
+
+/**
+ * Releases the given version, the nodes that no other version uses are freed
+ */
+void PAVL_delete(PAVL** pavl);
+
+/**
+ * Returns another reference to the same version, that has to be deleted on its own
+ */
+PAVL* PAVL_retain(PAVL* pavl);
+
+/**
+ * Returns a new version that also holds the value x (equal values are kept, like AVL_insert does)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+PAVL* PAVL_insert(PAVL* pavl, void* x);
+
+/**
+ * Returns a new version without (one occurrence of) the value x, or one more reference to the same version if x is not present
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+PAVL* PAVL_remove(PAVL* pavl, void* x);
+
+/**
+ * Searches the value x, returns a pointer to the stored element (NULL if it is not present)
+ *
+ * The element is valid as long as the version is, and must not be written
+ */
+void* PAVL_search(PAVL* pavl, void* x);
+
+/**
+ * Checks whether or not the value x is stored in the tree
+ */
+bool PAVL_contains(PAVL* pavl, void* x);
+
+/**
+ * Returns a pointer to the smallest element (NULL if the tree is empty), that must not be written
+ */
+void* PAVL_min(PAVL* pavl);
+
+/**
+ * Returns a pointer to the biggest element (NULL if the tree is empty), that must not be written
+ */
+void* PAVL_max(PAVL* pavl);
+
+/**
+ * Applies the callback to every element in order, the elements must not be written
+ */
+void PAVL_traverse_inoder(PAVL* pavl, void (*callback)(void*));
+
+/**
+ * Returns the number of elements stored in this version
+ */
+size_t PAVL_get_size(PAVL* pavl);
+
+/**
+ * Returns the size of the elements stored in the tree
+ */
+size_t PAVL_get_element_size(PAVL* pavl);
+
+/**
+ * Checks whether or not this version is empty
+ */
+bool PAVL_is_empty(PAVL* pavl);
+
+/**
+ * Returns the height of this version (0 if it is empty)
+ */
+size_t PAVL_get_height(PAVL* pavl);
+
+#endif
\ No newline at end of file
@@ -11,11 +11,14 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "../linear/pool.h"
 
 /** 
  * Struct that implements a binary node, that can be used in binary trees
  * 
  * This has a generic type value, a left child (binary node), and a right child (binary node)
+ *
+ * The value is stored right after the struct, in the same allocation
  */
 typedef struct binarynode binarynode;
 
@@ -24,11 +27,33 @@ typedef struct binarynode binarynode;
  */
 binarynode* binarynode_create(void* x, size_t element_size);
 
+/**
+ * Creates a binary node like binarynode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least binarynode_get_footprint(element_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+binarynode* binarynode_create_in(pool* p, void* x, size_t element_size);
+
 /**
  * Deletes the given binary node
  */
 void binarynode_delete(binarynode** bn);
 
+/**
+ * Deletes the given binary node, created by binarynode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void binarynode_delete_in(pool* p, binarynode** bn);
+
+/**
+ * Returns the number of bytes used by a binary node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t binarynode_get_footprint(size_t element_size);
+
 /**
  * Returns the stored value
  */
@@ -71,6 +96,8 @@ bool binarynode_is_leaf(binarynode* bn);
 
 /**
  * Returns the height of the tree whose root is bt
+ *
+ * The height is stored in the node, the trees keep it up to date through binarynode_update
  */
 int binarynode_get_height(binarynode* bn);
 
@@ -79,4 +106,18 @@ int binarynode_get_height(binarynode* bn);
  */
 int binarynode_get_balance(binarynode* bn);
 
+/**
+ * Returns the number of nodes in the tree whose root is bn
+ *
+ * The size is stored in the node, the trees keep it up to date through binarynode_update
+ */
+size_t binarynode_get_size(binarynode* bn);
+
+/**
+ * Recomputes the height and the size of the tree whose root is bn from the ones of its children
+ *
+ * Has to be called, bottom up, on every node whose children changed
+ */
+void binarynode_update(binarynode* bn);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BLOOMFILTER__H
+#define BLOOMFILTER__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "hashfunctions.h"
+
+/**
+ * Struct that represent a bloom filter, a set of keys that can only tell
+ * for sure that a key was never added (it may answer yes for keys that weren't)
+ *
+ * keys are sequences of bytes (strings or any other data), each one sets k bits
+ * of a bitset, chosen by double hashing the two default hash functions
+ *
+ * Filters with the same number of bits, hashes and seed can be merged
+ */
+typedef struct bloomfilter bloomfilter;
+
+/**
+ * Creates a bloom filter of the given number of bits, setting the given number of bits per key
+ */
+bloomfilter* bloom_create(size_t bits, size_t hashes);
+
+/**
+ * Creates a bloom filter sized for n keys with the given false positive rate
+ */
+bloomfilter* bloom_create_for(size_t n, double fpr);
+
+/**
+ * Computes the number of bits and hashes of a filter for n keys with the given false positive rate
+ */
+void bloom_get_optimal_size(size_t n, double fpr, size_t* bits, size_t* hashes);
+
+/**
+ * Deletes the given bloom filter
+ */
+void bloom_delete(bloomfilter** bf);
+
+/**
+ * Adds the given key (a string) to the filter
+ */
+void bloom_add(bloomfilter* bf, const char* key);
+
+/**
+ * Adds the given key, of len bytes, to the filter
+ */
+void bloom_add_n(bloomfilter* bf, const void* key, size_t len);
+
+/**
+ * Checks if the given key (a string) may have been added to the filter
+ */
+bool bloom_contains(bloomfilter* bf, const char* key);
+
+/**
+ * Checks if the given key, of len bytes, may have been added to the filter
+ */
+bool bloom_contains_n(bloomfilter* bf, const void* key, size_t len);
+
+/**
+ * Adds every key of other to the filter
+ *
+ * Returns whether or not they could be merged (same number of bits, hashes and seed)
+ */
+bool bloom_merge(bloomfilter* bf, bloomfilter* other);
+
+/**
+ * Returns the expected false positive rate, given the bits set so far
+ */
+double bloom_get_fpr(bloomfilter* bf);
+
+/**
+ * Returns the number of bits of the filter
+ */
+size_t bloom_get_size(bloomfilter* bf);
+
+/**
+ * Returns the number of bits set for each key
+ */
+size_t bloom_get_hashes(bloomfilter* bf);
+
+/**
+ * Removes every key from the filter
+ */
+void bloom_clear(bloomfilter* bf);
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every filter starts with a random seed, filters that have to be
+ * merged need the same one; it can only be changed while the filter is empty
+ */
+void bloom_set_seed(bloomfilter* bf, uint64_t seed);
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t bloom_get_seed(bloomfilter* bf);
+
+#endif
\ No newline at end of file
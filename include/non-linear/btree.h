@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BTREE__H
+#define BTREE__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../linear/stats.h"
+
+/**
+ * Struct that implements a B+tree, an ordered struct like the BST and the AVL
+ * that is used to store and then search elements
+ *
+ * Each node stores many elements inline (its size is a few cache lines), so a search
+ * looks at a handful of nodes instead of one node per level of a binary tree; elements
+ * are only stored in the leaves, which are linked in order to scan them quickly
+ *
+ * Two elements that the compare function considers equal are the same element, so
+ * comparing only part of a struct (a key) makes the tree an ordered map
+ *
+ * This has a generic type value, so a compare function needs to be given
+ */
+typedef struct btree btree;
+
+/**
+ * Creates a B+tree that can store elements of the given size
+ */
+btree* btree_create(size_t element_size, int (*compare)(void*, void*));
+
+/**
+ * Deletes the given B+tree
+ */
+void btree_delete(btree** t);
+
+/**
+ * Inserts the value x in the tree, according to the compare function
+ *
+ * If an equal element is already in the tree it is replaced by x
+ */
+void btree_insert(btree* t, void* x);
+
+/**
+ * Removes the value x from the tree, if it is present
+ */
+void btree_remove(btree* t, void* x);
+
+/**
+ * Searches the value x in the tree, returns a pointer to the element equal to it (NULL if not present)
+ *
+ * The pointer is valid until the tree is modified
+ */
+void* btree_search(btree* t, void* x);
+
+/**
+ * Checks wheter or not the value x is present in the tree
+ */
+bool btree_contains(btree* t, void* x);
+
+/**
+ * Returns the minimum value in the tree
+ */
+void* btree_min(btree* t);
+
+/**
+ * Copies the minimum value in the tree inside the buffer
+ */
+void btree_min_2(btree* t, void* buf);
+
+/**
+ * Returns the maximum value in the tree
+ */
+void* btree_max(btree* t);
+
+/**
+ * Copies the maximum value in the tree inside the buffer
+ */
+void btree_max_2(btree* t, void* buf);
+
+/**
+ * Returns the greatest value in the tree that is less than x (NULL if there's none)
+ *
+ * x doesn't need to be in the tree
+ */
+void* btree_predecessor(btree* t, void* x);
+
+/**
+ * Returns the smallest value in the tree that is greater than x (NULL if there's none)
+ *
+ * x doesn't need to be in the tree
+ */
+void* btree_successor(btree* t, void* x);
+
+/**
+ * Traverses the tree in inorder, applying the function callback to each element
+ */
+void btree_traverse_inoder(btree* t, void (*callback)(void*));
+
+/**
+ * Applies the function callback, in order, to each element between from and to (both included)
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void btree_traverse_range(btree* t, void* from, void* to, void (*callback)(void*));
+
+/**
+ * Returns the number of elements in the tree
+ */
+size_t btree_get_size(btree* t);
+
+/**
+ * Returns the size of elements stored in the tree
+ */
+size_t btree_get_element_size(btree* t);
+
+/**
+ * Removes each element from the tree, the struct itself is preserved
+ */
+void btree_clear(btree* t);
+
+/**
+ * Checks wheter or not the tree is empty
+ */
+bool btree_is_empty(btree* t);
+
+/**
+ * Returns the compare function used in the tree
+ */
+void* btree_get_compare_func(btree* t);
+
+/**
+ * Returns the height of the tree
+ */
+size_t btree_get_height(btree* t);
+
+/**
+ * Copies in stats the allocation counters of the nodes of the tree
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * Each node is allocated on its own, so every allocation is also a chunk
+ */
+void btree_get_stats(btree* t, node_stats* stats);
+
+#endif
\ No newline at end of file
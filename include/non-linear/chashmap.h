@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CHASHMAP__H
+#define CHASHMAP__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "hashfunctions.h"
+
+ /**
+  * Struct that represent a concurrent hashmap, mapping keys into values
+  *
+  * keys are sequences of bytes (strings or any other data)
+  * values are of generic type
+  *
+  * Every function can be called by any number of threads at the same time:
+  *   readers never lock, each slot is protected by a sequence counter (seqlock)
+  *   writers lock one of a fixed set of stripes, chosen by the hash of the key
+  *   removed keys and replaced tables are freed only once no reader can still be looking at them (epochs)
+  *
+  * The probing is the same double hashing of the hashmap
+  */
+typedef struct chashmap chashmap;
+
+/**
+ * Creates a concurrent hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements
+ *
+ * The capacity is rounded up to a power of two and grows automatically
+ */
+chashmap* chash_create(size_t capacity, size_t element_size);
+
+/**
+ * Deletes the given concurrent hashmap
+ *
+ * The keys still stored in the hashmap are freed aswell
+ * No other thread may be using the hashmap while it is deleted
+ */
+void chash_delete(chashmap** hash);
+
+/**
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void chash_put(chashmap* hash, const char* key, void* value);
+
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void chash_put_n(chashmap* hash, const void* key, size_t len, void* value);
+
+/**
+ * Removes the element mapped by key (NUL terminated string)
+ *
+ * The key is freed once no reader can be using it anymore
+ */
+void chash_remove(chashmap* hash, const char* key);
+
+/**
+ * Removes the element mapped by the len bytes pointed to by key
+ *
+ * The key is freed once no reader can be using it anymore
+ */
+void chash_remove_n(chashmap* hash, const void* key, size_t len);
+
+/**
+ * Copies the value mapped by key (NUL terminated string) into buf
+ *
+ * Since another thread could change the value at any time, values are
+ * always copied out and never returned by pointer
+ * Returns whether or not the key was found
+ */
+bool chash_get(chashmap* hash, const char* key, void* buf);
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf
+ *
+ * Since another thread could change the value at any time, values are
+ * always copied out and never returned by pointer
+ * Returns whether or not the key was found
+ */
+bool chash_get_n(chashmap* hash, const void* key, size_t len, void* buf);
+
+/**
+ * Removes all the values in the hashmap
+ * the struct itself is preserved
+ *
+ * The stored keys are freed once no reader can be using them anymore
+ */
+void chash_clear(chashmap* hash);
+
+/**
+ * Returns the capacity of the hashmap
+ */
+size_t chash_get_capacity(chashmap* hash);
+
+/**
+ * Returns the number of couples stored in the hashmap
+ *
+ * With concurrent writers the result is only a snapshot
+ */
+size_t chash_get_size(chashmap* hash);
+
+/**
+ * Returns the size of the elements stored in the hash
+ */
+size_t chash_get_element_size(chashmap* hash);
+
+#endif
\ No newline at end of file
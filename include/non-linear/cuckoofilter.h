@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CUCKOOFILTER__H
+#define CUCKOOFILTER__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "hashfunctions.h"
+
+/**
+ * Struct that represent a cuckoo filter, a set of keys that can only tell
+ * for sure that a key was never added (it may answer yes for keys that weren't)
+ *
+ * keys are sequences of bytes (strings or any other data), each one stores a small
+ * fingerprint in one of two buckets of four slots; unlike a bloom filter, keys can be removed
+ * (only keys that were actually added, removing any other one could remove a key sharing its fingerprint)
+ *
+ * Filters with the same number of buckets, fingerprint bits and seed can be merged
+ */
+typedef struct cuckoofilter cuckoofilter;
+
+/**
+ * Creates a cuckoo filter with (at least) the given number of buckets, and fingerprints of the given number of bits
+ *
+ * The number of buckets is rounded up to a power of 2, fingerprints can have from 4 to 16 bits
+ */
+cuckoofilter* cuckoo_create(size_t buckets, size_t fingerprint_bits);
+
+/**
+ * Creates a cuckoo filter sized for n keys with the given false positive rate
+ */
+cuckoofilter* cuckoo_create_for(size_t n, double fpr);
+
+/**
+ * Computes the number of buckets and fingerprint bits of a filter for n keys with the given false positive rate
+ *
+ * The buckets are sized to be 95% full with n keys, the false positive rate can't go below 8 / 65536
+ */
+void cuckoo_get_optimal_size(size_t n, double fpr, size_t* buckets, size_t* fingerprint_bits);
+
+/**
+ * Deletes the given cuckoo filter
+ */
+void cuckoo_delete(cuckoofilter** cf);
+
+/**
+ * Adds the given key (a string) to the filter
+ *
+ * Returns whether or not it was added (false if the filter is full)
+ */
+bool cuckoo_add(cuckoofilter* cf, const char* key);
+
+/**
+ * Adds the given key, of len bytes, to the filter
+ *
+ * Returns whether or not it was added (false if the filter is full)
+ */
+bool cuckoo_add_n(cuckoofilter* cf, const void* key, size_t len);
+
+/**
+ * Removes the given key (a string), that must have been added before, from the filter
+ *
+ * Returns whether or not it was removed
+ */
+bool cuckoo_remove(cuckoofilter* cf, const char* key);
+
+/**
+ * Removes the given key, of len bytes, that must have been added before, from the filter
+ *
+ * Returns whether or not it was removed
+ */
+bool cuckoo_remove_n(cuckoofilter* cf, const void* key, size_t len);
+
+/**
+ * Checks if the given key (a string) may have been added to the filter
+ */
+bool cuckoo_contains(cuckoofilter* cf, const char* key);
+
+/**
+ * Checks if the given key, of len bytes, may have been added to the filter
+ */
+bool cuckoo_contains_n(cuckoofilter* cf, const void* key, size_t len);
+
+/**
+ * Adds every key of other to the filter
+ *
+ * Returns whether or not they could be merged (same number of buckets, fingerprint bits and seed,
+ * and enough space); if the filter fills up on the way, the keys added so far stay in it
+ */
+bool cuckoo_merge(cuckoofilter* cf, cuckoofilter* other);
+
+/**
+ * Returns the number of keys in the filter
+ */
+size_t cuckoo_get_size(cuckoofilter* cf);
+
+/**
+ * Returns the number of fingerprints the filter has space for
+ */
+size_t cuckoo_get_capacity(cuckoofilter* cf);
+
+/**
+ * Removes every key from the filter
+ */
+void cuckoo_clear(cuckoofilter* cf);
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every filter starts with a random seed, filters that have to be
+ * merged need the same one; it can only be changed while the filter is empty
+ */
+void cuckoo_set_seed(cuckoofilter* cf, uint64_t seed);
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t cuckoo_get_seed(cuckoofilter* cf);
+
+#endif
\ No newline at end of file
@@ -17,6 +17,12 @@
 /**
  * Struct that represent a graph that can store
  * nodes of  ageneric data type
+ *
+ * Four engines implement this interface, one is chosen defining its macro:
+ *   GRAPH_WITH_MATRIX -> adjacency matrix (matrixgraph.c)
+ *   GRAPH_WITH_ADJACENCY_LIST -> list of adjacency lists, with incremental connectivity and topological order (adjecencylistgraph.c)
+ *   GRAPH_WITH_EDGE_LIST -> list of edges (edgelistgraph.c)
+ *   GRAPH_WITH_CSR -> dense integer ids and compressed sparse rows built from batches of arches (csrgraph.c)
  */
 typedef struct graph graph;
 
@@ -80,4 +86,193 @@ void graph_clear_nodes(graph* g);
  */
 void graph_clear_arches(graph* g);
 
+#ifdef GRAPH_WITH_ADJACENCY_LIST
+
+#include <stdbool.h>
+
+/**
+ * Checks whether or not the two nodes are in the same connected component
+ * (weakly connected for oriented graphs, the orientation of the arches is ignored)
+ *
+ * Insertions merge the components as they happen, after a removal they're rebuilt by the next query
+ */
+bool graph_connected(graph* g, void* first, void* second);
+
+/**
+ * Checks whether or not there's a path from the node holding first to the node holding second
+ *
+ * Nodes of different components, or that come in the wrong order in the topological order
+ * of an acyclic oriented graph, are told apart without visiting anything, otherwise the
+ * search only visits the nodes that come before second in the order
+ */
+bool graph_is_reachable(graph* g, void* first, void* second);
+
+/**
+ * Applies the callback to the value of every node in topological order (each node comes before the ones its arches reach)
+ *
+ * Only oriented graphs without cycles have one, false is returned (and nothing is visited) otherwise
+ * The order is maintained as arches are inserted, so a query only sorts the nodes by their position
+ */
+bool graph_topological_order(graph* g, void (*callback)(void*));
+
+#endif
+
+#ifdef GRAPH_WITH_CSR
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Id returned when there's no node holding a value */
+#define GRAPH_NO_NODE UINT32_MAX
+
+/**
+ * Inserts a node in the graph that will hold the value x, and returns its id
+ *
+ * Ids are given in insertion order starting from 0, if the value is already
+ * in the graph the id of its node is returned (GRAPH_NO_NODE if it couldn't be inserted)
+ */
+uint32_t graph_insert_node_id(graph* g, void* x);
+
+/**
+ * Returns the id of the node that holds x, GRAPH_NO_NODE if there's none
+ */
+uint32_t graph_get_node_id(graph* g, void* x);
+
+/**
+ * Returns a pointer to the value of the node with the given id, NULL if there's no such node
+ */
+void* graph_get_node_value(graph* g, uint32_t id);
+
+/**
+ * Returns the number of nodes in the graph
+ */
+size_t graph_get_node_count(graph* g);
+
+/**
+ * Inserts n arches at once, the i-th one goes from the node with id from[i]
+ * to the node with id to[i] and weights weights[i] (every weight is 1 if weights is NULL)
+ *
+ * Arches are only collected, the compressed rows are built (in linear time)
+ * when they're needed, so inserting a whole batch before traversing is the way to go
+ *
+ * Arches between ids that don't exist, or with weights that aren't positive, are skipped,
+ * inserting an arch that's already in the graph has no effect
+ */
+void graph_insert_arches(graph* g, const uint32_t* from, const uint32_t* to, const int* weights, size_t n);
+
+/**
+ * Builds the compressed rows, if they're out of date
+ *
+ * It's done automatically by any function that reads the arches, calling it
+ * after the last insertion avoids paying for it during the first read
+ */
+void graph_build(graph* g);
+
+/**
+ * Builds the compressed rows, if they're out of date, using (at most) the given number of threads
+ *
+ * The arches are counted and scattered into their rows by all the threads at the same time,
+ * then each thread sorts a range of rows and drops its duplicates, the rows are the same
+ * graph_build would produce (only the first inserted copy of an arch is kept)
+ */
+void graph_build_parallel(graph* g, size_t threads);
+
+/**
+ * Returns the ids of the nodes adjacent to the node with the given id, sorted,
+ * their number is stored in degree and the weights of the arches
+ * (in the same order) in weights, if it's not NULL
+ *
+ * The arrays belong to the graph and are valid until it's modified
+ */
+const uint32_t* graph_get_adjacency(graph* g, uint32_t id, const int** weights, size_t* degree);
+
+
+/**
+ * Traverses breadth-first the nodes reachable from source using the given number of threads,
+ * and returns an (allocated) array with the level of each node, indexed by id
+ * (GRAPH_NO_NODE for the nodes that weren't reached), NULL if source isn't a node
+ *
+ * Each level is expanded either top-down (the threads split the frontier and look at its arches)
+ * or bottom-up (the threads split the nodes not reached yet, and each looks for an arch coming
+ * from the frontier), whichever is expected to look at fewer arches; frontiers are bitmaps when
+ * going bottom-up and nodes are marked as reached in a bitmap shared with atomic operations
+ *
+ * The callback (if not NULL) is applied to each node reached, a level at a time, by the calling thread
+ */
+uint32_t* graph_BFS_parallel(graph* g, uint32_t source, size_t threads, void (*callback)(void*));
+
+/* Distance of the nodes that can't be reached */
+#define GRAPH_UNREACHABLE INT64_MAX
+
+/**
+ * Computes the length of the shortest path from source to every node, and returns
+ * an (allocated) array of distances indexed by id (GRAPH_UNREACHABLE for the nodes that
+ * can't be reached), NULL if source isn't a node
+ *
+ * If predecessors isn't NULL an (allocated) array is stored in it, with the id of the node
+ * that comes before each one in its shortest path (GRAPH_NO_NODE for source and the nodes not reached)
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log V) time
+ */
+int64_t* graph_dijkstra(graph* g, uint32_t source, uint32_t** predecessors);
+
+/**
+ * Computes the length of the shortest path from source to target, and returns it
+ * (GRAPH_UNREACHABLE if there's no such path, or the ids aren't nodes)
+ *
+ * The heuristic estimates the length of the path left from (the value of) a node to (the value of) target,
+ * the path is the shortest one as long as it never overestimates it; nodes are expanded in order of the
+ * length so far plus the estimate, so fewer nodes are looked at than with graph_dijkstra (NULL estimates 0)
+ *
+ * If path isn't NULL an (allocated) array with the ids of the nodes on the path, from source to target,
+ * is stored in it and its length in length (NULL and 0 if there's no path)
+ */
+int64_t graph_astar(graph* g, uint32_t source, uint32_t target, double (*heuristic)(void* from, void* to), uint32_t** path, size_t* length);
+
+/**
+ * Computes a minimum spanning forest growing a tree from a node of each component, and returns
+ * its weight (-1 if the graph is oriented)
+ *
+ * If from and to aren't NULL the arches of the forest are copied in them (they
+ * must have room for graph_get_node_count(g) - 1 ids), their number is stored in count
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log V) time
+ */
+int64_t graph_prim(graph* g, uint32_t* from, uint32_t* to, size_t* count);
+
+/**
+ * Computes a minimum spanning forest adding the arches by increasing weight, skipping the ones
+ * that would close a cycle, and returns its weight (-1 if the graph is oriented)
+ *
+ * If from and to aren't NULL the arches of the forest are copied in them (they
+ * must have room for graph_get_node_count(g) - 1 ids), their number is stored in count
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log E) time
+ */
+int64_t graph_kruskal(graph* g, uint32_t* from, uint32_t* to, size_t* count);
+
+/**
+ * Writes the graph in a snapshot in the given file (which is replaced): the compressed
+ * rows as they are, the value of every node and a table mapping each value to its id
+ *
+ * The rows are built first, the snapshot can be mapped back by graph_open_mmap,
+ * true is returned if it was written entirely
+ */
+bool graph_save(graph* g, const char* path);
+
+/**
+ * Maps the snapshot written by graph_save in the given file, and returns a graph that reads its rows,
+ * values and ids in place, so that traversals and lookups run on it without building anything
+ *
+ * Nothing is copied, so opening takes the same time whatever the size of the graph, and only the pages
+ * that are read get loaded. The graph is read-only: the functions that would modify it leave it unchanged,
+ * and the values and weights it returns must not be written. Deleting it unmaps the file
+ *
+ * The header of the snapshot and the bounds of its sections are checked, the rows themselves are trusted
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of a graph of this engine
+ */
+graph* graph_open_mmap(const char* path);
+
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef GRAPHBUILDER__H
+#define GRAPHBUILDER__H
+
+#ifdef GRAPH_WITH_CSR
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "graph.h"
+
+/**
+ * Struct that represent a builder, that loads a (CSR) graph from a stream of arches
+ *
+ * Arches are collected in chunks: the values of their nodes are looked up (and inserted
+ * when new) in the hash table of the graph as they arrive, so that every node costs one
+ * lookup instead of a search among all the nodes, and each full chunk of ids is passed
+ * to the graph at once. Besides the graph itself, the builder only holds one chunk
+ *
+ * Finishing the builder builds the compressed rows of the graph in parallel
+ */
+typedef struct graph_builder graph_builder;
+
+/**
+ * Creates a builder for a graph of nodes that are as big as element_size, with the given flags,
+ * that passes the arches to the graph chunk_size at a time (a default size is used if it's 0)
+ */
+graph_builder* gb_create(size_t element_size, int flags, size_t chunk_size);
+
+/**
+ * Deletes the given builder, and the graph it was building (unless it was finished)
+ */
+void gb_delete(graph_builder** b);
+
+/**
+ * Adds an arch between the nodes holding first and second, with the given weight,
+ * the nodes are inserted in the graph the first time their value is seen
+ *
+ * Arches whose weight isn't positive are skipped
+ */
+void gb_add_arch(graph_builder* b, const void* first, const void* second, int weight);
+
+/**
+ * Adds the arches produced by next, which is called until it returns false
+ *
+ * Each call writes the values of the two nodes in first and second (buffers that are as big
+ * as the elements) and the weight in weight (already set to 1), the number of arches added is returned
+ */
+size_t gb_add_stream(graph_builder* b, bool (*next)(void* context, void* first, void* second, int* weight), void* context);
+
+/**
+ * Adds the arches read from a binary file, till its end
+ *
+ * Each arch is a record made of the bytes of the first node, the bytes of the second one,
+ * and (only for weighted graphs) an int with the weight, the records are read a chunk at a time
+ * The number of arches read is returned
+ */
+size_t gb_add_file(graph_builder* b, FILE* file);
+
+/**
+ * Passes the last chunk to the graph, builds its compressed rows using (at most)
+ * the given number of threads and returns it, the graph belongs to the caller
+ *
+ * The builder starts again with an empty graph, so it can be reused (or deleted)
+ */
+graph* gb_finish(graph_builder* b, size_t threads);
+
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef HASHFUNCTIONS__H
+#define HASHFUNCTIONS__H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/**
+ * Hash functions that can be used by the hashmap (and any other hash based structure)
+ *
+ * Every function hashes the len bytes pointed to by key, the seed
+ * changes the whole output, so that the positions of a given set of keys
+ * can't be predicted without knowing it
+ */
+
+/**
+ * wyhash, fast hash that processes 16/48 bytes per step through 64x64 -> 128 bit multiplications
+ *
+ * Used by default by the hashmap
+ */
+size_t hash_util_wyhash(const void* key, size_t len, uint64_t seed);
+
+/**
+ * xxHash64, processes 32 bytes per step in four independent lanes
+ */
+size_t hash_util_xxh64(const void* key, size_t len, uint64_t seed);
+
+/**
+ * djb2 (hash * 33 + c), simple byte at a time hash
+ */
+size_t hash_util_djb2(const void* key, size_t len, uint64_t seed);
+
+/**
+ * Default hash function, used for the position of the keys
+ */
+size_t hash_util_default_hash(const void* key, size_t len, uint64_t seed);
+
+/**
+ * Default second hash function, independent from the first one
+ * (same key and seed produce unrelated values)
+ */
+size_t hash_util_default_second_hash(const void* key, size_t len, uint64_t seed);
+
+/**
+ * Returns a seed that is different for every call and every run of the program
+ */
+uint64_t hash_util_random_seed(void);
+
+#endif
\ No newline at end of file
@@ -11,49 +11,159 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "hashfunctions.h"
+#include "../linear/stats.h"
 
  /**
   * Struct that represent an hashmap, mapping keys into values
   * 
-  * keys are strings
+  * keys are sequences of bytes (strings or any other data)
   * values are of generic type
+  *
+  * Two engines implement this interface:
+  *   default -> open addressing with double hashing and incremental rehash (hashmap.c)
+  *   HASHMAP_WITH_FLAT_TABLE -> flat table with grouped control bytes, probed 16 slots at a time (flathashmap.c)
   */
 typedef struct hashmap hashmap;
 
+/**
+ * Counters of an hashmap, see hash_get_stats
+ */
+typedef struct hash_stats {
+
+	/* Couples stored, slots of the table(s) and deleted slots (tombstones) among them */
+	size_t count;
+	size_t capacity;
+	size_t tombstones;
+
+	/* Ratio between used (occupied + deleted) slots and capacity */
+	double load;
+
+	/* Probe sequences walked, their total and maximum length, and the average one */
+	size_t lookups;
+	size_t probes;
+	size_t max_probe;
+	double average_probe;
+
+	/* Number of times the table was rebuilt, to grow or to drop the tombstones */
+	size_t rehashes;
+
+	/* Whether or not the counters were compiled in */
+	bool enabled;
+} hash_stats;
+
 /**
  * Creates an hashmap that stores values that are as big as element_size
- * and can store at most max_size elements
+ * starting with room for at least capacity elements
+ *
+ * The capacity is rounded up to a power of two and grows automatically
  */
-hashmap* hash_create(size_t max_size, size_t element_size);
+hashmap* hash_create(size_t capacity, size_t element_size);
+
+/**
+ * Creates an hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements, and that keeps its own copy of the keys
+ *
+ * Keys up to 15 bytes are stored in their slot, the longer ones are appended to an arena,
+ * so inserting never allocates a key on its own and the callers keep (and free) the keys they pass
+ * The arena is compacted by rehashing, the keys of the removed couples are dropped then
+ */
+hashmap* hash_create_interned(size_t capacity, size_t element_size);
 
 /**
  * Deletes the given hashmap
+ *
+ * The keys still stored in the hashmap are freed aswell (unless they're interned)
  */
 void hash_delete(hashmap** hash);
 
 /**
- * Inserts a couple <key, value>
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
  */
 void hash_put(hashmap* hash, const char* key, void* value);
 
 /**
- * Removes the element mapped by key
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void hash_put_n(hashmap* hash, const void* key, size_t len, void* value);
+
+/**
+ * Removes the element mapped by key (NUL terminated string)
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
  */
 void hash_remove(hashmap* hash, const char* key);
 
 /**
- * Returns the value mapped by key
+ * Removes the element mapped by the len bytes pointed to by key
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
+ */
+void hash_remove_n(hashmap* hash, const void* key, size_t len);
+
+/**
+ * Returns the value mapped by key (NUL terminated string)
  */
 void* hash_get(hashmap* hash, const char* key);
 
 /**
- * Copies the value mapped by key into buf
+ * Returns the value mapped by the len bytes pointed to by key
+ */
+void* hash_get_n(hashmap* hash, const void* key, size_t len);
+
+/**
+ * Copies the value mapped by key (NUL terminated string) into buf
  */
 void hash_get_2(hashmap* hash, const char* key, void* buf);
 
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf
+ */
+void hash_get_2_n(hashmap* hash, const void* key, size_t len, void* buf);
+
+/**
+ * Inserts n couples <keys[i], value i>, values points to n contiguous elements
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
+ */
+void hash_put_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void* values);
+
+/**
+ * Removes the elements mapped by the n given keys
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved
+ */
+void hash_remove_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n);
+
+/**
+ * Looks up n keys at once, values[i] is set to the value mapped by keys[i] (NULL if absent)
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
+ */
+void hash_get_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void** values);
+
 /**
  * Removes all the values in the hashmap
  * the struct itself is preserved
+ *
+ * The stored keys are freed
  */
 void hash_clear(hashmap* hash);
 
@@ -62,19 +172,94 @@ void hash_clear(hashmap* hash);
  */
 size_t hash_get_capacity(hashmap* hash);
 
+/**
+ * Returns the number of couples stored in the hashmap
+ */
+size_t hash_get_size(hashmap* hash);
+
 /**
  * Returns the size of the elements stored in the hash
  */
 size_t hash_get_element_size(hashmap* hash);
 
 /**
- * Sets a custom hash function
+ * Sets the maximum load factor, that is the maximum ratio between
+ * used (occupied and deleted) slots and capacity, above which the
+ * hashmap is rehashed into a bigger table
+ *
+ * The value has to be between 0 and 1 (both excluded), otherwise the call is ignored
+ */
+void hash_set_max_load(hashmap* hash, double max_load);
+
+/**
+ * Returns the maximum load factor of the hashmap
+ */
+double hash_get_max_load(hashmap* hash);
+
+/**
+ * Checks whether or not an incremental rehash is in progress
+ *
+ * While rehashing, each operation moves a few couples from
+ * the old table to the new one, so that no single insertion pays for the whole rehash
  */
-void hash_set_function(hashmap* hash, size_t(*map)(const char*));
+bool hash_is_rehashing(hashmap* hash);
+
+/**
+ * Copies in stats the counters of the hashmap
+ *
+ * Probe lengths are counted in slots by the default engine and in groups of 16 slots by the flat one,
+ * lookups, probes and rehashes stay at zero unless the library is built with CDS_WITH_STATS
+ */
+void hash_get_stats(hashmap* hash, hash_stats* stats);
 
 /**
  * Sets a custom hash function
+ *
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
+ */
+void hash_set_function(hashmap* hash, size_t(*map)(const void*, size_t, uint64_t));
+
+/**
+ * Sets a custom second hash function, used to determine the probe step
+ *
+ * NULL (the default) derives the step from the first hash, without hashing the key twice
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
+ */
+void hash_set_second_function(hashmap* hash, size_t(*map2)(const void*, size_t, uint64_t));
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every hashmap starts with a random seed, so that a given set of keys
+ * can't be crafted to collide, this can be used to get reproducible layouts
+ * It can only be changed while the hashmap is empty
+ */
+void hash_set_seed(hashmap* hash, uint64_t seed);
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t hash_get_seed(hashmap* hash);
+
+/**
+ * Writes the couples of the hashmap in a snapshot in the given file (which is replaced)
+ *
+ * The snapshot doesn't depend on the engine nor on the hash function of the hashmap,
+ * it can be mapped back by hash_open_mmap, true is returned if it was written entirely
+ */
+bool hash_save(hashmap* hash, const char* path);
+
+/**
+ * Maps the snapshot written by hash_save in the given file, and returns an hashmap that looks keys up in place
+ *
+ * Nothing is copied or rehashed, so opening takes the same time whatever the number of couples, and
+ * only the pages that are read get loaded. The hashmap is read-only: the functions that would modify it
+ * leave it unchanged, and the values returned by hash_get must not be written. Deleting it unmaps the file
+ *
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of an hashmap
  */
-void hash_set_second_function(hashmap* hash, size_t(*map2)(const char*));
+hashmap* hash_open_mmap(const char* path);
 
 #endif
\ No newline at end of file
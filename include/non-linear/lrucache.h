@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef LRUCACHE__H
+#define LRUCACHE__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../linear/stats.h"
+
+/**
+ * Struct that represent a cache, mapping keys into values, that holds at most
+ * a given number of bytes and drops entries by itself to make room for new ones
+ *
+ * keys are sequences of bytes (strings or any other data), values are of generic type;
+ * each entry is charged the length of its key plus the size of the values
+ *
+ * Two policies are available:
+ *   LRU -> the least recently used entry is dropped
+ *   W-TinyLFU -> new entries go through a small LRU window (1% of the capacity), the entry leaving it
+ *                only gets in the main part (a segmented LRU) if it was used more often than the
+ *                entry that would leave the main part for it; uses are counted by a small aging sketch,
+ *                so entries seen once (scans) don't push out the ones used often
+ *
+ * Every operation is O(1): entries are nodes of lists (dnode) whose links are updated
+ * in place, and the hashmap maps each key to its node
+ */
+typedef struct lrucache lrucache;
+
+/**
+ * Creates an LRU cache that holds at most capacity bytes of entries, whose values are as big as element_size
+ */
+lrucache* lru_create(size_t capacity, size_t element_size);
+
+/**
+ * Creates a W-TinyLFU cache that holds at most capacity bytes of entries, whose values are as big as element_size
+ */
+lrucache* lru_create_tinylfu(size_t capacity, size_t element_size);
+
+/**
+ * Deletes the given cache, the eviction callback is called on every entry still in it
+ */
+void lru_delete(lrucache** c);
+
+/**
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * The key is copied, if it's already present its value is replaced,
+ * entries are dropped (calling the eviction callback) until the new one fits
+ */
+void lru_put(lrucache* c, const char* key, void* value);
+
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * The key is copied, if it's already present its value is replaced,
+ * entries are dropped (calling the eviction callback) until the new one fits
+ */
+void lru_put_n(lrucache* c, const void* key, size_t len, void* value);
+
+/**
+ * Returns the value mapped by key (NUL terminated string), and marks it as used
+ *
+ * The value is valid until the entry is dropped, NULL is returned if it's not in the cache
+ */
+void* lru_get(lrucache* c, const char* key);
+
+/**
+ * Returns the value mapped by the len bytes pointed to by key, and marks it as used
+ *
+ * The value is valid until the entry is dropped, NULL is returned if it's not in the cache
+ */
+void* lru_get_n(lrucache* c, const void* key, size_t len);
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf, and marks it as used
+ *
+ * Returns whether or not the key was in the cache
+ */
+bool lru_get_2_n(lrucache* c, const void* key, size_t len, void* buf);
+
+/**
+ * Returns the value mapped by the len bytes pointed to by key, without marking it as used
+ * nor counting it as a hit or a miss
+ */
+void* lru_peek_n(lrucache* c, const void* key, size_t len);
+
+/**
+ * Removes the entry of key (NUL terminated string), the eviction callback isn't called
+ */
+void lru_remove(lrucache* c, const char* key);
+
+/**
+ * Removes the entry of the len bytes pointed to by key, the eviction callback isn't called
+ */
+void lru_remove_n(lrucache* c, const void* key, size_t len);
+
+/**
+ * Removes every entry, calling the eviction callback on each one
+ */
+void lru_clear(lrucache* c);
+
+/**
+ * Sets the function called on every entry the cache drops by itself (to make room, or by clear and delete)
+ * right before it's freed, context is passed to each call
+ */
+void lru_set_eviction_callback(lrucache* c, void (*on_evict)(const void* key, size_t len, void* value, void* context), void* context);
+
+/**
+ * Returns the number of entries in the cache
+ */
+size_t lru_get_count(lrucache* c);
+
+/**
+ * Returns the number of bytes charged for the entries in the cache
+ */
+size_t lru_get_bytes(lrucache* c);
+
+/**
+ * Returns the capacity of the cache, in bytes
+ */
+size_t lru_get_capacity(lrucache* c);
+
+/**
+ * Returns the size of the values stored in the cache
+ */
+size_t lru_get_element_size(lrucache* c);
+
+/**
+ * Returns the number of lookups that found their key
+ */
+uint64_t lru_get_hits(lrucache* c);
+
+/**
+ * Returns the number of lookups that didn't find their key
+ */
+uint64_t lru_get_misses(lrucache* c);
+
+/**
+ * Returns the number of entries dropped to make room for others
+ */
+uint64_t lru_get_evictions(lrucache* c);
+
+/**
+ * Returns the ratio between hits and lookups (0 before the first lookup)
+ */
+double lru_get_hit_ratio(lrucache* c);
+
+/**
+ * Sets the hits, misses and evictions back to 0
+ */
+void lru_reset_stats(lrucache* c);
+
+/**
+ * Copies in stats the allocation counters of the nodes of the entries
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * Hits, misses and evictions are read by their own functions, lru_reset_stats doesn't touch these counters
+ */
+void lru_get_stats(lrucache* c, node_stats* stats);
+
+#endif
\ No newline at end of file
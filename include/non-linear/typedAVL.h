@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TYPEDAVL__H
+#define TYPEDAVL__H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../linear/pool.h"
+
+/**
+ * Type specialized AVL tree, generated by macro for a given element type and compare function
+ *
+ * Same algorithm and semantics of AVL (AVL.h): duplicates are allowed, every node
+ * knows its height and the size of its subtree (so select and rank take O(log n)),
+ * nodes are taken from a pool owned by the tree. Elements are typed values and the
+ * compare is inlined, instead of being called through a function pointer
+ *
+ *   DEFINE_AVL(uint64_t, cmp)              generates the type AVL_uint64_t and AVL_uint64_t_create, ..
+ *   DEFINE_AVL_NAMED(points, point, cmp)   generates the type points, for a type name that isn't a single identifier
+ *
+ * cmp(a, b) takes two values and returns a negative number, zero or a positive
+ * number if a is less, equal or greater than b, it can be a macro or a function
+ * (TYPED_COMPARE works for any type that can be compared with < and >)
+ *
+ * The generated struct is defined in the header, since every function using it is inlined,
+ * it should still only be accessed through the functions
+ */
+
+/* Compare for types that can be compared with < and > */
+#ifndef TYPED_COMPARE
+#define TYPED_COMPARE(a, b) (((a) > (b)) - ((a) < (b)))
+#endif
+
+#define DEFINE_AVL(T, cmp) DEFINE_AVL_NAMED(AVL_##T, T, cmp)
+
+#define DEFINE_AVL_NAMED(name, T, cmp)                                                                   \
+                                                                                                         \
+/* Node of the tree, with the height and the size of the subtree it is the root of */                    \
+typedef struct name##_node {                                                                             \
+	T value;                                                                                             \
+	struct name##_node* left;                                                                            \
+	struct name##_node* right;                                                                           \
+	int height;                                                                                          \
+	size_t size;                                                                                         \
+} name##_node;                                                                                           \
+                                                                                                         \
+/* Struct that represent an AVL tree of T */                                                             \
+typedef struct name {                                                                                    \
+	name##_node* root;                                                                                   \
+	pool* nodes;                                                                                         \
+} name;                                                                                                  \
+                                                                                                         \
+/* Utility functions that return the height and the size of a (possibly empty) subtree */                \
+static inline int name##_util_height(name##_node* n) {                                                   \
+                                                                                                         \
+	return n ? n->height : 0;                                                                            \
+}                                                                                                        \
+                                                                                                         \
+static inline size_t name##_util_size(name##_node* n) {                                                  \
+                                                                                                         \
+	return n ? n->size : 0;                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to recompute the height and size of a node from its children */                 \
+static inline void name##_util_update(name##_node* n) {                                                  \
+                                                                                                         \
+	int hl = name##_util_height(n->left), hr = name##_util_height(n->right);                             \
+	n->height = (hl > hr ? hl : hr) + 1;                                                                 \
+	n->size = name##_util_size(n->left) + name##_util_size(n->right) + 1;                                \
+}                                                                                                        \
+                                                                                                         \
+/* Utility functions used to rotate the subtree rooted in n, returning the new root */                   \
+static inline name##_node* name##_util_rotate_right(name##_node* n) {                                    \
+                                                                                                         \
+	name##_node* l = n->left;                                                                            \
+	n->left = l->right;                                                                                  \
+	l->right = n;                                                                                        \
+	name##_util_update(n);                                                                               \
+	name##_util_update(l);                                                                               \
+	return l;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+static inline name##_node* name##_util_rotate_left(name##_node* n) {                                     \
+                                                                                                         \
+	name##_node* r = n->right;                                                                           \
+	n->right = r->left;                                                                                  \
+	r->left = n;                                                                                         \
+	name##_util_update(n);                                                                               \
+	name##_util_update(r);                                                                               \
+	return r;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to restore the balance of a subtree whose children are balanced */              \
+static inline name##_node* name##_util_rebalance(name##_node* n) {                                       \
+                                                                                                         \
+	name##_util_update(n);                                                                               \
+	int balance = name##_util_height(n->left) - name##_util_height(n->right);                            \
+                                                                                                         \
+	if (balance > 1) {                                                                                   \
+		if (name##_util_height(n->left->left) < name##_util_height(n->left->right))                      \
+			n->left = name##_util_rotate_left(n->left);                                                  \
+		n = name##_util_rotate_right(n);                                                                 \
+	}                                                                                                    \
+	else if (balance < -1) {                                                                             \
+		if (name##_util_height(n->right->right) < name##_util_height(n->right->left))                    \
+			n->right = name##_util_rotate_right(n->right);                                               \
+		n = name##_util_rotate_left(n);                                                                  \
+	}                                                                                                    \
+	return n;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to insert the node x in the subtree rooted in n (equal values go right) */      \
+static inline name##_node* name##_util_insert(name##_node* n, name##_node* x) {                          \
+                                                                                                         \
+	if (!n) return x;                                                                                    \
+	if (cmp(x->value, n->value) < 0) n->left = name##_util_insert(n->left, x);                           \
+	else n->right = name##_util_insert(n->right, x);                                                     \
+	return name##_util_rebalance(n);                                                                     \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to detach the minimum of the subtree rooted in n, stored in min */              \
+static inline name##_node* name##_util_remove_min(name##_node* n, name##_node** min) {                   \
+                                                                                                         \
+	if (!n->left) {                                                                                      \
+		*min = n;                                                                                        \
+		return n->right;                                                                                 \
+	}                                                                                                    \
+	n->left = name##_util_remove_min(n->left, min);                                                      \
+	return name##_util_rebalance(n);                                                                     \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to remove one node holding x from the subtree rooted in n */                    \
+static inline name##_node* name##_util_remove(name* t, name##_node* n, T x) {                            \
+                                                                                                         \
+	if (!n) return NULL;                                                                                 \
+                                                                                                         \
+	int c = cmp(x, n->value);                                                                            \
+	if (c < 0) n->left = name##_util_remove(t, n->left, x);                                              \
+	else if (c > 0) n->right = name##_util_remove(t, n->right, x);                                       \
+	else {                                                                                               \
+		name##_node* removed = n;                                                                        \
+                                                                                                         \
+		/* With two children, the successor takes the place of the node */                              \
+		if (!n->left) n = n->right;                                                                      \
+		else if (!n->right) n = n->left;                                                                 \
+		else {                                                                                           \
+			name##_node* successor = NULL;                                                               \
+			name##_node* right = name##_util_remove_min(n->right, &successor);                           \
+			successor->left = n->left;                                                                   \
+			successor->right = right;                                                                    \
+			n = successor;                                                                               \
+		}                                                                                                \
+		pool_free(t->nodes, removed);                                                                    \
+		if (!n) return NULL;                                                                             \
+	}                                                                                                    \
+	return name##_util_rebalance(n);                                                                     \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to apply callback, in order, to the values between lo and hi */                 \
+static inline void name##_util_range(name##_node* n, T lo, T hi, void (*callback)(T*)) {                 \
+                                                                                                         \
+	while (n) {                                                                                          \
+		if (cmp(n->value, lo) < 0) n = n->right;                                                         \
+		else if (cmp(n->value, hi) > 0) n = n->left;                                                     \
+		else {                                                                                           \
+			name##_util_range(n->left, lo, hi, callback);                                                \
+			callback(&n->value);                                                                         \
+			n = n->right;                                                                                \
+		}                                                                                                \
+	}                                                                                                    \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to apply callback to every value of the subtree, in order */                    \
+static inline void name##_util_inorder(name##_node* n, void (*callback)(T*)) {                           \
+                                                                                                         \
+	while (n) {                                                                                          \
+		name##_util_inorder(n->left, callback);                                                          \
+		callback(&n->value);                                                                             \
+		n = n->right;                                                                                    \
+	}                                                                                                    \
+}                                                                                                        \
+                                                                                                         \
+/* Creates an empty tree */                                                                              \
+static inline name* name##_create(void) {                                                                \
+                                                                                                         \
+	name* t = (name*)malloc(sizeof(name));                                                               \
+                                                                                                         \
+	if (t) {                                                                                             \
+		t->root = NULL;                                                                                  \
+		t->nodes = pool_create(sizeof(name##_node));                                                     \
+		if (!t->nodes) {                                                                                 \
+			free(t);                                                                                     \
+			t = NULL;                                                                                    \
+		}                                                                                                \
+	}                                                                                                    \
+	return t;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Deletes the tree, and sets the pointer to NULL */                                                     \
+static inline void name##_delete(name** t) {                                                             \
+                                                                                                         \
+	if (t && *t) {                                                                                       \
+		pool_delete(&(*t)->nodes);                                                                       \
+		free(*t);                                                                                        \
+		*t = NULL;                                                                                       \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Inserts x in the tree (duplicates are allowed) */                                                     \
+static inline void name##_insert(name* t, T x) {                                                         \
+                                                                                                         \
+	name##_node* n = t ? (name##_node*)pool_alloc(t->nodes) : NULL;                                      \
+                                                                                                         \
+	if (n) {                                                                                             \
+		n->value = x;                                                                                    \
+		n->left = NULL;                                                                                  \
+		n->right = NULL;                                                                                 \
+		n->height = 1;                                                                                   \
+		n->size = 1;                                                                                     \
+		t->root = name##_util_insert(t->root, n);                                                        \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes (one occurrence of) x from the tree, if it is present */                                      \
+static inline void name##_remove(name* t, T x) {                                                         \
+                                                                                                         \
+	if (t) t->root = name##_util_remove(t, t->root, x);                                                  \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to a value equal to x, NULL if there's none */                                      \
+static inline T* name##_search(name* t, T x) {                                                           \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+                                                                                                         \
+	while (n) {                                                                                          \
+		int c = cmp(x, n->value);                                                                        \
+		if (c == 0) return &n->value;                                                                    \
+		n = c < 0 ? n->left : n->right;                                                                  \
+	}                                                                                                    \
+	return NULL;                                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Checks whether x is present in the tree */                                                            \
+static inline bool name##_contains(name* t, T x) {                                                       \
+                                                                                                         \
+	return name##_search(t, x) != NULL;                                                                  \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the smallest value, NULL if the tree is empty */                                 \
+static inline T* name##_min(name* t) {                                                                   \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+	while (n && n->left) n = n->left;                                                                    \
+	return n ? &n->value : NULL;                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the greatest value, NULL if the tree is empty */                                 \
+static inline T* name##_max(name* t) {                                                                   \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+	while (n && n->right) n = n->right;                                                                  \
+	return n ? &n->value : NULL;                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the first value (in order) not less than x, NULL if there's none */              \
+static inline T* name##_lower_bound(name* t, T x) {                                                      \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+	T* res = NULL;                                                                                       \
+                                                                                                         \
+	while (n) {                                                                                          \
+		if (cmp(n->value, x) < 0) n = n->right;                                                          \
+		else {                                                                                           \
+			res = &n->value;                                                                             \
+			n = n->left;                                                                                 \
+		}                                                                                                \
+	}                                                                                                    \
+	return res;                                                                                          \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the first value (in order) greater than x, NULL if there's none */               \
+static inline T* name##_upper_bound(name* t, T x) {                                                      \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+	T* res = NULL;                                                                                       \
+                                                                                                         \
+	while (n) {                                                                                          \
+		if (cmp(n->value, x) <= 0) n = n->right;                                                         \
+		else {                                                                                           \
+			res = &n->value;                                                                             \
+			n = n->left;                                                                                 \
+		}                                                                                                \
+	}                                                                                                    \
+	return res;                                                                                          \
+}                                                                                                        \
+                                                                                                         \
+/* Applies callback, in order, to each value between lo and hi (both included) */                        \
+static inline void name##_range(name* t, T lo, T hi, void (*callback)(T*)) {                             \
+                                                                                                         \
+	if (t && callback) name##_util_range(t->root, lo, hi, callback);                                     \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Applies callback to every value, in order */                                                          \
+static inline void name##_traverse_inorder(name* t, void (*callback)(T*)) {                              \
+                                                                                                         \
+	if (t && callback) name##_util_inorder(t->root, callback);                                           \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the k-th smallest value (starting from 0), NULL if k isn't less than the size */ \
+static inline T* name##_select(name* t, size_t k) {                                                      \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+                                                                                                         \
+	while (n) {                                                                                          \
+		size_t left = name##_util_size(n->left);                                                         \
+		if (k == left) return &n->value;                                                                 \
+		if (k < left) n = n->left;                                                                       \
+		else {                                                                                           \
+			k -= left + 1;                                                                               \
+			n = n->right;                                                                                \
+		}                                                                                                \
+	}                                                                                                    \
+	return NULL;                                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of values in the tree that are less than x */                                      \
+static inline size_t name##_rank(name* t, T x) {                                                         \
+                                                                                                         \
+	name##_node* n = t ? t->root : NULL;                                                                 \
+	size_t rank = 0;                                                                                     \
+                                                                                                         \
+	while (n) {                                                                                          \
+		if (cmp(n->value, x) < 0) {                                                                      \
+			rank += name##_util_size(n->left) + 1;                                                       \
+			n = n->right;                                                                                \
+		}                                                                                                \
+		else n = n->left;                                                                                \
+	}                                                                                                    \
+	return rank;                                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of values in the tree */                                                           \
+static inline size_t name##_get_size(name* t) {                                                          \
+                                                                                                         \
+	return t ? name##_util_size(t->root) : 0;                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the height of the tree (0 when empty) */                                                      \
+static inline size_t name##_get_height(name* t) {                                                        \
+                                                                                                         \
+	return t ? (size_t)name##_util_height(t->root) : 0;                                                  \
+}                                                                                                        \
+                                                                                                         \
+/* Checks whether the tree contains at least one value */                                                \
+static inline bool name##_is_empty(name* t) {                                                            \
+                                                                                                         \
+	return t ? t->root == NULL : false;                                                                  \
+}                                                                                                        \
+                                                                                                         \
+/* Removes every value, the tree itself is not deleted */                                                \
+static inline void name##_clear(name* t) {                                                               \
+                                                                                                         \
+	if (t) {                                                                                             \
+		pool_clear(t->nodes);                                                                            \
+		t->root = NULL;                                                                                  \
+	}                                                                                                    \
+	return;                                                                                              \
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TYPEDHASHMAP__H
+#define TYPEDHASHMAP__H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Type specialized hashmap, generated by macro for a given key and value type
+ *
+ * Same layout of the flat engine of hashmap (one control byte per slot, holding
+ * either empty, deleted or a 7 bit fingerprint of the key), but keys and values are
+ * typed and stored in their own arrays, hashed and compared by inlinable code
+ * instead of function pointers over byte sequences
+ *
+ *   DEFINE_HASHMAP(name, K, V, hash, equal)   generates the type name and name_create, name_put, ..
+ *
+ * hash(k) returns the size_t hash of a key, and equal(a, b) is true when two keys are equal,
+ * both can be macros or functions (TYPED_HASH_INTEGER and TYPED_EQUAL work for integer keys)
+ *
+ * The generated struct is defined in the header, since every function using it is inlined,
+ * it should still only be accessed through the functions
+ */
+
+/* Equality for types that can be compared with == */
+#ifndef TYPED_EQUAL
+#define TYPED_EQUAL(a, b) ((a) == (b))
+#endif
+
+/* Hash for integer keys, the splitmix64 finalizer (every bit of the key changes every bit of the hash) */
+static inline size_t typed_hash_mix64(uint64_t x) {
+
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	x ^= x >> 31;
+	return (size_t)x;
+}
+#define TYPED_HASH_INTEGER(k) typed_hash_mix64((uint64_t)(k))
+
+/* Control byte values, a full slot stores the 7 bit fingerprint of its key instead (high bit unset) */
+#define TYPED_HASH_CTRL_EMPTY ((uint8_t)0x80)
+#define TYPED_HASH_CTRL_DELETED ((uint8_t)0xFE)
+
+/* Minimum number of slots, and (live + deleted slots) / capacity above which the table is rebuilt */
+#define TYPED_HASH_MIN_CAPACITY 8
+#define TYPED_HASH_MAX_LOAD 0.875
+
+#define DEFINE_HASHMAP(name, K, V, hash, equal)                                                          \
+                                                                                                         \
+/* Struct that represent an hashmap, mapping keys of type K into values of type V */                     \
+typedef struct name {                                                                                    \
+                                                                                                         \
+	/* One control byte per slot, and the keys and values of the slots */                                \
+	uint8_t* ctrl;                                                                                       \
+	K* keys;                                                                                             \
+	V* values;                                                                                           \
+                                                                                                         \
+	/* Number of slots (a power of two), of occupied slots and of deleted slots */                       \
+	size_t capacity;                                                                                     \
+	size_t count;                                                                                        \
+	size_t deleted_count;                                                                                \
+} name;                                                                                                  \
+                                                                                                         \
+/* Utility function that returns the fingerprint stored in the control byte, the top 7 bits of the hash */ \
+static inline uint8_t name##_util_fingerprint(size_t h) {                                                \
+                                                                                                         \
+	return (uint8_t)((h >> (sizeof(size_t) * 8 - 7)) & 0x7F);                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function that returns the slot holding k, capacity if there is none */                        \
+static inline size_t name##_util_find(name* hmap, K k, size_t h) {                                       \
+                                                                                                         \
+	size_t mask = hmap->capacity - 1;                                                                    \
+	uint8_t fp = name##_util_fingerprint(h);                                                             \
+                                                                                                         \
+	/* Linear probing, the load factor guarantees an empty slot ends the sequence */                     \
+	for (size_t i = h & mask;; i = (i + 1) & mask) {                                                     \
+                                                                                                         \
+		uint8_t c = hmap->ctrl[i];                                                                       \
+		if (c == TYPED_HASH_CTRL_EMPTY) return hmap->capacity;                                           \
+		if (c == fp && equal(hmap->keys[i], k)) return i;                                                \
+	}                                                                                                    \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function that returns the first empty or deleted slot of the probe sequence of h */           \
+static inline size_t name##_util_find_free(name* hmap, size_t h) {                                       \
+                                                                                                         \
+	size_t mask = hmap->capacity - 1;                                                                    \
+	size_t i = h & mask;                                                                                 \
+                                                                                                         \
+	while (!(hmap->ctrl[i] & 0x80)) i = (i + 1) & mask;                                                  \
+	return i;                                                                                            \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to allocate the arrays of a table with capacity slots */                        \
+static inline bool name##_util_allocate(name* hmap, size_t capacity) {                                   \
+                                                                                                         \
+	bool success = capacity <= SIZE_MAX / (sizeof(K) + sizeof(V) + 1);                                  \
+                                                                                                         \
+	hmap->ctrl = success ? (uint8_t*)malloc(capacity) : NULL;                                            \
+	hmap->keys = success ? (K*)malloc(capacity * sizeof(K)) : NULL;                                      \
+	hmap->values = success ? (V*)malloc(capacity * sizeof(V)) : NULL;                                    \
+	success = hmap->ctrl && hmap->keys && hmap->values;                                                  \
+                                                                                                         \
+	if (success) {                                                                                       \
+		memset(hmap->ctrl, TYPED_HASH_CTRL_EMPTY, capacity);                                             \
+		hmap->capacity = capacity;                                                                       \
+		hmap->count = 0;                                                                                 \
+		hmap->deleted_count = 0;                                                                         \
+	}                                                                                                    \
+	else {                                                                                               \
+		free(hmap->ctrl);                                                                                \
+		free(hmap->keys);                                                                                \
+		free(hmap->values);                                                                              \
+	}                                                                                                    \
+	return success;                                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function used to rebuild the table with new_capacity slots, dropping the deleted ones */     \
+static inline bool name##_util_resize(name* hmap, size_t new_capacity) {                                 \
+                                                                                                         \
+	name old = *hmap;                                                                                    \
+	bool success = name##_util_allocate(hmap, new_capacity);                                             \
+                                                                                                         \
+	if (success) {                                                                                       \
+		for (size_t i = 0; i < old.capacity; i++) {                                                      \
+                                                                                                         \
+			if (!(old.ctrl[i] & 0x80)) {                                                                 \
+				size_t h = hash(old.keys[i]);                                                            \
+				size_t j = name##_util_find_free(hmap, h);                                               \
+				hmap->ctrl[j] = old.ctrl[i];                                                             \
+				hmap->keys[j] = old.keys[i];                                                             \
+				hmap->values[j] = old.values[i];                                                         \
+			}                                                                                            \
+		}                                                                                                \
+		hmap->count = old.count;                                                                         \
+		free(old.ctrl);                                                                                  \
+		free(old.keys);                                                                                  \
+		free(old.values);                                                                                \
+	}                                                                                                    \
+	else *hmap = old;                                                                                    \
+	return success;                                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Utility function that returns the smallest power of two not less than capacity (at least the minimum) */ \
+static inline size_t name##_util_round_capacity(size_t capacity) {                                       \
+                                                                                                         \
+	size_t rounded = TYPED_HASH_MIN_CAPACITY;                                                            \
+	while (rounded < capacity && rounded <= SIZE_MAX / 2) rounded *= 2;                                  \
+	return rounded;                                                                                      \
+}                                                                                                        \
+                                                                                                         \
+/* Creates an hashmap with (at least) the given number of slots */                                       \
+static inline name* name##_create(size_t capacity) {                                                     \
+                                                                                                         \
+	name* hmap = (name*)malloc(sizeof(name));                                                            \
+                                                                                                         \
+	if (hmap && !name##_util_allocate(hmap, name##_util_round_capacity(capacity))) {                     \
+		free(hmap);                                                                                      \
+		hmap = NULL;                                                                                     \
+	}                                                                                                    \
+	return hmap;                                                                                         \
+}                                                                                                        \
+                                                                                                         \
+/* Deletes the hashmap, and sets the pointer to NULL */                                                  \
+static inline void name##_delete(name** hmap) {                                                          \
+                                                                                                         \
+	if (hmap && *hmap) {                                                                                 \
+		free((*hmap)->ctrl);                                                                             \
+		free((*hmap)->keys);                                                                             \
+		free((*hmap)->values);                                                                           \
+		free(*hmap);                                                                                     \
+		*hmap = NULL;                                                                                    \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Maps k into v, replacing the previous value if k was already present */                               \
+static inline void name##_put(name* hmap, K k, V v) {                                                    \
+                                                                                                         \
+	if (hmap) {                                                                                          \
+		size_t h = hash(k);                                                                              \
+		size_t i = name##_util_find(hmap, k, h);                                                         \
+                                                                                                         \
+		if (i < hmap->capacity) hmap->values[i] = v;                                                     \
+		else {                                                                                           \
+			/* Rebuild the table first if the new slot would go over the load factor,                   \
+			 * doubling it only if the live keys (not the deleted ones) need the room                   \
+			 */                                                                                          \
+			bool room = true;                                                                            \
+			if ((double)(hmap->count + hmap->deleted_count + 1) > hmap->capacity * TYPED_HASH_MAX_LOAD) { \
+				size_t new_capacity = hmap->capacity;                                                    \
+				if ((double)(hmap->count + 1) > hmap->capacity * TYPED_HASH_MAX_LOAD / 2) new_capacity *= 2; \
+				room = new_capacity >= hmap->capacity && name##_util_resize(hmap, new_capacity);         \
+			}                                                                                            \
+			if (room) {                                                                                  \
+				i = name##_util_find_free(hmap, h);                                                      \
+				if (hmap->ctrl[i] == TYPED_HASH_CTRL_DELETED) hmap->deleted_count--;                     \
+				hmap->ctrl[i] = name##_util_fingerprint(h);                                              \
+				hmap->keys[i] = k;                                                                       \
+				hmap->values[i] = v;                                                                     \
+				hmap->count++;                                                                           \
+			}                                                                                            \
+		}                                                                                                \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes k (and its value) from the hashmap, if it is present */                                       \
+static inline void name##_remove(name* hmap, K k) {                                                      \
+                                                                                                         \
+	if (hmap) {                                                                                          \
+		size_t i = name##_util_find(hmap, k, hash(k));                                                   \
+                                                                                                         \
+		if (i < hmap->capacity) {                                                                        \
+			/* A slot followed by an empty one ends no probe sequence, so it can be emptied */           \
+			if (hmap->ctrl[(i + 1) & (hmap->capacity - 1)] == TYPED_HASH_CTRL_EMPTY)                     \
+				hmap->ctrl[i] = TYPED_HASH_CTRL_EMPTY;                                                   \
+			else {                                                                                       \
+				hmap->ctrl[i] = TYPED_HASH_CTRL_DELETED;                                                 \
+				hmap->deleted_count++;                                                                   \
+			}                                                                                            \
+			hmap->count--;                                                                               \
+		}                                                                                                \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns a pointer to the value of k, NULL if k isn't present (valid until the next put) */            \
+static inline V* name##_get(name* hmap, K k) {                                                           \
+                                                                                                         \
+	V* res = NULL;                                                                                       \
+                                                                                                         \
+	if (hmap) {                                                                                          \
+		size_t i = name##_util_find(hmap, k, hash(k));                                                   \
+		if (i < hmap->capacity) res = hmap->values + i;                                                  \
+	}                                                                                                    \
+	return res;                                                                                          \
+}                                                                                                        \
+                                                                                                         \
+/* Checks whether k is present in the hashmap */                                                         \
+static inline bool name##_contains(name* hmap, K k) {                                                    \
+                                                                                                         \
+	return name##_get(hmap, k) != NULL;                                                                  \
+}                                                                                                        \
+                                                                                                         \
+/* Applies f to every key and value, in no particular order */                                           \
+static inline void name##_for_each(name* hmap, void (*f)(K*, V*)) {                                      \
+                                                                                                         \
+	if (hmap && f) {                                                                                     \
+		for (size_t i = 0; i < hmap->capacity; i++)                                                      \
+			if (!(hmap->ctrl[i] & 0x80)) f(hmap->keys + i, hmap->values + i);                            \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Removes every key, the table keeps its capacity */                                                    \
+static inline void name##_clear(name* hmap) {                                                            \
+                                                                                                         \
+	if (hmap) {                                                                                          \
+		memset(hmap->ctrl, TYPED_HASH_CTRL_EMPTY, hmap->capacity);                                       \
+		hmap->count = 0;                                                                                 \
+		hmap->deleted_count = 0;                                                                         \
+	}                                                                                                    \
+	return;                                                                                              \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of keys in the hashmap */                                                          \
+static inline size_t name##_get_size(name* hmap) {                                                       \
+                                                                                                         \
+	return hmap ? hmap->count : 0;                                                                       \
+}                                                                                                        \
+                                                                                                         \
+/* Returns the number of slots of the table */                                                           \
+static inline size_t name##_get_capacity(name* hmap) {                                                   \
+                                                                                                         \
+	return hmap ? hmap->capacity : 0;                                                                    \
+}
+
+#endif
\ No newline at end of file
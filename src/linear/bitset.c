@@ -10,6 +10,33 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(_MSC_VER) && defined(__AVX__)
+#include <nmmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Utility function that returns the number of set bits in a word */
+size_t bitset_util_popcount(uint64_t word);
+
+/* Utility function that returns the mask of the valid bits of the last word */
+uint64_t bitset_util_tail_mask(bitset* b);
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t bitset_util_ctz(uint64_t word);
+
+/* Operations between two sets, done a word at a time */
+typedef enum bitset_op { BITSET_AND, BITSET_OR, BITSET_XOR, BITSET_AND_NOT } bitset_op;
+
+/* Utility function that applies the operation to the words both sets have, and counts the positive bits again */
+void bitset_util_apply(bitset* b, bitset* other, bitset_op op);
+
  /**
   * Struct that represent a bitset
   */
@@ -24,11 +51,14 @@ typedef struct bitset {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	/* Istead of storing the bits in a bool array, we use an array of unsigned integers, where each integer contains 32 bits */
-	uint32_t* bits;
+	/* Istead of storing the bits in a bool array, we use an array of unsigned integers, where each integer contains 64 bits */
+	uint64_t* bits;
 
 	/* Number of bits in the set */
 	size_t set_size;
+
+	/* Number of bits set to 1, kept up to date by every operation so it can be read in O(1) */
+	size_t count;
 } bitset;
 
 /**
@@ -45,7 +75,8 @@ bitset* bitset_create(size_t size) {
 		if (b) {
 
 			b->set_size = size;
-			b->bits = (uint32_t*)calloc((b->set_size + 31) / 32, sizeof(uint32_t));
+			b->count = 0;
+			b->bits = (uint64_t*)calloc((b->set_size + 63) / 64, sizeof(uint64_t));
 
 			// If the calloc failed cancel the creation
 			if (!b->bits) {
@@ -66,7 +97,7 @@ void bitset_delete(bitset** b) {
 
 	if (b && *b) {
 
-		free(&(*b)->bits);
+		free((*b)->bits);
 		memset(*b, 0, sizeof(bitset));
 		free(*b);
 		*b = NULL;
@@ -81,7 +112,9 @@ void bitset_set(bitset* b, size_t i) {
 
 	if (b && i < b->set_size) {
 
-		b->bits[i / 32] |= (1U << (i % 32));
+		// Count the bit only if it wasn't already set
+		if (!(b->bits[i / 64] & ((uint64_t)1 << (i % 64)))) b->count++;
+		b->bits[i / 64] |= ((uint64_t)1 << (i % 64));
 	}
 }
 
@@ -90,7 +123,14 @@ void bitset_set(bitset* b, size_t i) {
  */
 void bitset_set_full(bitset* b) {
 
-	if (b) memset(b->bits, 0xFF, sizeof(b->bits));
+	if (b) {
+
+		memset(b->bits, 0xFF, ((b->set_size + 63) / 64) * sizeof(uint64_t));
+
+		// The bits past the size of the set are always kept to 0
+		b->bits[(b->set_size - 1) / 64] &= bitset_util_tail_mask(b);
+		b->count = b->set_size;
+	}
 }
 
 /**
@@ -100,16 +140,21 @@ void bitset_unset(bitset* b, size_t i) {
 
 	if (b && i < b->set_size) {
 
-		b->bits[i / 32] &= ~(1U << (i % 32));
+		if (b->bits[i / 64] & ((uint64_t)1 << (i % 64))) b->count--;
+		b->bits[i / 64] &= ~((uint64_t)1 << (i % 64));
 	}
 }
 
 /**
- *  Sets all the bits of the set to 1
+ *  Sets all the bits of the set to 0
  */
 void bitset_unset_full(bitset* b) {
 
-	if (b) memset(b->bits, 0x00, sizeof(b->bits));
+	if (b) {
+
+		memset(b->bits, 0x00, ((b->set_size + 63) / 64) * sizeof(uint64_t));
+		b->count = 0;
+	}
 }
 
 /**
@@ -117,7 +162,7 @@ void bitset_unset_full(bitset* b) {
  */
 bool bitset_get(bitset* b, size_t i) {
 
-	return (b && i < b->set_size) ? (b->bits[i / 32] & (1U << (i % 32))) : false;
+	return (b && i < b->set_size) ? (b->bits[i / 64] & ((uint64_t)1 << (i % 64))) : false;
 }
 
 /**
@@ -127,7 +172,9 @@ void bitset_toggle(bitset* b, size_t i) {
 
 	if (b && i < b->set_size) {
 
-		b->bits[i / 32] ^= ~(1U << (i % 32));
+		b->bits[i / 64] ^= ((uint64_t)1 << (i % 64));
+		if (b->bits[i / 64] & ((uint64_t)1 << (i % 64))) b->count++;
+		else b->count--;
 	}
 }
 
@@ -136,28 +183,359 @@ void bitset_toggle(bitset* b, size_t i) {
  */
 void bitset_toggle_full(bitset* b) {
 
-	if (b) for (size_t i = 0; i < b->set_size; i++) b->bits[i] ^= ~0;
+	if (b) {
+
+		for (size_t i = 0; i < (b->set_size + 63) / 64; i++) b->bits[i] ^= ~(uint64_t)0;
+
+		// The bits past the size of the set are always kept to 0
+		b->bits[(b->set_size - 1) / 64] &= bitset_util_tail_mask(b);
+		b->count = b->set_size - b->count;
+	}
 }
 
 /**
  *  Returns the number of positive bits in the set
+ *
+ *  The value is cached, so this is O(1)
  */
 size_t bitset_count(bitset* b) {
 
+	return b ? b->count : 0;
+}
+
+/**
+ *  Counts again the positive bits in the set, a word at a time, and returns them
+ */
+size_t bitset_recount(bitset* b) {
+
 	size_t count = 0;
 	if (b) {
-		
-		for (size_t i = 0; i < b->set_size; i++)
-			if (bitset_get(b, i))
-				count++;
+
+		for (size_t i = 0; i < (b->set_size + 63) / 64; i++) count += bitset_util_popcount(b->bits[i]);
+		b->count = count;
+	}
+	return count;
+}
+
+/**
+ *  Returns the number of positive bits in the range [from, to)
+ */
+size_t bitset_count_range(bitset* b, size_t from, size_t to) {
+
+	size_t count = 0;
+	if (b && from < to) {
+
+		if (to > b->set_size) to = b->set_size;
+
+		// Partial words at the borders are masked, the ones in between are counted whole
+		for (size_t i = from; i < to;) {
+
+			uint64_t mask = ~(uint64_t)0 << (i % 64);
+			if (i / 64 == (to - 1) / 64 && to % 64) mask &= ~(~(uint64_t)0 << (to % 64));
+
+			count += bitset_util_popcount(b->bits[i / 64] & mask);
+			i = (i / 64 + 1) * 64;
+		}
 	}
 	return count;
 }
 
 /**
- *  Toggles the number of bits in the set
+ *  Sets all the bits in the range [from, to) to 1
+ */
+void bitset_set_range(bitset* b, size_t from, size_t to) {
+
+	if (b && from < to) {
+
+		if (to > b->set_size) to = b->set_size;
+
+		for (size_t i = from; i < to;) {
+
+			uint64_t mask = ~(uint64_t)0 << (i % 64);
+			if (i / 64 == (to - 1) / 64 && to % 64) mask &= ~(~(uint64_t)0 << (to % 64));
+
+			// Only the bits that were 0 change the count
+			b->count += bitset_util_popcount(~b->bits[i / 64] & mask);
+			b->bits[i / 64] |= mask;
+			i = (i / 64 + 1) * 64;
+		}
+	}
+	return;
+}
+
+/**
+ *  Sets all the bits in the range [from, to) to 0
+ */
+void bitset_unset_range(bitset* b, size_t from, size_t to) {
+
+	if (b && from < to) {
+
+		if (to > b->set_size) to = b->set_size;
+
+		for (size_t i = from; i < to;) {
+
+			uint64_t mask = ~(uint64_t)0 << (i % 64);
+			if (i / 64 == (to - 1) / 64 && to % 64) mask &= ~(~(uint64_t)0 << (to % 64));
+
+			// Only the bits that were 1 change the count
+			b->count -= bitset_util_popcount(b->bits[i / 64] & mask);
+			b->bits[i / 64] &= ~mask;
+			i = (i / 64 + 1) * 64;
+		}
+	}
+	return;
+}
+
+/**
+ *  Returns the number of bits in the set
  */
 size_t bitset_get_size(bitset* b) {
 
 	return b ? b->set_size : 0;
 }
+
+/**
+ *  Returns the position of the first bit set to 1 starting from the given one (included),
+ *  or the size of the set if there's none
+ *
+ *  Whole words are skipped at a time, so iterating the positive bits
+ *  costs one step per word plus one per positive bit
+ */
+size_t bitset_next_set(bitset* b, size_t from) {
+
+	size_t pos = b ? b->set_size : 0;
+
+	if (b && from < b->set_size) {
+
+		size_t words = (b->set_size + 63) / 64;
+		size_t i = from / 64;
+
+		// The bits before from are masked out of the first word
+		uint64_t word = b->bits[i] & (~(uint64_t)0 << (from % 64));
+
+		while (!word && ++i < words) word = b->bits[i];
+		if (word) pos = i * 64 + bitset_util_ctz(word);
+	}
+	return pos;
+}
+
+/**
+ *  Changes the number of bits in the set, the new bits are set to 0
+ */
+void bitset_resize(bitset* b, size_t size) {
+
+	if (b && 0 < size && size < SIZE_MAX) {
+
+		size_t old_words = (b->set_size + 63) / 64;
+		size_t words = (size + 63) / 64;
+
+		// The bits that are cut off don't count anymore
+		if (size < b->set_size) b->count -= bitset_count_range(b, size, b->set_size);
+
+		uint64_t* bits = (words != old_words) ? (uint64_t*)realloc(b->bits, words * sizeof(uint64_t)) : b->bits;
+		if (bits) {
+
+			if (words > old_words) memset(bits + old_words, 0, (words - old_words) * sizeof(uint64_t));
+			b->bits = bits;
+			b->set_size = size;
+
+			// The bits past the size of the set are always kept to 0
+			b->bits[words - 1] &= bitset_util_tail_mask(b);
+		}
+		else if (size < b->set_size) b->count += bitset_count_range(b, size, b->set_size);
+	}
+	return;
+}
+
+/**
+ *  Sets to 0 every bit of the set that's 0 in other (b = b & other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_and(bitset* b, bitset* other) {
+
+	if (b && other) {
+
+		bitset_util_apply(b, other, BITSET_AND);
+	}
+	return;
+}
+
+/**
+ *  Sets to 1 every bit of the set that's 1 in other (b = b | other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_or(bitset* b, bitset* other) {
+
+	if (b && other) {
+
+		bitset_util_apply(b, other, BITSET_OR);
+	}
+	return;
+}
+
+/**
+ *  Toggles every bit of the set that's 1 in other (b = b ^ other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_xor(bitset* b, bitset* other) {
+
+	if (b && other) {
+
+		bitset_util_apply(b, other, BITSET_XOR);
+	}
+	return;
+}
+
+/**
+ *  Sets to 0 every bit of the set that's 1 in other (b = b & ~other)
+ *
+ *  Only the bits in both sets are considered
+ */
+void bitset_and_not(bitset* b, bitset* other) {
+
+	if (b && other) {
+
+		bitset_util_apply(b, other, BITSET_AND_NOT);
+	}
+	return;
+}
+
+/**
+ *  Returns the position of the first bit set to 1, or the size of the set if there's none
+ */
+size_t bitset_find_first(bitset* b) {
+
+	return bitset_next_set(b, 0);
+}
+
+/**
+ *  Returns the position of the first bit set to 1 after the given one (excluded),
+ *  or the size of the set if there's none
+ */
+size_t bitset_find_next(bitset* b, size_t i) {
+
+	return (i < SIZE_MAX) ? bitset_next_set(b, i + 1) : bitset_get_size(b);
+}
+
+/**
+ *  Calls f with the position of every bit set to 1, in increasing order
+ *
+ *  f must not modify the set
+ */
+void bitset_for_each_set(bitset* b, void (*f)(size_t)) {
+
+	if (b && f) {
+
+		for (size_t i = 0; i < (b->set_size + 63) / 64; i++) {
+
+			// Take the lowest positive bit and clear it, until the word is empty
+			for (uint64_t word = b->bits[i]; word; word &= word - 1) f(i * 64 + bitset_util_ctz(word));
+		}
+	}
+	return;
+}
+
+/* Utility function that returns the number of set bits in a word */
+size_t bitset_util_popcount(uint64_t word) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+	return (size_t)_mm_popcnt_u64(word);
+#else
+	// Sum the bits in pairs, then nibbles, then add up the bytes
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* Utility function that returns the mask of the valid bits of the last word */
+uint64_t bitset_util_tail_mask(bitset* b) {
+
+	return (b->set_size % 64) ? ~(~(uint64_t)0 << (b->set_size % 64)) : ~(uint64_t)0;
+}
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t bitset_util_ctz(uint64_t word) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (size_t)index;
+#else
+	// Isolate the lowest bit, then find its position halving the range
+	size_t pos = 0;
+	word &= (~word + 1);
+	if (!(word & 0x00000000FFFFFFFFULL)) pos += 32;
+	if (!(word & 0x0000FFFF0000FFFFULL)) pos += 16;
+	if (!(word & 0x00FF00FF00FF00FFULL)) pos += 8;
+	if (!(word & 0x0F0F0F0F0F0F0F0FULL)) pos += 4;
+	if (!(word & 0x3333333333333333ULL)) pos += 2;
+	if (!(word & 0x5555555555555555ULL)) pos += 1;
+	return pos;
+#endif
+}
+
+/* Utility function that applies the operation to the words both sets have, and counts the positive bits again */
+void bitset_util_apply(bitset* b, bitset* other, bitset_op op) {
+
+	size_t bits = b->set_size < other->set_size ? b->set_size : other->set_size;
+	size_t words = (bits + 63) / 64;
+	size_t count = 0;
+	size_t i = 0;
+
+	// The last word is done apart, since only part of it may be shared
+	if (words > 0) words--;
+
+#if defined(__AVX2__)
+	// Four words at a time
+	for (; i + 4 <= words; i += 4) {
+
+		__m256i x = _mm256_loadu_si256((const __m256i*)(b->bits + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(other->bits + i));
+
+		switch (op) {
+		case BITSET_AND: x = _mm256_and_si256(x, y); break;
+		case BITSET_OR: x = _mm256_or_si256(x, y); break;
+		case BITSET_XOR: x = _mm256_xor_si256(x, y); break;
+		case BITSET_AND_NOT: x = _mm256_andnot_si256(y, x); break;
+		}
+		_mm256_storeu_si256((__m256i*)(b->bits + i), x);
+
+		count += bitset_util_popcount(b->bits[i]) + bitset_util_popcount(b->bits[i + 1]) + bitset_util_popcount(b->bits[i + 2]) + bitset_util_popcount(b->bits[i + 3]);
+	}
+#endif
+
+	for (; i <= words; i++) {
+
+		uint64_t word = b->bits[i];
+
+		switch (op) {
+		case BITSET_AND: word &= other->bits[i]; break;
+		case BITSET_OR: word |= other->bits[i]; break;
+		case BITSET_XOR: word ^= other->bits[i]; break;
+		case BITSET_AND_NOT: word &= ~other->bits[i]; break;
+		}
+
+		// In the last word the bits past the smaller set are kept as they were
+		if (i == words && bits % 64) {
+
+			uint64_t mask = ~(~(uint64_t)0 << (bits % 64));
+			word = (word & mask) | (b->bits[i] & ~mask);
+		}
+
+		b->bits[i] = word;
+		count += bitset_util_popcount(word);
+	}
+
+	// The bits of b past other are untouched
+	b->count = count + bitset_count_range(b, (words + 1) * 64, b->set_size);
+	return;
+}
\ No newline at end of file
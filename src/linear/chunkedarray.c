@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/chunkedarray.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Target size of a block in bytes, the number of elements per block is the biggest power of two that fits */
+#define CHUNKED_ARRAY_BLOCK_BYTES 4096
+
+/* Minimum number of elements per block, used when elements are bigger than a block */
+#define CHUNKED_ARRAY_MIN_BLOCK_LENGTH 16
+
+/* Number of block pointers in the map when the chunked array is created, the map doubles whenever it's full */
+#define CHUNKED_ARRAY_MIN_BLOCKS 4
+
+/* Alignment of the inline block, enough for any fundamental type */
+#define CHUNKED_ARRAY_INLINE_ALIGNMENT 16
+
+/* Offset of the inline block from the start of the struct */
+#define CHUNKED_ARRAY_INLINE_OFFSET ((sizeof(chunkedarray) + CHUNKED_ARRAY_INLINE_ALIGNMENT - 1) / CHUNKED_ARRAY_INLINE_ALIGNMENT * CHUNKED_ARRAY_INLINE_ALIGNMENT)
+
+/* Utility function used to get the block for a position, allocating it if it's missing */
+void* ca_util_block(chunkedarray* ca, size_t pos);
+
+/* Utility function used to give back the block holding a position if no element is left in it */
+void ca_util_release(chunkedarray* ca, size_t pos);
+
+/* Utility function used to double the map when every position is taken */
+bool ca_util_grow(chunkedarray* ca);
+
+/* Utility function used to drop a block that holds no element, keeping it as the spare if there's none */
+void ca_util_discard(chunkedarray* ca, char* block);
+
+/* Utility function used to get the inline block, placed right after the struct (NULL if there's none) */
+char* ca_util_inline(chunkedarray* ca);
+
+/**
+ * Struct that represent a chunked array (deque of blocks) that can store
+ * a generic type value
+ */
+typedef struct chunkedarray {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Circular map of blocks, a block is NULL when no element is stored in it */
+	char** blocks;
+
+	/* Number of blocks in the map (power of two) */
+	size_t block_count;
+
+	/* log2 of the number of elements of each block */
+	size_t block_shift;
+
+	/* Position of the first element, positions go from 0 to block_count * block_length (excluded) and wrap around */
+	size_t first;
+
+	/* Number of elements stored */
+	size_t size;
+
+	/* Size of each element */
+	size_t element_size;
+
+	/* Empty block kept to be reused, so that push / pop on a block boundary never reach the allocator */
+	char* spare;
+
+	/* Map used until it has to grow, so that a new chunked array doesn't allocate it separately */
+	char* inline_map[CHUNKED_ARRAY_MIN_BLOCKS];
+
+	/* Whether or not a block is stored right after the struct, it's never freed on its own */
+	bool has_inline;
+} chunkedarray;
+
+/**
+ * Creates a chunked array ready to store elements that are as big as the given size
+ */
+chunkedarray* ca_create(size_t element_size) {
+
+	return ca_create_inline(element_size, 0);
+}
+
+/**
+ * Creates a chunked array whose first block, big enough for inline_length elements,
+ * is stored in the same allocation as the chunked array itself
+ *
+ * The length of every block becomes inline_length, rounded up to a power of two
+ * (and capped to the usual block length), so it suits structures that stay small
+ */
+chunkedarray* ca_create_inline(size_t element_size, size_t inline_length) {
+
+	chunkedarray* ca = NULL;
+
+	// The size must be reasonable, and a block must be addressable
+	if (0 < element_size && element_size <= SIZE_MAX / CHUNKED_ARRAY_BLOCK_BYTES) {
+
+		// Biggest power of two number of elements that fits in a block
+		size_t block_shift = 0;
+		while ((element_size << (block_shift + 1)) <= CHUNKED_ARRAY_BLOCK_BYTES) block_shift++;
+		while (((size_t)1 << block_shift) < CHUNKED_ARRAY_MIN_BLOCK_LENGTH) block_shift++;
+
+		// Blocks as long as the inline one, unless it would be longer than usual
+		if (inline_length > 0) {
+
+			size_t inline_shift = 0;
+			while (inline_shift < block_shift && ((size_t)1 << inline_shift) < inline_length) inline_shift++;
+			block_shift = inline_shift;
+		}
+
+		ca = (chunkedarray*)malloc(inline_length > 0 ? CHUNKED_ARRAY_INLINE_OFFSET + (element_size << block_shift) : sizeof(chunkedarray));
+		if (ca) {
+
+			memset(ca->inline_map, 0, sizeof(ca->inline_map));
+			ca->blocks = ca->inline_map;
+			ca->block_shift = block_shift;
+			ca->block_count = CHUNKED_ARRAY_MIN_BLOCKS;
+			ca->first = 0;
+			ca->size = 0;
+			ca->element_size = element_size;
+			ca->has_inline = inline_length > 0;
+
+			// The inline block is the first one the chunked array will use
+			ca->spare = ca_util_inline(ca);
+		}
+	}
+	return ca;
+}
+
+/**
+ * Deletes the given chunked array, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for every block is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void ca_delete(chunkedarray** ca) {
+
+	if (ca && *ca) {
+
+		char* inline_block = ca_util_inline(*ca);
+
+		for (size_t i = 0; i < (*ca)->block_count; i++) {
+
+			if ((*ca)->blocks[i] != inline_block) free((*ca)->blocks[i]);
+		}
+		if ((*ca)->blocks != (*ca)->inline_map) free((*ca)->blocks);
+		if ((*ca)->spare != inline_block) free((*ca)->spare);
+
+		free(*ca);
+		*ca = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a copy of the element pointed to by x before the first element
+ */
+void ca_push_front(chunkedarray* ca, void* x) {
+
+	if (ca && x) {
+
+		size_t capacity = ca->block_count << ca->block_shift;
+
+		if (ca->size < capacity || ca_util_grow(ca)) {
+
+			capacity = ca->block_count << ca->block_shift;
+			size_t pos = (ca->first - 1) & (capacity - 1);
+
+			char* block = (char*)ca_util_block(ca, pos);
+			if (block) {
+
+				memcpy(block + (pos & (((size_t)1 << ca->block_shift) - 1)) * ca->element_size, x, ca->element_size);
+				ca->first = pos;
+				ca->size++;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Inserts a copy of the element pointed to by x after the last element
+ */
+void ca_push_back(chunkedarray* ca, void* x) {
+
+	if (ca && x) {
+
+		size_t capacity = ca->block_count << ca->block_shift;
+
+		if (ca->size < capacity || ca_util_grow(ca)) {
+
+			capacity = ca->block_count << ca->block_shift;
+			size_t pos = (ca->first + ca->size) & (capacity - 1);
+
+			char* block = (char*)ca_util_block(ca, pos);
+			if (block) {
+
+				memcpy(block + (pos & (((size_t)1 << ca->block_shift) - 1)) * ca->element_size, x, ca->element_size);
+				ca->size++;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the first element, copying it in the given buffer (if it's not NULL)
+ */
+void ca_pop_2_front(chunkedarray* ca, void* buf) {
+
+	if (ca && ca->size > 0) {
+
+		size_t pos = ca->first;
+
+		if (buf) memcpy(buf, ca_get_front(ca), ca->element_size);
+
+		ca->first = (pos + 1) & ((ca->block_count << ca->block_shift) - 1);
+		ca->size--;
+		ca_util_release(ca, pos);
+	}
+	return;
+}
+
+/**
+ * Removes the last element, copying it in the given buffer (if it's not NULL)
+ */
+void ca_pop_2_back(chunkedarray* ca, void* buf) {
+
+	if (ca && ca->size > 0) {
+
+		size_t pos = (ca->first + ca->size - 1) & ((ca->block_count << ca->block_shift) - 1);
+
+		if (buf) memcpy(buf, ca_get_back(ca), ca->element_size);
+
+		ca->size--;
+		ca_util_release(ca, pos);
+	}
+	return;
+}
+
+/**
+ * Returns a pointer to the first element, NULL if there are none
+ */
+void* ca_get_front(chunkedarray* ca) {
+	return ca ? ca_get_at(ca, 0) : NULL;
+}
+
+/**
+ * Returns a pointer to the last element, NULL if there are none
+ */
+void* ca_get_back(chunkedarray* ca) {
+	return ca && ca->size > 0 ? ca_get_at(ca, ca->size - 1) : NULL;
+}
+
+/**
+ * Returns a pointer to the element at the given position (0 is the first element),
+ * NULL if the position is out of bounds
+ */
+void* ca_get_at(chunkedarray* ca, size_t i) {
+
+	void* val = NULL;
+
+	if (ca && i < ca->size) {
+
+		size_t pos = (ca->first + i) & ((ca->block_count << ca->block_shift) - 1);
+		val = ca->blocks[pos >> ca->block_shift] + (pos & (((size_t)1 << ca->block_shift) - 1)) * ca->element_size;
+	}
+	return val;
+}
+
+/**
+ * Returns the number of elements inside the chunked array
+ */
+size_t ca_get_size(chunkedarray* ca) {
+	return ca ? ca->size : 0;
+}
+
+/**
+ * Returns the size of each element of the chunked array
+ */
+size_t ca_get_element_size(chunkedarray* ca) {
+	return ca ? ca->element_size : 0;
+}
+
+/**
+ * Removes every element from the chunked array
+ * (the struct itself is not deleted)
+ */
+void ca_clear(chunkedarray* ca) {
+
+	if (ca) {
+
+		// One block is kept as the spare, the others are freed
+		for (size_t i = 0; i < ca->block_count; i++) {
+
+			if (ca->blocks[i]) {
+
+				ca_util_discard(ca, ca->blocks[i]);
+				ca->blocks[i] = NULL;
+			}
+		}
+		ca->first = 0;
+		ca->size = 0;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the chunked array is empty
+ */
+bool ca_is_empty(chunkedarray* ca) {
+	return ca ? ca->size == 0 : false;
+}
+
+/**
+ * Returns the block that holds the given position, if it wasn't allocated yet
+ * the spare block is used, and malloc is called only if there's no spare
+ */
+void* ca_util_block(chunkedarray* ca, size_t pos) {
+
+	char** block = &ca->blocks[pos >> ca->block_shift];
+
+	if (!*block) {
+
+		if (ca->spare) {
+
+			*block = ca->spare;
+			ca->spare = NULL;
+		}
+		else *block = (char*)malloc(ca->element_size << ca->block_shift);
+	}
+	return *block;
+}
+
+/**
+ * Called after the element at the given position was removed, the block that held it
+ * is given back if neither the first nor the last element are in it anymore
+ * (the block isn't given back when the chunked array gets empty, so it can be reused right away)
+ */
+void ca_util_release(chunkedarray* ca, size_t pos) {
+
+	if (ca->size > 0) {
+
+		size_t mask = (ca->block_count << ca->block_shift) - 1;
+		size_t index = pos >> ca->block_shift;
+
+		if ((ca->first >> ca->block_shift) != index && (((ca->first + ca->size - 1) & mask) >> ca->block_shift) != index) {
+
+			ca_util_discard(ca, ca->blocks[index]);
+			ca->blocks[index] = NULL;
+		}
+	}
+	return;
+}
+
+/**
+ * Doubles the number of blocks of the map, the blocks are laid out again starting from the
+ * one holding the first element, so positions stay contiguous
+ *
+ * Only block pointers are moved, except when the first block also holds the last elements
+ * (the map was full and wrapped inside that block), then those are copied in a new block
+ */
+bool ca_util_grow(chunkedarray* ca) {
+
+	bool grown = false;
+
+	if (ca->block_count <= SIZE_MAX / 2 / sizeof(char*) && (ca->block_count << ca->block_shift) <= SIZE_MAX / 2) {
+
+		char** blocks = (char**)calloc(ca->block_count * 2, sizeof(char*));
+		if (blocks) {
+
+			size_t first_block = ca->first >> ca->block_shift;
+			size_t offset = ca->first & (((size_t)1 << ca->block_shift) - 1);
+			char* tail = NULL;
+
+			// The last elements, before the first one in its block, are moved to a block of their own
+			if (offset > 0) {
+
+				tail = ca->spare ? ca->spare : (char*)malloc(ca->element_size << ca->block_shift);
+				if (tail) {
+
+					ca->spare = NULL;
+					memcpy(tail, ca->blocks[first_block], offset * ca->element_size);
+				}
+			}
+
+			if (offset == 0 || tail) {
+
+				for (size_t i = 0; i < ca->block_count; i++) blocks[i] = ca->blocks[(first_block + i) & (ca->block_count - 1)];
+				blocks[ca->block_count] = tail;
+
+				if (ca->blocks != ca->inline_map) free(ca->blocks);
+				ca->blocks = blocks;
+				ca->block_count *= 2;
+				ca->first = offset;
+				grown = true;
+			}
+			else free(blocks);
+		}
+	}
+	return grown;
+}
+
+/**
+ * Drops a block that holds no element, it becomes the spare if there's none
+ * and the inline block is always kept (as the spare), since it can't be freed
+ */
+void ca_util_discard(chunkedarray* ca, char* block) {
+
+	if (!ca->spare) ca->spare = block;
+	else if (block == ca_util_inline(ca)) {
+
+		free(ca->spare);
+		ca->spare = block;
+	}
+	else free(block);
+	return;
+}
+
+/**
+ * Returns the inline block, placed right after the struct, NULL if the chunked array has none
+ */
+char* ca_util_inline(chunkedarray* ca) {
+
+	return ca->has_inline ? (char*)ca + CHUNKED_ARRAY_INLINE_OFFSET : NULL;
+}
\ No newline at end of file
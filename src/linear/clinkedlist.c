@@ -9,6 +9,7 @@
 #include "../../include/linear/clinkedlist.h"
 #include "../../include/linear/node.h"
 #include <string.h>
+#include <stdint.h>
 
 /**
  * Struct that represent a circular list of elements of a generic type value
@@ -33,6 +34,9 @@ typedef struct clinkedlist {
 	/* Size of the elements stored in the list */
 	size_t element_size;
 
+	/* Pool the nodes are taken from, owned by the list */
+	pool* nodes;
+
 } clinkedlist;
 
 /**
@@ -48,8 +52,17 @@ clinkedlist* cl_create(size_t element_size) {
 
 		if (cl) {
 
+			cl->tail = NULL;
 			cl->element_size = element_size;
 			cl->element_count = 0;
+			cl->nodes = pool_create(node_get_footprint(element_size));
+
+			// Cancel the creation if the nodes can't be allocated
+			if (!cl->nodes) {
+
+				free(cl);
+				cl = NULL;
+			}
 		}
 	}
 	return cl;
@@ -67,8 +80,8 @@ void cl_delete(clinkedlist** cl) {
 	// Access the list only if the pointer is valid
 	if (cl && *cl) {
 
-		// Free every node
-		cl_clear(*cl);
+		// Free every node, all at once
+		pool_delete(&(*cl)->nodes);
 
 		// Free the memory used for the whole struct
 		memset(*cl, 0, sizeof(clinkedlist));
@@ -90,7 +103,7 @@ void cl_insert_at(clinkedlist* cl, void* x, size_t i) {
 		i = i % (cl->element_count + 1);
 
 		// Create the node
-		node* n = node_create(x, cl->element_size);
+		node* n = node_create_in(cl->nodes, x, cl->element_size);
 
 		// Continue only if the node was created
 		if (n) {
@@ -196,7 +209,7 @@ void cl_remove_at(clinkedlist* cl, size_t i) {
 			// Set the head to null
 			cl->tail = NULL;
 		}
-		node_delete(&to_be_deleted);
+		node_delete_in(cl->nodes, &to_be_deleted);
 		cl->element_count--;
 	}
 	return;
@@ -336,6 +349,21 @@ size_t cl_get_element_size(clinkedlist* cl) {
 	return cl ? cl->element_size : 0;
 }
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void cl_get_stats(clinkedlist* cl, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (cl) pool_add_stats(cl->nodes, stats);
+	}
+	return;
+}
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -380,14 +408,8 @@ void cl_clear(clinkedlist* cl) {
 	// Access the list if the pointer is valid
 	if (cl) {
 
-		node* to_be_deleted = NULL;
-		node* tmp = node_get_next(cl->tail);
-		for (int i = 0; i < cl->element_count; i++) {
-
-			to_be_deleted = tmp;
-			tmp = node_get_next(tmp);
-			node_delete(&to_be_deleted);
-		}
+		// Every node comes from the pool, release them all without visiting the list
+		pool_clear(cl->nodes);
 		cl->tail = NULL;
 		cl->element_count = 0;
 	}
@@ -0,0 +1,676 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/cskiplist.h"
+#include <stdatomic.h>
+#include <threads.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Size of a cache line, the counters written by every thread are kept on different lines */
+#define CSL_CACHE_LINE 64
+
+/* Number of nodes retired between two attempts to move to the next epoch */
+#define CSL_RETIRE_BATCH 64
+
+/* The lowest bit of a pointer marks the node it belongs to as removed */
+#define CSL_MARK ((uintptr_t)1)
+#define CSL_PTR(p) ((csl_node*)((p) & ~CSL_MARK))
+#define CSL_MARKED(p) (((p) & CSL_MARK) != 0)
+
+/**
+ * Node of the list
+ *
+ * The pointers and the value are stored right after the struct, in the same allocation
+ */
+typedef struct csl_node {
+
+	/* Next node waiting to be freed, once the node is unlinked */
+	struct csl_node* retired;
+
+	/* Who still needs the node, the list and (while it's linking the upper levels) the thread that inserted it */
+	atomic_int owners;
+
+	/* Number of levels the node is in */
+	size_t level;
+
+	/* Pointers to the next nodes of each level, with the mark bit, the value follows them */
+	_Atomic uintptr_t next[];
+} csl_node;
+
+/**
+ * Counter on a cache line of its own
+ */
+typedef struct csl_counter {
+
+	atomic_size_t value;
+	char padding[CSL_CACHE_LINE - sizeof(atomic_size_t)];
+} csl_counter;
+
+/* Random generator of each thread, used to draw the levels */
+static _Thread_local uint64_t csl_random_state = 0;
+
+/* Different seeds for the generators of different threads */
+static atomic_uint_fast64_t csl_seeds = 0;
+
+/* Utility function used to create a node with the given number of levels */
+csl_node* csl_util_create_node(cskiplist* csl, void* x, size_t level);
+
+/* Utility function used to free a node (nothing if it's NULL) */
+void csl_util_free_node(cskiplist* csl, csl_node* n);
+
+/* Utility function that returns a pointer to the value of a node */
+void* csl_util_value(csl_node* n);
+
+/* Utility function that finds the last node before x and the first one not before it on every level, unlinking the removed nodes it meets */
+bool csl_util_find(cskiplist* csl, void* x, csl_node** preds, csl_node** succs);
+
+/* Utility function used to draw the level of a new node */
+size_t csl_util_random_level(cskiplist* csl);
+
+/* Utility functions used to enter and leave an epoch, every access to the nodes is done in between */
+size_t csl_util_enter(cskiplist* csl);
+void csl_util_leave(cskiplist* csl, size_t epoch);
+
+/* Utility function used to give up a reference to a node, the last one unlinks it and retires it */
+void csl_util_release(cskiplist* csl, csl_node* n, size_t epoch);
+
+/* Utility function used to put a node (already unlinked) in the list of the ones to free */
+void csl_util_retire(cskiplist* csl, csl_node* n, size_t epoch);
+
+/* Utility function that moves to the next epoch if every thread is in the current one, freeing the nodes no thread can reach */
+void csl_util_advance(cskiplist* csl);
+
+/* Utility function used to free every node, when no thread is using the list */
+void csl_util_free_nodes(cskiplist* csl);
+
+/**
+ * Struct that represent a skip list of elements of a generic type value that
+ * any number of threads can read and modify at the same time, without locks
+ */
+typedef struct cskiplist {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Sentinel node, before every other node in every level */
+	csl_node* head;
+
+	/* Number of levels in use, searches start from the highest one */
+	atomic_size_t top;
+
+	/* Number of elements present in the list */
+	atomic_size_t element_count;
+
+	/* Size of the elements stored in the list */
+	size_t element_size;
+
+	/* Maximum number of levels the nodes can be in */
+	size_t max_levels;
+
+	/* Probability used to determine the levels of each node */
+	double probability;
+
+	/* Function used to compare elements to determine the order within the list */
+	int (*compare)(void*, void*);
+
+	/* Current epoch, and number of threads inside each of the last three epochs */
+	atomic_size_t epoch;
+	csl_counter active[3];
+
+	/* Nodes unlinked during each of the last three epochs, waiting to be freed */
+	_Atomic(csl_node*) limbo[3];
+
+	/* Number of nodes retired so far */
+	atomic_size_t retired_count;
+
+	/* Taken (without waiting) by the thread moving to the next epoch */
+	mtx_t advance;
+
+#ifdef CDS_WITH_STATS
+	/* Nodes allocated and freed so far, and the bytes requested for them (updated by every thread) */
+	atomic_size_t allocations;
+	atomic_size_t frees;
+	atomic_size_t bytes;
+#endif
+} cskiplist;
+
+/**
+ * Creates a concurrent skip list ready to store elements that are as big as the given size
+ *
+ * max_levels is capped at CSL_MAX_LEVELS
+ */
+cskiplist* csl_create(size_t element_size, size_t max_levels, double probability, int (*cmp)(void*, void*)) {
+
+	cskiplist* csl = NULL;
+
+	if (0 < element_size && 0 < max_levels && 0.0 < probability && probability < 1.0 && cmp) {
+
+		csl = (cskiplist*)malloc(sizeof(cskiplist));
+		if (csl) {
+
+			csl->element_size = element_size;
+			csl->max_levels = max_levels < CSL_MAX_LEVELS ? max_levels : CSL_MAX_LEVELS;
+			csl->probability = probability;
+			csl->compare = cmp;
+			atomic_init(&csl->top, 1);
+			atomic_init(&csl->element_count, 0);
+			atomic_init(&csl->epoch, 0);
+			atomic_init(&csl->retired_count, 0);
+#ifdef CDS_WITH_STATS
+			atomic_init(&csl->allocations, 0);
+			atomic_init(&csl->frees, 0);
+			atomic_init(&csl->bytes, 0);
+#endif
+			for (size_t i = 0; i < 3; i++) {
+
+				atomic_init(&csl->active[i].value, 0);
+				atomic_init(&csl->limbo[i], NULL);
+			}
+
+			csl->head = csl_util_create_node(csl, NULL, csl->max_levels);
+			if (!csl->head || mtx_init(&csl->advance, mtx_plain) != thrd_success) {
+
+				csl_util_free_node(csl, csl->head);
+				free(csl);
+				csl = NULL;
+			}
+		}
+	}
+	return csl;
+}
+
+/**
+ * Deletes the given list, no other thread can be using it
+ */
+void csl_delete(cskiplist** csl) {
+
+	if (csl && *csl) {
+
+		csl_util_free_nodes(*csl);
+		mtx_destroy(&(*csl)->advance);
+		csl_util_free_node(*csl, (*csl)->head);
+		free(*csl);
+		*csl = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts the element pointed to by x in the list
+ *
+ * Returns whether or not it was inserted (false if an equal element is already in the list)
+ */
+bool csl_insert(cskiplist* csl, void* x) {
+
+	bool inserted = false;
+
+	if (csl && x) {
+
+		csl_node* preds[CSL_MAX_LEVELS];
+		csl_node* succs[CSL_MAX_LEVELS];
+		csl_node* node = NULL;
+
+		// The levels of the node have to be searched before it's linked
+		size_t level = csl_util_random_level(csl);
+		size_t top = atomic_load(&csl->top);
+		while (top < level && !atomic_compare_exchange_weak(&csl->top, &top, level));
+
+		size_t epoch = csl_util_enter(csl);
+
+		while (!csl_util_find(csl, x, preds, succs)) {
+
+			if (!node) node = csl_util_create_node(csl, x, level);
+			if (!node) break;
+
+			for (size_t i = 0; i < level; i++) atomic_store(&node->next[i], (uintptr_t)succs[i]);
+
+			// Once it's linked in the bottom level the element is in the list
+			uintptr_t expected = (uintptr_t)succs[0];
+			if (atomic_compare_exchange_strong(&preds[0]->next[0], &expected, (uintptr_t)node)) {
+
+				inserted = true;
+				break;
+			}
+		}
+
+		if (inserted) {
+
+			atomic_fetch_add(&csl->element_count, 1);
+
+			// Link the upper levels, unless the node gets removed in the meantime
+			bool marked = false;
+			for (size_t i = 1; i < level && !marked; i++) {
+
+				while (1) {
+
+					uintptr_t next = atomic_load(&node->next[i]);
+
+					marked = CSL_MARKED(next);
+					if (marked) break;
+					if (CSL_PTR(next) != succs[i] && !atomic_compare_exchange_strong(&node->next[i], &next, (uintptr_t)succs[i])) continue;
+
+					uintptr_t expected = (uintptr_t)succs[i];
+					if (atomic_compare_exchange_strong(&preds[i]->next[i], &expected, (uintptr_t)node)) break;
+
+					// Something changed around the node, look for its neighbours again
+					csl_util_find(csl, x, preds, succs);
+				}
+			}
+			csl_util_release(csl, node, epoch);
+		}
+		else csl_util_free_node(csl, node);
+
+		csl_util_leave(csl, epoch);
+	}
+	return inserted;
+}
+
+/**
+ * Removes x from the list (if present)
+ *
+ * Returns whether or not it was removed by this call
+ */
+bool csl_remove(cskiplist* csl, void* x) {
+
+	bool removed = false;
+
+	if (csl && x) {
+
+		csl_node* preds[CSL_MAX_LEVELS];
+		csl_node* succs[CSL_MAX_LEVELS];
+
+		size_t epoch = csl_util_enter(csl);
+
+		if (csl_util_find(csl, x, preds, succs)) {
+
+			csl_node* node = succs[0];
+
+			// Mark the upper levels first, so that the node can't be linked in them anymore
+			for (size_t i = node->level; i > 1; i--) {
+
+				uintptr_t next = atomic_load(&node->next[i - 1]);
+				while (!CSL_MARKED(next) && !atomic_compare_exchange_weak(&node->next[i - 1], &next, next | CSL_MARK));
+			}
+
+			// Whoever marks the bottom level is the one removing the element
+			uintptr_t next = atomic_load(&node->next[0]);
+			while (!CSL_MARKED(next)) {
+
+				if (atomic_compare_exchange_weak(&node->next[0], &next, next | CSL_MARK)) removed = true;
+			}
+
+			if (removed) {
+
+				atomic_fetch_sub(&csl->element_count, 1);
+
+				// Unlink it from every level
+				csl_util_find(csl, x, preds, succs);
+				csl_util_release(csl, node, epoch);
+			}
+		}
+		csl_util_leave(csl, epoch);
+	}
+	return removed;
+}
+
+/**
+ * Checks if the element pointed to by x is present in the list
+ */
+bool csl_contains(cskiplist* csl, void* x) {
+
+	return csl_search_2(csl, x, NULL);
+}
+
+/**
+ * Copies the element equal to x in the buffer
+ *
+ * Returns whether or not there was such an element, pointers to the elements aren't
+ * given out since another thread could remove (and free) them at any time
+ */
+bool csl_search_2(cskiplist* csl, void* x, void* buf) {
+
+	bool found = false;
+
+	if (csl && x) {
+
+		csl_node* preds[CSL_MAX_LEVELS];
+		csl_node* succs[CSL_MAX_LEVELS];
+
+		size_t epoch = csl_util_enter(csl);
+
+		found = csl_util_find(csl, x, preds, succs);
+		if (found && buf) memcpy(buf, csl_util_value(succs[0]), csl->element_size);
+
+		csl_util_leave(csl, epoch);
+	}
+	return found;
+}
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side; elements inserted or removed by
+ * other threads during the traversal may or may not be visited, the pointer given
+ * to the callback is only valid during the call
+ */
+void csl_range(cskiplist* csl, void* lo, void* hi, void (*callback)(void*)) {
+
+	if (csl && callback) {
+
+		csl_node* preds[CSL_MAX_LEVELS];
+		csl_node* succs[CSL_MAX_LEVELS];
+		csl_node* n;
+
+		size_t epoch = csl_util_enter(csl);
+
+		if (lo) {
+
+			csl_util_find(csl, lo, preds, succs);
+			n = succs[0];
+		}
+		else n = CSL_PTR(atomic_load(&csl->head->next[0]));
+
+		// The bottom level links every node in order, the marked ones are skipped
+		while (n) {
+
+			uintptr_t next = atomic_load(&n->next[0]);
+
+			if (hi && csl->compare(csl_util_value(n), hi) > 0) break;
+			if (!CSL_MARKED(next)) callback(csl_util_value(n));
+			n = CSL_PTR(next);
+		}
+		csl_util_leave(csl, epoch);
+	}
+	return;
+}
+
+/**
+ * Returns the number of elements of the list (a snapshot, if other threads are modifying it)
+ */
+size_t csl_get_size(cskiplist* csl) {
+
+	return csl ? atomic_load(&csl->element_count) : 0;
+}
+
+/**
+ * Returns the size of the elements of the list
+ */
+size_t csl_get_element_size(cskiplist* csl) {
+
+	return csl ? csl->element_size : 0;
+}
+
+/**
+ * Checks whether the list contains at least one element or not
+ */
+bool csl_is_empty(cskiplist* csl) {
+
+	return csl_get_size(csl) == 0;
+}
+
+/**
+ * Removes every element from the list, no other thread can be using it
+ * (the list struct itself is not deleted)
+ */
+void csl_clear(cskiplist* csl) {
+
+	if (csl) {
+
+		csl_util_free_nodes(csl);
+	}
+	return;
+}
+
+/**
+ * Copies in stats the allocation counters of the nodes of the list, the sentinel included
+ * (always zero unless built with CDS_WITH_STATS, nodes in use aswell)
+ *
+ * Each node is allocated on its own, so every allocation is also a chunk; removed nodes
+ * are in use until they're freed, once no thread can be looking at them
+ */
+void csl_get_stats(cskiplist* csl, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+#ifndef CDS_WITH_STATS
+		(void)csl;
+#else
+		if (csl) {
+
+			// Read while other threads allocate, frees are read first so that live can't wrap around
+			stats->frees = atomic_load(&csl->frees);
+			stats->allocations = atomic_load(&csl->allocations);
+			stats->chunks = stats->allocations;
+			stats->bytes = atomic_load(&csl->bytes);
+			stats->live = stats->allocations - stats->frees;
+		}
+#endif
+	}
+	return;
+}
+
+/* Utility function used to create a node with the given number of levels */
+csl_node* csl_util_create_node(cskiplist* csl, void* x, size_t level) {
+
+	size_t bytes = sizeof(csl_node) + level * sizeof(_Atomic uintptr_t) + csl->element_size;
+	csl_node* n = (csl_node*)malloc(bytes);
+
+	if (n) {
+
+		STATS_INC(csl->allocations);
+		STATS_ADD(csl->bytes, bytes);
+
+		n->retired = NULL;
+		n->level = level;
+		atomic_init(&n->owners, 2);
+		for (size_t i = 0; i < level; i++) atomic_init(&n->next[i], 0);
+		if (x) memcpy(csl_util_value(n), x, csl->element_size);
+	}
+	return n;
+}
+
+/* Utility function used to free a node (nothing if it's NULL) */
+void csl_util_free_node(cskiplist* csl, csl_node* n) {
+
+	// Without CDS_WITH_STATS the list isn't needed
+	(void)csl;
+
+	if (n) {
+
+		STATS_INC(csl->frees);
+		free(n);
+	}
+	return;
+}
+
+/* Utility function that returns a pointer to the value of a node */
+void* csl_util_value(csl_node* n) {
+
+	return (void*)(n->next + n->level);
+}
+
+/* Utility function that finds the last node before x and the first one not before it on every level, unlinking the removed nodes it meets */
+bool csl_util_find(cskiplist* csl, void* x, csl_node** preds, csl_node** succs) {
+
+	size_t top = atomic_load(&csl->top);
+	csl_node* pred;
+	csl_node* curr;
+
+retry:
+	pred = csl->head;
+	curr = NULL;
+
+	for (size_t i = top; i > 0; i--) {
+
+		curr = CSL_PTR(atomic_load(&pred->next[i - 1]));
+		while (curr) {
+
+			uintptr_t succ = atomic_load(&curr->next[i - 1]);
+
+			// curr is being removed, unlink it from this level (if pred is being removed aswell, start over)
+			if (CSL_MARKED(succ)) {
+
+				uintptr_t expected = (uintptr_t)curr;
+				if (!atomic_compare_exchange_strong(&pred->next[i - 1], &expected, succ & ~CSL_MARK)) goto retry;
+				curr = CSL_PTR(succ);
+			}
+			else if (csl->compare(csl_util_value(curr), x) < 0) {
+
+				pred = curr;
+				curr = CSL_PTR(succ);
+			}
+			else break;
+		}
+		preds[i - 1] = pred;
+		succs[i - 1] = curr;
+	}
+	return curr && csl->compare(csl_util_value(curr), x) == 0;
+}
+
+/* Utility function used to draw the level of a new node */
+size_t csl_util_random_level(cskiplist* csl) {
+
+	size_t level = 1;
+
+	// Every thread seeds its own generator the first time, there's no shared state to fight over after that
+	if (csl_random_state == 0) {
+
+		uint64_t z = atomic_fetch_add(&csl_seeds, 0x9E3779B97F4A7C15ull) + (uint64_t)(uintptr_t)&csl_random_state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		csl_random_state = (z ^ (z >> 31)) | 1;
+	}
+
+	while (level < csl->max_levels) {
+
+		// xorshift64*, the top 53 bits make a double in [0, 1)
+		csl_random_state ^= csl_random_state >> 12;
+		csl_random_state ^= csl_random_state << 25;
+		csl_random_state ^= csl_random_state >> 27;
+		double r = (double)((csl_random_state * 0x2545F4914F6CDD1Dull) >> 11) / 9007199254740992.0;
+
+		if (r >= csl->probability) break;
+		level++;
+	}
+	return level;
+}
+
+/* Utility function used to enter an epoch, every access to the nodes is done before leaving it */
+size_t csl_util_enter(cskiplist* csl) {
+
+	size_t epoch;
+
+	// If the epoch moved on before the thread was counted in, it's counted in the new one
+	while (1) {
+
+		epoch = atomic_load(&csl->epoch);
+		atomic_fetch_add(&csl->active[epoch % 3].value, 1);
+		if (atomic_load(&csl->epoch) == epoch) break;
+		atomic_fetch_sub(&csl->active[epoch % 3].value, 1);
+	}
+	return epoch;
+}
+
+/* Utility function used to leave an epoch */
+void csl_util_leave(cskiplist* csl, size_t epoch) {
+
+	atomic_fetch_sub(&csl->active[epoch % 3].value, 1);
+	return;
+}
+
+/* Utility function used to give up a reference to a node, the last one unlinks it and retires it */
+void csl_util_release(cskiplist* csl, csl_node* n, size_t epoch) {
+
+	if (atomic_fetch_sub(&n->owners, 1) == 1) {
+
+		csl_node* preds[CSL_MAX_LEVELS];
+		csl_node* succs[CSL_MAX_LEVELS];
+
+		// The inserting thread could have linked an upper level after the node was marked
+		csl_util_find(csl, csl_util_value(n), preds, succs);
+		csl_util_retire(csl, n, epoch);
+	}
+	return;
+}
+
+/* Utility function used to put a node (already unlinked) in the list of the ones to free */
+void csl_util_retire(cskiplist* csl, csl_node* n, size_t epoch) {
+
+	n->retired = atomic_load(&csl->limbo[epoch % 3]);
+	while (!atomic_compare_exchange_weak(&csl->limbo[epoch % 3], &n->retired, n));
+
+	if (atomic_fetch_add(&csl->retired_count, 1) % CSL_RETIRE_BATCH == CSL_RETIRE_BATCH - 1) csl_util_advance(csl);
+	return;
+}
+
+/* Utility function that moves to the next epoch if every thread is in the current one, freeing the nodes no thread can reach */
+void csl_util_advance(cskiplist* csl) {
+
+	csl_node* freeable = NULL;
+
+	// Only one thread moves the epoch on, the others don't wait for it
+	if (mtx_trylock(&csl->advance) == thrd_success) {
+
+		size_t epoch = atomic_load(&csl->epoch);
+
+		// No thread is in the previous epoch, so none can still see the nodes retired the epoch before it
+		// (nobody retires in that epoch anymore, and nobody will until the next one starts)
+		if (atomic_load(&csl->active[(epoch + 2) % 3].value) == 0) {
+
+			freeable = atomic_exchange(&csl->limbo[(epoch + 1) % 3], NULL);
+			atomic_store(&csl->epoch, epoch + 1);
+		}
+		mtx_unlock(&csl->advance);
+	}
+
+	while (freeable) {
+
+		csl_node* next = freeable->retired;
+		csl_util_free_node(csl, freeable);
+		freeable = next;
+	}
+	return;
+}
+
+/* Utility function used to free every node, when no thread is using the list */
+void csl_util_free_nodes(cskiplist* csl) {
+
+	// Every node still linked is in the bottom level, the others are waiting to be freed
+	csl_node* n = CSL_PTR(atomic_load(&csl->head->next[0]));
+	while (n) {
+
+		csl_node* next = CSL_PTR(atomic_load(&n->next[0]));
+		csl_util_free_node(csl, n);
+		n = next;
+	}
+
+	for (size_t i = 0; i < 3; i++) {
+
+		n = atomic_exchange(&csl->limbo[i], NULL);
+		while (n) {
+
+			csl_node* next = n->retired;
+			csl_util_free_node(csl, n);
+			n = next;
+		}
+	}
+
+	for (size_t i = 0; i < csl->max_levels; i++) atomic_store(&csl->head->next[i], 0);
+	atomic_store(&csl->top, 1);
+	atomic_store(&csl->element_count, 0);
+	return;
+}
\ No newline at end of file
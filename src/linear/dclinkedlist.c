@@ -9,6 +9,7 @@
 #include "../../include/linear/dclinkedlist.h"
 #include "../../include/linear/dnode.h"
 #include <string.h>
+#include <stdint.h>
 
  /**
   * Struct that represent a double linked circular list of elements of a generic type value
@@ -33,6 +34,9 @@ typedef struct dclinkedlist {
 	/* Size of the elements stored in the list */
 	size_t element_size;
 
+	/* Pool the nodes are taken from, owned by the list */
+	pool* nodes;
+
 } dclinkedlist;
 
 /**
@@ -48,8 +52,17 @@ dclinkedlist* dcl_create(size_t element_size) {
 
 		if (dcl) {
 
+			dcl->head = NULL;
 			dcl->element_size = element_size;
 			dcl->element_count = 0;
+			dcl->nodes = pool_create(dnode_get_footprint(element_size));
+
+			// Cancel the creation if the nodes can't be allocated
+			if (!dcl->nodes) {
+
+				free(dcl);
+				dcl = NULL;
+			}
 		}
 	}
 	return dcl;
@@ -67,8 +80,8 @@ void dcl_delete(dclinkedlist** dcl) {
 	// Access the list only if the pointer is valid
 	if (dcl && *dcl) {
 
-		// Free every node
-		dcl_clear(*dcl);
+		// Free every node, all at once
+		pool_delete(&(*dcl)->nodes);
 
 		// Free the memory used for the whole struct
 		memset(*dcl, 0, sizeof(dclinkedlist));
@@ -90,7 +103,7 @@ void dcl_insert_at(dclinkedlist* dcl, void* x, size_t i) {
 		i = i % (dcl->element_count + 1);
 
 		// Create the node
-		dnode* dn = dnode_create(x, dcl->element_size);
+		dnode* dn = dnode_create_in(dcl->nodes, x, dcl->element_size);
 
 		// Continue only if the node was created
 		if (dn) {
@@ -181,7 +194,7 @@ void dcl_remove_at(dclinkedlist* dcl, size_t i) {
 		// Head update
 		if (i == 0) dnode_get_next(to_be_deleted);
 
-		dnode_delete(&to_be_deleted);
+		dnode_delete_in(dcl->nodes, &to_be_deleted);
 		dcl->element_count--;
 	}
 	return;
@@ -321,6 +334,21 @@ size_t dcl_get_element_size(dclinkedlist* dcl) {
 	return dcl ? dcl->element_size : 0;
 }
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void dcl_get_stats(dclinkedlist* dcl, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (dcl) pool_add_stats(dcl->nodes, stats);
+	}
+	return;
+}
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -365,14 +393,8 @@ void dcl_clear(dclinkedlist* dcl) {
 	// Access the list if the pointer is valid
 	if (dcl) {
 
-		dnode* to_be_deleted = NULL;
-		dnode* tmp = dcl->head;
-		for (int i = 0; i < dcl->element_count; i++) {
-
-			to_be_deleted = tmp;
-			tmp = dnode_get_next(tmp);
-			dnode_delete(&to_be_deleted);
-		}
+		// Every node comes from the pool, release them all without visiting the list
+		pool_clear(dcl->nodes);
 		dcl->head = NULL;
 		dcl->element_count = 0;
 	}
@@ -7,8 +7,9 @@
  */
 
 #include "../../include/linear/deque.h"
-#include "../../include/linear/dclinkedlist.h"
+#include "../../include/linear/chunkedarray.h"
 #include <string.h>
+#include <stdint.h>
 
  /**
   * Struct that represent a double ended queue that can store
@@ -27,11 +28,11 @@ typedef struct deque {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* Pointer to the actual list that implements the deque, the head of the list is the
-	  * queue's head (since it's circular and double linked
-	  * we can both operate on the tail and head with O(1) )
+	 /* Pointer to the chunked array that implements the deque, its first element is the
+	  * queue's head (we can both operate on the tail and head with O(1), and blocks are reused
+	  * so the deque doesn't reach the allocator once it reached its size)
 	  */
-	dclinkedlist* head;
+	chunkedarray* head;
 } deque;
 
 /**
@@ -47,12 +48,12 @@ deque* deque_create(size_t element_size) {
 		// Create the struct
 		d = (deque*)malloc(sizeof(deque));
 
-		// If it was created, create the actual list (queue)
+		// If it was created, create the actual chunked array (queue)
 		if (d) {
 
-			d->head = dcl_create(element_size);
+			d->head = ca_create(element_size);
 
-			// If the list was not created, cancel the creation
+			// If the chunked array was not created, cancel the creation
 			if (!d->head) {
 				free(d);
 				d = NULL;
@@ -74,7 +75,7 @@ void deque_delete(deque** d) {
 	if (d && *d) {
 
 		// Delete the struct holding the elements, this will delete each element as well
-		dcl_delete(&((*d)->head));
+		ca_delete(&((*d)->head));
 		(*d)->head = NULL;
 
 		// Free the memory for the actual struct
@@ -91,7 +92,7 @@ void deque_push_front(deque* d, void* x) {
 
 	if (d && x) {
 
-		dcl_insert_head(d->head, x);
+		ca_push_front(d->head, x);
 	}
 	return;
 }
@@ -103,7 +104,7 @@ void deque_push_back(deque* d, void* x) {
 
 	if (d && x) {
 
-		dcl_insert_tail(d->head, x);
+		ca_push_back(d->head, x);
 	}
 	return;
 }
@@ -115,15 +116,10 @@ void* deque_pop_front(deque* d) {
 
 	void* val = NULL;
 
-	if (d) {
+	if (d && !ca_is_empty(d->head)) {
 
-		val = malloc(dcl_get_element_size(d->head));
-
-		if (val) {
-
-			memcpy(val, dcl_get_head(d->head), dcl_get_element_size(d->head));
-			dcl_remove_head(d->head);
-		}
+		val = malloc(ca_get_element_size(d->head));
+		if (val) ca_pop_2_front(d->head, val);
 	}
 
 	return val;
@@ -131,14 +127,12 @@ void* deque_pop_front(deque* d) {
 
 /**
  * Removes the first element of the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void deque_pop_2_front(deque* d, void* buf) {
 
-	if (d && buf) {
-
-		dcl_get_2_head(d->head, buf);
-		dcl_remove_head(d->head);
-	}
+	if (d && buf) ca_pop_2_front(d->head, buf);
 	return;
 }
 
@@ -149,15 +143,10 @@ void* deque_pop_back(deque* d) {
 
 	void* val = NULL;
 
-	if (d) {
+	if (d && !ca_is_empty(d->head)) {
 
-		val = malloc(dcl_get_element_size(d->head));
-
-		if (val) {
-
-			memcpy(val, dcl_get_tail(d->head), dcl_get_element_size(d->head));
-			dcl_remove_tail(d->head);
-		}
+		val = malloc(ca_get_element_size(d->head));
+		if (val) ca_pop_2_back(d->head, val);
 	}
 
 	return val;
@@ -165,14 +154,12 @@ void* deque_pop_back(deque* d) {
 
 /**
  * Removes the last element of the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void deque_pop_2_back(deque* d, void* buf) {
 
-	if (d && buf) {
-
-		dcl_get_2_tail(d->head, buf);
-		dcl_remove_tail(d->head);
-	}
+	if (d && buf) ca_pop_2_back(d->head, buf);
 	return;
 }
 
@@ -181,7 +168,7 @@ void deque_pop_2_back(deque* d, void* buf) {
  */
 void* deque_peek_front(deque* d) {
 
-	return d ? dcl_get_head(d->head) : NULL;
+	return d ? ca_get_front(d->head) : NULL;
 }
 
 /**
@@ -189,7 +176,7 @@ void* deque_peek_front(deque* d) {
  */
 void deque_peek_2_front(deque* d, void* buf) {
 
-	if (d && buf) dcl_get_2_head(d->head, buf);
+	if (d && buf && !ca_is_empty(d->head)) memcpy(buf, ca_get_front(d->head), ca_get_element_size(d->head));
 	return;
 }
 
@@ -198,7 +185,7 @@ void deque_peek_2_front(deque* d, void* buf) {
  */
 void* deque_peek_back(deque* d) {
 
-	return d ? dcl_get_tail(d->head) : NULL;
+	return d ? ca_get_back(d->head) : NULL;
 }
 
 /**
@@ -206,7 +193,7 @@ void* deque_peek_back(deque* d) {
  */
 void deque_peek_2_back(deque* d, void* buf) {
 
-	if (d && buf) dcl_get_2_tail(d->head, buf);
+	if (d && buf && !ca_is_empty(d->head)) memcpy(buf, ca_get_back(d->head), ca_get_element_size(d->head));
 	return;
 }
 
@@ -215,7 +202,7 @@ void deque_peek_2_back(deque* d, void* buf) {
  */
 size_t deque_get_size(deque* d) {
 
-	return d ? dcl_get_size(d->head) : 0;
+	return d ? ca_get_size(d->head) : 0;
 }
 
 /**
@@ -223,7 +210,7 @@ size_t deque_get_size(deque* d) {
  */
 size_t deque_get_element_size(deque* d) {
 
-	return d ? dcl_get_element_size(d->head) : 0;
+	return d ? ca_get_element_size(d->head) : 0;
 }
 
 /**
@@ -232,7 +219,7 @@ size_t deque_get_element_size(deque* d) {
  */
 void deque_clear(deque* d) {
 
-	if (d) dcl_clear(d->head);
+	if (d) ca_clear(d->head);
 	return;
 }
 
@@ -241,5 +228,5 @@ void deque_clear(deque* d) {
  */
 bool deque_is_empty(deque* d) {
 
-	return d ? dcl_is_empty(d->head) : true;
+	return d ? ca_is_empty(d->head) : true;
 }
\ No newline at end of file
@@ -9,6 +9,25 @@
 #include "../../include/linear/dlinkedlist.h"
 #include "../../include/linear/dnode.h"
 #include <string.h>
+#include <stdint.h>
+#include "../../include/linear/parallel.h"
+
+/* Utility function that returns the i -th node, starting from whichever of the head, the tail and the last position reached is closer */
+dnode* dll_util_walk(dlinkedlist* dll, size_t i);
+
+/* Number of elements each thread of a parallel operation takes at a time */
+#define DLL_PARALLEL_GRAIN 1024
+
+/* State shared by the threads of a parallel operation, the values are collected beforehand */
+typedef struct dll_parallel_task {
+
+	void** values;
+	size_t element_size;
+	void (*f)(void*);
+} dll_parallel_task;
+
+/* Utility function used as the body of dll_parallel_for_each, for the elements from 'from' to 'to' */
+void dll_util_parallel_for_each(void* context, size_t from, size_t to);
 
  /**
   * Struct that represent a double linked list of elements of a generic type value
@@ -27,12 +46,22 @@ typedef struct dlinkedlist {
 	 /* Pointer to the first node (head) of the list */
 	dnode* head;
 
+	/* Pointer to the last node (tail) of the list */
+	dnode* tail;
+
+	/* Last node reached by a walk, and its index (NULL if it isn't known) */
+	dnode* cursor;
+	size_t cursor_index;
+
 	/* Number of elements present in the list */
 	size_t element_count;
 
 	/* Size of the elements stored in the list */
 	size_t element_size;
 
+	/* Pool the nodes are taken from, owned by the list */
+	pool* nodes;
+
 } dlinkedlist;
 
 /**
@@ -48,8 +77,20 @@ dlinkedlist* dll_create(size_t element_size) {
 
 		if (dll) {
 
+			dll->head = NULL;
+			dll->tail = NULL;
+			dll->cursor = NULL;
+			dll->cursor_index = 0;
 			dll->element_size = element_size;
 			dll->element_count = 0;
+			dll->nodes = pool_create(dnode_get_footprint(element_size));
+
+			// Cancel the creation if the nodes can't be allocated
+			if (!dll->nodes) {
+
+				free(dll);
+				dll = NULL;
+			}
 		}
 	}
 	return dll;
@@ -67,8 +108,8 @@ void dll_delete(dlinkedlist** dll) {
 	// Access the list only if the pointer is valid
 	if (dll && *dll) {
 
-		// Free every node
-		dll_clear(*dll);
+		// Free every node, all at once
+		pool_delete(&(*dll)->nodes);
 
 		// Free the memory used for the whole struct
 		memset(*dll, 0, sizeof(dlinkedlist));
@@ -90,7 +131,7 @@ void dll_insert_at(dlinkedlist* dll, void* x, size_t i) {
 		if (i <= dll->element_count) {
 
 			// Create the node
-			dnode* dn = dnode_create(x, dll->element_size);
+			dnode* dn = dnode_create_in(dll->nodes, x, dll->element_size);
 
 			// Continue only if the node was created
 			if (dn) {
@@ -101,18 +142,16 @@ void dll_insert_at(dlinkedlist* dll, void* x, size_t i) {
 					dnode_set_next(dn, dll->head); // Connect the new node with the old head
 					dnode_set_prev(dll->head, dn);
 					dll->head = dn; // And replace the list's head
+
+					// Every node moved one position forward
+					dll->cursor_index++;
 				}
 
 				// In every other case
 				else {
 
-					dnode* tmp = dll->head;
-
-					// Iterate to the element before i
-					for (int j = 1; j < i; j++) {
-
-						tmp = dnode_get_next(tmp);
-					}
+					// Get to the element before i
+					dnode* tmp = dll_util_walk(dll, i - 1);
 
 					// Connect the node n between the node i-1 and i, becoming the new i -th node
 					dnode_set_next(dn, dnode_get_next(tmp));
@@ -122,6 +161,7 @@ void dll_insert_at(dlinkedlist* dll, void* x, size_t i) {
 					dnode_set_prev(dn, tmp);
 				}
 
+				if (i == dll->element_count) dll->tail = dn;
 				dll->element_count++;
 			}
 		}
@@ -166,12 +206,8 @@ void dll_remove_at(dlinkedlist* dll, size_t i) {
 		// Check if the position is correct
 		if (i < dll->element_count) {
 
-			// Iterate until the i -th element
-			dnode* to_be_deleted = dll->head;
-			for (int j = 0; j < i; j++) {
-
-				to_be_deleted = dnode_get_next(to_be_deleted);
-			}
+			// Get to the i -th element
+			dnode* to_be_deleted = dll_util_walk(dll, i);
 
 			/* We are now at the position i, we remove this node by connecting the one before with the one after
 			 *
@@ -181,8 +217,13 @@ void dll_remove_at(dlinkedlist* dll, size_t i) {
 			if (i > 0) dnode_set_next(dnode_get_prev(to_be_deleted), dnode_get_next(to_be_deleted)); // Only if not removing the head
 			else dll->head = dnode_get_next(to_be_deleted); // Update head if removed
 			if (i < dll->element_count - 1) dnode_set_prev(dnode_get_next(to_be_deleted), dnode_get_prev(to_be_deleted)); // Only if not removing the tail
+			else dll->tail = dnode_get_prev(to_be_deleted); // Update tail if removed
+
+			// The node before it is the last one reached
+			dll->cursor = dnode_get_prev(to_be_deleted);
+			dll->cursor_index = i - 1;
 
-			dnode_delete(&to_be_deleted);
+			dnode_delete_in(dll->nodes, &to_be_deleted);
 			dll->element_count--;
 		}
 	}
@@ -217,6 +258,8 @@ void dll_remove_tail(dlinkedlist* dll) {
 
 /**
  * Returns a pointer to the i -th element of the list
+ *
+ * The list remembers the last position it reached, so accessing the elements in order costs O(1) each
  */
 void* dll_get_at(dlinkedlist* dll, size_t i) {
 
@@ -228,16 +271,8 @@ void* dll_get_at(dlinkedlist* dll, size_t i) {
 		// Check if the position is correct
 		if (i < dll->element_count) {
 
-			// Iterate to the i -th node
-			dnode* tmp = dll->head;
-
-			for (int j = 0; j < i; j++) {
-
-				tmp = dnode_get_next(tmp);
-			}
-
 			// Return the value
-			ret = dnode_get_value(tmp);
+			ret = dnode_get_value(dll_util_walk(dll, i));
 		}
 	}
 	return ret;
@@ -256,16 +291,8 @@ void dll_get_2_at(dlinkedlist* dll, size_t i, void* buf) {
 		// Check if the position is correct
 		if (i < dll->element_count) {
 
-			// Iterate to the i -th node
-			dnode* tmp = dll->head;
-
-			for (int j = 0; j < i; j++) {
-
-				tmp = dnode_get_next(tmp);
-			}
-
 			// Copy the value
-			memcpy(buf, dnode_get_value(tmp), dll->element_size);
+			memcpy(buf, dnode_get_value(dll_util_walk(dll, i)), dll->element_size);
 		}
 	}
 	return;
@@ -325,6 +352,21 @@ size_t dll_get_element_size(dlinkedlist* dll) {
 	return dll ? dll->element_size : 0;
 }
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void dll_get_stats(dlinkedlist* dll, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (dll) pool_add_stats(dll->nodes, stats);
+	}
+	return;
+}
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -369,15 +411,11 @@ void dll_clear(dlinkedlist* dll) {
 	// Access the list if the pointer is valid
 	if (dll) {
 
-		dnode* to_be_deleted = NULL;
-		dnode* tmp = dll->head;
-		for (int i = 0; i < dll->element_count; i++) {
-
-			to_be_deleted = tmp;
-			tmp = dnode_get_next(tmp);
-			dnode_delete(&to_be_deleted);
-		}
+		// Every node comes from the pool, release them all without visiting the list
+		pool_clear(dll->nodes);
 		dll->head = NULL;
+		dll->tail = NULL;
+		dll->cursor = NULL;
 		dll->element_count = 0;
 	}
 }
@@ -412,6 +450,35 @@ void dll_for_each(dlinkedlist* dll, void (*f)(void*)) {
 	return;
 }
 
+/**
+ * Applies the function f to every element of the double linked list dll, using (at most) the given number of threads
+ *
+ * The positions of the elements are collected first, then they're split in chunks
+ * handled by the threads, f gets a copy of the element (like in dll_for_each)
+ * and is called by many threads at the same time, so it must be thread safe
+ */
+void dll_parallel_for_each(dlinkedlist* dll, void (*f)(void*), size_t threads) {
+
+	if (dll && f && dll->element_count > 0) {
+
+		dll_parallel_task task;
+		task.values = (void**)malloc(dll->element_count * sizeof(void*));
+		task.element_size = dll->element_size;
+		task.f = f;
+
+		if (task.values) {
+
+			// Walking the list can't be split, so the positions of the values are collected first
+			dnode* tmp = dll->head;
+			for (size_t i = 0; i < dll->element_count; i++, tmp = dnode_get_next(tmp)) task.values[i] = dnode_get_value(tmp);
+
+			parallel_util_for(dll->element_count, DLL_PARALLEL_GRAIN, threads, dll_util_parallel_for_each, &task);
+			free(task.values);
+		}
+	}
+	return;
+}
+
 /**
  * Returns a double linked list obtained by applying
  * the function f to every element of the original list dll
@@ -446,4 +513,160 @@ dlinkedlist* dll_map(dlinkedlist* dll, void* (*f)(void*)){
 		}
 	}
 	return mapped;
+}
+
+/**
+ * Initializes the iterator so that it starts from the head of the list
+ */
+void dll_iter_begin(dlinkedlist* dll, dll_iterator* it) {
+
+	if (dll && it) {
+
+		it->list = dll;
+		it->node = dll->head;
+		it->last = NULL;
+		it->index = 0;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool dll_iter_has_next(dll_iterator* it) {
+
+	return it ? it->node != NULL : false;
+}
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* dll_iter_next(dll_iterator* it) {
+
+	void* ret = NULL;
+
+	if (it && it->node) {
+
+		ret = dnode_get_value((dnode*)it->node);
+
+		it->last = it->node;
+		it->node = dnode_get_next((dnode*)it->node);
+		it->index++;
+	}
+	return ret;
+}
+
+/**
+ * Inserts the element pointed to by x before the next element (at the end, if there's none)
+ *
+ * The next element returned is still the one that would have been returned before
+ */
+void dll_iter_insert(dll_iterator* it, void* x) {
+
+	if (it && x) {
+
+		dlinkedlist* dll = it->list;
+		dnode* dn = dnode_create_in(dll->nodes, x, dll->element_size);
+
+		if (dn) {
+
+			dnode* next = (dnode*)it->node;
+			dnode* prev = next ? dnode_get_prev(next) : dll->tail;
+
+			// Connect the node between the element before the iterator and the next one
+			dnode_set_prev(dn, prev);
+			dnode_set_next(dn, next);
+			if (prev) dnode_set_next(prev, dn);
+			else dll->head = dn;
+			if (next) dnode_set_prev(next, dn);
+			else dll->tail = dn;
+
+			it->last = NULL;
+			it->index++;
+			dll->element_count++;
+
+			// The new node is the last one reached
+			dll->cursor = dn;
+			dll->cursor_index = it->index - 1;
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the last element returned by dll_iter_next
+ *
+ * It can be done once per element returned, and not after an insertion
+ */
+void dll_iter_remove(dll_iterator* it) {
+
+	if (it && it->last) {
+
+		dlinkedlist* dll = it->list;
+		dnode* to_be_deleted = (dnode*)it->last;
+		dnode* prev = dnode_get_prev(to_be_deleted);
+		dnode* next = dnode_get_next(to_be_deleted);
+
+		// Connect the node before it with the one after it
+		if (prev) dnode_set_next(prev, next);
+		else dll->head = next;
+		if (next) dnode_set_prev(next, prev);
+		else dll->tail = prev;
+
+		dnode_delete_in(dll->nodes, &to_be_deleted);
+		dll->element_count--;
+
+		it->last = NULL;
+		it->index--;
+
+		// The node before it is the last one reached
+		dll->cursor = prev;
+		dll->cursor_index = it->index - 1;
+	}
+	return;
+}
+
+/* Utility function that returns the i -th node, starting from whichever of the head, the tail and the last position reached is closer */
+dnode* dll_util_walk(dlinkedlist* dll, size_t i) {
+
+	dnode* tmp = dll->head;
+	size_t j = 0;
+	size_t distance = i;
+
+	if (dll->element_count - 1 - i < distance) {
+
+		tmp = dll->tail;
+		j = dll->element_count - 1;
+		distance = j - i;
+	}
+	if (dll->cursor && (dll->cursor_index > i ? dll->cursor_index - i : i - dll->cursor_index) < distance) {
+
+		tmp = dll->cursor;
+		j = dll->cursor_index;
+	}
+
+	// The list can be walked in both directions
+	for (; j < i; j++) tmp = dnode_get_next(tmp);
+	for (; j > i; j--) tmp = dnode_get_prev(tmp);
+
+	dll->cursor = tmp;
+	dll->cursor_index = i;
+	return tmp;
+}
+
+/* Utility function used as the body of dll_parallel_for_each, applies f to a copy of each value of the chunk */
+void dll_util_parallel_for_each(void* context, size_t from, size_t to) {
+
+	dll_parallel_task* task = (dll_parallel_task*)context;
+	void* tmp_buf = malloc(task->element_size);
+
+	if (tmp_buf) {
+		for (size_t i = from; i < to; i++) {
+
+			memcpy(tmp_buf, task->values[i], task->element_size);
+			task->f(tmp_buf);
+		}
+		free(tmp_buf);
+	}
+	return;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
  */
 
 #include "../../include/linear/dnode.h"
+#include <stdint.h>
 #include <string.h>
 
 /**
@@ -19,6 +20,8 @@
  * The node itself has three components, a value stored,
  * a pointer to the next node in the list, and a pointer
  * to the previous node
+ *
+ * The value is stored right after the struct, in the same allocation
  */
 typedef struct dnode {
 
@@ -31,12 +34,6 @@ typedef struct dnode {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* Pointer to the memory location that stores the node's value
-	  *
-	  * Void* is used to accept any type of data
-	  */
-	void* ptr;
-
 	/* Pointer to the previous node
 	 * (as in previous in a list)
 	 */
@@ -56,36 +53,32 @@ typedef struct dnode {
  */
 dnode* dnode_create(void* value, size_t value_size) {
 
+	return dnode_create_in(NULL, value, value_size);
+}
+
+/**
+ * Creates a node like dnode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least dnode_get_footprint(value_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+dnode* dnode_create_in(pool* p, void* value, size_t value_size) {
+
 	dnode* dn = NULL;
 
 	// Check if the size is reasonable
-	if (value_size <= SIZE_MAX) {
+	if (value_size <= SIZE_MAX - sizeof(dnode)) {
 
-		// Allocate memory for the node struct
-		dn = (dnode*)malloc(sizeof(dnode));
+		// Allocate memory for the node struct and its value, in one block
+		dn = (dnode*)(p ? pool_alloc(p) : malloc(dnode_get_footprint(value_size)));
 
 		// If it was allocated
 		if (dn) {
 
-			// Allocate memory for the value
-			dn->ptr = malloc(value_size);
-
-			// If it was allocated
-			if (dn->ptr) {
-
-				// Initialize the fields
-				memcpy(dn->ptr, value, value_size);
-				dn->prev = NULL;
-				dn->next = NULL;
-			}
-
-			// Otherwise
-			else {
-
-				// Cancel the creation, free the memory used for the struct
-				free(dn);
-				dn = NULL;
-			}
+			// Initialize the fields
+			memcpy(dnode_get_value(dn), value, value_size);
+			dn->prev = NULL;
+			dn->next = NULL;
 		}
 	}
 	return dn;
@@ -94,25 +87,41 @@ dnode* dnode_create(void* value, size_t value_size) {
 /**
  * Deletes the given node
  *
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ * The value is stored with the struct
+ * so a single free releases both
  */
 void dnode_delete(dnode** dn) {
 
-	// Check if the ptr fields needs to be freed as well
-	if (dn != NULL && *dn != NULL) {
+	dnode_delete_in(NULL, dn);
+	return;
+}
 
-		// Free the memory used for the value
-		free((*dn)->ptr);
+/**
+ * Deletes the given node, created by dnode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void dnode_delete_in(pool* p, dnode** dn) {
+
+	if (dn != NULL && *dn != NULL) {
 
-		// Free the memory used for the struct
-		memset(*dn, 0, sizeof(dnode));
-		free(*dn);
+		if (p) pool_free(p, *dn);
+		else free(*dn);
 		*dn = NULL;
 	}
 	return;
 }
 
+/**
+ * Returns the number of bytes used by a node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t dnode_get_footprint(size_t value_size) {
+
+	return sizeof(dnode) + value_size;
+}
+
 /**
  * Returns a pointer to the value stored in the
  * node
@@ -122,7 +131,7 @@ void dnode_delete(dnode** dn) {
  */
 void* dnode_get_value(dnode* dn) {
 
-	return dn ? dn->ptr : NULL;
+	return dn ? (void*)((char*)dn + sizeof(dnode)) : NULL;
 }
 
 /**
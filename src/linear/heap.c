@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/heap.h"
+#include <stdlib.h>
+
+/* Number of children of every node */
+#define HEAP_ARITY 4
+
+/* Position of the ids that aren't in the heap */
+#define HEAP_NOT_PRESENT ((size_t)-1)
+
+/* Utility function that makes room for the ids in [0, capacity) */
+void heap_util_reserve(heap* h, size_t capacity);
+
+/* Utility function that moves the entry at the given position up until its parent has a lower priority */
+void heap_util_sift_up(heap* h, size_t position);
+
+/* Utility function that moves the entry at the given position down until its children have a higher priority */
+void heap_util_sift_down(heap* h, size_t position);
+
+/* Utility function that removes the entry at the given position */
+void heap_util_remove_at(heap* h, size_t position);
+
+/**
+ * Entry of the heap, the priority is stored next to the id
+ * so that comparing the children of a node doesn't need to look anywhere else
+ */
+typedef struct heap_entry {
+
+	/* Priority of the id, lower comes first */
+	double priority;
+
+	/* The id itself */
+	size_t id;
+} heap_entry;
+
+/**
+ * Struct that represent an indexed heap (min priority queue) of ids
+ */
+typedef struct heap {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* The 4-ary tree layed out in an array, the children of position i are at 4i + 1 ... 4i + 4 */
+	heap_entry* entries;
+
+	/* Position in the entries of every id (HEAP_NOT_PRESENT if the id isn't in the heap) */
+	size_t* positions;
+
+	/* Number of ids in the heap */
+	size_t size;
+
+	/* Ids that can be stored without growing, [0, capacity) */
+	size_t capacity;
+} heap;
+
+/**
+ * Creates a heap with room for the ids in [0, capacity), bigger ids make it grow
+ */
+heap* heap_create(size_t capacity) {
+
+	heap* h = NULL;
+
+	// Allocate the struct
+	h = (heap*)malloc(sizeof(heap));
+	if (h) {
+
+		h->entries = NULL;
+		h->positions = NULL;
+		h->size = 0;
+		h->capacity = 0;
+
+		heap_util_reserve(h, capacity > 0 ? capacity : 1);
+		if (h->capacity == 0) {
+
+			free(h);
+			h = NULL;
+		}
+	}
+	return h;
+}
+
+/**
+ * Deletes the given heap, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for the ids and their positions is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void heap_delete(heap** h) {
+
+	if (h && *h) {
+
+		free((*h)->entries);
+		free((*h)->positions);
+		free(*h);
+		*h = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts the id with the given priority, if it's already in the heap its priority is replaced
+ */
+void heap_push(heap* h, size_t id, double priority) {
+
+	size_t position;
+	double old;
+
+	if (h && id != HEAP_NO_ID) {
+
+		if (id >= h->capacity) heap_util_reserve(h, id + 1);
+		if (id < h->capacity) {
+
+			position = h->positions[id];
+
+			// New id, it starts as the last leaf
+			if (position == HEAP_NOT_PRESENT) {
+
+				position = h->size++;
+				h->entries[position].id = id;
+				h->entries[position].priority = priority;
+				h->positions[id] = position;
+				heap_util_sift_up(h, position);
+			}
+			else {
+
+				old = h->entries[position].priority;
+				h->entries[position].priority = priority;
+
+				if (priority < old) heap_util_sift_up(h, position);
+				else heap_util_sift_down(h, position);
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Lowers the priority of the id to the given one, or inserts it if it's not in the heap
+ *
+ * Returns whether or not the priority changed (false if the id already had a lower, or the same, priority)
+ */
+bool heap_decrease_key(heap* h, size_t id, double priority) {
+
+	bool changed = false;
+
+	if (h && id != HEAP_NO_ID) {
+
+		if (!heap_contains(h, id) || priority < h->entries[h->positions[id]].priority) {
+
+			heap_push(h, id, priority);
+			changed = heap_contains(h, id);
+		}
+	}
+	return changed;
+}
+
+/**
+ * Removes the id with the lowest priority and returns it, HEAP_NO_ID if the heap is empty
+ *
+ * Its priority is copied in the given buffer (if it's not NULL)
+ */
+size_t heap_pop(heap* h, double* priority) {
+
+	size_t id = heap_peek(h, priority);
+
+	if (id != HEAP_NO_ID) heap_util_remove_at(h, 0);
+	return id;
+}
+
+/**
+ * Returns the id with the lowest priority without removing it, HEAP_NO_ID if the heap is empty
+ *
+ * Its priority is copied in the given buffer (if it's not NULL)
+ */
+size_t heap_peek(heap* h, double* priority) {
+
+	size_t id = HEAP_NO_ID;
+
+	if (h && h->size > 0) {
+
+		id = h->entries[0].id;
+		if (priority) *priority = h->entries[0].priority;
+	}
+	return id;
+}
+
+/**
+ * Removes the given id from the heap
+ */
+void heap_remove(heap* h, size_t id) {
+
+	if (heap_contains(h, id)) {
+
+		heap_util_remove_at(h, h->positions[id]);
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the id is in the heap
+ */
+bool heap_contains(heap* h, size_t id) {
+
+	return h && id < h->capacity && h->positions[id] != HEAP_NOT_PRESENT;
+}
+
+/**
+ * Returns the priority of the id, 0 if it's not in the heap
+ */
+double heap_get_priority(heap* h, size_t id) {
+
+	double priority = 0;
+
+	if (heap_contains(h, id)) {
+
+		priority = h->entries[h->positions[id]].priority;
+	}
+	return priority;
+}
+
+/**
+ * Returns the number of ids in the heap
+ */
+size_t heap_get_size(heap* h) {
+
+	return h ? h->size : 0;
+}
+
+/**
+ * Removes every id from the heap
+ * (the heap struct itself is not deleted)
+ */
+void heap_clear(heap* h) {
+
+	size_t i;
+
+	if (h) {
+
+		// Only the ids in the heap have a position to reset
+		for (i = 0; i < h->size; i++) {
+
+			h->positions[h->entries[i].id] = HEAP_NOT_PRESENT;
+		}
+		h->size = 0;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the heap is empty
+ */
+bool heap_is_empty(heap* h) {
+
+	return heap_get_size(h) == 0;
+}
+
+/* Utility function that makes room for the ids in [0, capacity) */
+void heap_util_reserve(heap* h, size_t capacity) {
+
+	size_t new_capacity, i;
+	heap_entry* entries;
+	size_t* positions;
+
+	if (h && capacity > h->capacity) {
+
+		// Grow geometrically so pushing increasing ids stays amortized O(1)
+		new_capacity = h->capacity * 2;
+		if (new_capacity < capacity) new_capacity = capacity;
+
+		entries = (heap_entry*)realloc(h->entries, new_capacity * sizeof(heap_entry));
+		if (entries) {
+
+			h->entries = entries;
+
+			positions = (size_t*)realloc(h->positions, new_capacity * sizeof(size_t));
+			if (positions) {
+
+				for (i = h->capacity; i < new_capacity; i++) positions[i] = HEAP_NOT_PRESENT;
+
+				h->positions = positions;
+				h->capacity = new_capacity;
+			}
+		}
+	}
+	return;
+}
+
+/* Utility function that moves the entry at the given position up until its parent has a lower priority */
+void heap_util_sift_up(heap* h, size_t position) {
+
+	heap_entry entry = h->entries[position];
+	size_t parent;
+
+	// Instead of swapping at every level, parents are moved down and the entry is written once at the end
+	while (position > 0) {
+
+		parent = (position - 1) / HEAP_ARITY;
+		if (h->entries[parent].priority <= entry.priority) break;
+
+		h->entries[position] = h->entries[parent];
+		h->positions[h->entries[position].id] = position;
+		position = parent;
+	}
+	h->entries[position] = entry;
+	h->positions[entry.id] = position;
+	return;
+}
+
+/* Utility function that moves the entry at the given position down until its children have a higher priority */
+void heap_util_sift_down(heap* h, size_t position) {
+
+	heap_entry entry = h->entries[position];
+	size_t first, last, child, best;
+
+	while (1) {
+
+		first = position * HEAP_ARITY + 1;
+		if (first >= h->size) break;
+
+		last = first + HEAP_ARITY;
+		if (last > h->size) last = h->size;
+
+		// Find the child with the lowest priority
+		best = first;
+		for (child = first + 1; child < last; child++) {
+
+			if (h->entries[child].priority < h->entries[best].priority) best = child;
+		}
+		if (h->entries[best].priority >= entry.priority) break;
+
+		h->entries[position] = h->entries[best];
+		h->positions[h->entries[position].id] = position;
+		position = best;
+	}
+	h->entries[position] = entry;
+	h->positions[entry.id] = position;
+	return;
+}
+
+/* Utility function that removes the entry at the given position */
+void heap_util_remove_at(heap* h, size_t position) {
+
+	double removed = h->entries[position].priority;
+
+	h->positions[h->entries[position].id] = HEAP_NOT_PRESENT;
+	h->size--;
+
+	// The last leaf takes the place of the removed entry and is moved where it belongs
+	if (position < h->size) {
+
+		h->entries[position] = h->entries[h->size];
+		h->positions[h->entries[position].id] = position;
+
+		if (h->entries[position].priority < removed) heap_util_sift_up(h, position);
+		else heap_util_sift_down(h, position);
+	}
+	return;
+}
\ No newline at end of file
@@ -6,9 +6,30 @@
  * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#ifndef LINKEDLIST_WITH_UNROLLED_NODES
+
 #include "../../include/linear/linkedlist.h"
 #include "../../include/linear/node.h"
 #include <string.h>
+#include <stdint.h>
+#include "../../include/linear/parallel.h"
+
+/* Utility function that returns the i -th node, starting from the last position reached when that's closer */
+node* ll_util_walk(linkedlist* ll, size_t i);
+
+/* Number of elements each thread of a parallel operation takes at a time */
+#define LL_PARALLEL_GRAIN 1024
+
+/* State shared by the threads of a parallel operation, the values are collected beforehand */
+typedef struct ll_parallel_task {
+
+	void** values;
+	size_t element_size;
+	void (*f)(void*);
+} ll_parallel_task;
+
+/* Utility function used as the body of ll_parallel_for_each, for the elements from 'from' to 'to' */
+void ll_util_parallel_for_each(void* context, size_t from, size_t to);
 
 /**
  * Struct that represent a list of elements of a generic type value
@@ -27,12 +48,22 @@ typedef struct linkedlist {
 	/* Pointer to the first node (head) of the list */
 	node* head;
 
+	/* Pointer to the last node (tail) of the list */
+	node* tail;
+
+	/* Last node reached by a walk, and its index (NULL if it isn't known) */
+	node* cursor;
+	size_t cursor_index;
+
 	/* Number of elements present in the list */
 	size_t element_count;
 
 	/* Size of the elements stored in the list */
 	size_t element_size;
 
+	/* Pool the nodes are taken from, owned by the list */
+	pool* nodes;
+
 } linkedlist;
 
 /**
@@ -40,6 +71,16 @@ typedef struct linkedlist {
  */
 linkedlist* ll_create(size_t element_size) {
 
+	return ll_create_inline(element_size, 0);
+}
+
+/**
+ * Creates a linked list whose first inline_length nodes are stored in the same allocation as their pool
+ *
+ * A list that never holds more than inline_length elements doesn't allocate its nodes one by one
+ */
+linkedlist* ll_create_inline(size_t element_size, size_t inline_length) {
+
 	linkedlist* ll = NULL;
 
 	if (0 < element_size && element_size <= SIZE_MAX) {
@@ -48,8 +89,20 @@ linkedlist* ll_create(size_t element_size) {
 
 		if (ll) {
 
+			ll->head = NULL;
+			ll->tail = NULL;
+			ll->cursor = NULL;
+			ll->cursor_index = 0;
 			ll->element_size = element_size;
 			ll->element_count = 0;
+			ll->nodes = pool_create_inline(node_get_footprint(element_size), inline_length);
+
+			// Cancel the creation if the nodes can't be allocated
+			if (!ll->nodes) {
+
+				free(ll);
+				ll = NULL;
+			}
 		}
 	}
 	return ll;
@@ -67,8 +120,8 @@ void ll_delete(linkedlist** ll) {
 	// Access the list only if the pointer is valid
 	if (ll && *ll) {
 
-		// Free every node
-		ll_clear(*ll);
+		// Free every node, all at once
+		pool_delete(&(*ll)->nodes);
 
 		// Free the memory used for the whole struct
 		memset(*ll, 0, sizeof(linkedlist));
@@ -90,7 +143,7 @@ void ll_insert_at(linkedlist* ll, void* x, size_t i) {
 		if (i <= ll->element_count) {
 
 			// Create the node
-			node* n = node_create(x, ll->element_size);
+			node* n = node_create_in(ll->nodes, x, ll->element_size);
 
 			// Continue only if the node was created
 			if (n) {
@@ -100,24 +153,23 @@ void ll_insert_at(linkedlist* ll, void* x, size_t i) {
 
 					node_set_next(n, ll->head); // Connect the new node with the old head
 					ll->head = n; // And replace the list's head
+
+					// Every node moved one position forward
+					ll->cursor_index++;
 				}
 
 				// In every other case
 				else {
 
-					node* tmp = ll->head;
-
-					// Iterate to the element before i
-					for (int j = 1; j < i; j++) {
-
-						tmp = node_get_next(tmp);
-					}
+					// Get to the element before i
+					node* tmp = ll_util_walk(ll, i - 1);
 
 					// Connect the node n between the node i-1 and i, becoming the new i -th node
 					node_set_next(n, node_get_next(tmp));
 					node_set_next(tmp, n);
 				}
 
+				if (i == ll->element_count) ll->tail = n;
 				ll->element_count++;
 			}
 		}
@@ -172,27 +224,28 @@ void ll_remove_at(linkedlist* ll, size_t i) {
 
 				// Logical removal, shift the head
 				ll->head = node_get_next(ll->head);
+				if (ll->tail == to_be_deleted) ll->tail = NULL;
+
+				// Every node moved one position back
+				if (ll->cursor == to_be_deleted) ll->cursor = NULL;
+				ll->cursor_index--;
 			}
 
 			// In every other case
 			else {
 
-				node* tmp = ll->head;
-
-				// Iterate to the element before i
-				for (int j = 1; j < i; j++) {
-
-					tmp = node_get_next(tmp);
-				}
+				// Get to the element before i
+				node* tmp = ll_util_walk(ll, i - 1);
 
 				// Logically remove the node first, then physically
 				to_be_deleted = node_get_next(tmp);
 				
 				// Logical removal, connect the node i-1 to i+1
 				node_set_next(tmp, node_get_next(node_get_next(tmp)));
+				if (ll->tail == to_be_deleted) ll->tail = tmp;
 			}
 
-			node_delete(&to_be_deleted);
+			node_delete_in(ll->nodes, &to_be_deleted);
 			ll->element_count--;
 		}
 	}
@@ -227,6 +280,8 @@ void ll_remove_tail(linkedlist* ll) {
 
 /**
  * Returns a pointer to the i -th element of the list
+ *
+ * The list remembers the last position it reached, so accessing the elements in order costs O(1) each
  */
 void* ll_get_at(linkedlist* ll, size_t i) {
 
@@ -238,16 +293,8 @@ void* ll_get_at(linkedlist* ll, size_t i) {
 		// Check if the position is correct
 		if (i < ll->element_count) {
 
-			// Iterate to the i -th node
-			node* tmp = ll->head;
-
-			for (int j = 0; j < i; j++) {
-
-				tmp = node_get_next(tmp);
-			}
-			
 			// Return the value
-			ret = node_get_value(tmp);
+			ret = node_get_value(ll_util_walk(ll, i));
 		}
 	}
 	return ret;
@@ -266,16 +313,8 @@ void ll_get_2_at(linkedlist* ll, size_t i, void* buf) {
 		// Check if the position is correct
 		if (i < ll->element_count) {
 
-			// Iterate to the i -th node
-			node* tmp = ll->head;
-
-			for (int j = 0; j < i; j++) {
-
-				tmp = node_get_next(tmp);
-			}
-
 			// Copy the value
-			memcpy(buf, node_get_value(tmp), ll->element_size);
+			memcpy(buf, node_get_value(ll_util_walk(ll, i)), ll->element_size);
 		}
 	}
 	return;
@@ -335,6 +374,23 @@ size_t ll_get_element_size(linkedlist* ll) {
 	return ll ? ll->element_size : 0;
 }
 
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * With unrolled nodes a node holds more than one element
+ */
+void ll_get_stats(linkedlist* ll, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (ll) pool_add_stats(ll->nodes, stats);
+	}
+	return;
+}
+
 /**
  * Checks if the element pointed to by x is present in the list
  *
@@ -379,15 +435,11 @@ void ll_clear(linkedlist* ll) {
 	// Access the list if the pointer is valid
 	if (ll) {
 
-		node* to_be_deleted = NULL;
-		node* tmp = ll->head;
-		for (int i = 0; i < ll->element_count; i++) {
-
-			to_be_deleted = tmp;
-			tmp = node_get_next(tmp);
-			node_delete(&to_be_deleted);
-		}
+		// Every node comes from the pool, release them all without visiting the list
+		pool_clear(ll->nodes);
 		ll->head = NULL;
+		ll->tail = NULL;
+		ll->cursor = NULL;
 		ll->element_count = 0;
 	}
 }
@@ -422,6 +474,94 @@ void ll_for_each(linkedlist* ll, void (*f)(void*)) {
 	return;
 }
 
+/**
+ * Applies the function f to every element of the linked list ll, using (at most) the given number of threads
+ *
+ * The positions of the elements are collected first, then they're split in chunks
+ * handled by the threads, f gets a copy of the element (like in ll_for_each)
+ * and is called by many threads at the same time, so it must be thread safe
+ */
+void ll_parallel_for_each(linkedlist* ll, void (*f)(void*), size_t threads) {
+
+	if (ll && f && ll->element_count > 0) {
+
+		ll_parallel_task task;
+		task.values = (void**)malloc(ll->element_count * sizeof(void*));
+		task.element_size = ll->element_size;
+		task.f = f;
+
+		if (task.values) {
+
+			// Walking the list can't be split, so the positions of the values are collected first
+			node* tmp = ll->head;
+			for (size_t i = 0; i < ll->element_count; i++, tmp = node_get_next(tmp)) task.values[i] = node_get_value(tmp);
+
+			parallel_util_for(ll->element_count, LL_PARALLEL_GRAIN, threads, ll_util_parallel_for_each, &task);
+			free(task.values);
+		}
+	}
+	return;
+}
+
+/**
+ * Sorts the elements of the list according to the compare function, equal elements keep their order
+ *
+ * Bottom-up merge sort that relinks the existing nodes, so it takes O(n log n) time and no extra memory
+ */
+void ll_sort(linkedlist* ll, int (*compare)(void*, void*)) {
+
+	if (ll && compare && ll->element_count > 1) {
+
+		node* list = ll->head;
+		node* tail = NULL;
+
+		// Every pass merges the pairs of sorted runs of width nodes, each pair becoming a run twice as long
+		for (size_t width = 1; width < ll->element_count; width *= 2) {
+
+			node* p = list;
+			list = NULL;
+			tail = NULL;
+
+			while (p) {
+
+				// The second run starts width nodes after the first one
+				node* q = p;
+				size_t p_size = 0, q_size = width;
+				for (; p_size < width && q; p_size++) q = node_get_next(q);
+
+				while (p_size > 0 || (q_size > 0 && q)) {
+
+					node* e;
+
+					// On ties the node of the first run goes first
+					if (p_size > 0 && (q_size == 0 || !q || compare(node_get_value(p), node_get_value(q)) <= 0)) {
+						e = p;
+						p = node_get_next(p);
+						p_size--;
+					}
+					else {
+						e = q;
+						q = node_get_next(q);
+						q_size--;
+					}
+
+					if (tail) node_set_next(tail, e);
+					else list = e;
+					tail = e;
+				}
+				p = q;
+			}
+			node_set_next(tail, NULL);
+		}
+
+		ll->head = list;
+		ll->tail = tail;
+		ll->cursor = NULL;
+		ll->cursor_index = 0;
+	}
+	return;
+}
+
 /**
  * Returns a linked list obtained by applying
  * the function f to every element of the original list ll
@@ -456,4 +596,163 @@ linkedlist* ll_map(linkedlist* ll, void* (*f)(void*)) {
 		}
 	}
 	return mapped;
-}
\ No newline at end of file
+}
+
+/**
+ * Initializes the iterator so that it starts from the head of the list
+ */
+void ll_iter_begin(linkedlist* ll, ll_iterator* it) {
+
+	if (ll && it) {
+
+		it->list = ll;
+		it->node = ll->head;
+		it->prev = NULL;
+		it->before = NULL;
+		it->offset = 0;
+		it->index = 0;
+		it->removable = false;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool ll_iter_has_next(ll_iterator* it) {
+
+	return it ? it->node != NULL : false;
+}
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* ll_iter_next(ll_iterator* it) {
+
+	void* ret = NULL;
+
+	if (it && it->node) {
+
+		ret = node_get_value((node*)it->node);
+
+		it->before = it->prev;
+		it->prev = it->node;
+		it->node = node_get_next((node*)it->node);
+		it->index++;
+		it->removable = true;
+	}
+	return ret;
+}
+
+/**
+ * Inserts the element pointed to by x before the next element (at the end, if there's none)
+ *
+ * The next element returned is still the one that would have been returned before
+ */
+void ll_iter_insert(ll_iterator* it, void* x) {
+
+	if (it && x) {
+
+		linkedlist* ll = it->list;
+		node* n = node_create_in(ll->nodes, x, ll->element_size);
+
+		if (n) {
+
+			// Connect the node between the last element returned and the next one
+			node_set_next(n, (node*)it->node);
+			if (it->prev) node_set_next((node*)it->prev, n);
+			else ll->head = n;
+			if (!it->node) ll->tail = n;
+
+			it->before = it->prev;
+			it->prev = n;
+			it->index++;
+			it->removable = false;
+			ll->element_count++;
+
+			// The new node is the last one reached
+			ll->cursor = n;
+			ll->cursor_index = it->index - 1;
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the last element returned by ll_iter_next
+ *
+ * It can be done once per element returned, and not after an insertion
+ */
+void ll_iter_remove(ll_iterator* it) {
+
+	if (it && it->removable) {
+
+		linkedlist* ll = it->list;
+		node* to_be_deleted = (node*)it->prev;
+
+		// Connect the node before it with the next one
+		if (it->before) node_set_next((node*)it->before, (node*)it->node);
+		else ll->head = (node*)it->node;
+		if (ll->tail == to_be_deleted) ll->tail = (node*)it->before;
+
+		node_delete_in(ll->nodes, &to_be_deleted);
+		ll->element_count--;
+
+		it->prev = it->before;
+		it->before = NULL;
+		it->index--;
+		it->removable = false;
+
+		// The node before it is the last one reached
+		ll->cursor = (node*)it->prev;
+		ll->cursor_index = it->index - 1;
+	}
+	return;
+}
+
+/* Utility function that returns the i -th node, starting from the last position reached when that's closer */
+node* ll_util_walk(linkedlist* ll, size_t i) {
+
+	node* tmp = ll->head;
+	size_t j = 0;
+
+	// The tail is reached directly, the other nodes from the head or the last node reached (if it's not past them)
+	if (i == ll->element_count - 1) {
+
+		tmp = ll->tail;
+		j = i;
+	}
+	else if (ll->cursor && ll->cursor_index <= i) {
+
+		tmp = ll->cursor;
+		j = ll->cursor_index;
+	}
+
+	for (; j < i; j++) {
+
+		tmp = node_get_next(tmp);
+	}
+
+	ll->cursor = tmp;
+	ll->cursor_index = i;
+	return tmp;
+}
+
+/* Utility function used as the body of ll_parallel_for_each, applies f to a copy of each value of the chunk */
+void ll_util_parallel_for_each(void* context, size_t from, size_t to) {
+
+	ll_parallel_task* task = (ll_parallel_task*)context;
+	void* tmp_buf = malloc(task->element_size);
+
+	if (tmp_buf) {
+		for (size_t i = from; i < to; i++) {
+
+			memcpy(tmp_buf, task->values[i], task->element_size);
+			task->f(tmp_buf);
+		}
+		free(tmp_buf);
+	}
+	return;
+}
+
+#endif
\ No newline at end of file
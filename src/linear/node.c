@@ -7,6 +7,7 @@
  */
 
 #include "../../include/linear/node.h"
+#include <stdint.h>
 #include <string.h>
 
 /**
@@ -17,6 +18,8 @@
  *
  * The node itself has two components, a value stored, and
  * a pointer to the next node in the list
+ *
+ * The value is stored right after the struct, in the same allocation
  */
 typedef struct node {
 
@@ -29,12 +32,6 @@ typedef struct node {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* Pointer to the memory location that stores the node's value
-	  *
-	  * Void* is used to accept any type of data
-	  */
-	void* ptr;
-
 	/* Pointer to the next node 
 	 * (as in next in a list)
 	 */
@@ -49,35 +46,31 @@ typedef struct node {
  */
 node* node_create(void* value, size_t value_size) {
 
+	return node_create_in(NULL, value, value_size);
+}
+
+/**
+ * Creates a node like node_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least node_get_footprint(value_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+node* node_create_in(pool* p, void* value, size_t value_size) {
+
 	node* n = NULL;
 
 	// Check if the size is reasonable
-	if (value_size <= SIZE_MAX) {
+	if (value_size <= SIZE_MAX - sizeof(node)) {
 
-		// Allocate memory for the node struct
-		n = (node*)malloc(sizeof(node));
+		// Allocate memory for the node struct and its value, in one block
+		n = (node*)(p ? pool_alloc(p) : malloc(node_get_footprint(value_size)));
 
 		// If it was allocated
 		if (n) {
 
-			// Allocate memory for the value
-			n->ptr = malloc(value_size);
-
-			// If it was allocated
-			if (n->ptr) {
-
-				// Initialize the fields
-				memcpy(n->ptr, value, value_size);
-				n->next = NULL;
-			}
-
-			// Otherwise
-			else {
-
-				// Cancel the creation, free the memory used for the struct
-				free(n);
-				n = NULL;
-			}
+			// Initialize the fields
+			memcpy(node_get_value(n), value, value_size);
+			n->next = NULL;
 		}
 	}
 
@@ -87,25 +80,41 @@ node* node_create(void* value, size_t value_size) {
 /**
  * Deletes the given node
  *
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ * The value is stored with the struct
+ * so a single free releases both
  */
 void node_delete(node** n) {
 
-	// Check if the ptr fields needs to be freed as well
-	if (n != NULL && *n != NULL) {
+	node_delete_in(NULL, n);
+	return;
+}
 
-		// Free the memory used for the value
-		free((*n)->ptr);
+/**
+ * Deletes the given node, created by node_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void node_delete_in(pool* p, node** n) {
+
+	if (n != NULL && *n != NULL) {
 
-		// Free the memory used for the struct
-		memset(*n, 0, sizeof(node));
-		free(*n);
+		if (p) pool_free(p, *n);
+		else free(*n);
 		*n = NULL;
 	}
 	return;
 }
 
+/**
+ * Returns the number of bytes used by a node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t node_get_footprint(size_t value_size) {
+
+	return sizeof(node) + value_size;
+}
+
 /**
  * Returns a pointer to the value stored in the
  * node
@@ -115,7 +124,7 @@ void node_delete(node** n) {
  */
 void* node_get_value(node* n) {
 
-	return n ? n->ptr : NULL;
+	return n ? (void*)((char*)n + sizeof(node)) : NULL;
 }
 
 /**
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/parallel.h"
+#include "../../include/linear/threadpool.h"
+#include <stdatomic.h>
+
+/**
+ * State shared by the threads of a parallel loop
+ */
+typedef struct parallel_loop {
+
+	parallel_body body;
+	void* context;
+
+	/* Number of indices and of indices in a chunk */
+	size_t n;
+	size_t grain;
+
+	/* Index of the first chunk nobody took yet */
+	atomic_size_t next;
+} parallel_loop;
+
+/* Utility function used by every thread of a loop (the calling one included) to take and run chunks */
+void parallel_util_run(parallel_loop* loop);
+
+/* Utility function used as the body of the tasks that help the calling thread */
+void parallel_util_task(void* arg);
+
+/**
+ * Applies body to every chunk of grain indices from 0 to n (the last one can be shorter),
+ * using at most the given number of threads, and returns when every chunk is done
+ *
+ * The body can be called at the same time on different chunks, so it must only write
+ * data that belongs to its chunk. The chunks are always the same (however many threads
+ * run them), with a single thread (or without the shared pool) they're run in order by
+ * the calling one, which also runs other queued tasks while it waits for the last chunks
+ */
+void parallel_util_for(size_t n, size_t grain, size_t threads, parallel_body body, void* context) {
+
+	if (body && n > 0) {
+
+		if (grain == 0) grain = 1;
+		size_t chunks = n / grain + (n % grain != 0);
+
+		// No point in starting more threads than chunks
+		if (threads > chunks) threads = chunks;
+
+		parallel_loop loop;
+		loop.body = body;
+		loop.context = context;
+		loop.n = n;
+		loop.grain = grain;
+		atomic_init(&loop.next, 0);
+
+		// The chunks are the same however many threads run them
+		threadpool* tp = threads > 1 ? tp_get_shared() : NULL;
+		if (!tp) parallel_util_run(&loop);
+		else {
+
+			// The calling thread is one of the workers, the others are tasks of the shared pool
+			tp_group g;
+			tp_group_init(tp, &g);
+			for (size_t i = 0; i < threads - 1; i++) tp_group_run(&g, parallel_util_task, &loop);
+
+			parallel_util_run(&loop);
+			tp_group_wait(&g);
+		}
+	}
+	return;
+}
+
+/* Utility function used by every thread of a loop (the calling one included) to take and run chunks */
+void parallel_util_run(parallel_loop* loop) {
+
+	size_t from;
+
+	while ((from = atomic_fetch_add_explicit(&loop->next, 1, memory_order_relaxed) * loop->grain) < loop->n) {
+
+		size_t to = (loop->n - from > loop->grain) ? from + loop->grain : loop->n;
+		loop->body(loop->context, from, to);
+	}
+	return;
+}
+
+/* Utility function used as the body of the tasks that help the calling thread */
+void parallel_util_task(void* arg) {
+
+	parallel_util_run((parallel_loop*)arg);
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/pool.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Alignment of every block, enough for pointers, size_t, double and 64 bit integers */
+#define POOL_ALIGNMENT 8
+
+/* Number of blocks of the first chunk, every following chunk doubles up to POOL_MAX_CHUNK_BLOCKS */
+#define POOL_MIN_CHUNK_BLOCKS 16
+#define POOL_MAX_CHUNK_BLOCKS 4096
+
+/* Offset of the inline chunk from the start of the struct */
+#define POOL_INLINE_OFFSET ((sizeof(pool) + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT)
+
+/**
+ * Header of a chunk of memory, the blocks follow it
+ */
+typedef struct pool_chunk {
+
+	/* Next chunk, in allocation order */
+	struct pool_chunk* next;
+
+	/* Number of blocks in this chunk */
+	size_t blocks;
+} pool_chunk;
+
+/* Utility function used to allocate new chunks */
+pool_chunk* pool_util_chunk_create(size_t blocks, size_t block_size);
+
+/* Utility function used to get the inline chunk of a pool, placed right after the struct */
+pool_chunk* pool_util_inline(pool* p);
+
+/**
+ * Struct that represent a pool (slab allocator) of fixed size blocks
+ */
+typedef struct pool {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* First chunk allocated, the others follow it */
+	pool_chunk* first;
+
+	/* Chunk from which never used blocks are taken */
+	pool_chunk* current;
+
+	/* Number of blocks of the current chunk already handed out */
+	size_t used;
+
+	/* Blocks given back, each one stores the pointer to the next in its first bytes */
+	void* free_list;
+
+	/* Size of each block */
+	size_t block_size;
+
+	/* Number of blocks in use */
+	size_t count;
+
+	/* Whether or not the first chunk is the inline one, which is freed along with the pool */
+	bool has_inline;
+
+#ifdef CDS_WITH_STATS
+	/* Blocks handed out and given back, chunks allocated and their bytes */
+	size_t allocations;
+	size_t frees;
+	size_t chunks;
+	size_t bytes;
+#endif
+} pool;
+
+/**
+ * Creates a pool that hands out blocks that are (at least) block_size bytes big
+ *
+ * Every block is aligned to POOL_ALIGNMENT
+ */
+pool* pool_create(size_t block_size) {
+
+	return pool_create_inline(block_size, 0);
+}
+
+/**
+ * Creates a pool whose first chunk, with room for the given number of blocks,
+ * is stored in the same allocation as the pool itself
+ *
+ * Containers that stay that small never reach malloc for their nodes
+ */
+pool* pool_create_inline(size_t block_size, size_t blocks) {
+
+	pool* p = NULL;
+
+	if (0 < block_size && block_size <= SIZE_MAX - POOL_ALIGNMENT) {
+
+		// The block has to be able to hold the free list link
+		if (block_size < sizeof(void*)) block_size = sizeof(void*);
+		block_size = (block_size + POOL_ALIGNMENT - 1) / POOL_ALIGNMENT * POOL_ALIGNMENT;
+
+		if (blocks <= (SIZE_MAX - POOL_INLINE_OFFSET - sizeof(pool_chunk)) / block_size) {
+
+			p = (pool*)malloc(blocks > 0 ? POOL_INLINE_OFFSET + sizeof(pool_chunk) + blocks * block_size : sizeof(pool));
+		}
+		if (p) {
+
+			p->block_size = block_size;
+			p->first = NULL;
+			p->current = NULL;
+			p->used = 0;
+			p->free_list = NULL;
+			p->count = 0;
+			p->has_inline = blocks > 0;
+
+			// The inline chunk is the first one, the others get allocated after it
+			if (p->has_inline) {
+
+				p->first = pool_util_inline(p);
+				p->first->next = NULL;
+				p->first->blocks = blocks;
+			}
+#ifdef CDS_WITH_STATS
+			p->allocations = 0;
+			p->frees = 0;
+			p->chunks = 0;
+			p->bytes = 0;
+#endif
+		}
+	}
+	return p;
+}
+
+/**
+ * Deletes the given pool, every chunk is freed
+ * so every block still in use becomes invalid
+ */
+void pool_delete(pool** p) {
+
+	if (p && *p) {
+
+		pool_chunk* chunk = (*p)->first;
+		while (chunk) {
+
+			pool_chunk* next = chunk->next;
+			if (chunk != pool_util_inline(*p)) free(chunk);
+			chunk = next;
+		}
+
+		memset(*p, 0, sizeof(pool));
+		free(*p);
+		*p = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns a block of memory, NULL if it couldn't be allocated
+ */
+void* pool_alloc(pool* p) {
+
+	void* block = NULL;
+
+	if (p) {
+
+		// Reuse a freed block first
+		if (p->free_list) {
+
+			block = p->free_list;
+			memcpy(&p->free_list, block, sizeof(void*));
+		}
+		else {
+
+			// The current chunk is exhausted, move to the next one (kept by pool_clear) or allocate it
+			if (!p->current || p->used == p->current->blocks) {
+
+				pool_chunk* next = p->current ? p->current->next : p->first;
+				if (!next) {
+
+					size_t blocks = p->current ? p->current->blocks * 2 : POOL_MIN_CHUNK_BLOCKS;
+					if (blocks < POOL_MIN_CHUNK_BLOCKS) blocks = POOL_MIN_CHUNK_BLOCKS;
+					if (blocks > POOL_MAX_CHUNK_BLOCKS) blocks = POOL_MAX_CHUNK_BLOCKS;
+
+					next = pool_util_chunk_create(blocks, p->block_size);
+					if (next) {
+
+						STATS_INC(p->chunks);
+						STATS_ADD(p->bytes, sizeof(pool_chunk) + blocks * p->block_size);
+
+						if (p->current) p->current->next = next;
+						else p->first = next;
+					}
+				}
+				if (next) {
+
+					p->current = next;
+					p->used = 0;
+				}
+			}
+
+			if (p->current && p->used < p->current->blocks) {
+
+				block = (char*)p->current + sizeof(pool_chunk) + p->used * p->block_size;
+				p->used++;
+			}
+		}
+
+		if (block) {
+
+			p->count++;
+			STATS_INC(p->allocations);
+		}
+	}
+	return block;
+}
+
+/**
+ * Gives the block back to the pool, to be reused by later allocations
+ *
+ * The block must have been returned by pool_alloc on the same pool
+ */
+void pool_free(pool* p, void* block) {
+
+	if (p && block) {
+
+		memcpy(block, &p->free_list, sizeof(void*));
+		p->free_list = block;
+		p->count--;
+		STATS_INC(p->frees);
+	}
+	return;
+}
+
+/**
+ * Releases every block at once, the chunks are kept to be reused
+ * so the cost depends only on the number of chunks
+ */
+void pool_clear(pool* p) {
+
+	if (p) {
+
+		STATS_ADD(p->frees, p->count);
+		p->current = p->first;
+		p->used = 0;
+		p->free_list = NULL;
+		p->count = 0;
+	}
+	return;
+}
+
+/**
+ * Returns the size of the blocks, after alignment
+ */
+size_t pool_get_block_size(pool* p) {
+
+	return p ? p->block_size : 0;
+}
+
+/**
+ * Returns the number of blocks currently in use
+ */
+size_t pool_get_count(pool* p) {
+
+	return p ? p->count : 0;
+}
+
+/**
+ * Adds the counters of the pool to stats, so that a container can sum the ones of all its pools
+ *
+ * Blocks released by pool_clear count as given back
+ */
+void pool_add_stats(pool* p, node_stats* stats) {
+
+	if (p && stats) {
+
+#ifdef CDS_WITH_STATS
+		stats->allocations += p->allocations;
+		stats->frees += p->frees;
+		stats->chunks += p->chunks;
+		stats->bytes += p->bytes;
+#endif
+		stats->live += p->count;
+		stats->enabled = STATS_ENABLED;
+	}
+	return;
+}
+
+/* Utility function that allocates a chunk with room for the given number of blocks */
+pool_chunk* pool_util_chunk_create(size_t blocks, size_t block_size) {
+
+	pool_chunk* chunk = NULL;
+
+	if (blocks <= (SIZE_MAX - sizeof(pool_chunk)) / block_size) {
+
+		chunk = (pool_chunk*)malloc(sizeof(pool_chunk) + blocks * block_size);
+		if (chunk) {
+
+			chunk->next = NULL;
+			chunk->blocks = blocks;
+		}
+	}
+	return chunk;
+}
+
+/* Utility function used to get the inline chunk of a pool, placed right after the struct */
+pool_chunk* pool_util_inline(pool* p) {
+
+	return p->has_inline ? (pool_chunk*)((char*)p + POOL_INLINE_OFFSET) : NULL;
+}
\ No newline at end of file
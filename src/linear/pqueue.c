@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/pqueue.h"
+#include "../../include/linear/vector.h"
+#include <string.h>
+
+/* Initial capacity of the vectors holding the heap and the positions of the handles */
+#define PQ_MIN_CAPACITY 16
+
+/* Position of the handles whose element isn't in the queue */
+#define PQ_NOT_PRESENT SIZE_MAX
+
+/* Slots are padded to a multiple of this, so that the handle and the element are aligned */
+#define PQ_SLOT_ALIGNMENT 8
+
+/* Utility functions that return the slot at the given position of the heap, and the element and handle stored in a slot */
+char* pq_util_slot(pqueue* pq, size_t position);
+void* pq_util_element(char* slot);
+size_t pq_util_handle(char* slot);
+
+/* Utility functions that move the slot at the given position up (or down) until the heap is ordered again */
+void pq_util_sift_up(pqueue* pq, size_t position);
+void pq_util_sift_down(pqueue* pq, size_t position);
+
+/* Utility function that moves the slot at the given position up or down, whichever it needs */
+void pq_util_fix(pqueue* pq, size_t position);
+
+/* Utility function that removes the slot at the given position */
+void pq_util_remove_at(pqueue* pq, size_t position);
+
+/* Utility function that returns a handle that's not in use (PQ_NO_HANDLE if there's no memory for it) */
+size_t pq_util_new_handle(pqueue* pq);
+
+/**
+ * Struct that represent a priority queue of elements of generic type
+ */
+typedef struct pqueue {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* The d-ary tree layed out in a vector, the children of position i are at d * i + 1 ... d * i + d,
+	 * each slot holds the handle of the element followed by the element itself
+	 */
+	vector* slots;
+
+	/* Position in the heap of the element of every handle (PQ_NOT_PRESENT if the handle isn't in use) */
+	vector* positions;
+
+	/* Handles that aren't in use anymore, given to the next elements */
+	vector* free_handles;
+
+	/* Slot kept aside while sifting, the others move into its place */
+	char* scratch;
+
+	/* Size of the elements, and of the slots (handle + element + padding) */
+	size_t element_size;
+	size_t slot_size;
+
+	/* Number of children of every node */
+	size_t arity;
+
+	/* Function used to compare the elements */
+	int (*compare)(void*, void*);
+} pqueue;
+
+/**
+ * Creates a priority queue that stores elements that are as big as element_size,
+ * ordered by the compare function, in a heap where every node has arity (2 or 4) children
+ */
+pqueue* pq_create(size_t element_size, int (*compare)(void*, void*), size_t arity) {
+
+	pqueue* pq = NULL;
+
+	if (0 < element_size && element_size <= SIZE_MAX - sizeof(size_t) - PQ_SLOT_ALIGNMENT && compare && (arity == 2 || arity == 4)) {
+
+		pq = (pqueue*)malloc(sizeof(pqueue));
+		if (pq) {
+
+			pq->slot_size = (sizeof(size_t) + element_size + PQ_SLOT_ALIGNMENT - 1) / PQ_SLOT_ALIGNMENT * PQ_SLOT_ALIGNMENT;
+			pq->slots = vec_create(PQ_MIN_CAPACITY, pq->slot_size);
+			pq->positions = vec_create(PQ_MIN_CAPACITY, sizeof(size_t));
+			pq->free_handles = vec_create(PQ_MIN_CAPACITY, sizeof(size_t));
+			pq->scratch = (char*)malloc(pq->slot_size);
+
+			if (pq->slots && pq->positions && pq->free_handles && pq->scratch) {
+
+				pq->element_size = element_size;
+				pq->arity = arity;
+				pq->compare = compare;
+			}
+			else {
+
+				vec_delete(&pq->slots);
+				vec_delete(&pq->positions);
+				vec_delete(&pq->free_handles);
+				free(pq->scratch);
+				free(pq);
+				pq = NULL;
+			}
+		}
+	}
+	return pq;
+}
+
+/**
+ * Deletes the given priority queue
+ */
+void pq_delete(pqueue** pq) {
+
+	if (pq && *pq) {
+
+		vec_delete(&(*pq)->slots);
+		vec_delete(&(*pq)->positions);
+		vec_delete(&(*pq)->free_handles);
+		free((*pq)->scratch);
+		memset(*pq, 0, sizeof(pqueue));
+		free(*pq);
+		*pq = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a copy of the element pointed to by x, and returns its handle (PQ_NO_HANDLE if it couldn't be inserted)
+ */
+size_t pq_push(pqueue* pq, void* x) {
+
+	size_t handle = PQ_NO_HANDLE;
+
+	if (pq && x) {
+
+		size_t length = vec_get_length(pq->slots);
+		handle = pq_util_new_handle(pq);
+
+		if (handle != PQ_NO_HANDLE) {
+
+			memcpy(pq->scratch, &handle, sizeof(size_t));
+			memcpy(pq_util_element(pq->scratch), x, pq->element_size);
+			vec_push_back(pq->slots, pq->scratch);
+
+			if (vec_get_length(pq->slots) > length) pq_util_sift_up(pq, length);
+			else {
+
+				vec_push_back(pq->free_handles, &handle);
+				handle = PQ_NO_HANDLE;
+			}
+		}
+	}
+	return handle;
+}
+
+/**
+ * Inserts the n elements (that are contiguous) pointed to by elements at once, and builds
+ * the heap again bottom-up, which takes O(n + size) time instead of O(n log(n + size))
+ *
+ * If handles isn't NULL the handle of each element is stored in it
+ */
+void pq_build(pqueue* pq, void* elements, size_t n, size_t* handles) {
+
+	if (pq && elements && n > 0) {
+
+		vec_reserve(pq->slots, vec_get_length(pq->slots) + n);
+
+		for (size_t i = 0; i < n; i++) {
+
+			size_t length = vec_get_length(pq->slots);
+			size_t handle = pq_util_new_handle(pq);
+
+			if (handle != PQ_NO_HANDLE) {
+
+				memcpy(pq->scratch, &handle, sizeof(size_t));
+				memcpy(pq_util_element(pq->scratch), (char*)elements + i * pq->element_size, pq->element_size);
+				vec_push_back(pq->slots, pq->scratch);
+
+				if (vec_get_length(pq->slots) > length) vec_insert_at(pq->positions, &length, handle);
+				else {
+
+					vec_push_back(pq->free_handles, &handle);
+					handle = PQ_NO_HANDLE;
+				}
+			}
+			if (handles) handles[i] = handle;
+		}
+
+		// Floyd's heapify, every node that has children is sifted down, from the last one to the root
+		size_t length = vec_get_length(pq->slots);
+		for (size_t i = length > 1 ? (length - 2) / pq->arity + 1 : 0; i > 0; i--) pq_util_sift_down(pq, i - 1);
+	}
+	return;
+}
+
+/**
+ * Removes the first element
+ */
+void pq_pop(pqueue* pq) {
+
+	if (pq && vec_get_length(pq->slots) > 0) pq_util_remove_at(pq, 0);
+	return;
+}
+
+/**
+ * Removes the first element and copies it in the given buffer
+ */
+void pq_pop_2(pqueue* pq, void* buf) {
+
+	if (pq && buf && vec_get_length(pq->slots) > 0) {
+
+		memcpy(buf, pq_util_element(pq_util_slot(pq, 0)), pq->element_size);
+		pq_util_remove_at(pq, 0);
+	}
+	return;
+}
+
+/**
+ * Returns a pointer to the first element, NULL if the queue is empty
+ *
+ * The element must not be modified in a way that changes its order (see pq_update)
+ */
+void* pq_peek(pqueue* pq) {
+
+	return (pq && vec_get_length(pq->slots) > 0) ? pq_util_element(pq_util_slot(pq, 0)) : NULL;
+}
+
+/**
+ * Returns the handle of the first element, PQ_NO_HANDLE if the queue is empty
+ */
+size_t pq_peek_handle(pqueue* pq) {
+
+	return (pq && vec_get_length(pq->slots) > 0) ? pq_util_handle(pq_util_slot(pq, 0)) : PQ_NO_HANDLE;
+}
+
+/**
+ * Replaces the element with the given handle with the one pointed to by x, only if x comes before it
+ *
+ * Returns whether or not the element was replaced
+ */
+bool pq_decrease_key(pqueue* pq, size_t handle, void* x) {
+
+	bool decreased = false;
+	void* current = pq_get(pq, handle);
+
+	if (current && x && pq->compare(x, current) < 0) {
+
+		memcpy(current, x, pq->element_size);
+		pq_util_sift_up(pq, *(size_t*)vec_get_at(pq->positions, handle));
+		decreased = true;
+	}
+	return decreased;
+}
+
+/**
+ * Replaces the element with the given handle with the one pointed to by x, whatever their order
+ */
+void pq_update(pqueue* pq, size_t handle, void* x) {
+
+	void* current = pq_get(pq, handle);
+
+	if (current && x) {
+
+		memcpy(current, x, pq->element_size);
+		pq_util_fix(pq, *(size_t*)vec_get_at(pq->positions, handle));
+	}
+	return;
+}
+
+/**
+ * Removes the element with the given handle
+ */
+void pq_remove(pqueue* pq, size_t handle) {
+
+	if (pq_contains(pq, handle)) pq_util_remove_at(pq, *(size_t*)vec_get_at(pq->positions, handle));
+	return;
+}
+
+/**
+ * Returns a pointer to the element with the given handle, NULL if it's not in the queue
+ */
+void* pq_get(pqueue* pq, size_t handle) {
+
+	return pq_contains(pq, handle) ? pq_util_element(pq_util_slot(pq, *(size_t*)vec_get_at(pq->positions, handle))) : NULL;
+}
+
+/**
+ * Checks whether or not the element with the given handle is in the queue
+ *
+ * Handles of elements that left the queue are given to new elements
+ */
+bool pq_contains(pqueue* pq, size_t handle) {
+
+	return pq && handle < vec_get_length(pq->positions) && *(size_t*)vec_get_at(pq->positions, handle) != PQ_NOT_PRESENT;
+}
+
+/**
+ * Returns the number of elements in the queue
+ */
+size_t pq_get_size(pqueue* pq) {
+
+	return pq ? vec_get_length(pq->slots) : 0;
+}
+
+/**
+ * Checks whether or not the queue is empty
+ */
+bool pq_is_empty(pqueue* pq) {
+
+	return pq_get_size(pq) == 0;
+}
+
+/**
+ * Returns the size of the elements stored in the queue
+ */
+size_t pq_get_element_size(pqueue* pq) {
+
+	return pq ? pq->element_size : 0;
+}
+
+/**
+ * Returns the number of children of every node of the heap
+ */
+size_t pq_get_arity(pqueue* pq) {
+
+	return pq ? pq->arity : 0;
+}
+
+/**
+ * Removes every element, the memory is kept
+ */
+void pq_clear(pqueue* pq) {
+
+	if (pq) {
+
+		vec_resize(pq->slots, 0);
+		vec_resize(pq->positions, 0);
+		vec_resize(pq->free_handles, 0);
+	}
+	return;
+}
+
+/* Utility function that returns the slot at the given position of the heap */
+char* pq_util_slot(pqueue* pq, size_t position) {
+
+	return (char*)vec_get_at(pq->slots, position);
+}
+
+/* Utility function that returns the element stored in a slot */
+void* pq_util_element(char* slot) {
+
+	return slot + sizeof(size_t);
+}
+
+/* Utility function that returns the handle stored in a slot */
+size_t pq_util_handle(char* slot) {
+
+	size_t handle;
+	memcpy(&handle, slot, sizeof(size_t));
+	return handle;
+}
+
+/**
+ * Moves the slot at the given position up until its parent comes before it
+ *
+ * The slot is kept aside and the parents move down into the hole, so every level costs one copy
+ */
+void pq_util_sift_up(pqueue* pq, size_t position) {
+
+	char* base = pq_util_slot(pq, 0);
+	size_t* positions = (size_t*)vec_get_at(pq->positions, 0);
+	size_t size = pq->slot_size;
+
+	memcpy(pq->scratch, base + position * size, size);
+
+	while (position > 0) {
+
+		size_t parent = (position - 1) / pq->arity;
+		char* up = base + parent * size;
+
+		if (pq->compare(pq_util_element(pq->scratch), pq_util_element(up)) >= 0) break;
+
+		memcpy(base + position * size, up, size);
+		positions[pq_util_handle(up)] = position;
+		position = parent;
+	}
+
+	memcpy(base + position * size, pq->scratch, size);
+	positions[pq_util_handle(pq->scratch)] = position;
+	return;
+}
+
+/**
+ * Moves the slot at the given position down until every child comes after it
+ *
+ * The slot is kept aside and the first child moves up into the hole, so every level costs one copy
+ */
+void pq_util_sift_down(pqueue* pq, size_t position) {
+
+	char* base = pq_util_slot(pq, 0);
+	size_t* positions = (size_t*)vec_get_at(pq->positions, 0);
+	size_t size = pq->slot_size;
+	size_t length = vec_get_length(pq->slots);
+
+	memcpy(pq->scratch, base + position * size, size);
+
+	while (position < length) {
+
+		size_t first = position * pq->arity + 1;
+		if (first >= length) break;
+
+		// The child that comes first among the (at most arity) children
+		size_t last = first + pq->arity < length ? first + pq->arity : length;
+		size_t best = first;
+		for (size_t child = first + 1; child < last; child++) {
+
+			if (pq->compare(pq_util_element(base + child * size), pq_util_element(base + best * size)) < 0) best = child;
+		}
+
+		char* down = base + best * size;
+		if (pq->compare(pq_util_element(down), pq_util_element(pq->scratch)) >= 0) break;
+
+		memcpy(base + position * size, down, size);
+		positions[pq_util_handle(down)] = position;
+		position = best;
+	}
+
+	memcpy(base + position * size, pq->scratch, size);
+	positions[pq_util_handle(pq->scratch)] = position;
+	return;
+}
+
+/* Utility function that moves the slot at the given position up or down, whichever it needs */
+void pq_util_fix(pqueue* pq, size_t position) {
+
+	if (position > 0 && pq->compare(pq_util_element(pq_util_slot(pq, position)), pq_util_element(pq_util_slot(pq, (position - 1) / pq->arity))) < 0) {
+
+		pq_util_sift_up(pq, position);
+	}
+	else pq_util_sift_down(pq, position);
+	return;
+}
+
+/**
+ * Removes the slot at the given position: the last slot takes its place, and moves up or down from there
+ */
+void pq_util_remove_at(pqueue* pq, size_t position) {
+
+	size_t handle = pq_util_handle(pq_util_slot(pq, position));
+	size_t not_present = PQ_NOT_PRESENT;
+	size_t last = vec_get_length(pq->slots) - 1;
+
+	vec_insert_at(pq->positions, &not_present, handle);
+	vec_push_back(pq->free_handles, &handle);
+
+	if (position != last) {
+
+		memcpy(pq_util_slot(pq, position), pq_util_slot(pq, last), pq->slot_size);
+		vec_pop_back(pq->slots);
+		pq_util_fix(pq, position);
+	}
+	else vec_pop_back(pq->slots);
+	return;
+}
+
+/* Utility function that returns a handle that's not in use (PQ_NO_HANDLE if there's no memory for it) */
+size_t pq_util_new_handle(pqueue* pq) {
+
+	size_t handle = PQ_NO_HANDLE;
+
+	if (vec_get_length(pq->free_handles) > 0) vec_pop_2_back(pq->free_handles, &handle);
+	else {
+
+		size_t length = vec_get_length(pq->positions);
+		size_t not_present = PQ_NOT_PRESENT;
+
+		vec_push_back(pq->positions, &not_present);
+		if (vec_get_length(pq->positions) > length) handle = length;
+	}
+	return handle;
+}
\ No newline at end of file
@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/pvector.h"
+#include <stdint.h>
+#include <string.h>
+
+/* log2 of the number of children of each node (and of elements of each leaf) */
+#define PVEC_BITS 5
+#define PVEC_WIDTH ((size_t)1 << PVEC_BITS)
+#define PVEC_MASK (PVEC_WIDTH - 1)
+
+/* Alignment of what follows the node header */
+#define PVEC_NODE_ALIGNMENT 8
+
+/* Size of the node header, the children (or the elements of a leaf) follow it */
+#define PVEC_NODE_HEADER ((sizeof(pvec_node) + PVEC_NODE_ALIGNMENT - 1) / PVEC_NODE_ALIGNMENT * PVEC_NODE_ALIGNMENT)
+
+/**
+ * Node of the trie, shared by every version that reaches it, it never changes once it's built
+ *
+ * The header is followed by PVEC_WIDTH children in the inner nodes and by PVEC_WIDTH elements
+ * in the leaves, whether a node is a leaf depends on its level (shift 0)
+ */
+typedef struct pvec_node {
+
+	/* Number of parents (of any version) and roots pointing to the node */
+	atomic_size_t refs;
+} pvec_node;
+
+/* Utility functions used to manage the nodes, inputs marked 'owned' are references the function takes over */
+pvec_node* pvec_util_node(pvector* pv, size_t shift, pvec_node* copy, bool* ok);
+pvec_node** pvec_util_children(pvec_node* n);
+void* pvec_util_element(pvector* pv, pvec_node* leaf, size_t i);
+void pvec_util_release(pvec_node* n, size_t shift);
+pvec_node* pvec_util_leaf(pvector* pv, size_t i);
+pvec_node* pvec_util_set(pvector* pv, pvec_node* n, size_t shift, size_t i, void* x, bool* ok);
+pvec_node* pvec_util_pop(pvector* pv, pvec_node* n, size_t shift, size_t i, bool* ok);
+pvector* pvec_util_version(pvector* pv, pvec_node* root, size_t shift, size_t length);
+void pvec_util_destroy(void* pv);
+
+ /**
+  * Struct that represent a version of a persistent vector
+  */
+typedef struct pvector {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* References to this version, it has to be the first field (see vcell) */
+	vcell_version header;
+
+	/* Root of the trie, NULL if the vector is empty */
+	pvec_node* root;
+
+	/* Level of the root, as the shift of the index bits that select its child (0 if it's a leaf) */
+	size_t shift;
+
+	/* Number of elements */
+	size_t length;
+
+	/* Size of each element */
+	size_t element_size;
+} pvector;
+
+/**
+ * Creates an empty vector storing elements that are as big as element_size
+ */
+pvector* pvec_create(size_t element_size) {
+
+	pvector* pv = NULL;
+
+	if (0 < element_size && element_size <= (SIZE_MAX - PVEC_NODE_HEADER) / PVEC_WIDTH) {
+
+		pv = (pvector*)malloc(sizeof(pvector));
+		if (pv) {
+
+			atomic_init(&pv->header.refs, 1);
+			pv->header.destroy = pvec_util_destroy;
+			pv->root = NULL;
+			pv->shift = 0;
+			pv->length = 0;
+			pv->element_size = element_size;
+		}
+	}
+	return pv;
+}
+
+/**
+ * Releases the given version, the nodes that no other version uses are freed
+ */
+void pvec_delete(pvector** pv) {
+
+	if (pv && *pv) {
+
+		vcell_release(*pv);
+		*pv = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns another reference to the same version, that has to be deleted on its own
+ */
+pvector* pvec_retain(pvector* pv) {
+
+	return (pvector*)vcell_retain(pv);
+}
+
+/**
+ * Returns a new version with x appended after the last element
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_push_back(pvector* pv, void* x) {
+
+	pvector* res = NULL;
+
+	if (pv && x && pv->length < SIZE_MAX) {
+
+		bool ok = true;
+		pvec_node* root = NULL;
+		size_t shift = pv->shift;
+
+		// The trie is full, it gets a new root whose first child is the old one
+		if (pv->root && (pv->length >> (pv->shift + PVEC_BITS)) > 0) {
+
+			shift += PVEC_BITS;
+			root = pvec_util_node(pv, shift, NULL, &ok);
+			if (root) {
+
+				atomic_fetch_add_explicit(&pv->root->refs, 1, memory_order_relaxed);
+				pvec_util_children(root)[0] = pv->root;
+				pvec_util_children(root)[1] = pvec_util_set(pv, NULL, shift - PVEC_BITS, pv->length, x, &ok);
+			}
+		}
+		else root = pvec_util_set(pv, pv->root, shift, pv->length, x, &ok);
+
+		if (ok) res = pvec_util_version(pv, root, shift, pv->length + 1);
+		else pvec_util_release(root, shift);
+	}
+	return res;
+}
+
+/**
+ * Returns a new version without the last element (another reference to the same version if it is empty)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_pop_back(pvector* pv) {
+
+	pvector* res = NULL;
+
+	if (pv && pv->length == 0) res = pvec_retain(pv);
+	else if (pv && pv->length == 1) res = pvec_util_version(pv, NULL, 0, 0);
+	else if (pv) {
+
+		bool ok = true;
+		size_t length = pv->length - 1;
+		size_t shift = pv->shift;
+		pvec_node* root = pvec_util_pop(pv, pv->root, shift, length, &ok);
+
+		// While only the first child of the root is used, it becomes the root
+		while (ok && shift > 0 && ((length - 1) >> shift) == 0) {
+
+			pvec_node* child = pvec_util_children(root)[0];
+
+			atomic_fetch_add_explicit(&child->refs, 1, memory_order_relaxed);
+			pvec_util_release(root, shift);
+			root = child;
+			shift -= PVEC_BITS;
+		}
+
+		if (ok) res = pvec_util_version(pv, root, shift, length);
+	}
+	return res;
+}
+
+/**
+ * Returns a new version in which the i -th element is x (another reference to the same version if i is out of bounds)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+pvector* pvec_set_at(pvector* pv, void* x, size_t i) {
+
+	pvector* res = NULL;
+
+	if (pv && x && i < pv->length) {
+
+		bool ok = true;
+		pvec_node* root = pvec_util_set(pv, pv->root, pv->shift, i, x, &ok);
+
+		if (ok) res = pvec_util_version(pv, root, pv->shift, pv->length);
+	}
+	else if (pv && x) res = pvec_retain(pv);
+
+	return res;
+}
+
+/**
+ * Returns a pointer to the i -th element (NULL if i is out of bounds)
+ *
+ * The element is valid as long as the version is, and must not be written
+ */
+void* pvec_get_at(pvector* pv, size_t i) {
+
+	return pv && i < pv->length ? pvec_util_element(pv, pvec_util_leaf(pv, i), i) : NULL;
+}
+
+/**
+ * Copies the i -th element in buf, if i is within bounds
+ */
+void pvec_get_2_at(pvector* pv, size_t i, void* buf) {
+
+	void* element = pvec_get_at(pv, i);
+
+	if (element && buf) memcpy(buf, element, pv->element_size);
+	return;
+}
+
+/**
+ * Applies f to every element, in order, the elements must not be written
+ */
+void pvec_for_each(pvector* pv, void (*f)(void*)) {
+
+	if (pv && f) {
+
+		// The leaf is looked up once for all of its elements
+		for (size_t i = 0; i < pv->length;) {
+
+			pvec_node* leaf = pvec_util_leaf(pv, i);
+			for (size_t j = i & PVEC_MASK; j < PVEC_WIDTH && i < pv->length; j++, i++) f(pvec_util_element(pv, leaf, j));
+		}
+	}
+	return;
+}
+
+/**
+ * Returns the number of elements of this version
+ */
+size_t pvec_get_length(pvector* pv) {
+
+	return pv ? pv->length : 0;
+}
+
+/**
+ * Returns the size of the elements stored in the vector
+ */
+size_t pvec_get_element_size(pvector* pv) {
+
+	return pv ? pv->element_size : 0;
+}
+
+/**
+ * Checks whether or not this version is empty
+ */
+bool pvec_is_empty(pvector* pv) {
+
+	return pv ? pv->length == 0 : false;
+}
+
+/* Utility function that builds a node of the given level, a copy of the given one (whose children get one more reference) or an empty one */
+pvec_node* pvec_util_node(pvector* pv, size_t shift, pvec_node* copy, bool* ok) {
+
+	size_t payload = shift > 0 ? PVEC_WIDTH * sizeof(pvec_node*) : PVEC_WIDTH * pv->element_size;
+	pvec_node* n = *ok ? (pvec_node*)malloc(PVEC_NODE_HEADER + payload) : NULL;
+
+	if (n) {
+
+		atomic_init(&n->refs, 1);
+
+		if (!copy) memset(pvec_util_children(n), 0, payload);
+		else {
+
+			memcpy(pvec_util_children(n), pvec_util_children(copy), payload);
+			for (size_t i = 0; shift > 0 && i < PVEC_WIDTH; i++) {
+
+				pvec_node* child = pvec_util_children(n)[i];
+				if (child) atomic_fetch_add_explicit(&child->refs, 1, memory_order_relaxed);
+			}
+		}
+	}
+	else *ok = false;
+
+	return n;
+}
+
+/* Utility function that returns the children of an inner node (the elements of a leaf start at the same address) */
+pvec_node** pvec_util_children(pvec_node* n) {
+
+	return (pvec_node**)((char*)n + PVEC_NODE_HEADER);
+}
+
+/* Utility function that returns the element of a leaf that holds the i -th element of the vector */
+void* pvec_util_element(pvector* pv, pvec_node* leaf, size_t i) {
+
+	return (char*)pvec_util_children(leaf) + (i & PVEC_MASK) * pv->element_size;
+}
+
+/* Utility function that releases a reference to a node of the given level, freeing it (and releasing its children) if it was the last one */
+void pvec_util_release(pvec_node* n, size_t shift) {
+
+	if (n && atomic_fetch_sub_explicit(&n->refs, 1, memory_order_acq_rel) == 1) {
+
+		for (size_t i = 0; shift > 0 && i < PVEC_WIDTH; i++) pvec_util_release(pvec_util_children(n)[i], shift - PVEC_BITS);
+		free(n);
+	}
+	return;
+}
+
+/* Utility function that returns the leaf holding the i -th element (which has to be there) */
+pvec_node* pvec_util_leaf(pvector* pv, size_t i) {
+
+	pvec_node* n = pv->root;
+
+	for (size_t shift = pv->shift; shift > 0; shift -= PVEC_BITS) n = pvec_util_children(n)[(i >> shift) & PVEC_MASK];
+	return n;
+}
+
+/* Utility function that returns the (owned) copy of the subtree n, that is only read (NULL makes a new one), with x in position i */
+pvec_node* pvec_util_set(pvector* pv, pvec_node* n, size_t shift, size_t i, void* x, bool* ok) {
+
+	pvec_node* res = pvec_util_node(pv, shift, n, ok);
+
+	if (res && shift == 0) memcpy(pvec_util_element(pv, res, i), x, pv->element_size);
+	else if (res) {
+
+		// The copy retained the old child too, the new one takes its place
+		pvec_node** child = &pvec_util_children(res)[(i >> shift) & PVEC_MASK];
+		pvec_node* old = *child;
+
+		*child = pvec_util_set(pv, old, shift - PVEC_BITS, i, x, ok);
+		pvec_util_release(old, shift - PVEC_BITS);
+
+		if (!*ok) {
+
+			pvec_util_release(res, shift);
+			res = NULL;
+		}
+	}
+	return res;
+}
+
+/* Utility function that returns the (owned) copy of the subtree n, that is only read, without the elements from position i on (NULL if none is left) */
+pvec_node* pvec_util_pop(pvector* pv, pvec_node* n, size_t shift, size_t i, bool* ok) {
+
+	pvec_node* res = NULL;
+
+	// Leaves are shared as they are, the length of the version hides the element left there
+	if (shift == 0) {
+
+		if ((i & PVEC_MASK) > 0) {
+
+			atomic_fetch_add_explicit(&n->refs, 1, memory_order_relaxed);
+			res = n;
+		}
+	}
+	else {
+
+		size_t index = (i >> shift) & PVEC_MASK;
+		pvec_node* child = pvec_util_pop(pv, pvec_util_children(n)[index], shift - PVEC_BITS, i, ok);
+
+		// An emptied first child empties this node as well
+		if (*ok && (child || index > 0)) {
+
+			res = pvec_util_node(pv, shift, n, ok);
+			if (res) {
+
+				pvec_util_release(pvec_util_children(res)[index], shift - PVEC_BITS);
+				pvec_util_children(res)[index] = child;
+			}
+			else pvec_util_release(child, shift - PVEC_BITS);
+		}
+	}
+	return res;
+}
+
+/* Utility function that creates a version like pv with the given (owned) root, NULL if there's not enough memory */
+pvector* pvec_util_version(pvector* pv, pvec_node* root, size_t shift, size_t length) {
+
+	pvector* res = pvec_create(pv->element_size);
+
+	if (res) {
+
+		res->root = root;
+		res->shift = shift;
+		res->length = length;
+	}
+	else pvec_util_release(root, shift);
+
+	return res;
+}
+
+/* Utility function used as the destroy function of the versions */
+void pvec_util_destroy(void* pv) {
+
+	pvec_util_release(((pvector*)pv)->root, ((pvector*)pv)->shift);
+	memset(pv, 0, sizeof(pvector));
+	free(pv);
+	return;
+}
\ No newline at end of file
@@ -7,8 +7,9 @@
  */
 
 #include "../../include/linear/queue.h"
-#include "../../include/linear/clinkedlist.h"
+#include "../../include/linear/chunkedarray.h"
 #include <string.h>
+#include <stdint.h>
 
  /**
   * Struct that represent a queue that can store
@@ -28,10 +29,11 @@ typedef struct queue {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* Pointer to the actual list that implements the queue, the head of the list is the
-	  * queue's tail (so we can both operate on the tail and head with O(1) ) 
+	 /* Pointer to the chunked array that implements the queue, elements are enqueued at its back
+	  * and dequeued from its front (blocks are reused, so the queue doesn't reach the allocator
+	  * once it reached its size)
 	  */
-	clinkedlist* tail;
+	chunkedarray* tail;
 } queue;
 
 /**
@@ -47,12 +49,12 @@ queue* queue_create(size_t element_size) {
 		// Create the struct
 		q = (queue*)malloc(sizeof(queue));
 
-		// If it was created, create the actual list (queue)
+		// If it was created, create the actual chunked array (queue)
 		if (q) {
 
-			q->tail = cl_create(element_size);
+			q->tail = ca_create(element_size);
 
-			// If the list was not created, cancel the creation
+			// If the chunked array was not created, cancel the creation
 			if (!q->tail) {
 				free(q);
 				q = NULL;
@@ -74,7 +76,7 @@ void queue_delete(queue** q) {
 	if (q && *q) {
 
 		// Delete the struct holding the elements, this will delete each element as well
-		cl_delete(&((*q)->tail));
+		ca_delete(&((*q)->tail));
 		(*q)->tail = NULL;
 
 		// Free the memory for the actual struct
@@ -91,17 +93,8 @@ void queue_enqueue(queue* q, void* x) {
 
 	if (q && x) {
 
-		/* Enqueue means inserting a new last element (new tail)
-		 * Our list pointer (list head) is the queue's tail
-		 *
-		 * We need to add an element AFTER our tail, and since
-		 * it's a circular list, a new element between the tail
-		 * and the head, this would mean insert a new head (insert at 0)
-		 *
-		 * However our pointer is to the tail, so we would need to insert
-		 * before the next (insert at 1)
-		 */
-		cl_insert_tail(q->tail, x);
+		// Enqueue means inserting a new last element (new tail)
+		ca_push_back(q->tail, x);
 	}
 	return;
 }
@@ -113,37 +106,23 @@ void* queue_dequeue(queue* q) {
 
 	void* val = NULL;
 
-	/* Dequeue means removing the current head
-	 * Our list pointer (list head) is the queue's tail
-	 *
-	 * We need to remove the element AFTER our tail, and since
-	 * it's a circular list, just removing the element marked as tail->next
-	 *
-	 * Since our pointer is to the tail, so we would need to remove the next (remove at 1)
-	 */
-	if (q) {
-
-		val = malloc(cl_get_element_size(q->tail));
-
-		if (val) {
+	// Dequeue means removing the current head
+	if (q && !ca_is_empty(q->tail)) {
 
-			memcpy(val, cl_get_head(q->tail), cl_get_element_size(q->tail));
-			cl_remove_head(q->tail);
-		}
+		val = malloc(ca_get_element_size(q->tail));
+		if (val) ca_pop_2_front(q->tail, val);
 	}
 	return val;
 }
 
 /**
  * Removes an element from the queue and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when dequeuing often
  */
 void queue_dequeue_2(queue* q, void* buf) {
 
-	if (q && buf) {
-
-		cl_get_2_head(q->tail, buf);
-		cl_remove_head(q->tail);
-	}
+	if (q && buf) ca_pop_2_front(q->tail, buf);
 	return;
 }
 
@@ -152,7 +131,7 @@ void queue_dequeue_2(queue* q, void* buf) {
  */
 void* queue_peek(queue* q) {
 
-	return q ? cl_get_head(q->tail) : NULL;
+	return q ? ca_get_front(q->tail) : NULL;
 }
 
 /**
@@ -160,7 +139,7 @@ void* queue_peek(queue* q) {
  */
 void queue_peek_2(queue* q, void* buf) {
 
-	if (q && buf) cl_get_2_head(q->tail, buf);
+	if (q && buf && !ca_is_empty(q->tail)) memcpy(buf, ca_get_front(q->tail), ca_get_element_size(q->tail));
 	return;
 }
 
@@ -169,7 +148,7 @@ void queue_peek_2(queue* q, void* buf) {
  */
 size_t queue_get_size(queue* q) {
 
-	return q ? cl_get_size(q->tail) : 0;
+	return q ? ca_get_size(q->tail) : 0;
 }
 
 /**
@@ -177,7 +156,7 @@ size_t queue_get_size(queue* q) {
  */
 size_t queue_get_element_size(queue* q) {
 
-	return q ? cl_get_element_size(q->tail) : 0;
+	return q ? ca_get_element_size(q->tail) : 0;
 }
 
 /**
@@ -186,7 +165,7 @@ size_t queue_get_element_size(queue* q) {
  */
 void queue_clear(queue* q) {
 
-	if (q) cl_clear(q->tail);
+	if (q) ca_clear(q->tail);
 	return;
 }
 
@@ -195,5 +174,5 @@ void queue_clear(queue* q) {
  */
 bool queue_is_empty(queue* q) {
 
-	return q ? cl_is_empty(q->tail) : false;
+	return q ? ca_is_empty(q->tail) : false;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 
 #include "../../include/linear/ringbuffer.h"
 #include "../../include/linear/vector.h"
+#include <stdatomic.h>
+#include <stdint.h>
 #include <string.h>
 
 /* Bit 0, sets the behaviour of the enqueue function on a full list
@@ -24,6 +26,49 @@
  */
 #define IS_FULL (1 << 1)
 
+/* Bit 2, set on rings created with ring_create_spsc, one producer and one consumer thread
+ * may use the ring at the same time without locks
+ */
+#define SPSC_MODE (1 << 2)
+
+/* Bit 3, set on rings created with ring_create_mpmc, any number of producer and consumer threads
+ * may use the ring at the same time without locks (each slot carries a sequence number)
+ */
+#define MPMC_MODE (1 << 3)
+
+/* Size of a cache line, the producer and consumer indices are padded to it so they don't share one */
+#define RING_CACHE_LINE 64
+
+/**
+ * Index of a concurrent ring (either the producer's or the consumer's one),
+ * padded to its own cache line
+ */
+typedef struct ring_index {
+
+	/* Number of elements inserted (producer) or removed (consumer) so far, never wraps within the ring,
+	 * the position in the ring is obtained masking it
+	 */
+	atomic_size_t value;
+
+	/* Last value read of the other index, only used in single producer/single consumer mode
+	 * so that the other cache line is read only when the ring looks full (or empty)
+	 */
+	size_t cached;
+
+	char padding[RING_CACHE_LINE - sizeof(atomic_size_t) - sizeof(size_t)];
+} ring_index;
+
+/* Utility function used to allocate a ring with the given flags */
+ringbuffer* ring_util_create(size_t max_capacity, size_t element_size, int flags);
+
+/* Utility functions implementing enqueue and dequeue for single producer/single consumer rings */
+bool ring_util_spsc_enqueue(ringbuffer* r, void* x);
+bool ring_util_spsc_deque(ringbuffer* r, void* buf);
+
+/* Utility functions implementing enqueue and dequeue for multi producer/multi consumer rings */
+bool ring_util_mpmc_enqueue(ringbuffer* r, void* x);
+bool ring_util_mpmc_deque(ringbuffer* r, void* buf);
+
  /**
   * Struct that represent a ring buffer that can store
   * a generic type value
@@ -53,6 +98,19 @@ typedef struct ringbuffer {
 	/* Flags containing the overwrite policy and information about the fullness ring */
 	int flags;
 
+	/* Capacity - 1, the capacity of concurrent rings is a power of two so positions are masked instead of using modulo */
+	size_t mask;
+
+	/* Sequence number of each slot, only used in multi producer/multi consumer mode */
+	atomic_size_t* sequences;
+
+	/* Keeps the fields above, which are only read once created, away from the producer index */
+	char padding[RING_CACHE_LINE];
+
+	/* Indices of concurrent rings, written by producers (tail) and by consumers (head) */
+	ring_index producer;
+	ring_index consumer;
+
 } ringbuffer;
 
 /**
@@ -60,40 +118,37 @@ typedef struct ringbuffer {
  */
 ringbuffer* ring_create(size_t max_capacity, size_t element_size) {
 
-	ringbuffer* r = NULL;
-
-	// Size check
-	if (max_capacity > 0 && element_size > 0) {
-
-		// Size check (2)
-		if (max_capacity <= SIZE_MAX / element_size) {
-
-			// Allocate the struct
-			r = (ringbuffer*)malloc(sizeof(ringbuffer));
-
-			if (r) {
-
-				// Create the vector
-				r->vec = vec_create(max_capacity, element_size);
+	return ring_util_create(max_capacity, element_size, 0);
+}
 
-				// The vector was created
-				if (r->vec) {
+/**
+ * Creates a ring buffer that one producer thread and one consumer thread
+ * can use at the same time, without locks
+ *
+ * The capacity is rounded up to a power of two, enqueue and dequeue
+ * never block and fail when the ring is full or empty
+ *
+ * The overwrite policy is ignored, the producer never moves the head
+ * (that would make it a second consumer), so enqueuing on a full ring fails
+ */
+ringbuffer* ring_create_spsc(size_t max_capacity, size_t element_size) {
 
-					r->head = 0;
-					r->tail = 0;
-					r->flags = 0;
-				}
+	return ring_util_create(max_capacity, element_size, SPSC_MODE);
+}
 
-				// The vector was not created, cancel the operation
-				else {
+/**
+ * Creates a ring buffer that any number of producer and consumer threads
+ * can use at the same time, without locks
+ *
+ * The capacity is rounded up to a power of two, enqueue and dequeue
+ * never block and fail when the ring is full or empty
+ *
+ * With the overwrite policy enabled, enqueuing on a full ring
+ * drops the first element and tries again
+ */
+ringbuffer* ring_create_mpmc(size_t max_capacity, size_t element_size) {
 
-					free(r);
-					r = NULL;
-				}
-			}
-		}
-	}
-	return r;
+	return ring_util_create(max_capacity, element_size, MPMC_MODE);
 }
 
 /**
@@ -109,6 +164,7 @@ void ring_delete(ringbuffer** r) {
 	if (r && *r) {
 
 		vec_delete(&(*r)->vec);
+		free((*r)->sequences);
 		memset(*r, 0, sizeof(ringbuffer));
 		free(*r);
 		*r = NULL;
@@ -125,11 +181,30 @@ void ring_delete(ringbuffer** r) {
  */
 void ring_enqueue(ringbuffer* r, void* x) {
 
+	ring_try_enqueue(r, x);
+	return;
+}
+
+/**
+ * Insert the element pointed to by x at the end of the ring buffer,
+ * returns whether or not it was inserted
+ *
+ * If the given ring is full, either the first element
+ * will be overwritten or the insertion will fail, depending
+ * on the overwrite policy
+ */
+bool ring_try_enqueue(ringbuffer* r, void* x) {
+
+	bool inserted = false;
+
 	// Parameter check
 	if (r && x) {
 
+		if (r->flags & SPSC_MODE) inserted = ring_util_spsc_enqueue(r, x);
+		else if (r->flags & MPMC_MODE) inserted = ring_util_mpmc_enqueue(r, x);
+
 		// If the list is full
-		if (ring_is_full(r)) {
+		else if (ring_is_full(r)) {
 
 			// If the policy permits overwriting, do that, otherwise, cancel the operation
 			if (r->flags & OVERWRITE_POLICY) {
@@ -138,6 +213,7 @@ void ring_enqueue(ringbuffer* r, void* x) {
 				r->head = (r->head + 1) % vec_get_size(r->vec);
 				vec_insert_at(r->vec, x, r->tail);
 				r->tail = (r->tail + 1) % vec_get_size(r->vec);
+				inserted = true;
 			}
 		}
 
@@ -148,9 +224,10 @@ void ring_enqueue(ringbuffer* r, void* x) {
 			r->tail = (r->tail + 1) % vec_get_size(r->vec);
 
 			if (r->head == r->tail) r->flags |= IS_FULL;
+			inserted = true;
 		}
 	}
-	return;
+	return inserted;
 }
 
 /**
@@ -169,11 +246,11 @@ void* ring_deque(ringbuffer* r) {
 
 			val = malloc(vec_get_element_size(r->vec));
 
-			if (val) {
+			// Another consumer may have emptied the ring in the meantime
+			if (val && !ring_try_deque(r, val)) {
 
-				memcpy(val, vec_get_at(r->vec, r->head), vec_get_element_size(r->vec));
-				vec_remove_at(r->vec, r->head);
-				r->head = (r->head + 1) % vec_get_size(r->vec);
+				free(val);
+				val = NULL;
 			}
 		}
 	}
@@ -188,44 +265,323 @@ void* ring_deque(ringbuffer* r) {
  */
 void ring_deque_2(ringbuffer* r, void* buf) {
 
-	if (r) {
+	ring_try_deque(r, buf);
+	return;
+}
 
-		if (!ring_is_empty(r)) {
+/**
+ * Removes the first element of the ring and copies it in the given buffer,
+ * returns whether or not an element was removed
+ *
+ * If the given ring is empty, false is returned and the buffer is left untouched
+ */
+bool ring_try_deque(ringbuffer* r, void* buf) {
+
+	bool removed = false;
+
+	if (r && buf) {
+
+		if (r->flags & SPSC_MODE) removed = ring_util_spsc_deque(r, buf);
+		else if (r->flags & MPMC_MODE) removed = ring_util_mpmc_deque(r, buf);
+
+		else if (!ring_is_empty(r)) {
 
 			vec_get_2_at(r->vec, r->head, buf);
 			vec_remove_at(r->vec, r->head);
 			r->head = (r->head + 1) % vec_get_size(r->vec);
+			r->flags &= ~IS_FULL;
+			removed = true;
 		}
 	}
-	return;
+	return removed;
 }
 
 /**
  * Returns the first element of the ring without removing it
  *
  * If the given ring is empty, NULL is returned
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring NULL is always returned, since another
+ * consumer could take the element while it's being read
  */
 void* ring_peek(ringbuffer* r) {
 
-	return r ? vec_get_at(r->vec, r->head) : NULL;
+	void* val = NULL;
+
+	if (r && !(r->flags & MPMC_MODE)) {
+
+		if (r->flags & SPSC_MODE) {
+
+			size_t head = atomic_load_explicit(&r->consumer.value, memory_order_relaxed);
+
+			if (head == r->consumer.cached) r->consumer.cached = atomic_load_explicit(&r->producer.value, memory_order_acquire);
+			if (head != r->consumer.cached) val = vec_get_at(r->vec, head & r->mask);
+		}
+		else if (!ring_is_empty(r)) val = vec_get_at(r->vec, r->head);
+	}
+	return val;
 }
 
 /**
  * Copies the first element of the ring in the given buffer, without removing it
  *
  * If the given ring is empty, NULL is returned
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring nothing is copied
  */
 void ring_peek_2(ringbuffer* r, void* buf) {
 
-	if (r) vec_get_2_at(r->vec, r->head, buf);
+	if (r && buf) {
+
+		void* val = ring_peek(r);
+		if (val) memcpy(buf, val, vec_get_element_size(r->vec));
+	}
+	return;
+}
+
+/**
+ * Inserts the n elements stored contiguously in xs at the end of the ring buffer,
+ * returns the number of elements inserted
+ *
+ * Elements are copied in (at most) two spans, before and after the wrap point
+ *
+ * If the ring gets full, either the first elements will be overwritten
+ * (only the last elements are kept if n is bigger than the ring) or the
+ * remaining elements are not inserted, depending on the overwrite policy
+ */
+size_t ring_enqueue_n(ringbuffer* r, const void* xs, size_t n) {
+
+	size_t inserted = 0;
+
+	if (r && xs) {
+
+		size_t element_size = vec_get_element_size(r->vec);
+
+		// Slots can't be reserved on multi producer/multi consumer rings, elements are inserted one at a time
+		if (r->flags & MPMC_MODE) {
+
+			while (inserted < n && ring_util_mpmc_enqueue(r, (char*)xs + inserted * element_size)) inserted++;
+		}
+		else {
+
+			const char* src = (const char*)xs;
+			size_t count = 0;
+			void* dst = NULL;
+
+			// Make room on a plain ring with the overwrite policy, dropping the first elements
+			if (!(r->flags & SPSC_MODE) && (r->flags & OVERWRITE_POLICY)) {
+
+				size_t capacity = ring_get_max_size(r);
+
+				// The first elements would be overwritten by the last ones of the same call, skip them
+				if (n > capacity) {
+
+					src += (n - capacity) * element_size;
+					inserted = n - capacity;
+				}
+				if (n - inserted > capacity - ring_get_cur_size(r)) ring_release(r, n - inserted - (capacity - ring_get_cur_size(r)));
+			}
+
+			while (inserted < n && (dst = ring_reserve(r, n - inserted, &count))) {
+
+				memcpy(dst, src, count * element_size);
+				ring_commit(r, count);
+				src += count * element_size;
+				inserted += count;
+			}
+		}
+	}
+	return inserted;
+}
+
+/**
+ * Removes (up to) n elements from the start of the ring and copies them contiguously in buf,
+ * returns the number of elements removed
+ *
+ * Elements are copied in (at most) two spans, before and after the wrap point
+ */
+size_t ring_deque_n(ringbuffer* r, void* buf, size_t n) {
+
+	size_t removed = 0;
+
+	if (r && buf) {
+
+		size_t element_size = vec_get_element_size(r->vec);
+
+		// Spans can't be peeked on multi producer/multi consumer rings, elements are removed one at a time
+		if (r->flags & MPMC_MODE) {
+
+			while (removed < n && ring_util_mpmc_deque(r, (char*)buf + removed * element_size)) removed++;
+		}
+		else {
+
+			size_t count = 0;
+			void* src = NULL;
+
+			while (removed < n && (src = ring_peek_span(r, n - removed, &count))) {
+
+				memcpy((char*)buf + removed * element_size, src, count * element_size);
+				ring_release(r, count);
+				removed += count;
+			}
+		}
+	}
+	return removed;
+}
+
+/**
+ * Returns a pointer to the free slots after the last element of the ring, so that the
+ * caller can write (up to) n elements directly into the buffer, they're inserted by ring_commit
+ *
+ * The number of contiguous slots that can be written (n at most, less if the ring
+ * is almost full or the span reaches the wrap point) is stored in reserved, NULL is
+ * returned when there's none
+ *
+ * On a single producer/single consumer ring only the producer may reserve,
+ * on a multi producer/multi consumer ring NULL is always returned
+ */
+void* ring_reserve(ringbuffer* r, size_t n, size_t* reserved) {
+
+	void* span = NULL;
+	size_t count = 0;
+
+	if (r && !(r->flags & MPMC_MODE)) {
+
+		size_t capacity = vec_get_size(r->vec);
+		size_t free_slots = 0;
+		size_t pos = 0;
+
+		if (r->flags & SPSC_MODE) {
+
+			size_t tail = atomic_load_explicit(&r->producer.value, memory_order_relaxed);
+
+			// The consumer index is read only when the cached one doesn't leave enough room
+			if (capacity - (tail - r->producer.cached) < n) r->producer.cached = atomic_load_explicit(&r->consumer.value, memory_order_acquire);
+
+			free_slots = capacity - (tail - r->producer.cached);
+			pos = tail & r->mask;
+		}
+		else {
+
+			free_slots = capacity - ring_get_cur_size(r);
+			pos = r->tail;
+		}
+
+		// The span stops at the wrap point
+		count = n < free_slots ? n : free_slots;
+		if (count > capacity - pos) count = capacity - pos;
+		if (count > 0) span = vec_get_at(r->vec, pos);
+	}
+	if (reserved) *reserved = count;
+	return span;
+}
+
+/**
+ * Inserts the n elements written in the span returned by ring_reserve
+ * (n can't be bigger than the number of slots reserved)
+ */
+void ring_commit(ringbuffer* r, size_t n) {
+
+	if (r && n > 0 && !(r->flags & MPMC_MODE)) {
+
+		// Publishes the elements to the consumer
+		if (r->flags & SPSC_MODE) atomic_store_explicit(&r->producer.value, atomic_load_explicit(&r->producer.value, memory_order_relaxed) + n, memory_order_release);
+
+		else {
+
+			r->tail = (r->tail + n) % vec_get_size(r->vec);
+			if (r->head == r->tail) r->flags |= IS_FULL;
+		}
+	}
+	return;
+}
+
+/**
+ * Returns a pointer to the first element of the ring, so that the caller can read
+ * (up to) n elements directly from the buffer, they're removed by ring_release
+ *
+ * The number of contiguous elements that can be read (n at most, less if the ring
+ * has fewer elements or the span reaches the wrap point) is stored in count, NULL is
+ * returned when there's none
+ *
+ * On a single producer/single consumer ring only the consumer may peek,
+ * on a multi producer/multi consumer ring NULL is always returned
+ */
+void* ring_peek_span(ringbuffer* r, size_t n, size_t* count) {
+
+	void* span = NULL;
+	size_t available = 0;
+
+	if (r && !(r->flags & MPMC_MODE)) {
+
+		size_t capacity = vec_get_size(r->vec);
+		size_t pos = 0;
+
+		if (r->flags & SPSC_MODE) {
+
+			size_t head = atomic_load_explicit(&r->consumer.value, memory_order_relaxed);
+
+			// The producer index is read only when the cached one doesn't hold enough elements
+			if (r->consumer.cached - head < n) r->consumer.cached = atomic_load_explicit(&r->producer.value, memory_order_acquire);
+
+			available = r->consumer.cached - head;
+			pos = head & r->mask;
+		}
+		else {
+
+			available = ring_get_cur_size(r);
+			pos = r->head;
+		}
+
+		// The span stops at the wrap point
+		if (available > n) available = n;
+		if (available > capacity - pos) available = capacity - pos;
+		if (available > 0) span = vec_get_at(r->vec, pos);
+	}
+	if (count) *count = available;
+	return span;
+}
+
+/**
+ * Removes the first n elements of the ring, usually after reading them
+ * from the span returned by ring_peek_span
+ * (n can't be bigger than the number of elements in the ring)
+ */
+void ring_release(ringbuffer* r, size_t n) {
+
+	if (r && n > 0 && !(r->flags & MPMC_MODE)) {
+
+		// Gives the slots back to the producer
+		if (r->flags & SPSC_MODE) atomic_store_explicit(&r->consumer.value, atomic_load_explicit(&r->consumer.value, memory_order_relaxed) + n, memory_order_release);
+
+		else {
+
+			r->head = (r->head + n) % vec_get_size(r->vec);
+			r->flags &= ~IS_FULL;
+		}
+	}
 	return;
 }
 
 /**
  * Returns the number of elements inside the ring
+ *
+ * On concurrent rings it's a snapshot, other threads may change it right after
  */
 size_t ring_get_cur_size(ringbuffer* r) {
 
+	// Concurrent rings, the value is a snapshot that may be stale by the time it's returned
+	if (r && (r->flags & (SPSC_MODE | MPMC_MODE))) {
+
+		// The head is read first, so the tail can't be behind it
+		size_t head = atomic_load(&r->consumer.value);
+		size_t tail = atomic_load(&r->producer.value);
+
+		return (tail - head < r->mask + 1) ? tail - head : r->mask + 1;
+	}
+
 	return r ? ((ring_is_full(r)) ? ring_get_max_size(r) : ((r->head <= r->tail) ? (r->tail - r->head) : (ring_get_max_size(r) - r->head + r->tail))) : 0;
 }
 
@@ -250,6 +606,8 @@ size_t ring_get_element_size(ringbuffer* r) {
  */
 bool ring_is_empty(ringbuffer* r) {
 
+	if (r && (r->flags & (SPSC_MODE | MPMC_MODE))) return ring_get_cur_size(r) == 0;
+
 	return r ? ((r->head == r->tail) && !(r->flags & IS_FULL)) : false;
 }
 
@@ -258,11 +616,15 @@ bool ring_is_empty(ringbuffer* r) {
  */
 bool ring_is_full(ringbuffer* r) {
 
+	if (r && (r->flags & (SPSC_MODE | MPMC_MODE))) return ring_get_cur_size(r) == r->mask + 1;
+
 	return r ? (r->flags & IS_FULL) : false;
 }
 
 /**
  * Enables the overwrite policy on full rings
+ *
+ * On concurrent rings the policy must be set before the ring is shared
  */
 void ring_enable_overwrite(ringbuffer* r) {
 
@@ -272,6 +634,8 @@ void ring_enable_overwrite(ringbuffer* r) {
 
 /**
  * Disables the overwrite policy on full rings
+ *
+ * On concurrent rings the policy must be set before the ring is shared
  */
 void ring_disable_overwrite(ringbuffer* r) {
 
@@ -296,4 +660,200 @@ void ring_set_overwrite(ringbuffer* r, bool flag_val) {
 		}
 	}
 	return;
+}
+
+/**
+ * Allocates a ring with the given capacity and flags, concurrent
+ * rings get their capacity rounded up to a power of two
+ * (and multi producer/multi consumer ones their sequence numbers)
+ */
+ringbuffer* ring_util_create(size_t max_capacity, size_t element_size, int flags) {
+
+	ringbuffer* r = NULL;
+
+	// Size check
+	if (max_capacity > 0 && element_size > 0) {
+
+		size_t capacity = max_capacity;
+
+		// Concurrent rings mask positions, so the capacity must be a power of two
+		if (flags & (SPSC_MODE | MPMC_MODE)) {
+
+			capacity = 1;
+			while (capacity < max_capacity && capacity <= SIZE_MAX / 2) capacity <<= 1;
+			if (capacity < max_capacity) capacity = 0;
+		}
+
+		// Size check (2)
+		if (capacity > 0 && capacity <= SIZE_MAX / element_size) {
+
+			// Allocate the struct
+			r = (ringbuffer*)malloc(sizeof(ringbuffer));
+
+			if (r) {
+
+				// Create the vector
+				r->vec = vec_create(capacity, element_size);
+				r->sequences = (flags & MPMC_MODE) ? (atomic_size_t*)malloc(capacity * sizeof(atomic_size_t)) : NULL;
+
+				// The vector was created
+				if (r->vec && (r->sequences || !(flags & MPMC_MODE))) {
+
+					r->head = 0;
+					r->tail = 0;
+					r->flags = flags;
+					r->mask = capacity - 1;
+
+					// A slot whose sequence is equal to the producer index is free to be written
+					if (r->sequences) for (size_t i = 0; i < capacity; i++) atomic_init(&r->sequences[i], i);
+
+					atomic_init(&r->producer.value, 0);
+					atomic_init(&r->consumer.value, 0);
+					r->producer.cached = 0;
+					r->consumer.cached = 0;
+				}
+
+				// The vector was not created, cancel the operation
+				else {
+
+					vec_delete(&r->vec);
+					free(r->sequences);
+					free(r);
+					r = NULL;
+				}
+			}
+		}
+	}
+	return r;
+}
+
+/**
+ * Producer side of a single producer/single consumer ring, the consumer index
+ * is read (from the other cache line) only when the cached one says the ring is full
+ */
+bool ring_util_spsc_enqueue(ringbuffer* r, void* x) {
+
+	bool inserted = false;
+	size_t tail = atomic_load_explicit(&r->producer.value, memory_order_relaxed);
+
+	if (tail - r->producer.cached > r->mask) r->producer.cached = atomic_load_explicit(&r->consumer.value, memory_order_acquire);
+
+	if (tail - r->producer.cached <= r->mask) {
+
+		memcpy(vec_get_at(r->vec, tail & r->mask), x, vec_get_element_size(r->vec));
+
+		// Publishes the element to the consumer
+		atomic_store_explicit(&r->producer.value, tail + 1, memory_order_release);
+		inserted = true;
+	}
+	return inserted;
+}
+
+/**
+ * Consumer side of a single producer/single consumer ring, the producer index
+ * is read (from the other cache line) only when the cached one says the ring is empty
+ */
+bool ring_util_spsc_deque(ringbuffer* r, void* buf) {
+
+	bool removed = false;
+	size_t head = atomic_load_explicit(&r->consumer.value, memory_order_relaxed);
+
+	if (head == r->consumer.cached) r->consumer.cached = atomic_load_explicit(&r->producer.value, memory_order_acquire);
+
+	if (head != r->consumer.cached) {
+
+		memcpy(buf, vec_get_at(r->vec, head & r->mask), vec_get_element_size(r->vec));
+
+		// Gives the slot back to the producer
+		atomic_store_explicit(&r->consumer.value, head + 1, memory_order_release);
+		removed = true;
+	}
+	return removed;
+}
+
+/**
+ * Producer side of a multi producer/multi consumer ring (bounded queue with per slot sequence numbers)
+ *
+ * A slot can be written when its sequence is equal to the producer index, the producer
+ * claims it moving the index forward and, after writing, sets the sequence to index + 1
+ * so that consumers see it as full
+ */
+bool ring_util_mpmc_enqueue(ringbuffer* r, void* x) {
+
+	bool inserted = false;
+	bool full = false;
+	size_t pos = atomic_load_explicit(&r->producer.value, memory_order_relaxed);
+
+	while (!inserted && !full) {
+
+		atomic_size_t* seq = &r->sequences[pos & r->mask];
+		intptr_t diff = (intptr_t)atomic_load_explicit(seq, memory_order_acquire) - (intptr_t)pos;
+
+		// The slot is free, try to claim it (on failure pos gets the current index)
+		if (diff == 0) {
+
+			if (atomic_compare_exchange_weak_explicit(&r->producer.value, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+
+				memcpy(vec_get_at(r->vec, pos & r->mask), x, vec_get_element_size(r->vec));
+				atomic_store_explicit(seq, pos + 1, memory_order_release);
+				inserted = true;
+			}
+		}
+
+		// The slot still holds the element inserted one lap before, the ring is full
+		else if (diff < 0) {
+
+			// Drops the first element to make room, if the policy permits it
+			if (r->flags & OVERWRITE_POLICY) {
+
+				ring_util_mpmc_deque(r, NULL);
+				pos = atomic_load_explicit(&r->producer.value, memory_order_relaxed);
+			}
+			else full = true;
+		}
+
+		// Another producer claimed the slot, catch up
+		else pos = atomic_load_explicit(&r->producer.value, memory_order_relaxed);
+	}
+	return inserted;
+}
+
+/**
+ * Consumer side of a multi producer/multi consumer ring (bounded queue with per slot sequence numbers)
+ *
+ * A slot can be read when its sequence is equal to the consumer index + 1, the consumer
+ * claims it moving the index forward and, after reading, sets the sequence to index + capacity
+ * so that producers see it as free on the next lap
+ *
+ * If buf is NULL the element is dropped
+ */
+bool ring_util_mpmc_deque(ringbuffer* r, void* buf) {
+
+	bool removed = false;
+	bool empty = false;
+	size_t pos = atomic_load_explicit(&r->consumer.value, memory_order_relaxed);
+
+	while (!removed && !empty) {
+
+		atomic_size_t* seq = &r->sequences[pos & r->mask];
+		intptr_t diff = (intptr_t)atomic_load_explicit(seq, memory_order_acquire) - (intptr_t)(pos + 1);
+
+		// The slot is full, try to claim it (on failure pos gets the current index)
+		if (diff == 0) {
+
+			if (atomic_compare_exchange_weak_explicit(&r->consumer.value, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+
+				if (buf) memcpy(buf, vec_get_at(r->vec, pos & r->mask), vec_get_element_size(r->vec));
+				atomic_store_explicit(seq, pos + r->mask + 1, memory_order_release);
+				removed = true;
+			}
+		}
+
+		// The slot wasn't written yet, the ring is empty
+		else if (diff < 0) empty = true;
+
+		// Another consumer claimed the slot, catch up
+		else pos = atomic_load_explicit(&r->consumer.value, memory_order_relaxed);
+	}
+	return removed;
 }
\ No newline at end of file
@@ -0,0 +1,1050 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/roaring.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && defined(__AVX__)
+#include <nmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Number of bits in a chunk, and words of the bitmap of a chunk */
+#define ROARING_CHUNK_BITS 65536
+#define ROARING_BITMAP_WORDS 1024
+
+/* Most positive bits a chunk stored as an array can have, past this a bitmap is smaller */
+#define ROARING_ARRAY_MAX 4096
+
+/* Forms a chunk can be stored in */
+typedef enum roaring_type { ROARING_ARRAY, ROARING_BITMAP, ROARING_RUN } roaring_type;
+
+/* Operations between two sets */
+typedef enum roaring_op { ROARING_AND, ROARING_OR, ROARING_XOR, ROARING_AND_NOT } roaring_op;
+
+/**
+ * Bits of a chunk
+ *
+ * An array holds the sorted low 16 bits of the positive ones, a bitmap holds 1024 words
+ * and a list of runs holds pairs (start, length - 1) sorted by start
+ */
+typedef struct roaring_container {
+
+	/* Form the chunk is stored in */
+	roaring_type type;
+
+	/* Number of positive bits */
+	uint32_t cardinality;
+
+	/* Values (arrays) or runs (lists of runs) in use, and how many there's space for */
+	uint32_t length;
+	uint32_t capacity;
+
+	/* Values, words or runs */
+	void* data;
+} roaring_container;
+
+/* Utility function that returns the first position of a sorted array whose value isn't smaller than x */
+size_t roaring_util_lower_bound(uint16_t* values, size_t n, uint16_t x);
+
+/* Utility function that returns the first run of the chunk that doesn't end before x */
+size_t roaring_util_run_find(roaring_container* c, uint16_t x);
+
+/* Utility function returning the number of set bits in a word */
+size_t roaring_util_popcount(uint64_t word);
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t roaring_util_ctz(uint64_t word);
+
+/* Utility function that returns the position of the first bit equal to value starting from the given one, or ROARING_CHUNK_BITS */
+uint32_t roaring_util_bitmap_next(uint64_t* words, uint32_t from, bool value);
+
+/* Utility functions used to read a bit of a chunk, and to find the next positive one */
+bool roaring_util_container_get(roaring_container* c, uint16_t x);
+bool roaring_util_container_next(roaring_container* c, uint16_t from, uint16_t* next);
+
+/* Utility functions used to add and remove a bit of a chunk, returning whether it changed */
+bool roaring_util_container_add(roaring_container* c, uint16_t x);
+bool roaring_util_container_remove(roaring_container* c, uint16_t x);
+
+/* Utility function that writes the bits of a chunk in 1024 words */
+void roaring_util_fill_words(roaring_container* c, uint64_t* words);
+
+/* Utility functions used to change the form of a chunk, returning false if memory runs out (the chunk is left as it was) */
+bool roaring_util_to_bitmap(roaring_container* c);
+bool roaring_util_to_array(roaring_container* c);
+bool roaring_util_to_run(roaring_container* c);
+
+/* Utility function that turns a list of runs back into an array or a bitmap, whichever fits the cardinality */
+bool roaring_util_unrun(roaring_container* c);
+
+/* Utility functions used to copy and free a chunk */
+bool roaring_util_container_copy(roaring_container* c, roaring_container* out);
+void roaring_util_container_free(roaring_container* c);
+
+/* Utility function that computes the operation between two chunks in a new one */
+bool roaring_util_combine(roaring_container* a, roaring_container* b, roaring_op op, roaring_container* out);
+
+/* Utility function that applies the operation between two sets, leaving the first unchanged if memory runs out */
+void roaring_util_apply(roaring* r, roaring* other, roaring_op op);
+
+/* Utility function that returns the chunk with the given key, creating it (empty) if required */
+roaring_container* roaring_util_get_container(roaring* r, uint16_t key, bool create);
+
+/* Utility function that removes the chunk at the given position */
+void roaring_util_remove_container(roaring* r, size_t index);
+
+/**
+ * Struct that represent a compressed bitset over the whole range of 32 bit integers
+ *
+ * The range is split in chunks of 65536 bits, only the chunks with at least one positive bit
+ * are stored, each one in the smallest of three forms: a sorted array of its positive bits
+ * (up to 4096 of them), a plain bitmap, or a list of runs of consecutive positive bits
+ *
+ * Runs are only made by roaring_optimize, changing a chunk stored as runs turns it back into one of the other forms
+ */
+typedef struct roaring {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* High 16 bits of the positions in each chunk, sorted */
+	uint16_t* keys;
+
+	/* Chunks, in the same order as their keys */
+	roaring_container* containers;
+
+	/* Number of chunks stored, and how many there's space for */
+	size_t size;
+	size_t capacity;
+
+	/* Number of bits set to 1 */
+	uint64_t count;
+} roaring;
+
+/**
+ *  Creates an empty compressed bitset
+ */
+roaring* roaring_create(void) {
+
+	roaring* r = (roaring*)malloc(sizeof(roaring));
+
+	if (r) {
+
+		r->keys = NULL;
+		r->containers = NULL;
+		r->size = 0;
+		r->capacity = 0;
+		r->count = 0;
+	}
+	return r;
+}
+
+/**
+ *  Deletes the given bitset
+ */
+void roaring_delete(roaring** r) {
+
+	if (r && *r) {
+
+		roaring_clear(*r);
+		free((*r)->keys);
+		free((*r)->containers);
+		free(*r);
+		*r = NULL;
+	}
+	return;
+}
+
+/**
+ *  Sets the i -th bit of the set to 1
+ */
+void roaring_set(roaring* r, uint32_t i) {
+
+	if (r) {
+
+		roaring_container* c = roaring_util_get_container(r, (uint16_t)(i >> 16), true);
+		if (c && roaring_util_container_add(c, (uint16_t)i)) r->count++;
+
+		// A chunk that couldn't get its first bit isn't kept
+		if (c && c->cardinality == 0) roaring_util_remove_container(r, (size_t)(c - r->containers));
+	}
+	return;
+}
+
+/**
+ *  Sets the i -th bit of the set to 0
+ */
+void roaring_unset(roaring* r, uint32_t i) {
+
+	if (r) {
+
+		roaring_container* c = roaring_util_get_container(r, (uint16_t)(i >> 16), false);
+		if (c && roaring_util_container_remove(c, (uint16_t)i)) {
+
+			r->count--;
+			if (c->cardinality == 0) roaring_util_remove_container(r, (size_t)(c - r->containers));
+		}
+	}
+	return;
+}
+
+/**
+ *  Returns the value of the i -th bit of the set
+ */
+bool roaring_get(roaring* r, uint32_t i) {
+
+	roaring_container* c = r ? roaring_util_get_container(r, (uint16_t)(i >> 16), false) : NULL;
+
+	return c ? roaring_util_container_get(c, (uint16_t)i) : false;
+}
+
+/**
+ *  Toggles the i -th bit of the set
+ */
+void roaring_toggle(roaring* r, uint32_t i) {
+
+	if (roaring_get(r, i)) roaring_unset(r, i);
+	else roaring_set(r, i);
+	return;
+}
+
+/**
+ *  Returns the number of positive bits in the set
+ *
+ *  The value is cached, so this is O(1)
+ */
+uint64_t roaring_count(roaring* r) {
+
+	return r ? r->count : 0;
+}
+
+/**
+ *  Sets to 0 every bit of the set that's 0 in other (r = r & other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_and(roaring* r, roaring* other) {
+
+	if (r && other) {
+
+		roaring_util_apply(r, other, ROARING_AND);
+	}
+	return;
+}
+
+/**
+ *  Sets to 1 every bit of the set that's 1 in other (r = r | other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_or(roaring* r, roaring* other) {
+
+	if (r && other) {
+
+		roaring_util_apply(r, other, ROARING_OR);
+	}
+	return;
+}
+
+/**
+ *  Toggles every bit of the set that's 1 in other (r = r ^ other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_xor(roaring* r, roaring* other) {
+
+	if (r && other) {
+
+		roaring_util_apply(r, other, ROARING_XOR);
+	}
+	return;
+}
+
+/**
+ *  Sets to 0 every bit of the set that's 1 in other (r = r & ~other)
+ *
+ *  If memory runs out the set is left unchanged
+ */
+void roaring_and_not(roaring* r, roaring* other) {
+
+	if (r && other) {
+
+		roaring_util_apply(r, other, ROARING_AND_NOT);
+	}
+	return;
+}
+
+/**
+ *  Returns the position of the first bit set to 1 starting from the given one (included)
+ *
+ *  Returns whether or not there was one, its position is written in next
+ */
+bool roaring_next_set(roaring* r, uint32_t from, uint32_t* next) {
+
+	bool found = false;
+
+	if (r && next) {
+
+		uint16_t low = (uint16_t)from;
+		uint16_t x;
+
+		// The chunk of from is searched from there on, the following ones from their start
+		for (size_t i = roaring_util_lower_bound(r->keys, r->size, (uint16_t)(from >> 16)); i < r->size && !found; i++) {
+
+			if (r->keys[i] != (uint16_t)(from >> 16)) low = 0;
+			found = roaring_util_container_next(r->containers + i, low, &x);
+			if (found) *next = ((uint32_t)r->keys[i] << 16) | x;
+		}
+	}
+	return found;
+}
+
+/**
+ *  Calls f with the position of every bit set to 1, in increasing order
+ *
+ *  f must not modify the set
+ */
+void roaring_for_each_set(roaring* r, void (*f)(uint32_t)) {
+
+	if (r && f) {
+
+		for (size_t i = 0; i < r->size; i++) {
+
+			roaring_container* c = r->containers + i;
+			uint32_t high = (uint32_t)r->keys[i] << 16;
+
+			if (c->type == ROARING_ARRAY) {
+
+				uint16_t* values = (uint16_t*)c->data;
+				for (uint32_t j = 0; j < c->length; j++) f(high | values[j]);
+			}
+			else if (c->type == ROARING_BITMAP) {
+
+				uint64_t* words = (uint64_t*)c->data;
+				for (uint32_t j = 0; j < ROARING_BITMAP_WORDS; j++) {
+
+					for (uint64_t word = words[j]; word; word &= word - 1) f(high | (j * 64 + (uint32_t)roaring_util_ctz(word)));
+				}
+			}
+			else {
+
+				uint16_t* runs = (uint16_t*)c->data;
+				for (uint32_t j = 0; j < c->length; j++) {
+
+					for (uint32_t x = runs[2 * j]; x <= (uint32_t)runs[2 * j] + runs[2 * j + 1]; x++) f(high | x);
+				}
+			}
+		}
+	}
+	return;
+}
+
+/**
+ *  Stores as runs every chunk that takes less memory that way
+ */
+void roaring_optimize(roaring* r) {
+
+	if (r) {
+
+		for (size_t i = 0; i < r->size; i++) roaring_util_to_run(r->containers + i);
+	}
+	return;
+}
+
+/**
+ *  Returns the number of bytes used by the set
+ */
+size_t roaring_get_memory(roaring* r) {
+
+	size_t memory = 0;
+
+	if (r) {
+
+		memory = sizeof(roaring) + r->capacity * (sizeof(uint16_t) + sizeof(roaring_container));
+		for (size_t i = 0; i < r->size; i++) {
+
+			roaring_container* c = r->containers + i;
+
+			if (c->type == ROARING_ARRAY) memory += c->capacity * sizeof(uint16_t);
+			else if (c->type == ROARING_BITMAP) memory += ROARING_BITMAP_WORDS * sizeof(uint64_t);
+			else memory += c->capacity * 2 * sizeof(uint16_t);
+		}
+	}
+	return memory;
+}
+
+/**
+ *  Sets all the bits of the set to 0
+ */
+void roaring_clear(roaring* r) {
+
+	if (r) {
+
+		for (size_t i = 0; i < r->size; i++) roaring_util_container_free(r->containers + i);
+		r->size = 0;
+		r->count = 0;
+	}
+	return;
+}
+
+/**
+ *  Checks whether the set has at least one positive bit or not
+ */
+bool roaring_is_empty(roaring* r) {
+
+	return roaring_count(r) == 0;
+}
+
+/* Utility function that returns the first position of a sorted array whose value isn't smaller than x */
+size_t roaring_util_lower_bound(uint16_t* values, size_t n, uint16_t x) {
+
+	size_t lo = 0, hi = n;
+
+	while (lo < hi) {
+
+		size_t mid = lo + (hi - lo) / 2;
+		if (values[mid] < x) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+/* Utility function that returns the first run of the chunk that doesn't end before x */
+size_t roaring_util_run_find(roaring_container* c, uint16_t x) {
+
+	uint16_t* runs = (uint16_t*)c->data;
+	size_t lo = 0, hi = c->length;
+
+	// Runs don't overlap, so their ends are sorted aswell
+	while (lo < hi) {
+
+		size_t mid = lo + (hi - lo) / 2;
+		if ((uint32_t)runs[2 * mid] + runs[2 * mid + 1] < x) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+/* Utility function returning the number of set bits in a word */
+size_t roaring_util_popcount(uint64_t word) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64) && defined(__AVX__)
+	return (size_t)_mm_popcnt_u64(word);
+#else
+	// Sum the bits in pairs, then nibbles, then add up the bytes
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t roaring_util_ctz(uint64_t word) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (size_t)index;
+#else
+	// Isolate the lowest bit, then find its position halving the range
+	size_t pos = 0;
+	word &= (~word + 1);
+	if (!(word & 0x00000000FFFFFFFFULL)) pos += 32;
+	if (!(word & 0x0000FFFF0000FFFFULL)) pos += 16;
+	if (!(word & 0x00FF00FF00FF00FFULL)) pos += 8;
+	if (!(word & 0x0F0F0F0F0F0F0F0FULL)) pos += 4;
+	if (!(word & 0x3333333333333333ULL)) pos += 2;
+	if (!(word & 0x5555555555555555ULL)) pos += 1;
+	return pos;
+#endif
+}
+
+/* Utility function that returns the position of the first bit equal to value starting from the given one, or ROARING_CHUNK_BITS */
+uint32_t roaring_util_bitmap_next(uint64_t* words, uint32_t from, bool value) {
+
+	uint32_t pos = ROARING_CHUNK_BITS;
+
+	if (from < ROARING_CHUNK_BITS) {
+
+		// Looking for a 0 is looking for a 1 in the complement
+		uint64_t flip = value ? 0 : ~(uint64_t)0;
+		uint32_t i = from / 64;
+		uint64_t word = (words[i] ^ flip) & (~(uint64_t)0 << (from % 64));
+
+		while (!word && ++i < ROARING_BITMAP_WORDS) word = words[i] ^ flip;
+		if (word) pos = i * 64 + (uint32_t)roaring_util_ctz(word);
+	}
+	return pos;
+}
+
+/* Utility function used to read a bit of a chunk */
+bool roaring_util_container_get(roaring_container* c, uint16_t x) {
+
+	bool found = false;
+
+	if (c->type == ROARING_ARRAY) {
+
+		size_t i = roaring_util_lower_bound((uint16_t*)c->data, c->length, x);
+		found = i < c->length && ((uint16_t*)c->data)[i] == x;
+	}
+	else if (c->type == ROARING_BITMAP) found = (((uint64_t*)c->data)[x / 64] >> (x % 64)) & 1;
+	else {
+
+		size_t i = roaring_util_run_find(c, x);
+		found = i < c->length && ((uint16_t*)c->data)[2 * i] <= x;
+	}
+	return found;
+}
+
+/* Utility function used to find the next positive bit of a chunk */
+bool roaring_util_container_next(roaring_container* c, uint16_t from, uint16_t* next) {
+
+	bool found = false;
+
+	if (c->type == ROARING_ARRAY) {
+
+		size_t i = roaring_util_lower_bound((uint16_t*)c->data, c->length, from);
+		found = i < c->length;
+		if (found) *next = ((uint16_t*)c->data)[i];
+	}
+	else if (c->type == ROARING_BITMAP) {
+
+		uint32_t pos = roaring_util_bitmap_next((uint64_t*)c->data, from, true);
+		found = pos < ROARING_CHUNK_BITS;
+		if (found) *next = (uint16_t)pos;
+	}
+	else {
+
+		size_t i = roaring_util_run_find(c, from);
+		found = i < c->length;
+		if (found) *next = ((uint16_t*)c->data)[2 * i] > from ? ((uint16_t*)c->data)[2 * i] : from;
+	}
+	return found;
+}
+
+/* Utility function used to add a bit to a chunk, returning whether it changed */
+bool roaring_util_container_add(roaring_container* c, uint16_t x) {
+
+	bool added = false;
+
+	if (c->type != ROARING_RUN || roaring_util_unrun(c)) {
+
+		if (c->type == ROARING_ARRAY) {
+
+			uint16_t* values = (uint16_t*)c->data;
+			size_t i = roaring_util_lower_bound(values, c->length, x);
+
+			if (i == c->length || values[i] != x) {
+
+				// A full array becomes a bitmap
+				if (c->length == ROARING_ARRAY_MAX) {
+
+					if (roaring_util_to_bitmap(c)) added = roaring_util_container_add(c, x);
+				}
+				else {
+
+					if (c->length == c->capacity) {
+
+						uint32_t capacity = c->capacity ? c->capacity * 2 : 4;
+						if (capacity > ROARING_ARRAY_MAX) capacity = ROARING_ARRAY_MAX;
+
+						values = (uint16_t*)realloc(c->data, capacity * sizeof(uint16_t));
+						if (values) {
+
+							c->data = values;
+							c->capacity = capacity;
+						}
+					}
+
+					if (c->length < c->capacity) {
+
+						values = (uint16_t*)c->data;
+						memmove(values + i + 1, values + i, (c->length - i) * sizeof(uint16_t));
+						values[i] = x;
+						c->length++;
+						c->cardinality++;
+						added = true;
+					}
+				}
+			}
+		}
+		else {
+
+			uint64_t* words = (uint64_t*)c->data;
+			if (!((words[x / 64] >> (x % 64)) & 1)) {
+
+				words[x / 64] |= (uint64_t)1 << (x % 64);
+				c->cardinality++;
+				added = true;
+			}
+		}
+	}
+	return added;
+}
+
+/* Utility function used to remove a bit from a chunk, returning whether it changed */
+bool roaring_util_container_remove(roaring_container* c, uint16_t x) {
+
+	bool removed = false;
+
+	if (roaring_util_container_get(c, x) && (c->type != ROARING_RUN || roaring_util_unrun(c))) {
+
+		if (c->type == ROARING_ARRAY) {
+
+			uint16_t* values = (uint16_t*)c->data;
+			size_t i = roaring_util_lower_bound(values, c->length, x);
+
+			memmove(values + i, values + i + 1, (c->length - i - 1) * sizeof(uint16_t));
+			c->length--;
+			c->cardinality--;
+		}
+		else {
+
+			((uint64_t*)c->data)[x / 64] &= ~((uint64_t)1 << (x % 64));
+			c->cardinality--;
+
+			// Small enough to go back to an array, if that fails it just stays a bitmap
+			if (c->cardinality <= ROARING_ARRAY_MAX) roaring_util_to_array(c);
+		}
+		removed = true;
+	}
+	return removed;
+}
+
+/* Utility function that writes the bits of a chunk in 1024 words */
+void roaring_util_fill_words(roaring_container* c, uint64_t* words) {
+
+	if (c->type == ROARING_BITMAP) memcpy(words, c->data, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+	else {
+
+		uint16_t* data = (uint16_t*)c->data;
+
+		memset(words, 0, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		if (c->type == ROARING_ARRAY) {
+
+			for (uint32_t i = 0; i < c->length; i++) words[data[i] / 64] |= (uint64_t)1 << (data[i] % 64);
+		}
+		else {
+
+			for (uint32_t i = 0; i < c->length; i++) {
+
+				// Whole words in the middle of the run, masks at its borders
+				uint32_t from = data[2 * i], to = (uint32_t)data[2 * i] + data[2 * i + 1] + 1;
+				while (from < to) {
+
+					uint64_t mask = ~(uint64_t)0 << (from % 64);
+					if (from / 64 == (to - 1) / 64 && to % 64) mask &= ~(~(uint64_t)0 << (to % 64));
+
+					words[from / 64] |= mask;
+					from = (from / 64 + 1) * 64;
+				}
+			}
+		}
+	}
+	return;
+}
+
+/* Utility function used to store a chunk as a bitmap */
+bool roaring_util_to_bitmap(roaring_container* c) {
+
+	bool converted = c->type == ROARING_BITMAP;
+
+	if (!converted) {
+
+		uint64_t* words = (uint64_t*)malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		if (words) {
+
+			roaring_util_fill_words(c, words);
+			free(c->data);
+			c->data = words;
+			c->type = ROARING_BITMAP;
+			c->length = 0;
+			c->capacity = 0;
+			converted = true;
+		}
+	}
+	return converted;
+}
+
+/* Utility function used to store a chunk as an array, it must have at most ROARING_ARRAY_MAX positive bits */
+bool roaring_util_to_array(roaring_container* c) {
+
+	bool converted = c->type == ROARING_ARRAY;
+
+	if (!converted) {
+
+		uint16_t* values = (uint16_t*)malloc((c->cardinality ? c->cardinality : 1) * sizeof(uint16_t));
+		if (values) {
+
+			uint32_t n = 0;
+			uint16_t* data = (uint16_t*)c->data;
+
+			if (c->type == ROARING_BITMAP) {
+
+				uint64_t* words = (uint64_t*)c->data;
+				for (uint32_t j = 0; j < ROARING_BITMAP_WORDS; j++) {
+
+					for (uint64_t word = words[j]; word; word &= word - 1) values[n++] = (uint16_t)(j * 64 + roaring_util_ctz(word));
+				}
+			}
+			else {
+
+				for (uint32_t j = 0; j < c->length; j++) {
+
+					for (uint32_t x = data[2 * j]; x <= (uint32_t)data[2 * j] + data[2 * j + 1]; x++) values[n++] = (uint16_t)x;
+				}
+			}
+
+			free(c->data);
+			c->data = values;
+			c->type = ROARING_ARRAY;
+			c->length = n;
+			c->capacity = c->cardinality ? c->cardinality : 1;
+			converted = true;
+		}
+	}
+	return converted;
+}
+
+/* Utility function used to store a chunk as runs, only if it takes less memory that way */
+bool roaring_util_to_run(roaring_container* c) {
+
+	bool converted = c->type == ROARING_RUN;
+
+	if (!converted) {
+
+		uint64_t words[ROARING_BITMAP_WORDS];
+		uint32_t runs = 0;
+
+		roaring_util_fill_words(c, words);
+
+		// A run starts on every positive bit whose previous one is 0
+		for (uint32_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+
+			uint64_t carry = i ? words[i - 1] >> 63 : 0;
+			runs += (uint32_t)roaring_util_popcount(words[i] & ~((words[i] << 1) | carry));
+		}
+
+		size_t current = c->type == ROARING_ARRAY ? c->capacity * sizeof(uint16_t) : ROARING_BITMAP_WORDS * sizeof(uint64_t);
+		if (runs * 2 * sizeof(uint16_t) < current) {
+
+			uint16_t* data = (uint16_t*)malloc(runs * 2 * sizeof(uint16_t));
+			if (data) {
+
+				uint32_t n = 0;
+				uint32_t pos = roaring_util_bitmap_next(words, 0, true);
+
+				while (pos < ROARING_CHUNK_BITS) {
+
+					uint32_t end = roaring_util_bitmap_next(words, pos, false);
+					data[2 * n] = (uint16_t)pos;
+					data[2 * n + 1] = (uint16_t)(end - pos - 1);
+					n++;
+					pos = roaring_util_bitmap_next(words, end, true);
+				}
+
+				free(c->data);
+				c->data = data;
+				c->type = ROARING_RUN;
+				c->length = runs;
+				c->capacity = runs;
+				converted = true;
+			}
+		}
+	}
+	return converted;
+}
+
+/* Utility function that turns a list of runs back into an array or a bitmap, whichever fits the cardinality */
+bool roaring_util_unrun(roaring_container* c) {
+
+	return c->cardinality <= ROARING_ARRAY_MAX ? roaring_util_to_array(c) : roaring_util_to_bitmap(c);
+}
+
+/* Utility function used to copy a chunk */
+bool roaring_util_container_copy(roaring_container* c, roaring_container* out) {
+
+	size_t bytes = c->type == ROARING_ARRAY ? c->length * sizeof(uint16_t) : c->type == ROARING_RUN ? c->length * 2 * sizeof(uint16_t) : ROARING_BITMAP_WORDS * sizeof(uint64_t);
+
+	*out = *c;
+	out->capacity = c->type == ROARING_BITMAP ? 0 : c->length;
+	out->data = malloc(bytes ? bytes : 1);
+	if (out->data) memcpy(out->data, c->data, bytes);
+
+	return out->data != NULL;
+}
+
+/* Utility function used to free a chunk */
+void roaring_util_container_free(roaring_container* c) {
+
+	free(c->data);
+	c->data = NULL;
+	c->cardinality = 0;
+	c->length = 0;
+	c->capacity = 0;
+	return;
+}
+
+/* Utility function that computes the operation between two chunks in a new one */
+bool roaring_util_combine(roaring_container* a, roaring_container* b, roaring_op op, roaring_container* out) {
+
+	bool done = false;
+
+	out->cardinality = 0;
+	out->length = 0;
+	out->capacity = 0;
+	out->data = NULL;
+
+	// An array intersected with anything (or minus anything) only needs its own bits checked
+	if ((op == ROARING_AND && (a->type == ROARING_ARRAY || b->type == ROARING_ARRAY)) || (op == ROARING_AND_NOT && a->type == ROARING_ARRAY)) {
+
+		roaring_container* array = (a->type == ROARING_ARRAY) ? a : b;
+		roaring_container* other = (array == a) ? b : a;
+		uint16_t* values = (uint16_t*)array->data;
+		uint16_t* data = (uint16_t*)malloc((array->length ? array->length : 1) * sizeof(uint16_t));
+
+		if (data) {
+
+			for (uint32_t i = 0; i < array->length; i++) {
+
+				if (roaring_util_container_get(other, values[i]) == (op == ROARING_AND)) data[out->length++] = values[i];
+			}
+			out->type = ROARING_ARRAY;
+			out->data = data;
+			out->capacity = array->length ? array->length : 1;
+			out->cardinality = out->length;
+			done = true;
+		}
+	}
+
+	// Two arrays are merged, the result may be too big for an array
+	else if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY) {
+
+		uint16_t* x = (uint16_t*)a->data;
+		uint16_t* y = (uint16_t*)b->data;
+		uint16_t* data = (uint16_t*)malloc((a->length + b->length) * sizeof(uint16_t));
+
+		if (data) {
+
+			uint32_t i = 0, j = 0;
+			while (i < a->length || j < b->length) {
+
+				if (j == b->length || (i < a->length && x[i] < y[j])) data[out->length++] = x[i++];
+				else if (i == a->length || y[j] < x[i]) data[out->length++] = y[j++];
+				else {
+
+					if (op == ROARING_OR) data[out->length++] = x[i];
+					i++;
+					j++;
+				}
+			}
+			out->type = ROARING_ARRAY;
+			out->data = data;
+			out->capacity = a->length + b->length;
+			out->cardinality = out->length;
+			done = out->cardinality <= ROARING_ARRAY_MAX || roaring_util_to_bitmap(out);
+			if (!done) roaring_util_container_free(out);
+		}
+	}
+
+	// Everything else is done a word at a time
+	else {
+
+		uint64_t* words = (uint64_t*)malloc(ROARING_BITMAP_WORDS * sizeof(uint64_t));
+		uint64_t other[ROARING_BITMAP_WORDS];
+
+		if (words) {
+
+			roaring_util_fill_words(a, words);
+			roaring_util_fill_words(b, other);
+
+			for (uint32_t i = 0; i < ROARING_BITMAP_WORDS; i++) {
+
+				switch (op) {
+				case ROARING_AND: words[i] &= other[i]; break;
+				case ROARING_OR: words[i] |= other[i]; break;
+				case ROARING_XOR: words[i] ^= other[i]; break;
+				case ROARING_AND_NOT: words[i] &= ~other[i]; break;
+				}
+				out->cardinality += (uint32_t)roaring_util_popcount(words[i]);
+			}
+			out->type = ROARING_BITMAP;
+			out->data = words;
+			if (out->cardinality <= ROARING_ARRAY_MAX) roaring_util_to_array(out);
+			done = true;
+		}
+	}
+	return done;
+}
+
+/* Utility function that applies the operation between two sets, leaving the first unchanged if memory runs out */
+void roaring_util_apply(roaring* r, roaring* other, roaring_op op) {
+
+	size_t capacity = r->size + other->size;
+	uint16_t* keys = (uint16_t*)malloc((capacity ? capacity : 1) * sizeof(uint16_t));
+	roaring_container* containers = (roaring_container*)malloc((capacity ? capacity : 1) * sizeof(roaring_container));
+
+	// Which chunk of r each new chunk is taken from as it is (SIZE_MAX for the ones made anew)
+	size_t* origin = (size_t*)malloc((capacity ? capacity : 1) * sizeof(size_t));
+
+	if (keys && containers && origin) {
+
+		size_t i = 0, j = 0, n = 0;
+		uint64_t count = 0;
+		bool failed = false;
+
+		while ((i < r->size || j < other->size) && !failed) {
+
+			bool keep = false;
+			roaring_container out;
+
+			if (j == other->size || (i < r->size && r->keys[i] < other->keys[j])) {
+
+				// Only in r, unless intersecting it's kept as it is
+				if (op != ROARING_AND) {
+
+					keys[n] = r->keys[i];
+					containers[n] = r->containers[i];
+					origin[n] = i;
+					count += containers[n].cardinality;
+					n++;
+				}
+				i++;
+			}
+			else if (i == r->size || other->keys[j] < r->keys[i]) {
+
+				// Only in other, copied if it ends up in the result
+				if (op == ROARING_OR || op == ROARING_XOR) {
+
+					keys[n] = other->keys[j];
+					failed = !roaring_util_container_copy(other->containers + j, &out);
+					keep = !failed;
+				}
+				j++;
+			}
+			else {
+
+				keys[n] = r->keys[i];
+				failed = !roaring_util_combine(r->containers + i, other->containers + j, op, &out);
+				keep = !failed;
+				if (keep && out.cardinality == 0) {
+
+					roaring_util_container_free(&out);
+					keep = false;
+				}
+				i++;
+				j++;
+			}
+
+			if (keep) {
+
+				containers[n] = out;
+				origin[n] = SIZE_MAX;
+				count += out.cardinality;
+				n++;
+			}
+		}
+
+		if (failed) {
+
+			for (size_t k = 0; k < n; k++) if (origin[k] == SIZE_MAX) roaring_util_container_free(containers + k);
+		}
+		else {
+
+			// The chunks of r that weren't taken as they are aren't needed anymore
+			size_t k = 0;
+			for (i = 0; i < r->size; i++) {
+
+				while (k < n && (origin[k] == SIZE_MAX || origin[k] < i)) k++;
+				if (k == n || origin[k] != i) roaring_util_container_free(r->containers + i);
+			}
+
+			free(r->keys);
+			free(r->containers);
+			r->keys = keys;
+			r->containers = containers;
+			r->size = n;
+			r->capacity = capacity;
+			r->count = count;
+			keys = NULL;
+			containers = NULL;
+		}
+	}
+
+	free(keys);
+	free(containers);
+	free(origin);
+	return;
+}
+
+/* Utility function that returns the chunk with the given key, creating it (empty) if required */
+roaring_container* roaring_util_get_container(roaring* r, uint16_t key, bool create) {
+
+	roaring_container* c = NULL;
+	size_t i = roaring_util_lower_bound(r->keys, r->size, key);
+
+	if (i < r->size && r->keys[i] == key) c = r->containers + i;
+	else if (create) {
+
+		if (r->size == r->capacity) {
+
+			size_t capacity = r->capacity ? r->capacity * 2 : 4;
+			uint16_t* keys = (uint16_t*)realloc(r->keys, capacity * sizeof(uint16_t));
+			if (keys) r->keys = keys;
+
+			roaring_container* containers = keys ? (roaring_container*)realloc(r->containers, capacity * sizeof(roaring_container)) : NULL;
+			if (containers) {
+
+				r->containers = containers;
+				r->capacity = capacity;
+			}
+		}
+
+		if (r->size < r->capacity) {
+
+			memmove(r->keys + i + 1, r->keys + i, (r->size - i) * sizeof(uint16_t));
+			memmove(r->containers + i + 1, r->containers + i, (r->size - i) * sizeof(roaring_container));
+			r->keys[i] = key;
+			r->size++;
+
+			c = r->containers + i;
+			c->type = ROARING_ARRAY;
+			c->cardinality = 0;
+			c->length = 0;
+			c->capacity = 0;
+			c->data = NULL;
+		}
+	}
+	return c;
+}
+
+/* Utility function that removes the chunk at the given position */
+void roaring_util_remove_container(roaring* r, size_t index) {
+
+	roaring_util_container_free(r->containers + index);
+	memmove(r->keys + index, r->keys + index + 1, (r->size - index - 1) * sizeof(uint16_t));
+	memmove(r->containers + index, r->containers + index + 1, (r->size - index - 1) * sizeof(roaring_container));
+	r->size--;
+	return;
+}
\ No newline at end of file
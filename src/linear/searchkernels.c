@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/searchkernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SEARCH_WITH_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Utility function used to get the index of the lowest set bit of a (non zero) compare mask */
+size_t search_util_lowest_bit(uint32_t mask);
+
+/**
+ * Search kernel for elements that are 1 byte long
+ */
+size_t search_util_find_8(const void* base, size_t count, size_t element_size, const void* x) {
+
+	// The width is fixed by the kernel, the size is only there to match the other kernels
+	(void)element_size;
+
+	const uint8_t* elements = (const uint8_t*)base;
+	uint8_t key = *(const uint8_t*)x;
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	__m256i needle = _mm256_set1_epi8((char)key);
+	for (; i + 32 <= count; i += 32) {
+
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(elements + i)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask);
+	}
+#elif defined(SEARCH_WITH_SSE2)
+	__m128i needle = _mm_set1_epi8((char)key);
+	for (; i + 16 <= count; i += 16) {
+
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(elements + i)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask);
+	}
+#endif
+
+	// Remaining elements (all of them, without vector instructions)
+	for (; i < count; i++)
+		if (elements[i] == key)
+			return i;
+	return count;
+}
+
+/**
+ * Search kernel for elements that are 2 bytes long
+ */
+size_t search_util_find_16(const void* base, size_t count, size_t element_size, const void* x) {
+
+	(void)element_size;
+
+	const uint8_t* elements = (const uint8_t*)base;
+	uint16_t key, value;
+	size_t i = 0;
+
+	memcpy(&key, x, sizeof(key));
+
+	/* The byte mask of a 16 bit compare has both bits of a lane set
+	 * or none of them, so the lowest set bit divided by two is the lane
+	 */
+#if defined(__AVX2__)
+	__m256i needle = _mm256_set1_epi16((short)key);
+	for (; i + 16 <= count; i += 16) {
+
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(elements + i * 2)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask) / 2;
+	}
+#elif defined(SEARCH_WITH_SSE2)
+	__m128i needle = _mm_set1_epi16((short)key);
+	for (; i + 8 <= count; i += 8) {
+
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(elements + i * 2)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask) / 2;
+	}
+#endif
+
+	for (; i < count; i++) {
+
+		memcpy(&value, elements + i * 2, sizeof(value));
+		if (value == key)
+			return i;
+	}
+	return count;
+}
+
+/**
+ * Search kernel for elements that are 4 bytes long
+ */
+size_t search_util_find_32(const void* base, size_t count, size_t element_size, const void* x) {
+
+	(void)element_size;
+
+	const uint8_t* elements = (const uint8_t*)base;
+	uint32_t key, value;
+	size_t i = 0;
+
+	memcpy(&key, x, sizeof(key));
+
+#if defined(__AVX2__)
+	__m256i needle = _mm256_set1_epi32((int)key);
+	for (; i + 8 <= count; i += 8) {
+
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(elements + i * 4)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask) / 4;
+	}
+#elif defined(SEARCH_WITH_SSE2)
+	__m128i needle = _mm_set1_epi32((int)key);
+	for (; i + 4 <= count; i += 4) {
+
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(elements + i * 4)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask) / 4;
+	}
+#endif
+
+	for (; i < count; i++) {
+
+		memcpy(&value, elements + i * 4, sizeof(value));
+		if (value == key)
+			return i;
+	}
+	return count;
+}
+
+/**
+ * Search kernel for elements that are 8 bytes long
+ */
+size_t search_util_find_64(const void* base, size_t count, size_t element_size, const void* x) {
+
+	(void)element_size;
+
+	const uint8_t* elements = (const uint8_t*)base;
+	uint64_t key, value;
+	size_t i = 0;
+
+	memcpy(&key, x, sizeof(key));
+
+#if defined(__AVX2__)
+	__m256i needle = _mm256_set1_epi64x((long long)key);
+	for (; i + 4 <= count; i += 4) {
+
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(elements + i * 8)), needle));
+		if (mask)
+			return i + search_util_lowest_bit(mask) / 8;
+	}
+#elif defined(SEARCH_WITH_SSE2)
+	/* SSE2 has no 64 bit compare, the two 32 bit halves are compared
+	 * instead and a lane matches only when its 8 mask bits are all set
+	 */
+	__m128i needle = _mm_set1_epi64x((long long)key);
+	for (; i + 2 <= count; i += 2) {
+
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(elements + i * 8)), needle));
+		if ((mask & 0x00FF) == 0x00FF)
+			return i;
+		if ((mask & 0xFF00) == 0xFF00)
+			return i + 1;
+	}
+#endif
+
+	for (; i < count; i++) {
+
+		memcpy(&value, elements + i * 8, sizeof(value));
+		if (value == key)
+			return i;
+	}
+	return count;
+}
+
+/**
+ * Search kernel for elements of any size, compares one element at a time with memcmp
+ */
+size_t search_util_find_generic(const void* base, size_t count, size_t element_size, const void* x) {
+
+	const uint8_t* element = (const uint8_t*)base;
+
+	for (size_t i = 0; i < count; i++, element += element_size)
+		if (memcmp(element, x, element_size) == 0)
+			return i;
+	return count;
+}
+
+/**
+ * Returns the fastest kernel for elements that are element_size bytes long
+ *
+ * Meant to be called once, when the container is created, and stored
+ */
+search_kernel search_util_select(size_t element_size) {
+
+	switch (element_size) {
+	case 1: return search_util_find_8;
+	case 2: return search_util_find_16;
+	case 4: return search_util_find_32;
+	case 8: return search_util_find_64;
+	default: return search_util_find_generic;
+	}
+}
+
+/* Utility function used to get the index of the lowest set bit of a (non zero) compare mask */
+size_t search_util_lowest_bit(uint32_t mask) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (size_t)index;
+#else
+	size_t index = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
\ No newline at end of file
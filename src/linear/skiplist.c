@@ -13,6 +13,12 @@
 /* Utility function used to generate a level for a node */
 size_t sl_generate_random_level(double probability, size_t max_levels);
 
+/* Utility function used to get the pool of the nodes with the given level */
+pool* sl_util_get_pool(skiplist* sl, size_t level);
+
+/* Utility function that returns the first node holding a value not less (or, if strict, greater) than x */
+snode* sl_util_bound(skiplist* sl, void* x, bool strict);
+
 /**
  * Struct that represent a list of elements of a generic type value
  */
@@ -44,6 +50,9 @@ typedef struct skiplist {
 
 	/* Function used to compare elements to determine the order within the list */
 	int (*compare)(void*, void*);
+
+	/* One pool for each level, since nodes of different levels have different sizes (created when first needed) */
+	pool** nodes;
 } skiplist;
 
 /**
@@ -68,28 +77,94 @@ skiplist* sl_create(size_t element_size, size_t max_levels, double probability,
 						sl->max_levels = max_levels;
 						sl->compare = cmp;
 						sl->probability = probability;
+						sl->sentinel = NULL;
+						sl->nodes = (pool**)calloc(max_levels, sizeof(pool*));
 
-						void* sentinel_val = malloc(sl->element_size);
-						if (sentinel_val) {
-							memset(sentinel_val, 0, sl->element_size);
-							sl->sentinel = snode_create(sentinel_val, sl->element_size, sl->max_levels);
-
-							if (!sl->sentinel) {
+						void* sentinel_val = calloc(1, sl->element_size);
+						if (sentinel_val && sl->nodes) {
 
-								free(sl);
-								sl = NULL;
-							}
-							free(sentinel_val);
+							sl->sentinel = snode_create(sentinel_val, sl->element_size, sl->max_levels);
 						}
-						else {
 
+						if (!sl->sentinel) {
+
+							free(sl->nodes);
 							free(sl);
 							sl = NULL;
 						}
+						free(sentinel_val);
+					}
+				}
+			}
+		}
+	}
+	return sl;
+}
+
+/**
+ * Creates a list holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * Every node is appended at the end in O(1), so it takes O(n) time without comparing any element;
+ * levels aren't random, one node every 1/probability in each level goes up to the next one, so the list is perfectly balanced
+ */
+skiplist* sl_from_sorted(size_t element_size, size_t max_levels, double probability, int (*cmp)(void*, void*), void* elements, size_t n) {
+
+	skiplist* sl = sl_create(element_size, max_levels, probability, cmp);
+
+	if (sl && elements && n > 0) {
+
+		size_t levels = snode_get_level(sl->sentinel);
+		snode** last = (snode**)malloc(sizeof(snode*) * levels);
+		size_t* positions = (size_t*)malloc(sizeof(size_t) * levels);
+
+		// A node every 'step' nodes of a level is in the next level aswell
+		size_t step = (size_t)(1.0 / probability + 0.5);
+		if (step < 2) step = 2;
+
+		if (last && positions) {
+
+			for (size_t i = 0; i < levels; i++) {
+
+				last[i] = sl->sentinel;
+				positions[i] = 0;
+			}
+
+			size_t top = 1;
+			for (size_t p = 1; p <= n && sl; p++) {
+
+				size_t node_level = 1;
+				for (size_t j = p; j % step == 0 && node_level < levels; j /= step) node_level++;
+
+				pool* nodes = sl_util_get_pool(sl, node_level);
+				snode* node = nodes ? snode_create_in(nodes, (char*)elements + (p - 1) * element_size, element_size, node_level) : NULL;
+				if (node) {
+
+					// Append the node as the last one of each of its levels
+					for (size_t i = 0; i < node_level; i++) {
+
+						snode_set_next(last[i], node, i);
+						snode_set_span(last[i], p - positions[i], i);
+						last[i] = node;
+						positions[i] = p;
 					}
+					if (node_level > top) top = node_level;
+					sl->element_count++;
 				}
+				else sl_delete(&sl);
+			}
+
+			if (sl) {
+
+				// The last pointer of each level moves over the nodes after it
+				for (size_t i = 0; i < levels; i++) snode_set_span(last[i], n - positions[i], i);
+				sl->max_levels = top;
 			}
 		}
+		else sl_delete(&sl);
+
+		free(last);
+		free(positions);
 	}
 	return sl;
 }
@@ -102,8 +177,10 @@ void sl_delete(skiplist** sl) {
 	// Access the list only if the pointer is valid
 	if (sl && *sl) {
 
-		// Free every node
-		sl_clear(*sl);
+		// Free every node, a pool at a time
+		for (size_t i = 0; i < snode_get_level((*sl)->sentinel); i++) pool_delete(&(*sl)->nodes[i]);
+		free((*sl)->nodes);
+		snode_delete(&(*sl)->sentinel);
 
 		// Free the memory used for the whole struct
 		memset(*sl, 0, sizeof(skiplist));
@@ -120,35 +197,50 @@ void sl_insert(skiplist* sl, void* x) {
 
 	if (sl && x) {
 
-		snode** update = (snode**)malloc(sizeof(snode*) * sl->max_levels);
-		if (update) {
+		size_t levels = snode_get_level(sl->sentinel);
+		snode** update = (snode**)malloc(sizeof(snode*) * levels);
+		size_t* rank = (size_t*)malloc(sizeof(size_t) * levels);
+		if (update && rank) {
 
 			snode* tmp = sl->sentinel;
 
-			for (size_t i = sl->max_levels; i > 0; i--) {
+			// Find the last node before x on every level, and its position in the list
+			for (size_t i = levels; i > 0; i--) {
 
+				rank[i - 1] = (i == levels) ? 0 : rank[i];
 				while (snode_get_next(tmp, i - 1) && (sl->compare(snode_get_value(snode_get_next(tmp, i - 1)), x) < 0)) {
 
+					rank[i - 1] += snode_get_span(tmp, i - 1);
 					tmp = snode_get_next(tmp, i - 1);
 				}
 				update[i - 1] = tmp;
 			}
 
-			size_t node_level = sl_generate_random_level(sl->probability, sl->max_levels);
-			snode* to_be_inserted = snode_create(x, sl->element_size, node_level);
+			size_t node_level = sl_generate_random_level(sl->probability, levels);
+			pool* nodes = sl_util_get_pool(sl, node_level);
+			snode* to_be_inserted = nodes ? snode_create_in(nodes, x, sl->element_size, node_level) : NULL;
 			if (to_be_inserted) {
 
+				// The new node splits the spans of the pointers it's linked between
 				for (size_t i = 0; i < node_level; i++) {
 
-					snode_set_next(to_be_inserted, snode_get_next(update[i], i), node_level);
+					snode_set_next(to_be_inserted, snode_get_next(update[i], i), i);
 					snode_set_next(update[i], to_be_inserted, i);
+
+					snode_set_span(to_be_inserted, snode_get_span(update[i], i) - (rank[0] - rank[i]), i);
+					snode_set_span(update[i], rank[0] - rank[i] + 1, i);
 				}
+
+				// The pointers above it now move over one more node
+				for (size_t i = node_level; i < levels; i++) snode_set_span(update[i], snode_get_span(update[i], i) + 1, i);
+
+				sl->element_count++;
+				if (node_level > sl->max_levels)
+					sl->max_levels = node_level;
 			}
-			free(update);
-			sl->element_count++;
-			if (node_level > sl->max_levels)
-				sl->max_levels = node_level;
 		}
+		free(update);
+		free(rank);
 	}
 	return;
 }
@@ -160,12 +252,13 @@ void sl_remove(skiplist* sl, void* x) {
 
 	if (sl && x) {
 
-		snode** update = (snode**)malloc(sizeof(snode*) * sl->max_levels);
+		size_t levels = snode_get_level(sl->sentinel);
+		snode** update = (snode**)malloc(sizeof(snode*) * levels);
 		if (update) {
 
 			snode* tmp = sl->sentinel;
 
-			for (size_t i = sl->max_levels; i > 0; i--) {
+			for (size_t i = levels; i > 0; i--) {
 
 				while (snode_get_next(tmp, i - 1) && (sl->compare(snode_get_value(snode_get_next(tmp, i - 1)), x) < 0)) {
 
@@ -178,19 +271,23 @@ void sl_remove(skiplist* sl, void* x) {
 
 			if (to_be_deleted && (sl->compare(snode_get_value(to_be_deleted), x) == 0)) {
 
-				for (size_t i = 0; i < sl->max_levels; i++) {
-
-					if (snode_get_next(update[i], i) != to_be_deleted) break;
-					snode_set_next(update[i], snode_get_next(to_be_deleted, i), i);
+				// Unlink the node from every level it is part of, the pointers passing over it move over one less node
+				for (size_t i = 0; i < levels; i++) {
 
-					snode_delete(&to_be_deleted);
+					if (snode_get_next(update[i], i) == to_be_deleted) {
 
-					while (sl->max_levels > 1 && !snode_get_next(sl->sentinel, sl->max_levels - 1))
-						sl->max_levels--;
+						snode_set_span(update[i], snode_get_span(update[i], i) + snode_get_span(to_be_deleted, i) - 1, i);
+						snode_set_next(update[i], snode_get_next(to_be_deleted, i), i);
+					}
+					else snode_set_span(update[i], snode_get_span(update[i], i) - 1, i);
 				}
+				snode_delete_in(sl_util_get_pool(sl, snode_get_level(to_be_deleted)), &to_be_deleted);
+				sl->element_count--;
+
+				while (sl->max_levels > 1 && !snode_get_next(sl->sentinel, sl->max_levels - 1))
+					sl->max_levels--;
 			}
 			free(update);
-			sl->element_count--;
 		}
 	}
 	return;
@@ -206,10 +303,10 @@ void* sl_search(skiplist* sl, void* x) {
 	if (sl && x) {
 	
 		to_ret = sl->sentinel;
-		for (size_t i = sl->max_levels; i > 0; i++) {
+		for (size_t i = sl->max_levels; i > 0; i--) {
 
-			while (snode_get_next(to_ret, i) && (sl->compare(snode_get_value(snode_get_next(to_ret, i)), x) < 0))
-				to_ret = snode_get_next(to_ret, i);
+			while (snode_get_next(to_ret, i - 1) && (sl->compare(snode_get_value(snode_get_next(to_ret, i - 1)), x) < 0))
+				to_ret = snode_get_next(to_ret, i - 1);
 		}
 
 		to_ret = snode_get_next(to_ret, 0);
@@ -218,6 +315,145 @@ void* sl_search(skiplist* sl, void* x) {
 	return (to_ret && (sl->compare(snode_get_value(to_ret), x) == 0)) ? to_ret : NULL;
 }
 
+/**
+ * Returns a pointer to the first element that is not less than x, NULL if there's none
+ */
+void* sl_lower_bound(skiplist* sl, void* x) {
+
+	snode* n = (sl && x) ? sl_util_bound(sl, x, false) : NULL;
+
+	return n ? snode_get_value(n) : NULL;
+}
+
+/**
+ * Returns a pointer to the first element that is greater than x, NULL if there's none
+ */
+void* sl_upper_bound(skiplist* sl, void* x) {
+
+	snode* n = (sl && x) ? sl_util_bound(sl, x, true) : NULL;
+
+	return n ? snode_get_value(n) : NULL;
+}
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) expected time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void sl_range(skiplist* sl, void* lo, void* hi, void (*callback)(void*)) {
+
+	if (sl && callback) {
+
+		sl_iterator it;
+		sl_iterator_init(sl, &it, lo, hi);
+
+		while (sl_iterator_has_next(&it)) callback(sl_iterator_next(&it));
+	}
+	return;
+}
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void sl_iterator_init(skiplist* sl, sl_iterator* it, void* lo, void* hi) {
+
+	if (it) {
+
+		it->node = NULL;
+		it->hi = hi;
+		it->compare = sl ? sl->compare : NULL;
+
+		if (sl) {
+
+			it->node = lo ? sl_util_bound(sl, lo, false) : snode_get_next(sl->sentinel, 0);
+
+			// The range could be empty
+			if (it->node && hi && it->compare(snode_get_value(it->node), hi) > 0) it->node = NULL;
+		}
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool sl_iterator_has_next(sl_iterator* it) {
+
+	return it && it->node;
+}
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* sl_iterator_next(sl_iterator* it) {
+
+	void* val = NULL;
+
+	if (it && it->node) {
+
+		val = snode_get_value(it->node);
+
+		// The bottom level links every node in order
+		it->node = snode_get_next(it->node, 0);
+		if (it->node && it->hi && it->compare(snode_get_value(it->node), it->hi) > 0) it->node = NULL;
+	}
+	return val;
+}
+
+/**
+ * Returns a pointer to the k-th smallest element (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(log n) expected time, since every pointer knows how many nodes it moves over
+ */
+void* sl_select(skiplist* sl, size_t k) {
+
+	snode* tmp = NULL;
+
+	if (sl && k < sl->element_count) {
+
+		size_t traversed = 0;
+
+		// Move forward as long as the (k + 1)-th node isn't passed
+		tmp = sl->sentinel;
+		for (size_t i = sl->max_levels; i > 0; i--) {
+
+			while (snode_get_next(tmp, i - 1) && traversed + snode_get_span(tmp, i - 1) <= k + 1) {
+
+				traversed += snode_get_span(tmp, i - 1);
+				tmp = snode_get_next(tmp, i - 1);
+			}
+		}
+	}
+	return tmp ? snode_get_value(tmp) : NULL;
+}
+
+/**
+ * Returns the number of elements in the list that are less than x (x doesn't need to be in the list)
+ *
+ * It takes O(log n) expected time, since every pointer knows how many nodes it moves over
+ */
+size_t sl_rank(skiplist* sl, void* x) {
+
+	size_t rank = 0;
+
+	if (sl && x) {
+
+		snode* tmp = sl->sentinel;
+		for (size_t i = sl->max_levels; i > 0; i--) {
+
+			while (snode_get_next(tmp, i - 1) && (sl->compare(snode_get_value(snode_get_next(tmp, i - 1)), x) < 0)) {
+
+				rank += snode_get_span(tmp, i - 1);
+				tmp = snode_get_next(tmp, i - 1);
+			}
+		}
+	}
+	return rank;
+}
+
 /**
  * Returns the number of elements of the list
  */
@@ -242,6 +478,33 @@ size_t sl_get_max_levels(skiplist* sl) {
 	return sl ? sl->max_levels : 0;
 }
 
+/**
+ * Copies in stats the counters of the skip list
+ *
+ * Nodes of each level come from their own pool, so the histogram costs O(max levels)
+ */
+void sl_get_stats(skiplist* sl, sl_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(sl_stats));
+		stats->nodes.enabled = STATS_ENABLED;
+
+		if (sl) {
+
+			for (size_t level = 0; level < sl->max_levels; level++) {
+
+				size_t count = pool_get_count(sl->nodes[level]);
+
+				pool_add_stats(sl->nodes[level], &stats->nodes);
+				stats->levels[level < SL_STATS_LEVELS ? level : SL_STATS_LEVELS - 1] += count;
+				if (count > 0) stats->height = level + 1;
+			}
+		}
+	}
+	return;
+}
+
 /**
  * Checks if the element pointed to by x is present in the list
  */
@@ -266,20 +529,14 @@ void sl_clear(skiplist* sl) {
 
 	if (sl) {
 
-		snode* tmp = snode_get_next(sl->sentinel, 0);
-		snode* next = NULL;
-
-		while(tmp) {
-
-			next = snode_get_next(tmp, 0);
-			snode_delete(&tmp);
-			tmp = next;
-		}
-
-		for (size_t i = 0; i < sl->max_levels; i++) {
+		// Every node comes from the pools, release them all without visiting the list
+		for (size_t i = 0; i < snode_get_level(sl->sentinel); i++) {
 
+			pool_clear(sl->nodes[i]);
 			snode_set_next(sl->sentinel, NULL, i);
+			snode_set_span(sl->sentinel, 0, i);
 		}
+		sl->element_count = 0;
 	}
 	return;
 }
@@ -293,4 +550,31 @@ size_t sl_generate_random_level(double probability, size_t max_levels) {
 		level++;
 
 	return level;
+}
+
+/* Utility function that returns the pool of the nodes with the given level, creating it if needed */
+pool* sl_util_get_pool(skiplist* sl, size_t level) {
+
+	if (!sl->nodes[level - 1]) sl->nodes[level - 1] = pool_create(snode_get_footprint(sl->element_size, level));
+
+	return sl->nodes[level - 1];
+}
+
+/* Utility function that returns the first node holding a value not less (or, if strict, greater) than x */
+snode* sl_util_bound(skiplist* sl, void* x, bool strict) {
+
+	snode* tmp = sl->sentinel;
+
+	// Stop, on every level, before the first node that qualifies
+	for (size_t i = sl->max_levels; i > 0; i--) {
+
+		while (snode_get_next(tmp, i - 1)) {
+
+			int diff = sl->compare(snode_get_value(snode_get_next(tmp, i - 1)), x);
+
+			if (diff < 0 || (diff == 0 && strict)) tmp = snode_get_next(tmp, i - 1);
+			else break;
+		}
+	}
+	return snode_get_next(tmp, 0);
 }
\ No newline at end of file
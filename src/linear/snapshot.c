@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/snapshot.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Bytes every snapshot starts with */
+#define SNAPSHOT_MAGIC "CDSSNAP"
+
+/* Written as it is, it reads differently on machines with the other byte order */
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+/* Tables are at most 7/8 full (so that every probe sequence meets an empty slot), and have at least 8 slots */
+#define SNAPSHOT_TABLE_MIN_CAPACITY 8
+
+/* Values in a table are padded to a multiple of this, so that they're aligned */
+#define SNAPSHOT_VALUE_ALIGNMENT 8
+
+/**
+ * Header at the start of every snapshot
+ */
+typedef struct snapshot_header {
+
+	char magic[8];
+	uint32_t version;
+	uint32_t kind;
+	uint32_t byte_order;
+
+	/* Sizes of size_t and int of the machine that wrote the snapshot, arrays of both are read in place */
+	uint16_t size_width;
+	uint16_t int_width;
+
+	/* Size of the descriptor at the end of the snapshot */
+	uint64_t descriptor_size;
+} snapshot_header;
+
+/**
+ * Header at the start of every table, followed by the slots, the values and the keys
+ */
+typedef struct snapshot_table_header {
+
+	uint64_t capacity;
+	uint64_t count;
+	uint64_t value_size;
+	uint64_t seed;
+} snapshot_table_header;
+
+/* Utility function used to pad the snapshot with zeros until its length is a multiple of alignment */
+void snapshot_util_pad(snapshot_writer* w, size_t alignment);
+
+/* Utility functions used to map and unmap a whole file (read-only) */
+bool snapshot_util_map(snapshot* s, const char* path);
+void snapshot_util_unmap(snapshot* s);
+
+/**
+ * Struct that represent a mapped snapshot
+ */
+typedef struct snapshot {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Start of the mapping and its length (the whole file) */
+	const char* data;
+	size_t size;
+
+#if defined(_WIN32)
+	/* Handles of the file and of the mapping object, released when unmapping */
+	HANDLE file;
+	HANDLE mapping;
+#endif
+} snapshot;
+
+/**
+ * Maps the snapshot in the given file, which must hold the given kind of container,
+ * and copies its descriptor (that is descriptor_size bytes long) in descriptor
+ *
+ * NULL is returned if the file can't be mapped or isn't a valid snapshot
+ */
+snapshot* snapshot_util_open(const char* path, uint32_t kind, void* descriptor, size_t descriptor_size) {
+
+	snapshot* s = NULL;
+
+	if (path && descriptor) {
+
+		s = (snapshot*)malloc(sizeof(snapshot));
+		if (s && snapshot_util_map(s, path)) {
+
+			snapshot_header header;
+			bool valid = s->size >= sizeof(snapshot_header) + descriptor_size;
+
+			if (valid) {
+
+				memcpy(&header, s->data, sizeof(snapshot_header));
+				valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == SNAPSHOT_VERSION &&
+					header.kind == kind && header.byte_order == SNAPSHOT_BYTE_ORDER && header.size_width == sizeof(size_t) &&
+					header.int_width == sizeof(int) && header.descriptor_size == descriptor_size;
+			}
+			if (valid) memcpy(descriptor, s->data + s->size - descriptor_size, descriptor_size);
+			else snapshot_util_close(&s);
+		}
+		else {
+
+			free(s);
+			s = NULL;
+		}
+	}
+	return s;
+}
+
+/**
+ * Unmaps the snapshot, every pointer into it is no longer valid
+ */
+void snapshot_util_close(snapshot** s) {
+
+	if (s && *s) {
+
+		snapshot_util_unmap(*s);
+		free(*s);
+		*s = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns a pointer to the length bytes at the given position of the snapshot,
+ * NULL if they're not all inside of it
+ */
+const void* snapshot_util_at(snapshot* s, uint64_t position, uint64_t length) {
+
+	const void* at = NULL;
+
+	if (s && position <= s->size && length <= s->size - position) at = s->data + position;
+	return at;
+}
+
+/**
+ * Reads the table at the given position of the snapshot in t, returns false if it isn't valid
+ */
+bool snapshot_util_open_table(snapshot* s, uint64_t position, snapshot_table* t) {
+
+	bool valid = false;
+	const void* at = snapshot_util_at(s, position, sizeof(snapshot_table_header));
+
+	if (at && t) {
+
+		snapshot_table_header header;
+		memcpy(&header, at, sizeof(snapshot_table_header));
+
+		size_t size = s->size - (size_t)position;
+		uint64_t stride = (header.value_size + SNAPSHOT_VALUE_ALIGNMENT - 1) / SNAPSHOT_VALUE_ALIGNMENT * SNAPSHOT_VALUE_ALIGNMENT;
+		uint64_t room = (size - sizeof(snapshot_table_header)) / sizeof(snapshot_slot);
+
+		// The slots and the values have to fit in the snapshot, and the table can't be full
+		valid = header.capacity >= SNAPSHOT_TABLE_MIN_CAPACITY && (header.capacity & (header.capacity - 1)) == 0 && header.capacity <= room &&
+			header.count < header.capacity && header.value_size < size &&
+			header.count * stride <= size - sizeof(snapshot_table_header) - header.capacity * sizeof(snapshot_slot);
+
+		if (valid) {
+
+			t->base = (const char*)at;
+			t->size = size;
+			t->slots = (const snapshot_slot*)(t->base + sizeof(snapshot_table_header));
+			t->capacity = (size_t)header.capacity;
+			t->count = (size_t)header.count;
+			t->value_size = (size_t)header.value_size;
+			t->seed = header.seed;
+		}
+	}
+	return valid;
+}
+
+/**
+ * Returns a pointer to the value mapped by the len bytes pointed to by key
+ * (whose hash, computed with the seed of the table, is h) NULL if there's none
+ *
+ * Positions are checked against the size of the table, so that a damaged
+ * snapshot can't make the lookup read outside of the mapping
+ */
+const void* snapshot_util_find(const snapshot_table* t, const void* key, size_t len, uint64_t h) {
+
+	const void* val = NULL;
+
+	if (t && key) {
+
+		size_t mask = t->capacity - 1;
+		size_t index = (size_t)h & mask;
+
+		for (size_t i = 0; i < t->capacity && t->slots[index].key != SNAPSHOT_EMPTY; i++) {
+
+			const snapshot_slot* slot = &t->slots[index];
+
+			if (slot->hash == h && slot->key_length == len && slot->key <= t->size && len <= t->size - slot->key &&
+				memcmp(t->base + slot->key, key, len) == 0) {
+
+				if (slot->value <= t->size && t->value_size <= t->size - slot->value) val = t->base + slot->value;
+				break;
+			}
+			index = (index + 1) & mask;
+		}
+	}
+	return val;
+}
+
+/**
+ * Starts writing a snapshot of the given kind in the given file (which is replaced),
+ * whose descriptor will be descriptor_size bytes long
+ */
+bool snapshot_util_begin(snapshot_writer* w, const char* path, uint32_t kind, size_t descriptor_size) {
+
+	bool started = false;
+
+	if (w && path) {
+
+		w->file = fopen(path, "wb");
+		w->path = path;
+		w->position = 0;
+		w->failed = w->file == NULL;
+
+		if (w->file) {
+
+			snapshot_header header;
+			memset(&header, 0, sizeof(snapshot_header));
+			memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+			header.version = SNAPSHOT_VERSION;
+			header.kind = kind;
+			header.byte_order = SNAPSHOT_BYTE_ORDER;
+			header.size_width = sizeof(size_t);
+			header.int_width = sizeof(int);
+			header.descriptor_size = descriptor_size;
+
+			snapshot_util_write(w, &header, sizeof(snapshot_header));
+			started = true;
+		}
+	}
+	return started;
+}
+
+/**
+ * Starts a new section, and returns its position
+ */
+uint64_t snapshot_util_section(snapshot_writer* w) {
+
+	snapshot_util_pad(w, SNAPSHOT_ALIGNMENT);
+	return w->position;
+}
+
+/**
+ * Writes length bytes at the end of the snapshot
+ */
+void snapshot_util_write(snapshot_writer* w, const void* data, size_t length) {
+
+	if (!w->failed && length > 0) {
+
+		if (data && fwrite(data, 1, length, w->file) == length) w->position += length;
+		else w->failed = true;
+	}
+	return;
+}
+
+/**
+ * Writes the n entries as a new table, and returns its position
+ *
+ * Every value is value_size bytes long, keys are hashed with hash and the given seed, and
+ * if key_positions isn't NULL the position of the key of each entry is stored in it
+ */
+uint64_t snapshot_util_write_table(snapshot_writer* w, const snapshot_entry* entries, size_t n, size_t value_size,
+	size_t (*hash)(const void*, size_t, uint64_t), uint64_t seed, uint64_t* key_positions) {
+
+	uint64_t position = snapshot_util_section(w);
+
+	// Smallest power of two that keeps the table at most 7/8 full
+	size_t capacity = SNAPSHOT_TABLE_MIN_CAPACITY;
+	while (capacity / 8 * 7 <= n && capacity <= SIZE_MAX / 2 / sizeof(snapshot_slot)) capacity *= 2;
+
+	snapshot_slot* slots = (capacity / 8 * 7 > n) ? (snapshot_slot*)malloc(capacity * sizeof(snapshot_slot)) : NULL;
+
+	if (slots && (entries || n == 0) && hash) {
+
+		size_t stride = (value_size + SNAPSHOT_VALUE_ALIGNMENT - 1) / SNAPSHOT_VALUE_ALIGNMENT * SNAPSHOT_VALUE_ALIGNMENT;
+		uint64_t values = sizeof(snapshot_table_header) + (uint64_t)capacity * sizeof(snapshot_slot);
+		uint64_t keys = values + (uint64_t)n * stride;
+		size_t mask = capacity - 1;
+
+		for (size_t i = 0; i < capacity; i++) {
+
+			slots[i].hash = 0;
+			slots[i].key = SNAPSHOT_EMPTY;
+			slots[i].key_length = 0;
+			slots[i].value = 0;
+		}
+
+		// Values and keys are written in the order of the entries
+		for (size_t i = 0; i < n; i++) {
+
+			uint64_t h = (uint64_t)hash(entries[i].key, entries[i].key_length, seed);
+			size_t index = (size_t)h & mask;
+
+			while (slots[index].key != SNAPSHOT_EMPTY) index = (index + 1) & mask;
+
+			slots[index].hash = h;
+			slots[index].key = keys;
+			slots[index].key_length = entries[i].key_length;
+			slots[index].value = values + (uint64_t)i * stride;
+
+			if (key_positions) key_positions[i] = position + keys;
+			keys += entries[i].key_length;
+		}
+
+		snapshot_table_header header = { capacity, n, value_size, seed };
+		snapshot_util_write(w, &header, sizeof(snapshot_table_header));
+		snapshot_util_write(w, slots, capacity * sizeof(snapshot_slot));
+
+		for (size_t i = 0; i < n; i++) {
+
+			snapshot_util_write(w, entries[i].value, value_size);
+			snapshot_util_pad(w, SNAPSHOT_VALUE_ALIGNMENT);
+		}
+		for (size_t i = 0; i < n; i++) snapshot_util_write(w, entries[i].key, entries[i].key_length);
+	}
+	else w->failed = true;
+
+	free(slots);
+	return position;
+}
+
+/**
+ * Ends the snapshot with its descriptor and closes the file
+ *
+ * Returns whether or not every write succeeded, the file is removed otherwise
+ */
+bool snapshot_util_end(snapshot_writer* w, const void* descriptor, size_t descriptor_size) {
+
+	bool done = false;
+
+	if (w && w->file) {
+
+		snapshot_util_pad(w, SNAPSHOT_VALUE_ALIGNMENT);
+		snapshot_util_write(w, descriptor, descriptor_size);
+
+		done = fclose(w->file) == 0 && !w->failed;
+		w->file = NULL;
+		if (!done) remove(w->path);
+	}
+	return done;
+}
+
+/* Utility function used to pad the snapshot with zeros until its length is a multiple of alignment */
+void snapshot_util_pad(snapshot_writer* w, size_t alignment) {
+
+	static const char zeros[SNAPSHOT_ALIGNMENT] = { 0 };
+
+	size_t padding = (size_t)((alignment - w->position % alignment) % alignment);
+	snapshot_util_write(w, zeros, padding);
+	return;
+}
+
+/* Utility function used to map a whole file (read-only) */
+bool snapshot_util_map(snapshot* s, const char* path) {
+
+	bool mapped = false;
+
+#if defined(_WIN32)
+	s->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	s->mapping = NULL;
+
+	LARGE_INTEGER size;
+	if (s->file != INVALID_HANDLE_VALUE && GetFileSizeEx(s->file, &size) && size.QuadPart >= (LONGLONG)sizeof(snapshot_header) &&
+		(unsigned long long)size.QuadPart <= SIZE_MAX) {
+
+		s->mapping = CreateFileMappingA(s->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		s->data = s->mapping ? (const char*)MapViewOfFile(s->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		s->size = (size_t)size.QuadPart;
+		mapped = s->data != NULL;
+	}
+	if (!mapped) {
+
+		if (s->mapping) CloseHandle(s->mapping);
+		if (s->file != INVALID_HANDLE_VALUE) CloseHandle(s->file);
+	}
+#else
+	int fd = open(path, O_RDONLY);
+	struct stat info;
+
+	if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(snapshot_header) && (unsigned long long)info.st_size <= SIZE_MAX) {
+
+		void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (data != MAP_FAILED) {
+
+			s->data = (const char*)data;
+			s->size = (size_t)info.st_size;
+			mapped = true;
+		}
+	}
+
+	// The mapping stays valid after the file is closed
+	if (fd >= 0) close(fd);
+#endif
+	return mapped;
+}
+
+/* Utility function used to unmap a file mapped by snapshot_util_map */
+void snapshot_util_unmap(snapshot* s) {
+
+#if defined(_WIN32)
+	UnmapViewOfFile(s->data);
+	CloseHandle(s->mapping);
+	CloseHandle(s->file);
+#else
+	munmap((void*)s->data, s->size);
+#endif
+	return;
+}
\ No newline at end of file
@@ -7,8 +7,12 @@
  */
 
 #include "../../include/linear/snode.h"
+#include <stdint.h>
 #include <string.h>
 
+/* Utility function that returns the array of spans, stored after the pointers */
+size_t* snode_util_spans(snode* sn);
+
 /**
  * Struct that represent a node that can store
  * a generic type value
@@ -17,6 +21,8 @@
  *
  * The node itself has two components, a value stored, and
  * an array of pointers to the nodes at the next levels
+ *
+ * The pointers, the spans and the value are stored right after the struct, in the same allocation
  */
 typedef struct snode {
 
@@ -29,17 +35,15 @@ typedef struct snode {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* Pointer to the memory location that stores the node's value
-	  *
-	  * Void* is used to accept any type of data
-	  */
-	void* ptr;
-
-	/* Array of pointers to the next nodes of the successive levels */
-	snode** forward;
-
 	/* Level the node has inside the list it is part of */
 	size_t level;
+
+	/* Number of levels the node has room for, it can't grow past them */
+	size_t max_level;
+
+	/* Array of pointers to the next nodes of the successive levels, followed by the
+	 * array of spans (how many nodes each pointer moves forward on the bottom level), and then by the value */
+	snode* forward[];
 } snode;
 
 /**
@@ -50,49 +54,37 @@ typedef struct snode {
  */
 snode* snode_create(void* value, size_t value_size, size_t level) {
 
+	return snode_create_in(NULL, value, value_size, level);
+}
+
+/**
+ * Creates a node like snode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least snode_get_footprint(value_size, level) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+snode* snode_create_in(pool* p, void* value, size_t value_size, size_t level) {
+
 	snode* sn = NULL;
 
 	// Check if the size is reasonable
-	if (0 < value_size && value_size <= SIZE_MAX && 0 < level && level <= SIZE_MAX) {
+	if (0 < value_size && 0 < level && level <= (SIZE_MAX - sizeof(snode)) / sizeof(snode*) && value_size <= SIZE_MAX - sizeof(snode) - level * sizeof(snode*)) {
 
-		// Allocate memory for the node struct
-		sn = (snode*)malloc(sizeof(snode));
+		// Allocate memory for the node struct, its pointers and its value, in one block
+		sn = (snode*)(p ? pool_alloc(p) : malloc(snode_get_footprint(value_size, level)));
 
 		// If it was allocated
 		if (sn) {
 
-			// Allocate memory for the value
-			sn->ptr = malloc(value_size);
+			// Initialize the fields
 			sn->level = level;
+			sn->max_level = level;
+			for (size_t i = 0; i < level; i++) {
 
-			// If it was allocated
-			if (sn->ptr) {
-
-				// Initialize the fields
-				memcpy(sn->ptr, value, value_size);
-
-				sn->forward = (snode**)malloc(level * sizeof(snode*));
-				for (int i = 0; i < sn->level; i++) {
-
-					sn->forward[i] = (snode*)NULL;
-				}
-
-				// Cancel the creation
-				if (!sn->forward) {
-
-					free(sn->ptr);
-					free(sn);
-					sn = NULL;
-				}
-			}
-
-			// Otherwise
-			else {
-
-				// Cancel the creation, free the memory used for the struct
-				free(sn);
-				sn = NULL;
+				sn->forward[i] = (snode*)NULL;
+				snode_util_spans(sn)[i] = 0;
 			}
+			memcpy(snode_get_value(sn), value, value_size);
 		}
 	}
 	return sn;
@@ -101,26 +93,42 @@ snode* snode_create(void* value, size_t value_size, size_t level) {
 /**
  * Deletes the given node
  *
- * It frees the memory used to store the value, then
- * the memory used for the struct itself
+ * The pointers and the value are stored with the struct
+ * so a single free releases everything
  */
 void snode_delete(snode** sn) {
 
-	if (sn && *sn) {
+	snode_delete_in(NULL, sn);
+	return;
+}
 
-		// Free the memory used to store the element
-		free((*sn)->ptr);
+/**
+ * Deletes the given node, created by snode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void snode_delete_in(pool* p, snode** sn) {
 
-		// Free the memory used for the pointers
-		free((*sn)->forward);
+	if (sn && *sn) {
 
-		// Free the memory used for the struct itself
-		free(*sn);
+		if (p) pool_free(p, *sn);
+		else free(*sn);
 		*sn = NULL;
 	}
 	return;
 }
 
+/**
+ * Returns the number of bytes used by a node with the given
+ * number of levels, storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t snode_get_footprint(size_t value_size, size_t level) {
+
+	return sizeof(snode) + level * (sizeof(snode*) + sizeof(size_t)) + value_size;
+}
+
 /**
  * Returns a pointer to the value stored in the
  * node
@@ -130,7 +138,7 @@ void snode_delete(snode** sn) {
  */
 void* snode_get_value(snode* sn) {
 
-	return sn ? sn->ptr : NULL;
+	return sn ? (void*)(snode_util_spans(sn) + sn->max_level) : NULL;
 }
 
 /**
@@ -163,9 +171,36 @@ size_t snode_get_level(snode* sn) {
 
 /**
  * Sets the level of the node inside the list it is part of
+ *
+ * It can't be more than the level the node was created with
  */
 void snode_set_level(snode* sn, size_t level) {
 
-	if (sn) sn->level = level;
+	if (sn && level <= sn->max_level) sn->level = level;
+	return;
+}
+
+/**
+ * Returns how many nodes the pointer of the given level moves forward on the bottom level
+ *
+ * Skip lists keep it up to date to find the position of a node in O(log n)
+ */
+size_t snode_get_span(snode* sn, size_t level) {
+
+	return (sn && level < sn->level) ? snode_util_spans(sn)[level] : 0;
+}
+
+/**
+ * Sets how many nodes the pointer of the given level moves forward on the bottom level
+ */
+void snode_set_span(snode* sn, size_t span, size_t level) {
+
+	if (sn && level < sn->level) snode_util_spans(sn)[level] = span;
 	return;
+}
+
+/* Utility function that returns the array of spans, stored after the pointers */
+size_t* snode_util_spans(snode* sn) {
+
+	return (size_t*)(sn->forward + sn->max_level);
 }
\ No newline at end of file
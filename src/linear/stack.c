@@ -7,8 +7,9 @@
  */
 
 #include "../../include/linear/stack.h"
-#include "../../include/linear/linkedlist.h"
+#include "../../include/linear/chunkedarray.h"
 #include <string.h>
+#include <stdint.h>
 
  /**
   * Struct that represent a stack that can store
@@ -28,8 +29,10 @@ typedef struct stack {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	/* Pointer to the actual list that implements the stack, the head of the list is the stack's top */
-	linkedlist* top;
+	/* Pointer to the chunked array that implements the stack, its last element is the stack's top
+	 * (blocks are reused, so push and pop don't reach the allocator once the stack reached its size)
+	 */
+	chunkedarray* top;
 
 } stack;
 
@@ -38,6 +41,16 @@ typedef struct stack {
  */
 stack* stack_create(size_t element_size) {
 
+	return stack_create_inline(element_size, 0);
+}
+
+/**
+ *  Creates a stack whose first inline_length elements are stored in the same allocation as its chunked array
+ *
+ * Meant for stacks that stay small, see ca_create_inline
+ */
+stack* stack_create_inline(size_t element_size, size_t inline_length) {
+
 	stack* s = NULL;
 	
 	// If the size is reasonable
@@ -46,12 +59,12 @@ stack* stack_create(size_t element_size) {
 		// Create the struct
 		s = (stack*)malloc(sizeof(stack));
 
-		// If it was created, create the actual list (stack)
+		// If it was created, create the actual chunked array (stack)
 		if (s) {
 
-			s->top = ll_create(element_size);
+			s->top = ca_create_inline(element_size, inline_length);
 
-			// If the list was not created, cancel the creation
+			// If the chunked array was not created, cancel the creation
 			if (!s->top) {
 				free(s);
 				s = NULL;
@@ -73,7 +86,7 @@ void stack_delete(stack** s) {
 	if (s && *s) {
 
 		// Delete the struct holding the elements, this will delete each element as well
-		ll_delete(&((*s)->top));
+		ca_delete(&((*s)->top));
 		(*s)->top = NULL;
 
 		// Free the memory for the actual struct
@@ -91,7 +104,7 @@ void stack_push(stack* s, void* x) {
 	if (s && x) {
 
 		// Pushing in a stack means inserting at the top
-		ll_insert_head(s->top, x);
+		ca_push_back(s->top, x);
 	}
 	return;
 }
@@ -103,29 +116,22 @@ void* stack_pop(stack* s) {
 	
 	void* val = NULL;
 
-	if (s) {
-
-		val = malloc(ll_get_element_size(s->top));
+	if (s && !ca_is_empty(s->top)) {
 
-		if (val) {
-		
-			memcpy(val, ll_get_head(s->top), ll_get_element_size(s->top));
-			ll_remove_head(s->top);
-		}
+		val = malloc(ca_get_element_size(s->top));
+		if (val) ca_pop_2_back(s->top, val);
 	}
 	return val;
 }
 
 /**
  * Removes an element from the stack and copies it in the given buffer
+ *
+ * Nothing is allocated, this is the way to go when popping often
  */
 void stack_pop_2(stack* s, void* buf) {
 
-	if (s && buf) {
-
-		ll_get_2_head(s->top, buf);
-		ll_remove_head(s->top);
-	}
+	if (s && buf) ca_pop_2_back(s->top, buf);
 
 	return;
 }
@@ -135,7 +141,7 @@ void stack_pop_2(stack* s, void* buf) {
  */
 void* stack_peek(stack* s) {
 
-	return s ? ll_get_head(s->top) : NULL;
+	return s ? ca_get_back(s->top) : NULL;
 }
 
 /**
@@ -143,7 +149,7 @@ void* stack_peek(stack* s) {
  */
 void stack_peek_2(stack* s, void* buf) {
 
-	if (s && buf) ll_get_2_head(s->top, buf);
+	if (s && buf && !ca_is_empty(s->top)) memcpy(buf, ca_get_back(s->top), ca_get_element_size(s->top));
 	return;
 }
 
@@ -152,7 +158,7 @@ void stack_peek_2(stack* s, void* buf) {
  */
 size_t stack_get_size(stack* s) {
 
-	return s ? ll_get_size(s->top) : 0;
+	return s ? ca_get_size(s->top) : 0;
 }
 
 /**
@@ -160,7 +166,7 @@ size_t stack_get_size(stack* s) {
  */
 size_t stack_get_element_size(stack* s) {
 
-	return s ? ll_get_element_size(s->top) : 0;
+	return s ? ca_get_element_size(s->top) : 0;
 }
 
 /**
@@ -169,7 +175,7 @@ size_t stack_get_element_size(stack* s) {
  */
 void stack_clear(stack* s) {
 
-	if (s) ll_clear(s->top);
+	if (s) ca_clear(s->top);
 	return;
 }
 
@@ -178,5 +184,5 @@ void stack_clear(stack* s) {
  */
 bool stack_is_empty(stack* s) {
 
-	return s ? ll_is_empty(s->top) : false;
+	return s ? ca_is_empty(s->top) : false;
 }
\ No newline at end of file
@@ -0,0 +1,635 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/threadpool.h"
+#include "../../include/linear/deque.h"
+#include <stdint.h>
+#include <threads.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/* Size of a cache line, the ends of the queue of a worker are kept on different ones */
+#define TP_CACHE_LINE 64
+
+/* Number of tasks the queue of a worker can hold before it needs to grow (a power of two) */
+#define TP_DEQUE_INITIAL_SIZE 64
+
+/* Number of times an idle worker looks for tasks before it goes to sleep */
+#define TP_SPINS 64
+
+/**
+ * Task waiting to be run, with the group it belongs to
+ */
+typedef struct tp_task {
+
+	void (*fn)(void*);
+	void* arg;
+	tp_group* group;
+} tp_task;
+
+/**
+ * Circular array of tasks used by the queue of a worker
+ *
+ * When the queue grows, the old array is kept (linked from the new one) until
+ * the pool is deleted, since a thief could still be reading it
+ */
+typedef struct tp_array {
+
+	struct tp_array* previous;
+	int64_t size;
+	_Atomic(tp_task*) slots[];
+} tp_array;
+
+/**
+ * Chase-Lev queue of a worker
+ *
+ * Only the owner pushes and takes at the bottom, every other thread steals from the top,
+ * a compare and swap on the top is needed only when the two ends could meet
+ */
+typedef struct tp_deque {
+
+	_Atomic int64_t top;
+	char top_padding[TP_CACHE_LINE - sizeof(int64_t)];
+
+	_Atomic int64_t bottom;
+	char bottom_padding[TP_CACHE_LINE - sizeof(int64_t)];
+
+	_Atomic(tp_array*) array;
+} tp_deque;
+
+/**
+ * Worker thread of a pool, with its own queue
+ */
+typedef struct tp_worker {
+
+	threadpool* tp;
+	size_t index;
+	thrd_t handle;
+	tp_deque deque;
+
+	/* State of the generator used to choose whom to steal from */
+	uint64_t random_state;
+} tp_worker;
+
+/**
+ * Struct that represent a pool of worker threads that run tasks
+ */
+typedef struct threadpool {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as changing the number of workers while they're running
+	 */
+
+	tp_worker* workers;
+	size_t threads;
+
+	/* Tasks submitted by threads that aren't workers of the pool */
+	deque* shared;
+	mtx_t shared_lock;
+
+	/* Number of tasks queued (anywhere) and not taken yet, and of workers sleeping */
+	atomic_size_t queued;
+	atomic_size_t sleeping;
+
+	/* Idle workers sleep on cond, stop is set when the pool is deleted */
+	mtx_t sleep_lock;
+	cnd_t cond;
+	atomic_bool stop;
+} threadpool;
+
+/* Worker the calling thread is (NULL for threads that aren't workers of any pool) */
+static _Thread_local tp_worker* tp_current_worker = NULL;
+
+/* Pool shared by the whole library, created once, and the number of workers it will have (0 for one per processor) */
+static threadpool* tp_shared = NULL;
+static once_flag tp_shared_once = ONCE_FLAG_INIT;
+static atomic_size_t tp_shared_threads = 0;
+
+/* Piece of the range of a tp_parallel_for */
+typedef struct tp_range {
+
+	parallel_body body;
+	void* context;
+	size_t from;
+	size_t to;
+	size_t grain;
+	tp_group* group;
+} tp_range;
+
+/* Utility functions used to manage the queue of a worker */
+bool tp_util_deque_init(tp_deque* d);
+void tp_util_deque_free(tp_deque* d);
+bool tp_util_deque_push(tp_deque* d, tp_task* t);
+tp_task* tp_util_deque_take(tp_deque* d);
+tp_task* tp_util_deque_steal(tp_deque* d);
+
+/* Utility functions used to find a task for the calling thread (w is NULL if it isn't a worker) and run it */
+tp_task* tp_util_find(threadpool* tp, tp_worker* w);
+void tp_util_execute(tp_task* t);
+
+/* Utility function used as the body of the workers */
+int tp_util_worker(void* arg);
+
+/* Utility function used to create the shared pool */
+void tp_util_create_shared(void);
+
+/* Utility function that returns the number of processors */
+size_t tp_util_hardware_threads(void);
+
+/* Utility function used to run a piece of the range of a tp_parallel_for, splitting it first */
+void tp_util_range(void* arg);
+
+/**
+ * Creates a pool with the given number of worker threads, 0 means one for each processor
+ */
+threadpool* tp_create(size_t threads) {
+
+	threadpool* tp = NULL;
+
+	if (threads == 0) threads = tp_util_hardware_threads();
+	if (threads <= SIZE_MAX / sizeof(tp_worker)) {
+
+		tp = (threadpool*)malloc(sizeof(threadpool));
+		if (tp) {
+
+			tp->threads = 0;
+			tp->workers = (tp_worker*)malloc(threads * sizeof(tp_worker));
+			tp->shared = deque_create(sizeof(tp_task*));
+			atomic_init(&tp->queued, 0);
+			atomic_init(&tp->sleeping, 0);
+			atomic_init(&tp->stop, false);
+
+			bool shared_lock = mtx_init(&tp->shared_lock, mtx_plain) == thrd_success;
+			bool sleep_lock = mtx_init(&tp->sleep_lock, mtx_plain) == thrd_success;
+			bool cond = cnd_init(&tp->cond) == thrd_success;
+			bool ready = tp->workers && tp->shared && shared_lock && sleep_lock && cond;
+
+			// Every queue is ready before any worker starts, since workers steal from each other
+			size_t initialized = 0;
+			for (; ready && initialized < threads; initialized++) {
+
+				tp_worker* w = &tp->workers[initialized];
+				w->tp = tp;
+				w->index = initialized;
+				w->random_state = 0x9E3779B97F4A7C15ULL * (initialized + 1);
+				ready = tp_util_deque_init(&w->deque);
+				if (!ready) break;
+			}
+
+			// Start the workers, if one of them can't be started the ones already running are stopped
+			if (ready) {
+
+				size_t started = 0;
+				tp->threads = threads;
+				while (started < threads && thrd_create(&tp->workers[started].handle, tp_util_worker, &tp->workers[started]) == thrd_success) started++;
+
+				if (started < threads) {
+
+					mtx_lock(&tp->sleep_lock);
+					atomic_store(&tp->stop, true);
+					cnd_broadcast(&tp->cond);
+					mtx_unlock(&tp->sleep_lock);
+					for (size_t i = 0; i < started; i++) thrd_join(tp->workers[i].handle, NULL);
+					ready = false;
+				}
+			}
+
+			if (!ready) {
+				for (size_t i = 0; i < initialized; i++) tp_util_deque_free(&tp->workers[i].deque);
+				if (cond) cnd_destroy(&tp->cond);
+				if (sleep_lock) mtx_destroy(&tp->sleep_lock);
+				if (shared_lock) mtx_destroy(&tp->shared_lock);
+				deque_delete(&tp->shared);
+				free(tp->workers);
+				free(tp);
+				tp = NULL;
+			}
+		}
+	}
+	return tp;
+}
+
+/**
+ * Deletes the given pool, waiting for the workers to finish the task they're running
+ *
+ * The tasks that are still queued are not run, so every group should be waited for first
+ */
+void tp_delete(threadpool** tp) {
+
+	if (tp && *tp) {
+
+		threadpool* p = *tp;
+
+		// Wake up every worker, they exit as soon as they see stop
+		mtx_lock(&p->sleep_lock);
+		atomic_store(&p->stop, true);
+		cnd_broadcast(&p->cond);
+		mtx_unlock(&p->sleep_lock);
+
+		for (size_t i = 0; i < p->threads; i++) thrd_join(p->workers[i].handle, NULL);
+
+		// Free the tasks nobody took
+		for (size_t i = 0; i < p->threads; i++) {
+
+			tp_task* t;
+			while ((t = tp_util_deque_take(&p->workers[i].deque)) != NULL) free(t);
+			tp_util_deque_free(&p->workers[i].deque);
+		}
+		while (!deque_is_empty(p->shared)) {
+
+			tp_task* t;
+			deque_pop_2_front(p->shared, &t);
+			free(t);
+		}
+
+		deque_delete(&p->shared);
+		cnd_destroy(&p->cond);
+		mtx_destroy(&p->sleep_lock);
+		mtx_destroy(&p->shared_lock);
+		free(p->workers);
+		free(p);
+		*tp = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns the pool shared by the whole library (used by parallel_util_for), created the first
+ * time it's needed with one worker for each processor, or as many as set by tp_set_shared_threads
+ *
+ * It is never deleted, NULL is returned if it couldn't be created
+ */
+threadpool* tp_get_shared(void) {
+
+	call_once(&tp_shared_once, tp_util_create_shared);
+	return tp_shared;
+}
+
+/**
+ * Sets the number of workers of the shared pool, it has effect only if called before it is created
+ */
+void tp_set_shared_threads(size_t threads) {
+
+	atomic_store(&tp_shared_threads, threads);
+	return;
+}
+
+/**
+ * Returns the number of worker threads of the pool
+ */
+size_t tp_get_threads(threadpool* tp) {
+
+	return tp ? tp->threads : 0;
+}
+
+/**
+ * Prepares the group to hold tasks run by the given pool
+ */
+void tp_group_init(threadpool* tp, tp_group* g) {
+
+	if (g) {
+		g->tp = tp;
+		atomic_init(&g->pending, 0);
+	}
+	return;
+}
+
+/**
+ * Runs task(arg) in the pool, as part of the group g
+ *
+ * If memory for the task can't be allocated, it is run right away by the calling thread
+ */
+void tp_group_run(tp_group* g, void (*task)(void*), void* arg) {
+
+	if (g && task) {
+
+		threadpool* tp = g->tp;
+		tp_task* t = tp ? (tp_task*)malloc(sizeof(tp_task)) : NULL;
+		bool queued = false;
+
+		if (t) {
+
+			t->fn = task;
+			t->arg = arg;
+			t->group = g;
+			atomic_fetch_add_explicit(&g->pending, 1, memory_order_relaxed);
+
+			// Workers of the pool use their own queue, every other thread the shared one
+			tp_worker* w = tp_current_worker;
+			if (w && w->tp == tp) queued = tp_util_deque_push(&w->deque, t);
+			else {
+				mtx_lock(&tp->shared_lock);
+				size_t size = deque_get_size(tp->shared);
+				deque_push_back(tp->shared, &t);
+				queued = deque_get_size(tp->shared) > size;
+				mtx_unlock(&tp->shared_lock);
+			}
+
+			if (queued) {
+
+				// A worker checks queued after announcing it is going to sleep, so either it sees this task or it is woken up
+				atomic_fetch_add(&tp->queued, 1);
+				if (atomic_load(&tp->sleeping) > 0) {
+
+					mtx_lock(&tp->sleep_lock);
+					cnd_signal(&tp->cond);
+					mtx_unlock(&tp->sleep_lock);
+				}
+			}
+			else {
+				atomic_fetch_sub_explicit(&g->pending, 1, memory_order_relaxed);
+				free(t);
+			}
+		}
+
+		if (!queued) task(arg);
+	}
+	return;
+}
+
+/**
+ * Waits until every task of the group (and the ones they added to it) finished
+ *
+ * The calling thread runs queued tasks in the meantime (of any group), so
+ * tasks can wait for the groups they create without exhausting the workers
+ */
+void tp_group_wait(tp_group* g) {
+
+	if (g && g->tp) {
+
+		tp_worker* w = (tp_current_worker && tp_current_worker->tp == g->tp) ? tp_current_worker : NULL;
+
+		while (atomic_load_explicit(&g->pending, memory_order_acquire) > 0) {
+
+			tp_task* t = tp_util_find(g->tp, w);
+			if (t) tp_util_execute(t);
+			else thrd_yield();
+		}
+	}
+	return;
+}
+
+/**
+ * Applies body to the indices from 0 to n using the pool, the range is split in half
+ * recursively until the pieces have at most grain indices, and returns when every piece is done
+ *
+ * The two halves of each split can be run by different threads, so body must only
+ * write data that belongs to its range
+ */
+void tp_parallel_for(threadpool* tp, size_t n, size_t grain, parallel_body body, void* context) {
+
+	if (body && n > 0) {
+
+		tp_range* root = tp ? (tp_range*)malloc(sizeof(tp_range)) : NULL;
+
+		if (root) {
+
+			tp_group g;
+			tp_group_init(tp, &g);
+
+			root->body = body;
+			root->context = context;
+			root->from = 0;
+			root->to = n;
+			root->grain = grain > 0 ? grain : 1;
+			root->group = &g;
+
+			// The calling thread works on the first half of every split, and then helps with the rest
+			tp_util_range(root);
+			tp_group_wait(&g);
+		}
+		else body(context, 0, n);
+	}
+	return;
+}
+
+/* Utility function used to prepare the (empty) queue of a worker */
+bool tp_util_deque_init(tp_deque* d) {
+
+	tp_array* a = (tp_array*)malloc(sizeof(tp_array) + TP_DEQUE_INITIAL_SIZE * sizeof(_Atomic(tp_task*)));
+
+	if (a) {
+		a->previous = NULL;
+		a->size = TP_DEQUE_INITIAL_SIZE;
+		atomic_init(&d->top, 0);
+		atomic_init(&d->bottom, 0);
+		atomic_init(&d->array, a);
+	}
+	return a != NULL;
+}
+
+/* Utility function used to free the arrays of the queue of a worker (the current one and the old ones) */
+void tp_util_deque_free(tp_deque* d) {
+
+	tp_array* a = atomic_load_explicit(&d->array, memory_order_relaxed);
+
+	while (a) {
+		tp_array* previous = a->previous;
+		free(a);
+		a = previous;
+	}
+	atomic_store_explicit(&d->array, NULL, memory_order_relaxed);
+	return;
+}
+
+/* Utility function used by the owner to push a task at the bottom of its queue, growing it if it's full */
+bool tp_util_deque_push(tp_deque* d, tp_task* t) {
+
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+	int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+	tp_array* a = atomic_load_explicit(&d->array, memory_order_relaxed);
+
+	if (b - top > a->size - 1) {
+
+		// Double the array, copying the live tasks at the same positions (modulo the new size)
+		tp_array* bigger = (a->size <= INT64_MAX / 2) ? (tp_array*)malloc(sizeof(tp_array) + 2 * a->size * sizeof(_Atomic(tp_task*))) : NULL;
+		if (!bigger) return false;
+
+		bigger->previous = a;
+		bigger->size = 2 * a->size;
+		for (int64_t i = top; i < b; i++)
+			atomic_store_explicit(&bigger->slots[i & (bigger->size - 1)], atomic_load_explicit(&a->slots[i & (a->size - 1)], memory_order_relaxed), memory_order_relaxed);
+
+		atomic_store_explicit(&d->array, bigger, memory_order_release);
+		a = bigger;
+	}
+
+	atomic_store_explicit(&a->slots[b & (a->size - 1)], t, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+	return true;
+}
+
+/* Utility function used by the owner to take the newest task from the bottom of its queue, NULL if it's empty */
+tp_task* tp_util_deque_take(tp_deque* d) {
+
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+	tp_array* a = atomic_load_explicit(&d->array, memory_order_relaxed);
+	tp_task* t = NULL;
+
+	atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t top = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+	if (top <= b) {
+
+		t = atomic_load_explicit(&a->slots[b & (a->size - 1)], memory_order_relaxed);
+
+		// Last task, a thief could be taking it at the same time
+		if (top == b) {
+			if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) t = NULL;
+			atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+		}
+	}
+	else atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+
+	return t;
+}
+
+/* Utility function used by the other threads to steal the oldest task from the top of a queue, NULL if it's empty or another thread won it */
+tp_task* tp_util_deque_steal(tp_deque* d) {
+
+	int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+	tp_task* t = NULL;
+
+	if (top < b) {
+
+		tp_array* a = atomic_load_explicit(&d->array, memory_order_acquire);
+		t = atomic_load_explicit(&a->slots[top & (a->size - 1)], memory_order_relaxed);
+		if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) t = NULL;
+	}
+	return t;
+}
+
+/* Utility function that finds a task for the calling thread (w is NULL if it isn't a worker): its own queue first, then the other workers, then the shared queue */
+tp_task* tp_util_find(threadpool* tp, tp_worker* w) {
+
+	tp_task* t = w ? tp_util_deque_take(&w->deque) : NULL;
+
+	if (!t && tp->threads > 0) {
+
+		// Start from a random victim, so that thieves don't all go after the same worker
+		size_t start = 0;
+		if (w) {
+			w->random_state ^= w->random_state >> 12;
+			w->random_state ^= w->random_state << 25;
+			w->random_state ^= w->random_state >> 27;
+			start = (size_t)((w->random_state * 0x2545F4914F6CDD1DULL) >> 32) % tp->threads;
+		}
+		for (size_t i = 0; i < tp->threads && !t; i++) {
+
+			tp_worker* victim = &tp->workers[(start + i) % tp->threads];
+			if (victim != w) t = tp_util_deque_steal(&victim->deque);
+		}
+	}
+
+	if (!t) {
+		mtx_lock(&tp->shared_lock);
+		if (!deque_is_empty(tp->shared)) deque_pop_2_front(tp->shared, &t);
+		mtx_unlock(&tp->shared_lock);
+	}
+
+	if (t) atomic_fetch_sub(&tp->queued, 1);
+	return t;
+}
+
+/* Utility function used to run a task and tell its group it finished */
+void tp_util_execute(tp_task* t) {
+
+	tp_group* g = t->group;
+
+	t->fn(t->arg);
+	free(t);
+	atomic_fetch_sub_explicit(&g->pending, 1, memory_order_release);
+	return;
+}
+
+/* Utility function used as the body of the workers, runs tasks until the pool is deleted */
+int tp_util_worker(void* arg) {
+
+	tp_worker* w = (tp_worker*)arg;
+	threadpool* tp = w->tp;
+	size_t spins = 0;
+
+	tp_current_worker = w;
+	while (!atomic_load_explicit(&tp->stop, memory_order_acquire)) {
+
+		tp_task* t = tp_util_find(tp, w);
+		if (t) {
+			tp_util_execute(t);
+			spins = 0;
+		}
+		else if (++spins < TP_SPINS) thrd_yield();
+		else {
+
+			// Announce the sleep first, then check again, so that a task submitted in the meantime isn't missed
+			mtx_lock(&tp->sleep_lock);
+			atomic_fetch_add(&tp->sleeping, 1);
+			if (atomic_load(&tp->queued) == 0 && !atomic_load(&tp->stop)) cnd_wait(&tp->cond, &tp->sleep_lock);
+			atomic_fetch_sub(&tp->sleeping, 1);
+			mtx_unlock(&tp->sleep_lock);
+			spins = 0;
+		}
+	}
+	tp_current_worker = NULL;
+	return 0;
+}
+
+/* Utility function used to create the shared pool */
+void tp_util_create_shared(void) {
+
+	tp_shared = tp_create(atomic_load(&tp_shared_threads));
+	return;
+}
+
+/* Utility function that returns the number of processors (1 if it can't be known) */
+size_t tp_util_hardware_threads(void) {
+
+	size_t threads = 1;
+
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	threads = (size_t)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+	if (online > 0) threads = (size_t)online;
+#endif
+
+	return threads > 0 ? threads : 1;
+}
+
+/* Utility function used to run a piece of the range of a tp_parallel_for, the second half of every split becomes a new task */
+void tp_util_range(void* arg) {
+
+	tp_range* r = (tp_range*)arg;
+
+	while (r->to - r->from > r->grain) {
+
+		tp_range* half = (tp_range*)malloc(sizeof(tp_range));
+		if (!half) break;
+
+		*half = *r;
+		half->from = r->from + (r->to - r->from) / 2;
+		r->to = half->from;
+		tp_group_run(r->group, tp_util_range, half);
+	}
+	r->body(r->context, r->from, r->to);
+	free(r);
+	return;
+}
\ No newline at end of file
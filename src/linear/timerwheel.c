@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/timerwheel.h"
+#include "../../include/linear/dnode.h"
+#include "../../include/linear/vector.h"
+#include <string.h>
+
+/* Levels of the wheel, and slots of every level (a slot of level i spans 256^i ticks) */
+#define TW_LEVELS 4
+#define TW_SLOT_BITS 8
+#define TW_SLOTS (1 << TW_SLOT_BITS)
+
+/* Furthest deadline (from the current time) a timer can wait for without being clamped */
+#define TW_MAX_DELAY ((((uint64_t)1) << (TW_LEVELS * TW_SLOT_BITS)) - 1)
+
+/* Elements passed to the expire callback at a time */
+#define TW_BATCH_SIZE 64
+
+/* Initial capacity of the vectors of handles */
+#define TW_MIN_CAPACITY 16
+
+/**
+ * Header stored in every node, the element follows it
+ */
+typedef struct tw_timer {
+
+	/* Tick the timer expires at */
+	uint64_t deadline;
+
+	/* Handle of the timer */
+	size_t handle;
+
+	/* Slot (level * TW_SLOTS + index) the node is in */
+	size_t bucket;
+} tw_timer;
+
+/* Size of the header, padded so that elements are aligned */
+#define TW_TIMER_SIZE ((sizeof(tw_timer) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*))
+
+/* Utility functions that link the node in the slot its deadline (but not before earliest) falls in, and unlink it from its slot */
+void tw_util_link(timerwheel* tw, dnode* node, uint64_t earliest);
+void tw_util_unlink(timerwheel* tw, dnode* node);
+
+/* Utility function that moves every timer of the given slot to the slot (of a lower level) its deadline falls in now */
+void tw_util_cascade(timerwheel* tw, size_t bucket);
+
+/* Utility function that expires every timer of the given slot, filling the batch */
+size_t tw_util_expire(timerwheel* tw, size_t bucket, void (*expire)(void*, size_t, void*), void* context);
+
+/* Utility function that passes the elements in the batch to the expire callback */
+void tw_util_flush(timerwheel* tw, void (*expire)(void*, size_t, void*), void* context);
+
+/* Utility function that frees the node of a timer, and its handle */
+void tw_util_release(timerwheel* tw, dnode* node);
+
+/* Utility function that returns the node of the timer with the given handle, NULL if it's not scheduled */
+dnode* tw_util_find(timerwheel* tw, size_t handle);
+
+/**
+ * Struct that represent a hierarchical timing wheel of timers of generic type
+ */
+typedef struct timerwheel {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* First node of every slot, the slots of level i are at i * TW_SLOTS ... i * TW_SLOTS + TW_SLOTS - 1 */
+	dnode* buckets[TW_LEVELS * TW_SLOTS];
+
+	/* Number of timers in the slots of every level */
+	size_t level_counts[TW_LEVELS];
+
+	/* Node of every handle (NULL if the handle isn't in use) */
+	vector* nodes_by_handle;
+
+	/* Handles that aren't in use anymore, given to the next timers */
+	vector* free_handles;
+
+	/* Pool the nodes are taken from */
+	pool* nodes;
+
+	/* Header and element being scheduled, and elements waiting to be passed to the expire callback */
+	char* scratch;
+	char* batch;
+	size_t batch_count;
+
+	/* Last tick that was processed */
+	uint64_t current;
+
+	/* Number of scheduled timers */
+	size_t count;
+
+	/* Size of the elements stored in the wheel */
+	size_t element_size;
+} timerwheel;
+
+/**
+ * Creates a timing wheel that stores elements that are as big as element_size, whose time starts at now
+ */
+timerwheel* tw_create(size_t element_size, uint64_t now) {
+
+	timerwheel* tw = NULL;
+
+	if (0 < element_size && element_size <= (SIZE_MAX - TW_TIMER_SIZE) / TW_BATCH_SIZE) {
+
+		tw = (timerwheel*)malloc(sizeof(timerwheel));
+		if (tw) {
+
+			tw->nodes_by_handle = vec_create(TW_MIN_CAPACITY, sizeof(dnode*));
+			tw->free_handles = vec_create(TW_MIN_CAPACITY, sizeof(size_t));
+			tw->nodes = pool_create(dnode_get_footprint(TW_TIMER_SIZE + element_size));
+			tw->scratch = (char*)malloc(TW_TIMER_SIZE + element_size);
+			tw->batch = (char*)malloc(TW_BATCH_SIZE * element_size);
+
+			if (tw->nodes_by_handle && tw->free_handles && tw->nodes && tw->scratch && tw->batch) {
+
+				memset(tw->buckets, 0, sizeof(tw->buckets));
+				memset(tw->level_counts, 0, sizeof(tw->level_counts));
+				tw->batch_count = 0;
+				tw->current = now;
+				tw->count = 0;
+				tw->element_size = element_size;
+			}
+			else {
+
+				vec_delete(&tw->nodes_by_handle);
+				vec_delete(&tw->free_handles);
+				pool_delete(&tw->nodes);
+				free(tw->scratch);
+				free(tw->batch);
+				free(tw);
+				tw = NULL;
+			}
+		}
+	}
+	return tw;
+}
+
+/**
+ * Deletes the given timing wheel, the timers still in it are dropped
+ */
+void tw_delete(timerwheel** tw) {
+
+	if (tw && *tw) {
+
+		vec_delete(&(*tw)->nodes_by_handle);
+		vec_delete(&(*tw)->free_handles);
+		pool_delete(&(*tw)->nodes);
+		free((*tw)->scratch);
+		free((*tw)->batch);
+		memset(*tw, 0, sizeof(timerwheel));
+		free(*tw);
+		*tw = NULL;
+	}
+	return;
+}
+
+/**
+ * Schedules a copy of the element pointed to by x, to expire at the given deadline (in ticks),
+ * and returns its handle (TW_NO_HANDLE if it couldn't be scheduled)
+ *
+ * Deadlines that are already passed expire on the next tick
+ */
+size_t tw_schedule(timerwheel* tw, uint64_t deadline, void* x) {
+
+	size_t handle = TW_NO_HANDLE;
+
+	if (tw && x) {
+
+		dnode* node = NULL;
+		size_t handles = vec_get_length(tw->nodes_by_handle);
+
+		// A free handle, or a new one at the end
+		if (vec_get_length(tw->free_handles) > 0) vec_pop_2_back(tw->free_handles, &handle);
+		else {
+
+			vec_push_back(tw->nodes_by_handle, &node);
+			if (vec_get_length(tw->nodes_by_handle) > handles) handle = handles;
+		}
+
+		if (handle != TW_NO_HANDLE) {
+
+			tw_timer* timer = (tw_timer*)tw->scratch;
+			timer->deadline = deadline;
+			timer->handle = handle;
+			memcpy(tw->scratch + TW_TIMER_SIZE, x, tw->element_size);
+
+			node = dnode_create_in(tw->nodes, tw->scratch, TW_TIMER_SIZE + tw->element_size);
+			if (node) {
+
+				vec_insert_at(tw->nodes_by_handle, &node, handle);
+				tw_util_link(tw, node, tw->current + 1);
+				tw->count++;
+			}
+			else {
+
+				vec_push_back(tw->free_handles, &handle);
+				handle = TW_NO_HANDLE;
+			}
+		}
+	}
+	return handle;
+}
+
+/**
+ * Moves the timer with the given handle to a new deadline
+ *
+ * Returns whether or not the timer was still scheduled
+ */
+bool tw_reschedule(timerwheel* tw, size_t handle, uint64_t deadline) {
+
+	dnode* node = tw_util_find(tw, handle);
+
+	if (node) {
+
+		tw_util_unlink(tw, node);
+		((tw_timer*)dnode_get_value(node))->deadline = deadline;
+		tw_util_link(tw, node, tw->current + 1);
+	}
+	return node != NULL;
+}
+
+/**
+ * Cancels the timer with the given handle, its element is dropped
+ *
+ * Returns whether or not the timer was still scheduled
+ */
+bool tw_cancel(timerwheel* tw, size_t handle) {
+
+	dnode* node = tw_util_find(tw, handle);
+
+	if (node) {
+
+		tw_util_unlink(tw, node);
+		tw_util_release(tw, node);
+	}
+	return node != NULL;
+}
+
+/**
+ * Moves the time of the wheel forward to now, the timers whose deadline is reached
+ * expire and their elements are passed to expire in batches: every call gets n
+ * (contiguous) elements, context is passed to each call
+ *
+ * The handles of the expired timers are free before expire is called, so expire
+ * can schedule new timers (they expire on a later call) but not advance the wheel
+ *
+ * Returns the number of expired timers
+ */
+size_t tw_advance(timerwheel* tw, uint64_t now, void (*expire)(void* elements, size_t n, void* context), void* context) {
+
+	size_t expired = 0;
+
+	if (tw && expire) {
+
+		while (tw->current < now) {
+
+			// Nothing left to expire, the remaining ticks can be skipped at once
+			if (tw->count == 0) {
+
+				tw->current = now;
+				break;
+			}
+
+			/* The levels below the first one with timers are empty, so nothing
+			 * happens until the next slot of that level is reached
+			 */
+			size_t first = 0;
+			while (first < TW_LEVELS - 1 && tw->level_counts[first] == 0) first++;
+
+			if (first > 0) {
+
+				uint64_t skipped = tw->current | (((uint64_t)1 << (first * TW_SLOT_BITS)) - 1);
+				if (skipped >= now) {
+
+					tw->current = now;
+					break;
+				}
+				tw->current = skipped;
+			}
+
+			uint64_t tick = ++tw->current;
+
+			/* Every 256^i ticks the next slot of level i is reached, its timers move
+			 * down (lower levels first, so that they don't land in a slot already passed)
+			 */
+			for (size_t level = 1; level < TW_LEVELS && (tick & (((uint64_t)1 << (level * TW_SLOT_BITS)) - 1)) == 0; level++) {
+
+				tw_util_cascade(tw, level * TW_SLOTS + ((tick >> (level * TW_SLOT_BITS)) & (TW_SLOTS - 1)));
+			}
+
+			expired += tw_util_expire(tw, tick & (TW_SLOTS - 1), expire, context);
+		}
+		tw_util_flush(tw, expire, context);
+	}
+	return expired;
+}
+
+/**
+ * Returns a pointer to the element of the timer with the given handle, NULL if it's not scheduled
+ */
+void* tw_get(timerwheel* tw, size_t handle) {
+
+	dnode* node = tw_util_find(tw, handle);
+	return node ? (char*)dnode_get_value(node) + TW_TIMER_SIZE : NULL;
+}
+
+/**
+ * Returns the deadline of the timer with the given handle, 0 if it's not scheduled
+ */
+uint64_t tw_get_deadline(timerwheel* tw, size_t handle) {
+
+	dnode* node = tw_util_find(tw, handle);
+	return node ? ((tw_timer*)dnode_get_value(node))->deadline : 0;
+}
+
+/**
+ * Checks whether or not the timer with the given handle is scheduled
+ *
+ * Handles of timers that expired or were cancelled are given to new timers
+ */
+bool tw_contains(timerwheel* tw, size_t handle) {
+
+	return tw_util_find(tw, handle) != NULL;
+}
+
+/**
+ * Returns the current time of the wheel
+ */
+uint64_t tw_get_time(timerwheel* tw) {
+
+	return tw ? tw->current : 0;
+}
+
+/**
+ * Returns the number of scheduled timers
+ */
+size_t tw_get_count(timerwheel* tw) {
+
+	return tw ? tw->count : 0;
+}
+
+/**
+ * Returns the size of the elements stored in the wheel
+ */
+size_t tw_get_element_size(timerwheel* tw) {
+
+	return tw ? tw->element_size : 0;
+}
+
+/**
+ * Checks whether or not there are no scheduled timers
+ */
+bool tw_is_empty(timerwheel* tw) {
+
+	return tw_get_count(tw) == 0;
+}
+
+/**
+ * Drops every timer, the time of the wheel stays the same
+ */
+void tw_clear(timerwheel* tw) {
+
+	if (tw) {
+
+		memset(tw->buckets, 0, sizeof(tw->buckets));
+		memset(tw->level_counts, 0, sizeof(tw->level_counts));
+		vec_resize(tw->nodes_by_handle, 0);
+		vec_resize(tw->free_handles, 0);
+		pool_clear(tw->nodes);
+		tw->batch_count = 0;
+		tw->count = 0;
+	}
+	return;
+}
+
+/**
+ * Copies in stats the allocation counters of the nodes of the timers
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ */
+void tw_get_stats(timerwheel* tw, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (tw) pool_add_stats(tw->nodes, stats);
+	}
+	return;
+}
+
+/**
+ * Links the node at the head of the slot its deadline falls in, deadlines before earliest
+ * are moved to it (the next tick, or the tick being processed while timers move down)
+ *
+ * The level is the first one whose span (256^(level + 1) ticks) covers the time left,
+ * the index is the digit (in base 256) of the deadline at that level
+ */
+void tw_util_link(timerwheel* tw, dnode* node, uint64_t earliest) {
+
+	tw_timer* timer = (tw_timer*)dnode_get_value(node);
+
+	// Deadlines already passed expire as soon as possible, the ones too far wait in level 3
+	uint64_t deadline = timer->deadline > earliest ? timer->deadline : earliest;
+	uint64_t delay = deadline - tw->current;
+	if (delay > TW_MAX_DELAY) {
+
+		delay = TW_MAX_DELAY;
+		deadline = tw->current + delay;
+	}
+
+	size_t level = 0;
+	while (level < TW_LEVELS - 1 && delay >> ((level + 1) * TW_SLOT_BITS) != 0) level++;
+
+	timer->bucket = level * TW_SLOTS + ((deadline >> (level * TW_SLOT_BITS)) & (TW_SLOTS - 1));
+
+	dnode_set_prev(node, NULL);
+	dnode_set_next(node, tw->buckets[timer->bucket]);
+	if (tw->buckets[timer->bucket]) dnode_set_prev(tw->buckets[timer->bucket], node);
+	tw->buckets[timer->bucket] = node;
+	tw->level_counts[level]++;
+	return;
+}
+
+/* Utility function that unlinks the node from its slot */
+void tw_util_unlink(timerwheel* tw, dnode* node) {
+
+	dnode* prev = dnode_get_prev(node);
+	dnode* next = dnode_get_next(node);
+
+	if (prev) dnode_set_next(prev, next);
+	else tw->buckets[((tw_timer*)dnode_get_value(node))->bucket] = next;
+
+	if (next) dnode_set_prev(next, prev);
+	tw->level_counts[((tw_timer*)dnode_get_value(node))->bucket / TW_SLOTS]--;
+	return;
+}
+
+/* Utility function that moves every timer of the given slot to the slot (of a lower level) its deadline falls in now */
+void tw_util_cascade(timerwheel* tw, size_t bucket) {
+
+	dnode* node = tw->buckets[bucket];
+	tw->buckets[bucket] = NULL;
+
+	while (node) {
+
+		dnode* next = dnode_get_next(node);
+		tw->level_counts[bucket / TW_SLOTS]--;
+		tw_util_link(tw, node, tw->current);
+		node = next;
+	}
+	return;
+}
+
+/**
+ * Expires every timer of the given slot (of level 0), their elements are copied in the batch
+ * and the nodes are freed right away; the batch is passed to the callback every time it's full
+ */
+size_t tw_util_expire(timerwheel* tw, size_t bucket, void (*expire)(void*, size_t, void*), void* context) {
+
+	size_t expired = 0;
+	dnode* node = tw->buckets[bucket];
+
+	// The slot is detached first, the callback can schedule timers in it
+	tw->buckets[bucket] = NULL;
+
+	while (node) {
+
+		dnode* next = dnode_get_next(node);
+
+		if (tw->batch_count == TW_BATCH_SIZE) tw_util_flush(tw, expire, context);
+		memcpy(tw->batch + tw->batch_count * tw->element_size, (char*)dnode_get_value(node) + TW_TIMER_SIZE, tw->element_size);
+		tw->batch_count++;
+
+		tw->level_counts[0]--;
+		tw_util_release(tw, node);
+		expired++;
+		node = next;
+	}
+	return expired;
+}
+
+/* Utility function that passes the elements in the batch to the expire callback */
+void tw_util_flush(timerwheel* tw, void (*expire)(void*, size_t, void*), void* context) {
+
+	if (tw->batch_count > 0) {
+
+		size_t n = tw->batch_count;
+		tw->batch_count = 0;
+		expire(tw->batch, n, context);
+	}
+	return;
+}
+
+/* Utility function that frees the node of a timer, and its handle */
+void tw_util_release(timerwheel* tw, dnode* node) {
+
+	size_t handle = ((tw_timer*)dnode_get_value(node))->handle;
+	dnode* none = NULL;
+
+	vec_insert_at(tw->nodes_by_handle, &none, handle);
+	vec_push_back(tw->free_handles, &handle);
+	dnode_delete_in(tw->nodes, &node);
+	tw->count--;
+	return;
+}
+
+/* Utility function that returns the node of the timer with the given handle, NULL if it's not scheduled */
+dnode* tw_util_find(timerwheel* tw, size_t handle) {
+
+	return (tw && handle < vec_get_length(tw->nodes_by_handle)) ? *(dnode**)vec_get_at(tw->nodes_by_handle, handle) : NULL;
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/unionfind.h"
+#include <stdlib.h>
+
+/* Value returned for elements that are out of range */
+#define UF_NO_ELEMENT ((size_t)-1)
+
+/* Utility function that makes room for the elements in [0, capacity) */
+void uf_util_reserve(unionfind* uf, size_t capacity);
+
+/**
+ * Struct that represent a union-find (disjoint set forest) over the elements [0, n)
+ */
+typedef struct unionfind {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Parent of every element, the representatives are their own parent */
+	size_t* parents;
+
+	/* Number of elements of every set, only meaningful for the representatives */
+	size_t* sizes;
+
+	/* Number of elements */
+	size_t size;
+
+	/* Number of elements that can be stored without growing */
+	size_t capacity;
+
+	/* Number of disjoint sets */
+	size_t sets;
+} unionfind;
+
+/**
+ * Creates a union-find of the given size, where every element is in its own set
+ */
+unionfind* uf_create(size_t size) {
+
+	unionfind* uf = NULL;
+
+	// Allocate the struct
+	uf = (unionfind*)malloc(sizeof(unionfind));
+	if (uf) {
+
+		uf->parents = NULL;
+		uf->sizes = NULL;
+		uf->size = 0;
+		uf->capacity = 0;
+		uf->sets = 0;
+
+		uf_util_reserve(uf, size > 0 ? size : 1);
+		if (uf->capacity == 0) {
+
+			free(uf);
+			uf = NULL;
+		}
+		else {
+
+			uf->size = size;
+			uf_clear(uf);
+		}
+	}
+	return uf;
+}
+
+/**
+ * Deletes the given union-find, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for the parents and the set sizes is freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void uf_delete(unionfind** uf) {
+
+	if (uf && *uf) {
+
+		free((*uf)->parents);
+		free((*uf)->sizes);
+		free(*uf);
+		*uf = NULL;
+	}
+	return;
+}
+
+/**
+ * Adds a new element in its own set and returns it, (size_t)-1 if it couldn't be added
+ */
+size_t uf_add(unionfind* uf) {
+
+	size_t x = UF_NO_ELEMENT;
+
+	if (uf) {
+
+		if (uf->size == uf->capacity) uf_util_reserve(uf, uf->capacity * 2);
+		if (uf->size < uf->capacity) {
+
+			x = uf->size++;
+			uf->parents[x] = x;
+			uf->sizes[x] = 1;
+			uf->sets++;
+		}
+	}
+	return x;
+}
+
+/**
+ * Returns the representative of the set the element is in, (size_t)-1 if the element is out of range
+ */
+size_t uf_find(unionfind* uf, size_t x) {
+
+	size_t root = UF_NO_ELEMENT;
+
+	if (uf && x < uf->size) {
+
+		// Path halving, every other element on the path is linked to its grandparent
+		while (uf->parents[x] != x) {
+
+			uf->parents[x] = uf->parents[uf->parents[x]];
+			x = uf->parents[x];
+		}
+		root = x;
+	}
+	return root;
+}
+
+/**
+ * Merges the sets of the two elements
+ *
+ * Returns whether or not they were in different sets
+ */
+bool uf_union(unionfind* uf, size_t x, size_t y) {
+
+	size_t rx = uf_find(uf, x), ry = uf_find(uf, y), t;
+	bool merged = false;
+
+	if (rx != UF_NO_ELEMENT && ry != UF_NO_ELEMENT && rx != ry) {
+
+		// The smaller tree goes under the bigger one, so trees stay logarithmic in height
+		if (uf->sizes[rx] < uf->sizes[ry]) {
+
+			t = rx;
+			rx = ry;
+			ry = t;
+		}
+		uf->parents[ry] = rx;
+		uf->sizes[rx] += uf->sizes[ry];
+		uf->sets--;
+		merged = true;
+	}
+	return merged;
+}
+
+/**
+ * Checks whether or not the two elements are in the same set
+ */
+bool uf_connected(unionfind* uf, size_t x, size_t y) {
+
+	size_t rx = uf_find(uf, x);
+
+	return rx != UF_NO_ELEMENT && rx == uf_find(uf, y);
+}
+
+/**
+ * Returns the number of elements in the set the element is in
+ */
+size_t uf_get_set_size(unionfind* uf, size_t x) {
+
+	size_t root = uf_find(uf, x);
+
+	return root != UF_NO_ELEMENT ? uf->sizes[root] : 0;
+}
+
+/**
+ * Returns the number of disjoint sets
+ */
+size_t uf_get_set_count(unionfind* uf) {
+
+	return uf ? uf->sets : 0;
+}
+
+/**
+ * Returns the number of elements
+ */
+size_t uf_get_size(unionfind* uf) {
+
+	return uf ? uf->size : 0;
+}
+
+/**
+ * Puts every element back in its own set
+ * (the union-find struct itself is not deleted)
+ */
+void uf_clear(unionfind* uf) {
+
+	size_t i;
+
+	if (uf) {
+
+		for (i = 0; i < uf->size; i++) {
+
+			uf->parents[i] = i;
+			uf->sizes[i] = 1;
+		}
+		uf->sets = uf->size;
+	}
+	return;
+}
+
+/* Utility function that makes room for the elements in [0, capacity) */
+void uf_util_reserve(unionfind* uf, size_t capacity) {
+
+	size_t* parents;
+	size_t* sizes;
+
+	if (uf && capacity > uf->capacity) {
+
+		parents = (size_t*)realloc(uf->parents, capacity * sizeof(size_t));
+		if (parents) {
+
+			uf->parents = parents;
+
+			sizes = (size_t*)realloc(uf->sizes, capacity * sizeof(size_t));
+			if (sizes) {
+
+				uf->sizes = sizes;
+				uf->capacity = capacity;
+			}
+		}
+	}
+	return;
+}
\ No newline at end of file
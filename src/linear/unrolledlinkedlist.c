@@ -0,0 +1,957 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef LINKEDLIST_WITH_UNROLLED_NODES
+
+#include "../../include/linear/linkedlist.h"
+#include "../../include/linear/pool.h"
+#include "../../include/linear/searchkernels.h"
+#include "../../include/linear/parallel.h"
+#include <string.h>
+#include <stdint.h>
+
+/* Bytes of a node (header included), the number of elements it holds is derived from it */
+#define LL_NODE_BYTES 256
+
+/**
+ * Node of the list, holding up to per_node elements one after the other
+ *
+ * The elements are stored right after the struct, in the same block
+ */
+typedef struct ll_node {
+
+	/* Next node of the list */
+	struct ll_node* next;
+
+	/* Number of elements in the node */
+	size_t count;
+} ll_node;
+
+/* Utility function that returns a pointer to the j -th element of a node */
+void* ll_util_element(linkedlist* ll, ll_node* n, size_t j);
+
+/* Number of elements each thread of a parallel operation takes at a time (rounded to whole nodes) */
+#define LL_PARALLEL_GRAIN 1024
+
+/* State shared by the threads of a parallel operation, the nodes are collected beforehand */
+typedef struct ll_parallel_task {
+
+	linkedlist* ll;
+	ll_node** nodes;
+	void (*f)(void*);
+} ll_parallel_task;
+
+/* Utility function used as the body of ll_parallel_for_each, for the nodes from 'from' to 'to' */
+void ll_util_parallel_for_each(void* context, size_t from, size_t to);
+
+/* Utility function that returns the first node after the run (nodes whose elements are all in order) starting at n, NULL if it reaches the end of the list */
+ll_node* ll_util_run_end(linkedlist* ll, ll_node* n, int (*compare)(void*, void*));
+
+/* Utility function used to create an empty node after prev (or as the head, if prev is NULL) */
+ll_node* ll_util_create_node(linkedlist* ll, ll_node* prev);
+
+/* Utility function that finds the node holding the i -th element, and its position in it */
+ll_node* ll_util_locate(linkedlist* ll, size_t i, size_t* offset, ll_node** prev);
+
+/* Utility function that makes space for an element in a node, splitting it if it's full, and returns the node the element goes in */
+ll_node* ll_util_make_room(linkedlist* ll, ll_node* n, size_t* offset);
+
+/* Utility function used to move the elements of the node after n into n */
+void ll_util_absorb(linkedlist* ll, ll_node* n);
+
+/**
+ * Struct that represent a list of elements of a generic type value
+ */
+typedef struct linkedlist {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Pointers to the first and last nodes of the list */
+	ll_node* head;
+	ll_node* tail;
+
+	/* Last node reached by a search, the one before it and the index of its first element (NULL if it isn't known) */
+	ll_node* cursor;
+	ll_node* cursor_prev;
+	size_t cursor_start;
+
+	/* Number of elements present in the list */
+	size_t element_count;
+
+	/* Size of the elements stored in the list */
+	size_t element_size;
+
+	/* Number of elements each node can hold */
+	size_t per_node;
+
+	/* Search kernel used to scan the (contiguous) elements of a node, picked from the element size */
+	search_kernel find;
+
+	/* Pool the nodes are taken from, owned by the list */
+	pool* nodes;
+
+} linkedlist;
+
+/**
+ *  Creates a linked list ready to store elements that are as big as the given size
+ */
+linkedlist* ll_create(size_t element_size) {
+
+	return ll_create_inline(element_size, 0);
+}
+
+/**
+ * Creates a linked list whose first inline_length nodes are stored in the same allocation as their pool
+ *
+ * A list that never holds more than inline_length elements doesn't allocate its nodes one by one
+ */
+linkedlist* ll_create_inline(size_t element_size, size_t inline_length) {
+
+	linkedlist* ll = NULL;
+
+	if (0 < element_size && element_size <= SIZE_MAX - sizeof(ll_node)) {
+
+		ll = (linkedlist*)malloc(sizeof(linkedlist));
+
+		if (ll) {
+
+			ll->head = NULL;
+			ll->tail = NULL;
+			ll->cursor = NULL;
+			ll->cursor_prev = NULL;
+			ll->cursor_start = 0;
+			ll->element_size = element_size;
+			ll->element_count = 0;
+			ll->find = search_util_select(element_size);
+
+			// As many elements as fit in a node, but at least one
+			ll->per_node = (LL_NODE_BYTES - sizeof(ll_node)) / element_size;
+			if (ll->per_node == 0) ll->per_node = 1;
+
+			// Full nodes hold per_node elements, so that many of them fit inline_length elements
+			size_t inline_nodes = inline_length / ll->per_node + (inline_length % ll->per_node != 0);
+			ll->nodes = (ll->per_node <= (SIZE_MAX - sizeof(ll_node)) / element_size) ? pool_create_inline(sizeof(ll_node) + ll->per_node * element_size, inline_nodes) : NULL;
+
+			// Cancel the creation if the nodes can't be allocated
+			if (!ll->nodes) {
+
+				free(ll);
+				ll = NULL;
+			}
+		}
+	}
+	return ll;
+}
+
+/**
+ * Deletes the given list, since memory is allocated dinamically
+ * the following actions are performed:
+ *   The memory allocated for storing the actual element in each node, and the node, are freed
+ *   The memory allocated for the struct itself is freed
+ *   The pointer to the struct is then set to NULL
+ */
+void ll_delete(linkedlist** ll) {
+
+	// Access the list only if the pointer is valid
+	if (ll && *ll) {
+
+		// Free every node, all at once
+		pool_delete(&(*ll)->nodes);
+
+		// Free the memory used for the whole struct
+		memset(*ll, 0, sizeof(linkedlist));
+		free(*ll);
+		*ll = NULL;
+	}
+	return;
+}
+
+/**
+ * Insert the element pointed to by x as the i -th element of the list
+ */
+void ll_insert_at(linkedlist* ll, void* x, size_t i) {
+
+	// Check for pointer validity
+	if (ll && x) {
+
+		// Check if the position is correct
+		if (i <= ll->element_count) {
+
+			size_t offset = 0;
+			ll_node* prev = NULL;
+			ll_node* n = ll->tail;
+
+			// Appending doesn't walk the list
+			if (!n) n = ll_util_create_node(ll, NULL);
+			else if (i == ll->element_count) offset = n->count;
+			else n = ll_util_locate(ll, i, &offset, &prev);
+
+			if (n) n = ll_util_make_room(ll, n, &offset);
+
+			// Continue only if there's space for the element
+			if (n) {
+
+				memmove(ll_util_element(ll, n, offset + 1), ll_util_element(ll, n, offset), (n->count - offset) * ll->element_size);
+				memcpy(ll_util_element(ll, n, offset), x, ll->element_size);
+				n->count++;
+				ll->element_count++;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Insert the element pointed to by x as the new head of the list
+ */
+void ll_insert_head(linkedlist* ll, void* x) {
+
+	// Check for pointer validity
+	if (ll && x) {
+
+		ll_insert_at(ll, x, 0);
+	}
+	return;
+}
+
+/**
+ * Insert the element pointed to by x as the new tail of the list
+ */
+void ll_insert_tail(linkedlist* ll, void* x) {
+
+	// Check for pointer validity
+	if (ll && x) {
+
+		ll_insert_at(ll, x, ll->element_count);
+	}
+	return;
+}
+
+/**
+ * Removes the i -th element from the list
+ */
+void ll_remove_at(linkedlist* ll, size_t i) {
+
+	// Check for pointer validity
+	if (ll) {
+
+		// Check if the position is correct
+		if (i < ll->element_count) {
+
+			size_t offset = 0;
+			ll_node* prev = NULL;
+			ll_node* n = ll_util_locate(ll, i + 1, &offset, &prev);
+
+			offset--;
+			memmove(ll_util_element(ll, n, offset), ll_util_element(ll, n, offset + 1), (n->count - offset - 1) * ll->element_size);
+			n->count--;
+			ll->element_count--;
+
+			// An empty node is unlinked
+			if (n->count == 0) {
+
+				if (prev) prev->next = n->next;
+				else ll->head = n->next;
+				if (ll->tail == n) ll->tail = prev;
+				if (ll->cursor == n) ll->cursor = NULL;
+				pool_free(ll->nodes, n);
+			}
+
+			// Nodes less than half full take the elements of the next one, if they fit
+			else if (n->count < ll->per_node / 2 && n->next && n->count + n->next->count <= ll->per_node) ll_util_absorb(ll, n);
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the head from the list
+ */
+void ll_remove_head(linkedlist* ll) {
+
+	// Check for pointer validity
+	if (ll) {
+
+		ll_remove_at(ll, 0);
+	}
+	return;
+}
+
+/**
+ * Removes the tail from the list
+ */
+void ll_remove_tail(linkedlist* ll) {
+
+	// Check for pointer validity
+	if (ll) {
+
+		ll_remove_at(ll, ll->element_count - 1);
+	}
+	return;
+}
+
+/**
+ * Returns a pointer to the i -th element of the list
+ *
+ * The list remembers the last position it reached, so accessing the elements in order costs O(1) each
+ */
+void* ll_get_at(linkedlist* ll, size_t i) {
+
+	void* ret = NULL;
+
+	// Check for pointer validity
+	if (ll) {
+
+		// Check if the position is correct
+		if (i < ll->element_count) {
+
+			size_t offset = ll->tail->count;
+			ll_node* prev = NULL;
+			ll_node* n = ll->tail;
+
+			// The tail is reached directly
+			if (i < ll->element_count - 1) n = ll_util_locate(ll, i + 1, &offset, &prev);
+
+			// Return the value
+			ret = ll_util_element(ll, n, offset - 1);
+		}
+	}
+	return ret;
+}
+
+/**
+ * Copies the i -th element of the list inside the buffer
+ * pointed to by buf (we assume it has already been allocated,
+ * and of the correct size)
+ */
+void ll_get_2_at(linkedlist* ll, size_t i, void* buf) {
+
+	void* value = ll_get_at(ll, i);
+
+	// Copy the value
+	if (value && buf) memcpy(buf, value, ll->element_size);
+	return;
+}
+
+/**
+ * Returns a pointer to the head of the list
+ */
+void* ll_get_head(linkedlist* ll) {
+
+	return ll ? ll_get_at(ll, 0) : NULL;
+}
+
+/**
+ * Copies the head of the list inside the buffer
+ * pointed to by buf (we assume it has already been allocated,
+ * and of the correct size)
+ */
+void ll_get_2_head(linkedlist* ll, void* buf) {
+
+	ll_get_2_at(ll, 0, buf);
+	return;
+}
+
+/**
+ * Returns a pointer to the tail of the list
+ */
+void* ll_get_tail(linkedlist* ll) {
+
+	return ll ? ll_get_at(ll, ll->element_count - 1) : NULL;
+}
+
+/**
+ * Copies the tail of the list inside the buffer
+ * pointed to by buf (we assume it has already been allocated,
+ * and of the correct size)
+ */
+void ll_get_2_tail(linkedlist* ll, void* buf) {
+
+	if (ll) ll_get_2_at(ll, ll->element_count - 1, buf);
+	return;
+}
+
+/**
+ * Returns the number of elements of the list
+ */
+size_t ll_get_size(linkedlist* ll) {
+
+	return ll ? ll->element_count : 0;
+}
+
+/**
+ * Returns the size of the elements of the list
+ */
+size_t ll_get_element_size(linkedlist* ll) {
+
+	return ll ? ll->element_size : 0;
+}
+
+/**
+ * Copies in stats the allocation counters of the nodes of the list
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * With unrolled nodes a node holds more than one element
+ */
+void ll_get_stats(linkedlist* ll, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (ll) pool_add_stats(ll->nodes, stats);
+	}
+	return;
+}
+
+/**
+ * Checks if the element pointed to by x is present in the list
+ *
+ * The value returned is actually it's position in the list
+ * from 1 to ll_get_size (needs to be adjusted by subtracting one when accessing the list)
+ */
+short ll_contains(linkedlist* ll, void* x) {
+
+	size_t index = 0;
+	bool isPresent = false;
+
+	// Check for pointer validity
+	if (ll && x) {
+
+		// The elements of a node are contiguous, so each node is scanned by the search kernel at once
+		for (ll_node* n = ll->head; n && !isPresent; n = n->next) {
+
+			size_t j = ll->find(ll_util_element(ll, n, 0), n->count, ll->element_size, x);
+
+			isPresent = (j < n->count);
+			index += isPresent ? j + 1 : n->count;
+		}
+	}
+	return isPresent ? (short)index : 0;
+}
+
+/**
+ * Checks whether the list contains at least one element or not
+ */
+bool ll_is_empty(linkedlist* ll) {
+
+	return ll ? !(ll->element_count) : false;
+}
+
+/**
+ * Removed every element from the list
+ * (the list struct itself is not deleted)
+ */
+void ll_clear(linkedlist* ll) {
+
+	// Access the list if the pointer is valid
+	if (ll) {
+
+		// Every node comes from the pool, release them all without visiting the list
+		pool_clear(ll->nodes);
+		ll->head = NULL;
+		ll->tail = NULL;
+		ll->cursor = NULL;
+		ll->element_count = 0;
+	}
+}
+
+/**
+ * Applies the function f to every element
+ * of the linked list ll
+ */
+void ll_for_each(linkedlist* ll, void (*f)(void*)) {
+
+	// Parameters check
+	if (ll && f) {
+
+		void* tmp_buf = malloc(ll->element_size);
+		if (tmp_buf) {
+
+			// Apply the function to each element
+			for (ll_node* n = ll->head; n; n = n->next) {
+
+				for (size_t j = 0; j < n->count; j++) {
+
+					// Get a copy of the element for safety reasons
+					memcpy(tmp_buf, ll_util_element(ll, n, j), ll->element_size);
+
+					// Apply the function to the copy
+					f(tmp_buf);
+				}
+			}
+			free(tmp_buf);
+		}
+	}
+	return;
+}
+
+/**
+ * Applies the function f to every element of the linked list ll, using (at most) the given number of threads
+ *
+ * The positions of the elements are collected first, then they're split in chunks
+ * handled by the threads, f gets a copy of the element (like in ll_for_each)
+ * and is called by many threads at the same time, so it must be thread safe
+ */
+void ll_parallel_for_each(linkedlist* ll, void (*f)(void*), size_t threads) {
+
+	if (ll && f && ll->head) {
+
+		// Only the nodes need to be collected, the elements of a node are contiguous
+		size_t count = 0;
+		for (ll_node* n = ll->head; n; n = n->next) count++;
+
+		ll_parallel_task task;
+		task.ll = ll;
+		task.nodes = (ll_node**)malloc(count * sizeof(ll_node*));
+		task.f = f;
+
+		if (task.nodes) {
+
+			size_t i = 0;
+			for (ll_node* n = ll->head; n; n = n->next) task.nodes[i++] = n;
+
+			size_t grain = LL_PARALLEL_GRAIN / ll->per_node;
+			parallel_util_for(count, grain > 0 ? grain : 1, threads, ll_util_parallel_for_each, &task);
+			free(task.nodes);
+		}
+	}
+	return;
+}
+
+/**
+ * Sorts the elements of the list according to the compare function, equal elements keep their order
+ *
+ * Each node is sorted in place, then the sorted runs of nodes are merged in pairs, the merged elements
+ * go into nodes emptied by the merge itself, so only three spare nodes are needed (a merge never fills
+ * more than three nodes more than the ones it emptied), the list is left unchanged if they can't be allocated
+ */
+void ll_sort(linkedlist* ll, int (*compare)(void*, void*)) {
+
+	if (ll && compare && ll->element_count > 1) {
+
+		ll_node* spare = NULL;
+		bool ready = true;
+		for (int i = 0; i < 3 && ready; i++) {
+
+			ll_node* s = (ll_node*)pool_alloc(ll->nodes);
+			if (s) {
+				s->next = spare;
+				spare = s;
+			}
+			ready = (s != NULL);
+		}
+
+		if (ready) {
+
+			size_t size = ll->element_size;
+
+			// Insertion sort of every node, a spare node holds the element being moved
+			char* tmp = (char*)ll_util_element(ll, spare, 0);
+			for (ll_node* n = ll->head; n; n = n->next) {
+
+				for (size_t i = 1; i < n->count; i++) {
+
+					size_t j = i;
+					memcpy(tmp, ll_util_element(ll, n, i), size);
+					while (j > 0 && compare(ll_util_element(ll, n, j - 1), tmp) > 0) j--;
+
+					memmove(ll_util_element(ll, n, j + 1), ll_util_element(ll, n, j), (i - j) * size);
+					memcpy(ll_util_element(ll, n, j), tmp, size);
+				}
+			}
+
+			// Every pass merges pairs of runs (nodes whose elements are all in order), until the first run is the whole list
+			for (;;) {
+
+				ll_node* p = ll->head;
+				ll_node* head = NULL;
+				ll_node* tail = NULL;
+
+				ll_node* q = ll_util_run_end(ll, p, compare);
+				if (!q) break;
+
+				while (p) {
+
+					// The first run goes from p to q (excluded), the second one from q to r
+					ll_node* r = q ? ll_util_run_end(ll, q, compare) : NULL;
+					ll_node* a = p;
+					ll_node* b = q;
+					ll_node* out = NULL;
+					size_t i = 0, j = 0;
+
+					while (a || b) {
+
+						// On ties the element of the first run goes first
+						bool from_a = a && (!b || compare(ll_util_element(ll, a, i), ll_util_element(ll, b, j)) <= 0);
+						char* src = (char*)(from_a ? ll_util_element(ll, a, i) : ll_util_element(ll, b, j));
+
+						// Each merge starts a new node, so that runs never share one
+						if (!out || out->count == ll->per_node) {
+
+							ll_node* s = spare;
+							spare = s->next;
+							s->count = 0;
+							s->next = NULL;
+
+							if (tail) tail->next = s;
+							else head = s;
+							tail = s;
+							out = s;
+						}
+						memcpy(ll_util_element(ll, out, out->count++), src, size);
+
+						// An emptied node becomes a spare one
+						if (from_a && ++i == a->count) {
+
+							ll_node* next = a->next;
+							a->next = spare;
+							spare = a;
+							a = (next == q) ? NULL : next;
+							i = 0;
+						}
+						else if (!from_a && ++j == b->count) {
+
+							ll_node* next = b->next;
+							b->next = spare;
+							spare = b;
+							b = (next == r) ? NULL : next;
+							j = 0;
+						}
+					}
+
+					p = r;
+					q = p ? ll_util_run_end(ll, p, compare) : NULL;
+				}
+
+				ll->head = head;
+				ll->tail = tail;
+			}
+			ll->cursor = NULL;
+		}
+
+		// Give the spare nodes back
+		while (spare) {
+
+			ll_node* next = spare->next;
+			pool_free(ll->nodes, spare);
+			spare = next;
+		}
+	}
+	return;
+}
+
+/**
+ * Returns a linked list obtained by applying
+ * the function f to every element of the original list ll
+ */
+linkedlist* ll_map(linkedlist* ll, void* (*f)(void*)) {
+
+	linkedlist* mapped = NULL;
+
+	// Parameters check
+	if (ll && f) {
+
+		mapped = ll_create(ll->element_size);
+		if (mapped) {
+
+			void* tmp_buf = malloc(ll->element_size);
+			if (tmp_buf) {
+
+				// Apply the function to each element and append it to the new list
+				for (ll_node* n = ll->head; n; n = n->next) {
+
+					for (size_t j = 0; j < n->count; j++) {
+
+						// Get a copy of the element for safety reasons
+						memcpy(tmp_buf, ll_util_element(ll, n, j), ll->element_size);
+
+						// Apply the function to the copy and insert it in the list
+						ll_insert_tail(mapped, f(tmp_buf));
+					}
+				}
+				free(tmp_buf);
+			}
+		}
+	}
+	return mapped;
+}
+
+/**
+ * Initializes the iterator so that it starts from the head of the list
+ */
+void ll_iter_begin(linkedlist* ll, ll_iterator* it) {
+
+	if (ll && it) {
+
+		it->list = ll;
+		it->node = ll->head;
+		it->prev = NULL;
+		it->before = NULL;
+		it->offset = 0;
+		it->index = 0;
+		it->removable = false;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool ll_iter_has_next(ll_iterator* it) {
+
+	ll_node* n = it ? (ll_node*)it->node : NULL;
+
+	return n ? (it->offset < n->count || n->next) : false;
+}
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* ll_iter_next(ll_iterator* it) {
+
+	void* ret = NULL;
+	ll_node* n = it ? (ll_node*)it->node : NULL;
+
+	if (n) {
+
+		// Nodes are never empty, past the end of one the next element is the first of the following one
+		if (it->offset == n->count && n->next) {
+
+			it->prev = n;
+			it->node = n = n->next;
+			it->offset = 0;
+		}
+
+		if (it->offset < n->count) {
+
+			ret = ll_util_element(it->list, n, it->offset);
+			it->offset++;
+			it->index++;
+			it->removable = true;
+		}
+	}
+	return ret;
+}
+
+/**
+ * Inserts the element pointed to by x before the next element (at the end, if there's none)
+ *
+ * The next element returned is still the one that would have been returned before
+ */
+void ll_iter_insert(ll_iterator* it, void* x) {
+
+	if (it && x) {
+
+		linkedlist* ll = it->list;
+		ll_node* n = it->node ? (ll_node*)it->node : ll_util_create_node(ll, NULL);
+		ll_node* room = n ? ll_util_make_room(ll, n, &it->offset) : NULL;
+
+		if (room) {
+
+			// The element may have gone in the second half of a split node
+			if (room != n) it->prev = n;
+			it->node = room;
+
+			memmove(ll_util_element(ll, room, it->offset + 1), ll_util_element(ll, room, it->offset), (room->count - it->offset) * ll->element_size);
+			memcpy(ll_util_element(ll, room, it->offset), x, ll->element_size);
+			room->count++;
+			ll->element_count++;
+
+			it->offset++;
+			it->index++;
+			it->removable = false;
+			ll->cursor = NULL;
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the last element returned by ll_iter_next
+ *
+ * It can be done once per element returned, and not after an insertion
+ */
+void ll_iter_remove(ll_iterator* it) {
+
+	if (it && it->removable) {
+
+		linkedlist* ll = it->list;
+		ll_node* n = (ll_node*)it->node;
+
+		// The last element returned is right before the position of the iterator, in the same node
+		it->offset--;
+		memmove(ll_util_element(ll, n, it->offset), ll_util_element(ll, n, it->offset + 1), (n->count - it->offset - 1) * ll->element_size);
+		n->count--;
+		ll->element_count--;
+
+		it->index--;
+		it->removable = false;
+		ll->cursor = NULL;
+
+		// An empty node takes the elements of the next one, the tail is unlinked instead (the iterator moves to the end of the node before it)
+		if (n->count == 0 && !n->next) {
+
+			ll_node* prev = (ll_node*)it->prev;
+
+			if (prev) prev->next = NULL;
+			else ll->head = NULL;
+			ll->tail = prev;
+			pool_free(ll->nodes, n);
+
+			it->node = prev;
+			it->offset = prev ? prev->count : 0;
+			it->prev = NULL;
+		}
+		else if (n->next && n->count + n->next->count <= ll->per_node && (n->count == 0 || n->count < ll->per_node / 2)) ll_util_absorb(ll, n);
+	}
+	return;
+}
+
+/* Utility function that returns a pointer to the j -th element of a node */
+void* ll_util_element(linkedlist* ll, ll_node* n, size_t j) {
+
+	return (char*)(n + 1) + j * ll->element_size;
+}
+
+/* Utility function used to create an empty node after prev (or as the head, if prev is NULL) */
+ll_node* ll_util_create_node(linkedlist* ll, ll_node* prev) {
+
+	ll_node* n = (ll_node*)pool_alloc(ll->nodes);
+
+	if (n) {
+
+		n->count = 0;
+		if (prev) {
+
+			n->next = prev->next;
+			prev->next = n;
+		}
+		else {
+
+			n->next = ll->head;
+			ll->head = n;
+		}
+		if (ll->tail == prev) ll->tail = n;
+	}
+	return n;
+}
+
+/* Utility function that finds the node holding the i -th element, and its position in it
+ *
+ * Positions go from 1 to the size of the node, i = 0 gives the head and position 0 (so that an insertion can be placed there) */
+ll_node* ll_util_locate(linkedlist* ll, size_t i, size_t* offset, ll_node** prev) {
+
+	ll_node* n = ll->head;
+	size_t start = 0;
+	*prev = NULL;
+
+	// The search can start from the last node reached, if it starts before the element
+	if (ll->cursor && ll->cursor_start < i) {
+
+		n = ll->cursor;
+		*prev = ll->cursor_prev;
+		start = ll->cursor_start;
+	}
+
+	while (i - start > n->count) {
+
+		start += n->count;
+		*prev = n;
+		n = n->next;
+	}
+
+	ll->cursor = n;
+	ll->cursor_prev = *prev;
+	ll->cursor_start = start;
+	i -= start;
+	*offset = i;
+	return n;
+}
+
+/* Utility function that makes space for an element in a node, splitting it if it's full, and returns the node the element goes in */
+ll_node* ll_util_make_room(linkedlist* ll, ll_node* n, size_t* offset) {
+
+	// A full node gets a new one after it: appending only starts it, otherwise half of the elements move there
+	if (n->count == ll->per_node) {
+
+		ll_node* split = ll_util_create_node(ll, n);
+
+		if (!split) n = NULL;
+		else {
+
+			if (*offset < n->count) {
+
+				size_t moved = (n->count + 1) / 2;
+
+				memcpy(ll_util_element(ll, split, 0), ll_util_element(ll, n, n->count - moved), moved * ll->element_size);
+				split->count = moved;
+				n->count -= moved;
+			}
+
+			// The element goes in the new node if it's past the ones left, or if nothing was moved
+			if (*offset > n->count || n->count == ll->per_node) {
+
+				*offset -= n->count;
+				n = split;
+			}
+		}
+	}
+	return n;
+}
+
+/* Utility function used to move the elements of the node after n into n */
+void ll_util_absorb(linkedlist* ll, ll_node* n) {
+
+	ll_node* next = n->next;
+
+	memcpy(ll_util_element(ll, n, n->count), ll_util_element(ll, next, 0), next->count * ll->element_size);
+	n->count += next->count;
+	n->next = next->next;
+	if (ll->tail == next) ll->tail = n;
+	if (ll->cursor == next) ll->cursor = NULL;
+	pool_free(ll->nodes, next);
+	return;
+}
+
+/* Utility function used as the body of ll_parallel_for_each, applies f to a copy of each element of the nodes of the chunk */
+void ll_util_parallel_for_each(void* context, size_t from, size_t to) {
+
+	ll_parallel_task* task = (ll_parallel_task*)context;
+	linkedlist* ll = task->ll;
+	void* tmp_buf = malloc(ll->element_size);
+
+	if (tmp_buf) {
+		for (size_t i = from; i < to; i++) {
+
+			for (size_t j = 0; j < task->nodes[i]->count; j++) {
+
+				memcpy(tmp_buf, ll_util_element(ll, task->nodes[i], j), ll->element_size);
+				task->f(tmp_buf);
+			}
+		}
+		free(tmp_buf);
+	}
+	return;
+}
+
+/* Utility function that returns the first node after the run (nodes whose elements are all in order) starting at n, NULL if it reaches the end of the list */
+ll_node* ll_util_run_end(linkedlist* ll, ll_node* n, int (*compare)(void*, void*)) {
+
+	while (n->next && compare(ll_util_element(ll, n, n->count - 1), ll_util_element(ll, n->next, 0)) <= 0) n = n->next;
+	return n->next;
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,96 @@
  */
 
 #include "../../include/linear/vector.h"
+#include "../../include/linear/searchkernels.h"
+#include "../../include/linear/parallel.h"
+#include "../../include/linear/snapshot.h"
+
+/* Growth factor used by newly created vectors, when they need to enlarge their buffer */
+#define VECTOR_DEFAULT_GROWTH_FACTOR 2.0
+
+/* Biggest buffer (in bytes) that vec_create stores inline, right after the struct */
+#define VECTOR_INLINE_BYTES 64
+
+/* Alignment of the inline buffer, enough for any fundamental type */
+#define VECTOR_INLINE_ALIGNMENT 16
+
+/* Offset of the inline buffer from the start of the struct */
+#define VECTOR_INLINE_OFFSET ((sizeof(vector) + VECTOR_INLINE_ALIGNMENT - 1) / VECTOR_INLINE_ALIGNMENT * VECTOR_INLINE_ALIGNMENT)
+
+/* Utility function used to enlarge the buffer so that it can hold at least min_capacity elements */
+bool vec_util_grow(vector* v, size_t min_capacity);
+
+/* Utility function used to reallocate the buffer to exactly new_capacity elements */
+bool vec_util_reallocate(vector* v, size_t new_capacity);
+
+/* Utility function used to create a vector whose first inline_capacity elements are stored after the struct */
+vector* vec_util_create(size_t vector_size, size_t element_size, size_t inline_capacity);
+
+/* Utility function used to get the inline buffer of a vector */
+void* vec_util_inline(vector* v);
+
+/* Number of elements each thread of a parallel operation takes at a time */
+#define VECTOR_PARALLEL_GRAIN 1024
+
+/* State shared by the threads of a parallel operation */
+typedef struct vec_parallel_task {
+
+	vector* v;
+	vector* mapped;
+	void (*f)(void*);
+	void* (*map)(void*);
+	void (*combine)(void*, void*);
+	void* identity;
+
+	/* One accumulator for each chunk, used by reduce */
+	char* partials;
+} vec_parallel_task;
+
+/* Utility functions used as the body of the parallel operations, for the elements from 'from' to 'to' */
+void vec_util_parallel_for_each(void* context, size_t from, size_t to);
+void vec_util_parallel_map(void* context, size_t from, size_t to);
+void vec_util_parallel_reduce(void* context, size_t from, size_t to);
+
+/* Number of elements under which the sorts switch to insertion sort */
+#define VECTOR_SORT_INSERTION 16
+
+/* Number of elements each block of a parallel sort has (at least) */
+#define VECTOR_SORT_PARALLEL_GRAIN 8192
+
+/* State shared by the threads of a parallel sort */
+typedef struct vec_sort_task {
+
+	size_t n;
+	size_t element_size;
+	int (*compare)(void*, void*);
+
+	/* Buffer the runs are read from and buffer they're merged into, and the length of the runs */
+	char* src;
+	char* dst;
+	size_t width;
+} vec_sort_task;
+
+/* Utility functions used by the sorts, on the n elements that are size bytes long starting at base */
+void vec_util_swap(char* a, char* b, size_t size);
+void vec_util_insertion_sort(char* base, size_t n, size_t size, int (*compare)(void*, void*));
+void vec_util_heap_sort(char* base, size_t n, size_t size, int (*compare)(void*, void*));
+void vec_util_introsort(char* base, size_t n, size_t size, int (*compare)(void*, void*), size_t depth);
+void vec_util_merge(char* a, size_t na, size_t nb, char* out, size_t size, int (*compare)(void*, void*));
+uint64_t vec_util_radix_key(const char* element, size_t size, bool is_signed);
+
+/* Utility functions used as the body of the parallel sort, for the blocks (or pairs of runs) from 'from' to 'to' */
+void vec_util_parallel_sort(void* context, size_t from, size_t to);
+void vec_util_parallel_merge(void* context, size_t from, size_t to);
+
+/**
+ * Descriptor of the snapshot of a vector, the live elements are stored in a single section
+ */
+typedef struct vec_snapshot {
+
+	uint64_t element_size;
+	uint64_t length;
+	uint64_t elements;
+} vec_snapshot;
 
 /**
  * Struct that represent a generic type vector
@@ -31,56 +121,68 @@ typedef struct vector {
 	 */
 	void* elements;
 
-	/* Vectors are fixed in size. The size is used
-	 * both for creating the actual array and for
-	 * any array-related operation (mainly the ones
-	 * that iterate it)
+	/* Number of elements the buffer can currently hold (capacity)
+	 * Every random access operation (insert_at, get_at, ..) is
+	 * bounded by this value, and it can grow when appending
 	 */
 	size_t vector_size;
 
+	/* Logical length of the vector, that is the number of live elements
+	 *
+	 * Elements go from 0 to length - 1, iterating operations (for_each,
+	 * contains, map) only walk this portion of the buffer
+	 */
+	size_t length;
+
+	/* Factor by which the capacity gets multiplied when the buffer is full */
+	double growth_factor;
+
 	/* Pointer arithmetics don't make sense when using void*
 	 * since the compiler can't possibly know how much space to
 	 * alloc for each element, nor how many positions to move when
 	 * iterating it, the element size is used to overcome this
 	 */
 	size_t element_size;
+
+	/* Search kernel used by contains/find_index, picked
+	 * at creation time based on the element size (so that
+	 * 1, 2, 4 and 8 bytes elements are compared many at a time)
+	 */
+	search_kernel find;
+
+	/* Snapshot the elements are read from (see vec_open_mmap), NULL
+	 * if they're in memory. Mapped vectors are read-only, so every
+	 * function that would modify them leaves them unchanged
+	 */
+	snapshot* mapping;
+
+	/* Number of elements the inline buffer (placed right after the struct) can hold, 0 if there's none
+	 * The elements are stored there as long as the capacity doesn't exceed it
+	 */
+	size_t inline_capacity;
 } vector;
 
 /**
  *  Creates a vector with the given size, ready to store elements that are 'element_size' long
+ *
+ * Buffers up to 64 bytes are stored in the same allocation as the vector (see vec_create_inline)
  */
 vector* vec_create(size_t vector_size, size_t element_size) {
-	
-	vector* v = NULL;
-
-	// Check if the sizes are correct, that is, at least 1
-	if (vector_size > 0 && element_size > 0) {
-
-		/* And not too big(consequence of passing a negative value to a size_t parameter)
-		 * The maximum length of the array is LONG_MAX, so vector_size * element_size should be at most, LONG_MAX
-		 */
-		if (vector_size <= SIZE_MAX / element_size) {
 
-			// Sizes are correct, we can allocate memory for the struct
-			v = (vector*)malloc(sizeof(vector));
+	bool small = vector_size > 0 && element_size > 0 && vector_size <= VECTOR_INLINE_BYTES / element_size;
 
-			// If the allocation was successful
-			if (v != NULL) {
-				v->vector_size = vector_size;
-				v->element_size = element_size;
-				v->elements = calloc(v->vector_size, v->element_size);
+	return vec_util_create(vector_size, element_size, small ? vector_size : 0);
+}
 
-				// Check if the array's memory allocation was successful
-				if (v->elements == NULL) {
+/**
+ * Creates a vector that stores its first inline_capacity elements in the same allocation as the vector itself
+ *
+ * The capacity starts at inline_capacity, when the vector grows past it the elements move to
+ * a buffer of their own (and back in, if it shrinks to fit them). Most small vectors never allocate again
+ */
+vector* vec_create_inline(size_t inline_capacity, size_t element_size) {
 
-					// In case the allocation failed, revert the allocation for vector
-					free(v);
-					v = NULL;
-				}
-			}
-		}
-	}
-	return v;
+	return vec_util_create(inline_capacity, element_size, inline_capacity);
 }
 
 /**
@@ -103,9 +205,14 @@ void vec_delete(vector** v) {
 	// Access the array only if the pointer is valid
 	if (v != NULL && *v != NULL) {
 
-		// Zero the memory used for the array and free it
-		memset((*v)->elements, 0, (*v)->vector_size * (*v)->element_size);
-		free((*v)->elements);
+		// Mapped elements are released by unmapping the snapshot
+		if ((*v)->mapping) snapshot_util_close(&(*v)->mapping);
+		else {
+
+			// Zero the memory used for the array and free it (the inline one goes away with the struct)
+			memset((*v)->elements, 0, (*v)->vector_size * (*v)->element_size);
+			if ((*v)->elements != vec_util_inline(*v)) free((*v)->elements);
+		}
 
 		// Zero the memory used for the whole struct and free it
 		memset((*v), 0, sizeof(vector));
@@ -125,7 +232,7 @@ void vec_delete(vector** v) {
  */
 void vec_insert_at(vector* v, void* x, size_t i) {
 
-	if (v != NULL && i < v->vector_size && x != NULL) {
+	if (v != NULL && i < v->vector_size && x != NULL && v->mapping == NULL) {
 
 		/* Get the i - th element's position
 		 * Casting the array as char* lets us perform pointer operations
@@ -136,6 +243,9 @@ void vec_insert_at(vector* v, void* x, size_t i) {
 
 		// Write the value pointed to by x into the found position
 		memcpy(ithPtr, x, v->element_size);
+
+		// Writing past the last live element extends the logical length
+		if (i >= v->length) v->length = i + 1;
 	}
 }
 
@@ -148,7 +258,7 @@ void vec_insert_at(vector* v, void* x, size_t i) {
  */
 void vec_remove_at(vector* v, size_t i) {
 
-	if (v != NULL && i < v->vector_size) {
+	if (v != NULL && i < v->vector_size && v->mapping == NULL) {
 		/* Get the i - th element's position
 		 * Casting the array as char* lets us perform pointer operations
 		 * As we know that every element is 1 byte, the i-th element will be
@@ -204,12 +314,20 @@ void vec_get_2_at(vector* v, size_t i, void* buf) {
 }
 
 /**
- * Returns the vector size of v
+ * Returns the vector size of v, that is the number of
+ * elements it can hold without reallocating (capacity)
  */
 size_t vec_get_size(vector* v) {
 	return (v != NULL) ? v->vector_size : 0;
 }
 
+/**
+ * Returns the logical length of v, that is the number of live elements
+ */
+size_t vec_get_length(vector* v) {
+	return (v != NULL) ? v->length : 0;
+}
+
 /**
  * Returns the element size of v
  */
@@ -220,26 +338,33 @@ size_t vec_get_element_size(vector* v) {
 /**
  * Checks if the element pointed to by x is present in the vector
  * 
- * The value returned is actually it's position in the array
- * from 1 to vector_size (not from 0 to vector_size-1)
+ * Only the live elements are checked, the value returned is actually it's position in the array
+ * from 1 to length (not from 0 to length-1)
  */
 short vec_contains(vector* v, void* x) {
 
-	int isPresent = 0, index = 0;
+	size_t index = vec_find_index(v, x);
 
-	// Iterate through the vector and compare with each element
-	if (v != NULL && x != NULL) {
+	return index != SIZE_MAX ? (short)(index + 1) : 0;
+}
 
-		for (index = 0; index < v->vector_size; index++) {
+/**
+ * Returns the position (from 0 to length - 1) of the first live element equal to the one pointed to by x
+ *
+ * SIZE_MAX is returned if no element is equal to x (or the pointers are invalid)
+ */
+size_t vec_find_index(vector* v, void* x) {
 
-			// Compare the i -th element with the element pointed to by x
-			isPresent = (memcmp((char*)v->elements + index * v->element_size, x, v->element_size) == 0);
-			if (isPresent)
-				break;
-		}
-	}
+	size_t index = SIZE_MAX;
 
-	return isPresent ? index + 1 : 0;
+	// The kernel walks the live elements, returning length when none of them matches
+	if (v != NULL && x != NULL) {
+
+		index = v->find(v->elements, v->length, v->element_size, x);
+		if (index == v->length)
+			index = SIZE_MAX;
+	}
+	return index;
 }
 
 /**
@@ -274,17 +399,18 @@ short vec_is_index_empty(vector* v, size_t i) {
  */
 void vec_clear(vector* v) {
 
-	if (v != NULL) {
+	if (v != NULL && v->mapping == NULL) {
 
 		// Consider the whole array as an array of chars (so we can write byte by byte)
 		char* ptr = (char*)v->elements;
 
 		memset(ptr, '\0', v->vector_size * v->element_size);
+		v->length = 0;
 	}
 }
 
 /**
- * Applies the function f to every element
+ * Applies the function f to every live element
  * of the vector v
  */
 void vec_for_each(vector* v, void (*f)(void*)) {
@@ -296,8 +422,8 @@ void vec_for_each(vector* v, void (*f)(void*)) {
 		void* tmp_buf = malloc(v->element_size);
 		if (tmp_buf) {
 
-			// Apply the function to each element
-			for (int i = 0; i < v->vector_size; i++) {
+			// Apply the function to each live element
+			for (size_t i = 0; i < v->length; i++) {
 
 				// Get a copy of the element for safety reasons
 				vec_get_2_at(v, i, tmp_buf);
@@ -313,7 +439,7 @@ void vec_for_each(vector* v, void (*f)(void*)) {
 
 /**
  * Returns a vector obtained by applying
- * the function f to every element of the vector v
+ * the function f to every live element of the vector v
  */
 vector* vec_map(vector* v, void* (*f)(void*)) {
 	
@@ -325,12 +451,14 @@ vector* vec_map(vector* v, void* (*f)(void*)) {
 		mapped = vec_create(v->vector_size, v->element_size);
 		if (mapped) {
 
+			mapped->growth_factor = v->growth_factor;
+
 			// Iterate the vector
 			void* tmp_buf = malloc(v->element_size);
 			if (tmp_buf) {
 
-				// Apply the function to each element and insert it in the new vector
-				for (int i = 0; i < v->vector_size; i++) {
+				// Apply the function to each live element and insert it in the new vector
+				for (size_t i = 0; i < v->length; i++) {
 
 					// Get a copy of the element for safety reasons
 					vec_get_2_at(v, i, tmp_buf);
@@ -343,4 +471,796 @@ vector* vec_map(vector* v, void* (*f)(void*)) {
 		}
 	}
 	return mapped;
+}
+
+/**
+ * Applies the function f to every live element of the vector v, splitting
+ * the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * f gets a copy of the element, like in vec_for_each, and is called
+ * by many threads at the same time, so it must be thread safe
+ */
+void vec_parallel_for_each(vector* v, void (*f)(void*), size_t threads) {
+
+	if (v && f) {
+
+		vec_parallel_task task = { 0 };
+		task.v = v;
+		task.f = f;
+		parallel_util_for(v->length, VECTOR_PARALLEL_GRAIN, threads, vec_util_parallel_for_each, &task);
+	}
+	return;
+}
+
+/**
+ * Returns a vector obtained by applying the function f to every live element
+ * of the vector v, splitting the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * f is called by many threads at the same time, so it must be thread safe
+ * (and return a pointer that stays valid until it's called again by the same thread)
+ */
+vector* vec_parallel_map(vector* v, void* (*f)(void*), size_t threads) {
+
+	vector* mapped = NULL;
+
+	if (v && f) {
+
+		mapped = vec_create(v->vector_size, v->element_size);
+		if (mapped) {
+
+			mapped->growth_factor = v->growth_factor;
+
+			// Every chunk writes its own slots of the new buffer, the length is set once at the end
+			vec_parallel_task task = { 0 };
+			task.v = v;
+			task.mapped = mapped;
+			task.map = f;
+			parallel_util_for(v->length, VECTOR_PARALLEL_GRAIN, threads, vec_util_parallel_map, &task);
+			mapped->length = v->length;
+		}
+	}
+	return mapped;
+}
+
+/**
+ * Combines every live element of the vector v into buf, starting from the value pointed to by identity,
+ * splitting the elements in chunks that are handled by (at most) the given number of threads
+ *
+ * combine(acc, x) folds the element x into the accumulator acc (both element_size bytes), it must be
+ * associative and identity must be its neutral element, since each chunk is folded on its own
+ * and the partial results are then combined in order (so combine doesn't need to be commutative)
+ */
+void vec_reduce(vector* v, void* identity, void (*combine)(void*, void*), void* buf, size_t threads) {
+
+	if (v && identity && combine && buf) {
+
+		size_t chunks = v->length / VECTOR_PARALLEL_GRAIN + (v->length % VECTOR_PARALLEL_GRAIN != 0);
+
+		vec_parallel_task task = { 0 };
+		task.v = v;
+		task.combine = combine;
+		task.identity = identity;
+		task.partials = chunks > 0 ? (char*)malloc(chunks * v->element_size) : NULL;
+
+		memcpy(buf, identity, v->element_size);
+		if (task.partials) {
+
+			parallel_util_for(v->length, VECTOR_PARALLEL_GRAIN, threads, vec_util_parallel_reduce, &task);
+
+			// The partial results are combined in the order of their chunks
+			for (size_t i = 0; i < chunks; i++) combine(buf, task.partials + i * v->element_size);
+			free(task.partials);
+		}
+
+		// Not enough memory for the partial results, fold everything in the calling thread
+		else {
+			for (size_t i = 0; i < v->length; i++) combine(buf, (char*)v->elements + i * v->element_size);
+		}
+	}
+	return;
+}
+
+/**
+ * Appends the element pointed to by x after the last live element
+ *
+ * If the buffer is full, its capacity is multiplied by the growth factor,
+ * so that a sequence of n appends costs O(n) amortized
+ */
+void vec_push_back(vector* v, void* x) {
+
+	if (v && x && !v->mapping) {
+
+		// Grow the buffer if there is no room for another element
+		if (v->length < v->vector_size || vec_util_grow(v, v->length + 1)) {
+
+			memcpy((char*)v->elements + v->length * v->element_size, x, v->element_size);
+			v->length++;
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the last live element of the vector
+ */
+void vec_pop_back(vector* v) {
+
+	if (v && v->length > 0 && !v->mapping) {
+
+		v->length--;
+		memset((char*)v->elements + v->length * v->element_size, 0, v->element_size);
+	}
+	return;
+}
+
+/**
+ * Removes the last live element of the vector and copies it in the given buffer
+ */
+void vec_pop_2_back(vector* v, void* buf) {
+
+	if (v && buf && v->length > 0 && !v->mapping) {
+
+		vec_get_2_at(v, v->length - 1, buf);
+		vec_pop_back(v);
+	}
+	return;
+}
+
+/**
+ * Makes sure the vector can hold at least capacity elements
+ * without reallocating, the length is not modified
+ */
+void vec_reserve(vector* v, size_t capacity) {
+
+	if (v && capacity > v->vector_size && !v->mapping) {
+
+		vec_util_reallocate(v, capacity);
+	}
+	return;
+}
+
+/**
+ * Sets the logical length of the vector to new_length
+ *
+ * If the vector grows, the new elements are all zeros
+ * If it shrinks, the removed elements are zeroed
+ */
+void vec_resize(vector* v, size_t new_length) {
+
+	if (v && !v->mapping) {
+
+		// Shrinking, zero the elements that are not live anymore
+		if (new_length < v->length) {
+
+			memset((char*)v->elements + new_length * v->element_size, 0, (v->length - new_length) * v->element_size);
+			v->length = new_length;
+		}
+
+		// Growing, the buffer past length is always zeroed so there is nothing to write
+		else if (new_length <= v->vector_size || vec_util_reallocate(v, new_length)) {
+
+			v->length = new_length;
+		}
+	}
+	return;
+}
+
+/**
+ * Reduces the capacity of the vector to its length
+ * (a vector always keeps room for at least one element)
+ */
+void vec_shrink_to_fit(vector* v) {
+
+	if (v && !v->mapping) {
+
+		size_t new_capacity = v->length > 0 ? v->length : 1;
+		if (new_capacity < v->vector_size) vec_util_reallocate(v, new_capacity);
+	}
+	return;
+}
+
+/**
+ * Sets the factor used to enlarge the buffer when appending to a full vector
+ *
+ * The factor has to be greater than 1, otherwise the call is ignored
+ */
+void vec_set_growth_factor(vector* v, double growth_factor) {
+
+	if (v && growth_factor > 1.0) v->growth_factor = growth_factor;
+	return;
+}
+
+/**
+ * Returns the growth factor of v
+ */
+double vec_get_growth_factor(vector* v) {
+
+	return v ? v->growth_factor : 0.0;
+}
+
+/**
+ * Sorts the live elements of the vector according to the compare function (not stable)
+ *
+ * Introsort: quicksort with a median of three pivot, that switches to heapsort when the
+ * recursion gets too deep (so it's always O(n log n)) and to insertion sort on small ranges
+ */
+void vec_sort(vector* v, int (*compare)(void*, void*)) {
+
+	if (v && compare && v->length > 1 && !v->mapping) {
+
+		// Quicksort can go 2 log2(n) levels deep before heapsort takes over
+		size_t depth = 0;
+		for (size_t n = v->length; n > 1; n >>= 1) depth += 2;
+
+		vec_util_introsort((char*)v->elements, v->length, v->element_size, compare, depth);
+	}
+	return;
+}
+
+/**
+ * Sorts the live elements of the vector, treating them as integers (signed or unsigned)
+ *
+ * LSD radix sort on 8 bit digits, it takes O(n) time for each byte of the elements and makes no
+ * comparisons, only vectors whose elements are 1, 2, 4 or 8 bytes long are sorted, and the vector is
+ * left unchanged if the buffer needed for the passes can't be allocated
+ */
+void vec_radix_sort(vector* v, bool is_signed) {
+
+	size_t size = v ? v->element_size : 0;
+
+	if (v && v->length > 1 && !v->mapping && (size == 1 || size == 2 || size == 4 || size == 8)) {
+
+		size_t n = v->length;
+		char* buf = (char*)malloc(n * size);
+		size_t* counts = (size_t*)calloc(size * 256, sizeof(size_t));
+
+		if (buf && counts) {
+
+			// The histograms of every digit are computed together, in a single read of the elements
+			for (size_t i = 0; i < n; i++) {
+
+				uint64_t key = vec_util_radix_key((char*)v->elements + i * size, size, is_signed);
+				for (size_t d = 0; d < size; d++) counts[d * 256 + ((key >> (8 * d)) & 0xFF)]++;
+			}
+
+			char* src = (char*)v->elements;
+			char* dst = buf;
+			for (size_t d = 0; d < size; d++) {
+
+				size_t* count = counts + d * 256;
+
+				// A digit that is the same for every element doesn't change the order
+				bool skip = false;
+				for (size_t b = 0; b < 256 && !skip; b++) skip = (count[b] == n);
+
+				if (!skip) {
+
+					// Turn the counts into the starting position of each digit, then move the elements there
+					size_t position = 0;
+					for (size_t b = 0; b < 256; b++) {
+						size_t c = count[b];
+						count[b] = position;
+						position += c;
+					}
+					for (size_t i = 0; i < n; i++) {
+
+						uint64_t key = vec_util_radix_key(src + i * size, size, is_signed);
+						memcpy(dst + (count[(key >> (8 * d)) & 0xFF]++) * size, src + i * size, size);
+					}
+
+					char* tmp = src;
+					src = dst;
+					dst = tmp;
+				}
+			}
+
+			if (src != (char*)v->elements) memcpy(v->elements, src, n * size);
+		}
+		free(buf);
+		free(counts);
+	}
+	return;
+}
+
+/**
+ * Sorts the live elements of the vector according to the compare function, equal elements keep their order
+ *
+ * Bottom-up merge sort on runs sorted by insertion sort, it needs a buffer as big as the live elements
+ * (without it, the vector is sorted by insertion sort alone)
+ */
+void vec_stable_sort(vector* v, int (*compare)(void*, void*)) {
+
+	if (v && compare && v->length > 1 && !v->mapping) {
+
+		size_t n = v->length;
+		size_t size = v->element_size;
+		char* buf = (char*)malloc(n * size);
+
+		if (buf) {
+
+			// Short runs are sorted in place, then merged in pairs into the other buffer, back and forth
+			for (size_t i = 0; i < n; i += VECTOR_SORT_INSERTION)
+				vec_util_insertion_sort((char*)v->elements + i * size, (n - i < VECTOR_SORT_INSERTION) ? n - i : VECTOR_SORT_INSERTION, size, compare);
+
+			char* src = (char*)v->elements;
+			char* dst = buf;
+			for (size_t width = VECTOR_SORT_INSERTION; width < n; width *= 2) {
+
+				for (size_t i = 0; i < n; i += 2 * width) {
+
+					size_t na = (n - i < width) ? n - i : width;
+					size_t nb = (n - i - na < width) ? n - i - na : width;
+					vec_util_merge(src + i * size, na, nb, dst + i * size, size, compare);
+				}
+
+				char* tmp = src;
+				src = dst;
+				dst = tmp;
+			}
+
+			if (src != (char*)v->elements) memcpy(v->elements, src, n * size);
+			free(buf);
+		}
+		else vec_util_insertion_sort((char*)v->elements, n, size, compare);
+	}
+	return;
+}
+
+/**
+ * Sorts the live elements of the vector according to the compare function (not stable), using (at most) the given number of threads
+ *
+ * The elements are split in blocks that are sorted by introsort at the same time,
+ * then the blocks are merged in pairs, many merges at the same time, until one is left
+ *
+ * The compare function is called by many threads at the same time, so it must be thread safe
+ */
+void vec_sort_parallel(vector* v, int (*compare)(void*, void*), size_t threads) {
+
+	if (v && compare && v->length > 1 && !v->mapping) {
+
+		size_t n = v->length;
+		char* buf = (threads > 1 && n >= 2 * VECTOR_SORT_PARALLEL_GRAIN) ? (char*)malloc(n * v->element_size) : NULL;
+
+		if (buf) {
+
+			// One block for each thread, unless that makes them too small
+			size_t block = n / threads + (n % threads != 0);
+			if (block < VECTOR_SORT_PARALLEL_GRAIN) block = VECTOR_SORT_PARALLEL_GRAIN;
+
+			vec_sort_task task;
+			task.n = n;
+			task.element_size = v->element_size;
+			task.compare = compare;
+			task.src = (char*)v->elements;
+			task.dst = buf;
+			task.width = block;
+
+			parallel_util_for(n, block, threads, vec_util_parallel_sort, &task);
+
+			// Every round merges pairs of runs into the other buffer, the runs double each time
+			for (; task.width < n; task.width *= 2) {
+
+				size_t pairs = n / (2 * task.width) + (n % (2 * task.width) != 0);
+				parallel_util_for(pairs, 1, threads, vec_util_parallel_merge, &task);
+
+				char* tmp = task.src;
+				task.src = task.dst;
+				task.dst = tmp;
+			}
+
+			if (task.src != (char*)v->elements) memcpy(v->elements, task.src, n * v->element_size);
+			free(buf);
+		}
+
+		// Too few elements (or threads) to be worth it, or no memory for the merges
+		else vec_sort(v, compare);
+	}
+	return;
+}
+
+/**
+ * Writes the live elements of the vector in a snapshot in the given file (which is replaced)
+ *
+ * The snapshot can be mapped back by vec_open_mmap, true is returned if it was written entirely
+ */
+bool vec_save(vector* v, const char* path) {
+
+	bool saved = false;
+	snapshot_writer w;
+
+	if (v && path && snapshot_util_begin(&w, path, SNAPSHOT_VECTOR, sizeof(vec_snapshot))) {
+
+		vec_snapshot descriptor;
+		descriptor.element_size = v->element_size;
+		descriptor.length = v->length;
+		descriptor.elements = snapshot_util_section(&w);
+
+		snapshot_util_write(&w, v->elements, v->length * v->element_size);
+		saved = snapshot_util_end(&w, &descriptor, sizeof(vec_snapshot));
+	}
+	return saved;
+}
+
+/**
+ * Maps the snapshot written by vec_save in the given file, and returns a vector that reads its elements in place
+ *
+ * Nothing is copied, so opening takes the same time whatever the length, and only the pages that are
+ * read get loaded. The vector is read-only: the functions that would modify it leave it unchanged,
+ * and the elements pointed to by vec_get_at must not be written. Deleting it unmaps the file
+ *
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of a vector
+ */
+vector* vec_open_mmap(const char* path) {
+
+	vector* v = NULL;
+	vec_snapshot descriptor;
+	snapshot* s = snapshot_util_open(path, SNAPSHOT_VECTOR, &descriptor, sizeof(vec_snapshot));
+
+	if (s) {
+
+		const void* elements = NULL;
+
+		if (descriptor.element_size > 0 && descriptor.length <= SIZE_MAX / descriptor.element_size) {
+
+			elements = snapshot_util_at(s, descriptor.elements, descriptor.length * descriptor.element_size);
+		}
+		v = elements ? (vector*)malloc(sizeof(vector)) : NULL;
+
+		if (v) {
+
+			v->elements = (void*)elements;
+			v->vector_size = (size_t)descriptor.length;
+			v->length = (size_t)descriptor.length;
+			v->growth_factor = VECTOR_DEFAULT_GROWTH_FACTOR;
+			v->element_size = (size_t)descriptor.element_size;
+			v->find = search_util_select(v->element_size);
+			v->mapping = s;
+			v->inline_capacity = 0;
+		}
+		else snapshot_util_close(&s);
+	}
+	return v;
+}
+
+/* Utility function used to enlarge the buffer so that it can hold at least min_capacity elements */
+bool vec_util_grow(vector* v, size_t min_capacity) {
+
+	size_t max_capacity = SIZE_MAX / v->element_size;
+	size_t new_capacity = max_capacity;
+
+	// Geometric growth, unless it would overflow
+	if ((double)v->vector_size * v->growth_factor < (double)max_capacity) {
+
+		new_capacity = (size_t)((double)v->vector_size * v->growth_factor);
+	}
+
+	// Small vectors with small factors could end up not growing at all
+	if (new_capacity < min_capacity) new_capacity = min_capacity;
+
+	return min_capacity <= max_capacity && vec_util_reallocate(v, new_capacity);
+}
+
+/* Utility function used to reallocate the buffer to exactly new_capacity elements */
+bool vec_util_reallocate(vector* v, size_t new_capacity) {
+
+	bool done = false;
+
+	if (0 < new_capacity && new_capacity <= SIZE_MAX / v->element_size) {
+
+		void* inline_elements = vec_util_inline(v);
+		void* new_elements = NULL;
+		size_t kept = (v->vector_size < new_capacity ? v->vector_size : new_capacity) * v->element_size;
+
+		// The inline buffer is used whenever it's big enough
+		if (new_capacity <= v->inline_capacity) {
+
+			new_elements = inline_elements;
+			if (v->elements != inline_elements) {
+
+				memcpy(new_elements, v->elements, kept);
+				free(v->elements);
+			}
+		}
+
+		// Spill from the inline buffer, or resize the one already allocated
+		else if (v->elements == inline_elements) {
+
+			new_elements = malloc(new_capacity * v->element_size);
+			if (new_elements) memcpy(new_elements, v->elements, kept);
+		}
+		else new_elements = realloc(v->elements, new_capacity * v->element_size);
+
+		if (new_elements) {
+
+			// Everything past the old capacity has to be zeroed, as calloc would do
+			if (new_capacity > v->vector_size) {
+
+				memset((char*)new_elements + v->vector_size * v->element_size, 0, (new_capacity - v->vector_size) * v->element_size);
+			}
+
+			v->elements = new_elements;
+			v->vector_size = new_capacity;
+			if (v->length > new_capacity) v->length = new_capacity;
+			done = true;
+		}
+	}
+	return done;
+}
+
+/* Utility function used to create a vector whose first inline_capacity elements are stored after the struct */
+vector* vec_util_create(size_t vector_size, size_t element_size, size_t inline_capacity) {
+
+	vector* v = NULL;
+
+	// Check if the sizes are correct, that is, at least 1
+	if (vector_size > 0 && element_size > 0) {
+
+		/* And not too big(consequence of passing a negative value to a size_t parameter)
+		 * The maximum length of the array is LONG_MAX, so vector_size * element_size should be at most, LONG_MAX
+		 */
+		if (vector_size <= SIZE_MAX / element_size && inline_capacity <= (SIZE_MAX - VECTOR_INLINE_OFFSET) / element_size) {
+
+			// Sizes are correct, we can allocate memory for the struct (and the inline buffer)
+			v = (vector*)malloc(inline_capacity > 0 ? VECTOR_INLINE_OFFSET + inline_capacity * element_size : sizeof(vector));
+
+			// If the allocation was successful
+			if (v != NULL) {
+				v->vector_size = vector_size;
+				v->element_size = element_size;
+				v->find = search_util_select(element_size);
+				v->mapping = NULL;
+				v->length = 0;
+				v->growth_factor = VECTOR_DEFAULT_GROWTH_FACTOR;
+				v->inline_capacity = inline_capacity;
+
+				if (vector_size <= inline_capacity) {
+
+					v->elements = vec_util_inline(v);
+					memset(v->elements, 0, vector_size * element_size);
+				}
+				else v->elements = calloc(v->vector_size, v->element_size);
+
+				// Check if the array's memory allocation was successful
+				if (v->elements == NULL) {
+
+					// In case the allocation failed, revert the allocation for vector
+					free(v);
+					v = NULL;
+				}
+			}
+		}
+	}
+	return v;
+}
+
+/* Utility function used to get the inline buffer of a vector */
+void* vec_util_inline(vector* v) {
+
+	return v->inline_capacity > 0 ? (char*)v + VECTOR_INLINE_OFFSET : NULL;
+}
+
+
+/* Utility function used as the body of vec_parallel_for_each, applies f to a copy of each element of the chunk */
+void vec_util_parallel_for_each(void* context, size_t from, size_t to) {
+
+	vec_parallel_task* task = (vec_parallel_task*)context;
+	vector* v = task->v;
+	void* tmp_buf = malloc(v->element_size);
+
+	if (tmp_buf) {
+		for (size_t i = from; i < to; i++) {
+
+			memcpy(tmp_buf, (char*)v->elements + i * v->element_size, v->element_size);
+			task->f(tmp_buf);
+		}
+		free(tmp_buf);
+	}
+	return;
+}
+
+/* Utility function used as the body of vec_parallel_map, writes the mapped elements of the chunk in the new vector */
+void vec_util_parallel_map(void* context, size_t from, size_t to) {
+
+	vec_parallel_task* task = (vec_parallel_task*)context;
+	vector* v = task->v;
+	void* tmp_buf = malloc(v->element_size);
+
+	if (tmp_buf) {
+		for (size_t i = from; i < to; i++) {
+
+			memcpy(tmp_buf, (char*)v->elements + i * v->element_size, v->element_size);
+
+			void* res = task->map(tmp_buf);
+			if (res) memcpy((char*)task->mapped->elements + i * v->element_size, res, v->element_size);
+		}
+		free(tmp_buf);
+	}
+	return;
+}
+
+/* Utility function used as the body of vec_reduce, folds the elements of the chunk in the accumulator of the chunk */
+void vec_util_parallel_reduce(void* context, size_t from, size_t to) {
+
+	vec_parallel_task* task = (vec_parallel_task*)context;
+	vector* v = task->v;
+	char* acc = task->partials + (from / VECTOR_PARALLEL_GRAIN) * v->element_size;
+
+	memcpy(acc, task->identity, v->element_size);
+	for (size_t i = from; i < to; i++) task->combine(acc, (char*)v->elements + i * v->element_size);
+	return;
+}
+
+/* Utility function used to swap two elements that are size bytes long */
+void vec_util_swap(char* a, char* b, size_t size) {
+
+	char tmp[64];
+
+	// A chunk at a time, so that no memory needs to be allocated for big elements
+	while (size > 0) {
+
+		size_t chunk = size < sizeof(tmp) ? size : sizeof(tmp);
+		memcpy(tmp, a, chunk);
+		memcpy(a, b, chunk);
+		memcpy(b, tmp, chunk);
+		a += chunk;
+		b += chunk;
+		size -= chunk;
+	}
+	return;
+}
+
+/* Utility function used to sort a (small) range by insertion sort, equal elements keep their order */
+void vec_util_insertion_sort(char* base, size_t n, size_t size, int (*compare)(void*, void*)) {
+
+	for (size_t i = 1; i < n; i++) {
+
+		// Move the i -th element back until the one before it isn't greater
+		for (size_t j = i; j > 0 && compare(base + (j - 1) * size, base + j * size) > 0; j--)
+			vec_util_swap(base + (j - 1) * size, base + j * size, size);
+	}
+	return;
+}
+
+/* Utility function used to sort a range by heapsort, used when quicksort goes too deep */
+void vec_util_heap_sort(char* base, size_t n, size_t size, int (*compare)(void*, void*)) {
+
+	// Build a max heap, then move its root after the heap one element at a time
+	for (size_t i = n / 2; i-- > 0; ) {
+
+		for (size_t root = i, child; (child = 2 * root + 1) < n; root = child) {
+
+			if (child + 1 < n && compare(base + child * size, base + (child + 1) * size) < 0) child++;
+			if (compare(base + root * size, base + child * size) >= 0) break;
+			vec_util_swap(base + root * size, base + child * size, size);
+		}
+	}
+	for (size_t end = n - 1; end > 0; end--) {
+
+		vec_util_swap(base, base + end * size, size);
+		for (size_t root = 0, child; (child = 2 * root + 1) < end; root = child) {
+
+			if (child + 1 < end && compare(base + child * size, base + (child + 1) * size) < 0) child++;
+			if (compare(base + root * size, base + child * size) >= 0) break;
+			vec_util_swap(base + root * size, base + child * size, size);
+		}
+	}
+	return;
+}
+
+/* Utility function used to sort a range by introsort, depth is the number of partitions left before switching to heapsort */
+void vec_util_introsort(char* base, size_t n, size_t size, int (*compare)(void*, void*), size_t depth) {
+
+	while (n > VECTOR_SORT_INSERTION) {
+
+		if (depth == 0) {
+			vec_util_heap_sort(base, n, size, compare);
+			return;
+		}
+		depth--;
+
+		// Median of the first, middle and last element, then moved to the front as the pivot
+		char* mid = base + (n / 2) * size;
+		char* last = base + (n - 1) * size;
+		if (compare(mid, base) < 0) vec_util_swap(mid, base, size);
+		if (compare(last, mid) < 0) {
+			vec_util_swap(last, mid, size);
+			if (compare(mid, base) < 0) vec_util_swap(mid, base, size);
+		}
+		vec_util_swap(base, mid, size);
+
+		/* Hoare partition, the last element (not less than the pivot) and
+		 * the pivot itself stop the scans without checking the bounds
+		 */
+		size_t i = 1, j = n - 1;
+		for (;;) {
+
+			while (compare(base + i * size, base) < 0) i++;
+			while (compare(base, base + j * size) < 0) j--;
+			if (i >= j) break;
+			vec_util_swap(base + i * size, base + j * size, size);
+			i++;
+			j--;
+		}
+		vec_util_swap(base, base + j * size, size);
+
+		// Recurse on the smaller side, so that the stack stays O(log n), and loop on the bigger one
+		if (j < n - j - 1) {
+			vec_util_introsort(base, j, size, compare, depth);
+			base += (j + 1) * size;
+			n -= j + 1;
+		}
+		else {
+			vec_util_introsort(base + (j + 1) * size, n - j - 1, size, compare, depth);
+			n = j;
+		}
+	}
+	vec_util_insertion_sort(base, n, size, compare);
+	return;
+}
+
+/* Utility function used to merge the sorted runs a[0, na) and a[na, na + nb) into out, equal elements keep their order */
+void vec_util_merge(char* a, size_t na, size_t nb, char* out, size_t size, int (*compare)(void*, void*)) {
+
+	char* b = a + na * size;
+	char* a_end = b;
+	char* b_end = b + nb * size;
+
+	while (a < a_end && b < b_end) {
+
+		// On ties the element of the first run goes first
+		if (compare(b, a) < 0) {
+			memcpy(out, b, size);
+			b += size;
+		}
+		else {
+			memcpy(out, a, size);
+			a += size;
+		}
+		out += size;
+	}
+	memcpy(out, a, a_end - a);
+	memcpy(out + (a_end - a), b, b_end - b);
+	return;
+}
+
+/* Utility function that reads an element as an unsigned integer, moving the sign bit of signed ones so that the order is kept */
+uint64_t vec_util_radix_key(const char* element, size_t size, bool is_signed) {
+
+	uint64_t key = 0;
+
+	switch (size) {
+	case 1: { uint8_t x; memcpy(&x, element, 1); key = x; break; }
+	case 2: { uint16_t x; memcpy(&x, element, 2); key = x; break; }
+	case 4: { uint32_t x; memcpy(&x, element, 4); key = x; break; }
+	default: { uint64_t x; memcpy(&x, element, 8); key = x; break; }
+	}
+	if (is_signed) key ^= (uint64_t)1 << (8 * size - 1);
+	return key;
+}
+
+/* Utility function used as the body of the parallel sort, sorts the elements of a block */
+void vec_util_parallel_sort(void* context, size_t from, size_t to) {
+
+	vec_sort_task* task = (vec_sort_task*)context;
+	size_t depth = 0;
+
+	for (size_t n = to - from; n > 1; n >>= 1) depth += 2;
+	vec_util_introsort(task->src + from * task->element_size, to - from, task->element_size, task->compare, depth);
+	return;
+}
+
+/* Utility function used as the body of the parallel sort, merges the pairs of runs from 'from' to 'to' into the other buffer */
+void vec_util_parallel_merge(void* context, size_t from, size_t to) {
+
+	vec_sort_task* task = (vec_sort_task*)context;
+	size_t size = task->element_size;
+
+	for (size_t p = from; p < to; p++) {
+
+		size_t i = p * 2 * task->width;
+		size_t na = (task->n - i < task->width) ? task->n - i : task->width;
+		size_t nb = (task->n - i - na < task->width) ? task->n - i - na : task->width;
+		vec_util_merge(task->src + i * size, na, nb, task->dst + i * size, size, task->compare);
+	}
+	return;
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/linear/versioncell.h"
+#include <threads.h>
+#include <string.h>
+
+/* Utility functions used to enter and leave the cell as a reader, and to wait for the readers of the previous epoch */
+atomic_size_t* vcell_util_read_lock(vcell* cell);
+void vcell_util_read_unlock(atomic_size_t* active);
+void vcell_util_synchronize(vcell* cell);
+
+ /**
+  * Struct that represent a cell holding the current version of a persistent structure
+  */
+typedef struct vcell {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Current version */
+	_Atomic(vcell_version*) current;
+
+	/* Current epoch, its parity selects which counter new readers use */
+	atomic_size_t epoch;
+
+	/* Readers inside vcell_acquire, for each of the two epoch parities */
+	atomic_size_t readers[2];
+
+	/* Serializes the writers waiting for the readers to leave an epoch */
+	mtx_t sync_lock;
+} vcell;
+
+/**
+ * Creates a cell holding the given version (a PAVL or a pvector), the reference of the caller is moved into the cell
+ */
+vcell* vcell_create(void* version) {
+
+	vcell* cell = NULL;
+
+	if (version) {
+
+		cell = (vcell*)malloc(sizeof(vcell));
+		if (cell) {
+
+			if (mtx_init(&cell->sync_lock, mtx_plain) == thrd_success) {
+
+				atomic_init(&cell->current, (vcell_version*)version);
+				atomic_init(&cell->epoch, 0);
+				atomic_init(&cell->readers[0], 0);
+				atomic_init(&cell->readers[1], 0);
+			}
+			else {
+
+				free(cell);
+				cell = NULL;
+			}
+		}
+	}
+	return cell;
+}
+
+/**
+ * Deletes the given cell, releasing the version it holds
+ *
+ * No reader nor writer may be using the cell meanwhile
+ */
+void vcell_delete(vcell** cell) {
+
+	if (cell && *cell) {
+
+		vcell_release(atomic_load(&(*cell)->current));
+		mtx_destroy(&(*cell)->sync_lock);
+		free(*cell);
+		*cell = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns the current version, with a new reference the caller has to release (PAVL_delete, pvec_delete)
+ */
+void* vcell_acquire(vcell* cell) {
+
+	vcell_version* version = NULL;
+
+	if (cell) {
+
+		// The version can't be released between loading it and retaining it, its writer waits for this counter
+		atomic_size_t* active = vcell_util_read_lock(cell);
+		version = (vcell_version*)vcell_retain(atomic_load(&cell->current));
+		vcell_util_read_unlock(active);
+	}
+	return version;
+}
+
+/**
+ * Replaces the current version with the given one, the reference of the caller is moved into the cell
+ *
+ * The replaced version is released after the readers that could be retaining it have left,
+ * so the call waits for them (only the readers inside vcell_acquire, never the ones holding a version)
+ */
+void vcell_publish(vcell* cell, void* version) {
+
+	if (cell && version) {
+
+		vcell_version* old = atomic_exchange(&cell->current, (vcell_version*)version);
+
+		vcell_util_synchronize(cell);
+		vcell_release(old);
+	}
+	return;
+}
+
+/**
+ * Adds a reference to a version, returns the version itself
+ */
+void* vcell_retain(void* version) {
+
+	if (version) atomic_fetch_add_explicit(&((vcell_version*)version)->refs, 1, memory_order_relaxed);
+	return version;
+}
+
+/**
+ * Releases a reference to a version, freeing it if it was the last one
+ */
+void vcell_release(void* version) {
+
+	if (version && atomic_fetch_sub_explicit(&((vcell_version*)version)->refs, 1, memory_order_acq_rel) == 1) {
+
+		((vcell_version*)version)->destroy(version);
+	}
+	return;
+}
+
+/* Utility function that enters the cell as a reader, returns the counter to give back to vcell_util_read_unlock */
+atomic_size_t* vcell_util_read_lock(vcell* cell) {
+
+	atomic_size_t* active = NULL;
+
+	for (;;) {
+
+		size_t epoch = atomic_load(&cell->epoch);
+		active = &cell->readers[epoch & 1];
+		atomic_fetch_add(active, 1);
+
+		// If the epoch moved on meanwhile, a writer may have already checked this counter
+		if (atomic_load(&cell->epoch) == epoch) break;
+		atomic_fetch_sub(active, 1);
+	}
+	return active;
+}
+
+/* Utility function that releases the counter taken by vcell_util_read_lock */
+void vcell_util_read_unlock(atomic_size_t* active) {
+
+	atomic_fetch_sub_explicit(active, 1, memory_order_release);
+	return;
+}
+
+/* Utility function that waits until every reader that could see the replaced version has left */
+void vcell_util_synchronize(vcell* cell) {
+
+	mtx_lock(&cell->sync_lock);
+
+	// New readers go to the other parity, so the old one can only drain
+	size_t parity = atomic_fetch_add(&cell->epoch, 1) & 1;
+	while (atomic_load(&cell->readers[parity]) != 0) thrd_yield();
+
+	mtx_unlock(&cell->sync_lock);
+	return;
+}
\ No newline at end of file
@@ -3,8 +3,15 @@
 #include "../../include/non-linear/AVL.h"
 #include "../../include/non-linear/BST.h"
 
-binarynode* AVL_util_right_rotation(binarynode* z);
-binarynode* AVL_util_left_rotation(binarynode* z);
+/* Utility functions that rotate the tree with root z, and return its new root */
+binarynode* AVL_util_right_rotation(AVL* avl, binarynode* z);
+binarynode* AVL_util_left_rotation(AVL* avl, binarynode* z);
+
+/* Utility function that restores the balance from the given node up to the root */
+void AVL_util_rebalance(AVL* avl, binarynode* n);
+
+/* Utility function that wraps a tree (that is already balanced) in an AVL */
+AVL* AVL_util_wrap(BST* tree);
 
 /**
  * Struct that implements an AVL tree, a struct that is used to store and then search
@@ -31,6 +38,11 @@ typedef struct AVL {
 
 	/* Actual tree */
 	BST* tree;
+
+#ifdef CDS_WITH_STATS
+	/* Rotations made so far */
+	size_t rotations;
+#endif
 } AVL;
 
 /**
@@ -43,6 +55,9 @@ AVL* AVL_create(size_t element_size, int (*compare)(void*, void*)) {
 	if (avl) {
 
 		avl->tree = BST_create(element_size, compare);
+#ifdef CDS_WITH_STATS
+		avl->rotations = 0;
+#endif
 		if (!avl->tree) {
 
 			free(avl);
@@ -52,6 +67,29 @@ AVL* AVL_create(size_t element_size, int (*compare)(void*, void*)) {
 	return avl;
 }
 
+/**
+ * Creates a tree holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * The tree is perfectly balanced and it's built in O(n) time, without comparing any element
+ */
+AVL* AVL_from_sorted(size_t element_size, int (*compare)(void*, void*), void* elements, size_t n) {
+
+	// A perfectly balanced tree is also an AVL
+	return AVL_util_wrap(BST_from_sorted(element_size, compare, elements, n));
+}
+
+/**
+ * Creates a tree holding the elements of both trees (that need to store elements of the same size, ordered the
+ * same way), the two trees aren't modified
+ *
+ * The elements are merged in order and the new tree is built from them, so it's perfectly balanced and it takes O(n + m) time
+ */
+AVL* AVL_merge(AVL* a, AVL* b) {
+
+	return (a && b) ? AVL_util_wrap(BST_merge(a->tree, b->tree)) : NULL;
+}
+
 /**
  * Deletes the given binary node
  */
@@ -72,56 +110,8 @@ void AVL_insert(AVL* avl, void* x) {
 
 	if (avl && x) {
 
-		// This is the newly added node
-		binarynode* n = binarynode_get_father(BST_insert(avl->tree, x));
-
-		int (*cmp)(void*, void*) = BST_get_compare_func(avl->tree);
-
-		int balance;
-		
-		binarynode* tmp = n;
-
-		while (n) {
-			balance = binarynode_get_balance(n);
-
-
-			// Left inbalance
-			if (balance > 1) {
-
-				if (cmp(x, binarynode_get_value(binarynode_get_left_child(n))) < 0) {
-
-					// LL (RR rotation)
-					n = AVL_util_right_rotation(n);
-				} 
-
-				else {
-
-					// LR (LR rotation)
-					binarynode_set_left_child(n, AVL_util_left_rotation(binarynode_get_left_child(n)));
-					n = AVL_util_right_rotation(n);
-				}
-			}
-
-			// Right inbalance
-			else if (balance < -1) {
-
-
-				if (cmp(x, binarynode_get_value(binarynode_get_right_child(n))) > 0) {
-
-					// RR (LL rotation)
-					n = AVL_util_left_rotation(n);
-				}
-
-				else {
-
-					// RL (RL rotation)
-					binarynode_set_right_child(n, AVL_util_right_rotation(binarynode_get_right_child(n)));
-					n = AVL_util_left_rotation(n);
-				}
-			}
-
-			n = binarynode_get_father(n);
-		}
+		// The trees on the path from the newly added node to the root may be unbalanced
+		AVL_util_rebalance(avl, binarynode_get_father(BST_insert(avl->tree, x)));
 	}
 	return;
 }
@@ -133,54 +123,8 @@ void AVL_remove(AVL* avl, void* x) {
 
 	if (avl && x) {
 
-		// This is the father of the deleted node
-		binarynode* n = BST_remove(avl->tree, x);
-
-		int (*cmp)(void*, void*) = BST_get_compare_func(avl->tree);
-
-		int balance;
-
-		while (n) {
-			balance = binarynode_get_balance(n);
-
-
-			// Left inbalance
-			if (balance > 1) {
-
-				if (cmp(x, binarynode_get_value(binarynode_get_left_child(n))) < 0) {
-
-					// LL (RR rotation)
-					n = AVL_util_right_rotation(n);
-				}
-
-				else {
-
-					// LR (LR rotation)
-					binarynode_set_left_child(n, AVL_util_left_rotation(binarynode_get_left_child(n)));
-					n = AVL_util_right_rotation(n);
-				}
-			}
-
-			// Right inbalance
-			else if (balance < -1) {
-
-
-				if (cmp(x, binarynode_get_value(binarynode_get_right_child(n))) > 0) {
-
-					// RR (LL rotation)
-					n = AVL_util_left_rotation(n);
-				}
-
-				else {
-
-					// RL (RL rotation)
-					binarynode_set_right_child(n, AVL_util_right_rotation(binarynode_get_right_child(n)));
-					n = AVL_util_left_rotation(n);
-				}
-			}
-
-			n = binarynode_get_father(n);
-		}
+		// The trees on the path from the deepest changed node to the root may be unbalanced
+		AVL_util_rebalance(avl, BST_remove(avl->tree, x));
 	}
 	return;
 }
@@ -251,6 +195,84 @@ binarynode* AVL_successor(AVL* avl, binarynode* bn) {
 	return (avl && bn) ? BST_successor(avl->tree, bn) : NULL;
 }
 
+/**
+ * Returns the first node (in order) holding a value that is not less than x, NULL if there's none
+ */
+binarynode* AVL_lower_bound(AVL* avl, void* x) {
+
+	return avl ? BST_lower_bound(avl->tree, x) : NULL;
+}
+
+/**
+ * Returns the first node (in order) holding a value that is greater than x, NULL if there's none
+ */
+binarynode* AVL_upper_bound(AVL* avl, void* x) {
+
+	return avl ? BST_upper_bound(avl->tree, x) : NULL;
+}
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void AVL_range(AVL* avl, void* lo, void* hi, void (*callback)(void*)) {
+
+	if (avl && callback) {
+
+		BST_range(avl->tree, lo, hi, callback);
+	}
+	return;
+}
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void AVL_iterator_init(AVL* avl, AVL_iterator* it, void* lo, void* hi) {
+
+	BST_iterator_init(avl ? avl->tree : NULL, it, lo, hi);
+	return;
+}
+
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool AVL_iterator_has_next(AVL_iterator* it) {
+
+	return BST_iterator_has_next(it);
+}
+
+/**
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
+ */
+void* AVL_iterator_next(AVL_iterator* it) {
+
+	return BST_iterator_next(it);
+}
+
+/**
+ * Returns the node holding the k-th smallest value (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(log n) time, since every node knows the size of its subtree
+ */
+binarynode* AVL_select(AVL* avl, size_t k) {
+
+	return avl ? BST_select(avl->tree, k) : NULL;
+}
+
+/**
+ * Returns the number of values in the tree that are less than x (x doesn't need to be in the tree)
+ *
+ * It takes O(log n) time, since every node knows the size of its subtree
+ */
+size_t AVL_rank(AVL* avl, void* x) {
+
+	return avl ? BST_rank(avl->tree, x) : 0;
+}
+
 /**
  * Traverses the tree in preorder, applying the function callback to each element
  */
@@ -339,38 +361,139 @@ size_t AVL_get_height(AVL* avl) {
 	return avl ? BST_get_height(avl->tree) : 0;
 }
 
+/**
+ * Copies in stats the counters of the tree avl
+ */
+void AVL_get_stats(AVL* avl, AVL_stats* stats) {
+
+	if (stats) {
+
+		BST_stats tree;
+		BST_get_stats(avl ? avl->tree : NULL, &tree);
+
+		memset(stats, 0, sizeof(AVL_stats));
+		stats->nodes = tree.nodes;
+		stats->height = tree.height;
+#ifdef CDS_WITH_STATS
+		if (avl) stats->rotations = avl->rotations;
+#endif
+	}
+	return;
+}
+
 /**
  * Performs a right rotation on the tree with root z
  */
-binarynode* AVL_util_right_rotation(binarynode* z) {
+binarynode* AVL_util_right_rotation(AVL* avl, binarynode* z) {
 
+	binarynode* father = binarynode_get_father(z);
 	binarynode* y = binarynode_get_left_child(z);
 	binarynode* t = binarynode_get_right_child(y);
 
+	STATS_INC(avl->rotations);
+
 	binarynode_set_right_child(y, z);
 	binarynode_set_left_child(z, t);
 
 	binarynode_set_father(t, z);
-	binarynode_set_father(y, binarynode_get_father(z));
+	binarynode_set_father(y, father);
 	binarynode_set_father(z, y);
 
+	// y takes the place of z below its father
+	if (!father) BST_set_root(avl->tree, y);
+	else if (binarynode_get_left_child(father) == z) binarynode_set_left_child(father, y);
+	else binarynode_set_right_child(father, y);
+
+	// z is now below y
+	binarynode_update(z);
+	binarynode_update(y);
+
 	return y;
 }
 
 /**
  * Performs a left rotation on the tree with root z
  */
-binarynode* AVL_util_left_rotation(binarynode* x) {
+binarynode* AVL_util_left_rotation(AVL* avl, binarynode* x) {
 
+	binarynode* father = binarynode_get_father(x);
 	binarynode* y = binarynode_get_right_child(x);
 	binarynode* t = binarynode_get_left_child(y);
 
+	STATS_INC(avl->rotations);
+
 	binarynode_set_left_child(y, x);
 	binarynode_set_right_child(x, t);
 
 	binarynode_set_father(t, x);
-	binarynode_set_father(y, binarynode_get_father(x));
+	binarynode_set_father(y, father);
 	binarynode_set_father(x, y);
 
+	// y takes the place of x below its father
+	if (!father) BST_set_root(avl->tree, y);
+	else if (binarynode_get_left_child(father) == x) binarynode_set_left_child(father, y);
+	else binarynode_set_right_child(father, y);
+
+	// x is now below y
+	binarynode_update(x);
+	binarynode_update(y);
+
 	return y;
+}
+
+/**
+ * Restores the balance from the given node up to the root, the heights and sizes below it have to be up to date
+ */
+void AVL_util_rebalance(AVL* avl, binarynode* n) {
+
+	while (n) {
+
+		binarynode_update(n);
+		int balance = binarynode_get_balance(n);
+
+		// Left inbalance
+		if (balance > 1) {
+
+			// LR, the left child leans right and is rotated first
+			if (binarynode_get_balance(binarynode_get_left_child(n)) < 0) AVL_util_left_rotation(avl, binarynode_get_left_child(n));
+
+			// LL (RR rotation)
+			n = AVL_util_right_rotation(avl, n);
+		}
+
+		// Right inbalance
+		else if (balance < -1) {
+
+			// RL, the right child leans left and is rotated first
+			if (binarynode_get_balance(binarynode_get_right_child(n)) > 0) AVL_util_right_rotation(avl, binarynode_get_right_child(n));
+
+			// RR (LL rotation)
+			n = AVL_util_left_rotation(avl, n);
+		}
+
+		n = binarynode_get_father(n);
+	}
+	return;
+}
+
+/**
+ * Wraps a tree (that is already balanced) in an AVL, the tree is deleted if it can't be wrapped
+ */
+AVL* AVL_util_wrap(BST* tree) {
+
+	AVL* avl = NULL;
+
+	if (tree) {
+
+		avl = (AVL*)malloc(sizeof(AVL));
+		if (avl) {
+
+			avl->tree = tree;
+#ifdef CDS_WITH_STATS
+			avl->rotations = 0;
+#endif
+		}
+		else BST_delete(&tree);
+	}
+	return avl;
 }
\ No newline at end of file
@@ -1,10 +1,21 @@
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../../include/non-linear/BST.h"
 #include "../../include/linear/stack.h"
 
-void BST_util_count(void* x);
-size_t UTIL_COUNT;
+/* Utility functions that return the node holding the previous / next value in order */
+binarynode* BST_util_prev(binarynode* bn);
+binarynode* BST_util_next(binarynode* bn);
+
+/* Utility function that returns the first node (in order) holding a value not less (or, if strict, greater) than x */
+binarynode* BST_util_bound(BST* bst, void* x, bool strict);
+
+/* Utility function that updates the heights and the sizes from the given node up to the root */
+void BST_util_update_path(binarynode* bn);
+
+/* Utility function that builds a perfectly balanced tree from the sorted elements [low, high), returns its root */
+binarynode* BST_util_build(BST* bst, char* elements, size_t low, size_t high, bool* failed);
 
 /**
  * Struct that implements a binary search tree, a struct that is used to store and then search
@@ -34,6 +45,9 @@ typedef struct BST {
 
 	/* Function used to determine the order of values */
 	int (*compare)(void*, void*);
+
+	/* Pool the nodes are taken from, owned by the tree */
+	pool* nodes;
 } BST;
 
 /**
@@ -53,12 +67,87 @@ BST* BST_create(size_t element_size, int (*compare)(void*, void*)) {
 				bst->root = NULL;
 				bst->element_size = element_size;
 				bst->compare = compare;
+				bst->nodes = pool_create(binarynode_get_footprint(element_size));
+
+				// Cancel the creation if the nodes can't be allocated
+				if (!bst->nodes) {
+
+					free(bst);
+					bst = NULL;
+				}
 			}
 		}
 	}
 	return bst;
 }
 
+/**
+ * Creates a tree holding the n elements of the given array, that has to be sorted according to
+ * the compare function (the content of a vector can be passed with vec_get_at(v, 0) and vec_get_length(v))
+ *
+ * The tree is perfectly balanced and it's built in O(n) time, without comparing any element
+ */
+BST* BST_from_sorted(size_t element_size, int (*compare)(void*, void*), void* elements, size_t n) {
+
+	BST* bst = BST_create(element_size, compare);
+
+	if (bst && elements && n > 0) {
+
+		bool failed = false;
+
+		bst->root = BST_util_build(bst, (char*)elements, 0, n, &failed);
+		if (failed) BST_delete(&bst);
+	}
+	return bst;
+}
+
+/**
+ * Creates a tree holding the elements of both trees (that need to store elements of the same size, ordered the
+ * same way), the two trees aren't modified
+ *
+ * The elements are merged in order and the new tree is built from them, so it's perfectly balanced and it takes O(n + m) time
+ */
+BST* BST_merge(BST* a, BST* b) {
+
+	BST* merged = NULL;
+
+	if (a && b && a->element_size == b->element_size) {
+
+		size_t na = BST_get_size(a), nb = BST_get_size(b), es = a->element_size;
+		char* elements = (char*)malloc((na + nb > 0 ? na + nb : 1) * es);
+
+		if (elements) {
+
+			BST_iterator ia, ib;
+			BST_iterator_init(a, &ia, NULL, NULL);
+			BST_iterator_init(b, &ib, NULL, NULL);
+
+			// Standard merge of the two in-order sequences, on ties the element of a comes first
+			size_t count = 0;
+			void* va = BST_iterator_next(&ia);
+			void* vb = BST_iterator_next(&ib);
+			while (va || vb) {
+
+				if (va && (!vb || a->compare(va, vb) <= 0)) {
+
+					memcpy(elements + count * es, va, es);
+					va = BST_iterator_next(&ia);
+				}
+				else {
+
+					memcpy(elements + count * es, vb, es);
+					vb = BST_iterator_next(&ib);
+				}
+				count++;
+			}
+
+			merged = BST_from_sorted(es, a->compare, elements, count);
+			free(elements);
+		}
+	}
+	return merged;
+}
+
 /**
  * Deletes the given binary node
  */
@@ -66,7 +155,8 @@ void BST_delete(BST** bst) {
 
 	if (bst && *bst) {
 
-		BST_clear(*bst);
+		// Free every node, all at once
+		pool_delete(&(*bst)->nodes);
 		(*bst)->element_size = 0;
 		(*bst)->compare = NULL;
 		free(*bst);
@@ -83,7 +173,7 @@ binarynode* BST_insert(BST* bst, void* x) {
 
 	if (bst && x) {
 
-		n = binarynode_create(x, bst->element_size);
+		n = binarynode_create_in(bst->nodes, x, bst->element_size);
 		if (n) {
 
 			if (!bst->root) {
@@ -104,8 +194,11 @@ binarynode* BST_insert(BST* bst, void* x) {
 
 				// n_father holds the last pointer to a non null node
 				binarynode_set_father(n, n_father);
-				if (bst->compare(x, binarynode_get_value(tmp)) < 0) binarynode_set_left_child(n_father, n);
+				if (bst->compare(x, binarynode_get_value(n_father)) < 0) binarynode_set_left_child(n_father, n);
 				else binarynode_set_right_child(n_father, n);
+
+				// Every tree on the path got one more node
+				BST_util_update_path(n_father);
 			}
 		}
 	}
@@ -126,6 +219,9 @@ binarynode* BST_remove(BST* bst, void* x) {
 
 		if (x_node) {
 
+			// Deepest node whose subtree changes, and from where sizes and heights are updated
+			binarynode* changed = father;
+
 
 			// Has at least 1 child
 			if (binarynode_get_left_child(x_node)) {
@@ -136,6 +232,8 @@ binarynode* BST_remove(BST* bst, void* x) {
 					binarynode* successor = BST_successor(bst, x_node);
 					if (successor) {
 
+						changed = (binarynode_get_father(successor) == x_node) ? successor : binarynode_get_father(successor);
+
 						binarynode* tmp = binarynode_get_right_child(successor);
 						if (binarynode_get_left_child(binarynode_get_father(successor)) == successor)
 							binarynode_set_left_child(binarynode_get_father(successor), tmp);
@@ -231,9 +329,11 @@ binarynode* BST_remove(BST* bst, void* x) {
 				}
 			}
 			
-			father = binarynode_get_father(x_node);
+			BST_util_update_path(changed);
+			father = changed;
+
 			// Delete the node (physical deletion)
-			binarynode_delete(&x_node);
+			binarynode_delete_in(bst->nodes, &x_node);
 		}
 	}
 	return father;
@@ -248,7 +348,7 @@ binarynode* BST_search(BST* bst, void* x) {
 
 	if (bst) {
 
-		binarynode* n = bst->root;
+		n = bst->root;
 		int diff = 0;
 
 		while (n) {
@@ -370,69 +470,180 @@ void BST_max_2(BST* bst, void* buf) {
  */
 binarynode* BST_predecessor(BST* bst, binarynode* bn) {
 
-	binarynode* prev = NULL;
+	return (bst && bn) ? BST_util_prev(bn) : NULL;
+}
 
-	if (bst && bn) {
+/**
+ * Returns the successor of the given node inside the tree
+ */
+binarynode* BST_successor(BST* bst, binarynode* bn) {
 
-		// If there is the left sub-tree, the successor is the element the most to the right in the left subtree
-		if (binarynode_get_left_child(bn)) {
+	return (bst && bn) ? BST_util_next(bn) : NULL;
+}
 
-			binarynode* tmp = binarynode_get_left_child(bn);
-			while (binarynode_get_right_child(bn)) bn = binarynode_get_right_child(bn);
+/**
+ * Returns the first node (in order) holding a value that is not less than x, NULL if there's none
+ */
+binarynode* BST_lower_bound(BST* bst, void* x) {
 
-			prev = tmp;
-		}
+	return (bst && x) ? BST_util_bound(bst, x, false) : NULL;
+}
 
-		// Otherwise, we have to go up until we find a node that is the right child of its father
-		else {
+/**
+ * Returns the first node (in order) holding a value that is greater than x, NULL if there's none
+ */
+binarynode* BST_upper_bound(BST* bst, void* x) {
 
-			binarynode* father = binarynode_get_father(bn);
-			while (father && bn == binarynode_get_left_child(father)) {
-			
-				bn = father;
-				father = binarynode_get_father(father);
+	return (bst && x) ? BST_util_bound(bst, x, true) : NULL;
+}
+
+/**
+ * Applies the function callback, in order, to each element between lo and hi (both included),
+ * it takes O(log n + k) time for k elements in the range
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void BST_range(BST* bst, void* lo, void* hi, void (*callback)(void*)) {
+
+	if (bst && callback) {
+
+		BST_iterator it;
+		BST_iterator_init(bst, &it, lo, hi);
+
+		while (BST_iterator_has_next(&it)) callback(BST_iterator_next(&it));
+	}
+	return;
+}
+
+/**
+ * Initializes the iterator so that it returns, in order, the elements between lo and hi (both included)
+ *
+ * A NULL bound means the range isn't limited on that side, hi must stay valid while iterating
+ */
+void BST_iterator_init(BST* bst, BST_iterator* it, void* lo, void* hi) {
+
+	if (it) {
+
+		it->node = NULL;
+		it->hi = hi;
+		it->compare = bst ? bst->compare : NULL;
+
+		if (bst && bst->root) {
+
+			if (lo) it->node = BST_util_bound(bst, lo, false);
+			else {
+
+				it->node = bst->root;
+				while (binarynode_get_left_child(it->node)) it->node = binarynode_get_left_child(it->node);
 			}
 
-			prev = father;
+			// The range could be empty
+			if (it->node && hi && it->compare(binarynode_get_value(it->node), hi) > 0) it->node = NULL;
 		}
 	}
+	return;
+}
 
-	return prev;
+/**
+ * Checks whether or not the iterator has more elements to return
+ */
+bool BST_iterator_has_next(BST_iterator* it) {
+
+	return it && it->node;
 }
 
 /**
- * Returns the successor of the given node inside the tree
+ * Returns the next element and moves the iterator past it, NULL if there are no more elements
  */
-binarynode* BST_successor(BST* bst, binarynode* bn) {
+void* BST_iterator_next(BST_iterator* it) {
 
-	binarynode* succ = NULL;
+	void* val = NULL;
 
-	if (bst && bn) {
+	if (it && it->node) {
 
-		// If there is the right sub-tree, the successor is the element the most to the left in the right subtree
-		if (binarynode_get_right_child(bn)) {
+		val = binarynode_get_value(it->node);
+
+		// Walking from a node to the next one takes O(1) amortized time
+		it->node = BST_util_next(it->node);
+		if (it->node && it->hi && it->compare(binarynode_get_value(it->node), it->hi) > 0) it->node = NULL;
+	}
+	return val;
+}
 
-			binarynode* tmp = binarynode_get_right_child(bn);
-			while (binarynode_get_left_child(bn)) bn = binarynode_get_left_child(bn);
+/**
+ * Returns the node holding the k-th smallest value (starting from 0), NULL if k isn't less than the size
+ *
+ * It takes O(height) time, since every node knows the size of its subtree
+ */
+binarynode* BST_select(BST* bst, size_t k) {
 
-			succ = tmp;
-		}
+	binarynode* n = NULL;
 
-		// Otherwise, we have to go up until we find a node that is the left child of its father
-		else {
+	if (bst && k < binarynode_get_size(bst->root)) {
 
-			binarynode* father = binarynode_get_father(bn);
-			while (father && bn == binarynode_get_right_child(father)) {
+		n = bst->root;
+		while (n) {
+
+			size_t left = binarynode_get_size(binarynode_get_left_child(n));
 
-				bn = father;
-				father = binarynode_get_father(father);
+			if (k < left) n = binarynode_get_left_child(n);
+			else if (k > left) {
+
+				k -= left + 1;
+				n = binarynode_get_right_child(n);
 			}
+			else break;
+		}
+	}
+	return n;
+}
+
+/**
+ * Returns the number of values in the tree that are less than x (x doesn't need to be in the tree)
+ *
+ * It takes O(height) time, since every node knows the size of its subtree
+ */
+size_t BST_rank(BST* bst, void* x) {
+
+	size_t rank = 0;
 
-			succ = father;
+	if (bst && x) {
+
+		binarynode* n = bst->root;
+		while (n) {
+
+			// The node and its whole left subtree are less than x
+			if (bst->compare(binarynode_get_value(n), x) < 0) {
+
+				rank += binarynode_get_size(binarynode_get_left_child(n)) + 1;
+				n = binarynode_get_right_child(n);
+			}
+			else n = binarynode_get_left_child(n);
 		}
 	}
+	return rank;
+}
 
-	return succ;
+/**
+ * Returns the root of the tree
+ */
+binarynode* BST_get_root(BST* bst) {
+
+	return bst ? bst->root : NULL;
+}
+
+/**
+ * Sets the root of the tree, used by the trees built on top of the BST
+ * (such as the AVL) when they restructure it
+ */
+void BST_set_root(BST* bst, binarynode* root) {
+
+	if (bst) {
+
+		bst->root = root;
+		binarynode_set_father(root, NULL);
+	}
+	return;
 }
 
 /**
@@ -445,20 +656,21 @@ void BST_traverse_preoder(BST* bst, void (*callback)(void*)) {
 		stack* stck = stack_create(sizeof(binarynode*));
 		if (stck) {
 		
-			stack_push(stck, bst->root);
-			binarynode* tmp = NULL;
+			binarynode* tmp = bst->root;
+			if (tmp) stack_push(stck, &tmp);
 
 			while (!stack_is_empty(stck)) {
 
-				tmp = (binarynode*)stack_pop(stck);
+				stack_pop_2(stck, &tmp);
 
 				// Visit current node
 				callback(binarynode_get_value(tmp));
 
 				// Insert right child first so the left one is elaborated first
-				if (binarynode_get_right_child(tmp)) stack_push(stck, binarynode_get_right_child(tmp));
-				if (binarynode_get_left_child(tmp)) stack_push(stck, binarynode_get_left_child(tmp));
-				free(tmp);
+				binarynode* right = binarynode_get_right_child(tmp);
+				binarynode* left = binarynode_get_left_child(tmp);
+				if (right) stack_push(stck, &right);
+				if (left) stack_push(stck, &left);
 			}
 
 			stack_delete(&stck);
@@ -478,21 +690,18 @@ void BST_traverse_inoder(BST* bst, void (*callback)(void*)) {
 		if (stck) {
 
 			binarynode* tmp = bst->root;
-			binarynode* used_to_del = NULL;
 			while (tmp || !stack_is_empty(stck)) {
 
 				// Go to the far left
 				while (tmp) {
 
-					stack_push(stck, tmp);
+					stack_push(stck, &tmp);
 					tmp = binarynode_get_left_child(tmp);
 				}
 
-				tmp = stack_pop(stck);
-				used_to_del = tmp;
+				stack_pop_2(stck, &tmp);
 				callback(binarynode_get_value(tmp));
 				tmp = binarynode_get_right_child(tmp);
-				free(used_to_del);
 			}
 			stack_delete(&stck);
 		}
@@ -512,18 +721,19 @@ void BST_traverse_postoder(BST* bst, void (*callback)(void*)) {
 
 		if (preoder_emulator && actual_postorder) {
 
-			stack_push(preoder_emulator, bst->root);
-			binarynode* tmp = NULL;
+			binarynode* tmp = bst->root;
+			if (tmp) stack_push(preoder_emulator, &tmp);
 
 			while (!stack_is_empty(preoder_emulator)) {
 
-				tmp = (binarynode*)stack_pop(preoder_emulator);
+				stack_pop_2(preoder_emulator, &tmp);
 				stack_push(actual_postorder, binarynode_get_value(tmp));
 
 				// Left first, so the order is correct when inverting
-				if (binarynode_get_left_child(tmp)) stack_push(preoder_emulator, binarynode_get_left_child(tmp));
-				if (binarynode_get_right_child(tmp)) stack_push(preoder_emulator, binarynode_get_right_child(tmp));
-				free(tmp);
+				binarynode* left = binarynode_get_left_child(tmp);
+				binarynode* right = binarynode_get_right_child(tmp);
+				if (left) stack_push(preoder_emulator, &left);
+				if (right) stack_push(preoder_emulator, &right);
 			}
 
 			void* val = NULL;
@@ -550,9 +760,8 @@ size_t BST_get_size(BST* bst) {
 
 	if (bst) {
 
-		UTIL_COUNT = 0;
-		BST_traverse_preoder(bst, *BST_util_count);
-		dim = UTIL_COUNT;
+		// Every node of the tree comes from its pool
+		dim = pool_get_count(bst->nodes);
 	}
 	return dim;
 }
@@ -572,10 +781,9 @@ void BST_clear(BST* bst) {
 
 	if (bst) {
 
-		while (bst->root) {
-
-			BST_remove(bst, binarynode_get_value(bst->root));
-		}
+		// Every node comes from the pool, release them all without visiting the tree
+		pool_clear(bst->nodes);
+		bst->root = NULL;
 	}
 	return;
 }
@@ -605,9 +813,129 @@ size_t BST_get_height(BST* bst) {
 }
 
 /**
- * Accepts a pointer to a counter and updates it
+ * Copies in stats the counters of the tree bst
  */
-void BST_util_count(void* x) {
+void BST_get_stats(BST* bst, BST_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(BST_stats));
+		stats->nodes.enabled = STATS_ENABLED;
+
+		if (bst) {
+
+			pool_add_stats(bst->nodes, &stats->nodes);
+			stats->height = BST_get_height(bst);
+		}
+	}
+	return;
+}
+
+/* Utility function that returns the node holding the previous value in order */
+binarynode* BST_util_prev(binarynode* bn) {
+
+	binarynode* prev = NULL;
 
-	UTIL_COUNT += x ? 1 : 0;
+	// If there is the left sub-tree, the predecessor is the element the most to the right in the left subtree
+	if (binarynode_get_left_child(bn)) {
+
+		prev = binarynode_get_left_child(bn);
+		while (binarynode_get_right_child(prev)) prev = binarynode_get_right_child(prev);
+	}
+
+	// Otherwise, we have to go up until we find a node that is the right child of its father
+	else {
+
+		prev = binarynode_get_father(bn);
+		while (prev && bn == binarynode_get_left_child(prev)) {
+
+			bn = prev;
+			prev = binarynode_get_father(prev);
+		}
+	}
+	return prev;
+}
+
+/* Utility function that returns the node holding the next value in order */
+binarynode* BST_util_next(binarynode* bn) {
+
+	binarynode* succ = NULL;
+
+	// If there is the right sub-tree, the successor is the element the most to the left in the right subtree
+	if (binarynode_get_right_child(bn)) {
+
+		succ = binarynode_get_right_child(bn);
+		while (binarynode_get_left_child(succ)) succ = binarynode_get_left_child(succ);
+	}
+
+	// Otherwise, we have to go up until we find a node that is the left child of its father
+	else {
+
+		succ = binarynode_get_father(bn);
+		while (succ && bn == binarynode_get_right_child(succ)) {
+
+			bn = succ;
+			succ = binarynode_get_father(succ);
+		}
+	}
+	return succ;
+}
+
+/* Utility function that returns the first node (in order) holding a value not less (or, if strict, greater) than x */
+binarynode* BST_util_bound(BST* bst, void* x, bool strict) {
+
+	binarynode* bound = NULL;
+	binarynode* tmp = bst->root;
+
+	// Every node that qualifies is remembered before looking for a smaller one on its left
+	while (tmp) {
+
+		int diff = bst->compare(binarynode_get_value(tmp), x);
+
+		if (diff > 0 || (diff == 0 && !strict)) {
+
+			bound = tmp;
+			tmp = binarynode_get_left_child(tmp);
+		}
+		else tmp = binarynode_get_right_child(tmp);
+	}
+	return bound;
+}
+
+/* Utility function that updates the heights and the sizes from the given node up to the root */
+void BST_util_update_path(binarynode* bn) {
+
+	while (bn) {
+
+		binarynode_update(bn);
+		bn = binarynode_get_father(bn);
+	}
+	return;
+}
+
+/* Utility function that builds a perfectly balanced tree from the sorted elements [low, high), returns its root */
+binarynode* BST_util_build(BST* bst, char* elements, size_t low, size_t high, bool* failed) {
+
+	binarynode* n = NULL;
+
+	if (low < high && !*failed) {
+
+		// The middle element is the root, the two halves are its subtrees
+		size_t mid = low + (high - low) / 2;
+
+		n = binarynode_create_in(bst->nodes, elements + mid * bst->element_size, bst->element_size);
+		if (n) {
+
+			binarynode* left = BST_util_build(bst, elements, low, mid, failed);
+			binarynode* right = BST_util_build(bst, elements, mid + 1, high, failed);
+
+			binarynode_set_left_child(n, left);
+			binarynode_set_right_child(n, right);
+			binarynode_set_father(left, n);
+			binarynode_set_father(right, n);
+			binarynode_update(n);
+		}
+		else *failed = true;
+	}
+	return n;
 }
\ No newline at end of file
@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/PAVL.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Alignment of the element stored after the node header */
+#define PAVL_NODE_ALIGNMENT 8
+
+/* Size of the node header, the element follows it */
+#define PAVL_NODE_HEADER ((sizeof(PAVL_node) + PAVL_NODE_ALIGNMENT - 1) / PAVL_NODE_ALIGNMENT * PAVL_NODE_ALIGNMENT)
+
+/**
+ * Node of a persistent tree, shared by every version that reaches it, it never changes once it's built
+ */
+typedef struct PAVL_node {
+
+	/* Number of parents (of any version) and roots pointing to the node */
+	atomic_size_t refs;
+
+	/* Children, NULL when missing */
+	struct PAVL_node* left;
+	struct PAVL_node* right;
+
+	/* Height of the subtree rooted in the node, a leaf is 1 tall */
+	size_t height;
+} PAVL_node;
+
+/* Utility functions used to manage the nodes, inputs marked 'owned' are references the function takes over */
+PAVL_node* PAVL_util_node(PAVL* pavl, void* x, PAVL_node* left, PAVL_node* right, bool* ok);
+PAVL_node* PAVL_util_retain(PAVL_node* n);
+void PAVL_util_release(PAVL_node* n);
+void* PAVL_util_value(PAVL_node* n);
+size_t PAVL_util_height(PAVL_node* n);
+PAVL_node* PAVL_util_rebalance(PAVL* pavl, PAVL_node* n, bool* ok);
+PAVL_node* PAVL_util_insert(PAVL* pavl, PAVL_node* n, void* x, bool* ok);
+PAVL_node* PAVL_util_remove(PAVL* pavl, PAVL_node* n, void* x, bool* ok);
+PAVL_node* PAVL_util_remove_min(PAVL* pavl, PAVL_node* n, bool* ok);
+PAVL* PAVL_util_version(PAVL* pavl, PAVL_node* root, size_t count);
+void PAVL_util_destroy(void* pavl);
+void PAVL_util_inorder(PAVL_node* n, void (*callback)(void*));
+
+ /**
+  * Struct that implements a version of a persistent AVL tree
+  */
+typedef struct PAVL {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* References to this version, it has to be the first field (see vcell) */
+	vcell_version header;
+
+	/* Root of the tree, NULL if it is empty */
+	PAVL_node* root;
+
+	/* Number of elements */
+	size_t count;
+
+	/* Size of each element */
+	size_t element_size;
+
+	/* Function used to order the elements */
+	int (*compare)(void*, void*);
+} PAVL;
+
+/**
+ * Creates an empty tree storing elements that are as big as element_size, ordered by the compare function
+ */
+PAVL* PAVL_create(size_t element_size, int (*compare)(void*, void*)) {
+
+	PAVL* pavl = NULL;
+
+	if (0 < element_size && element_size <= SIZE_MAX - PAVL_NODE_HEADER && compare) {
+
+		pavl = (PAVL*)malloc(sizeof(PAVL));
+		if (pavl) {
+
+			atomic_init(&pavl->header.refs, 1);
+			pavl->header.destroy = PAVL_util_destroy;
+			pavl->root = NULL;
+			pavl->count = 0;
+			pavl->element_size = element_size;
+			pavl->compare = compare;
+		}
+	}
+	return pavl;
+}
+
+/**
+ * Releases the given version, the nodes that no other version uses are freed
+ */
+void PAVL_delete(PAVL** pavl) {
+
+	if (pavl && *pavl) {
+
+		vcell_release(*pavl);
+		*pavl = NULL;
+	}
+	return;
+}
+
+/**
+ * Returns another reference to the same version, that has to be deleted on its own
+ */
+PAVL* PAVL_retain(PAVL* pavl) {
+
+	return (PAVL*)vcell_retain(pavl);
+}
+
+/**
+ * Returns a new version that also holds the value x (equal values are kept, like AVL_insert does)
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+PAVL* PAVL_insert(PAVL* pavl, void* x) {
+
+	PAVL* res = NULL;
+
+	if (pavl && x) {
+
+		bool ok = true;
+		PAVL_node* root = PAVL_util_insert(pavl, pavl->root, x, &ok);
+
+		if (ok) res = PAVL_util_version(pavl, root, pavl->count + 1);
+	}
+	return res;
+}
+
+/**
+ * Returns a new version without (one occurrence of) the value x, or one more reference to the same version if x is not present
+ *
+ * The given version is left unchanged, NULL is returned if there's not enough memory
+ */
+PAVL* PAVL_remove(PAVL* pavl, void* x) {
+
+	PAVL* res = NULL;
+
+	if (pavl && x) {
+
+		// Nothing to copy if the value isn't there
+		if (!PAVL_search(pavl, x)) res = PAVL_retain(pavl);
+		else {
+
+			bool ok = true;
+			PAVL_node* root = PAVL_util_remove(pavl, pavl->root, x, &ok);
+
+			if (ok) res = PAVL_util_version(pavl, root, pavl->count - 1);
+		}
+	}
+	return res;
+}
+
+/**
+ * Searches the value x, returns a pointer to the stored element (NULL if it is not present)
+ *
+ * The element is valid as long as the version is, and must not be written
+ */
+void* PAVL_search(PAVL* pavl, void* x) {
+
+	PAVL_node* n = pavl && x ? pavl->root : NULL;
+
+	while (n) {
+
+		int c = pavl->compare(x, PAVL_util_value(n));
+		if (c == 0) break;
+		n = c < 0 ? n->left : n->right;
+	}
+	return n ? PAVL_util_value(n) : NULL;
+}
+
+/**
+ * Checks whether or not the value x is stored in the tree
+ */
+bool PAVL_contains(PAVL* pavl, void* x) {
+
+	return PAVL_search(pavl, x) != NULL;
+}
+
+/**
+ * Returns a pointer to the smallest element (NULL if the tree is empty), that must not be written
+ */
+void* PAVL_min(PAVL* pavl) {
+
+	PAVL_node* n = pavl ? pavl->root : NULL;
+
+	while (n && n->left) n = n->left;
+	return n ? PAVL_util_value(n) : NULL;
+}
+
+/**
+ * Returns a pointer to the biggest element (NULL if the tree is empty), that must not be written
+ */
+void* PAVL_max(PAVL* pavl) {
+
+	PAVL_node* n = pavl ? pavl->root : NULL;
+
+	while (n && n->right) n = n->right;
+	return n ? PAVL_util_value(n) : NULL;
+}
+
+/**
+ * Applies the callback to every element in order, the elements must not be written
+ */
+void PAVL_traverse_inoder(PAVL* pavl, void (*callback)(void*)) {
+
+	if (pavl && callback) PAVL_util_inorder(pavl->root, callback);
+	return;
+}
+
+/**
+ * Returns the number of elements stored in this version
+ */
+size_t PAVL_get_size(PAVL* pavl) {
+
+	return pavl ? pavl->count : 0;
+}
+
+/**
+ * Returns the size of the elements stored in the tree
+ */
+size_t PAVL_get_element_size(PAVL* pavl) {
+
+	return pavl ? pavl->element_size : 0;
+}
+
+/**
+ * Checks whether or not this version is empty
+ */
+bool PAVL_is_empty(PAVL* pavl) {
+
+	return pavl ? pavl->count == 0 : false;
+}
+
+/**
+ * Returns the height of this version (0 if it is empty)
+ */
+size_t PAVL_get_height(PAVL* pavl) {
+
+	return pavl ? PAVL_util_height(pavl->root) : 0;
+}
+
+/* Utility function that builds a node holding a copy of x, with the (owned) children, NULL if the operation already failed */
+PAVL_node* PAVL_util_node(PAVL* pavl, void* x, PAVL_node* left, PAVL_node* right, bool* ok) {
+
+	PAVL_node* n = *ok ? (PAVL_node*)malloc(PAVL_NODE_HEADER + pavl->element_size) : NULL;
+
+	if (n) {
+
+		size_t hl = PAVL_util_height(left), hr = PAVL_util_height(right);
+
+		atomic_init(&n->refs, 1);
+		n->left = left;
+		n->right = right;
+		n->height = (hl > hr ? hl : hr) + 1;
+		memcpy(PAVL_util_value(n), x, pavl->element_size);
+	}
+
+	// The children would be lost otherwise
+	else {
+
+		*ok = false;
+		PAVL_util_release(left);
+		PAVL_util_release(right);
+	}
+	return n;
+}
+
+/* Utility function that adds a reference to a node, returns the node itself */
+PAVL_node* PAVL_util_retain(PAVL_node* n) {
+
+	if (n) atomic_fetch_add_explicit(&n->refs, 1, memory_order_relaxed);
+	return n;
+}
+
+/* Utility function that releases a reference to a node, freeing it (and releasing its children) if it was the last one */
+void PAVL_util_release(PAVL_node* n) {
+
+	while (n && atomic_fetch_sub_explicit(&n->refs, 1, memory_order_acq_rel) == 1) {
+
+		PAVL_node* right = n->right;
+
+		PAVL_util_release(n->left);
+		free(n);
+
+		// The right child is released in the loop, so a chain of right children doesn't recurse
+		n = right;
+	}
+	return;
+}
+
+/* Utility function that returns the element stored in a node */
+void* PAVL_util_value(PAVL_node* n) {
+
+	return (char*)n + PAVL_NODE_HEADER;
+}
+
+/* Utility function that returns the height of a subtree (0 for an empty one) */
+size_t PAVL_util_height(PAVL_node* n) {
+
+	return n ? n->height : 0;
+}
+
+/**
+ * Utility function that rebalances the (owned) subtree rooted in n, returning its new root
+ *
+ * The nodes that change children are copied, the old ones are released
+ */
+PAVL_node* PAVL_util_rebalance(PAVL* pavl, PAVL_node* n, bool* ok) {
+
+	PAVL_node* res = n;
+
+	if (n) {
+
+		size_t hl = PAVL_util_height(n->left), hr = PAVL_util_height(n->right);
+
+		// Left heavy, single right rotation or (left-right) double rotation
+		if (hl > hr + 1) {
+
+			PAVL_node* l = n->left;
+
+			if (PAVL_util_height(l->left) >= PAVL_util_height(l->right)) {
+
+				PAVL_node* right = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(l->right), PAVL_util_retain(n->right), ok);
+				res = PAVL_util_node(pavl, PAVL_util_value(l), PAVL_util_retain(l->left), right, ok);
+			}
+			else {
+
+				PAVL_node* lr = l->right;
+				PAVL_node* left = PAVL_util_node(pavl, PAVL_util_value(l), PAVL_util_retain(l->left), PAVL_util_retain(lr->left), ok);
+				PAVL_node* right = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(lr->right), PAVL_util_retain(n->right), ok);
+				res = PAVL_util_node(pavl, PAVL_util_value(lr), left, right, ok);
+			}
+			PAVL_util_release(n);
+		}
+
+		// Right heavy, single left rotation or (right-left) double rotation
+		else if (hr > hl + 1) {
+
+			PAVL_node* r = n->right;
+
+			if (PAVL_util_height(r->right) >= PAVL_util_height(r->left)) {
+
+				PAVL_node* left = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(n->left), PAVL_util_retain(r->left), ok);
+				res = PAVL_util_node(pavl, PAVL_util_value(r), left, PAVL_util_retain(r->right), ok);
+			}
+			else {
+
+				PAVL_node* rl = r->left;
+				PAVL_node* left = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(n->left), PAVL_util_retain(rl->left), ok);
+				PAVL_node* right = PAVL_util_node(pavl, PAVL_util_value(r), PAVL_util_retain(rl->right), PAVL_util_retain(r->right), ok);
+				res = PAVL_util_node(pavl, PAVL_util_value(rl), left, right, ok);
+			}
+			PAVL_util_release(n);
+		}
+	}
+	return res;
+}
+
+/* Utility function that returns the (owned) copy of the subtree n, that is only read, with x added */
+PAVL_node* PAVL_util_insert(PAVL* pavl, PAVL_node* n, void* x, bool* ok) {
+
+	PAVL_node* res = NULL;
+
+	if (!n) res = PAVL_util_node(pavl, x, NULL, NULL, ok);
+
+	// Equal values go to the right, like in the BST
+	else if (pavl->compare(x, PAVL_util_value(n)) < 0) {
+
+		PAVL_node* left = PAVL_util_insert(pavl, n->left, x, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(n), left, PAVL_util_retain(n->right), ok);
+	}
+	else {
+
+		PAVL_node* right = PAVL_util_insert(pavl, n->right, x, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(n->left), right, ok);
+	}
+	return PAVL_util_rebalance(pavl, res, ok);
+}
+
+/* Utility function that returns the (owned) copy of the subtree n, that is only read, without x (which has to be there) */
+PAVL_node* PAVL_util_remove(PAVL* pavl, PAVL_node* n, void* x, bool* ok) {
+
+	PAVL_node* res = NULL;
+	int c = pavl->compare(x, PAVL_util_value(n));
+
+	if (c < 0) {
+
+		PAVL_node* left = PAVL_util_remove(pavl, n->left, x, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(n), left, PAVL_util_retain(n->right), ok);
+	}
+	else if (c > 0) {
+
+		PAVL_node* right = PAVL_util_remove(pavl, n->right, x, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(n), PAVL_util_retain(n->left), right, ok);
+	}
+
+	// With at most one child, the child takes the place of the node
+	else if (!n->left || !n->right) {
+
+		res = PAVL_util_retain(n->left ? n->left : n->right);
+	}
+
+	// Otherwise the node is replaced by its successor, the smallest element on its right
+	else {
+
+		PAVL_node* successor = n->right;
+		while (successor->left) successor = successor->left;
+
+		PAVL_node* right = PAVL_util_remove_min(pavl, n->right, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(successor), PAVL_util_retain(n->left), right, ok);
+	}
+	return PAVL_util_rebalance(pavl, res, ok);
+}
+
+/* Utility function that returns the (owned) copy of the subtree n, that is only read, without its smallest element */
+PAVL_node* PAVL_util_remove_min(PAVL* pavl, PAVL_node* n, bool* ok) {
+
+	PAVL_node* res = NULL;
+
+	if (!n->left) res = PAVL_util_retain(n->right);
+	else {
+
+		PAVL_node* left = PAVL_util_remove_min(pavl, n->left, ok);
+		res = PAVL_util_node(pavl, PAVL_util_value(n), left, PAVL_util_retain(n->right), ok);
+	}
+	return PAVL_util_rebalance(pavl, res, ok);
+}
+
+/* Utility function that creates a version like pavl with the given (owned) root, NULL if there's not enough memory */
+PAVL* PAVL_util_version(PAVL* pavl, PAVL_node* root, size_t count) {
+
+	PAVL* res = PAVL_create(pavl->element_size, pavl->compare);
+
+	if (res) {
+
+		res->root = root;
+		res->count = count;
+	}
+	else PAVL_util_release(root);
+
+	return res;
+}
+
+/* Utility function used as the destroy function of the versions */
+void PAVL_util_destroy(void* pavl) {
+
+	PAVL_util_release(((PAVL*)pavl)->root);
+	memset(pavl, 0, sizeof(PAVL));
+	free(pavl);
+	return;
+}
+
+/* Utility function that applies the callback to the elements of the subtree n, in order */
+void PAVL_util_inorder(PAVL_node* n, void (*callback)(void*)) {
+
+	if (n) {
+
+		PAVL_util_inorder(n->left, callback);
+		callback(PAVL_util_value(n));
+		PAVL_util_inorder(n->right, callback);
+	}
+	return;
+}
\ No newline at end of file
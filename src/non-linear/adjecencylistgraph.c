@@ -10,16 +10,82 @@
 
 #include "../../include/non-linear/graph.h"
 #include "../../include/linear/linkedlist.h"
-#include "../../include/linear/queue.h"
-#include "../../include/linear/stack.h"
+#include "../../include/linear/vector.h"
+#include "../../include/linear/unionfind.h"
 #include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
 
+/* Initial capacity of the vectors used by the traversals */
+#define GRAPH_TRAVERSAL_CAPACITY 16
+
+struct gnode;
+
+/**
+ * Arch leaving a node
+ */
+typedef struct garch {
+
+	/* Node the arch reaches */
+	struct gnode* to;
+
+	/* Weight of the arch */
+	int weight;
+} garch;
+
+/**
+ * Node of the graph, the lists store pointers to it so that it never moves
+ */
 typedef struct gnode {
 
+	/* Value held by the node (the pointer given by the user) */
 	void* value;
+
+	/* Arches leaving the node (garch), for graphs that are not oriented every arch is in the lists of both its nodes */
 	linkedlist* adjacency;
-}gnode;
+
+	/* Nodes with an arch reaching this one (gnode*), only for oriented graphs */
+	linkedlist* incoming;
+
+	/* Element of the union-find that represents the node */
+	size_t component;
+
+	/* Position of the node in the topological order, only for oriented graphs */
+	size_t order;
+
+	/* Arches still to be visited by the topological sort, or the traversal that visited the node last */
+	size_t pending;
+	size_t mark;
+} gnode;
+
+/* Utility function used to get the node holding the value x, NULL if there's none */
+gnode* graph_util_node(graph* g, void* x);
+
+/* Utility function used to get the arch from one node to another, NULL if there's none */
+garch* graph_util_arch(gnode* from, gnode* to);
+
+/* Utility functions used to remove the arches reaching a node from a list of arches, or the node from a list of nodes */
+void graph_util_unlink_arch(linkedlist* arches, gnode* to);
+void graph_util_unlink_node(linkedlist* nodes, gnode* n);
+
+/* Utility function used to delete a node, along with its lists */
+void graph_util_free_node(gnode* n);
+
+/* Utility function used to start a new traversal, so that no node results visited */
+size_t graph_util_next_mark(graph* g);
+
+/* Utility function used to rebuild the union-find from every arch, after a removal */
+void graph_util_components(graph* g);
+
+/* Utility function used to fix the topological order after the arch from -> to was inserted (Pearce-Kelly) */
+void graph_util_update_order(graph* g, gnode* from, gnode* to);
+
+/* Utility function used to compute the topological order from scratch (Kahn), after a removal in a cyclic graph */
+void graph_util_compute_order(graph* g);
+
+/* Utility functions used to compare nodes by their position in the topological order, or the positions themselves */
+int graph_util_compare_order(void* a, void* b);
+int graph_util_compare_position(void* a, void* b);
 
 /**
  * Struct that represent a graph that can store
@@ -36,7 +102,7 @@ typedef struct graph {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	 /* List of lists of nodes */
+	 /* List of the nodes (gnode*), in insertion order */
 	linkedlist* nodes;
 
 	/* Size of the elements stored in the list */
@@ -45,6 +111,25 @@ typedef struct graph {
 	/* Flags for weighted and oriented graphs */
 	int flags;
 
+	/* Connected components (weakly connected, for oriented graphs), merged as arches are inserted
+	 * Removals can split a component, so they only mark it to be rebuilt by the next query
+	 */
+	unionfind* components;
+	bool components_dirty;
+
+	/* Topological order of oriented graphs, kept up to date as arches are inserted
+	 *
+	 * order_valid is false once an arch closed a cycle, then order_dirty tells whether
+	 * anything was removed since, so that the next query has to compute the order again
+	 */
+	bool order_valid;
+	bool order_dirty;
+
+	/* Position given to the next node added to the order */
+	size_t next_order;
+
+	/* Mark of the current traversal */
+	size_t mark;
 } graph;
 
 /**
@@ -59,14 +144,22 @@ graph* graph_create(size_t element_size, int flags) {
 		g = (graph*)malloc(sizeof(graph));
 		if (g) {
 
-			g->nodes = ll_create(sizeof(gnode));
-			if (g->nodes) {
+			g->nodes = ll_create(sizeof(gnode*));
+			g->components = uf_create(1);
+			if (g->nodes && g->components) {
 
 				g->element_size = element_size;
 				g->flags = flags;
+				g->components_dirty = false;
+				g->order_valid = true;
+				g->order_dirty = false;
+				g->next_order = 0;
+				g->mark = 0;
 			}
 			else {
 
+				ll_delete(&g->nodes);
+				uf_delete(&g->components);
 				free(g);
 				g = NULL;
 			}
@@ -83,6 +176,8 @@ void graph_delete(graph** g) {
 	if (g && *g) {
 
 		graph_clear_nodes(*g);
+		ll_delete(&(*g)->nodes);
+		uf_delete(&(*g)->components);
 		memset(*g, 0, sizeof(graph));
 		free(*g);
 		*g = NULL;
@@ -98,21 +193,35 @@ void graph_insert_node(graph* g, void* x) {
 	if (g && x) {
 
 		// If node is not contained, add it
-		if (graph_search_node(g, x) == NULL) {
+		if (graph_util_node(g, x) == NULL) {
 
 			gnode* to_add = (gnode*)malloc(sizeof(gnode));
 			if (to_add) {
 
 				to_add->value = x;
-				to_add->adjacency = ll_create(g->element_size);
+				to_add->adjacency = ll_create(sizeof(garch));
+				to_add->incoming = (g->flags & IS_ORIENTED) ? ll_create(sizeof(gnode*)) : NULL;
+				to_add->mark = 0;
+				to_add->pending = 0;
+
+				// A new node has no arch, it can go last in the order
+				to_add->order = g->next_order++;
+
+				if (to_add->adjacency && (to_add->incoming || !(g->flags & IS_ORIENTED))) {
+
+					size_t size = ll_get_size(g->nodes);
+					ll_insert_tail(g->nodes, &to_add);
 
-				if (to_add->adjacency) {
+					if (ll_get_size(g->nodes) > size) {
 
-					ll_insert_tail(g->nodes, to_add);
+						to_add->component = g->components_dirty ? 0 : uf_add(g->components);
+						if (to_add->component == (size_t)-1) g->components_dirty = true;
+					}
+					else graph_util_free_node(to_add);
 				}
 				else {
 
-					free(to_add);
+					graph_util_free_node(to_add);
 				}
 			}
 		}
@@ -128,29 +237,32 @@ void graph_insert_arch(graph* g, void* first, void* second, int weight) {
 
 	if (g && first && second && weight > 0) {
 
-		// If both elements are present
-		if (graph_search_node(g, first) && graph_search_node(g, second)) {
+		gnode* from = graph_util_node(g, first);
+		gnode* to = graph_util_node(g, second);
 
-			// Graph search arch will either return the pointer to the list of adjacency of first, if the arch is present, or null if it's not
-			void* adjacency_list = graph_search_arch(g, first, second);
-			if (!adjacency_list) {
+		// If both elements are present, and the arch is not
+		if (from && to && !graph_util_arch(from, to)) {
 
-				// Need to add the arch
-				linkedlist* ll = ((gnode*)graph_search_node(g, first))->adjacency;
-				ll_insert_tail(ll, second);
-			}
+			garch arch = { to, weight };
+			ll_insert_tail(from->adjacency, &arch);
 
-			// If the graph is NOT oriented
-			if (g->flags & ~IS_ORIENTED) {
+			if (g->flags & IS_ORIENTED) {
 
-				adjacency_list = graph_search_arch(g, second, first);
-				if (!adjacency_list) {
+				ll_insert_tail(to->incoming, &from);
 
-					// Need to add the arch
-					linkedlist* ll = ((gnode*)graph_search_node(g, second))->adjacency;
-					ll_insert_tail(ll, first);
-				}
+				// A closed cycle leaves no order to maintain, until something is removed
+				if (from == to) g->order_valid = false;
+				else if (g->order_valid) graph_util_update_order(g, from, to);
+			}
+
+			// If the graph is NOT oriented the arch is also stored by the second node
+			else if (from != to) {
+
+				arch.to = from;
+				ll_insert_tail(to->adjacency, &arch);
 			}
+
+			if (!g->components_dirty) uf_union(g->components, from->component, to->component);
 		}
 
 	}
@@ -165,26 +277,32 @@ void graph_remove_node(graph* g, void* x) {
 
 	if (g && x) {
 
-		gnode* node = graph_search_node(g, x);
+		gnode* node = graph_util_node(g, x);
 
 		// The element is present
 		if (node) {
 
-			ll_delete(&(node->adjacency));
-			ll_remove_at(g->nodes, -1 + ll_contains(g->nodes, node));
-
-			// For each element in the list, check if the arch exists and remove it
-			gnode* tmp = NULL;
-			for (int i = 0; i < ll_get_size(g->nodes); i++) {
+			ll_iterator it;
 
-				tmp = ll_get_at(g->nodes, i);
+			// Remove every arch reaching the node, the lists of its neighbours say where they are
+			for (ll_iter_begin(node->adjacency, &it); ll_iter_has_next(&it);) {
 
-				// If an arch exists
-				if (graph_search_arch(g, tmp->value, x)) {
+				gnode* other = ((garch*)ll_iter_next(&it))->to;
+				if (g->flags & IS_ORIENTED) graph_util_unlink_node(other->incoming, node);
+				else graph_util_unlink_arch(other->adjacency, node);
+			}
+			if (node->incoming) for (ll_iter_begin(node->incoming, &it); ll_iter_has_next(&it);) {
 
-					ll_remove_at(tmp->adjacency, ll_contains(tmp->adjacency, x) - 1);
-				}
+				gnode* other = *(gnode**)ll_iter_next(&it);
+				graph_util_unlink_arch(other->adjacency, node);
 			}
+
+			graph_util_unlink_node(g->nodes, node);
+			graph_util_free_node(node);
+
+			// The order of the other nodes is still valid, the components may have split
+			g->components_dirty = true;
+			g->order_dirty = true;
 		}
 	}
 	return;
@@ -197,31 +315,19 @@ void graph_remove_arch(graph* g, void* first, void* second) {
 
 	if (g && first && second) {
 
-		if (first != second) {
-
-			// If both are present
-			gnode* of_first = graph_search_node(g, first);
-			gnode* of_second = graph_search_node(g, second);
-			if (of_first && of_second) {
-
-				// If the adjacency list of the first element contains the second, first->second exists
-				int k = -1;
-				if ((k = ll_contains(of_first->adjacency, second))) {
-
-					ll_remove_at(of_first->adjacency, k - 1);
-				}
+		// If both are present
+		gnode* of_first = graph_util_node(g, first);
+		gnode* of_second = graph_util_node(g, second);
+		if (of_first && of_second && graph_util_arch(of_first, of_second)) {
 
-			
-				// If the graph is not oriented, we can also try second->first
-				if (g->flags & ~IS_ORIENTED) {
+			graph_util_unlink_arch(of_first->adjacency, of_second);
 
-					int k = -1;
-					if ((k = ll_contains(of_second->adjacency, first))) {
+			// Oriented graphs also keep the predecessors, the others the arch in the other direction
+			if (g->flags & IS_ORIENTED) graph_util_unlink_node(of_second->incoming, of_first);
+			else graph_util_unlink_arch(of_second->adjacency, of_first);
 
-						ll_remove_at(of_second->adjacency, k - 1);
-					}
-				}
-			}
+			g->components_dirty = true;
+			g->order_dirty = true;
 		}
 	}
 	return;
@@ -232,26 +338,16 @@ void graph_remove_arch(graph* g, void* first, void* second) {
  */
 void* graph_search_node(graph* g, void* x) {
 
-	void* val = NULL;
-
-	if (g && x) {
-
-		gnode* tmp = NULL;
-		for (int i = 0; i < ll_get_size(g->nodes); i++) {
+	gnode* n = graph_util_node(g, x);
 
-			tmp = ll_get_at(g->nodes, i);
-			if (tmp->value == x) {
-
-				val = tmp;
-				break;
-			}
-		}
-	}
-	return val;
+	return n ? n->value : NULL;
 }
 
 /**
  * Searches for an arch between first and second
+ *
+ * A pointer to the weight of the arch is returned for weighted graphs, a pointer
+ * to the value of second for unweighted ones (NULL if there's no such arch)
  */
 void* graph_search_arch(graph* g, void* first, void* second) {
 
@@ -259,34 +355,11 @@ void* graph_search_arch(graph* g, void* first, void* second) {
 
 	if (g && first && second) {
 
-		if (first != second) {
-
-			gnode* of_first = graph_search_node(g, first);
-			gnode* of_second = graph_search_node(g, second);
-			if (of_first && of_second) {
-
-				// If the adjacency list of the first element contains the second, first->second exists
-				int k = -1;
-				if ((k = ll_contains(of_first->adjacency, second))) {
-
-					val = ll_get_at(of_first->adjacency, k - 1);
-				}
-
-				// first->second doesn't exist
-				else {
-					
-					// If the graph is not oriented, we can also try second->first
-					if (g->flags & ~IS_ORIENTED) {
-
-						int k = -1;
-						if ((k = ll_contains(of_second->adjacency, first))) {
+		gnode* of_first = graph_util_node(g, first);
+		gnode* of_second = graph_util_node(g, second);
+		garch* arch = of_first && of_second ? graph_util_arch(of_first, of_second) : NULL;
 
-							val = ll_get_at(of_second->adjacency, k - 1);
-						}
-					}
-				}
-			}
-		}
+		if (arch) val = (g->flags & IS_WEIGHTED) ? (void*)&arch->weight : arch->to->value;
 	}
 	return val;
 }
@@ -296,33 +369,36 @@ void* graph_search_arch(graph* g, void* first, void* second) {
  */
 void graph_BFS(graph* g, void (*callback)(void*)) {
 
-	if (g && callback) {
+	if (g && callback && !ll_is_empty(g->nodes)) {
 
-		bool* visited = (bool*)calloc(ll_get_size(g->nodes), sizeof(bool));
-		queue* q = queue_create(sizeof(gnode));
+		vector* q = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
 
-		if (visited && q) {
+		if (q) {
 
-			gnode* cur = ll_get_head(g->nodes);
-			queue_enqueue(q, cur);
-			visited[ll_contains(g->nodes, cur) - 1] = true;
+			size_t mark = graph_util_next_mark(g);
+			gnode* cur = *(gnode**)ll_get_head(g->nodes);
 
-			while (!queue_is_empty(q)) {
+			// The vector is used as a queue, head is the next node to dequeue
+			cur->mark = mark;
+			vec_push_back(q, &cur);
+			for (size_t head = 0; head < vec_get_length(q); head++) {
 
-				cur = queue_dequeue(q);
+				cur = *(gnode**)vec_get_at(q, head);
 				callback(cur->value);
-				int index = 0;
-				for (int i = 0; i < ll_get_size(cur->adjacency); i++) {
 
-					index = ll_contains(g->nodes, ll_get_at(cur->adjacency, i)) - 1;
-					if(!visited[index]) {
+				ll_iterator it;
+				for (ll_iter_begin(cur->adjacency, &it); ll_iter_has_next(&it);) {
 
-						queue_enqueue(q, ll_get_at(cur->adjacency, i));
+					gnode* next = ((garch*)ll_iter_next(&it))->to;
+					if (next->mark != mark) {
 
+						next->mark = mark;
+						vec_push_back(q, &next);
 					}
 				}
 			}
 		}
+		vec_delete(&q);
 	}
 	return;
 }
@@ -332,33 +408,33 @@ void graph_BFS(graph* g, void (*callback)(void*)) {
  */
 void graph_DFS(graph* g, void (*callback)(void*)) {
 
-	if (g && callback) {
+	if (g && callback && !ll_is_empty(g->nodes)) {
 
-		bool* visited = (bool*)calloc(ll_get_size(g->nodes), sizeof(bool));
-		stack* s = stack_create(sizeof(gnode));
+		vector* s = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
 
-		if (visited && s) {
+		if (s) {
 
-			gnode* cur = ll_get_head(g->nodes);
-			stack_push(s, cur);
-			visited[ll_contains(g->nodes, cur) - 1] = true;
+			size_t mark = graph_util_next_mark(g);
+			gnode* cur = *(gnode**)ll_get_head(g->nodes);
+			vec_push_back(s, &cur);
 
-			while (!stack_is_empty(s)) {
+			while (vec_get_length(s) > 0) {
 
-				cur = stack_pop(s);
-				callback(cur->value);
-				int index = 0;
-				for (int i = 0; i < ll_get_size(cur->adjacency); i++) {
+				vec_pop_2_back(s, &cur);
+				if (cur->mark == mark) continue;
 
-					index = ll_contains(g->nodes, ll_get_at(cur->adjacency, i)) - 1;
-					if (!visited[index]) {
+				cur->mark = mark;
+				callback(cur->value);
 
-						stack_push(s, ll_get_at(cur->adjacency, i));
+				ll_iterator it;
+				for (ll_iter_begin(cur->adjacency, &it); ll_iter_has_next(&it);) {
 
-					}
+					gnode* next = ((garch*)ll_iter_next(&it))->to;
+					if (next->mark != mark) vec_push_back(s, &next);
 				}
 			}
 		}
+		vec_delete(&s);
 	}
 	return;
 }
@@ -370,8 +446,15 @@ void graph_clear_nodes(graph* g) {
 
 	if (g) {
 
-		graph_clear_arches(g);
+		ll_iterator it;
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) graph_util_free_node(*(gnode**)ll_iter_next(&it));
 		ll_clear(g->nodes);
+
+		uf_clear(g->components);
+		g->components_dirty = true;
+		g->order_valid = true;
+		g->order_dirty = false;
+		g->next_order = 0;
 	}
 	return;
 }
@@ -383,21 +466,392 @@ void graph_clear_arches(graph* g) {
 
 	if (g) {
 
-		// Traverse the list of couples (value + list) and delete the list
+		ll_iterator it;
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) {
+
+			gnode* n = *(gnode**)ll_iter_next(&it);
+			ll_clear(n->adjacency);
+			if (n->incoming) ll_clear(n->incoming);
+		}
+
+		// Without arches every order is topological
+		g->components_dirty = true;
+		g->order_valid = true;
+		g->order_dirty = false;
+	}
+	return;
+}
+
+/**
+ * Checks whether or not the two nodes are in the same connected component
+ * (weakly connected for oriented graphs, the orientation of the arches is ignored)
+ *
+ * Insertions merge the components as they happen, after a removal they're rebuilt by the next query
+ */
+bool graph_connected(graph* g, void* first, void* second) {
+
+	bool connected = false;
 
-		void* tmp;
-		for (int i = 0; i < ll_get_size(g->nodes); i++) {
+	if (g && first && second) {
 
-			tmp = ll_get_at(g->nodes, i);
+		gnode* a = graph_util_node(g, first);
+		gnode* b = graph_util_node(g, second);
 
-			// tmp points to a memory location that contains [value, pointer to list], increment it
-			tmp = (char*)tmp + g->element_size;
+		if (a && b) {
 
-			// tmp now points to a location that contains a pointer to a list, so
-			ll_clear((linkedlist*)tmp);
+			if (g->components_dirty) graph_util_components(g);
+			connected = a == b || (!g->components_dirty && uf_connected(g->components, a->component, b->component));
 		}
 	}
+	return connected;
+}
+
+/**
+ * Checks whether or not there's a path from the node holding first to the node holding second
+ *
+ * Nodes of different components, or that come in the wrong order in the topological order
+ * of an acyclic oriented graph, are told apart without visiting anything, otherwise the
+ * search only visits the nodes that come before second in the order
+ */
+bool graph_is_reachable(graph* g, void* first, void* second) {
+
+	bool reachable = false;
+
+	if (g && first && second && graph_connected(g, first, second)) {
+
+		gnode* from = graph_util_node(g, first);
+		gnode* to = graph_util_node(g, second);
+
+		// Without orientation, being in the same component is enough
+		if (from == to || !(g->flags & IS_ORIENTED)) reachable = true;
+		else {
+
+			if (!g->order_valid && g->order_dirty) graph_util_compute_order(g);
+
+			// In an acyclic graph a path only goes forward in the order
+			bool pruned = g->order_valid;
+			vector* s = (!pruned || from->order < to->order) ? vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*)) : NULL;
+
+			if (s) {
+
+				size_t mark = graph_util_next_mark(g);
+				from->mark = mark;
+				vec_push_back(s, &from);
+
+				while (!reachable && vec_get_length(s) > 0) {
+
+					gnode* cur = NULL;
+					vec_pop_2_back(s, &cur);
+
+					ll_iterator it;
+					for (ll_iter_begin(cur->adjacency, &it); ll_iter_has_next(&it);) {
+
+						gnode* next = ((garch*)ll_iter_next(&it))->to;
+						if (next == to) reachable = true;
+						else if (next->mark != mark && (!pruned || next->order < to->order)) {
+
+							next->mark = mark;
+							vec_push_back(s, &next);
+						}
+					}
+				}
+			}
+			vec_delete(&s);
+		}
+	}
+	return reachable;
+}
+
+/**
+ * Applies the callback to the value of every node in topological order (each node comes before the ones its arches reach)
+ *
+ * Only oriented graphs without cycles have one, false is returned (and nothing is visited) otherwise
+ * The order is maintained as arches are inserted, so a query only sorts the nodes by their position
+ */
+bool graph_topological_order(graph* g, void (*callback)(void*)) {
+
+	bool sorted = false;
+
+	if (g && callback && (g->flags & IS_ORIENTED)) {
+
+		if (!g->order_valid && g->order_dirty) graph_util_compute_order(g);
+
+		vector* nodes = g->order_valid ? vec_create(ll_get_size(g->nodes) > 0 ? ll_get_size(g->nodes) : 1, sizeof(gnode*)) : NULL;
+		if (nodes) {
+
+			ll_iterator it;
+			for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) vec_push_back(nodes, ll_iter_next(&it));
+
+			if (vec_get_length(nodes) == ll_get_size(g->nodes)) {
+
+				vec_sort(nodes, graph_util_compare_order);
+				for (size_t i = 0; i < vec_get_length(nodes); i++) callback((*(gnode**)vec_get_at(nodes, i))->value);
+				sorted = true;
+			}
+		}
+		vec_delete(&nodes);
+	}
+	return sorted;
+}
+
+gnode* graph_util_node(graph* g, void* x) {
+
+	gnode* val = NULL;
+
+	if (g && x) {
+
+		ll_iterator it;
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) {
+
+			gnode* tmp = *(gnode**)ll_iter_next(&it);
+			if (tmp->value == x) {
+
+				val = tmp;
+				break;
+			}
+		}
+	}
+	return val;
+}
+
+garch* graph_util_arch(gnode* from, gnode* to) {
+
+	garch* val = NULL;
+
+	ll_iterator it;
+	for (ll_iter_begin(from->adjacency, &it); ll_iter_has_next(&it);) {
+
+		garch* arch = (garch*)ll_iter_next(&it);
+		if (arch->to == to) {
+
+			val = arch;
+			break;
+		}
+	}
+	return val;
+}
+
+void graph_util_unlink_arch(linkedlist* arches, gnode* to) {
+
+	ll_iterator it;
+	for (ll_iter_begin(arches, &it); ll_iter_has_next(&it);) {
+
+		if (((garch*)ll_iter_next(&it))->to == to) {
+
+			ll_iter_remove(&it);
+			break;
+		}
+	}
+	return;
+}
+
+void graph_util_unlink_node(linkedlist* nodes, gnode* n) {
+
+	ll_iterator it;
+	for (ll_iter_begin(nodes, &it); ll_iter_has_next(&it);) {
+
+		if (*(gnode**)ll_iter_next(&it) == n) {
+
+			ll_iter_remove(&it);
+			break;
+		}
+	}
+	return;
+}
+
+void graph_util_free_node(gnode* n) {
+
+	ll_delete(&n->adjacency);
+	ll_delete(&n->incoming);
+	free(n);
 	return;
 }
 
+size_t graph_util_next_mark(graph* g) {
+
+	// Marks only have to differ from the previous ones, when they wrap around every node is reset
+	if (++g->mark == 0) {
+
+		ll_iterator it;
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) (*(gnode**)ll_iter_next(&it))->mark = 0;
+		g->mark = 1;
+	}
+	return g->mark;
+}
+
+void graph_util_components(graph* g) {
+
+	unionfind* components = uf_create(ll_get_size(g->nodes) > 0 ? ll_get_size(g->nodes) : 1);
+
+	if (components) {
+
+		ll_iterator it;
+		size_t i = 0;
+
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it); i++) (*(gnode**)ll_iter_next(&it))->component = i;
+
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) {
+
+			gnode* n = *(gnode**)ll_iter_next(&it);
+
+			ll_iterator arches;
+			for (ll_iter_begin(n->adjacency, &arches); ll_iter_has_next(&arches);) uf_union(components, n->component, ((garch*)ll_iter_next(&arches))->to->component);
+		}
+
+		uf_delete(&g->components);
+		g->components = components;
+		g->components_dirty = false;
+	}
+	return;
+}
+
+/**
+ * Pearce-Kelly: only the nodes whose position is between the two nodes of the arch can be misplaced,
+ * the ones reached from 'to' (forward) and the ones reaching 'from' (backward). They swap places, each
+ * group keeping its relative order, and take the same set of positions they held before
+ */
+void graph_util_update_order(graph* g, gnode* from, gnode* to) {
+
+	// Already in order, nothing to fix
+	if (from->order < to->order) return;
+
+	size_t lower = to->order, upper = from->order;
+	vector* forward = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
+	vector* backward = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
+	vector* stack = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
+	vector* positions = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(size_t));
+	bool cycle = false;
+
+	if (forward && backward && stack && positions) {
+
+		size_t mark = graph_util_next_mark(g);
+		gnode* cur = to;
+
+		// Forward search from 'to', among the nodes placed before 'from', reaching 'from' means the arch closed a cycle
+		to->mark = mark;
+		vec_push_back(stack, &cur);
+		while (!cycle && vec_get_length(stack) > 0) {
+
+			vec_pop_2_back(stack, &cur);
+			vec_push_back(forward, &cur);
+
+			ll_iterator it;
+			for (ll_iter_begin(cur->adjacency, &it); ll_iter_has_next(&it);) {
+
+				gnode* next = ((garch*)ll_iter_next(&it))->to;
+				if (next == from) cycle = true;
+				else if (next->mark != mark && next->order < upper) {
+
+					next->mark = mark;
+					vec_push_back(stack, &next);
+				}
+			}
+		}
+
+		// Backward search from 'from', among the nodes placed after 'to'
+		cur = from;
+		from->mark = mark;
+		vec_resize(stack, 0);
+		if (!cycle) vec_push_back(stack, &cur);
+		while (vec_get_length(stack) > 0) {
+
+			vec_pop_2_back(stack, &cur);
+			vec_push_back(backward, &cur);
+
+			ll_iterator it;
+			for (ll_iter_begin(cur->incoming, &it); ll_iter_has_next(&it);) {
+
+				gnode* prev = *(gnode**)ll_iter_next(&it);
+				if (prev->mark != mark && prev->order > lower) {
+
+					prev->mark = mark;
+					vec_push_back(stack, &prev);
+				}
+			}
+		}
+
+		if (!cycle && vec_get_length(forward) + vec_get_length(backward) > 0) {
+
+			// The positions freed by both groups, in increasing order
+			for (size_t i = 0; i < vec_get_length(backward); i++) vec_push_back(positions, &(*(gnode**)vec_get_at(backward, i))->order);
+			for (size_t i = 0; i < vec_get_length(forward); i++) vec_push_back(positions, &(*(gnode**)vec_get_at(forward, i))->order);
+			vec_sort(positions, graph_util_compare_position);
+			vec_sort(backward, graph_util_compare_order);
+			vec_sort(forward, graph_util_compare_order);
+
+			// The nodes reaching 'from' go first, then the ones reached by 'to'
+			size_t k = 0;
+			for (size_t i = 0; i < vec_get_length(backward); i++, k++) (*(gnode**)vec_get_at(backward, i))->order = *(size_t*)vec_get_at(positions, k);
+			for (size_t i = 0; i < vec_get_length(forward); i++, k++) (*(gnode**)vec_get_at(forward, i))->order = *(size_t*)vec_get_at(positions, k);
+		}
+	}
+
+	// Without memory for the searches the order can't be trusted anymore, it gets computed again by the next query
+	if (cycle || !forward || !backward || !stack || !positions || vec_get_length(positions) < vec_get_length(forward) + vec_get_length(backward)) {
+
+		g->order_valid = false;
+		g->order_dirty = !cycle;
+	}
+
+	vec_delete(&forward);
+	vec_delete(&backward);
+	vec_delete(&stack);
+	vec_delete(&positions);
+	return;
+}
+
+void graph_util_compute_order(graph* g) {
+
+	vector* ready = vec_create(GRAPH_TRAVERSAL_CAPACITY, sizeof(gnode*));
+
+	if (ready) {
+
+		size_t placed = 0;
+		ll_iterator it;
+
+		// Nodes without predecessors can go first
+		for (ll_iter_begin(g->nodes, &it); ll_iter_has_next(&it);) {
+
+			gnode* n = *(gnode**)ll_iter_next(&it);
+			n->pending = ll_get_size(n->incoming);
+			if (n->pending == 0) vec_push_back(ready, &n);
+		}
+
+		while (vec_get_length(ready) > 0) {
+
+			gnode* cur = NULL;
+			vec_pop_2_back(ready, &cur);
+			cur->order = placed++;
+
+			ll_iterator arches;
+			for (ll_iter_begin(cur->adjacency, &arches); ll_iter_has_next(&arches);) {
+
+				gnode* next = ((garch*)ll_iter_next(&arches))->to;
+				if (--next->pending == 0) vec_push_back(ready, &next);
+			}
+		}
+
+		// Some node was never freed of its predecessors, it's on a cycle
+		g->order_valid = placed == ll_get_size(g->nodes);
+		g->order_dirty = false;
+		g->next_order = placed < ll_get_size(g->nodes) ? ll_get_size(g->nodes) : placed;
+	}
+	vec_delete(&ready);
+	return;
+}
+
+int graph_util_compare_order(void* a, void* b) {
+
+	size_t x = (*(gnode**)a)->order, y = (*(gnode**)b)->order;
+
+	return (x > y) - (x < y);
+}
+
+int graph_util_compare_position(void* a, void* b) {
+
+	size_t x = *(size_t*)a, y = *(size_t*)b;
+
+	return (x > y) - (x < y);
+}
+
 #endif
\ No newline at end of file
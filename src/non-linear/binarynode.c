@@ -7,12 +7,20 @@
  */
 
 #include "../../include/non-linear/binarynode.h"
+#include <stdint.h>
 #include <string.h>
 
+/* MSVC's stdlib.h defines it, the other compilers don't */
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
  /**
   * Struct that implements a binary node, that can be used in binary trees
   *
   * This has a generic type value, a left child (binary node), and a right child (binary node)
+  *
+  * The value is stored right after the struct, in the same allocation
   */
 typedef struct binarynode {
 
@@ -25,9 +33,6 @@ typedef struct binarynode {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	/* Pointer to a generic type of data */
-	void* ptr;
-
 	/* Pointer to the binary node's father */
 	binarynode* father;
 
@@ -36,6 +41,12 @@ typedef struct binarynode {
 
 	/* Pointer to the binary node's right child */
 	binarynode* right;
+
+	/* Number of nodes in the tree whose root is this node, kept up to date by the trees */
+	size_t size;
+
+	/* Height of the tree whose root is this node, kept up to date by the trees */
+	int height;
 } binarynode;
 
 /**
@@ -43,28 +54,31 @@ typedef struct binarynode {
  */
 binarynode* binarynode_create(void* x, size_t element_size) {
 
-	binarynode* bn = NULL;
+	return binarynode_create_in(NULL, x, element_size);
+}
 
-	if (0 < element_size && element_size <= SIZE_MAX && x) {
+/**
+ * Creates a binary node like binarynode_create, taking its memory from the pool p
+ *
+ * The blocks of p have to be at least binarynode_get_footprint(element_size) bytes big
+ * If p is NULL the memory is taken from malloc
+ */
+binarynode* binarynode_create_in(pool* p, void* x, size_t element_size) {
 
-		bn = (binarynode*)malloc(sizeof(binarynode));
+	binarynode* bn = NULL;
 
-		if (bn) {
-		
-			bn->ptr = malloc(element_size);
+	if (0 < element_size && element_size <= SIZE_MAX - sizeof(binarynode) && x) {
 
-			if (bn->ptr) {
+		bn = (binarynode*)(p ? pool_alloc(p) : malloc(binarynode_get_footprint(element_size)));
 
-				memcpy(bn->ptr, x, element_size);
-				bn->father = NULL;
-				bn->left = NULL;
-				bn->right = NULL;
-			}
-			else {
+		if (bn) {
 
-				free(bn);
-				bn = NULL;
-			}
+			memcpy(binarynode_get_value(bn), x, element_size);
+			bn->father = NULL;
+			bn->left = NULL;
+			bn->right = NULL;
+			bn->size = 1;
+			bn->height = 1;
 		}
 	}
 
@@ -76,22 +90,42 @@ binarynode* binarynode_create(void* x, size_t element_size) {
  */
 void binarynode_delete(binarynode** bn) {
 
+	binarynode_delete_in(NULL, bn);
+	return;
+}
+
+/**
+ * Deletes the given binary node, created by binarynode_create_in with the same pool
+ *
+ * If p is NULL the memory is given back to free
+ */
+void binarynode_delete_in(pool* p, binarynode** bn) {
+
 	if (bn && *bn) {
 
-		free((*bn)->ptr);
-		memset(*bn, 0, sizeof(binarynode));
-		free(*bn);
+		if (p) pool_free(p, *bn);
+		else free(*bn);
 		*bn = NULL;
 	}
 	return;
 }
 
+/**
+ * Returns the number of bytes used by a binary node storing a value of the given size
+ *
+ * Useful for creating pools of nodes
+ */
+size_t binarynode_get_footprint(size_t element_size) {
+
+	return sizeof(binarynode) + element_size;
+}
+
 /**
  * Returns the stored value
  */
 void* binarynode_get_value(binarynode* bn) {
 
-	return bn ? bn->ptr : NULL;
+	return bn ? (void*)((char*)bn + sizeof(binarynode)) : NULL;
 }
 
 /**
@@ -155,10 +189,12 @@ bool binarynode_is_leaf(binarynode* bn) {
 
 /**
  * Returns the height of the tree whose root is bn
+ *
+ * The height is stored in the node, the trees keep it up to date through binarynode_update
  */
 int binarynode_get_height(binarynode* bn) {
 
-	return bn ? 1 + max(binarynode_get_height(bn->left), binarynode_get_height(bn->right)) : 0;
+	return bn ? bn->height : 0;
 }
 
 /**
@@ -167,4 +203,29 @@ int binarynode_get_height(binarynode* bn) {
 int binarynode_get_balance(binarynode* bn) {
 
 	return bn ? binarynode_get_height(bn->left) - binarynode_get_height(bn->right) : 0;
+}
+
+/**
+ * Returns the number of nodes in the tree whose root is bn
+ *
+ * The size is stored in the node, the trees keep it up to date through binarynode_update
+ */
+size_t binarynode_get_size(binarynode* bn) {
+
+	return bn ? bn->size : 0;
+}
+
+/**
+ * Recomputes the height and the size of the tree whose root is bn from the ones of its children
+ *
+ * Has to be called, bottom up, on every node whose children changed
+ */
+void binarynode_update(binarynode* bn) {
+
+	if (bn) {
+
+		bn->height = 1 + max(binarynode_get_height(bn->left), binarynode_get_height(bn->right));
+		bn->size = 1 + binarynode_get_size(bn->left) + binarynode_get_size(bn->right);
+	}
+	return;
 }
\ No newline at end of file
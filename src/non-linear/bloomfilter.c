@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/bloomfilter.h"
+#include "../../include/linear/bitset.h"
+#include <string.h>
+#include <math.h>
+
+/* Utility function that returns the two hashes the positions of a key are derived from */
+void bloom_util_hash(bloomfilter* bf, const void* key, size_t len, size_t* h1, size_t* h2);
+
+/**
+ * Struct that represent a bloom filter, a set of keys that can only tell
+ * for sure that a key was never added (it may answer yes for keys that weren't)
+ *
+ * keys are sequences of bytes (strings or any other data), each one sets k bits
+ * of a bitset, chosen by double hashing the two default hash functions
+ *
+ * Filters with the same number of bits, hashes and seed can be merged
+ */
+typedef struct bloomfilter {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Bits of the filter */
+	bitset* bits;
+
+	/* Number of bits set for each key */
+	size_t hashes;
+
+	/* Seed given to the hash functions */
+	uint64_t seed;
+} bloomfilter;
+
+/**
+ * Creates a bloom filter of the given number of bits, setting the given number of bits per key
+ */
+bloomfilter* bloom_create(size_t bits, size_t hashes) {
+
+	bloomfilter* bf = NULL;
+
+	if (0 < bits && 0 < hashes) {
+
+		bf = (bloomfilter*)malloc(sizeof(bloomfilter));
+		if (bf) {
+
+			bf->bits = bitset_create(bits);
+			bf->hashes = hashes;
+			bf->seed = hash_util_random_seed();
+
+			if (!bf->bits) {
+
+				free(bf);
+				bf = NULL;
+			}
+		}
+	}
+	return bf;
+}
+
+/**
+ * Creates a bloom filter sized for n keys with the given false positive rate
+ */
+bloomfilter* bloom_create_for(size_t n, double fpr) {
+
+	size_t bits = 0, hashes = 0;
+
+	bloom_get_optimal_size(n, fpr, &bits, &hashes);
+	return bloom_create(bits, hashes);
+}
+
+/**
+ * Computes the number of bits and hashes of a filter for n keys with the given false positive rate
+ */
+void bloom_get_optimal_size(size_t n, double fpr, size_t* bits, size_t* hashes) {
+
+	if (0 < n && 0.0 < fpr && fpr < 1.0 && bits && hashes) {
+
+		// m = -n ln(p) / ln(2)^2 bits, k = m / n ln(2) hashes
+		double m = ceil(-(double)n * log(fpr) / (log(2.0) * log(2.0)));
+		double k = round(m / (double)n * log(2.0));
+
+		*bits = (m < (double)SIZE_MAX) ? (size_t)m : 0;
+		*hashes = (k < 1.0) ? 1 : (size_t)k;
+	}
+	return;
+}
+
+/**
+ * Deletes the given bloom filter
+ */
+void bloom_delete(bloomfilter** bf) {
+
+	if (bf && *bf) {
+
+		bitset_delete(&(*bf)->bits);
+		free(*bf);
+		*bf = NULL;
+	}
+	return;
+}
+
+/**
+ * Adds the given key (a string) to the filter
+ */
+void bloom_add(bloomfilter* bf, const char* key) {
+
+	if (key) bloom_add_n(bf, key, strlen(key));
+	return;
+}
+
+/**
+ * Adds the given key, of len bytes, to the filter
+ */
+void bloom_add_n(bloomfilter* bf, const void* key, size_t len) {
+
+	if (bf && key) {
+
+		size_t h1, h2;
+		size_t size = bitset_get_size(bf->bits);
+
+		bloom_util_hash(bf, key, len, &h1, &h2);
+
+		// The i -th position is h1 + i * h2, modulo the size
+		for (size_t i = 0; i < bf->hashes; i++) {
+
+			bitset_set(bf->bits, h1);
+			h1 = (h1 >= size - h2) ? h1 - (size - h2) : h1 + h2;
+		}
+	}
+	return;
+}
+
+/**
+ * Checks if the given key (a string) may have been added to the filter
+ */
+bool bloom_contains(bloomfilter* bf, const char* key) {
+
+	return key ? bloom_contains_n(bf, key, strlen(key)) : false;
+}
+
+/**
+ * Checks if the given key, of len bytes, may have been added to the filter
+ */
+bool bloom_contains_n(bloomfilter* bf, const void* key, size_t len) {
+
+	bool found = false;
+
+	if (bf && key) {
+
+		size_t h1, h2;
+		size_t size = bitset_get_size(bf->bits);
+
+		bloom_util_hash(bf, key, len, &h1, &h2);
+
+		// A single bit at 0 means the key was never added
+		found = true;
+		for (size_t i = 0; i < bf->hashes && found; i++) {
+
+			found = bitset_get(bf->bits, h1);
+			h1 = (h1 >= size - h2) ? h1 - (size - h2) : h1 + h2;
+		}
+	}
+	return found;
+}
+
+/**
+ * Adds every key of other to the filter
+ *
+ * Returns whether or not they could be merged (same number of bits, hashes and seed)
+ */
+bool bloom_merge(bloomfilter* bf, bloomfilter* other) {
+
+	bool merged = false;
+
+	if (bf && other && bitset_get_size(bf->bits) == bitset_get_size(other->bits) && bf->hashes == other->hashes && bf->seed == other->seed) {
+
+		bitset_or(bf->bits, other->bits);
+		merged = true;
+	}
+	return merged;
+}
+
+/**
+ * Returns the expected false positive rate, given the bits set so far
+ */
+double bloom_get_fpr(bloomfilter* bf) {
+
+	// Every one of the k bits of a key that wasn't added has to be set
+	return bf ? pow((double)bitset_count(bf->bits) / (double)bitset_get_size(bf->bits), (double)bf->hashes) : 0.0;
+}
+
+/**
+ * Returns the number of bits of the filter
+ */
+size_t bloom_get_size(bloomfilter* bf) {
+
+	return bf ? bitset_get_size(bf->bits) : 0;
+}
+
+/**
+ * Returns the number of bits set for each key
+ */
+size_t bloom_get_hashes(bloomfilter* bf) {
+
+	return bf ? bf->hashes : 0;
+}
+
+/**
+ * Removes every key from the filter
+ */
+void bloom_clear(bloomfilter* bf) {
+
+	if (bf) {
+
+		bitset_unset_full(bf->bits);
+	}
+	return;
+}
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every filter starts with a random seed, filters that have to be
+ * merged need the same one; it can only be changed while the filter is empty
+ */
+void bloom_set_seed(bloomfilter* bf, uint64_t seed) {
+
+	if (bf && !bitset_count(bf->bits)) bf->seed = seed;
+	return;
+}
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t bloom_get_seed(bloomfilter* bf) {
+
+	return bf ? bf->seed : 0;
+}
+
+/* Utility function that returns the two hashes the positions of a key are derived from */
+void bloom_util_hash(bloomfilter* bf, const void* key, size_t len, size_t* h1, size_t* h2) {
+
+	size_t size = bitset_get_size(bf->bits);
+
+	*h1 = hash_util_default_hash(key, len, bf->seed) % size;
+
+	// The step can't be a multiple of the size, or every position would be the same
+	*h2 = hash_util_default_second_hash(key, len, bf->seed) % size;
+	if (*h2 == 0) *h2 = 1 % size;
+	return;
+}
\ No newline at end of file
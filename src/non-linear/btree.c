@@ -0,0 +1,773 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../../include/non-linear/btree.h"
+
+/* Bytes of elements each node holds (a few cache lines) */
+#define BTREE_NODE_BYTES 256
+
+/* Smallest number of elements in a node, whatever the size of the elements */
+#define BTREE_MIN_CAPACITY 4
+
+/* Alignment of the elements stored inline in the nodes */
+#define BTREE_ALIGNMENT 16
+
+/**
+ * Node of the tree, leaves hold the elements and internal nodes hold separators,
+ * the i-th separator is not greater than any element under the child i + 1
+ * and greater than every element under the child i
+ *
+ * The children and the elements are in the same allocation as the node itself,
+ * each can hold one element (and one child) more than the capacity so that it can be split after inserting
+ */
+typedef struct btree_node {
+
+	/* Number of elements (leaves) or separators (internal nodes) */
+	size_t count;
+
+	/* Children of the node, NULL for leaves */
+	struct btree_node** children;
+
+	/* Previous and next leaves, in order */
+	struct btree_node* prev;
+	struct btree_node* next;
+
+	/* Elements or separators */
+	char* keys;
+} btree_node;
+
+/* Utility function used to allocate a node */
+btree_node* btree_util_create_node(btree* t, bool leaf);
+
+/* Utility functions used to free a node, or a node and everything under it */
+void btree_util_free_node(btree* t, btree_node* n);
+void btree_util_free(btree* t, btree_node* n);
+
+/* Utility function that returns a pointer to the i-th key of a node */
+void* btree_util_key(btree* t, btree_node* n, size_t i);
+
+/* Utility function that returns the position of the first key not less than x */
+size_t btree_util_lower_bound(btree* t, btree_node* n, void* x);
+
+/* Utility function that returns the position of the first key greater than x */
+size_t btree_util_upper_bound(btree* t, btree_node* n, void* x);
+
+/* Utility function that returns the leaf where x is (or would be) */
+btree_node* btree_util_find_leaf(btree* t, void* x);
+
+/* Utility function used to insert x under the node, returns the new right sibling if the node was split */
+btree_node* btree_util_insert(btree* t, btree_node* n, void* x);
+
+/* Utility function used to remove x from under the node, returns whether or not it was there */
+bool btree_util_remove(btree* t, btree_node* n, void* x);
+
+/* Utility function used to fill up the i-th child of a node, that has too few keys */
+void btree_util_rebalance(btree* t, btree_node* n, size_t i);
+
+/**
+ * Struct that implements a B+tree, an ordered struct like the BST and the AVL
+ * that is used to store and then search elements
+ *
+ * This has a generic type value, so a compare function needs to be given
+ */
+typedef struct btree {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Root of the tree, NULL if the tree is empty */
+	btree_node* root;
+
+	/* First and last leaves */
+	btree_node* first;
+	btree_node* last;
+
+	/* Separator going up after a split */
+	void* separator;
+
+	/* Most keys a node holds, and fewest keys a node (but the root) holds */
+	size_t capacity;
+	size_t min_keys;
+
+	/* Number of elements */
+	size_t size;
+
+	/* Number of levels */
+	size_t height;
+
+	/* Number of nodes allocated */
+	size_t nodes;
+
+	/* Size of the elements stored in the tree */
+	size_t element_size;
+
+	/* Function used to compare elements */
+	int (*compare)(void*, void*);
+
+#ifdef CDS_WITH_STATS
+	/* Nodes allocated and freed so far, and the bytes requested for them */
+	size_t allocations;
+	size_t frees;
+	size_t bytes;
+#endif
+} btree;
+
+/**
+ * Creates a B+tree that can store elements of the given size
+ */
+btree* btree_create(size_t element_size, int (*compare)(void*, void*)) {
+
+	btree* t = NULL;
+
+	if (element_size > 0 && compare) {
+
+		t = (btree*)malloc(sizeof(btree));
+		if (t) {
+
+			t->separator = malloc(element_size);
+			if (t->separator) {
+
+				t->root = NULL;
+				t->first = NULL;
+				t->last = NULL;
+				t->capacity = BTREE_NODE_BYTES / element_size;
+				if (t->capacity < BTREE_MIN_CAPACITY) t->capacity = BTREE_MIN_CAPACITY;
+				t->min_keys = t->capacity / 2;
+				t->size = 0;
+				t->height = 0;
+				t->nodes = 0;
+				t->element_size = element_size;
+				t->compare = compare;
+#ifdef CDS_WITH_STATS
+				t->allocations = 0;
+				t->frees = 0;
+				t->bytes = 0;
+#endif
+			}
+			else {
+
+				free(t);
+				t = NULL;
+			}
+		}
+	}
+	return t;
+}
+
+/**
+ * Deletes the given B+tree
+ */
+void btree_delete(btree** t) {
+
+	if (t && *t) {
+
+		btree_clear(*t);
+		free((*t)->separator);
+		free(*t);
+		*t = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts the value x in the tree, according to the compare function
+ *
+ * If an equal element is already in the tree it is replaced by x
+ */
+void btree_insert(btree* t, void* x) {
+
+	if (t && x) {
+
+		if (!t->root) {
+
+			t->root = btree_util_create_node(t, true);
+			if (t->root) {
+
+				t->first = t->root;
+				t->last = t->root;
+				t->height = 1;
+			}
+		}
+
+		if (t->root) {
+
+			btree_node* right = btree_util_insert(t, t->root, x);
+
+			// The root was split, the tree grows by one level
+			if (right) {
+
+				btree_node* root = btree_util_create_node(t, false);
+				if (root) {
+
+					memcpy(btree_util_key(t, root, 0), t->separator, t->element_size);
+					root->children[0] = t->root;
+					root->children[1] = right;
+					root->count = 1;
+					t->root = root;
+					t->height++;
+				}
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the value x from the tree, if it is present
+ */
+void btree_remove(btree* t, void* x) {
+
+	if (t && x && t->root) {
+
+		if (btree_util_remove(t, t->root, x)) {
+
+			t->size--;
+
+			// The root lost its last separator, its only child becomes the root
+			if (t->root->children && t->root->count == 0) {
+
+				btree_node* old = t->root;
+				t->root = old->children[0];
+				btree_util_free_node(t, old);
+				t->height--;
+			}
+			else if (!t->root->children && t->root->count == 0) {
+
+				btree_util_free_node(t, t->root);
+				t->root = NULL;
+				t->first = NULL;
+				t->last = NULL;
+				t->height = 0;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Searches the value x in the tree, returns a pointer to the element equal to it (NULL if not present)
+ *
+ * The pointer is valid until the tree is modified
+ */
+void* btree_search(btree* t, void* x) {
+
+	void* val = NULL;
+
+	if (t && x && t->root) {
+
+		btree_node* leaf = btree_util_find_leaf(t, x);
+		size_t i = btree_util_lower_bound(t, leaf, x);
+
+		if (i < leaf->count && t->compare(x, btree_util_key(t, leaf, i)) == 0) val = btree_util_key(t, leaf, i);
+	}
+	return val;
+}
+
+/**
+ * Checks wheter or not the value x is present in the tree
+ */
+bool btree_contains(btree* t, void* x) {
+
+	return btree_search(t, x) != NULL;
+}
+
+/**
+ * Returns the minimum value in the tree
+ */
+void* btree_min(btree* t) {
+
+	return (t && t->first) ? btree_util_key(t, t->first, 0) : NULL;
+}
+
+/**
+ * Copies the minimum value in the tree inside the buffer
+ */
+void btree_min_2(btree* t, void* buf) {
+
+	void* val = btree_min(t);
+
+	if (val && buf) memcpy(buf, val, t->element_size);
+	return;
+}
+
+/**
+ * Returns the maximum value in the tree
+ */
+void* btree_max(btree* t) {
+
+	return (t && t->last) ? btree_util_key(t, t->last, t->last->count - 1) : NULL;
+}
+
+/**
+ * Copies the maximum value in the tree inside the buffer
+ */
+void btree_max_2(btree* t, void* buf) {
+
+	void* val = btree_max(t);
+
+	if (val && buf) memcpy(buf, val, t->element_size);
+	return;
+}
+
+/**
+ * Returns the greatest value in the tree that is less than x (NULL if there's none)
+ *
+ * x doesn't need to be in the tree
+ */
+void* btree_predecessor(btree* t, void* x) {
+
+	void* val = NULL;
+
+	if (t && x && t->root) {
+
+		btree_node* leaf = btree_util_find_leaf(t, x);
+		size_t i = btree_util_lower_bound(t, leaf, x);
+
+		// Everything in the previous leaf is less than x
+		if (i > 0) val = btree_util_key(t, leaf, i - 1);
+		else if (leaf->prev) val = btree_util_key(t, leaf->prev, leaf->prev->count - 1);
+	}
+	return val;
+}
+
+/**
+ * Returns the smallest value in the tree that is greater than x (NULL if there's none)
+ *
+ * x doesn't need to be in the tree
+ */
+void* btree_successor(btree* t, void* x) {
+
+	void* val = NULL;
+
+	if (t && x && t->root) {
+
+		btree_node* leaf = btree_util_find_leaf(t, x);
+		size_t i = btree_util_upper_bound(t, leaf, x);
+
+		// Everything in the next leaf is greater than x
+		if (i < leaf->count) val = btree_util_key(t, leaf, i);
+		else if (leaf->next) val = btree_util_key(t, leaf->next, 0);
+	}
+	return val;
+}
+
+/**
+ * Traverses the tree in inorder, applying the function callback to each element
+ */
+void btree_traverse_inoder(btree* t, void (*callback)(void*)) {
+
+	btree_traverse_range(t, NULL, NULL, callback);
+	return;
+}
+
+/**
+ * Applies the function callback, in order, to each element between from and to (both included)
+ *
+ * A NULL bound means the range isn't limited on that side
+ */
+void btree_traverse_range(btree* t, void* from, void* to, void (*callback)(void*)) {
+
+	if (t && callback && t->root) {
+
+		btree_node* leaf = from ? btree_util_find_leaf(t, from) : t->first;
+		size_t i = from ? btree_util_lower_bound(t, leaf, from) : 0;
+
+		// Walk the linked leaves until an element is past the end of the range
+		while (leaf) {
+
+			for (; i < leaf->count; i++) {
+
+				void* val = btree_util_key(t, leaf, i);
+
+				if (to && t->compare(val, to) > 0) return;
+				callback(val);
+			}
+			leaf = leaf->next;
+			i = 0;
+		}
+	}
+	return;
+}
+
+/**
+ * Returns the number of elements in the tree
+ */
+size_t btree_get_size(btree* t) {
+
+	return t ? t->size : 0;
+}
+
+/**
+ * Returns the size of elements stored in the tree
+ */
+size_t btree_get_element_size(btree* t) {
+
+	return t ? t->element_size : 0;
+}
+
+/**
+ * Removes each element from the tree, the struct itself is preserved
+ */
+void btree_clear(btree* t) {
+
+	if (t) {
+
+		btree_util_free(t, t->root);
+		t->root = NULL;
+		t->first = NULL;
+		t->last = NULL;
+		t->size = 0;
+		t->height = 0;
+	}
+	return;
+}
+
+/**
+ * Checks wheter or not the tree is empty
+ */
+bool btree_is_empty(btree* t) {
+
+	return btree_get_size(t) == 0;
+}
+
+/**
+ * Returns the compare function used in the tree
+ */
+void* btree_get_compare_func(btree* t) {
+
+	return t ? (void*)t->compare : NULL;
+}
+
+/**
+ * Returns the height of the tree
+ */
+size_t btree_get_height(btree* t) {
+
+	return t ? t->height : 0;
+}
+
+/**
+ * Copies in stats the allocation counters of the nodes of the tree
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * Each node is allocated on its own, so every allocation is also a chunk
+ */
+void btree_get_stats(btree* t, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+
+		if (t) {
+
+			stats->live = t->nodes;
+#ifdef CDS_WITH_STATS
+			stats->allocations = t->allocations;
+			stats->frees = t->frees;
+			stats->chunks = t->allocations;
+			stats->bytes = t->bytes;
+#endif
+		}
+	}
+	return;
+}
+
+/* Utility function used to allocate a node */
+btree_node* btree_util_create_node(btree* t, bool leaf) {
+
+	// Header, children (internal nodes only) and keys, each part aligned
+	size_t header = (sizeof(btree_node) + BTREE_ALIGNMENT - 1) / BTREE_ALIGNMENT * BTREE_ALIGNMENT;
+	size_t children = leaf ? 0 : ((t->capacity + 2) * sizeof(btree_node*) + BTREE_ALIGNMENT - 1) / BTREE_ALIGNMENT * BTREE_ALIGNMENT;
+
+	size_t bytes = header + children + (t->capacity + 1) * t->element_size;
+
+	btree_node* n = (btree_node*)malloc(bytes);
+	if (n) {
+
+		t->nodes++;
+		STATS_INC(t->allocations);
+		STATS_ADD(t->bytes, bytes);
+
+		n->count = 0;
+		n->children = leaf ? NULL : (btree_node**)((char*)n + header);
+		n->prev = NULL;
+		n->next = NULL;
+		n->keys = (char*)n + header + children;
+	}
+	return n;
+}
+
+/* Utility function used to free a single node */
+void btree_util_free_node(btree* t, btree_node* n) {
+
+	t->nodes--;
+	STATS_INC(t->frees);
+	free(n);
+	return;
+}
+
+/* Utility function used to free a node and everything under it */
+void btree_util_free(btree* t, btree_node* n) {
+
+	if (n) {
+
+		if (n->children) {
+
+			for (size_t i = 0; i <= n->count; i++) btree_util_free(t, n->children[i]);
+		}
+		btree_util_free_node(t, n);
+	}
+	return;
+}
+
+/* Utility function that returns a pointer to the i-th key of a node */
+void* btree_util_key(btree* t, btree_node* n, size_t i) {
+
+	return n->keys + i * t->element_size;
+}
+
+/* Utility function that returns the position of the first key not less than x */
+size_t btree_util_lower_bound(btree* t, btree_node* n, void* x) {
+
+	size_t low = 0, high = n->count;
+
+	while (low < high) {
+
+		size_t mid = low + (high - low) / 2;
+
+		if (t->compare(x, btree_util_key(t, n, mid)) > 0) low = mid + 1;
+		else high = mid;
+	}
+	return low;
+}
+
+/* Utility function that returns the position of the first key greater than x */
+size_t btree_util_upper_bound(btree* t, btree_node* n, void* x) {
+
+	size_t low = 0, high = n->count;
+
+	while (low < high) {
+
+		size_t mid = low + (high - low) / 2;
+
+		if (t->compare(x, btree_util_key(t, n, mid)) >= 0) low = mid + 1;
+		else high = mid;
+	}
+	return low;
+}
+
+/* Utility function that returns the leaf where x is (or would be) */
+btree_node* btree_util_find_leaf(btree* t, void* x) {
+
+	btree_node* n = t->root;
+
+	// Elements equal to a separator are under the child to its right
+	while (n->children) n = n->children[btree_util_upper_bound(t, n, x)];
+	return n;
+}
+
+/* Utility function used to insert x under the node, returns the new right sibling if the node was split */
+btree_node* btree_util_insert(btree* t, btree_node* n, void* x) {
+
+	size_t es = t->element_size;
+	btree_node* right = NULL;
+
+	if (!n->children) {
+
+		size_t i = btree_util_lower_bound(t, n, x);
+
+		// Already there, the element is replaced
+		if (i < n->count && t->compare(x, btree_util_key(t, n, i)) == 0) {
+
+			memcpy(btree_util_key(t, n, i), x, es);
+			return NULL;
+		}
+
+		memmove(btree_util_key(t, n, i + 1), btree_util_key(t, n, i), (n->count - i) * es);
+		memcpy(btree_util_key(t, n, i), x, es);
+		n->count++;
+		t->size++;
+
+		// Too many elements, the upper half goes in a new leaf and its first element goes up
+		if (n->count > t->capacity) {
+
+			right = btree_util_create_node(t, true);
+			if (right) {
+
+				size_t mid = n->count / 2;
+
+				right->count = n->count - mid;
+				memcpy(right->keys, btree_util_key(t, n, mid), right->count * es);
+				n->count = mid;
+
+				right->prev = n;
+				right->next = n->next;
+				if (n->next) n->next->prev = right;
+				else t->last = right;
+				n->next = right;
+
+				memcpy(t->separator, right->keys, es);
+			}
+		}
+	}
+	else {
+
+		size_t i = btree_util_upper_bound(t, n, x);
+		btree_node* child = btree_util_insert(t, n->children[i], x);
+
+		// The child was split, its separator and the new child are added after it
+		if (child) {
+
+			memmove(btree_util_key(t, n, i + 1), btree_util_key(t, n, i), (n->count - i) * es);
+			memcpy(btree_util_key(t, n, i), t->separator, es);
+			memmove(n->children + i + 2, n->children + i + 1, (n->count - i) * sizeof(btree_node*));
+			n->children[i + 1] = child;
+			n->count++;
+
+			// Too many separators, the middle one goes up and the ones after it go in a new node
+			if (n->count > t->capacity) {
+
+				right = btree_util_create_node(t, false);
+				if (right) {
+
+					size_t mid = n->count / 2;
+
+					right->count = n->count - mid - 1;
+					memcpy(right->keys, btree_util_key(t, n, mid + 1), right->count * es);
+					memcpy(right->children, n->children + mid + 1, (right->count + 1) * sizeof(btree_node*));
+					memcpy(t->separator, btree_util_key(t, n, mid), es);
+					n->count = mid;
+				}
+			}
+		}
+	}
+	return right;
+}
+
+/* Utility function used to remove x from under the node, returns whether or not it was there */
+bool btree_util_remove(btree* t, btree_node* n, void* x) {
+
+	size_t es = t->element_size;
+	bool removed = false;
+
+	if (!n->children) {
+
+		size_t i = btree_util_lower_bound(t, n, x);
+
+		if (i < n->count && t->compare(x, btree_util_key(t, n, i)) == 0) {
+
+			memmove(btree_util_key(t, n, i), btree_util_key(t, n, i + 1), (n->count - i - 1) * es);
+			n->count--;
+			removed = true;
+		}
+	}
+	else {
+
+		size_t i = btree_util_upper_bound(t, n, x);
+
+		removed = btree_util_remove(t, n->children[i], x);
+		if (removed && n->children[i]->count < t->min_keys) btree_util_rebalance(t, n, i);
+	}
+	return removed;
+}
+
+/* Utility function used to fill up the i-th child of a node, that has too few keys */
+void btree_util_rebalance(btree* t, btree_node* n, size_t i) {
+
+	size_t es = t->element_size;
+	btree_node* child = n->children[i];
+	btree_node* left = i > 0 ? n->children[i - 1] : NULL;
+	btree_node* right = i < n->count ? n->children[i + 1] : NULL;
+
+	// Borrow the last key of the left sibling
+	if (left && left->count > t->min_keys) {
+
+		memmove(btree_util_key(t, child, 1), child->keys, child->count * es);
+
+		if (!child->children) {
+
+			memcpy(child->keys, btree_util_key(t, left, left->count - 1), es);
+			memcpy(btree_util_key(t, n, i - 1), child->keys, es);
+		}
+		else {
+
+			// The separator comes down, the last separator of the sibling goes up in its place
+			memmove(child->children + 1, child->children, (child->count + 1) * sizeof(btree_node*));
+			child->children[0] = left->children[left->count];
+			memcpy(child->keys, btree_util_key(t, n, i - 1), es);
+			memcpy(btree_util_key(t, n, i - 1), btree_util_key(t, left, left->count - 1), es);
+		}
+		child->count++;
+		left->count--;
+	}
+
+	// Borrow the first key of the right sibling
+	else if (right && right->count > t->min_keys) {
+
+		if (!right->children) {
+
+			memcpy(btree_util_key(t, child, child->count), right->keys, es);
+			memmove(right->keys, btree_util_key(t, right, 1), (right->count - 1) * es);
+			memcpy(btree_util_key(t, n, i), right->keys, es);
+		}
+		else {
+
+			memcpy(btree_util_key(t, child, child->count), btree_util_key(t, n, i), es);
+			child->children[child->count + 1] = right->children[0];
+			memcpy(btree_util_key(t, n, i), right->keys, es);
+			memmove(right->keys, btree_util_key(t, right, 1), (right->count - 1) * es);
+			memmove(right->children, right->children + 1, right->count * sizeof(btree_node*));
+		}
+		child->count++;
+		right->count--;
+	}
+
+	// Neither sibling can spare a key, the child is merged with one of them
+	else {
+
+		if (left) {
+
+			right = child;
+			i--;
+		}
+		else left = child;
+
+		// The separator between the two comes down in internal nodes, and is dropped in leaves
+		if (!left->children) {
+
+			memcpy(btree_util_key(t, left, left->count), right->keys, right->count * es);
+			left->count += right->count;
+
+			left->next = right->next;
+			if (right->next) right->next->prev = left;
+			else t->last = left;
+		}
+		else {
+
+			memcpy(btree_util_key(t, left, left->count), btree_util_key(t, n, i), es);
+			memcpy(btree_util_key(t, left, left->count + 1), right->keys, right->count * es);
+			memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(btree_node*));
+			left->count += right->count + 1;
+		}
+		btree_util_free_node(t, right);
+
+		memmove(btree_util_key(t, n, i), btree_util_key(t, n, i + 1), (n->count - i - 1) * es);
+		memmove(n->children + i + 1, n->children + i + 2, (n->count - i - 1) * sizeof(btree_node*));
+		n->count--;
+	}
+	return;
+}
\ No newline at end of file
@@ -0,0 +1,853 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/chashmap.h"
+#include "../../include/non-linear/hashfunctions.h"
+#include <stdatomic.h>
+#include <threads.h>
+#include <string.h>
+
+/* Load factor above which the table is replaced by a bigger one, (live + deleted slots) / capacity */
+#define CHASH_DEFAULT_MAX_LOAD 0.75
+
+/* Number of locks shared by the writers, a key always maps to the same one */
+#define CHASH_LOCK_STRIPES 64
+
+/* Number of counters the readers announce themselves on, so that they don't all write the same cache line */
+#define CHASH_READER_STRIPES 64
+
+/* Number of retired pointers collected before waiting for the readers and freeing them */
+#define CHASH_RETIRE_BATCH 64
+
+/* Assumed size of a cache line, used to keep the reader counters apart */
+#define CHASH_CACHE_LINE 64
+
+/* Slots are padded to a multiple of this, so that the header and the values are aligned */
+#define CHASH_SLOT_ALIGNMENT 8
+
+/* States of a slot, busy means a writer claimed it and is filling it */
+#define CHASH_EMPTY 0u
+#define CHASH_BUSY 1u
+#define CHASH_FULL 2u
+#define CHASH_DELETED 3u
+
+/**
+ * Header stored at the start of every slot, the value follows it
+ *
+ * Every field is atomic so that readers, which don't lock, never see torn words;
+ * seq is odd while a writer is changing the slot, a reader accepts
+ * what it read only if seq was even and didn't change meanwhile
+ */
+typedef struct chash_slot {
+
+	/* Sequence counter of the slot */
+	atomic_uint seq;
+
+	/* One of the CHASH_ states */
+	atomic_uint state;
+
+	/* Pointer to the key bytes */
+	_Atomic(const void*) key;
+
+	/* Number of bytes of the key */
+	atomic_size_t key_length;
+
+	/* Hash of the key, used for the position */
+	atomic_size_t hash;
+
+	/* Second hash of the key, used for the probe step */
+	atomic_size_t second_hash;
+} chash_slot;
+
+/**
+ * Struct that represent a single open addressing table
+ *
+ * A table is never resized in place, a bigger one is built
+ * and published while the old one is left to the readers still using it
+ */
+typedef struct chash_table {
+
+	/* Array of slots, each one holds the slot header followed by the value */
+	char* slots;
+
+	/* Number of slots, a power of two */
+	size_t capacity;
+
+	/* Number of full slots */
+	atomic_size_t count;
+
+	/* Number of deleted slots */
+	atomic_size_t deleted_count;
+} chash_table;
+
+/* Counter of the readers inside the hashmap, padded to its own cache line */
+typedef struct chash_reader {
+
+	atomic_size_t active;
+	char padding[CHASH_CACHE_LINE - sizeof(atomic_size_t)];
+} chash_reader;
+
+/* Utility functions used to manage the hashmap */
+chash_table* chash_util_table_create(size_t capacity, size_t slot_size);
+void chash_util_table_free_keys(chashmap* hash, chash_table* t);
+chash_slot* chash_util_slot(chashmap* hash, chash_table* t, size_t index);
+void chash_util_compute(chashmap* hash, const void* key, size_t len, size_t* h, size_t* h2);
+int chash_util_read(chashmap* hash, chash_slot* slot, const void* key, size_t len, size_t h, void* buf);
+void chash_util_write(chashmap* hash, chash_slot* slot, const void* key, size_t len, size_t h, size_t h2, void* value);
+atomic_size_t* chash_util_read_lock(chashmap* hash);
+void chash_util_read_unlock(atomic_size_t* active);
+void chash_util_synchronize(chashmap* hash);
+void chash_util_retire(chashmap* hash, void* ptr);
+void chash_util_lock_all(chashmap* hash);
+void chash_util_unlock_all(chashmap* hash);
+void chash_util_resize(chashmap* hash, bool force);
+size_t chash_util_round_capacity(size_t capacity);
+size_t chash_util_thread_index(void);
+
+/* Index of the reader counter used by the calling thread, 0 until assigned */
+static _Thread_local size_t chash_thread_index = 0;
+
+/* Source of the thread indexes */
+static atomic_size_t chash_thread_counter = 0;
+
+ /**
+  * Struct that represent a concurrent hashmap, mapping keys into values
+  *
+  * keys are sequences of bytes (strings or any other data)
+  * values are of generic type
+  */
+typedef struct chashmap {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Current table, replaced as a whole when it grows */
+	_Atomic(chash_table*) table;
+
+	/* Size of the values stored in the hashmap */
+	size_t element_size;
+
+	/* Size of each slot, header + value + padding */
+	size_t slot_size;
+
+	/* Maximum ratio between used (full + deleted) slots and capacity, before growing */
+	double max_load;
+
+	/* Seed given to the hash function, random for every hashmap */
+	uint64_t seed;
+
+	/* Locks of the writers, the key with hash h uses locks[h % CHASH_LOCK_STRIPES] */
+	mtx_t locks[CHASH_LOCK_STRIPES];
+
+	/* Current epoch, its parity selects which set of counters new readers use */
+	atomic_size_t epoch;
+
+	/* Readers inside the hashmap, for each of the two epoch parities */
+	chash_reader readers[2][CHASH_READER_STRIPES];
+
+	/* Serializes the writers waiting for the readers to leave an epoch */
+	mtx_t sync_lock;
+
+	/* Pointers whose memory will be freed at the next grace period */
+	void** retired;
+	size_t retired_count;
+	size_t retired_capacity;
+	mtx_t retire_lock;
+} chashmap;
+
+/**
+ * Creates a concurrent hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements
+ *
+ * The capacity is rounded up to a power of two and grows automatically
+ */
+chashmap* chash_create(size_t capacity, size_t element_size) {
+
+	chashmap* hash = NULL;
+
+	if (0 < capacity && 0 < element_size && element_size <= SIZE_MAX - sizeof(chash_slot) - CHASH_SLOT_ALIGNMENT) {
+
+		size_t slot_size = (sizeof(chash_slot) + element_size + CHASH_SLOT_ALIGNMENT - 1) / CHASH_SLOT_ALIGNMENT * CHASH_SLOT_ALIGNMENT;
+
+		capacity = chash_util_round_capacity(capacity);
+		if (0 < capacity && capacity <= SIZE_MAX / slot_size) {
+
+			hash = (chashmap*)malloc(sizeof(chashmap));
+			if (hash) {
+
+				chash_table* t = chash_util_table_create(capacity, slot_size);
+				if (t) {
+
+					atomic_init(&hash->table, t);
+					hash->element_size = element_size;
+					hash->slot_size = slot_size;
+					hash->max_load = CHASH_DEFAULT_MAX_LOAD;
+					hash->seed = hash_util_random_seed();
+					atomic_init(&hash->epoch, 0);
+					hash->retired = NULL;
+					hash->retired_count = 0;
+					hash->retired_capacity = 0;
+
+					for (size_t i = 0; i < CHASH_LOCK_STRIPES; i++) mtx_init(&hash->locks[i], mtx_plain);
+					for (size_t i = 0; i < CHASH_READER_STRIPES; i++) {
+
+						atomic_init(&hash->readers[0][i].active, 0);
+						atomic_init(&hash->readers[1][i].active, 0);
+					}
+					mtx_init(&hash->sync_lock, mtx_plain);
+					mtx_init(&hash->retire_lock, mtx_plain);
+				}
+				else {
+
+					free(hash);
+					hash = NULL;
+				}
+			}
+		}
+	}
+	return hash;
+}
+
+/**
+ * Deletes the given concurrent hashmap
+ *
+ * The keys still stored in the hashmap are freed aswell
+ * No other thread may be using the hashmap while it is deleted
+ */
+void chash_delete(chashmap** hash) {
+
+	if (hash && *hash) {
+
+		chash_table* t = atomic_load(&(*hash)->table);
+		chash_util_table_free_keys(*hash, t);
+		free(t->slots);
+		free(t);
+
+		// Nobody is reading anymore, the retired pointers can go right away
+		for (size_t i = 0; i < (*hash)->retired_count; i++) free((*hash)->retired[i]);
+		free((*hash)->retired);
+
+		for (size_t i = 0; i < CHASH_LOCK_STRIPES; i++) mtx_destroy(&(*hash)->locks[i]);
+		mtx_destroy(&(*hash)->sync_lock);
+		mtx_destroy(&(*hash)->retire_lock);
+
+		free(*hash);
+		*hash = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void chash_put(chashmap* hash, const char* key, void* value) {
+
+	if (key) chash_put_n(hash, key, strlen(key), value);
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void chash_put_n(chashmap* hash, const void* key, size_t len, void* value) {
+
+	if (hash && key && value) {
+
+		size_t h, h2;
+		chash_util_compute(hash, key, len, &h, &h2);
+		mtx_t* lock = &hash->locks[h % CHASH_LOCK_STRIPES];
+
+		bool done = false;
+		while (!done) {
+
+			bool grow = false;
+			const void* old_key = NULL;
+
+			// The table can't be replaced while any stripe is held
+			mtx_lock(lock);
+			atomic_size_t* active = chash_util_read_lock(hash);
+			chash_table* t = atomic_load(&hash->table);
+
+			size_t mask = t->capacity - 1;
+			size_t index = h & mask;
+			size_t step = (h2 | 1) & mask;
+			size_t free_index = t->capacity;
+
+			// Look for the key along the whole sequence, remembering the first free slot
+			for (size_t i = 0; i < t->capacity; i++) {
+
+				chash_slot* slot = chash_util_slot(hash, t, index);
+				unsigned state = atomic_load(&slot->state);
+
+				if (state == CHASH_FULL && atomic_load_explicit(&slot->hash, memory_order_relaxed) == h && atomic_load_explicit(&slot->key_length, memory_order_relaxed) == len) {
+
+					const void* read_key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+					if (memcmp(read_key, key, len) == 0) {
+
+						// Key present, replace the couple
+						if (read_key != key) old_key = read_key;
+						chash_util_write(hash, slot, key, len, h, h2, value);
+						done = true;
+						break;
+					}
+				}
+				if ((state == CHASH_EMPTY || state == CHASH_DELETED) && free_index == t->capacity) free_index = index;
+				if (state == CHASH_EMPTY) break;
+
+				index = (index + step) & mask;
+			}
+
+			// New key, claim the first free slot (writers of other stripes may take it first, then try the next ones)
+			index = free_index;
+			for (size_t i = 0; !done && free_index < t->capacity && i < t->capacity; i++) {
+
+				chash_slot* slot = chash_util_slot(hash, t, index);
+				unsigned state = atomic_load(&slot->state);
+
+				if ((state == CHASH_EMPTY || state == CHASH_DELETED) && atomic_compare_exchange_strong(&slot->state, &state, CHASH_BUSY)) {
+
+					chash_util_write(hash, slot, key, len, h, h2, value);
+					if (state == CHASH_DELETED) atomic_fetch_sub(&t->deleted_count, 1);
+					atomic_fetch_add(&t->count, 1);
+					atomic_store_explicit(&slot->state, CHASH_FULL, memory_order_release);
+
+					grow = (double)(atomic_load(&t->count) + atomic_load(&t->deleted_count)) > hash->max_load * (double)t->capacity;
+					done = true;
+				}
+				index = (index + step) & mask;
+			}
+
+			chash_util_read_unlock(active);
+			mtx_unlock(lock);
+
+			if (old_key) chash_util_retire(hash, (void*)old_key);
+
+			// Grow after too many insertions, or right away if the table had no free slot at all
+			if (grow || !done) chash_util_resize(hash, !done);
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the element mapped by key (NUL terminated string)
+ *
+ * The key is freed once no reader can be using it anymore
+ */
+void chash_remove(chashmap* hash, const char* key) {
+
+	if (key) chash_remove_n(hash, key, strlen(key));
+	return;
+}
+
+/**
+ * Removes the element mapped by the len bytes pointed to by key
+ *
+ * The key is freed once no reader can be using it anymore
+ */
+void chash_remove_n(chashmap* hash, const void* key, size_t len) {
+
+	if (hash && key) {
+
+		size_t h, h2;
+		chash_util_compute(hash, key, len, &h, &h2);
+		mtx_t* lock = &hash->locks[h % CHASH_LOCK_STRIPES];
+		const void* old_key = NULL;
+
+		mtx_lock(lock);
+		atomic_size_t* active = chash_util_read_lock(hash);
+		chash_table* t = atomic_load(&hash->table);
+
+		size_t mask = t->capacity - 1;
+		size_t index = h & mask;
+		size_t step = (h2 | 1) & mask;
+
+		for (size_t i = 0; i < t->capacity; i++) {
+
+			chash_slot* slot = chash_util_slot(hash, t, index);
+			unsigned state = atomic_load(&slot->state);
+
+			if (state == CHASH_EMPTY) break;
+			if (state == CHASH_FULL && atomic_load_explicit(&slot->hash, memory_order_relaxed) == h && atomic_load_explicit(&slot->key_length, memory_order_relaxed) == len) {
+
+				const void* read_key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+				if (memcmp(read_key, key, len) == 0) {
+
+					// Mark the slot as deleted (tombstone) inside a write section, so that readers notice
+					unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+					atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+					atomic_thread_fence(memory_order_release);
+					atomic_store_explicit(&slot->state, CHASH_DELETED, memory_order_relaxed);
+					atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+
+					atomic_fetch_sub(&t->count, 1);
+					atomic_fetch_add(&t->deleted_count, 1);
+					old_key = read_key;
+					break;
+				}
+			}
+			index = (index + step) & mask;
+		}
+
+		chash_util_read_unlock(active);
+		mtx_unlock(lock);
+
+		if (old_key) chash_util_retire(hash, (void*)old_key);
+	}
+	return;
+}
+
+/**
+ * Copies the value mapped by key (NUL terminated string) into buf
+ *
+ * Since another thread could change the value at any time, values are
+ * always copied out and never returned by pointer
+ * Returns whether or not the key was found
+ */
+bool chash_get(chashmap* hash, const char* key, void* buf) {
+
+	return key ? chash_get_n(hash, key, strlen(key), buf) : false;
+}
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf
+ *
+ * Since another thread could change the value at any time, values are
+ * always copied out and never returned by pointer
+ * Returns whether or not the key was found
+ */
+bool chash_get_n(chashmap* hash, const void* key, size_t len, void* buf) {
+
+	bool found = false;
+
+	if (hash && key && buf) {
+
+		size_t h, h2;
+		chash_util_compute(hash, key, len, &h, &h2);
+
+		// No lock, the epoch only keeps the table and the keys from being freed
+		atomic_size_t* active = chash_util_read_lock(hash);
+		chash_table* t = atomic_load_explicit(&hash->table, memory_order_acquire);
+
+		size_t mask = t->capacity - 1;
+		size_t index = h & mask;
+		size_t step = (h2 | 1) & mask;
+
+		for (size_t i = 0; i < t->capacity; i++) {
+
+			int res = chash_util_read(hash, chash_util_slot(hash, t, index), key, len, h, buf);
+			if (res != 0) {
+
+				found = res > 0;
+				break;
+			}
+			index = (index + step) & mask;
+		}
+
+		chash_util_read_unlock(active);
+	}
+	return found;
+}
+
+/**
+ * Removes all the values in the hashmap
+ * the struct itself is preserved
+ *
+ * The stored keys are freed once no reader can be using them anymore
+ */
+void chash_clear(chashmap* hash) {
+
+	if (hash) {
+
+		chash_util_lock_all(hash);
+
+		// Readers may still be inside the old table, so a new empty one replaces it
+		chash_table* old = atomic_load(&hash->table);
+		chash_table* t = chash_util_table_create(old->capacity, hash->slot_size);
+		if (t) atomic_store(&hash->table, t);
+
+		chash_util_unlock_all(hash);
+
+		if (t) {
+
+			chash_util_synchronize(hash);
+			chash_util_table_free_keys(hash, old);
+			free(old->slots);
+			free(old);
+		}
+	}
+	return;
+}
+
+/**
+ * Returns the capacity of the hashmap
+ */
+size_t chash_get_capacity(chashmap* hash) {
+
+	size_t capacity = 0;
+
+	if (hash) {
+
+		atomic_size_t* active = chash_util_read_lock(hash);
+		capacity = atomic_load(&hash->table)->capacity;
+		chash_util_read_unlock(active);
+	}
+	return capacity;
+}
+
+/**
+ * Returns the number of couples stored in the hashmap
+ *
+ * With concurrent writers the result is only a snapshot
+ */
+size_t chash_get_size(chashmap* hash) {
+
+	size_t size = 0;
+
+	if (hash) {
+
+		atomic_size_t* active = chash_util_read_lock(hash);
+		size = atomic_load(&atomic_load(&hash->table)->count);
+		chash_util_read_unlock(active);
+	}
+	return size;
+}
+
+/**
+ * Returns the size of the elements stored in the hash
+ */
+size_t chash_get_element_size(chashmap* hash) {
+
+	return hash ? hash->element_size : 0;
+}
+
+/* Utility function that creates an empty table with the given capacity (a power of two) */
+chash_table* chash_util_table_create(size_t capacity, size_t slot_size) {
+
+	chash_table* t = (chash_table*)malloc(sizeof(chash_table));
+	if (t) {
+
+		t->slots = (char*)malloc(capacity * slot_size);
+		if (t->slots) {
+
+			t->capacity = capacity;
+			atomic_init(&t->count, 0);
+			atomic_init(&t->deleted_count, 0);
+
+			for (size_t i = 0; i < capacity; i++) {
+
+				chash_slot* slot = (chash_slot*)(t->slots + i * slot_size);
+				memset(slot, 0, slot_size);
+				atomic_init(&slot->seq, 0);
+				atomic_init(&slot->state, CHASH_EMPTY);
+				atomic_init(&slot->key, NULL);
+				atomic_init(&slot->key_length, 0);
+				atomic_init(&slot->hash, 0);
+				atomic_init(&slot->second_hash, 0);
+			}
+		}
+		else {
+
+			free(t);
+			t = NULL;
+		}
+	}
+	return t;
+}
+
+/* Utility function that frees every key stored in the table, no one else may be using it */
+void chash_util_table_free_keys(chashmap* hash, chash_table* t) {
+
+	for (size_t i = 0; atomic_load(&t->count) > 0 && i < t->capacity; i++) {
+
+		chash_slot* slot = chash_util_slot(hash, t, i);
+		if (atomic_load(&slot->state) == CHASH_FULL) free((void*)atomic_load(&slot->key));
+	}
+	return;
+}
+
+/* Utility function that returns the header of the index -th slot of t */
+chash_slot* chash_util_slot(chashmap* hash, chash_table* t, size_t index) {
+
+	return (chash_slot*)(t->slots + index * hash->slot_size);
+}
+
+/* Utility function that computes both hashes of a key, the second one is derived from the first */
+void chash_util_compute(chashmap* hash, const void* key, size_t len, size_t* h, size_t* h2) {
+
+	*h = hash_util_default_hash(key, len, hash->seed);
+
+	uint64_t x = (uint64_t)*h;
+	x = (x ^ (x >> 31)) * 0x94D049BB133111EBULL;
+	*h2 = (size_t)(x ^ (x >> 29));
+	return;
+}
+
+/**
+ * Utility function that checks, without locking, whether slot holds key and if so copies its value into buf
+ *
+ * Returns 1 if the key was found, -1 if the slot is empty (the probe ends), 0 otherwise
+ */
+int chash_util_read(chashmap* hash, chash_slot* slot, const void* key, size_t len, size_t h, void* buf) {
+
+	int res = 0;
+	bool retry = true;
+
+	while (retry) {
+
+		retry = false;
+		unsigned seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+		// A writer is in the middle of changing the slot
+		if (seq & 1) {
+
+			retry = true;
+			continue;
+		}
+
+		unsigned state = atomic_load_explicit(&slot->state, memory_order_acquire);
+		if (state == CHASH_EMPTY) {
+
+			res = -1;
+		}
+		else if (state == CHASH_FULL && atomic_load_explicit(&slot->hash, memory_order_relaxed) == h && atomic_load_explicit(&slot->key_length, memory_order_relaxed) == len) {
+
+			const void* read_key = atomic_load_explicit(&slot->key, memory_order_relaxed);
+
+			// Key and length have to belong to the same couple before reading the key bytes
+			atomic_thread_fence(memory_order_acquire);
+			if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) {
+
+				retry = true;
+			}
+			else if (memcmp(read_key, key, len) == 0) {
+
+				memcpy(buf, (char*)slot + sizeof(chash_slot), hash->element_size);
+
+				// The copy is valid only if no writer touched the slot meanwhile
+				atomic_thread_fence(memory_order_acquire);
+				if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) retry = true;
+				else res = 1;
+			}
+		}
+	}
+	return res;
+}
+
+/* Utility function that stores a couple in a slot owned by the calling writer, inside a write section */
+void chash_util_write(chashmap* hash, chash_slot* slot, const void* key, size_t len, size_t h, size_t h2, void* value) {
+
+	unsigned seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+	atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	atomic_store_explicit(&slot->key, key, memory_order_relaxed);
+	atomic_store_explicit(&slot->key_length, len, memory_order_relaxed);
+	atomic_store_explicit(&slot->hash, h, memory_order_relaxed);
+	atomic_store_explicit(&slot->second_hash, h2, memory_order_relaxed);
+	memcpy((char*)slot + sizeof(chash_slot), value, hash->element_size);
+
+	atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+	return;
+}
+
+/**
+ * Utility function that announces a reader in the current epoch
+ *
+ * Until the returned counter is released, the tables and keys
+ * visible to the caller won't be freed
+ */
+atomic_size_t* chash_util_read_lock(chashmap* hash) {
+
+	size_t index = chash_util_thread_index() % CHASH_READER_STRIPES;
+	atomic_size_t* active = NULL;
+
+	for (;;) {
+
+		size_t epoch = atomic_load(&hash->epoch);
+		active = &hash->readers[epoch & 1][index].active;
+		atomic_fetch_add(active, 1);
+
+		// If the epoch moved on meanwhile, a writer may have already checked this counter
+		if (atomic_load(&hash->epoch) == epoch) break;
+		atomic_fetch_sub(active, 1);
+	}
+	return active;
+}
+
+/* Utility function that releases the counter taken by chash_util_read_lock */
+void chash_util_read_unlock(atomic_size_t* active) {
+
+	atomic_fetch_sub_explicit(active, 1, memory_order_release);
+	return;
+}
+
+/* Utility function that waits until every reader that could see something already unlinked has left */
+void chash_util_synchronize(chashmap* hash) {
+
+	mtx_lock(&hash->sync_lock);
+
+	// New readers go to the other parity, so the old one can only drain
+	size_t parity = atomic_fetch_add(&hash->epoch, 1) & 1;
+	for (size_t i = 0; i < CHASH_READER_STRIPES; i++) {
+
+		while (atomic_load(&hash->readers[parity][i].active) != 0) thrd_yield();
+	}
+
+	mtx_unlock(&hash->sync_lock);
+	return;
+}
+
+/* Utility function that frees ptr once no reader can be using it, batching the waits */
+void chash_util_retire(chashmap* hash, void* ptr) {
+
+	void** batch = NULL;
+	size_t batch_count = 0;
+
+	mtx_lock(&hash->retire_lock);
+
+	if (hash->retired_count == hash->retired_capacity) {
+
+		size_t capacity = hash->retired_capacity ? hash->retired_capacity * 2 : CHASH_RETIRE_BATCH;
+		void** retired = (void**)realloc(hash->retired, capacity * sizeof(void*));
+		if (retired) {
+
+			hash->retired = retired;
+			hash->retired_capacity = capacity;
+		}
+	}
+
+	if (hash->retired_count < hash->retired_capacity) {
+
+		hash->retired[hash->retired_count++] = ptr;
+		ptr = NULL;
+	}
+
+	// Enough garbage, take it all and free it outside of the lock
+	if (hash->retired_count >= CHASH_RETIRE_BATCH) {
+
+		batch = hash->retired;
+		batch_count = hash->retired_count;
+		hash->retired = NULL;
+		hash->retired_count = 0;
+		hash->retired_capacity = 0;
+	}
+
+	mtx_unlock(&hash->retire_lock);
+
+	// Couldn't be queued (out of memory), wait for the readers right away
+	if (ptr || batch) chash_util_synchronize(hash);
+
+	free(ptr);
+	for (size_t i = 0; i < batch_count; i++) free(batch[i]);
+	free(batch);
+	return;
+}
+
+/* Utility function that locks every stripe, in order */
+void chash_util_lock_all(chashmap* hash) {
+
+	for (size_t i = 0; i < CHASH_LOCK_STRIPES; i++) mtx_lock(&hash->locks[i]);
+	return;
+}
+
+/* Utility function that unlocks every stripe */
+void chash_util_unlock_all(chashmap* hash) {
+
+	for (size_t i = CHASH_LOCK_STRIPES; i > 0; i--) mtx_unlock(&hash->locks[i - 1]);
+	return;
+}
+
+/**
+ * Utility function that replaces the table with a new one holding the same couples
+ *
+ * The table doubles if the live couples need it, otherwise only the tombstones are dropped
+ * Unless force is set, nothing happens if another writer already did it
+ */
+void chash_util_resize(chashmap* hash, bool force) {
+
+	chash_util_lock_all(hash);
+
+	chash_table* old = atomic_load(&hash->table);
+	size_t count = atomic_load(&old->count);
+	size_t used = count + atomic_load(&old->deleted_count);
+	chash_table* t = NULL;
+
+	if (force || (double)used > hash->max_load * (double)old->capacity) {
+
+		size_t capacity = old->capacity;
+		if ((double)count > hash->max_load * (double)capacity / 2 && capacity <= SIZE_MAX / 2 / hash->slot_size) capacity *= 2;
+
+		t = chash_util_table_create(capacity, hash->slot_size);
+		if (t) {
+
+			// Every writer is locked out, the couples can be moved without seqlocks
+			size_t mask = capacity - 1;
+			for (size_t i = 0; i < old->capacity; i++) {
+
+				chash_slot* from = chash_util_slot(hash, old, i);
+				if (atomic_load_explicit(&from->state, memory_order_relaxed) != CHASH_FULL) continue;
+
+				size_t h = atomic_load_explicit(&from->hash, memory_order_relaxed);
+				size_t h2 = atomic_load_explicit(&from->second_hash, memory_order_relaxed);
+				size_t index = h & mask;
+				size_t step = (h2 | 1) & mask;
+
+				while (atomic_load_explicit(&chash_util_slot(hash, t, index)->state, memory_order_relaxed) != CHASH_EMPTY) index = (index + step) & mask;
+
+				chash_slot* to = chash_util_slot(hash, t, index);
+				chash_util_write(hash, to, atomic_load_explicit(&from->key, memory_order_relaxed), atomic_load_explicit(&from->key_length, memory_order_relaxed), h, h2, (char*)from + sizeof(chash_slot));
+				atomic_store_explicit(&to->state, CHASH_FULL, memory_order_relaxed);
+			}
+			atomic_init(&t->count, count);
+
+			// Publish the new table, readers that already loaded the old one keep using it
+			atomic_store_explicit(&hash->table, t, memory_order_release);
+		}
+	}
+
+	chash_util_unlock_all(hash);
+
+	// The keys now belong to the new table, only the old slots are freed
+	if (t) {
+
+		chash_util_synchronize(hash);
+		free(old->slots);
+		free(old);
+	}
+	return;
+}
+
+/* Utility function that rounds the capacity up to a power of two (0 if it's not possible) */
+size_t chash_util_round_capacity(size_t capacity) {
+
+	size_t rounded = 1;
+	while (rounded < capacity && rounded <= SIZE_MAX / 2) rounded *= 2;
+
+	return rounded >= capacity ? rounded : 0;
+}
+
+/* Utility function that returns the index of the calling thread, assigned on first use */
+size_t chash_util_thread_index(void) {
+
+	if (chash_thread_index == 0) chash_thread_index = atomic_fetch_add(&chash_thread_counter, 1) + 1;
+
+	return chash_thread_index;
+}
\ No newline at end of file
@@ -0,0 +1,1940 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef GRAPH_WITH_CSR
+
+#include "../../include/non-linear/graph.h"
+#include "../../include/non-linear/hashmap.h"
+#include "../../include/linear/vector.h"
+#include "../../include/linear/heap.h"
+#include "../../include/linear/unionfind.h"
+#include "../../include/linear/snapshot.h"
+#include "../../include/linear/parallel.h"
+#include <stdatomic.h>
+#include <threads.h>
+#include <string.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Initial capacity of the vectors holding the nodes and the arches */
+#define GRAPH_CSR_MIN_CAPACITY 16
+
+/**
+ * Arch as it's inserted, before the compressed rows are built
+ */
+typedef struct csr_arch {
+
+	uint32_t from;
+	uint32_t to;
+	int weight;
+} csr_arch;
+
+/**
+ * Entry of a row while the rows are built in parallel, entries with the same target
+ * are ordered by the position of their arch among the inserted ones
+ */
+typedef struct csr_entry {
+
+	uint32_t target;
+	int weight;
+	size_t index;
+} csr_entry;
+
+/* Number of arches and of rows each thread of a parallel build takes at a time */
+#define GRAPH_BUILD_GRAIN 4096
+#define GRAPH_BUILD_ROW_GRAIN 256
+
+/**
+ * State shared by the threads of a parallel build
+ */
+typedef struct graph_build_task {
+
+	const csr_arch* arches;
+	bool oriented;
+
+	/* Next free entry of each row while scattering (the number of entries of each row before that) */
+	atomic_size_t* cursors;
+
+	/* Entries of every row, and where each row starts */
+	csr_entry* entries;
+	size_t* starts;
+
+	/* Entries left in each row once the duplicates are dropped, and the final rows */
+	size_t* kept;
+	size_t* offsets;
+	uint32_t* targets;
+	int* weights;
+} graph_build_task;
+
+/* Parameters of the direction optimizing BFS (Beamer et al.): the traversal goes bottom-up when
+ * the arches of the frontier are more than 1 / ALPHA of the ones left to explore, and goes back
+ * top-down when the frontier has less than 1 / BETA of the nodes
+ */
+#define GRAPH_BFS_ALPHA 14
+#define GRAPH_BFS_BETA 24
+
+/* Number of frontier nodes a thread takes at a time going top-down, and discovered nodes it collects before publishing them */
+#define GRAPH_BFS_CHUNK 64
+#define GRAPH_BFS_BATCH 256
+
+/**
+ * Barrier used by the threads of the parallel BFS to wait for each other at the end of every phase
+ */
+typedef struct graph_barrier {
+
+	mtx_t lock;
+	cnd_t cond;
+
+	/* Number of threads that take part, of threads waiting and of phases completed */
+	size_t count;
+	size_t waiting;
+	size_t generation;
+} graph_barrier;
+
+/**
+ * State shared by the threads of a parallel BFS
+ */
+typedef struct graph_bfs {
+
+	graph* g;
+
+	/* Arches entering each node, they're the rows themselves when the graph isn't oriented */
+	const size_t* in_offsets;
+	const uint32_t* in_sources;
+
+	/* Number of nodes and of 64 bit words of the bitmaps */
+	size_t n;
+	size_t words;
+
+	/* Level at which each node was reached, GRAPH_NO_NODE if it wasn't */
+	uint32_t* distances;
+
+	/* Nodes already reached, set atomically since threads could reach the same node together */
+	_Atomic uint64_t* visited;
+
+	/* Frontier and next frontier as queues of ids (top-down) or as bitmaps (bottom-up) */
+	uint32_t* frontier;
+	uint32_t* next;
+	uint64_t* frontier_bits;
+	uint64_t* next_bits;
+	size_t frontier_count;
+	atomic_size_t next_count;
+
+	/* Sum of the degrees of the nodes of the next frontier */
+	atomic_size_t next_arches;
+
+	/* Position of the next chunk of the frontier to take going top-down */
+	atomic_size_t cursor;
+
+	uint32_t level;
+	bool bottom_up;
+	bool done;
+
+	size_t threads;
+	graph_barrier barrier;
+} graph_bfs;
+
+/**
+ * Argument of each thread of a parallel BFS
+ */
+typedef struct graph_bfs_worker {
+
+	graph_bfs* bfs;
+	size_t index;
+} graph_bfs_worker;
+
+/* Utility function used to (re)build the compressed rows from the inserted arches */
+void graph_util_build(graph* g);
+
+/* Utility functions used as the bodies of the parallel build, for the arches (or rows) from 'from' to 'to' */
+void graph_util_build_count(void* context, size_t from, size_t to);
+void graph_util_build_scatter(void* context, size_t from, size_t to);
+void graph_util_build_sort(void* context, size_t from, size_t to);
+void graph_util_build_copy(void* context, size_t from, size_t to);
+
+/* Utility function used to sort the entries of a row, by target and then by position of their arch */
+int graph_util_compare_entries(const void* a, const void* b);
+
+/* Utility function used to forget the inserted arches that touch removed nodes */
+size_t graph_util_drop_removed(graph* g);
+
+/* Utility function used to free the compressed rows */
+void graph_util_free_rows(graph* g);
+
+/* Utility function used to build the rows of the arches entering each node (for oriented graphs) */
+bool graph_util_build_incoming(graph* g);
+
+/* Utility function used to find the position of an arch in the compressed rows */
+size_t graph_util_find(graph* g, uint32_t from, uint32_t to);
+
+/* Utility functions used to visit the nodes reachable from one node */
+void graph_util_BFS(graph* g, uint32_t source, bool* visited, uint32_t* frontier, void (*callback)(void*));
+void graph_util_DFS(graph* g, uint32_t source, bool* visited, uint32_t* nodes, size_t* cursors, void (*callback)(void*));
+
+/* Utility functions used by the parallel BFS */
+void graph_util_barrier_wait(graph_barrier* barrier);
+int graph_util_bfs_thread(void* arg);
+void graph_util_bfs_step(graph_bfs* bfs, size_t index);
+void graph_util_bfs_top_down(graph_bfs* bfs);
+void graph_util_bfs_bottom_up(graph_bfs* bfs, size_t index);
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t graph_util_ctz64(uint64_t word);
+
+/* Utility function that returns the weight of the arch at the given position of the rows (1 if the graph isn't weighted) */
+int64_t graph_util_weight(graph* g, size_t position);
+
+/* Utility function used to sort the arches by weight */
+int graph_util_compare_arches(const void* a, const void* b);
+
+/**
+ * Descriptor of the snapshot of a graph, with the positions of its sections
+ */
+typedef struct graph_snapshot {
+
+	uint64_t element_size;
+	uint64_t flags;
+	uint64_t node_count;
+	uint64_t row_count;
+
+	/* Compressed rows (row_count + 1 offsets, and as many targets and weights as the last offset) */
+	uint64_t offsets;
+	uint64_t targets;
+	uint64_t weights;
+
+	/* Position of the value of each node (SNAPSHOT_EMPTY for removed nodes), and table from values to ids */
+	uint64_t values;
+	uint64_t ids;
+} graph_snapshot;
+
+/**
+ * Struct that represent a graph that can store
+ * nodes of  ageneric data type
+ */
+typedef struct graph {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Maps the bytes of a value to the id of its node, the keys (copies of the values) are owned by the hashmap */
+	hashmap* ids;
+
+	/* Value of each node (the key stored in ids) indexed by id, NULL for removed nodes */
+	vector* values;
+
+	/* Number of nodes not removed */
+	size_t node_count;
+
+	/* Arches inserted so far (csr_arch), the compressed rows are built from these */
+	vector* arches;
+
+	/* Compressed rows, the neighbours of node i are targets[offsets[i]] .. targets[offsets[i + 1] - 1] sorted by id */
+	size_t* offsets;
+	uint32_t* targets;
+	int* weights;
+
+	/* Rows of the arches entering each node, built only when a parallel BFS needs them on an oriented graph */
+	size_t* in_offsets;
+	uint32_t* in_sources;
+
+	/* Number of nodes the rows were built for */
+	size_t row_count;
+
+	/* Whether or not the rows are out of date with respect to the nodes and arches */
+	bool dirty;
+
+	/* Size of the elements stored in the list */
+	size_t element_size;
+
+	/* Flags for weighted and oriented graphs */
+	int flags;
+
+	/* Snapshot the rows are read from (see graph_open_mmap), with the table that replaces ids and the positions
+	 * of the values that replace values, NULL if the graph is in memory. Mapped graphs are read-only,
+	 * so every function that would modify them leaves them unchanged
+	 */
+	snapshot* mapping;
+	snapshot_table image;
+	const uint64_t* value_positions;
+
+} graph;
+
+/**
+ * Creates a graph that will store elements that are as big as the  given size
+ */
+graph* graph_create(size_t element_size, int flags) {
+
+	graph* g = NULL;
+
+	if (0 < element_size && element_size <= SIZE_MAX) {
+
+		g = (graph*)malloc(sizeof(graph));
+		if (g) {
+
+			g->ids = hash_create(GRAPH_CSR_MIN_CAPACITY, sizeof(uint32_t));
+			g->values = vec_create(GRAPH_CSR_MIN_CAPACITY, sizeof(void*));
+			g->arches = vec_create(GRAPH_CSR_MIN_CAPACITY, sizeof(csr_arch));
+
+			if (g->ids && g->values && g->arches) {
+
+				g->node_count = 0;
+				g->offsets = NULL;
+				g->targets = NULL;
+				g->weights = NULL;
+				g->in_offsets = NULL;
+				g->in_sources = NULL;
+				g->row_count = 0;
+				g->dirty = true;
+				g->element_size = element_size;
+				g->flags = flags;
+				g->mapping = NULL;
+				g->value_positions = NULL;
+			}
+			else {
+
+				hash_delete(&g->ids);
+				vec_delete(&g->values);
+				vec_delete(&g->arches);
+				free(g);
+				g = NULL;
+			}
+		}
+	}
+	return g;
+}
+
+/**
+ * Deletes the given graph
+ */
+void graph_delete(graph** g) {
+
+	if (g && *g) {
+
+		hash_delete(&(*g)->ids);
+		vec_delete(&(*g)->values);
+		vec_delete(&(*g)->arches);
+		graph_util_free_rows(*g);
+		snapshot_util_close(&(*g)->mapping);
+		memset(*g, 0, sizeof(graph));
+		free(*g);
+		*g = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a node in the graph that will hold the value x
+ */
+void graph_insert_node(graph* g, void* x) {
+
+	graph_insert_node_id(g, x);
+	return;
+}
+
+/**
+ * Connects the two given nodes with the given weight (= inserts an arch)
+ */
+void graph_insert_arch(graph* g, void* first, void* second, int weight) {
+
+	if (g && first && second && weight > 0) {
+
+		uint32_t from = graph_get_node_id(g, first);
+		uint32_t to = graph_get_node_id(g, second);
+
+		if (from != GRAPH_NO_NODE && to != GRAPH_NO_NODE) graph_insert_arches(g, &from, &to, &weight, 1);
+	}
+	return;
+}
+
+/**
+ * Removes the node that holds x from the graph
+ */
+void graph_remove_node(graph* g, void* x) {
+
+	if (g && x && !g->mapping) {
+
+		uint32_t id = graph_get_node_id(g, x);
+		if (id != GRAPH_NO_NODE) {
+
+			// The id isn't reused, its arches are dropped when the rows are built again
+			void* removed = NULL;
+			vec_insert_at(g->values, &removed, id);
+			hash_remove_n(g->ids, x, g->element_size);
+			g->node_count--;
+			g->dirty = true;
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the arch that connects the two nodes
+ */
+void graph_remove_arch(graph* g, void* first, void* second) {
+
+	if (g && first && second && !g->mapping) {
+
+		uint32_t from = graph_get_node_id(g, first);
+		uint32_t to = graph_get_node_id(g, second);
+
+		if (from != GRAPH_NO_NODE && to != GRAPH_NO_NODE) {
+
+			// Every copy of the arch is removed, keeping the order of the others
+			csr_arch* arches = (csr_arch*)vec_get_at(g->arches, 0);
+			size_t length = vec_get_length(g->arches);
+			size_t kept = 0;
+
+			for (size_t i = 0; i < length; i++) {
+
+				bool same = arches[i].from == from && arches[i].to == to;
+				bool reversed = !(g->flags & IS_ORIENTED) && arches[i].from == to && arches[i].to == from;
+
+				if (!same && !reversed) arches[kept++] = arches[i];
+			}
+			if (kept < length) {
+
+				vec_resize(g->arches, kept);
+				g->dirty = true;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Searches for the value x in the graph and returns a pointer to it (if present)
+ */
+void* graph_search_node(graph* g, void* x) {
+
+	uint32_t id = graph_get_node_id(g, x);
+	return id != GRAPH_NO_NODE ? graph_get_node_value(g, id) : NULL;
+}
+
+/**
+ * Searches for an arch between first and second
+ *
+ * A pointer to the weight of the arch is returned (NULL if there's no such arch)
+ */
+void* graph_search_arch(graph* g, void* first, void* second) {
+
+	void* val = NULL;
+
+	if (g && first && second) {
+
+		uint32_t from = graph_get_node_id(g, first);
+		uint32_t to = graph_get_node_id(g, second);
+
+		if (from != GRAPH_NO_NODE && to != GRAPH_NO_NODE) {
+
+			graph_util_build(g);
+
+			size_t pos = graph_util_find(g, from, to);
+			if (pos != SIZE_MAX) val = &g->weights[pos];
+		}
+	}
+	return val;
+}
+
+/**
+ * Traverses the graph breadth-first and applies the callback function to each element
+ *
+ * Every node is visited, a new traversal starts from the smallest id not visited yet
+ */
+void graph_BFS(graph* g, void (*callback)(void*)) {
+
+	if (g && callback) {
+
+		graph_util_build(g);
+
+		bool* visited = (bool*)calloc(g->row_count + 1, sizeof(bool));
+		uint32_t* frontier = (uint32_t*)malloc((g->row_count + 1) * sizeof(uint32_t));
+
+		if (visited && frontier) {
+
+			for (uint32_t i = 0; i < g->row_count; i++) {
+
+				if (!visited[i] && graph_get_node_value(g, i)) graph_util_BFS(g, i, visited, frontier, callback);
+			}
+		}
+		free(visited);
+		free(frontier);
+	}
+	return;
+}
+
+/**
+ * Traverses the graph depths-first and applies the callback function to each element
+ *
+ * Every node is visited, a new traversal starts from the smallest id not visited yet
+ */
+void graph_DFS(graph* g, void (*callback)(void*)) {
+
+	if (g && callback) {
+
+		graph_util_build(g);
+
+		bool* visited = (bool*)calloc(g->row_count + 1, sizeof(bool));
+		uint32_t* nodes = (uint32_t*)malloc((g->row_count + 1) * sizeof(uint32_t));
+		size_t* cursors = (size_t*)malloc((g->row_count + 1) * sizeof(size_t));
+
+		if (visited && nodes && cursors) {
+
+			for (uint32_t i = 0; i < g->row_count; i++) {
+
+				if (!visited[i] && graph_get_node_value(g, i)) graph_util_DFS(g, i, visited, nodes, cursors, callback);
+			}
+		}
+		free(visited);
+		free(nodes);
+		free(cursors);
+	}
+	return;
+}
+
+/**
+ * Removes all nodes (all the arches aswell)
+ */
+void graph_clear_nodes(graph* g) {
+
+	if (g && !g->mapping) {
+
+		hash_clear(g->ids);
+		vec_clear(g->values);
+		vec_clear(g->arches);
+		graph_util_free_rows(g);
+		g->node_count = 0;
+		g->dirty = true;
+	}
+	return;
+}
+
+/**
+ * Removes all the arches
+ */
+void graph_clear_arches(graph* g) {
+
+	if (g && !g->mapping) {
+
+		vec_clear(g->arches);
+		g->dirty = true;
+	}
+	return;
+}
+
+/**
+ * Inserts a node in the graph that will hold the value x, and returns its id
+ *
+ * Ids are given in insertion order starting from 0, if the value is already
+ * in the graph the id of its node is returned (GRAPH_NO_NODE if it couldn't be inserted)
+ */
+uint32_t graph_insert_node_id(graph* g, void* x) {
+
+	uint32_t id = GRAPH_NO_NODE;
+
+	if (g && x && !g->mapping) {
+
+		id = graph_get_node_id(g, x);
+
+		// New value, the hashmap owns the copy, which is the value of the node aswell
+		if (id == GRAPH_NO_NODE && vec_get_length(g->values) < GRAPH_NO_NODE) {
+
+			void* value = malloc(g->element_size);
+			if (value) {
+
+				memcpy(value, x, g->element_size);
+
+				uint32_t new_id = (uint32_t)vec_get_length(g->values);
+				vec_push_back(g->values, &value);
+
+				if (vec_get_length(g->values) > new_id) {
+
+					hash_put_n(g->ids, value, g->element_size, &new_id);
+					g->node_count++;
+					g->dirty = true;
+					id = new_id;
+				}
+				else free(value);
+			}
+		}
+	}
+	return id;
+}
+
+/**
+ * Returns the id of the node that holds x, GRAPH_NO_NODE if there's none
+ */
+uint32_t graph_get_node_id(graph* g, void* x) {
+
+	uint32_t id = GRAPH_NO_NODE;
+
+	// Mapped graphs look the value up in the table of the snapshot
+	if (g && x && g->mapping) {
+
+		const uint32_t* found = (const uint32_t*)snapshot_util_find(&g->image, x, g->element_size, hash_util_wyhash(x, g->element_size, g->image.seed));
+		if (found) id = *found;
+	}
+	else if (g && x) {
+
+		uint32_t* found = (uint32_t*)hash_get_n(g->ids, x, g->element_size);
+		if (found) id = *found;
+	}
+	return id;
+}
+
+/**
+ * Returns a pointer to the value of the node with the given id, NULL if there's no such node
+ */
+void* graph_get_node_value(graph* g, uint32_t id) {
+
+	void* val = NULL;
+
+	if (g && g->mapping) {
+
+		if (id < g->row_count && g->value_positions[id] != SNAPSHOT_EMPTY) val = (void*)snapshot_util_at(g->mapping, g->value_positions[id], g->element_size);
+	}
+	else if (g && id < vec_get_length(g->values)) val = *(void**)vec_get_at(g->values, id);
+	return val;
+}
+
+/**
+ * Returns the number of nodes in the graph
+ */
+size_t graph_get_node_count(graph* g) {
+
+	return g ? g->node_count : 0;
+}
+
+/**
+ * Inserts n arches at once, the i-th one goes from the node with id from[i]
+ * to the node with id to[i] and weights weights[i] (every weight is 1 if weights is NULL)
+ *
+ * Arches are only collected, the compressed rows are built (in linear time)
+ * when they're needed, so inserting a whole batch before traversing is the way to go
+ *
+ * Arches between ids that don't exist, or with weights that aren't positive, are skipped,
+ * inserting an arch that's already in the graph has no effect
+ */
+void graph_insert_arches(graph* g, const uint32_t* from, const uint32_t* to, const int* weights, size_t n) {
+
+	if (g && from && to && !g->mapping) {
+
+		size_t node_ids = vec_get_length(g->values);
+
+		for (size_t i = 0; i < n; i++) {
+
+			csr_arch a = { from[i], to[i], weights ? weights[i] : 1 };
+
+			if (a.from < node_ids && a.to < node_ids && a.weight > 0) {
+
+				vec_push_back(g->arches, &a);
+				g->dirty = true;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Builds the compressed rows, if they're out of date
+ *
+ * It's done automatically by any function that reads the arches, calling it
+ * after the last insertion avoids paying for it during the first read
+ */
+void graph_build(graph* g) {
+
+	if (g) graph_util_build(g);
+	return;
+}
+
+/**
+ * Builds the compressed rows, if they're out of date, using (at most) the given number of threads
+ *
+ * The arches are counted and scattered into their rows by all the threads at the same time,
+ * then each thread sorts a range of rows and drops its duplicates, the rows are the same
+ * graph_build would produce (only the first inserted copy of an arch is kept)
+ */
+void graph_build_parallel(graph* g, size_t threads) {
+
+	if (g && g->dirty && !g->mapping) {
+
+		size_t n = vec_get_length(g->values);
+		size_t length = graph_util_drop_removed(g);
+
+		graph_build_task task;
+		task.arches = (const csr_arch*)vec_get_at(g->arches, 0);
+		task.oriented = g->flags & IS_ORIENTED;
+		task.cursors = (atomic_size_t*)malloc((n + 1) * sizeof(atomic_size_t));
+		task.starts = (size_t*)malloc((n + 1) * sizeof(size_t));
+		task.kept = (size_t*)malloc((n + 1) * sizeof(size_t));
+		task.offsets = (size_t*)malloc((n + 2) * sizeof(size_t));
+		task.entries = NULL;
+		task.targets = NULL;
+		task.weights = NULL;
+
+		if (task.cursors && task.starts && task.kept && task.offsets) {
+
+			// Number of entries of each row
+			for (size_t i = 0; i < n; i++) atomic_init(&task.cursors[i], 0);
+			parallel_util_for(length, GRAPH_BUILD_GRAIN, threads, graph_util_build_count, &task);
+
+			size_t entries = 0;
+			for (size_t i = 0; i < n; i++) {
+
+				task.starts[i] = entries;
+				entries += atomic_load_explicit(&task.cursors[i], memory_order_relaxed);
+				atomic_store_explicit(&task.cursors[i], task.starts[i], memory_order_relaxed);
+			}
+			task.starts[n] = entries;
+			task.entries = (csr_entry*)malloc((entries + 1) * sizeof(csr_entry));
+		}
+		if (task.entries) {
+
+			// Entries land in their row in any order, sorting the rows puts them in a fixed one
+			parallel_util_for(length, GRAPH_BUILD_GRAIN, threads, graph_util_build_scatter, &task);
+			parallel_util_for(n, GRAPH_BUILD_ROW_GRAIN, threads, graph_util_build_sort, &task);
+
+			task.offsets[0] = 0;
+			for (size_t i = 0; i < n; i++) task.offsets[i + 1] = task.offsets[i] + task.kept[i];
+
+			task.targets = (uint32_t*)malloc((task.offsets[n] + 1) * sizeof(uint32_t));
+			task.weights = (int*)malloc((task.offsets[n] + 1) * sizeof(int));
+		}
+		if (task.targets && task.weights) {
+
+			parallel_util_for(n, GRAPH_BUILD_ROW_GRAIN, threads, graph_util_build_copy, &task);
+
+			graph_util_free_rows(g);
+			g->offsets = task.offsets;
+			g->targets = task.targets;
+			g->weights = task.weights;
+			g->row_count = n;
+			g->dirty = false;
+
+			task.offsets = NULL;
+			task.targets = NULL;
+			task.weights = NULL;
+		}
+
+		free(task.cursors);
+		free(task.starts);
+		free(task.kept);
+		free(task.offsets);
+		free(task.entries);
+		free(task.targets);
+		free(task.weights);
+
+		// Without memory for the parallel build the rows are built by the sequential one
+		graph_util_build(g);
+	}
+	return;
+}
+
+/**
+ * Returns the ids of the nodes adjacent to the node with the given id, sorted,
+ * their number is stored in degree and the weights of the arches
+ * (in the same order) in weights, if it's not NULL
+ *
+ * The arrays belong to the graph and are valid until it's modified
+ */
+const uint32_t* graph_get_adjacency(graph* g, uint32_t id, const int** weights, size_t* degree) {
+
+	const uint32_t* adjacency = NULL;
+	size_t count = 0;
+
+	if (g) {
+
+		graph_util_build(g);
+
+		if (id < g->row_count && graph_get_node_value(g, id)) {
+
+			adjacency = g->targets + g->offsets[id];
+			count = g->offsets[id + 1] - g->offsets[id];
+			if (weights) *weights = g->weights + g->offsets[id];
+		}
+	}
+	if (degree) *degree = count;
+	return adjacency;
+}
+
+/**
+ * Traverses breadth-first the nodes reachable from source using the given number of threads,
+ * and returns an (allocated) array with the level of each node, indexed by id
+ * (GRAPH_NO_NODE for the nodes that weren't reached), NULL if source isn't a node
+ *
+ * Each level is expanded either top-down (the threads split the frontier and look at its arches)
+ * or bottom-up (the threads split the nodes not reached yet, and each looks for an arch coming
+ * from the frontier), whichever is expected to look at fewer arches; frontiers are bitmaps when
+ * going bottom-up and nodes are marked as reached in a bitmap shared with atomic operations
+ *
+ * The callback (if not NULL) is applied to each node reached, a level at a time, by the calling thread
+ */
+uint32_t* graph_BFS_parallel(graph* g, uint32_t source, size_t threads, void (*callback)(void*)) {
+
+	uint32_t* distances = NULL;
+
+	if (g) {
+
+		graph_util_build(g);
+
+		if (!g->dirty && source < g->row_count && graph_get_node_value(g, source) && (!(g->flags & IS_ORIENTED) || graph_util_build_incoming(g))) {
+
+			graph_bfs bfs;
+			bfs.g = g;
+			bfs.in_offsets = (g->flags & IS_ORIENTED) ? g->in_offsets : g->offsets;
+			bfs.in_sources = (g->flags & IS_ORIENTED) ? g->in_sources : g->targets;
+			bfs.n = g->row_count;
+			bfs.words = (bfs.n + 63) / 64;
+			bfs.threads = threads > 0 ? threads : 1;
+
+			distances = (uint32_t*)malloc(bfs.n * sizeof(uint32_t));
+			bfs.distances = distances;
+			bfs.visited = (_Atomic uint64_t*)malloc(bfs.words * sizeof(_Atomic uint64_t));
+			bfs.frontier = (uint32_t*)malloc(bfs.n * sizeof(uint32_t));
+			bfs.next = (uint32_t*)malloc(bfs.n * sizeof(uint32_t));
+			bfs.frontier_bits = (uint64_t*)calloc(bfs.words, sizeof(uint64_t));
+			bfs.next_bits = (uint64_t*)calloc(bfs.words, sizeof(uint64_t));
+
+			graph_bfs_worker* workers = (graph_bfs_worker*)malloc(bfs.threads * sizeof(graph_bfs_worker));
+			thrd_t* handles = (thrd_t*)malloc(bfs.threads * sizeof(thrd_t));
+
+			bool ready = distances && bfs.visited && bfs.frontier && bfs.next && bfs.frontier_bits && bfs.next_bits && workers && handles;
+			bool lock = ready && mtx_init(&bfs.barrier.lock, mtx_plain) == thrd_success;
+			bool cond = lock && cnd_init(&bfs.barrier.cond) == thrd_success;
+
+			if (cond) {
+
+				for (size_t i = 0; i < bfs.n; i++) distances[i] = GRAPH_NO_NODE;
+				for (size_t i = 0; i < bfs.words; i++) atomic_init(&bfs.visited[i], 0);
+				atomic_init(&bfs.next_count, 0);
+				atomic_init(&bfs.next_arches, 0);
+				atomic_init(&bfs.cursor, 0);
+
+				// Level 0 is the source alone
+				distances[source] = 0;
+				atomic_store(&bfs.visited[source / 64], (uint64_t)1 << (source % 64));
+				bfs.frontier[0] = source;
+				bfs.frontier_count = 1;
+				bfs.level = 0;
+				bfs.bottom_up = false;
+				bfs.done = false;
+				if (callback) callback(graph_get_node_value(g, source));
+
+				// Arches of the frontier, and arches of the nodes not reached yet
+				size_t frontier_arches = g->offsets[source + 1] - g->offsets[source];
+				size_t unexplored = g->offsets[bfs.n] - frontier_arches;
+
+				// The calling thread is the first one, if some thread can't be started the others go on without it
+				bfs.barrier.count = bfs.threads;
+				bfs.barrier.waiting = 0;
+				bfs.barrier.generation = 0;
+
+				size_t started = 1;
+				workers[0].bfs = &bfs;
+				workers[0].index = 0;
+				for (size_t i = 1; i < bfs.threads; i++) {
+
+					workers[started].bfs = &bfs;
+					workers[started].index = started;
+					if (thrd_create(&handles[started], graph_util_bfs_thread, &workers[started]) == thrd_success) started++;
+				}
+				mtx_lock(&bfs.barrier.lock);
+				bfs.barrier.count = started;
+				bfs.threads = started;
+				mtx_unlock(&bfs.barrier.lock);
+
+				while (!bfs.done) {
+
+					// Bottom-up when the frontier has many arches compared to the ones left, the frontier becomes a bitmap
+					if (!bfs.bottom_up && frontier_arches > unexplored / GRAPH_BFS_ALPHA) {
+
+						memset(bfs.frontier_bits, 0, bfs.words * sizeof(uint64_t));
+						for (size_t i = 0; i < bfs.frontier_count; i++) bfs.frontier_bits[bfs.frontier[i] / 64] |= (uint64_t)1 << (bfs.frontier[i] % 64);
+						bfs.bottom_up = true;
+					}
+
+					// Top-down when the frontier is small again, the frontier becomes a queue
+					else if (bfs.bottom_up && bfs.frontier_count < bfs.n / GRAPH_BFS_BETA) {
+
+						size_t count = 0;
+						for (size_t w = 0; w < bfs.words; w++) {
+
+							for (uint64_t bits = bfs.frontier_bits[w]; bits; bits &= bits - 1) bfs.frontier[count++] = (uint32_t)(w * 64 + graph_util_ctz64(bits));
+						}
+						bfs.frontier_count = count;
+						bfs.bottom_up = false;
+					}
+
+					atomic_store(&bfs.next_count, 0);
+					atomic_store(&bfs.next_arches, 0);
+					atomic_store(&bfs.cursor, 0);
+					if (bfs.bottom_up) memset(bfs.next_bits, 0, bfs.words * sizeof(uint64_t));
+					bfs.done = bfs.frontier_count == 0;
+
+					// Every thread expands its part of the level
+					graph_util_barrier_wait(&bfs.barrier);
+					if (!bfs.done) {
+
+						graph_util_bfs_step(&bfs, 0);
+						graph_util_barrier_wait(&bfs.barrier);
+
+						// The nodes reached become the frontier
+						frontier_arches = atomic_load(&bfs.next_arches);
+						unexplored = (unexplored > frontier_arches) ? unexplored - frontier_arches : 0;
+						bfs.frontier_count = atomic_load(&bfs.next_count);
+
+						if (callback) {
+
+							if (bfs.bottom_up) {
+
+								for (size_t w = 0; w < bfs.words; w++) {
+
+									for (uint64_t bits = bfs.next_bits[w]; bits; bits &= bits - 1) callback(graph_get_node_value(g, (uint32_t)(w * 64 + graph_util_ctz64(bits))));
+								}
+							}
+							else for (size_t i = 0; i < bfs.frontier_count; i++) callback(graph_get_node_value(g, bfs.next[i]));
+						}
+
+						uint32_t* tmp = bfs.frontier;
+						bfs.frontier = bfs.next;
+						bfs.next = tmp;
+
+						uint64_t* tmp_bits = bfs.frontier_bits;
+						bfs.frontier_bits = bfs.next_bits;
+						bfs.next_bits = tmp_bits;
+
+						bfs.level++;
+					}
+				}
+
+				for (size_t i = 1; i < started; i++) thrd_join(handles[i], NULL);
+			}
+			else {
+
+				free(distances);
+				distances = NULL;
+			}
+
+			if (cond) cnd_destroy(&bfs.barrier.cond);
+			if (lock) mtx_destroy(&bfs.barrier.lock);
+			free((void*)bfs.visited);
+			free(bfs.frontier);
+			free(bfs.next);
+			free(bfs.frontier_bits);
+			free(bfs.next_bits);
+			free(workers);
+			free(handles);
+		}
+	}
+	return distances;
+}
+
+/**
+ * Computes the length of the shortest path from source to every node, and returns
+ * an (allocated) array of distances indexed by id (GRAPH_UNREACHABLE for the nodes that
+ * can't be reached), NULL if source isn't a node
+ *
+ * If predecessors isn't NULL an (allocated) array is stored in it, with the id of the node
+ * that comes before each one in its shortest path (GRAPH_NO_NODE for source and the nodes not reached)
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log V) time
+ */
+int64_t* graph_dijkstra(graph* g, uint32_t source, uint32_t** predecessors) {
+
+	int64_t* distances = NULL;
+	uint32_t* previous = NULL;
+
+	if (predecessors) *predecessors = NULL;
+
+	if (g) {
+
+		graph_util_build(g);
+
+		if (!g->dirty && source < g->row_count && graph_get_node_value(g, source)) {
+
+			size_t n = g->row_count;
+			heap* h = heap_create(n);
+
+			distances = (int64_t*)malloc(n * sizeof(int64_t));
+			previous = (uint32_t*)malloc(n * sizeof(uint32_t));
+
+			if (h && distances && previous) {
+
+				for (size_t i = 0; i < n; i++) {
+
+					distances[i] = GRAPH_UNREACHABLE;
+					previous[i] = GRAPH_NO_NODE;
+				}
+				distances[source] = 0;
+				heap_push(h, source, 0);
+
+				// Every node leaves the heap once, when its distance is final
+				while (!heap_is_empty(h)) {
+
+					uint32_t u = (uint32_t)heap_pop(h, NULL);
+
+					for (size_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+
+						uint32_t v = g->targets[k];
+						int64_t d = distances[u] + graph_util_weight(g, k);
+
+						if (d < distances[v]) {
+
+							distances[v] = d;
+							previous[v] = u;
+							heap_decrease_key(h, v, (double)d);
+						}
+					}
+				}
+			}
+			else {
+
+				free(distances);
+				distances = NULL;
+			}
+			heap_delete(&h);
+		}
+	}
+
+	if (distances && predecessors) *predecessors = previous;
+	else free(previous);
+	return distances;
+}
+
+/**
+ * Computes the length of the shortest path from source to target, and returns it
+ * (GRAPH_UNREACHABLE if there's no such path, or the ids aren't nodes)
+ *
+ * The heuristic estimates the length of the path left from (the value of) a node to (the value of) target,
+ * the path is the shortest one as long as it never overestimates it; nodes are expanded in order of the
+ * length so far plus the estimate, so fewer nodes are looked at than with graph_dijkstra (NULL estimates 0)
+ *
+ * If path isn't NULL an (allocated) array with the ids of the nodes on the path, from source to target,
+ * is stored in it and its length in length (NULL and 0 if there's no path)
+ */
+int64_t graph_astar(graph* g, uint32_t source, uint32_t target, double (*heuristic)(void* from, void* to), uint32_t** path, size_t* length) {
+
+	int64_t cost = GRAPH_UNREACHABLE;
+
+	if (path) *path = NULL;
+	if (length) *length = 0;
+
+	if (g) {
+
+		graph_util_build(g);
+
+		if (!g->dirty && source < g->row_count && target < g->row_count && graph_get_node_value(g, source) && graph_get_node_value(g, target)) {
+
+			size_t n = g->row_count;
+			void* goal = graph_get_node_value(g, target);
+			heap* h = heap_create(n);
+			int64_t* distances = (int64_t*)malloc(n * sizeof(int64_t));
+			uint32_t* previous = (uint32_t*)malloc(n * sizeof(uint32_t));
+
+			if (h && distances && previous) {
+
+				for (size_t i = 0; i < n; i++) {
+
+					distances[i] = GRAPH_UNREACHABLE;
+					previous[i] = GRAPH_NO_NODE;
+				}
+				distances[source] = 0;
+				heap_push(h, source, heuristic ? heuristic(graph_get_node_value(g, source), goal) : 0);
+
+				while (!heap_is_empty(h)) {
+
+					uint32_t u = (uint32_t)heap_pop(h, NULL);
+
+					if (u == target) {
+
+						cost = distances[target];
+						break;
+					}
+
+					// A node whose distance gets lower goes back in the heap, so estimates that aren't consistent still work
+					for (size_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+
+						uint32_t v = g->targets[k];
+						int64_t d = distances[u] + graph_util_weight(g, k);
+
+						if (d < distances[v]) {
+
+							distances[v] = d;
+							previous[v] = u;
+							heap_push(h, v, (double)d + (heuristic ? heuristic(graph_get_node_value(g, v), goal) : 0));
+						}
+					}
+				}
+
+				// Walk the path back from target
+				if (cost != GRAPH_UNREACHABLE && path) {
+
+					size_t count = 1;
+					for (uint32_t v = target; v != source; v = previous[v]) count++;
+
+					*path = (uint32_t*)malloc(count * sizeof(uint32_t));
+					if (*path) {
+
+						uint32_t v = target;
+						for (size_t i = count; i > 0; i--) {
+
+							(*path)[i - 1] = v;
+							v = previous[v];
+						}
+						if (length) *length = count;
+					}
+				}
+			}
+			heap_delete(&h);
+			free(distances);
+			free(previous);
+		}
+	}
+	return cost;
+}
+
+/**
+ * Computes a minimum spanning forest growing a tree from a node of each component, and returns
+ * its weight (-1 if the graph is oriented)
+ *
+ * If from and to aren't NULL the arches of the forest are copied in them (they
+ * must have room for graph_get_node_count(g) - 1 ids), their number is stored in count
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log V) time
+ */
+int64_t graph_prim(graph* g, uint32_t* from, uint32_t* to, size_t* count) {
+
+	int64_t total = -1;
+	size_t arches = 0;
+
+	if (g && !(g->flags & IS_ORIENTED)) {
+
+		graph_util_build(g);
+
+		if (!g->dirty) {
+
+			size_t n = g->row_count;
+			heap* h = heap_create(n);
+			uint32_t* parents = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+			bool* in_tree = (bool*)calloc(n + 1, sizeof(bool));
+
+			if (h && parents && in_tree) {
+
+				total = 0;
+				for (uint32_t root = 0; root < n; root++) {
+
+					if (in_tree[root] || !graph_get_node_value(g, root)) continue;
+
+					parents[root] = GRAPH_NO_NODE;
+					heap_push(h, root, 0);
+
+					// The node closest to the tree joins it, through the cheapest arch found so far
+					while (!heap_is_empty(h)) {
+
+						double weight;
+						uint32_t u = (uint32_t)heap_pop(h, &weight);
+
+						in_tree[u] = true;
+						if (parents[u] != GRAPH_NO_NODE) {
+
+							if (from) from[arches] = parents[u];
+							if (to) to[arches] = u;
+							total += (int64_t)weight;
+							arches++;
+						}
+
+						for (size_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+
+							uint32_t v = g->targets[k];
+
+							if (!in_tree[v] && heap_decrease_key(h, v, (double)graph_util_weight(g, k))) parents[v] = u;
+						}
+					}
+				}
+			}
+			heap_delete(&h);
+			free(parents);
+			free(in_tree);
+		}
+	}
+	if (count) *count = arches;
+	return total;
+}
+
+/**
+ * Computes a minimum spanning forest adding the arches by increasing weight, skipping the ones
+ * that would close a cycle, and returns its weight (-1 if the graph is oriented)
+ *
+ * If from and to aren't NULL the arches of the forest are copied in them (they
+ * must have room for graph_get_node_count(g) - 1 ids), their number is stored in count
+ *
+ * Arches weight 1 in graphs that aren't weighted, it takes O(E log E) time
+ */
+int64_t graph_kruskal(graph* g, uint32_t* from, uint32_t* to, size_t* count) {
+
+	int64_t total = -1;
+	size_t arches = 0;
+
+	if (g && !(g->flags & IS_ORIENTED)) {
+
+		graph_util_build(g);
+
+		if (!g->dirty) {
+
+			size_t n = g->row_count;
+			unionfind* uf = uf_create(n);
+
+			// Every arch is in both rows, only the copy going to the bigger id is taken
+			csr_arch* sorted = (csr_arch*)malloc((g->offsets[n] / 2 + 1) * sizeof(csr_arch));
+
+			if (uf && sorted) {
+
+				size_t length = 0;
+				for (uint32_t u = 0; u < n; u++) {
+
+					for (size_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+
+						if (u < g->targets[k]) {
+
+							csr_arch a = { u, g->targets[k], (int)graph_util_weight(g, k) };
+							sorted[length++] = a;
+						}
+					}
+				}
+				qsort(sorted, length, sizeof(csr_arch), graph_util_compare_arches);
+
+				total = 0;
+				for (size_t i = 0; i < length && arches + 1 < n; i++) {
+
+					if (uf_union(uf, sorted[i].from, sorted[i].to)) {
+
+						if (from) from[arches] = sorted[i].from;
+						if (to) to[arches] = sorted[i].to;
+						total += sorted[i].weight;
+						arches++;
+					}
+				}
+			}
+			uf_delete(&uf);
+			free(sorted);
+		}
+	}
+	if (count) *count = arches;
+	return total;
+}
+
+/**
+ * Writes the graph in a snapshot in the given file (which is replaced): the compressed
+ * rows as they are, the value of every node and a table mapping each value to its id
+ *
+ * The rows are built first, the snapshot can be mapped back by graph_open_mmap,
+ * true is returned if it was written entirely
+ */
+bool graph_save(graph* g, const char* path) {
+
+	bool saved = false;
+
+	if (g && path) {
+
+		graph_util_build(g);
+
+		size_t n = g->row_count;
+		size_t arches = g->offsets ? g->offsets[n] : 0;
+
+		snapshot_entry* entries = (snapshot_entry*)malloc((n + 1) * sizeof(snapshot_entry));
+		uint32_t* ids = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+		uint64_t* positions = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+		uint64_t* values = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+		snapshot_writer w;
+
+		if (!g->dirty && g->offsets && entries && ids && positions && values && snapshot_util_begin(&w, path, SNAPSHOT_GRAPH, sizeof(graph_snapshot))) {
+
+			graph_snapshot descriptor;
+			descriptor.element_size = g->element_size;
+			descriptor.flags = (uint64_t)g->flags;
+			descriptor.node_count = g->node_count;
+			descriptor.row_count = n;
+
+			descriptor.offsets = snapshot_util_section(&w);
+			snapshot_util_write(&w, g->offsets, (n + 1) * sizeof(size_t));
+			descriptor.targets = snapshot_util_section(&w);
+			snapshot_util_write(&w, g->targets, arches * sizeof(uint32_t));
+			descriptor.weights = snapshot_util_section(&w);
+			snapshot_util_write(&w, g->weights, arches * sizeof(int));
+
+			// Every node still in the graph maps its value to its id, the keys of the table are the values of the nodes
+			size_t count = 0;
+			for (uint32_t i = 0; i < n; i++) {
+
+				void* value = graph_get_node_value(g, i);
+				if (value) {
+
+					ids[count] = i;
+					entries[count].key = value;
+					entries[count].key_length = g->element_size;
+					entries[count].value = &ids[count];
+					count++;
+				}
+			}
+
+			uint64_t seed = g->mapping ? g->image.seed : hash_get_seed(g->ids);
+			descriptor.ids = snapshot_util_write_table(&w, entries, count, sizeof(uint32_t), hash_util_wyhash, seed, positions);
+
+			for (size_t i = 0; i < n; i++) values[i] = SNAPSHOT_EMPTY;
+			for (size_t i = 0; i < count; i++) values[ids[i]] = positions[i];
+
+			descriptor.values = snapshot_util_section(&w);
+			snapshot_util_write(&w, values, n * sizeof(uint64_t));
+			saved = snapshot_util_end(&w, &descriptor, sizeof(graph_snapshot));
+		}
+		free(entries);
+		free(ids);
+		free(positions);
+		free(values);
+	}
+	return saved;
+}
+
+/**
+ * Maps the snapshot written by graph_save in the given file, and returns a graph that reads its rows,
+ * values and ids in place, so that traversals and lookups run on it without building anything
+ *
+ * Nothing is copied, so opening takes the same time whatever the size of the graph, and only the pages
+ * that are read get loaded. The graph is read-only: the functions that would modify it leave it unchanged,
+ * and the values and weights it returns must not be written. Deleting it unmaps the file
+ *
+ * The header of the snapshot and the bounds of its sections are checked, the rows themselves are trusted
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of a graph of this engine
+ */
+graph* graph_open_mmap(const char* path) {
+
+	graph* g = NULL;
+	graph_snapshot d;
+	snapshot* s = snapshot_util_open(path, SNAPSHOT_GRAPH, &d, sizeof(graph_snapshot));
+
+	if (s) {
+
+		snapshot_table image;
+		const size_t* offsets = NULL;
+		const void* targets = NULL;
+		const void* weights = NULL;
+		const void* values = NULL;
+
+		// Ids are 32 bit, so the number of rows bounds the size of every other section
+		if (d.element_size > 0 && d.row_count < GRAPH_NO_NODE && d.node_count <= d.row_count && snapshot_util_open_table(s, d.ids, &image) &&
+			image.value_size == sizeof(uint32_t)) {
+
+			offsets = (const size_t*)snapshot_util_at(s, d.offsets, (d.row_count + 1) * sizeof(size_t));
+			values = snapshot_util_at(s, d.values, d.row_count * sizeof(uint64_t));
+		}
+		if (offsets && values && offsets[d.row_count] <= SIZE_MAX / sizeof(uint32_t)) {
+
+			targets = snapshot_util_at(s, d.targets, offsets[d.row_count] * sizeof(uint32_t));
+			weights = snapshot_util_at(s, d.weights, offsets[d.row_count] * sizeof(int));
+		}
+
+		g = (targets && weights) ? (graph*)malloc(sizeof(graph)) : NULL;
+		if (g) {
+
+			g->ids = NULL;
+			g->values = NULL;
+			g->node_count = (size_t)d.node_count;
+			g->arches = NULL;
+			g->offsets = (size_t*)offsets;
+			g->targets = (uint32_t*)targets;
+			g->weights = (int*)weights;
+			g->in_offsets = NULL;
+			g->in_sources = NULL;
+			g->row_count = (size_t)d.row_count;
+			g->dirty = false;
+			g->element_size = (size_t)d.element_size;
+			g->flags = (int)d.flags;
+			g->mapping = s;
+			g->image = image;
+			g->value_positions = (const uint64_t*)values;
+		}
+		else snapshot_util_close(&s);
+	}
+	return g;
+}
+
+/**
+ * Builds the rows from the inserted arches with two counting sorts, by target first and
+ * then (stably) by source, so that every row ends up sorted and duplicates are adjacent
+ *
+ * Arches touching removed nodes are dropped from the inserted ones aswell, in graphs
+ * that aren't oriented every arch is stored in both rows
+ */
+void graph_util_build(graph* g) {
+
+	if (g->dirty) {
+
+		size_t n = vec_get_length(g->values);
+		size_t length = graph_util_drop_removed(g);
+		csr_arch* arches = (csr_arch*)vec_get_at(g->arches, 0);
+		bool oriented = g->flags & IS_ORIENTED;
+
+		// Number of entries in the rows, each arch is stored twice in graphs that aren't oriented
+		size_t entries = 0;
+		for (size_t i = 0; i < length; i++) entries += (!oriented && arches[i].from != arches[i].to) ? 2 : 1;
+
+		size_t* offsets = (size_t*)calloc(n + 2, sizeof(size_t));
+		size_t* counts = (size_t*)calloc(n + 2, sizeof(size_t));
+		csr_arch* by_target = (csr_arch*)malloc((entries + 1) * sizeof(csr_arch));
+		uint32_t* targets = (uint32_t*)malloc((entries + 1) * sizeof(uint32_t));
+		int* weights = (int*)malloc((entries + 1) * sizeof(int));
+
+		if (offsets && counts && by_target && targets && weights) {
+
+			// First sort, by target
+			for (size_t i = 0; i < length; i++) {
+
+				counts[arches[i].to + 1]++;
+				if (!oriented && arches[i].from != arches[i].to) counts[arches[i].from + 1]++;
+			}
+			for (size_t i = 0; i < n; i++) counts[i + 1] += counts[i];
+
+			for (size_t i = 0; i < length; i++) {
+
+				by_target[counts[arches[i].to]++] = arches[i];
+				if (!oriented && arches[i].from != arches[i].to) {
+
+					csr_arch reversed = { arches[i].to, arches[i].from, arches[i].weight };
+					by_target[counts[reversed.to]++] = reversed;
+				}
+			}
+
+			// Second sort, by source, the order by target is kept inside each row
+			for (size_t i = 0; i < entries; i++) offsets[by_target[i].from + 1]++;
+			for (size_t i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+			memcpy(counts, offsets, (n + 1) * sizeof(size_t));
+
+			for (size_t i = 0; i < entries; i++) {
+
+				size_t pos = counts[by_target[i].from]++;
+				targets[pos] = by_target[i].to;
+				weights[pos] = by_target[i].weight;
+			}
+
+			// Drop the duplicates, the first inserted copy of an arch is kept
+			size_t write = 0;
+			for (size_t i = 0; i < n; i++) {
+
+				size_t start = offsets[i];
+				size_t end = offsets[i + 1];
+				offsets[i] = write;
+
+				for (size_t j = start; j < end; j++) {
+
+					if (j == start || targets[j] != targets[j - 1]) {
+
+						targets[write] = targets[j];
+						weights[write] = weights[j];
+						write++;
+					}
+				}
+			}
+			offsets[n] = write;
+
+			graph_util_free_rows(g);
+			g->offsets = offsets;
+			g->targets = targets;
+			g->weights = weights;
+			g->row_count = n;
+			g->dirty = false;
+
+			offsets = NULL;
+			targets = NULL;
+			weights = NULL;
+		}
+
+		free(offsets);
+		free(counts);
+		free(by_target);
+		free(targets);
+		free(weights);
+	}
+	return;
+}
+
+/**
+ * Forgets the inserted arches that touch removed nodes, and returns the number of arches left
+ */
+size_t graph_util_drop_removed(graph* g) {
+
+	size_t length = vec_get_length(g->arches);
+	csr_arch* arches = (csr_arch*)vec_get_at(g->arches, 0);
+	size_t kept = 0;
+
+	for (size_t i = 0; i < length; i++) {
+
+		if (graph_get_node_value(g, arches[i].from) && graph_get_node_value(g, arches[i].to)) arches[kept++] = arches[i];
+	}
+	if (kept < length) vec_resize(g->arches, kept);
+	return kept;
+}
+
+/**
+ * Body of the parallel build that counts the entries of each row, each arch is counted
+ * in both rows in graphs that aren't oriented
+ */
+void graph_util_build_count(void* context, size_t from, size_t to) {
+
+	graph_build_task* task = (graph_build_task*)context;
+
+	for (size_t i = from; i < to; i++) {
+
+		const csr_arch* a = &task->arches[i];
+		atomic_fetch_add_explicit(&task->cursors[a->from], 1, memory_order_relaxed);
+		if (!task->oriented && a->from != a->to) atomic_fetch_add_explicit(&task->cursors[a->to], 1, memory_order_relaxed);
+	}
+	return;
+}
+
+/**
+ * Body of the parallel build that moves each arch in its row (both rows in graphs that aren't oriented)
+ */
+void graph_util_build_scatter(void* context, size_t from, size_t to) {
+
+	graph_build_task* task = (graph_build_task*)context;
+
+	for (size_t i = from; i < to; i++) {
+
+		const csr_arch* a = &task->arches[i];
+
+		size_t pos = atomic_fetch_add_explicit(&task->cursors[a->from], 1, memory_order_relaxed);
+		task->entries[pos].target = a->to;
+		task->entries[pos].weight = a->weight;
+		task->entries[pos].index = i;
+
+		if (!task->oriented && a->from != a->to) {
+
+			pos = atomic_fetch_add_explicit(&task->cursors[a->to], 1, memory_order_relaxed);
+			task->entries[pos].target = a->from;
+			task->entries[pos].weight = a->weight;
+			task->entries[pos].index = i;
+		}
+	}
+	return;
+}
+
+/**
+ * Body of the parallel build that sorts each row and drops its duplicates (the first inserted copy stays)
+ */
+void graph_util_build_sort(void* context, size_t from, size_t to) {
+
+	graph_build_task* task = (graph_build_task*)context;
+
+	for (size_t i = from; i < to; i++) {
+
+		csr_entry* row = task->entries + task->starts[i];
+		size_t length = task->starts[i + 1] - task->starts[i];
+		size_t write = 0;
+
+		if (length > 1) qsort(row, length, sizeof(csr_entry), graph_util_compare_entries);
+
+		for (size_t j = 0; j < length; j++) {
+
+			if (j == 0 || row[j].target != row[j - 1].target) row[write++] = row[j];
+		}
+		task->kept[i] = write;
+	}
+	return;
+}
+
+/**
+ * Body of the parallel build that copies the entries left in each row into the final rows
+ */
+void graph_util_build_copy(void* context, size_t from, size_t to) {
+
+	graph_build_task* task = (graph_build_task*)context;
+
+	for (size_t i = from; i < to; i++) {
+
+		const csr_entry* row = task->entries + task->starts[i];
+		size_t pos = task->offsets[i];
+
+		for (size_t j = 0; j < task->kept[i]; j++) {
+
+			task->targets[pos + j] = row[j].target;
+			task->weights[pos + j] = row[j].weight;
+		}
+	}
+	return;
+}
+
+/**
+ * Compares two entries of a row by target, and then by position of their arch among the inserted ones
+ */
+int graph_util_compare_entries(const void* a, const void* b) {
+
+	const csr_entry* x = (const csr_entry*)a;
+	const csr_entry* y = (const csr_entry*)b;
+
+	if (x->target != y->target) return x->target < y->target ? -1 : 1;
+	return (x->index > y->index) - (x->index < y->index);
+}
+
+/**
+ * Frees the compressed rows
+ */
+void graph_util_free_rows(graph* g) {
+
+	// Mapped rows belong to the snapshot
+	if (!g->mapping) {
+
+		free(g->offsets);
+		free(g->targets);
+		free(g->weights);
+	}
+	free(g->in_offsets);
+	free(g->in_sources);
+	g->offsets = NULL;
+	g->targets = NULL;
+	g->weights = NULL;
+	g->in_offsets = NULL;
+	g->in_sources = NULL;
+	g->row_count = 0;
+	return;
+}
+
+/**
+ * Returns the position in the rows of the arch from -> to (binary search in the row of from),
+ * SIZE_MAX if there's no such arch
+ */
+size_t graph_util_find(graph* g, uint32_t from, uint32_t to) {
+
+	size_t pos = SIZE_MAX;
+
+	if (!g->dirty && from < g->row_count) {
+
+		size_t low = g->offsets[from];
+		size_t high = g->offsets[from + 1];
+
+		while (low < high) {
+
+			size_t mid = low + (high - low) / 2;
+
+			if (g->targets[mid] < to) low = mid + 1;
+			else high = mid;
+		}
+		if (low < g->offsets[from + 1] && g->targets[low] == to) pos = low;
+	}
+	return pos;
+}
+
+/**
+ * Visits breadth-first the nodes reachable from source, the frontier is a plain
+ * array used as a queue, since every node enters it at most once
+ */
+void graph_util_BFS(graph* g, uint32_t source, bool* visited, uint32_t* frontier, void (*callback)(void*)) {
+
+	size_t head = 0;
+	size_t tail = 0;
+
+	frontier[tail++] = source;
+	visited[source] = true;
+
+	while (head < tail) {
+
+		uint32_t cur = frontier[head++];
+		callback(graph_get_node_value(g, cur));
+
+		for (size_t i = g->offsets[cur]; i < g->offsets[cur + 1]; i++) {
+
+			if (!visited[g->targets[i]]) {
+
+				visited[g->targets[i]] = true;
+				frontier[tail++] = g->targets[i];
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Visits depth-first the nodes reachable from source, the stack holds the path
+ * from source along with the position of the next arch to follow of each node
+ */
+void graph_util_DFS(graph* g, uint32_t source, bool* visited, uint32_t* nodes, size_t* cursors, void (*callback)(void*)) {
+
+	size_t top = 0;
+
+	nodes[top] = source;
+	cursors[top] = g->offsets[source];
+	top++;
+	visited[source] = true;
+	callback(graph_get_node_value(g, source));
+
+	while (top > 0) {
+
+		uint32_t cur = nodes[top - 1];
+
+		// Follow the next arch to a node not visited yet, or go back
+		if (cursors[top - 1] < g->offsets[cur + 1]) {
+
+			uint32_t next = g->targets[cursors[top - 1]++];
+			if (!visited[next]) {
+
+				visited[next] = true;
+				callback(graph_get_node_value(g, next));
+				nodes[top] = next;
+				cursors[top] = g->offsets[next];
+				top++;
+			}
+		}
+		else top--;
+	}
+	return;
+}
+
+/**
+ * Builds the rows of the arches entering each node, with a counting sort by target,
+ * they're kept until the rows are built again
+ */
+bool graph_util_build_incoming(graph* g) {
+
+	if (!g->in_offsets) {
+
+		size_t n = g->row_count;
+		size_t entries = g->offsets[n];
+		size_t* in_offsets = (size_t*)calloc(n + 2, sizeof(size_t));
+		size_t* cursors = (size_t*)malloc((n + 1) * sizeof(size_t));
+		uint32_t* in_sources = (uint32_t*)malloc((entries + 1) * sizeof(uint32_t));
+
+		if (in_offsets && cursors && in_sources) {
+
+			for (size_t i = 0; i < entries; i++) in_offsets[g->targets[i] + 1]++;
+			for (size_t i = 0; i < n; i++) in_offsets[i + 1] += in_offsets[i];
+			memcpy(cursors, in_offsets, (n + 1) * sizeof(size_t));
+
+			// Sources are visited in order, so every row ends up sorted
+			for (size_t u = 0; u < n; u++) {
+
+				for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) in_sources[cursors[g->targets[i]]++] = (uint32_t)u;
+			}
+
+			g->in_offsets = in_offsets;
+			g->in_sources = in_sources;
+			in_offsets = NULL;
+			in_sources = NULL;
+		}
+		free(in_offsets);
+		free(cursors);
+		free(in_sources);
+	}
+	return g->in_offsets != NULL;
+}
+
+/**
+ * Waits until every thread taking part in the barrier reaches it
+ */
+void graph_util_barrier_wait(graph_barrier* barrier) {
+
+	mtx_lock(&barrier->lock);
+
+	size_t generation = barrier->generation;
+
+	// The last one to arrive wakes up the others
+	if (++barrier->waiting >= barrier->count) {
+
+		barrier->waiting = 0;
+		barrier->generation++;
+		cnd_broadcast(&barrier->cond);
+	}
+	else {
+
+		while (generation == barrier->generation) cnd_wait(&barrier->cond, &barrier->lock);
+	}
+	mtx_unlock(&barrier->lock);
+	return;
+}
+
+/**
+ * Body of the threads of a parallel BFS (except the calling one), each level
+ * is expanded between two barriers, while the calling thread prepares the next one
+ */
+int graph_util_bfs_thread(void* arg) {
+
+	graph_bfs_worker* worker = (graph_bfs_worker*)arg;
+	graph_bfs* bfs = worker->bfs;
+	bool done = false;
+
+	while (!done) {
+
+		graph_util_barrier_wait(&bfs->barrier);
+		done = bfs->done;
+
+		if (!done) {
+
+			graph_util_bfs_step(bfs, worker->index);
+			graph_util_barrier_wait(&bfs->barrier);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Expands the part of the level that belongs to the thread with the given index
+ */
+void graph_util_bfs_step(graph_bfs* bfs, size_t index) {
+
+	if (bfs->bottom_up) graph_util_bfs_bottom_up(bfs, index);
+	else graph_util_bfs_top_down(bfs);
+	return;
+}
+
+/**
+ * Top-down expansion, threads take chunks of the frontier and claim the nodes they reach
+ * setting their bit in the visited bitmap, the node goes to the thread that actually flipped it
+ *
+ * Claimed nodes are collected locally and appended to the next frontier in batches
+ */
+void graph_util_bfs_top_down(graph_bfs* bfs) {
+
+	const size_t* offsets = bfs->g->offsets;
+	const uint32_t* targets = bfs->g->targets;
+	uint32_t batch[GRAPH_BFS_BATCH];
+	size_t batched = 0;
+	size_t arches = 0;
+	size_t start = 0;
+
+	while ((start = atomic_fetch_add(&bfs->cursor, GRAPH_BFS_CHUNK)) < bfs->frontier_count) {
+
+		size_t end = (start + GRAPH_BFS_CHUNK < bfs->frontier_count) ? start + GRAPH_BFS_CHUNK : bfs->frontier_count;
+
+		for (size_t i = start; i < end; i++) {
+
+			uint32_t u = bfs->frontier[i];
+
+			for (size_t k = offsets[u]; k < offsets[u + 1]; k++) {
+
+				uint32_t v = targets[k];
+				uint64_t bit = (uint64_t)1 << (v % 64);
+
+				// The plain load avoids the atomic operation for nodes already reached
+				if (!(atomic_load_explicit(&bfs->visited[v / 64], memory_order_relaxed) & bit) && !(atomic_fetch_or_explicit(&bfs->visited[v / 64], bit, memory_order_relaxed) & bit)) {
+
+					bfs->distances[v] = bfs->level + 1;
+					arches += offsets[v + 1] - offsets[v];
+					batch[batched++] = v;
+
+					if (batched == GRAPH_BFS_BATCH) {
+
+						memcpy(bfs->next + atomic_fetch_add(&bfs->next_count, batched), batch, batched * sizeof(uint32_t));
+						batched = 0;
+					}
+				}
+			}
+		}
+	}
+	if (batched > 0) memcpy(bfs->next + atomic_fetch_add(&bfs->next_count, batched), batch, batched * sizeof(uint32_t));
+	atomic_fetch_add(&bfs->next_arches, arches);
+	return;
+}
+
+/**
+ * Bottom-up expansion, each thread owns a range of words of the bitmaps and, for every
+ * node in it not reached yet, looks for an arch coming from the frontier (stopping at the first one)
+ *
+ * Since no other thread writes those words, the bits are set without contention
+ */
+void graph_util_bfs_bottom_up(graph_bfs* bfs, size_t index) {
+
+	const size_t* offsets = bfs->g->offsets;
+	size_t from = bfs->words * index / bfs->threads;
+	size_t to = bfs->words * (index + 1) / bfs->threads;
+	size_t count = 0;
+	size_t arches = 0;
+
+	for (size_t w = from; w < to; w++) {
+
+		uint64_t unvisited = ~atomic_load_explicit(&bfs->visited[w], memory_order_relaxed);
+		uint64_t reached = 0;
+
+		// The bits past the last node don't stand for any node
+		if (w == bfs->words - 1 && bfs->n % 64) unvisited &= ((uint64_t)1 << (bfs->n % 64)) - 1;
+
+		for (; unvisited; unvisited &= unvisited - 1) {
+
+			size_t b = graph_util_ctz64(unvisited);
+			size_t v = w * 64 + b;
+
+			for (size_t k = bfs->in_offsets[v]; k < bfs->in_offsets[v + 1]; k++) {
+
+				uint32_t u = bfs->in_sources[k];
+
+				if (bfs->frontier_bits[u / 64] & ((uint64_t)1 << (u % 64))) {
+
+					bfs->distances[v] = bfs->level + 1;
+					reached |= (uint64_t)1 << b;
+					count++;
+					arches += offsets[v + 1] - offsets[v];
+					break;
+				}
+			}
+		}
+		if (reached) {
+
+			bfs->next_bits[w] = reached;
+			atomic_fetch_or_explicit(&bfs->visited[w], reached, memory_order_relaxed);
+		}
+	}
+	atomic_fetch_add(&bfs->next_count, count);
+	atomic_fetch_add(&bfs->next_arches, arches);
+	return;
+}
+
+/* Utility function that returns the position of the lowest set bit of a word (that isn't 0) */
+size_t graph_util_ctz64(uint64_t word) {
+
+#if defined(__GNUC__)
+	return (size_t)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (size_t)index;
+#else
+	size_t pos = 0;
+	while (!(word & 1)) {
+
+		word >>= 1;
+		pos++;
+	}
+	return pos;
+#endif
+}
+
+/* Utility function that returns the weight of the arch at the given position of the rows (1 if the graph isn't weighted) */
+int64_t graph_util_weight(graph* g, size_t position) {
+
+	return (g->flags & IS_WEIGHTED) ? g->weights[position] : 1;
+}
+
+/* Utility function used to sort the arches by weight */
+int graph_util_compare_arches(const void* a, const void* b) {
+
+	const csr_arch* x = (const csr_arch*)a;
+	const csr_arch* y = (const csr_arch*)b;
+
+	// Ties are broken by ids so the forest doesn't depend on the sort
+	if (x->weight != y->weight) return x->weight < y->weight ? -1 : 1;
+	if (x->from != y->from) return x->from < y->from ? -1 : 1;
+	if (x->to != y->to) return x->to < y->to ? -1 : 1;
+	return 0;
+}
+
+#endif
\ No newline at end of file
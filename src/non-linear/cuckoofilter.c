@@ -0,0 +1,426 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/cuckoofilter.h"
+#include <string.h>
+#include <math.h>
+
+/* Number of fingerprints per bucket */
+#define CUCKOO_BUCKET_SIZE 4
+
+/* Number of fingerprints moved around by an insertion before giving up */
+#define CUCKOO_MAX_KICKS 500
+
+/* Utility function that returns the first bucket and the fingerprint of a key */
+void cuckoo_util_hash(cuckoofilter* cf, const void* key, size_t len, size_t* bucket, uint16_t* fingerprint);
+
+/* Utility function that returns the other bucket a fingerprint can be in */
+size_t cuckoo_util_alt_bucket(cuckoofilter* cf, size_t bucket, uint16_t fingerprint);
+
+/* Utility function used to put a fingerprint in a free slot of the bucket, returning whether there was one */
+bool cuckoo_util_place(cuckoofilter* cf, size_t bucket, uint16_t fingerprint);
+
+/* Utility function used to insert a fingerprint in one of its two buckets, moving the others if required */
+bool cuckoo_util_insert(cuckoofilter* cf, size_t bucket, uint16_t fingerprint);
+
+/**
+ * Struct that represent a cuckoo filter, a set of keys that can only tell
+ * for sure that a key was never added (it may answer yes for keys that weren't)
+ *
+ * keys are sequences of bytes (strings or any other data), each one stores a small
+ * fingerprint in one of two buckets of four slots; unlike a bloom filter, keys can be removed
+ * (only keys that were actually added, removing any other one could remove a key sharing its fingerprint)
+ *
+ * Filters with the same number of buckets, fingerprint bits and seed can be merged
+ */
+typedef struct cuckoofilter {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Fingerprints, CUCKOO_BUCKET_SIZE per bucket, 0 marks a free slot */
+	uint16_t* slots;
+
+	/* Number of buckets (a power of 2) */
+	size_t buckets;
+
+	/* Number of keys in the filter */
+	size_t count;
+
+	/* Mask of the bits of a fingerprint */
+	uint16_t fingerprint_mask;
+
+	/* Fingerprint left without a slot by the last insertion that gave up (0 if none), and one of its buckets
+	 * Keeping it means no key is ever lost, but no other key can be added until a removal makes space */
+	uint16_t victim;
+	size_t victim_bucket;
+
+	/* Seed given to the hash functions */
+	uint64_t seed;
+
+	/* State of the generator choosing which fingerprints to move */
+	uint64_t random;
+} cuckoofilter;
+
+/**
+ * Creates a cuckoo filter with (at least) the given number of buckets, and fingerprints of the given number of bits
+ *
+ * The number of buckets is rounded up to a power of 2, fingerprints can have from 4 to 16 bits
+ */
+cuckoofilter* cuckoo_create(size_t buckets, size_t fingerprint_bits) {
+
+	cuckoofilter* cf = NULL;
+
+	if (0 < buckets && buckets <= SIZE_MAX / 2 / CUCKOO_BUCKET_SIZE / sizeof(uint16_t) && 4 <= fingerprint_bits && fingerprint_bits <= 16) {
+
+		size_t n = 1;
+		while (n < buckets) n *= 2;
+
+		cf = (cuckoofilter*)malloc(sizeof(cuckoofilter));
+		if (cf) {
+
+			cf->slots = (uint16_t*)calloc(n * CUCKOO_BUCKET_SIZE, sizeof(uint16_t));
+			cf->buckets = n;
+			cf->count = 0;
+			cf->fingerprint_mask = (uint16_t)((1UL << fingerprint_bits) - 1);
+			cf->victim = 0;
+			cf->victim_bucket = 0;
+			cf->seed = hash_util_random_seed();
+			cf->random = cf->seed | 1;
+
+			if (!cf->slots) {
+
+				free(cf);
+				cf = NULL;
+			}
+		}
+	}
+	return cf;
+}
+
+/**
+ * Creates a cuckoo filter sized for n keys with the given false positive rate
+ */
+cuckoofilter* cuckoo_create_for(size_t n, double fpr) {
+
+	size_t buckets = 0, fingerprint_bits = 0;
+
+	cuckoo_get_optimal_size(n, fpr, &buckets, &fingerprint_bits);
+	return cuckoo_create(buckets, fingerprint_bits);
+}
+
+/**
+ * Computes the number of buckets and fingerprint bits of a filter for n keys with the given false positive rate
+ *
+ * The buckets are sized to be 95% full with n keys, the false positive rate can't go below 8 / 65536
+ */
+void cuckoo_get_optimal_size(size_t n, double fpr, size_t* buckets, size_t* fingerprint_bits) {
+
+	if (0 < n && 0.0 < fpr && fpr < 1.0 && buckets && fingerprint_bits) {
+
+		// A lookup compares 2 * CUCKOO_BUCKET_SIZE fingerprints, each one matching with probability 2^-f
+		double f = ceil(log2(2.0 * CUCKOO_BUCKET_SIZE / fpr));
+
+		*fingerprint_bits = (f < 4.0) ? 4 : (f > 16.0) ? 16 : (size_t)f;
+		*buckets = (size_t)ceil((double)n / (CUCKOO_BUCKET_SIZE * 0.95));
+	}
+	return;
+}
+
+/**
+ * Deletes the given cuckoo filter
+ */
+void cuckoo_delete(cuckoofilter** cf) {
+
+	if (cf && *cf) {
+
+		free((*cf)->slots);
+		free(*cf);
+		*cf = NULL;
+	}
+	return;
+}
+
+/**
+ * Adds the given key (a string) to the filter
+ *
+ * Returns whether or not it was added (false if the filter is full)
+ */
+bool cuckoo_add(cuckoofilter* cf, const char* key) {
+
+	return key ? cuckoo_add_n(cf, key, strlen(key)) : false;
+}
+
+/**
+ * Adds the given key, of len bytes, to the filter
+ *
+ * Returns whether or not it was added (false if the filter is full)
+ */
+bool cuckoo_add_n(cuckoofilter* cf, const void* key, size_t len) {
+
+	bool added = false;
+
+	if (cf && key) {
+
+		size_t bucket;
+		uint16_t fingerprint;
+
+		cuckoo_util_hash(cf, key, len, &bucket, &fingerprint);
+		added = cuckoo_util_insert(cf, bucket, fingerprint);
+	}
+	return added;
+}
+
+/**
+ * Removes the given key (a string), that must have been added before, from the filter
+ *
+ * Returns whether or not it was removed
+ */
+bool cuckoo_remove(cuckoofilter* cf, const char* key) {
+
+	return key ? cuckoo_remove_n(cf, key, strlen(key)) : false;
+}
+
+/**
+ * Removes the given key, of len bytes, that must have been added before, from the filter
+ *
+ * Returns whether or not it was removed
+ */
+bool cuckoo_remove_n(cuckoofilter* cf, const void* key, size_t len) {
+
+	bool removed = false;
+
+	if (cf && key) {
+
+		size_t bucket;
+		uint16_t fingerprint;
+
+		cuckoo_util_hash(cf, key, len, &bucket, &fingerprint);
+		size_t alt = cuckoo_util_alt_bucket(cf, bucket, fingerprint);
+
+		if (cf->victim == fingerprint && (cf->victim_bucket == bucket || cf->victim_bucket == alt)) {
+
+			cf->victim = 0;
+			removed = true;
+		}
+
+		// The slots of the first bucket, then the ones of the other
+		for (size_t i = 0; i < 2 * CUCKOO_BUCKET_SIZE && !removed; i++) {
+
+			size_t slot = (i < CUCKOO_BUCKET_SIZE ? bucket : alt) * CUCKOO_BUCKET_SIZE + i % CUCKOO_BUCKET_SIZE;
+			if (cf->slots[slot] == fingerprint) {
+
+				cf->slots[slot] = 0;
+				removed = true;
+			}
+		}
+
+		if (removed) {
+
+			cf->count--;
+
+			// There's space again, the victim gets a slot
+			if (cf->victim) {
+
+				fingerprint = cf->victim;
+				cf->victim = 0;
+				cf->count--;
+				cuckoo_util_insert(cf, cf->victim_bucket, fingerprint);
+			}
+		}
+	}
+	return removed;
+}
+
+/**
+ * Checks if the given key (a string) may have been added to the filter
+ */
+bool cuckoo_contains(cuckoofilter* cf, const char* key) {
+
+	return key ? cuckoo_contains_n(cf, key, strlen(key)) : false;
+}
+
+/**
+ * Checks if the given key, of len bytes, may have been added to the filter
+ */
+bool cuckoo_contains_n(cuckoofilter* cf, const void* key, size_t len) {
+
+	bool found = false;
+
+	if (cf && key) {
+
+		size_t bucket;
+		uint16_t fingerprint;
+
+		cuckoo_util_hash(cf, key, len, &bucket, &fingerprint);
+		size_t alt = cuckoo_util_alt_bucket(cf, bucket, fingerprint);
+
+		found = cf->victim == fingerprint && (cf->victim_bucket == bucket || cf->victim_bucket == alt);
+		for (size_t i = 0; i < CUCKOO_BUCKET_SIZE && !found; i++) {
+
+			found = cf->slots[bucket * CUCKOO_BUCKET_SIZE + i] == fingerprint || cf->slots[alt * CUCKOO_BUCKET_SIZE + i] == fingerprint;
+		}
+	}
+	return found;
+}
+
+/**
+ * Adds every key of other to the filter
+ *
+ * Returns whether or not they could be merged (same number of buckets, fingerprint bits and seed,
+ * and enough space); if the filter fills up on the way, the keys added so far stay in it
+ */
+bool cuckoo_merge(cuckoofilter* cf, cuckoofilter* other) {
+
+	bool merged = false;
+
+	if (cf && other && cf != other && cf->buckets == other->buckets && cf->fingerprint_mask == other->fingerprint_mask && cf->seed == other->seed) {
+
+		// Fingerprints go in the same bucket they're in, the pair of buckets is the same in both filters
+		merged = !other->victim || cuckoo_util_insert(cf, other->victim_bucket, other->victim);
+		for (size_t i = 0; i < other->buckets * CUCKOO_BUCKET_SIZE && merged; i++) {
+
+			if (other->slots[i]) merged = cuckoo_util_insert(cf, i / CUCKOO_BUCKET_SIZE, other->slots[i]);
+		}
+	}
+	return merged;
+}
+
+/**
+ * Returns the number of keys in the filter
+ */
+size_t cuckoo_get_size(cuckoofilter* cf) {
+
+	return cf ? cf->count : 0;
+}
+
+/**
+ * Returns the number of fingerprints the filter has space for
+ */
+size_t cuckoo_get_capacity(cuckoofilter* cf) {
+
+	return cf ? cf->buckets * CUCKOO_BUCKET_SIZE : 0;
+}
+
+/**
+ * Removes every key from the filter
+ */
+void cuckoo_clear(cuckoofilter* cf) {
+
+	if (cf) {
+
+		memset(cf->slots, 0, cf->buckets * CUCKOO_BUCKET_SIZE * sizeof(uint16_t));
+		cf->count = 0;
+		cf->victim = 0;
+	}
+	return;
+}
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every filter starts with a random seed, filters that have to be
+ * merged need the same one; it can only be changed while the filter is empty
+ */
+void cuckoo_set_seed(cuckoofilter* cf, uint64_t seed) {
+
+	if (cf && !cf->count) cf->seed = seed;
+	return;
+}
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t cuckoo_get_seed(cuckoofilter* cf) {
+
+	return cf ? cf->seed : 0;
+}
+
+/* Utility function that returns the first bucket and the fingerprint of a key */
+void cuckoo_util_hash(cuckoofilter* cf, const void* key, size_t len, size_t* bucket, uint16_t* fingerprint) {
+
+	*bucket = hash_util_default_hash(key, len, cf->seed) & (cf->buckets - 1);
+
+	// 0 marks free slots, so it can't be a fingerprint
+	*fingerprint = (uint16_t)(hash_util_default_second_hash(key, len, cf->seed) & cf->fingerprint_mask);
+	if (*fingerprint == 0) *fingerprint = 1;
+	return;
+}
+
+/* Utility function that returns the other bucket a fingerprint can be in */
+size_t cuckoo_util_alt_bucket(cuckoofilter* cf, size_t bucket, uint16_t fingerprint) {
+
+	// Only the fingerprint is known when moving it, so the other bucket depends only on it (and going back gives the first one)
+	return (bucket ^ (size_t)((uint32_t)fingerprint * 0x5BD1E995U)) & (cf->buckets - 1);
+}
+
+/* Utility function used to put a fingerprint in a free slot of the bucket, returning whether there was one */
+bool cuckoo_util_place(cuckoofilter* cf, size_t bucket, uint16_t fingerprint) {
+
+	bool placed = false;
+
+	for (size_t i = 0; i < CUCKOO_BUCKET_SIZE && !placed; i++) {
+
+		if (!cf->slots[bucket * CUCKOO_BUCKET_SIZE + i]) {
+
+			cf->slots[bucket * CUCKOO_BUCKET_SIZE + i] = fingerprint;
+			placed = true;
+		}
+	}
+	return placed;
+}
+
+/* Utility function used to insert a fingerprint in one of its two buckets, moving the others if required */
+bool cuckoo_util_insert(cuckoofilter* cf, size_t bucket, uint16_t fingerprint) {
+
+	bool inserted = false;
+
+	// With a victim waiting the filter is considered full
+	if (!cf->victim) {
+
+		inserted = true;
+		if (!cuckoo_util_place(cf, bucket, fingerprint) && !cuckoo_util_place(cf, cuckoo_util_alt_bucket(cf, bucket, fingerprint), fingerprint)) {
+
+			bool placed = false;
+
+			// Kick a random fingerprint out of the bucket and move it to its other one, until one finds a free slot
+			for (size_t kicks = 0; kicks < CUCKOO_MAX_KICKS && !placed; kicks++) {
+
+				cf->random ^= cf->random << 13;
+				cf->random ^= cf->random >> 7;
+				cf->random ^= cf->random << 17;
+
+				// Start from either bucket, then keep the one the kicked fingerprint goes to
+				if (kicks == 0 && (cf->random >> 32) & 1) bucket = cuckoo_util_alt_bucket(cf, bucket, fingerprint);
+
+				size_t slot = bucket * CUCKOO_BUCKET_SIZE + (size_t)(cf->random % CUCKOO_BUCKET_SIZE);
+				uint16_t kicked = cf->slots[slot];
+
+				cf->slots[slot] = fingerprint;
+				fingerprint = kicked;
+				bucket = cuckoo_util_alt_bucket(cf, bucket, fingerprint);
+				placed = cuckoo_util_place(cf, bucket, fingerprint);
+			}
+
+			// The last one kicked out waits for a free slot
+			if (!placed) {
+
+				cf->victim = fingerprint;
+				cf->victim_bucket = bucket;
+			}
+		}
+		cf->count++;
+	}
+	return inserted;
+}
\ No newline at end of file
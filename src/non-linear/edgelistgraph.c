@@ -6,7 +6,11 @@
  * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+/* Default engine, used when no other one is chosen */
+#if !defined(GRAPH_WITH_EDGE_LIST) && !defined(GRAPH_WITH_MATRIX) && !defined(GRAPH_WITH_ADJACENCY_LIST) && !defined(GRAPH_WITH_CSR)
 #define GRAPH_WITH_EDGE_LIST
+#endif
+
 #ifdef GRAPH_WITH_EDGE_LIST
 
 #include "../../include/non-linear/graph.h"
@@ -14,6 +18,7 @@
 #include "../../include/linear/queue.h"
 #include "../../include/linear/stack.h"
 #include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 typedef struct edge {
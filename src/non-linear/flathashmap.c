@@ -0,0 +1,1063 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef HASHMAP_WITH_FLAT_TABLE
+
+#include "../../include/non-linear/hashmap.h"
+#include "../../include/non-linear/hashfunctions.h"
+#include "../../include/linear/snapshot.h"
+#include "../../include/linear/vector.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HASH_FLAT_USE_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HASH_FLAT_USE_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* Number of slots whose control bytes are matched together */
+#define HASH_GROUP_WIDTH 16
+
+/* Load factor used by newly created hashmaps, (live + deleted slots) / capacity above which the table is rebuilt */
+#define HASH_DEFAULT_MAX_LOAD 0.875
+
+/* Number of keys whose hashes are computed and prefetched together by the batch functions */
+#define HASH_BATCH_SIZE 16
+
+/* Records the length of a probe sequence, nothing without CDS_WITH_STATS */
+#define HASH_COUNT_PROBE(hash, length) (STATS_INC((hash)->lookups), STATS_ADD((hash)->probes, (length)), STATS_MAX((hash)->max_probe, (length)))
+
+/* Hint the processor to start loading the cache line of addr, without waiting for it */
+#if defined(__GNUC__) || defined(__clang__)
+#define HASH_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(HASH_FLAT_USE_SSE2)
+#define HASH_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define HASH_PREFETCH(addr) ((void)(addr))
+#endif
+
+/* Control byte values, a full slot stores the 7 bit fingerprint of its key instead (high bit unset) */
+#define HASH_CTRL_EMPTY ((uint8_t)0x80)
+#define HASH_CTRL_DELETED ((uint8_t)0xFE)
+
+/* Slots are padded to a multiple of this, so that the header and the values returned by hash_get are aligned */
+#define HASH_SLOT_ALIGNMENT 8
+
+/* Interned keys up to this long are stored in the slot (followed by a NUL), the longer ones in the arena */
+#define HASH_INLINE_KEY_LENGTH 15
+#define HASH_INLINE_KEY_SIZE (HASH_INLINE_KEY_LENGTH + 1)
+
+/* Initial size (in bytes) of the arena of an hashmap that interns its keys */
+#define HASH_ARENA_MIN_SIZE 256
+
+/**
+ * Header stored at the start of every slot, the value follows it
+ *
+ * The hash is cached, so that a fingerprint collision is discarded
+ * without reading the key and resizing never needs to hash again
+ */
+typedef struct hash_slot {
+
+	/* Pointer to the key bytes, or the offset of an interned key in the arena
+	 * (unused for the interned keys stored in the slot, after the value)
+	 */
+	union {
+		const void* key;
+		size_t key_offset;
+	};
+
+	/* Number of bytes of the key */
+	size_t key_length;
+
+	/* Hash of the key */
+	size_t hash;
+} hash_slot;
+
+/* Utility function used to create an hashmap, that either interns its keys or stores the given pointers */
+hashmap* hash_util_create(size_t capacity, size_t element_size, bool interned);
+
+/* Utility functions used to manage the table of the hashmap */
+uint32_t hash_util_group_match(const uint8_t* group, uint8_t value);
+uint32_t hash_util_group_match_empty(const uint8_t* group);
+uint32_t hash_util_group_match_free(const uint8_t* group);
+unsigned hash_util_ctz(uint32_t mask);
+size_t hash_util_find(hashmap* hash, const void* key, size_t len, size_t h);
+size_t hash_util_find_free(hashmap* hash, size_t h);
+bool hash_util_resize(hashmap* hash, size_t new_capacity);
+size_t hash_util_round_capacity(size_t capacity);
+hash_slot* hash_util_slot(hashmap* hash, size_t index);
+void hash_util_put(hashmap* hash, const void* key, size_t len, size_t h, void* value);
+void hash_util_remove(hashmap* hash, const void* key, size_t len, size_t h);
+void hash_util_batch_prepare(hashmap* hash, const char** keys, const size_t* lengths, size_t n, size_t* len, size_t* h);
+
+/* Utility functions used to copy an interned key in a slot (or the arena) and to get the bytes of the key of a slot */
+bool hash_util_intern(hashmap* hash, vector* arena, hash_slot* slot, const void* key, size_t len);
+const void* hash_util_slot_key(hashmap* hash, vector* arena, hash_slot* slot);
+
+/**
+ * Descriptor of the snapshot of an hashmap, the couples are stored in a single table
+ */
+typedef struct hash_snapshot {
+
+	uint64_t element_size;
+	uint64_t table;
+} hash_snapshot;
+
+ /**
+  * Struct that represent an hashmap, mapping keys into values
+  *
+  * keys are sequences of bytes (strings or any other data)
+  * values are of generic type
+  *
+  * This engine stores one control byte per slot in a separate contiguous array,
+  * so that a whole group of slots can be checked with a single vector compare,
+  * and only the slots whose fingerprint matches need to read the key
+  */
+typedef struct hashmap {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* One control byte per slot, either empty, deleted or the fingerprint of the stored key */
+	uint8_t* ctrl;
+
+	/* Array of slots, each one holds the slot header followed by the value */
+	char* slots;
+
+	/* Number of slots, a power of two and a multiple of the group width */
+	size_t capacity;
+
+	/* Number of occupied slots */
+	size_t count;
+
+	/* Number of deleted slots */
+	size_t deleted_count;
+
+	/* Size of the values stored in the hashmap */
+	size_t element_size;
+
+	/* Size of each slot, header + value + padding (+ the short interned keys) */
+	size_t slot_size;
+
+	/* Arena the long interned keys are copied in, one after the other, NULL if the hashmap stores the pointers given (see hash_create_interned)
+	 * Removed keys are left where they are, they're dropped when the table is rebuilt
+	 */
+	vector* keys;
+
+	/* Maximum ratio between used (occupied + deleted) slots and capacity, before rebuilding the table */
+	double max_load;
+
+	/* Seed given to the hash function, random for every hashmap */
+	uint64_t seed;
+
+	/* Hash function, can be specified */
+	size_t(*hash_func)(const void*, size_t, uint64_t);
+
+	/* second hash function, can be specified, not used by this engine (the fingerprint comes from the first one) */
+	size_t(*second_hash)(const void*, size_t, uint64_t);
+
+	/* Snapshot the couples are read from (see hash_open_mmap) and its table, NULL if
+	 * they're in memory. Mapped hashmaps are read-only, so every function that would
+	 * modify them leaves them unchanged
+	 */
+	snapshot* mapping;
+	snapshot_table image;
+
+#ifdef CDS_WITH_STATS
+	/* Probe sequences walked, their total and maximum length, and tables rebuilt */
+	size_t lookups;
+	size_t probes;
+	size_t max_probe;
+	size_t rehashes;
+#endif
+} hashmap;
+
+/**
+ * Creates an hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements
+ *
+ * The capacity is rounded up to a power of two and grows automatically
+ */
+hashmap* hash_create(size_t capacity, size_t element_size) {
+
+	return hash_util_create(capacity, element_size, false);
+}
+
+/**
+ * Creates an hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements, and that keeps its own copy of the keys
+ *
+ * Keys up to 15 bytes are stored in their slot, the longer ones are appended to an arena,
+ * so inserting never allocates a key on its own and the callers keep (and free) the keys they pass
+ * The arena is compacted by rehashing, the keys of the removed couples are dropped then
+ */
+hashmap* hash_create_interned(size_t capacity, size_t element_size) {
+
+	return hash_util_create(capacity, element_size, true);
+}
+
+/* Utility function that creates an hashmap, with the slots sized for the interned keys if needed */
+hashmap* hash_util_create(size_t capacity, size_t element_size, bool interned) {
+
+	hashmap* hash = NULL;
+
+	if (0 < capacity && 0 < element_size && element_size <= SIZE_MAX - sizeof(hash_slot) - HASH_INLINE_KEY_SIZE - HASH_SLOT_ALIGNMENT) {
+
+		hash = (hashmap*)malloc(sizeof(hashmap));
+		if (hash) {
+
+			hash->ctrl = NULL;
+			hash->slots = NULL;
+			hash->capacity = 0;
+			hash->count = 0;
+			hash->deleted_count = 0;
+			hash->element_size = element_size;
+			hash->slot_size = (sizeof(hash_slot) + element_size + (interned ? HASH_INLINE_KEY_SIZE : 0) + HASH_SLOT_ALIGNMENT - 1) / HASH_SLOT_ALIGNMENT * HASH_SLOT_ALIGNMENT;
+			hash->keys = interned ? vec_create(HASH_ARENA_MIN_SIZE, sizeof(char)) : NULL;
+			hash->max_load = HASH_DEFAULT_MAX_LOAD;
+			hash->seed = hash_util_random_seed();
+			hash->hash_func = *hash_util_default_hash;
+			hash->second_hash = NULL;
+			hash->mapping = NULL;
+#ifdef CDS_WITH_STATS
+			hash->lookups = 0;
+			hash->probes = 0;
+			hash->max_probe = 0;
+			hash->rehashes = 0;
+#endif
+
+			if ((interned && !hash->keys) || !hash_util_resize(hash, hash_util_round_capacity(capacity))) {
+
+				vec_delete(&hash->keys);
+				free(hash);
+				hash = NULL;
+			}
+		}
+	}
+	return hash;
+}
+
+/**
+ * Deletes the given hashmap
+ *
+ * The keys still stored in the hashmap are freed aswell (unless they're interned)
+ */
+void hash_delete(hashmap** hash) {
+
+	if (hash && *hash) {
+
+		// The couples of mapped hashmaps are released by unmapping the snapshot
+		if ((*hash)->mapping) snapshot_util_close(&(*hash)->mapping);
+		else hash_clear(*hash);
+		free((*hash)->ctrl);
+		free((*hash)->slots);
+		vec_delete(&(*hash)->keys);
+		memset(*hash, 0, sizeof(hashmap));
+		free(*hash);
+		*hash = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void hash_put(hashmap* hash, const char* key, void* value) {
+
+	if (key) hash_put_n(hash, key, strlen(key), value);
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void hash_put_n(hashmap* hash, const void* key, size_t len, void* value) {
+
+	if (hash && key && value && !hash->mapping) hash_util_put(hash, key, len, hash->hash_func(key, len, hash->seed), value);
+	return;
+}
+
+/**
+ * Removes the element mapped by key (NUL terminated string)
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
+ */
+void hash_remove(hashmap* hash, const char* key) {
+
+	if (key) hash_remove_n(hash, key, strlen(key));
+	return;
+}
+
+/**
+ * Removes the element mapped by the len bytes pointed to by key
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
+ */
+void hash_remove_n(hashmap* hash, const void* key, size_t len) {
+
+	if (hash && key && !hash->mapping) hash_util_remove(hash, key, len, hash->hash_func(key, len, hash->seed));
+	return;
+}
+
+/**
+ * Returns the value mapped by key (NUL terminated string)
+ */
+void* hash_get(hashmap* hash, const char* key) {
+
+	return key ? hash_get_n(hash, key, strlen(key)) : NULL;
+}
+
+/**
+ * Returns the value mapped by the len bytes pointed to by key
+ */
+void* hash_get_n(hashmap* hash, const void* key, size_t len) {
+
+	void* val = NULL;
+
+	if (hash && key && hash->mapping) val = (void*)snapshot_util_find(&hash->image, key, len, hash_util_wyhash(key, len, hash->image.seed));
+	else if (hash && key) {
+
+		size_t index = hash_util_find(hash, key, len, hash->hash_func(key, len, hash->seed));
+		if (index < hash->capacity) val = (char*)hash_util_slot(hash, index) + sizeof(hash_slot);
+	}
+	return val;
+}
+
+/**
+ * Copies the value mapped by key (NUL terminated string) into buf
+ */
+void hash_get_2(hashmap* hash, const char* key, void* buf) {
+
+	if (key) hash_get_2_n(hash, key, strlen(key), buf);
+	return;
+}
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf
+ */
+void hash_get_2_n(hashmap* hash, const void* key, size_t len, void* buf) {
+
+	if (hash && key && buf) {
+
+		void* val = hash_get_n(hash, key, len);
+		if (val) memcpy(buf, val, hash->element_size);
+	}
+	return;
+}
+
+/**
+ * Inserts n couples <keys[i], value i>, values points to n contiguous elements
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its group prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
+ */
+void hash_put_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void* values) {
+
+	if (hash && keys && values && !hash->mapping) {
+
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE];
+
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
+
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h);
+
+			for (size_t i = 0; i < batch; i++) {
+
+				if (keys[base + i]) hash_util_put(hash, keys[base + i], len[i], h[i], (char*)values + (base + i) * hash->element_size);
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Removes the elements mapped by the n given keys
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its group prefetched before any probe is resolved
+ */
+void hash_remove_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n) {
+
+	if (hash && keys && !hash->mapping) {
+
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE];
+
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
+
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h);
+
+			for (size_t i = 0; i < batch; i++) {
+
+				if (keys[base + i]) hash_util_remove(hash, keys[base + i], len[i], h[i]);
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Looks up n keys at once, values[i] is set to the value mapped by keys[i] (NULL if absent)
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its group prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
+ */
+void hash_get_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void** values) {
+
+	// Mapped tables are probed one key at a time
+	if (hash && keys && values && hash->mapping) {
+
+		for (size_t i = 0; i < n; i++) values[i] = keys[i] ? hash_get_n(hash, keys[i], lengths ? lengths[i] : strlen(keys[i])) : NULL;
+	}
+	else if (hash && keys && values) {
+
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE];
+
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
+
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h);
+
+			// By now the control bytes and first slots of the batch are (most likely) in cache
+			for (size_t i = 0; i < batch; i++) {
+
+				size_t index = keys[base + i] ? hash_util_find(hash, keys[base + i], len[i], h[i]) : hash->capacity;
+				values[base + i] = index < hash->capacity ? (void*)((char*)hash_util_slot(hash, index) + sizeof(hash_slot)) : NULL;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Removes all the values in the hashmap
+ * the struct itself is preserved
+ *
+ * The stored keys are freed
+ */
+void hash_clear(hashmap* hash) {
+
+	if (hash && !hash->mapping) {
+
+		// Interned keys belong to the arena, there's nothing to free
+		for (size_t i = 0; !hash->keys && hash->count > 0 && i < hash->capacity; i++) {
+
+			if (!(hash->ctrl[i] & 0x80)) {
+
+				free((void*)hash_util_slot(hash, i)->key);
+				hash->count--;
+			}
+		}
+		if (hash->keys) vec_resize(hash->keys, 0);
+
+		memset(hash->ctrl, HASH_CTRL_EMPTY, hash->capacity);
+		memset(hash->slots, 0, hash->capacity * hash->slot_size);
+		hash->count = 0;
+		hash->deleted_count = 0;
+	}
+	return;
+}
+
+/**
+ * Returns the capacity of the hashmap
+ */
+size_t hash_get_capacity(hashmap* hash) {
+
+	return hash ? (hash->mapping ? hash->image.capacity : hash->capacity) : 0;
+}
+
+/**
+ * Returns the number of couples stored in the hashmap
+ */
+size_t hash_get_size(hashmap* hash) {
+
+	return hash ? (hash->mapping ? hash->image.count : hash->count) : 0;
+}
+
+/**
+ * Returns the size of the elements stored in the hash
+ */
+size_t hash_get_element_size(hashmap* hash) {
+
+	return hash ? hash->element_size : 0;
+}
+
+/**
+ * Sets the maximum load factor, that is the maximum ratio between
+ * used (occupied and deleted) slots and capacity, above which the
+ * hashmap is rehashed into a bigger table
+ *
+ * The value has to be between 0 and 1 (both excluded), otherwise the call is ignored
+ */
+void hash_set_max_load(hashmap* hash, double max_load) {
+
+	if (hash && 0.0 < max_load && max_load < 1.0) hash->max_load = max_load;
+	return;
+}
+
+/**
+ * Returns the maximum load factor of the hashmap
+ */
+double hash_get_max_load(hashmap* hash) {
+
+	return hash ? hash->max_load : 0.0;
+}
+
+/**
+ * Checks whether or not an incremental rehash is in progress
+ *
+ * This engine rebuilds the whole table at once, so it's never the case
+ */
+bool hash_is_rehashing(hashmap* hash) {
+
+	(void)hash;
+	return false;
+}
+
+/**
+ * Copies in stats the counters of the hashmap
+ *
+ * Probe lengths are counted in slots by the default engine and in groups of 16 slots by the flat one,
+ * lookups, probes and rehashes stay at zero unless the library is built with CDS_WITH_STATS
+ */
+void hash_get_stats(hashmap* hash, hash_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(hash_stats));
+		stats->enabled = STATS_ENABLED;
+
+		if (hash && hash->mapping) {
+
+			stats->count = hash->image.count;
+			stats->capacity = hash->image.capacity;
+		}
+		else if (hash) {
+
+			stats->count = hash->count;
+			stats->capacity = hash->capacity;
+			stats->tombstones = hash->deleted_count;
+		}
+
+		// Averages are computed here, so that lookups only pay for the sums
+		stats->load = stats->capacity ? (double)(stats->count + stats->tombstones) / (double)stats->capacity : 0;
+#ifdef CDS_WITH_STATS
+		if (hash) {
+
+			stats->lookups = hash->lookups;
+			stats->probes = hash->probes;
+			stats->max_probe = hash->max_probe;
+			stats->rehashes = hash->rehashes;
+			stats->average_probe = hash->lookups ? (double)hash->probes / (double)hash->lookups : 0;
+		}
+#endif
+	}
+	return;
+}
+
+/**
+ * Sets a custom hash function
+ *
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
+ */
+void hash_set_function(hashmap* hash, size_t (*map)(const void*, size_t, uint64_t)) {
+
+	if (hash && map && !hash->count) hash->hash_func = map;
+	return;
+}
+
+/**
+ * Sets a custom second hash function, used to determine the probe step
+ *
+ * NULL (the default) derives the step from the first hash, without hashing the key twice
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
+ */
+void hash_set_second_function(hashmap* hash, size_t(*map2)(const void*, size_t, uint64_t)) {
+
+	if (hash && !hash->count) hash->second_hash = map2;
+	return;
+}
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every hashmap starts with a random seed, so that a given set of keys
+ * can't be crafted to collide, this can be used to get reproducible layouts
+ * It can only be changed while the hashmap is empty
+ */
+void hash_set_seed(hashmap* hash, uint64_t seed) {
+
+	if (hash && !hash->count) hash->seed = seed;
+	return;
+}
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t hash_get_seed(hashmap* hash) {
+
+	return hash ? hash->seed : 0;
+}
+
+/**
+ * Writes the couples of the hashmap in a snapshot in the given file (which is replaced)
+ *
+ * The snapshot doesn't depend on the engine nor on the hash function of the hashmap,
+ * it can be mapped back by hash_open_mmap, true is returned if it was written entirely
+ */
+bool hash_save(hashmap* hash, const char* path) {
+
+	bool saved = false;
+	snapshot_writer w;
+	size_t n = hash_get_size(hash);
+	snapshot_entry* entries = hash ? (snapshot_entry*)malloc((n + 1) * sizeof(snapshot_entry)) : NULL;
+
+	if (entries && path && snapshot_util_begin(&w, path, SNAPSHOT_HASHMAP, sizeof(hash_snapshot))) {
+
+		size_t count = 0;
+
+		// Couples of a mapped hashmap are taken from its table
+		if (hash->mapping) {
+
+			for (size_t i = 0; i < hash->image.capacity && count < n; i++) {
+
+				const snapshot_slot* slot = &hash->image.slots[i];
+				if (slot->key != SNAPSHOT_EMPTY) {
+
+					entries[count].key = hash->image.base + slot->key;
+					entries[count].key_length = (size_t)slot->key_length;
+					entries[count].value = hash->image.base + slot->value;
+					count++;
+				}
+			}
+		}
+
+		for (size_t i = 0; !hash->mapping && count < n && i < hash->capacity; i++) {
+
+			if (!(hash->ctrl[i] & 0x80)) {
+
+				hash_slot* slot = hash_util_slot(hash, i);
+				entries[count].key = hash_util_slot_key(hash, hash->keys, slot);
+				entries[count].key_length = slot->key_length;
+				entries[count].value = (char*)slot + sizeof(hash_slot);
+				count++;
+			}
+		}
+
+		// The table is always hashed by wyhash, since the function of the hashmap could be different in another process
+		hash_snapshot descriptor;
+		descriptor.element_size = hash->element_size;
+		descriptor.table = snapshot_util_write_table(&w, entries, count, hash->element_size, hash_util_wyhash, hash->mapping ? hash->image.seed : hash->seed, NULL);
+		saved = snapshot_util_end(&w, &descriptor, sizeof(hash_snapshot));
+	}
+	free(entries);
+	return saved;
+}
+
+/**
+ * Maps the snapshot written by hash_save in the given file, and returns an hashmap that looks keys up in place
+ *
+ * Nothing is copied or rehashed, so opening takes the same time whatever the number of couples, and
+ * only the pages that are read get loaded. The hashmap is read-only: the functions that would modify it
+ * leave it unchanged, and the values returned by hash_get must not be written. Deleting it unmaps the file
+ *
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of an hashmap
+ */
+hashmap* hash_open_mmap(const char* path) {
+
+	hashmap* hash = NULL;
+	hash_snapshot descriptor;
+	snapshot* s = snapshot_util_open(path, SNAPSHOT_HASHMAP, &descriptor, sizeof(hash_snapshot));
+
+	if (s) {
+
+		snapshot_table image;
+		bool valid = snapshot_util_open_table(s, descriptor.table, &image) && descriptor.element_size > 0 && image.value_size == descriptor.element_size;
+
+		hash = valid ? (hashmap*)malloc(sizeof(hashmap)) : NULL;
+		if (hash) {
+
+			hash->ctrl = NULL;
+			hash->slots = NULL;
+			hash->capacity = 0;
+			hash->count = 0;
+			hash->deleted_count = 0;
+			hash->slot_size = 0;
+			hash->keys = NULL;
+			hash->element_size = image.value_size;
+			hash->max_load = HASH_DEFAULT_MAX_LOAD;
+			hash->seed = image.seed;
+			hash->hash_func = *hash_util_default_hash;
+			hash->second_hash = NULL;
+			hash->mapping = s;
+			hash->image = image;
+#ifdef CDS_WITH_STATS
+			hash->lookups = 0;
+			hash->probes = 0;
+			hash->max_probe = 0;
+			hash->rehashes = 0;
+#endif
+		}
+		else snapshot_util_close(&s);
+	}
+	return hash;
+}
+
+/* Utility function that returns a bitmask of the slots in the group whose control byte is value */
+uint32_t hash_util_group_match(const uint8_t* group, uint8_t value) {
+
+#if defined(HASH_FLAT_USE_SSE2)
+	__m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+#elif defined(HASH_FLAT_USE_NEON)
+	// Narrow the 0x00/0xFF lanes to 4 bits each, then keep one bit per slot
+	uint8x16_t eq = vceqq_u8(vld1q_u8(group), vdupq_n_u8(value));
+	uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+	uint32_t mask = 0;
+	for (int i = 0; i < HASH_GROUP_WIDTH; i++) mask |= (uint32_t)((nibbles >> (4 * i)) & 1) << i;
+	return mask;
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < HASH_GROUP_WIDTH; i++) mask |= (uint32_t)(group[i] == value) << i;
+	return mask;
+#endif
+}
+
+/* Utility function that returns a bitmask of the empty slots in the group */
+uint32_t hash_util_group_match_empty(const uint8_t* group) {
+
+	return hash_util_group_match(group, HASH_CTRL_EMPTY);
+}
+
+/* Utility function that returns a bitmask of the slots in the group that are either empty or deleted */
+uint32_t hash_util_group_match_free(const uint8_t* group) {
+
+#if defined(HASH_FLAT_USE_SSE2)
+	// Only free slots have the high bit set
+	return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < HASH_GROUP_WIDTH; i++) mask |= (uint32_t)(group[i] >> 7) << i;
+	return mask;
+#endif
+}
+
+/* Utility function that returns the index of the lowest set bit of a non zero mask */
+unsigned hash_util_ctz(uint32_t mask) {
+
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (unsigned)index;
+#elif defined(__GNUC__)
+	return (unsigned)__builtin_ctz(mask);
+#else
+	unsigned index = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
+
+/* Utility function that returns the slot holding key, or the capacity if the key is not present */
+size_t hash_util_find(hashmap* hash, const void* key, size_t len, size_t h) {
+
+	size_t found = hash->capacity;
+
+	if (hash->count > 0) {
+
+		uint8_t fingerprint = (uint8_t)(h & 0x7F);
+		size_t group_mask = hash->capacity / HASH_GROUP_WIDTH - 1;
+		size_t group = (h >> 7) & group_mask;
+
+		size_t i = 1;
+
+		// Triangular probing over the groups, with a power of two number of groups it visits all of them
+		for (; i <= group_mask + 1; i++) {
+
+			const uint8_t* ctrl = hash->ctrl + group * HASH_GROUP_WIDTH;
+
+			// Only the slots with the same fingerprint need to look at the key
+			for (uint32_t match = hash_util_group_match(ctrl, fingerprint); match; match &= match - 1) {
+
+				size_t index = group * HASH_GROUP_WIDTH + hash_util_ctz(match);
+				hash_slot* slot = hash_util_slot(hash, index);
+				if (slot->hash == h && slot->key_length == len && memcmp(hash_util_slot_key(hash, hash->keys, slot), key, len) == 0) {
+
+					HASH_COUNT_PROBE(hash, i);
+					return index;
+				}
+			}
+
+			// An empty slot means the key would have been inserted in this group
+			if (hash_util_group_match_empty(ctrl)) break;
+
+			group = (group + i) & group_mask;
+		}
+		HASH_COUNT_PROBE(hash, i <= group_mask + 1 ? i : group_mask + 1);
+	}
+	return found;
+}
+
+/* Utility function that returns the first free (empty or deleted) slot of the probe sequence */
+size_t hash_util_find_free(hashmap* hash, size_t h) {
+
+	size_t group_mask = hash->capacity / HASH_GROUP_WIDTH - 1;
+	size_t group = (h >> 7) & group_mask;
+
+	for (size_t i = 1; i <= group_mask + 1; i++) {
+
+		uint32_t match = hash_util_group_match_free(hash->ctrl + group * HASH_GROUP_WIDTH);
+		if (match) return group * HASH_GROUP_WIDTH + hash_util_ctz(match);
+
+		group = (group + i) & group_mask;
+	}
+	return hash->capacity;
+}
+
+/* Utility function that moves every couple into a new table of the given capacity, the long interned keys into a new arena */
+bool hash_util_resize(hashmap* hash, size_t new_capacity) {
+
+	bool done = false;
+
+	if (HASH_GROUP_WIDTH <= new_capacity && new_capacity <= SIZE_MAX / hash->slot_size) {
+
+		uint8_t* old_ctrl = hash->ctrl;
+		char* old_slots = hash->slots;
+		size_t old_capacity = hash->capacity;
+		vector* old_keys = hash->keys;
+
+		// The live keys fit in as many bytes as the old arena holds, so copying them can't fail
+		hash->ctrl = (uint8_t*)malloc(new_capacity);
+		hash->slots = (char*)calloc(new_capacity, hash->slot_size);
+		hash->keys = old_keys ? vec_create(vec_get_length(old_keys) > HASH_ARENA_MIN_SIZE ? vec_get_length(old_keys) : HASH_ARENA_MIN_SIZE, sizeof(char)) : NULL;
+
+		if (hash->ctrl && hash->slots && (!old_keys || hash->keys)) {
+
+			memset(hash->ctrl, HASH_CTRL_EMPTY, new_capacity);
+			hash->capacity = new_capacity;
+			hash->deleted_count = 0;
+
+			// Reinsert every live couple, the keys are known to be distinct and their hash is cached
+			for (size_t i = 0; i < old_capacity; i++) {
+
+				if (!(old_ctrl[i] & 0x80)) {
+
+					char* slot = old_slots + i * hash->slot_size;
+					size_t h = ((hash_slot*)slot)->hash;
+					size_t index = hash_util_find_free(hash, h);
+					hash->ctrl[index] = (uint8_t)(h & 0x7F);
+					memcpy(hash->slots + index * hash->slot_size, slot, hash->slot_size);
+
+					// Only the keys that are still mapped get into the new arena
+					hash_slot* moved = hash_util_slot(hash, index);
+					if (old_keys && moved->key_length > HASH_INLINE_KEY_LENGTH) hash_util_intern(hash, hash->keys, moved, hash_util_slot_key(hash, old_keys, (hash_slot*)slot), moved->key_length);
+				}
+			}
+
+			free(old_ctrl);
+			free(old_slots);
+			vec_delete(&old_keys);
+			done = true;
+		}
+
+		// Allocation failed, keep the old table
+		else {
+
+			free(hash->ctrl);
+			free(hash->slots);
+			vec_delete(&hash->keys);
+			hash->ctrl = old_ctrl;
+			hash->slots = old_slots;
+			hash->keys = old_keys;
+		}
+	}
+	return done;
+}
+
+/* Utility function that rounds the capacity up to a power of two, at least as big as a group (0 if it's not possible) */
+size_t hash_util_round_capacity(size_t capacity) {
+
+	size_t rounded = HASH_GROUP_WIDTH;
+	while (rounded < capacity && rounded <= SIZE_MAX / 2) rounded *= 2;
+
+	return rounded >= capacity ? rounded : 0;
+}
+
+/* Utility function that returns the header of the index -th slot */
+hash_slot* hash_util_slot(hashmap* hash, size_t index) {
+
+	return (hash_slot*)(hash->slots + index * hash->slot_size);
+}
+
+/* Utility function that inserts (or replaces) a couple whose hash is already known */
+void hash_util_put(hashmap* hash, const void* key, size_t len, size_t h, void* value) {
+
+	size_t index = hash_util_find(hash, key, len, h);
+
+	// New key, make sure there is room for it first
+	if (index == hash->capacity) {
+
+		if ((double)(hash->count + hash->deleted_count + 1) > hash->max_load * (double)hash->capacity) {
+
+			// Grow only if the live couples need it, otherwise just drop the tombstones
+			size_t new_capacity = hash->capacity;
+			if ((double)(hash->count + 1) > hash->max_load * (double)hash->capacity / 2 && new_capacity <= SIZE_MAX / 2 / hash->slot_size) new_capacity *= 2;
+			if (hash_util_resize(hash, new_capacity)) STATS_INC(hash->rehashes);
+		}
+
+		// Interned keys are copied first, the slot stays free if there's no room for the key
+		index = hash_util_find_free(hash, h);
+		if (index < hash->capacity && hash->keys && !hash_util_intern(hash, hash->keys, hash_util_slot(hash, index), key, len)) index = hash->capacity;
+		if (index < hash->capacity) {
+
+			if (hash->ctrl[index] == HASH_CTRL_DELETED) hash->deleted_count--;
+			hash->ctrl[index] = (uint8_t)(h & 0x7F);
+			hash->count++;
+		}
+	}
+
+	// Key present, the old one is replaced (an interned key is kept, it has the same bytes)
+	else if (!hash->keys) {
+
+		hash_slot* read = hash_util_slot(hash, index);
+		if (read->key != key) free((void*)read->key);
+	}
+
+	if (index < hash->capacity) {
+
+		hash_slot* slot = hash_util_slot(hash, index);
+		if (!hash->keys) slot->key = key;
+		slot->key_length = len;
+		slot->hash = h;
+		memcpy((char*)slot + sizeof(hash_slot), value, hash->element_size);
+	}
+	return;
+}
+
+/* Utility function that removes the couple whose hash is already known, if present */
+void hash_util_remove(hashmap* hash, const void* key, size_t len, size_t h) {
+
+	size_t index = hash_util_find(hash, key, len, h);
+	if (index < hash->capacity) {
+
+		// Interned keys are dropped by the next rebuild (or when the hashmap gets empty)
+		if (!hash->keys) free((void*)hash_util_slot(hash, index)->key);
+		memset(hash->slots + index * hash->slot_size, 0, hash->slot_size);
+
+		// Probes stop at the first group with an empty slot, if this group has one no probe goes through it
+		if (hash_util_group_match_empty(hash->ctrl + (index & ~(size_t)(HASH_GROUP_WIDTH - 1)))) {
+
+			hash->ctrl[index] = HASH_CTRL_EMPTY;
+		}
+		else {
+
+			hash->ctrl[index] = HASH_CTRL_DELETED;
+			hash->deleted_count++;
+		}
+		hash->count--;
+		if (hash->keys && hash->count == 0) vec_resize(hash->keys, 0);
+	}
+	return;
+}
+
+/* Utility function that computes lengths and hashes of a batch of keys, and prefetches their first group */
+void hash_util_batch_prepare(hashmap* hash, const char** keys, const size_t* lengths, size_t n, size_t* len, size_t* h) {
+
+	size_t group_mask = hash->capacity / HASH_GROUP_WIDTH - 1;
+
+	for (size_t i = 0; i < n; i++) {
+
+		if (keys[i]) {
+
+			len[i] = lengths ? lengths[i] : strlen(keys[i]);
+			h[i] = hash->hash_func(keys[i], len[i], hash->seed);
+
+			size_t group = (h[i] >> 7) & group_mask;
+			HASH_PREFETCH(hash->ctrl + group * HASH_GROUP_WIDTH);
+			HASH_PREFETCH(hash->slots + group * HASH_GROUP_WIDTH * hash->slot_size);
+		}
+	}
+	return;
+}
+
+/* Utility function that copies an interned key: in the slot (after the value) if it's short, otherwise at the end of the arena */
+bool hash_util_intern(hashmap* hash, vector* arena, hash_slot* slot, const void* key, size_t len) {
+
+	bool stored = false;
+
+	if (len <= HASH_INLINE_KEY_LENGTH) {
+
+		char* bytes = (char*)slot + hash->slot_size - HASH_INLINE_KEY_SIZE;
+		memcpy(bytes, key, len);
+		bytes[len] = '\0';
+		stored = true;
+	}
+	else if (len < SIZE_MAX - vec_get_length(arena)) {
+
+		// Keys are followed by a NUL aswell, the arena doubles when it's full so that appending stays amortized O(1)
+		size_t offset = vec_get_length(arena);
+		size_t needed = offset + len + 1;
+		size_t size = vec_get_size(arena);
+
+		if (needed > size) vec_reserve(arena, size <= SIZE_MAX / 2 && needed < 2 * size ? 2 * size : needed);
+		vec_resize(arena, needed);
+
+		if (vec_get_length(arena) == needed) {
+
+			char* bytes = (char*)vec_get_at(arena, offset);
+			memcpy(bytes, key, len);
+			bytes[len] = '\0';
+			slot->key_offset = offset;
+			stored = true;
+		}
+	}
+	return stored;
+}
+
+/* Utility function that returns the bytes of the key of a slot, wherever they're stored */
+const void* hash_util_slot_key(hashmap* hash, vector* arena, hash_slot* slot) {
+
+	if (!arena) return slot->key;
+	if (slot->key_length <= HASH_INLINE_KEY_LENGTH) return (char*)slot + hash->slot_size - HASH_INLINE_KEY_SIZE;
+
+	return vec_get_at(arena, slot->key_offset);
+}
+
+#endif
\ No newline at end of file
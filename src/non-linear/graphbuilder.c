@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef GRAPH_WITH_CSR
+
+#include "../../include/non-linear/graphbuilder.h"
+#include <string.h>
+
+/* Number of arches passed to the graph at a time, when the chunk size isn't given */
+#define GRAPH_BUILDER_DEFAULT_CHUNK 65536
+
+/* Utility function used to pass the collected arches to the graph */
+void gb_util_flush(graph_builder* b);
+
+/**
+ * Struct that represent a builder, that loads a (CSR) graph from a stream of arches
+ */
+typedef struct graph_builder {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Graph being built, NULL if a new one couldn't be created after finishing */
+	graph* g;
+
+	/* Ids of the two nodes and weight of each arch of the current chunk */
+	uint32_t* from;
+	uint32_t* to;
+	int* weights;
+
+	/* Number of arches in the current chunk, and maximum number */
+	size_t count;
+	size_t chunk_size;
+
+	/* Size of the elements stored in the graph */
+	size_t element_size;
+
+	/* Flags of the graph */
+	int flags;
+} graph_builder;
+
+/**
+ * Creates a builder for a graph of nodes that are as big as element_size, with the given flags,
+ * that passes the arches to the graph chunk_size at a time (a default size is used if it's 0)
+ */
+graph_builder* gb_create(size_t element_size, int flags, size_t chunk_size) {
+
+	graph_builder* b = NULL;
+
+	if (chunk_size == 0) chunk_size = GRAPH_BUILDER_DEFAULT_CHUNK;
+
+	if (0 < element_size && chunk_size <= SIZE_MAX / sizeof(uint32_t)) {
+
+		b = (graph_builder*)malloc(sizeof(graph_builder));
+		if (b) {
+
+			b->g = graph_create(element_size, flags);
+			b->from = (uint32_t*)malloc(chunk_size * sizeof(uint32_t));
+			b->to = (uint32_t*)malloc(chunk_size * sizeof(uint32_t));
+			b->weights = (int*)malloc(chunk_size * sizeof(int));
+
+			if (b->g && b->from && b->to && b->weights) {
+
+				b->count = 0;
+				b->chunk_size = chunk_size;
+				b->element_size = element_size;
+				b->flags = flags;
+			}
+			else {
+
+				graph_delete(&b->g);
+				free(b->from);
+				free(b->to);
+				free(b->weights);
+				free(b);
+				b = NULL;
+			}
+		}
+	}
+	return b;
+}
+
+/**
+ * Deletes the given builder, and the graph it was building (unless it was finished)
+ */
+void gb_delete(graph_builder** b) {
+
+	if (b && *b) {
+
+		graph_delete(&(*b)->g);
+		free((*b)->from);
+		free((*b)->to);
+		free((*b)->weights);
+		memset(*b, 0, sizeof(graph_builder));
+		free(*b);
+		*b = NULL;
+	}
+	return;
+}
+
+/**
+ * Adds an arch between the nodes holding first and second, with the given weight,
+ * the nodes are inserted in the graph the first time their value is seen
+ *
+ * Arches whose weight isn't positive are skipped
+ */
+void gb_add_arch(graph_builder* b, const void* first, const void* second, int weight) {
+
+	if (b && b->g && first && second && weight > 0) {
+
+		// A single lookup gives the id of a node, whether it's new or not
+		uint32_t from = graph_insert_node_id(b->g, (void*)first);
+		uint32_t to = graph_insert_node_id(b->g, (void*)second);
+
+		if (from != GRAPH_NO_NODE && to != GRAPH_NO_NODE) {
+
+			b->from[b->count] = from;
+			b->to[b->count] = to;
+			b->weights[b->count] = weight;
+			if (++b->count == b->chunk_size) gb_util_flush(b);
+		}
+	}
+	return;
+}
+
+/**
+ * Adds the arches produced by next, which is called until it returns false
+ *
+ * Each call writes the values of the two nodes in first and second (buffers that are as big
+ * as the elements) and the weight in weight (already set to 1), the number of arches added is returned
+ */
+size_t gb_add_stream(graph_builder* b, bool (*next)(void* context, void* first, void* second, int* weight), void* context) {
+
+	size_t added = 0;
+
+	if (b && next) {
+
+		char* first = (char*)malloc(b->element_size);
+		char* second = (char*)malloc(b->element_size);
+
+		if (first && second) {
+
+			int weight = 1;
+			while (next(context, first, second, &weight)) {
+
+				gb_add_arch(b, first, second, weight);
+				weight = 1;
+				added++;
+			}
+		}
+		free(first);
+		free(second);
+	}
+	return added;
+}
+
+/**
+ * Adds the arches read from a binary file, till its end
+ *
+ * Each arch is a record made of the bytes of the first node, the bytes of the second one,
+ * and (only for weighted graphs) an int with the weight, the records are read a chunk at a time
+ * The number of arches read is returned
+ */
+size_t gb_add_file(graph_builder* b, FILE* file) {
+
+	size_t added = 0;
+
+	if (b && file) {
+
+		bool weighted = b->flags & IS_WEIGHTED;
+		size_t record = 2 * b->element_size + (weighted ? sizeof(int) : 0);
+		size_t records = b->chunk_size;
+
+		// The buffer holds a chunk of records, or as many as fit if they're too big
+		if (records > SIZE_MAX / record) records = SIZE_MAX / record;
+		char* buf = (char*)malloc(records * record);
+
+		for (size_t read = 1; buf && read > 0; ) {
+
+			read = fread(buf, record, records, file);
+			for (size_t i = 0; i < read; i++) {
+
+				const char* r = buf + i * record;
+				int weight = 1;
+
+				if (weighted) memcpy(&weight, r + 2 * b->element_size, sizeof(int));
+				gb_add_arch(b, r, r + b->element_size, weight);
+			}
+			added += read;
+		}
+		free(buf);
+	}
+	return added;
+}
+
+/**
+ * Passes the last chunk to the graph, builds its compressed rows using (at most)
+ * the given number of threads and returns it, the graph belongs to the caller
+ *
+ * The builder starts again with an empty graph, so it can be reused (or deleted)
+ */
+graph* gb_finish(graph_builder* b, size_t threads) {
+
+	graph* g = NULL;
+
+	if (b && b->g) {
+
+		gb_util_flush(b);
+		graph_build_parallel(b->g, threads);
+
+		g = b->g;
+		b->g = graph_create(b->element_size, b->flags);
+	}
+	return g;
+}
+
+/* Utility function used to pass the collected arches to the graph */
+void gb_util_flush(graph_builder* b) {
+
+	graph_insert_arches(b->g, b->from, b->to, b->weights, b->count);
+	b->count = 0;
+	return;
+}
+
+#endif
\ No newline at end of file
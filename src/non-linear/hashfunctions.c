@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/hashfunctions.h"
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/* Default secret of wyhash */
+static const uint64_t WYHASH_SECRET[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+/* Primes used by xxHash64 */
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+/* Utility functions used to read (unaligned) little endian words and combine them */
+uint64_t hash_util_read64(const uint8_t* p);
+uint64_t hash_util_read32(const uint8_t* p);
+uint64_t hash_util_rotl64(uint64_t x, int r);
+void hash_util_mum(uint64_t* a, uint64_t* b);
+uint64_t hash_util_wymix(uint64_t a, uint64_t b);
+uint64_t hash_util_xxh64_round(uint64_t acc, uint64_t input);
+uint64_t hash_util_xxh64_merge(uint64_t acc, uint64_t val);
+
+/**
+ * wyhash, fast hash that processes 16/48 bytes per step through 64x64 -> 128 bit multiplications
+ *
+ * Used by default by the hashmap
+ */
+size_t hash_util_wyhash(const void* key, size_t len, uint64_t seed) {
+
+	const uint8_t* p = (const uint8_t*)key;
+	uint64_t a = 0, b = 0;
+
+	seed ^= hash_util_wymix(seed ^ WYHASH_SECRET[0], WYHASH_SECRET[1]);
+
+	// Short keys are read with (possibly overlapping) 4 bytes words
+	if (len <= 16) {
+
+		if (len >= 4) {
+
+			a = (hash_util_read32(p) << 32) | hash_util_read32(p + ((len >> 3) << 2));
+			b = (hash_util_read32(p + len - 4) << 32) | hash_util_read32(p + len - 4 - ((len >> 3) << 2));
+		}
+		else if (len > 0) {
+
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+		}
+	}
+	else {
+
+		size_t i = len;
+
+		// Three independent lanes for long keys
+		if (i >= 48) {
+
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = hash_util_wymix(hash_util_read64(p) ^ WYHASH_SECRET[1], hash_util_read64(p + 8) ^ seed);
+				see1 = hash_util_wymix(hash_util_read64(p + 16) ^ WYHASH_SECRET[2], hash_util_read64(p + 24) ^ see1);
+				see2 = hash_util_wymix(hash_util_read64(p + 32) ^ WYHASH_SECRET[3], hash_util_read64(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i >= 48);
+			seed ^= see1 ^ see2;
+		}
+
+		while (i > 16) {
+
+			seed = hash_util_wymix(hash_util_read64(p) ^ WYHASH_SECRET[1], hash_util_read64(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+
+		// The last 16 bytes (overlapping the ones already read if needed)
+		a = hash_util_read64(p + i - 16);
+		b = hash_util_read64(p + i - 8);
+	}
+
+	a ^= WYHASH_SECRET[1];
+	b ^= seed;
+	hash_util_mum(&a, &b);
+
+	return (size_t)hash_util_wymix(a ^ WYHASH_SECRET[0] ^ len, b ^ WYHASH_SECRET[1]);
+}
+
+/**
+ * xxHash64, processes 32 bytes per step in four independent lanes
+ */
+size_t hash_util_xxh64(const void* key, size_t len, uint64_t seed) {
+
+	const uint8_t* p = (const uint8_t*)key;
+	const uint8_t* end = p + len;
+	uint64_t h;
+
+	if (len >= 32) {
+
+		uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+		uint64_t v2 = seed + XXH_PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - XXH_PRIME64_1;
+
+		do {
+			v1 = hash_util_xxh64_round(v1, hash_util_read64(p));
+			v2 = hash_util_xxh64_round(v2, hash_util_read64(p + 8));
+			v3 = hash_util_xxh64_round(v3, hash_util_read64(p + 16));
+			v4 = hash_util_xxh64_round(v4, hash_util_read64(p + 24));
+			p += 32;
+		} while (p + 32 <= end);
+
+		h = hash_util_rotl64(v1, 1) + hash_util_rotl64(v2, 7) + hash_util_rotl64(v3, 12) + hash_util_rotl64(v4, 18);
+		h = hash_util_xxh64_merge(h, v1);
+		h = hash_util_xxh64_merge(h, v2);
+		h = hash_util_xxh64_merge(h, v3);
+		h = hash_util_xxh64_merge(h, v4);
+	}
+	else {
+
+		h = seed + XXH_PRIME64_5;
+	}
+
+	h += (uint64_t)len;
+
+	// Remaining bytes, 8, then 4, then 1 at a time
+	for (; p + 8 <= end; p += 8) {
+
+		h ^= hash_util_xxh64_round(0, hash_util_read64(p));
+		h = hash_util_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	}
+	if (p + 4 <= end) {
+
+		h ^= hash_util_read32(p) * XXH_PRIME64_1;
+		h = hash_util_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	for (; p < end; p++) {
+
+		h ^= (*p) * XXH_PRIME64_5;
+		h = hash_util_rotl64(h, 11) * XXH_PRIME64_1;
+	}
+
+	// Final avalanche
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+
+	return (size_t)h;
+}
+
+/**
+ * djb2 (hash * 33 + c), simple byte at a time hash
+ */
+size_t hash_util_djb2(const void* key, size_t len, uint64_t seed) {
+
+	const uint8_t* p = (const uint8_t*)key;
+	size_t hash = 5381 ^ (size_t)seed;
+
+	for (size_t i = 0; i < len; i++) hash = ((hash << 5) + hash) + p[i]; /* hash * 33 + c */
+
+	return hash;
+}
+
+/**
+ * Default hash function, used for the position of the keys
+ */
+size_t hash_util_default_hash(const void* key, size_t len, uint64_t seed) {
+
+	return hash_util_wyhash(key, len, seed);
+}
+
+/**
+ * Default second hash function, independent from the first one
+ * (same key and seed produce unrelated values)
+ */
+size_t hash_util_default_second_hash(const void* key, size_t len, uint64_t seed) {
+
+	return hash_util_xxh64(key, len, seed);
+}
+
+/**
+ * Returns a seed that is different for every call and every run of the program
+ */
+uint64_t hash_util_random_seed(void) {
+
+	static uint64_t counter = 0;
+	int on_stack = 0;
+
+	// Mix time, address space layout and a counter, then scramble them (splitmix64)
+	uint64_t x = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32) ^ (uint64_t)(uintptr_t)&on_stack;
+	x += 0x9E3779B97F4A7C15ULL * ++counter;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+	return x ^ (x >> 31);
+}
+
+/* Utility function that reads 8 little endian bytes */
+uint64_t hash_util_read64(const uint8_t* p) {
+
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+		((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+/* Utility function that reads 4 little endian bytes */
+uint64_t hash_util_read32(const uint8_t* p) {
+
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24);
+}
+
+/* Utility function that rotates x to the left by r bits */
+uint64_t hash_util_rotl64(uint64_t x, int r) {
+
+	return (x << r) | (x >> (64 - r));
+}
+
+/* Utility function that computes the 128 bit product of a and b, low half in a and high half in b */
+void hash_util_mum(uint64_t* a, uint64_t* b) {
+
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	*a = _umul128(*a, *b, b);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+	return;
+}
+
+/* Utility function that folds the 128 bit product of a and b into 64 bits */
+uint64_t hash_util_wymix(uint64_t a, uint64_t b) {
+
+	hash_util_mum(&a, &b);
+	return a ^ b;
+}
+
+/* Utility function that consumes 8 bytes of input into an xxHash64 lane */
+uint64_t hash_util_xxh64_round(uint64_t acc, uint64_t input) {
+
+	acc += input * XXH_PRIME64_2;
+	acc = hash_util_rotl64(acc, 31);
+	return acc * XXH_PRIME64_1;
+}
+
+/* Utility function that merges an xxHash64 lane into the final hash */
+uint64_t hash_util_xxh64_merge(uint64_t acc, uint64_t val) {
+
+	acc ^= hash_util_xxh64_round(0, val);
+	return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
\ No newline at end of file
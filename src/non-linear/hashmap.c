@@ -6,18 +6,141 @@
  * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#ifndef HASHMAP_WITH_FLAT_TABLE
+
 #include "../../include/non-linear/hashmap.h"
+#include "../../include/non-linear/hashfunctions.h"
+#include "../../include/linear/snapshot.h"
 #include "../../include/linear/vector.h"
 #include "../../include/linear/bitset.h"
 #include <string.h>
 
-/* Hash function that transforms the string key into an unsigned integer */
-size_t hash_util_default_hash(const char* key);
-size_t hash_util_default_second_hash(const char* key);
+/* Load factor used by newly created hashmaps, (live + deleted slots) / capacity above which a rehash starts */
+#define HASH_DEFAULT_MAX_LOAD 0.75
+
+/* Number of slots of the old table that get migrated by each operation, while a rehash is in progress */
+#define HASH_REHASH_STEP 16
+
+/* Slots are padded to a multiple of this, so that the header and the values returned by hash_get are aligned */
+#define HASH_SLOT_ALIGNMENT 8
+
+/* Number of keys whose hashes are computed and prefetched together by the batch functions */
+#define HASH_BATCH_SIZE 16
+
+/* Interned keys up to this long are stored in the slot (followed by a NUL), the longer ones in the arena of the table */
+#define HASH_INLINE_KEY_LENGTH 15
+#define HASH_INLINE_KEY_SIZE (HASH_INLINE_KEY_LENGTH + 1)
+
+/* Initial size (in bytes) of the arena of a table that interns its keys */
+#define HASH_ARENA_MIN_SIZE 256
+
+/* Records the length of a probe sequence, nothing without CDS_WITH_STATS */
+#define HASH_COUNT_PROBE(hash, length) (STATS_INC((hash)->lookups), STATS_ADD((hash)->probes, (length)), STATS_MAX((hash)->max_probe, (length)))
+
+/* Hint the processor to start loading the cache line of addr, without waiting for it */
+#if defined(__GNUC__) || defined(__clang__)
+#define HASH_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define HASH_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define HASH_PREFETCH(addr) ((void)(addr))
+#endif
+
+/**
+ * Header stored at the start of every slot, the value follows it
+ *
+ * Both hashes are cached, so that comparisons can discard a slot
+ * without reading the key and rehashing never needs to hash again
+ */
+typedef struct hash_slot {
+
+	/* Pointer to the key bytes, or the offset of an interned key in the arena of its table
+	 * (unused for the interned keys stored in the slot, after the value)
+	 */
+	union {
+		const void* key;
+		size_t key_offset;
+	};
+
+	/* Number of bytes of the key */
+	size_t key_length;
+
+	/* Hash of the key, used for the position */
+	size_t hash;
+
+	/* Second hash of the key, used for the probe step */
+	size_t second_hash;
+} hash_slot;
+
+/**
+ * Struct that represent a single open addressing table
+ *
+ * A slot can be in three states:
+ *   empty -> neither occupied nor deleted, ends every probe sequence
+ *   occupied -> holds a couple <key, value>
+ *   deleted -> (tombstone) held a couple that was removed, probe sequences continue past it
+ */
+typedef struct hash_table {
+
+	/* Array of slots, each one holds the slot header followed by the value */
+	vector* slots;
+
+	/* Bitset used to determine if a slot in the vector is occupied or not (could be 0 but 0 is the actual element) */
+	bitset* occupied;
+
+	/* Bitset used to mark the slots whose couple was removed (tombstones) */
+	bitset* deleted;
+
+	/* Number of occupied slots */
+	size_t count;
+
+	/* Number of deleted slots */
+	size_t deleted_count;
+
+	/* Arena the long interned keys of the table are copied in, one after the other (NULL if the keys aren't interned)
+	 * Removed keys are left where they are, they're dropped when the couples are migrated into the next table
+	 */
+	vector* keys;
+} hash_table;
+
+/* Utility function used to create an hashmap, that either interns its keys or stores the given pointers */
+hashmap* hash_util_create(size_t capacity, size_t element_size, bool interned);
+
+/* Utility functions used to manage the tables of the hashmap */
+hash_table* hash_util_table_create(size_t capacity, size_t slot_size, bool interned);
+void hash_util_table_delete(hash_table** t);
+void hash_util_table_free_keys(hash_table* t);
+size_t hash_util_table_find(hashmap* hash, hash_table* t, const void* key, size_t len, size_t h, size_t h2);
+bool hash_util_table_insert(hashmap* hash, hash_table* t, hash_slot* header, const void* key, void* value);
+void hash_util_table_remove_at(hash_table* t, size_t index);
+void hash_util_rehash_start(hashmap* hash);
+void hash_util_rehash_step(hashmap* hash, size_t steps);
+void hash_util_rehash_finish(hashmap* hash);
+size_t hash_util_round_capacity(size_t capacity);
+void hash_util_compute(hashmap* hash, const void* key, size_t len, size_t* h, size_t* h2);
+hash_slot* hash_util_lookup(hashmap* hash, const void* key, size_t len, size_t h, size_t h2, hash_table** where, size_t* index);
+void hash_util_put(hashmap* hash, const void* key, size_t len, size_t h, size_t h2, void* value);
+void hash_util_remove(hashmap* hash, const void* key, size_t len, size_t h, size_t h2);
+void hash_util_batch_prepare(hashmap* hash, const char** keys, const size_t* lengths, size_t n, size_t* len, size_t* h, size_t* h2);
+
+/* Utility functions used to copy an interned key in a slot (or the arena of its table) and to get the bytes of the key of a slot */
+bool hash_util_intern(hashmap* hash, vector* arena, hash_slot* slot, const void* key, size_t len);
+const void* hash_util_slot_key(hashmap* hash, vector* arena, hash_slot* slot);
+
+/**
+ * Descriptor of the snapshot of an hashmap, the couples are stored in a single table
+ */
+typedef struct hash_snapshot {
+
+	uint64_t element_size;
+	uint64_t table;
+} hash_snapshot;
+
  /**
   * Struct that represent an hashmap, mapping keys into values
   *
-  * keys are strings
+  * keys are sequences of bytes (strings or any other data)
   * values are of generic type
   */
 typedef struct hashmap {
@@ -31,53 +154,117 @@ typedef struct hashmap {
 	 * in unallocated memory (or, still, memory that isn't 'ours')
 	 */
 
-	/* Array of generic type of values */
-	vector* values;
+	/* Table in which new couples are inserted */
+	hash_table* table;
 
-	/* Bitset used to determine if an element in the vector is occupied or not (could be 0 but 0 is the actual element) */
-	bitset* occupied;
+	/* Table that is being migrated into 'table' during an incremental rehash, NULL otherwise */
+	hash_table* old_table;
+
+	/* Next slot of the old table that has to be migrated */
+	size_t rehash_index;
+
+	/* Size of the values stored in the hashmap */
+	size_t element_size;
+
+	/* Size of each slot, header + value + padding (+ the short interned keys) */
+	size_t slot_size;
+
+	/* Whether the keys are copied by the hashmap (see hash_create_interned) or the pointers given are stored */
+	bool interned;
+
+	/* Maximum ratio between used (occupied + deleted) slots and capacity, before rehashing */
+	double max_load;
+
+	/* Seed given to the hash functions, random for every hashmap */
+	uint64_t seed;
 
 	/* Hash function, can be specified */
-	size_t(*hash_func)(const char*);
+	size_t(*hash_func)(const void*, size_t, uint64_t);
+
+	/* second hash function, can be specified, used for collisions (NULL means it is derived from the first hash) */
+	size_t(*second_hash)(const void*, size_t, uint64_t);
 
-	/* second hash function, can be specified, used for collisions */
-	size_t(*second_hash)(const char*);
+	/* Snapshot the couples are read from (see hash_open_mmap) and its table, NULL if
+	 * they're in memory. Mapped hashmaps are read-only, so every function that would
+	 * modify them leaves them unchanged
+	 */
+	snapshot* mapping;
+	snapshot_table image;
+
+#ifdef CDS_WITH_STATS
+	/* Probe sequences walked, their total and maximum length, and tables rebuilt */
+	size_t lookups;
+	size_t probes;
+	size_t max_probe;
+	size_t rehashes;
+#endif
 } hashmap;
 
 /**
  * Creates an hashmap that stores values that are as big as element_size
- * and can store at most capacity elements
+ * starting with room for at least capacity elements
+ *
+ * The capacity is rounded up to a power of two and grows automatically
  */
 hashmap* hash_create(size_t capacity, size_t element_size) {
 
+	return hash_util_create(capacity, element_size, false);
+}
+
+/**
+ * Creates an hashmap that stores values that are as big as element_size
+ * starting with room for at least capacity elements, and that keeps its own copy of the keys
+ *
+ * Keys up to 15 bytes are stored in their slot, the longer ones are appended to an arena,
+ * so inserting never allocates a key on its own and the callers keep (and free) the keys they pass
+ * The arena is compacted by rehashing, the keys of the removed couples are dropped then
+ */
+hashmap* hash_create_interned(size_t capacity, size_t element_size) {
+
+	return hash_util_create(capacity, element_size, true);
+}
+
+/* Utility function that creates an hashmap, with the slots sized for the interned keys if needed */
+hashmap* hash_util_create(size_t capacity, size_t element_size, bool interned) {
+
 	hashmap* hash = NULL;
 
-	if (0 < capacity && 0 < element_size && capacity <= SIZE_MAX/element_size) {
-	
-		hash = (hashmap*)malloc(sizeof(hashmap));
-		if (hash) {
+	if (0 < capacity && 0 < element_size && element_size <= SIZE_MAX - sizeof(hash_slot) - HASH_INLINE_KEY_SIZE - HASH_SLOT_ALIGNMENT) {
+
+		size_t slot_size = (sizeof(hash_slot) + element_size + (interned ? HASH_INLINE_KEY_SIZE : 0) + HASH_SLOT_ALIGNMENT - 1) / HASH_SLOT_ALIGNMENT * HASH_SLOT_ALIGNMENT;
+
+		capacity = hash_util_round_capacity(capacity);
+		if (0 < capacity && capacity <= SIZE_MAX / slot_size) {
 
-			hash->values = vec_create(capacity, sizeof(const char*) + element_size);
-			if (hash->values) {
+			hash = (hashmap*)malloc(sizeof(hashmap));
+			if (hash) {
 
-				hash->occupied = bitset_create(capacity);
-				if (hash->occupied) {
+				hash->table = hash_util_table_create(capacity, slot_size, interned);
+				if (hash->table) {
 
+					hash->old_table = NULL;
+					hash->rehash_index = 0;
+					hash->element_size = element_size;
+					hash->slot_size = slot_size;
+					hash->interned = interned;
+					hash->max_load = HASH_DEFAULT_MAX_LOAD;
+					hash->seed = hash_util_random_seed();
 					hash->hash_func = *hash_util_default_hash;
-					hash->hash_func = *hash_util_default_second_hash;
+					hash->second_hash = NULL;
+					hash->mapping = NULL;
+#ifdef CDS_WITH_STATS
+					hash->lookups = 0;
+					hash->probes = 0;
+					hash->max_probe = 0;
+					hash->rehashes = 0;
+#endif
 				}
 				else {
 
-					vec_delete(&hash->values);
 					free(hash);
 					hash = NULL;
 				}
 			}
-			else {
-
-				free(hash);
-				hash = NULL;
-			}
 		}
 	}
 	return hash;
@@ -85,14 +272,18 @@ hashmap* hash_create(size_t capacity, size_t element_size) {
 
 /**
  * Deletes the given hashmap
+ *
+ * The keys still stored in the hashmap are freed aswell (unless they're interned)
  */
 void hash_delete(hashmap** hash) {
 
 	if (hash && *hash) {
-	
-		vec_delete(&(*hash)->values);
-		bitset_delete(&(*hash)->occupied);
-		memset(*hash, 0, sizeof(hash));
+
+		// The couples of mapped hashmaps are released by unmapping the snapshot
+		if ((*hash)->mapping) snapshot_util_close(&(*hash)->mapping);
+		else hash_clear(*hash);
+		hash_util_table_delete(&(*hash)->table);
+		memset(*hash, 0, sizeof(hashmap));
 		free(*hash);
 		*hash = NULL;
 	}
@@ -100,86 +291,137 @@ void hash_delete(hashmap** hash) {
 }
 
 /**
- * Inserts a couple <key, value>
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
  */
 void hash_put(hashmap* hash, const char* key, void* value) {
 
-	if (hash && key) {
+	if (key) hash_put_n(hash, key, strlen(key), value);
+	return;
+}
 
-		// Proceed if not full
-		if (bitset_count(hash->occupied) < bitset_get_size(hash->occupied)) {
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * If the key is already present its value is replaced, the old key
+ * is freed (unless it is the same pointer) and the new one is stored
+ */
+void hash_put_n(hashmap* hash, const void* key, size_t len, void* value) {
 
-			size_t index = hash->hash_func(key) % hash_get_capacity(hash);
-			size_t step = hash->second_hash(key);
+	if (hash && key && value && !hash->mapping) {
 
+		size_t h, h2;
+		hash_util_compute(hash, key, len, &h, &h2);
+		hash_util_put(hash, key, len, h, h2, value);
+	}
+	return;
+}
 
-			size_t max_iterations = hash_get_capacity(hash);
+/**
+ * Removes the element mapped by key (NUL terminated string)
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
+ */
+void hash_remove(hashmap* hash, const char* key) {
 
-			for (size_t i = 0; i < max_iterations; i++) {
+	if (key) hash_remove_n(hash, key, strlen(key));
+	return;
+}
 
-				// If the position is free
-				if (!bitset_get(hash->occupied, index)) {
+/**
+ * Removes the element mapped by the len bytes pointed to by key
+ *
+ * The slot is marked as deleted (tombstone) so that the probe
+ * sequences of the other keys are not broken
+ */
+void hash_remove_n(hashmap* hash, const void* key, size_t len) {
 
-					// Insert the couple <key, value>
-					void* to_insert = malloc(sizeof(const char*) + hash_get_element_size(hash));
-					if (to_insert) {
+	if (hash && key && !hash->mapping) {
 
-						// The first part of the memory will be used to store the pointer to key
-						memcpy((char*)to_insert, &key, sizeof(const char*));
+		size_t h, h2;
+		hash_util_compute(hash, key, len, &h, &h2);
+		hash_util_remove(hash, key, len, h, h2);
+	}
+	return;
+}
 
-						// The second part to store the actual value
-						memcpy((char*)to_insert + sizeof(const char*), value, hash_get_element_size(hash));
+/**
+ * Returns the value mapped by key (NUL terminated string)
+ */
+void* hash_get(hashmap* hash, const char* key) {
 
-						vec_insert_at(hash->values, to_insert, index);
-						bitset_set(hash->occupied, i);
-					}
+	return key ? hash_get_n(hash, key, strlen(key)) : NULL;
+}
 
-					break;
-				}
+/**
+ * Returns the value mapped by the len bytes pointed to by key
+ */
+void* hash_get_n(hashmap* hash, const void* key, size_t len) {
 
-				index = (index + step) % hash_get_capacity(hash);
-			}
-		}
+	void* val = NULL;
+
+	if (hash && key && hash->mapping) val = (void*)snapshot_util_find(&hash->image, key, len, hash_util_wyhash(key, len, hash->image.seed));
+	else if (hash && key) {
+
+		size_t h, h2;
+		hash_util_compute(hash, key, len, &h, &h2);
+
+		hash_table* t = NULL;
+		size_t index = 0;
+		hash_slot* slot = hash_util_lookup(hash, key, len, h, h2, &t, &index);
+
+		if (slot) val = (void*)((char*)slot + sizeof(hash_slot));
 	}
-	return;
+	return val;
 }
 
 /**
- * Removes the element mapped by key
+ * Copies the value mapped by key (NUL terminated string) into buf
  */
-void hash_remove(hashmap* hash, const char* key) {
+void hash_get_2(hashmap* hash, const char* key, void* buf) {
 
-	if (hash && key) {
+	if (key) hash_get_2_n(hash, key, strlen(key), buf);
+	return;
+}
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf
+ */
+void hash_get_2_n(hashmap* hash, const void* key, size_t len, void* buf) {
 
-		// Proceed if the map is not empty
-		if (bitset_count(hash->occupied) > 0) {
+	if (hash && key && buf) {
 
-			size_t index = hash->hash_func(key) % hash_get_capacity(hash);
-			size_t step = hash->second_hash(key);
+		void* val = hash_get_n(hash, key, len);
+		if (val) memcpy(buf, val, hash->element_size);
+	}
+	return;
+}
 
+/**
+ * Inserts n couples <keys[i], value i>, values points to n contiguous elements
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
+ */
+void hash_put_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void* values) {
 
-			size_t max_iterations = hash_get_capacity(hash);
+	if (hash && keys && values && !hash->mapping) {
 
-			for (size_t i = 0; i < max_iterations; i++) {
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE], h2[HASH_BATCH_SIZE];
 
-				// If the position is ocuupied
-				if (bitset_get(hash->occupied, index)) {
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
 
-					// Geyt the couple <key, value>
-					void* read = vec_get_at(hash->values, index);
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h, h2);
 
-					// If the key is the one we were looking for
-					char* read_key = *(char**)read;
-					if (strncmp(read_key, key, strlen(key)) == 0) {
+			for (size_t i = 0; i < batch; i++) {
 
-						// Remove the couple
-						vec_remove_at(hash->values, index);
-						free(read_key);
-						bitset_unset(hash->occupied, index);
-						break;
-					}
-				}
-				index = (index + step) % hash_get_capacity(hash);
+				if (keys[base + i]) hash_util_put(hash, keys[base + i], len[i], h[i], h2[i], (char*)values + (base + i) * hash->element_size);
 			}
 		}
 	}
@@ -187,75 +429,65 @@ void hash_remove(hashmap* hash, const char* key) {
 }
 
 /**
- * Returns the value mapped by key
+ * Removes the elements mapped by the n given keys
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved
  */
-void* hash_get(hashmap* hash, const char* key) {
-
-	void* val = NULL;
-
-	if (hash && key) {
-
-		// Proceed if the map is not empty
-		if (bitset_count(hash->occupied) > 0) {
+void hash_remove_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n) {
 
-			size_t index = hash->hash_func(key) % hash_get_capacity(hash);
-			size_t step = hash->second_hash(key);
+	if (hash && keys && !hash->mapping) {
 
-			size_t max_iterations = hash_get_capacity(hash);
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE], h2[HASH_BATCH_SIZE];
 
-			for (size_t i = 0; i < max_iterations; i++) {
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
 
-				// If the position is ocuupied
-				if (bitset_get(hash->occupied, index)) {
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h, h2);
 
-					// Geyt the couple <key, value>
-					void* read = vec_get_at(hash->values, index);
+			for (size_t i = 0; i < batch; i++) {
 
-					// If the key is the one we were looking for
-					char* read_key = *(char**)read;
-					if (strncmp(read_key, key, strlen(key)) == 0) {
-
-						val = (void*)((char*)read + sizeof(const char*));
-						break;
-					}
-				}
-				index = (index + step) % hash_get_capacity(hash);
+				if (keys[base + i]) hash_util_remove(hash, keys[base + i], len[i], h[i], h2[i]);
 			}
 		}
 	}
-	return val;
+	return;
 }
 
 /**
- * Copies the value mapped by key into buf
+ * Looks up n keys at once, values[i] is set to the value mapped by keys[i] (NULL if absent)
+ *
+ * If lengths is NULL the keys are NUL terminated strings, otherwise
+ * the i -th key is made of lengths[i] bytes
+ * Every key is hashed and its slot prefetched before any probe is resolved,
+ * so that the cache misses of the batch overlap instead of being paid one after the other
  */
-void hash_get_2(hashmap* hash, const char* key, void* buf) {
+void hash_get_many(hashmap* hash, const char** keys, const size_t* lengths, size_t n, void** values) {
 
-	if (hash && key) {
-
-		size_t index = hash->hash_func(key) % hash_get_capacity(hash);
-		size_t step = hash->second_hash(key);
+	// Mapped tables are probed one key at a time
+	if (hash && keys && values && hash->mapping) {
 
+		for (size_t i = 0; i < n; i++) values[i] = keys[i] ? hash_get_n(hash, keys[i], lengths ? lengths[i] : strlen(keys[i])) : NULL;
+	}
+	else if (hash && keys && values) {
 
-		size_t max_iterations = hash_get_capacity(hash);
+		size_t len[HASH_BATCH_SIZE], h[HASH_BATCH_SIZE], h2[HASH_BATCH_SIZE];
 
-		for (size_t i = 0; i < max_iterations; i++) {
+		for (size_t base = 0; base < n; base += HASH_BATCH_SIZE) {
 
-			// If the position is ocuupied
-			if (bitset_get(hash->occupied, index)) {
+			size_t batch = n - base < HASH_BATCH_SIZE ? n - base : HASH_BATCH_SIZE;
+			hash_util_batch_prepare(hash, keys + base, lengths ? lengths + base : NULL, batch, len, h, h2);
 
-				// Geyt the couple <key, value>
-				void* read = vec_get_at(hash->values, index);
+			// By now the home slots of the batch are (most likely) in cache
+			for (size_t i = 0; i < batch; i++) {
 
-				// If the key is the one we were looking for
-				char* read_key = *(char**)read;
-				if (strncmp(read_key, key, strlen(key)) == 0) {
+				hash_table* t = NULL;
+				size_t index = 0;
+				hash_slot* slot = keys[base + i] ? hash_util_lookup(hash, keys[base + i], len[i], h[i], h2[i], &t, &index) : NULL;
 
-					memcpy(buf, (char*)read + sizeof(const char*), hash_get_element_size(hash));
-					break;
-				}
+				values[base + i] = slot ? (void*)((char*)slot + sizeof(hash_slot)) : NULL;
 			}
-			index = (index + step) % hash_get_capacity(hash);
 		}
 	}
 	return;
@@ -264,10 +496,29 @@ void hash_get_2(hashmap* hash, const char* key, void* buf) {
 /**
  * Removes all the values in the hashmap
  * the struct itself is preserved
+ *
+ * The stored keys are freed
  */
 void hash_clear(hashmap* hash) {
 
-	if (hash) vec_clear(hash->values);
+	if (hash && !hash->mapping) {
+
+		// Any pending migration is dropped altogether
+		if (hash->old_table) {
+
+			hash_util_table_free_keys(hash->old_table);
+			hash_util_table_delete(&hash->old_table);
+			hash->rehash_index = 0;
+		}
+
+		hash_util_table_free_keys(hash->table);
+		vec_clear(hash->table->slots);
+		if (hash->table->keys) vec_resize(hash->table->keys, 0);
+		bitset_unset_full(hash->table->occupied);
+		bitset_unset_full(hash->table->deleted);
+		hash->table->count = 0;
+		hash->table->deleted_count = 0;
+	}
 	return;
 }
 
@@ -276,7 +527,16 @@ void hash_clear(hashmap* hash) {
  */
 size_t hash_get_capacity(hashmap* hash) {
 
-	return hash ? vec_get_size(hash->values) : 0;
+	return hash ? (hash->mapping ? hash->image.capacity : vec_get_size(hash->table->slots)) : 0;
+}
+
+/**
+ * Returns the number of couples stored in the hashmap
+ */
+size_t hash_get_size(hashmap* hash) {
+
+	if (hash && hash->mapping) return hash->image.count;
+	return hash ? hash->table->count + (hash->old_table ? hash->old_table->count : 0) : 0;
 }
 
 /**
@@ -284,44 +544,602 @@ size_t hash_get_capacity(hashmap* hash) {
  */
 size_t hash_get_element_size(hashmap* hash) {
 
-	return hash ? vec_get_element_size(hash->values) : 0;
+	return hash ? hash->element_size : 0;
 }
 
-/* Hash function that transforms the string key into an unsigned integer */
-size_t hash_util_default_hash(const char* key) {
+/**
+ * Sets the maximum load factor, that is the maximum ratio between
+ * used (occupied and deleted) slots and capacity, above which the
+ * hashmap is rehashed into a bigger table
+ *
+ * The value has to be between 0 and 1 (both excluded), otherwise the call is ignored
+ */
+void hash_set_max_load(hashmap* hash, double max_load) {
 
-	size_t hash = 5381;
-	int c;
-	while (c = *key++) hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+	if (hash && 0.0 < max_load && max_load < 1.0) hash->max_load = max_load;
+	return;
+}
 
-	return hash;
+/**
+ * Returns the maximum load factor of the hashmap
+ */
+double hash_get_max_load(hashmap* hash) {
+
+	return hash ? hash->max_load : 0.0;
 }
-size_t hash_util_default_second_hash(const char* key) {
 
-	size_t hash = 1431655765;
+/**
+ * Checks whether or not an incremental rehash is in progress
+ *
+ * While rehashing, each operation moves a few couples from
+ * the old table to the new one, so that no single insertion pays for the whole rehash
+ */
+bool hash_is_rehashing(hashmap* hash) {
 
-	while (*key) {
-		hash ^= *key++;
-		hash = (hash << 5) + hash;
-	}
+	return hash ? hash->old_table != NULL : false;
+}
+
+/**
+ * Copies in stats the counters of the hashmap
+ *
+ * Probe lengths are counted in slots by the default engine and in groups of 16 slots by the flat one,
+ * lookups, probes and rehashes stay at zero unless the library is built with CDS_WITH_STATS
+ */
+void hash_get_stats(hashmap* hash, hash_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(hash_stats));
+		stats->enabled = STATS_ENABLED;
+
+		if (hash && hash->mapping) {
+
+			stats->count = hash->image.count;
+			stats->capacity = hash->image.capacity;
+		}
+		else if (hash) {
+
+			stats->count = hash_get_size(hash);
+			stats->capacity = vec_get_size(hash->table->slots) + (hash->old_table ? vec_get_size(hash->old_table->slots) : 0);
+			stats->tombstones = hash->table->deleted_count + (hash->old_table ? hash->old_table->deleted_count : 0);
+		}
+
+		// Averages are computed here, so that lookups only pay for the sums
+		stats->load = stats->capacity ? (double)(stats->count + stats->tombstones) / (double)stats->capacity : 0;
+#ifdef CDS_WITH_STATS
+		if (hash) {
 
-	return 0;
+			stats->lookups = hash->lookups;
+			stats->probes = hash->probes;
+			stats->max_probe = hash->max_probe;
+			stats->rehashes = hash->rehashes;
+			stats->average_probe = hash->lookups ? (double)hash->probes / (double)hash->lookups : 0;
+		}
+#endif
+	}
+	return;
 }
 
 /**
  * Sets a custom hash function
+ *
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
  */
-void hash_set_function(hashmap* hash, size_t (*map)(const char*)) {
+void hash_set_function(hashmap* hash, size_t (*map)(const void*, size_t, uint64_t)) {
 
-	if (hash && map) hash->hash_func = map;
+	if (hash && map && !hash_get_size(hash)) hash->hash_func = map;
 	return;
 }
 
 /**
- * Sets a custom hash function
+ * Sets a custom second hash function, used to determine the probe step
+ *
+ * NULL (the default) derives the step from the first hash, without hashing the key twice
+ * Since the position of every key depends on it, it can
+ * only be changed while the hashmap is empty
  */
-void hash_set_second_function(hashmap* hash, size_t(*map2)(const char*)) {
+void hash_set_second_function(hashmap* hash, size_t(*map2)(const void*, size_t, uint64_t)) {
 
-	if (hash && map2) hash->hash_func = map2;
+	if (hash && !hash_get_size(hash)) hash->second_hash = map2;
 	return;
-}
\ No newline at end of file
+}
+
+/**
+ * Sets the seed given to the hash functions
+ *
+ * Every hashmap starts with a random seed, so that a given set of keys
+ * can't be crafted to collide, this can be used to get reproducible layouts
+ * It can only be changed while the hashmap is empty
+ */
+void hash_set_seed(hashmap* hash, uint64_t seed) {
+
+	if (hash && !hash_get_size(hash)) hash->seed = seed;
+	return;
+}
+
+/**
+ * Returns the seed given to the hash functions
+ */
+uint64_t hash_get_seed(hashmap* hash) {
+
+	return hash ? hash->seed : 0;
+}
+
+/**
+ * Writes the couples of the hashmap in a snapshot in the given file (which is replaced)
+ *
+ * The snapshot doesn't depend on the engine nor on the hash function of the hashmap,
+ * it can be mapped back by hash_open_mmap, true is returned if it was written entirely
+ */
+bool hash_save(hashmap* hash, const char* path) {
+
+	bool saved = false;
+	snapshot_writer w;
+	size_t n = hash_get_size(hash);
+	snapshot_entry* entries = hash ? (snapshot_entry*)malloc((n + 1) * sizeof(snapshot_entry)) : NULL;
+
+	if (entries && path && snapshot_util_begin(&w, path, SNAPSHOT_HASHMAP, sizeof(hash_snapshot))) {
+
+		size_t count = 0;
+
+		// Couples of a mapped hashmap are taken from its table
+		if (hash->mapping) {
+
+			for (size_t i = 0; i < hash->image.capacity && count < n; i++) {
+
+				const snapshot_slot* slot = &hash->image.slots[i];
+				if (slot->key != SNAPSHOT_EMPTY) {
+
+					entries[count].key = hash->image.base + slot->key;
+					entries[count].key_length = (size_t)slot->key_length;
+					entries[count].value = hash->image.base + slot->value;
+					count++;
+				}
+			}
+		}
+
+		// During a rehash the couples are split between the two tables
+		for (int which = 0; which < 2 && !hash->mapping; which++) {
+
+			hash_table* t = which == 0 ? hash->table : hash->old_table;
+			for (size_t i = 0; t && t->count > 0 && i < vec_get_size(t->slots); i++) {
+
+				if (bitset_get(t->occupied, i)) {
+
+					hash_slot* slot = (hash_slot*)vec_get_at(t->slots, i);
+					entries[count].key = hash_util_slot_key(hash, t->keys, slot);
+					entries[count].key_length = slot->key_length;
+					entries[count].value = (char*)slot + sizeof(hash_slot);
+					count++;
+				}
+			}
+		}
+
+		// The table is always hashed by wyhash, since the function of the hashmap could be different in another process
+		hash_snapshot descriptor;
+		descriptor.element_size = hash->element_size;
+		descriptor.table = snapshot_util_write_table(&w, entries, count, hash->element_size, hash_util_wyhash, hash->mapping ? hash->image.seed : hash->seed, NULL);
+		saved = snapshot_util_end(&w, &descriptor, sizeof(hash_snapshot));
+	}
+	free(entries);
+	return saved;
+}
+
+/**
+ * Maps the snapshot written by hash_save in the given file, and returns an hashmap that looks keys up in place
+ *
+ * Nothing is copied or rehashed, so opening takes the same time whatever the number of couples, and
+ * only the pages that are read get loaded. The hashmap is read-only: the functions that would modify it
+ * leave it unchanged, and the values returned by hash_get must not be written. Deleting it unmaps the file
+ *
+ * NULL is returned if the file can't be mapped or doesn't hold the snapshot of an hashmap
+ */
+hashmap* hash_open_mmap(const char* path) {
+
+	hashmap* hash = NULL;
+	hash_snapshot descriptor;
+	snapshot* s = snapshot_util_open(path, SNAPSHOT_HASHMAP, &descriptor, sizeof(hash_snapshot));
+
+	if (s) {
+
+		snapshot_table image;
+		bool valid = snapshot_util_open_table(s, descriptor.table, &image) && descriptor.element_size > 0 && image.value_size == descriptor.element_size;
+
+		hash = valid ? (hashmap*)malloc(sizeof(hashmap)) : NULL;
+		if (hash) {
+
+			hash->table = NULL;
+			hash->old_table = NULL;
+			hash->rehash_index = 0;
+			hash->slot_size = 0;
+			hash->interned = false;
+			hash->element_size = image.value_size;
+			hash->max_load = HASH_DEFAULT_MAX_LOAD;
+			hash->seed = image.seed;
+			hash->hash_func = *hash_util_default_hash;
+			hash->second_hash = NULL;
+			hash->mapping = s;
+			hash->image = image;
+#ifdef CDS_WITH_STATS
+			hash->lookups = 0;
+			hash->probes = 0;
+			hash->max_probe = 0;
+			hash->rehashes = 0;
+#endif
+		}
+		else snapshot_util_close(&s);
+	}
+	return hash;
+}
+
+/* Utility function that creates an empty table with the given capacity (a power of two), with an arena if it interns its keys */
+hash_table* hash_util_table_create(size_t capacity, size_t slot_size, bool interned) {
+
+	hash_table* t = (hash_table*)malloc(sizeof(hash_table));
+	if (t) {
+
+		t->count = 0;
+		t->deleted_count = 0;
+		t->slots = vec_create(capacity, slot_size);
+		t->occupied = bitset_create(capacity);
+		t->deleted = bitset_create(capacity);
+		t->keys = interned ? vec_create(HASH_ARENA_MIN_SIZE, sizeof(char)) : NULL;
+
+		// If any allocation failed cancel the creation
+		if (!t->slots || !t->occupied || !t->deleted || (interned && !t->keys)) {
+
+			vec_delete(&t->slots);
+			bitset_delete(&t->occupied);
+			bitset_delete(&t->deleted);
+			vec_delete(&t->keys);
+			free(t);
+			t = NULL;
+		}
+	}
+	return t;
+}
+
+/* Utility function that deletes a table (the keys are not freed) */
+void hash_util_table_delete(hash_table** t) {
+
+	if (t && *t) {
+
+		vec_delete(&(*t)->slots);
+		bitset_delete(&(*t)->occupied);
+		bitset_delete(&(*t)->deleted);
+		vec_delete(&(*t)->keys);
+		free(*t);
+		*t = NULL;
+	}
+	return;
+}
+
+/* Utility function that frees every key stored in the table (interned keys belong to the table, there's nothing to free) */
+void hash_util_table_free_keys(hash_table* t) {
+
+	for (size_t i = 0; !t->keys && t->count > 0 && i < vec_get_size(t->slots); i++) {
+
+		if (bitset_get(t->occupied, i)) free((void*)((hash_slot*)vec_get_at(t->slots, i))->key);
+	}
+	return;
+}
+
+/* Utility function that returns the slot holding key inside t, or the table capacity if the key is not there */
+size_t hash_util_table_find(hashmap* hash, hash_table* t, const void* key, size_t len, size_t h, size_t h2) {
+
+	size_t capacity = vec_get_size(t->slots);
+	size_t found = capacity;
+
+	if (t->count > 0) {
+
+		// Capacity is a power of two, so any odd step visits every slot
+		size_t mask = capacity - 1;
+		size_t index = h & mask;
+		size_t step = (h2 | 1) & mask;
+		size_t i = 0;
+
+		for (; i < capacity; i++) {
+
+			// An empty slot ends the probe sequence
+			if (bitset_get(t->occupied, index)) {
+
+				// The cached hash and length discard almost every other key without reading it
+				hash_slot* slot = (hash_slot*)vec_get_at(t->slots, index);
+				if (slot->hash == h && slot->key_length == len && memcmp(hash_util_slot_key(hash, t->keys, slot), key, len) == 0) {
+
+					found = index;
+					break;
+				}
+			}
+			else if (!bitset_get(t->deleted, index)) {
+
+				break;
+			}
+			index = (index + step) & mask;
+		}
+		HASH_COUNT_PROBE(hash, i < capacity ? i + 1 : capacity);
+	}
+	return found;
+}
+
+/* Utility function that inserts a couple in t, assuming the key is not already present, false if the key couldn't be interned */
+bool hash_util_table_insert(hashmap* hash, hash_table* t, hash_slot* header, const void* key, void* value) {
+
+	size_t capacity = vec_get_size(t->slots);
+	size_t mask = capacity - 1;
+	size_t index = header->hash & mask;
+	size_t step = (header->second_hash | 1) & mask;
+	bool inserted = false;
+
+	// The first slot that is not occupied (either empty or deleted) is reused
+	for (size_t i = 0; i < capacity; i++) {
+
+		if (!bitset_get(t->occupied, index)) {
+
+			char* slot = (char*)vec_get_at(t->slots, index);
+
+			// The first part of the memory will be used to store the header
+			memcpy(slot, header, sizeof(hash_slot));
+
+			// Interned keys are copied now, the slot stays free if there's no room for the key
+			if (t->keys && !hash_util_intern(hash, t->keys, (hash_slot*)slot, key, header->key_length)) break;
+
+			// The second part to store the actual value
+			memcpy(slot + sizeof(hash_slot), value, hash->element_size);
+
+			if (bitset_get(t->deleted, index)) {
+
+				bitset_unset(t->deleted, index);
+				t->deleted_count--;
+			}
+			bitset_set(t->occupied, index);
+			t->count++;
+			inserted = true;
+			break;
+		}
+		index = (index + step) & mask;
+	}
+	return inserted;
+}
+
+/* Utility function that marks the index -th slot of t as deleted */
+void hash_util_table_remove_at(hash_table* t, size_t index) {
+
+	vec_remove_at(t->slots, index);
+	bitset_unset(t->occupied, index);
+	bitset_set(t->deleted, index);
+	t->count--;
+	t->deleted_count++;
+
+	// Without any live couple, the tombstones (and the interned keys) are useless
+	if (t->count == 0) {
+
+		bitset_unset_full(t->deleted);
+		t->deleted_count = 0;
+		if (t->keys) vec_resize(t->keys, 0);
+	}
+	return;
+}
+
+/* Utility function that allocates the new table and starts migrating the current one into it */
+void hash_util_rehash_start(hashmap* hash) {
+
+	size_t capacity = vec_get_size(hash->table->slots);
+
+	// Grow only if the live couples alone would fill half of the allowed load, otherwise just drop the tombstones
+	if ((double)hash->table->count > hash->max_load * (double)capacity / 2 && capacity <= SIZE_MAX / 2 / hash->slot_size) capacity *= 2;
+
+	hash_table* t = hash_util_table_create(capacity, hash->slot_size, hash->interned);
+	if (t) {
+
+		hash->old_table = hash->table;
+		hash->table = t;
+		hash->rehash_index = 0;
+		STATS_INC(hash->rehashes);
+	}
+	return;
+}
+
+/* Utility function that migrates (at most) the given number of slots from the old table to the current one */
+void hash_util_rehash_step(hashmap* hash, size_t steps) {
+
+	hash_table* old = hash->old_table;
+	size_t capacity = vec_get_size(old->slots);
+
+	for (; steps > 0 && hash->rehash_index < capacity && old->count > 0; steps--, hash->rehash_index++) {
+
+		if (bitset_get(old->occupied, hash->rehash_index)) {
+
+			// The hashes are cached, moving a couple only reads its key to copy it in the arena of the new table
+			// If it can't be copied the couple stays where it is, the next step tries again
+			hash_slot* slot = (hash_slot*)vec_get_at(old->slots, hash->rehash_index);
+			if (!hash_util_table_insert(hash, hash->table, slot, hash_util_slot_key(hash, old->keys, slot), (char*)slot + sizeof(hash_slot))) break;
+			hash_util_table_remove_at(old, hash->rehash_index);
+		}
+	}
+
+	// Every couple was moved, the old table can be dropped
+	if (hash->rehash_index >= capacity || old->count == 0) {
+
+		hash_util_table_delete(&hash->old_table);
+		hash->rehash_index = 0;
+	}
+	return;
+}
+
+/* Utility function that completes a pending migration */
+void hash_util_rehash_finish(hashmap* hash) {
+
+	if (hash->old_table) hash_util_rehash_step(hash, vec_get_size(hash->old_table->slots));
+	return;
+}
+
+/* Utility function that rounds the capacity up to a power of two (0 if it's not possible) */
+size_t hash_util_round_capacity(size_t capacity) {
+
+	size_t rounded = 1;
+	while (rounded < capacity && rounded <= SIZE_MAX / 2) rounded *= 2;
+
+	return rounded >= capacity ? rounded : 0;
+}
+
+/* Utility function that computes both hashes of a key */
+void hash_util_compute(hashmap* hash, const void* key, size_t len, size_t* h, size_t* h2) {
+
+	*h = hash->hash_func(key, len, hash->seed);
+
+	if (hash->second_hash) {
+
+		*h2 = hash->second_hash(key, len, hash->seed);
+	}
+
+	// Derive the step from the bits of the first hash that don't pick the position
+	else {
+
+		uint64_t x = (uint64_t)*h;
+		x = (x ^ (x >> 31)) * 0x94D049BB133111EBULL;
+		*h2 = (size_t)(x ^ (x >> 29));
+	}
+	return;
+}
+
+/* Utility function that searches the key in both tables, returns its slot (NULL if absent) along with the table and index */
+hash_slot* hash_util_lookup(hashmap* hash, const void* key, size_t len, size_t h, size_t h2, hash_table** where, size_t* index) {
+
+	hash_slot* slot = NULL;
+
+	*where = hash->table;
+	*index = hash_util_table_find(hash, *where, key, len, h, h2);
+	if (*index == vec_get_size((*where)->slots) && hash->old_table) {
+
+		*where = hash->old_table;
+		*index = hash_util_table_find(hash, *where, key, len, h, h2);
+	}
+
+	if (*index < vec_get_size((*where)->slots)) slot = (hash_slot*)vec_get_at((*where)->slots, *index);
+
+	return slot;
+}
+
+/* Utility function that inserts (or replaces) a couple whose hashes are already known */
+void hash_util_put(hashmap* hash, const void* key, size_t len, size_t h, size_t h2, void* value) {
+
+	// Move forward the migration, if there is one
+	if (hash->old_table) hash_util_rehash_step(hash, HASH_REHASH_STEP);
+
+	// The key could be in any of the two tables, update it where it is
+	hash_table* t = NULL;
+	size_t index = 0;
+	hash_slot* slot = hash_util_lookup(hash, key, len, h, h2, &t, &index);
+
+	// Key present, replace the couple (an interned key is kept, it has the same bytes)
+	if (slot) {
+
+		if (!hash->interned) {
+
+			if (slot->key != key) free((void*)slot->key);
+			slot->key = key;
+		}
+		memcpy((char*)slot + sizeof(hash_slot), value, hash->element_size);
+	}
+
+	// New key, it always goes into the newest table
+	else {
+
+		hash_slot header;
+		header.key = key;
+		header.key_length = len;
+		header.hash = h;
+		header.second_hash = h2;
+
+		// Too many used slots, start moving the couples into a bigger table
+		if (hash_util_table_insert(hash, hash->table, &header, key, value) && (double)(hash->table->count + hash->table->deleted_count) > hash->max_load * (double)vec_get_size(hash->table->slots)) {
+
+			// A table can't be replaced while it is still being filled
+			if (hash->old_table) hash_util_rehash_finish(hash);
+			if (!hash->old_table) hash_util_rehash_start(hash);
+		}
+	}
+	return;
+}
+
+/* Utility function that removes the couple whose hashes are already known, if present */
+void hash_util_remove(hashmap* hash, const void* key, size_t len, size_t h, size_t h2) {
+
+	if (hash->old_table) hash_util_rehash_step(hash, HASH_REHASH_STEP);
+
+	hash_table* t = NULL;
+	size_t index = 0;
+	hash_slot* slot = hash_util_lookup(hash, key, len, h, h2, &t, &index);
+
+	// If the key was found, free it (interned keys are dropped by the next rehash) and mark the slot as deleted
+	if (slot) {
+
+		if (!hash->interned) free((void*)slot->key);
+		hash_util_table_remove_at(t, index);
+	}
+	return;
+}
+
+/* Utility function that computes lengths and hashes of a batch of keys, and prefetches their home slots */
+void hash_util_batch_prepare(hashmap* hash, const char** keys, const size_t* lengths, size_t n, size_t* len, size_t* h, size_t* h2) {
+
+	for (size_t i = 0; i < n; i++) {
+
+		if (keys[i]) {
+
+			len[i] = lengths ? lengths[i] : strlen(keys[i]);
+			hash_util_compute(hash, keys[i], len[i], &h[i], &h2[i]);
+
+			HASH_PREFETCH(vec_get_at(hash->table->slots, h[i] & (vec_get_size(hash->table->slots) - 1)));
+			if (hash->old_table) HASH_PREFETCH(vec_get_at(hash->old_table->slots, h[i] & (vec_get_size(hash->old_table->slots) - 1)));
+		}
+	}
+	return;
+}
+
+/* Utility function that copies an interned key: in the slot (after the value) if it's short, otherwise at the end of the arena */
+bool hash_util_intern(hashmap* hash, vector* arena, hash_slot* slot, const void* key, size_t len) {
+
+	bool stored = false;
+
+	if (len <= HASH_INLINE_KEY_LENGTH) {
+
+		char* bytes = (char*)slot + hash->slot_size - HASH_INLINE_KEY_SIZE;
+		memcpy(bytes, key, len);
+		bytes[len] = '\0';
+		stored = true;
+	}
+	else if (len < SIZE_MAX - vec_get_length(arena)) {
+
+		// Keys are followed by a NUL aswell, the arena doubles when it's full so that appending stays amortized O(1)
+		size_t offset = vec_get_length(arena);
+		size_t needed = offset + len + 1;
+		size_t size = vec_get_size(arena);
+
+		if (needed > size) vec_reserve(arena, size <= SIZE_MAX / 2 && needed < 2 * size ? 2 * size : needed);
+		vec_resize(arena, needed);
+
+		if (vec_get_length(arena) == needed) {
+
+			char* bytes = (char*)vec_get_at(arena, offset);
+			memcpy(bytes, key, len);
+			bytes[len] = '\0';
+			slot->key_offset = offset;
+			stored = true;
+		}
+	}
+	return stored;
+}
+
+/* Utility function that returns the bytes of the key of a slot, wherever they're stored */
+const void* hash_util_slot_key(hashmap* hash, vector* arena, hash_slot* slot) {
+
+	if (!hash->interned) return slot->key;
+	if (slot->key_length <= HASH_INLINE_KEY_LENGTH) return (char*)slot + hash->slot_size - HASH_INLINE_KEY_SIZE;
+
+	return vec_get_at(arena, slot->key_offset);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,723 @@
+/*
+ * Copyright (c) 2024 Biribo' Francesco
+ *
+ * Permission to use, copy, modify, and distribute this software for any purpose with or without fee is hereby granted, provided that the above copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include "../../include/non-linear/lrucache.h"
+#include "../../include/non-linear/hashmap.h"
+#include "../../include/non-linear/hashfunctions.h"
+#include "../../include/linear/dnode.h"
+#include "../../include/linear/pool.h"
+#include <string.h>
+
+/* Initial capacity of the hashmap mapping the keys to their nodes */
+#define LRU_MIN_CAPACITY 16
+
+/* Share (percent) of the capacity given to the window, and share of the main part given to the protected segment */
+#define LRU_WINDOW_PERCENT 1
+#define LRU_PROTECTED_PERCENT 80
+
+/* Rows of the sketch, value at which its counters stop growing and width it starts with */
+#define LRU_SKETCH_DEPTH 4
+#define LRU_SKETCH_MAX 15
+#define LRU_SKETCH_MIN_WIDTH 64
+
+/* Uses counted (times the width of the sketch) before every counter is halved, so that old uses weigh less */
+#define LRU_SKETCH_SAMPLE 10
+
+/* Lists an entry can be in, the LRU policy only uses the window */
+#define LRU_WINDOW 0
+#define LRU_PROBATION 1
+#define LRU_PROTECTED 2
+
+/**
+ * Header stored in every node, the value follows it
+ */
+typedef struct lru_entry {
+
+	/* Key of the entry, the copy is owned by the hashmap */
+	const void* key;
+	size_t key_length;
+
+	/* Hash of the key, used by the sketch */
+	uint64_t hash;
+
+	/* Bytes charged for the entry */
+	size_t charge;
+
+	/* List the node is in */
+	int segment;
+} lru_entry;
+
+/* Size of the header, padded so that values are aligned */
+#define LRU_ENTRY_SIZE ((sizeof(lru_entry) + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*))
+
+/**
+ * List of nodes, from the most recently used (head) to the least recently used (tail)
+ */
+typedef struct lru_list {
+
+	dnode* head;
+	dnode* tail;
+
+	/* Bytes charged for the entries of the list */
+	size_t bytes;
+} lru_list;
+
+/* Utility function used to create a cache with the given policy */
+lrucache* lru_util_create(size_t capacity, size_t element_size, bool tinylfu);
+
+/* Utility functions used to link a node at the head of a list, and to unlink it */
+void lru_util_push_front(lru_list* l, dnode* node);
+void lru_util_unlink(lru_list* l, dnode* node);
+
+/* Utility function that returns the node of a key, NULL if it's not in the cache */
+dnode* lru_util_find(lrucache* c, const void* key, size_t len);
+
+/* Utility function used to mark a node as used, moving it to the head of its list (or of the protected one) */
+void lru_util_touch(lrucache* c, dnode* node);
+
+/* Utility function used to drop a node, evicted tells whether it's making room (the callback is called) or removed */
+void lru_util_drop(lrucache* c, dnode* node, bool evicted);
+
+/* Utility function used to drop entries until every list is within its budget */
+void lru_util_evict(lrucache* c);
+
+/* Utility functions used to count a use of a key in the sketch, and to estimate how many times it was used */
+void lru_util_sketch_add(lrucache* c, uint64_t h);
+unsigned lru_util_sketch_estimate(lrucache* c, uint64_t h);
+
+/**
+ * Struct that represent a cache, mapping keys into values, that holds at most
+ * a given number of bytes and drops entries by itself to make room for new ones
+ */
+typedef struct lrucache {
+
+	/* The actual definition of the struct is placed
+	 * here and not in the header file to try and achieve incapsulation
+	 *
+	 * Mainly, so that users wouldn't be able to modify
+	 * the value of individual fields in a wrongful way,
+	 * such as setting a bigger size/ element size to read/write
+	 * in unallocated memory (or, still, memory that isn't 'ours')
+	 */
+
+	/* Maps the bytes of a key to its node (dnode*), nodes come from the pool so their address never changes */
+	hashmap* map;
+	pool* nodes;
+
+	/* Window, probation and protected lists, and the budget of the window, of the main part
+	 * (probation + protected) and of the protected segment
+	 */
+	lru_list lists[3];
+	size_t window_budget;
+	size_t main_budget;
+	size_t protected_budget;
+
+	/* Maximum number of bytes, bytes charged so far and number of entries */
+	size_t capacity;
+	size_t bytes;
+	size_t count;
+
+	/* Size of the values stored in the cache */
+	size_t element_size;
+
+	/* Whether the W-TinyLFU policy is used, and its sketch (LRU_SKETCH_DEPTH rows of width counters) */
+	bool tinylfu;
+	uint8_t* sketch;
+	size_t sketch_width;
+	size_t sketch_uses;
+
+	/* Seed given to the hash function */
+	uint64_t seed;
+
+	/* Buffer where a new node is prepared (header + value) before being created */
+	char* scratch;
+
+	/* Function called on the entries the cache drops by itself */
+	void (*on_evict)(const void* key, size_t len, void* value, void* context);
+	void* context;
+
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+} lrucache;
+
+/**
+ * Creates an LRU cache that holds at most capacity bytes of entries, whose values are as big as element_size
+ */
+lrucache* lru_create(size_t capacity, size_t element_size) {
+
+	return lru_util_create(capacity, element_size, false);
+}
+
+/**
+ * Creates a W-TinyLFU cache that holds at most capacity bytes of entries, whose values are as big as element_size
+ */
+lrucache* lru_create_tinylfu(size_t capacity, size_t element_size) {
+
+	return lru_util_create(capacity, element_size, true);
+}
+
+/**
+ * Deletes the given cache, the eviction callback is called on every entry still in it
+ */
+void lru_delete(lrucache** c) {
+
+	if (c && *c) {
+
+		lru_clear(*c);
+		hash_delete(&(*c)->map);
+		pool_delete(&(*c)->nodes);
+		free((*c)->sketch);
+		free((*c)->scratch);
+		memset(*c, 0, sizeof(lrucache));
+		free(*c);
+		*c = NULL;
+	}
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is a NUL terminated string
+ *
+ * The key is copied, if it's already present its value is replaced,
+ * entries are dropped (calling the eviction callback) until the new one fits
+ */
+void lru_put(lrucache* c, const char* key, void* value) {
+
+	if (key) lru_put_n(c, key, strlen(key), value);
+	return;
+}
+
+/**
+ * Inserts a couple <key, value>, the key is made of the len bytes pointed to by key
+ *
+ * The key is copied, if it's already present its value is replaced,
+ * entries are dropped (calling the eviction callback) until the new one fits
+ */
+void lru_put_n(lrucache* c, const void* key, size_t len, void* value) {
+
+	if (c && key && value) {
+
+		dnode* node = lru_util_find(c, key, len);
+		uint64_t h = hash_util_wyhash(key, len, c->seed);
+
+		if (c->tinylfu) lru_util_sketch_add(c, h);
+
+		// Known key, the value is replaced and the entry counts as used
+		if (node) {
+
+			memcpy((char*)dnode_get_value(node) + LRU_ENTRY_SIZE, value, c->element_size);
+			lru_util_touch(c, node);
+		}
+
+		// New key, it's inserted only if it can fit in the cache at all
+		else if (len <= c->capacity - c->element_size) {
+
+			void* copy = malloc(len + 1);
+			lru_entry* entry = (lru_entry*)c->scratch;
+
+			if (copy) {
+
+				memcpy(copy, key, len);
+				entry->key = copy;
+				entry->key_length = len;
+				entry->hash = h;
+				entry->charge = len + c->element_size;
+				entry->segment = LRU_WINDOW;
+				memcpy(c->scratch + LRU_ENTRY_SIZE, value, c->element_size);
+
+				node = dnode_create_in(c->nodes, c->scratch, LRU_ENTRY_SIZE + c->element_size);
+			}
+			if (node) {
+
+				size_t count = hash_get_size(c->map);
+				hash_put_n(c->map, copy, len, &node);
+
+				if (hash_get_size(c->map) > count) {
+
+					lru_util_push_front(&c->lists[LRU_WINDOW], node);
+					c->bytes += entry->charge;
+					c->count++;
+					lru_util_evict(c);
+				}
+				else {
+
+					// The hashmap couldn't store it (and didn't take the copy)
+					dnode_delete_in(c->nodes, &node);
+					free(copy);
+				}
+			}
+			else free(copy);
+		}
+	}
+	return;
+}
+
+/**
+ * Returns the value mapped by key (NUL terminated string), and marks it as used
+ *
+ * The value is valid until the entry is dropped, NULL is returned if it's not in the cache
+ */
+void* lru_get(lrucache* c, const char* key) {
+
+	return key ? lru_get_n(c, key, strlen(key)) : NULL;
+}
+
+/**
+ * Returns the value mapped by the len bytes pointed to by key, and marks it as used
+ *
+ * The value is valid until the entry is dropped, NULL is returned if it's not in the cache
+ */
+void* lru_get_n(lrucache* c, const void* key, size_t len) {
+
+	void* val = NULL;
+
+	if (c && key) {
+
+		dnode* node = lru_util_find(c, key, len);
+
+		// Misses are counted by the sketch aswell, a key asked for often deserves a place once it's put
+		if (c->tinylfu) lru_util_sketch_add(c, node ? ((lru_entry*)dnode_get_value(node))->hash : hash_util_wyhash(key, len, c->seed));
+
+		if (node) {
+
+			lru_util_touch(c, node);
+			val = (char*)dnode_get_value(node) + LRU_ENTRY_SIZE;
+			c->hits++;
+		}
+		else c->misses++;
+	}
+	return val;
+}
+
+/**
+ * Copies the value mapped by the len bytes pointed to by key into buf, and marks it as used
+ *
+ * Returns whether or not the key was in the cache
+ */
+bool lru_get_2_n(lrucache* c, const void* key, size_t len, void* buf) {
+
+	void* val = buf ? lru_get_n(c, key, len) : NULL;
+
+	if (val) memcpy(buf, val, c->element_size);
+	return val != NULL;
+}
+
+/**
+ * Returns the value mapped by the len bytes pointed to by key, without marking it as used
+ * nor counting it as a hit or a miss
+ */
+void* lru_peek_n(lrucache* c, const void* key, size_t len) {
+
+	dnode* node = (c && key) ? lru_util_find(c, key, len) : NULL;
+
+	return node ? (char*)dnode_get_value(node) + LRU_ENTRY_SIZE : NULL;
+}
+
+/**
+ * Removes the entry of key (NUL terminated string), the eviction callback isn't called
+ */
+void lru_remove(lrucache* c, const char* key) {
+
+	if (key) lru_remove_n(c, key, strlen(key));
+	return;
+}
+
+/**
+ * Removes the entry of the len bytes pointed to by key, the eviction callback isn't called
+ */
+void lru_remove_n(lrucache* c, const void* key, size_t len) {
+
+	dnode* node = (c && key) ? lru_util_find(c, key, len) : NULL;
+
+	if (node) lru_util_drop(c, node, false);
+	return;
+}
+
+/**
+ * Removes every entry, calling the eviction callback on each one
+ */
+void lru_clear(lrucache* c) {
+
+	if (c) {
+
+		// The keys are still owned by the hashmap while the callback runs
+		for (int i = 0; c->on_evict && i < 3; i++) {
+
+			for (dnode* node = c->lists[i].head; node; node = dnode_get_next(node)) {
+
+				lru_entry* entry = (lru_entry*)dnode_get_value(node);
+				c->on_evict(entry->key, entry->key_length, (char*)entry + LRU_ENTRY_SIZE, c->context);
+			}
+		}
+
+		hash_clear(c->map);
+		pool_clear(c->nodes);
+		memset(c->lists, 0, sizeof(c->lists));
+		c->bytes = 0;
+		c->count = 0;
+	}
+	return;
+}
+
+/**
+ * Sets the function called on every entry the cache drops by itself (to make room, or by clear and delete)
+ * right before it's freed, context is passed to each call
+ */
+void lru_set_eviction_callback(lrucache* c, void (*on_evict)(const void* key, size_t len, void* value, void* context), void* context) {
+
+	if (c) {
+
+		c->on_evict = on_evict;
+		c->context = context;
+	}
+	return;
+}
+
+/**
+ * Returns the number of entries in the cache
+ */
+size_t lru_get_count(lrucache* c) {
+
+	return c ? c->count : 0;
+}
+
+/**
+ * Returns the number of bytes charged for the entries in the cache
+ */
+size_t lru_get_bytes(lrucache* c) {
+
+	return c ? c->bytes : 0;
+}
+
+/**
+ * Returns the capacity of the cache, in bytes
+ */
+size_t lru_get_capacity(lrucache* c) {
+
+	return c ? c->capacity : 0;
+}
+
+/**
+ * Returns the size of the values stored in the cache
+ */
+size_t lru_get_element_size(lrucache* c) {
+
+	return c ? c->element_size : 0;
+}
+
+/**
+ * Returns the number of lookups that found their key
+ */
+uint64_t lru_get_hits(lrucache* c) {
+
+	return c ? c->hits : 0;
+}
+
+/**
+ * Returns the number of lookups that didn't find their key
+ */
+uint64_t lru_get_misses(lrucache* c) {
+
+	return c ? c->misses : 0;
+}
+
+/**
+ * Returns the number of entries dropped to make room for others
+ */
+uint64_t lru_get_evictions(lrucache* c) {
+
+	return c ? c->evictions : 0;
+}
+
+/**
+ * Returns the ratio between hits and lookups (0 before the first lookup)
+ */
+double lru_get_hit_ratio(lrucache* c) {
+
+	uint64_t lookups = c ? c->hits + c->misses : 0;
+
+	return lookups ? (double)c->hits / (double)lookups : 0.0;
+}
+
+/**
+ * Sets the hits, misses and evictions back to 0
+ */
+void lru_reset_stats(lrucache* c) {
+
+	if (c) {
+
+		c->hits = 0;
+		c->misses = 0;
+		c->evictions = 0;
+	}
+	return;
+}
+
+/**
+ * Copies in stats the allocation counters of the nodes of the entries
+ * (always zero unless built with CDS_WITH_STATS) and the number of nodes in use
+ *
+ * Hits, misses and evictions are read by their own functions, lru_reset_stats doesn't touch these counters
+ */
+void lru_get_stats(lrucache* c, node_stats* stats) {
+
+	if (stats) {
+
+		memset(stats, 0, sizeof(node_stats));
+		stats->enabled = STATS_ENABLED;
+		if (c) pool_add_stats(c->nodes, stats);
+	}
+	return;
+}
+
+/* Utility function used to create a cache with the given policy */
+lrucache* lru_util_create(size_t capacity, size_t element_size, bool tinylfu) {
+
+	lrucache* c = NULL;
+
+	if (0 < element_size && element_size < capacity && element_size <= SIZE_MAX / 2 - LRU_ENTRY_SIZE) {
+
+		c = (lrucache*)malloc(sizeof(lrucache));
+		if (c) {
+
+			c->map = hash_create(LRU_MIN_CAPACITY, sizeof(dnode*));
+			c->nodes = pool_create(dnode_get_footprint(LRU_ENTRY_SIZE + element_size));
+			c->scratch = (char*)malloc(LRU_ENTRY_SIZE + element_size);
+			c->sketch_width = LRU_SKETCH_MIN_WIDTH;
+			c->sketch = tinylfu ? (uint8_t*)calloc(LRU_SKETCH_DEPTH * c->sketch_width, sizeof(uint8_t)) : NULL;
+
+			if (c->map && c->nodes && c->scratch && (c->sketch || !tinylfu)) {
+
+				memset(c->lists, 0, sizeof(c->lists));
+				c->capacity = capacity;
+				c->bytes = 0;
+				c->count = 0;
+				c->element_size = element_size;
+				c->tinylfu = tinylfu;
+				c->sketch_uses = 0;
+				c->seed = hash_get_seed(c->map);
+				c->on_evict = NULL;
+				c->context = NULL;
+				c->hits = 0;
+				c->misses = 0;
+				c->evictions = 0;
+
+				// The LRU policy keeps everything in the window
+				c->window_budget = tinylfu ? capacity / 100 * LRU_WINDOW_PERCENT + capacity % 100 * LRU_WINDOW_PERCENT / 100 : capacity;
+				c->main_budget = capacity - c->window_budget;
+				c->protected_budget = c->main_budget / 100 * LRU_PROTECTED_PERCENT + c->main_budget % 100 * LRU_PROTECTED_PERCENT / 100;
+			}
+			else {
+
+				hash_delete(&c->map);
+				pool_delete(&c->nodes);
+				free(c->scratch);
+				free(c->sketch);
+				free(c);
+				c = NULL;
+			}
+		}
+	}
+	return c;
+}
+
+/* Utility function used to link a node at the head of a list */
+void lru_util_push_front(lru_list* l, dnode* node) {
+
+	dnode_set_prev(node, NULL);
+	dnode_set_next(node, l->head);
+
+	if (l->head) dnode_set_prev(l->head, node);
+	else l->tail = node;
+
+	l->head = node;
+	l->bytes += ((lru_entry*)dnode_get_value(node))->charge;
+	return;
+}
+
+/* Utility function used to unlink a node from its list */
+void lru_util_unlink(lru_list* l, dnode* node) {
+
+	dnode* prev = dnode_get_prev(node);
+	dnode* next = dnode_get_next(node);
+
+	if (prev) dnode_set_next(prev, next);
+	else l->head = next;
+
+	if (next) dnode_set_prev(next, prev);
+	else l->tail = prev;
+
+	l->bytes -= ((lru_entry*)dnode_get_value(node))->charge;
+	return;
+}
+
+/* Utility function that returns the node of a key, NULL if it's not in the cache */
+dnode* lru_util_find(lrucache* c, const void* key, size_t len) {
+
+	dnode** found = (dnode**)hash_get_n(c->map, key, len);
+	return found ? *found : NULL;
+}
+
+/**
+ * Marks a node as used: it goes to the head of its list, unless it's in the probation segment,
+ * in that case it's promoted to the protected one (whose least recently used entries go back to probation)
+ */
+void lru_util_touch(lrucache* c, dnode* node) {
+
+	lru_entry* entry = (lru_entry*)dnode_get_value(node);
+	lru_list* l = &c->lists[entry->segment];
+
+	lru_util_unlink(l, node);
+
+	if (entry->segment == LRU_PROBATION) {
+
+		entry->segment = LRU_PROTECTED;
+		lru_util_push_front(&c->lists[LRU_PROTECTED], node);
+
+		lru_list* protect = &c->lists[LRU_PROTECTED];
+		while (protect->bytes > c->protected_budget && protect->tail != node) {
+
+			dnode* demoted = protect->tail;
+			lru_util_unlink(protect, demoted);
+			((lru_entry*)dnode_get_value(demoted))->segment = LRU_PROBATION;
+			lru_util_push_front(&c->lists[LRU_PROBATION], demoted);
+		}
+	}
+	else lru_util_push_front(l, node);
+	return;
+}
+
+/* Utility function used to drop a node, evicted tells whether it's making room (the callback is called) or removed */
+void lru_util_drop(lrucache* c, dnode* node, bool evicted) {
+
+	lru_entry* entry = (lru_entry*)dnode_get_value(node);
+
+	lru_util_unlink(&c->lists[entry->segment], node);
+	c->bytes -= entry->charge;
+	c->count--;
+
+	if (evicted) {
+
+		c->evictions++;
+		if (c->on_evict) c->on_evict(entry->key, entry->key_length, (char*)entry + LRU_ENTRY_SIZE, c->context);
+	}
+
+	// The hashmap frees its copy of the key, which is the one the entry points to
+	hash_remove_n(c->map, entry->key, entry->key_length);
+	dnode_delete_in(c->nodes, &node);
+	return;
+}
+
+/**
+ * Drops entries until every list is within its budget
+ *
+ * With the LRU policy the least recently used entries are dropped. With W-TinyLFU the entries
+ * leaving the window go to the probation segment, and while the main part is over its budget
+ * each one is compared with the entry it would push out (the least recently used of probation,
+ * or of protected if probation has nothing else): the one used less often is dropped
+ */
+void lru_util_evict(lrucache* c) {
+
+	lru_list* window = &c->lists[LRU_WINDOW];
+	lru_list* probation = &c->lists[LRU_PROBATION];
+	lru_list* protect = &c->lists[LRU_PROTECTED];
+
+	while (window->tail && window->bytes > c->window_budget) {
+
+		dnode* candidate = window->tail;
+
+		if (!c->tinylfu) {
+
+			lru_util_drop(c, candidate, true);
+			continue;
+		}
+
+		lru_util_unlink(window, candidate);
+		((lru_entry*)dnode_get_value(candidate))->segment = LRU_PROBATION;
+		lru_util_push_front(probation, candidate);
+
+		while (candidate && probation->bytes + protect->bytes > c->main_budget) {
+
+			dnode* victim = probation->tail != candidate ? probation->tail : protect->tail;
+
+			if (victim) {
+
+				unsigned candidate_uses = lru_util_sketch_estimate(c, ((lru_entry*)dnode_get_value(candidate))->hash);
+				unsigned victim_uses = lru_util_sketch_estimate(c, ((lru_entry*)dnode_get_value(victim))->hash);
+
+				// Ties go to the entry already in, so that a scan can't replace it
+				if (candidate_uses > victim_uses) lru_util_drop(c, victim, true);
+				else {
+
+					lru_util_drop(c, candidate, true);
+					candidate = NULL;
+				}
+			}
+			else {
+
+				// Nothing to compare with, the candidate alone is over the budget
+				lru_util_drop(c, candidate, true);
+				candidate = NULL;
+			}
+		}
+	}
+	return;
+}
+
+/**
+ * Counts a use of the key with the given hash, every counter of the key in the sketch grows (up to LRU_SKETCH_MAX)
+ *
+ * After LRU_SKETCH_SAMPLE times the width uses every counter is halved, and the sketch
+ * gets wider (and starts over) when the cache holds more entries than its width
+ */
+void lru_util_sketch_add(lrucache* c, uint64_t h) {
+
+	if (c->count > c->sketch_width && c->sketch_width <= SIZE_MAX / 2 / LRU_SKETCH_DEPTH) {
+
+		uint8_t* wider = (uint8_t*)calloc(LRU_SKETCH_DEPTH * c->sketch_width * 2, sizeof(uint8_t));
+		if (wider) {
+
+			free(c->sketch);
+			c->sketch = wider;
+			c->sketch_width *= 2;
+			c->sketch_uses = 0;
+		}
+	}
+
+	size_t mask = c->sketch_width - 1;
+	uint64_t step = (h >> 32) | 1;
+
+	for (size_t i = 0; i < LRU_SKETCH_DEPTH; i++) {
+
+		uint8_t* counter = &c->sketch[i * c->sketch_width + ((size_t)(h + i * step) & mask)];
+		if (*counter < LRU_SKETCH_MAX) (*counter)++;
+	}
+
+	if (++c->sketch_uses >= LRU_SKETCH_SAMPLE * c->sketch_width) {
+
+		for (size_t i = 0; i < LRU_SKETCH_DEPTH * c->sketch_width; i++) c->sketch[i] >>= 1;
+		c->sketch_uses /= 2;
+	}
+	return;
+}
+
+/* Utility function that estimates how many times the key with the given hash was used (the smallest of its counters) */
+unsigned lru_util_sketch_estimate(lrucache* c, uint64_t h) {
+
+	size_t mask = c->sketch_width - 1;
+	uint64_t step = (h >> 32) | 1;
+	unsigned estimate = LRU_SKETCH_MAX;
+
+	for (size_t i = 0; i < LRU_SKETCH_DEPTH; i++) {
+
+		unsigned counter = c->sketch[i * c->sketch_width + ((size_t)(h + i * step) & mask)];
+		if (counter < estimate) estimate = counter;
+	}
+	return estimate;
+}
\ No newline at end of file
@@ -10,12 +10,21 @@
 
 #include "../../include/non-linear/graph.h"
 #include "../../include/linear/linkedlist.h"
-#include "../../include/linear/queue.h"
-#include "../../include/linear/stack.h"
+#include "../../include/linear/bitset.h"
 #include <string.h>
 #include <stdbool.h>
 
-#define MAX_ELEMENTS 100
+/* Number of nodes the matrix has room for when the graph is created, it doubles whenever it's full */
+#define GRAPH_MATRIX_MIN_CAPACITY 8
+
+/* Utility function used to make room in the matrix for (at least) the given number of nodes */
+bool graph_util_grow(graph* g, size_t min_capacity);
+
+/* Utility function used to find the first node adjacent to i starting from j (included), current_elements if there's none */
+size_t graph_util_next(graph* g, size_t i, size_t j);
+
+/* Utility function used to collect the values of the nodes, indexed like the matrix */
+void** graph_util_values(graph* g);
 
  /**
   * Struct that represent a graph that can store
@@ -35,11 +44,17 @@ typedef struct graph {
 	/* List of nodes */
 	linkedlist* nodes;
 
-	/* Matrix of adjacency, used to represent the arches */
-	int adjacency_matrix[MAX_ELEMENTS][MAX_ELEMENTS];
+	/* Matrix of adjacency of weighted graphs, capacity x capacity weights stored row after row (NULL otherwise) */
+	int* weights;
+
+	/* Matrix of adjacency of unweighted graphs, one bitset of capacity bits per row (NULL otherwise) */
+	bitset** rows;
+
+	/* Number of nodes the matrix has room for */
+	size_t capacity;
 
 	/* Number of current elements in the graph */
-	int current_elements;
+	size_t current_elements;
 
 	/* Size of the elements stored in the list */
 	size_t element_size;
@@ -62,19 +77,16 @@ graph* graph_create(size_t element_size, int flags) {
 		if (g) {
 
 			g->nodes = ll_create(element_size);
-			if (g->nodes) {
-
-				g->current_elements = 0;
-				g->element_size = element_size;
-				g->flags = flags;
-				for (int i = 0; i < MAX_ELEMENTS; i++)
-					for (int j = 0; j < MAX_ELEMENTS; j++)
-						g->adjacency_matrix[i][j] = 0;
-			}
-			else {
+			g->weights = NULL;
+			g->rows = NULL;
+			g->capacity = 0;
+			g->current_elements = 0;
+			g->element_size = element_size;
+			g->flags = flags;
 
-				free(g);
-				g = NULL;
+			if (!g->nodes || !graph_util_grow(g, GRAPH_MATRIX_MIN_CAPACITY)) {
+
+				graph_delete(&g);
 			}
 		}
 	}
@@ -89,6 +101,12 @@ void graph_delete(graph** g) {
 	if (g && *g) {
 
 		ll_delete(&(*g)->nodes);
+		free((*g)->weights);
+		if ((*g)->rows) {
+
+			for (size_t i = 0; i < (*g)->capacity; i++) bitset_delete(&(*g)->rows[i]);
+			free((*g)->rows);
+		}
 		memset(*g, 0, sizeof(graph));
 		free(*g);
 		*g = NULL;
@@ -98,21 +116,17 @@ void graph_delete(graph** g) {
 
 /**
  * Inserts a node in the graph that will hold the value x
+ *
+ * The matrix grows when it's full, its row and column start empty
  */
 void graph_insert_node(graph* g, void* x) {
 
 	if(g && x) {
 	
-		if (g->current_elements < MAX_ELEMENTS && !ll_contains(g->nodes, x)) {
+		if (!ll_contains(g->nodes, x) && (g->current_elements < g->capacity || graph_util_grow(g, g->current_elements + 1))) {
 
 			ll_insert_tail(g->nodes, x);
 			g->current_elements++;
-
-			// Initialize the row/column for the matrix
-			for (int i = 0; i < g->current_elements; i++)
-				g->adjacency_matrix[i][g->current_elements - 1] = 0;
-			for (int j = 0; j < g->current_elements; j++)
-				g->adjacency_matrix[g->current_elements - 1][j] = 0;
 		}
 	}
 	return;
@@ -132,8 +146,16 @@ void graph_insert_arch(graph* g, void* first, void* second, int weight) {
 
 			if (i > 0 && j > 0) {
 
-				g->adjacency_matrix[i - 1][j - 1] = (g->flags & IS_WEIGHTED) ? weight : 1;
-				if (g->flags & ~IS_ORIENTED) g->adjacency_matrix[j - 1][i - 1] = (g->flags & IS_WEIGHTED) ? weight : 1;
+				if (g->weights) {
+
+					g->weights[(i - 1) * g->capacity + (j - 1)] = weight;
+					if (!(g->flags & IS_ORIENTED)) g->weights[(j - 1) * g->capacity + (i - 1)] = weight;
+				}
+				else {
+
+					bitset_set(g->rows[i - 1], j - 1);
+					if (!(g->flags & IS_ORIENTED)) bitset_set(g->rows[j - 1], i - 1);
+				}
 			}
 		}
 	}
@@ -149,47 +171,51 @@ void graph_remove_node(graph* g, void* x) {
 	if (g && x) {
 
 		// Search for the indexes of the element
-		int k = ll_contains(g->nodes, x);
+		int found = ll_contains(g->nodes, x);
 
-		if (k > 0) {
+		if (found > 0) {
 
 			// Adjust index
-			k--;
+			size_t k = (size_t)found - 1;
+			size_t n = g->current_elements;
 
 			ll_remove_at(g->nodes, k);
 
-			// Free the row and column occupied by the old node
-			for (int i = 0; i < g->current_elements; i++)
-				g->adjacency_matrix[i][k] = 0;
-			for (int j = 0; j < g->current_elements; j++)
-				g->adjacency_matrix[k][j] = 0;
+			if (g->weights) {
 
-			// Shift each row after the deleted one 1 up
-			for (int i = k + 1; i < g->current_elements; i++) {
+				// Every weight after row k or column k moves 1 up or 1 to the left (destinations never pass sources)
+				for (size_t i = 0; i < n; i++) {
 
-				for (int j = 0; j < g->current_elements; j++) {
+					for (size_t j = 0; j < n; j++) {
 
-					if (j != k)
-						g->adjacency_matrix[i - 1][j] = g->adjacency_matrix[i][j];
+						if (i != k && j != k) g->weights[(i - (i > k)) * g->capacity + (j - (j > k))] = g->weights[i * g->capacity + j];
+					}
 				}
+
+				// The last row and column are free now
+				memset(g->weights + (n - 1) * g->capacity, 0, n * sizeof(int));
+				for (size_t i = 0; i < n; i++) g->weights[i * g->capacity + n - 1] = 0;
 			}
+			else {
 
-			// Shift each column after the deleted one 1 to the left
-			for (int j = k + 1; j < g->current_elements; j++) {
+				// The row of the removed node is emptied and becomes the last one
+				bitset* removed = g->rows[k];
+				bitset_unset_full(removed);
+				memmove(g->rows + k, g->rows + k + 1, (n - 1 - k) * sizeof(bitset*));
+				g->rows[n - 1] = removed;
 
-				for (int i = 0; i < g->current_elements; i++) {
+				// In every row, the bits after column k move 1 to the left
+				for (size_t i = 0; i + 1 < n; i++) {
 
-					if (i != k)
-						g->adjacency_matrix[i][j - 1] = g->adjacency_matrix[i][j];
+					bitset_unset(g->rows[i], k);
+					for (size_t j = bitset_next_set(g->rows[i], k + 1); j < n; j = bitset_next_set(g->rows[i], j + 1)) {
+
+						bitset_unset(g->rows[i], j);
+						bitset_set(g->rows[i], j - 1);
+					}
 				}
 			}
 
-			// The last row and index are to be deleted now
-			for (int i = 0; i < g->current_elements; i++)
-				g->adjacency_matrix[i][g->current_elements - 1] = 0;
-			for (int j = 0; j < g->current_elements; j++)
-				g->adjacency_matrix[g->current_elements - 1][j] = 0;
-
 			g->current_elements--;
 		}
 	}
@@ -208,8 +234,16 @@ void graph_remove_arch(graph* g, void* first, void* second) {
 
 		if (i > 0 && j > 0) {
 
-			g->adjacency_matrix[i - 1][j - 1] = 0;
-			if (g->flags & ~IS_ORIENTED) g->adjacency_matrix[j - 1][i - 1] = 0;
+			if (g->weights) {
+
+				g->weights[(i - 1) * g->capacity + (j - 1)] = 0;
+				if (!(g->flags & IS_ORIENTED)) g->weights[(j - 1) * g->capacity + (i - 1)] = 0;
+			}
+			else {
+
+				bitset_unset(g->rows[i - 1], j - 1);
+				if (!(g->flags & IS_ORIENTED)) bitset_unset(g->rows[j - 1], i - 1);
+			}
 		}
 	}
 	return;
@@ -232,6 +266,9 @@ void* graph_search_node(graph* g, void* x) {
 
 /**
  * Searches for an arch between first and second
+ *
+ * A pointer to the weight of the arch is returned for weighted graphs, a pointer
+ * to the value of second for unweighted ones (NULL if there's no such arch)
  */
 void* graph_search_arch(graph* g, void* first, void* second) {
 
@@ -245,7 +282,11 @@ void* graph_search_arch(graph* g, void* first, void* second) {
 			int j = ll_contains(g->nodes, second);
 			if (i > 0 && j > 0) {
 
-				val = &(g->adjacency_matrix[i - 1][j - 1]);
+				if (g->weights) {
+
+					if (g->weights[(i - 1) * g->capacity + (j - 1)]) val = &(g->weights[(i - 1) * g->capacity + (j - 1)]);
+				}
+				else if (bitset_get(g->rows[i - 1], j - 1)) val = ll_get_at(g->nodes, j - 1);
 			}
 		}
 	}
@@ -254,70 +295,155 @@ void* graph_search_arch(graph* g, void* first, void* second) {
 
 /**
  * Traverses the graph breadth-first and applies the callback function to each element
+ *
+ * Every node is visited, a new traversal starts from the first node not visited yet
+ *
+ * On unweighted graphs the traversal goes a level at a time, the next level is the union
+ * of the rows of the current one minus the visited nodes, computed a word at a time
  */
 void graph_BFS(graph* g, void (*callback)(void*)) {
 
-	if (g && callback) {
+	if (g && callback && g->current_elements > 0) {
 
-		bool visited[MAX_ELEMENTS] = { false };
-		queue* q = queue_create(sizeof(void*));
+		size_t n = g->current_elements;
+		void** values = graph_util_values(g);
 
-		if (q) {
+		if (values && g->rows) {
 
-			void* cur = ll_get_head(g->nodes);
-			queue_enqueue(q, cur);
-			visited[ll_contains(g->nodes, cur) - 1] = true;
+			bitset* visited = bitset_create(g->capacity);
+			bitset* frontier = bitset_create(g->capacity);
+			bitset* next = bitset_create(g->capacity);
 
-			while (!queue_is_empty(q)) {
+			if (visited && frontier && next) {
 
-				cur = queue_dequeue(q);
-				callback(cur);
-				for (int i = 0; i < ll_get_size(g->nodes); i++) {
+				for (size_t s = 0; s < n; s++) {
 
-					if (g->adjacency_matrix[ll_contains(g->nodes, cur) - 1][i] && !visited[i]) {
+					if (!bitset_get(visited, s)) {
 
-						queue_enqueue(q, ll_get_at(g->nodes, i));
-						visited[i] = true;
+						bitset_set(frontier, s);
+						bitset_set(visited, s);
+
+						while (bitset_count(frontier) > 0) {
+
+							for (size_t v = bitset_next_set(frontier, 0); v < n; v = bitset_next_set(frontier, v + 1)) {
+
+								callback(values[v]);
+								bitset_or(next, g->rows[v]);
+							}
+							bitset_and_not(next, visited);
+							bitset_or(visited, next);
+
+							// The next level becomes the current one
+							bitset* tmp = frontier;
+							frontier = next;
+							next = tmp;
+							bitset_unset_full(next);
+						}
 					}
 				}
 			}
+			bitset_delete(&visited);
+			bitset_delete(&frontier);
+			bitset_delete(&next);
 		}
 
+		// Weighted graphs, the queue is a plain array since every node enters it at most once
+		else if (values) {
+
+			bool* visited = (bool*)calloc(n, sizeof(bool));
+			size_t* queue = (size_t*)malloc(n * sizeof(size_t));
+
+			if (visited && queue) {
+
+				for (size_t s = 0; s < n; s++) {
+
+					if (!visited[s]) {
+
+						size_t head = 0, tail = 0;
+						queue[tail++] = s;
+						visited[s] = true;
+
+						while (head < tail) {
+
+							size_t cur = queue[head++];
+							callback(values[cur]);
+
+							for (size_t i = graph_util_next(g, cur, 0); i < n; i = graph_util_next(g, cur, i + 1)) {
+
+								if (!visited[i]) {
+
+									visited[i] = true;
+									queue[tail++] = i;
+								}
+							}
+						}
+					}
+				}
+			}
+			free(visited);
+			free(queue);
+		}
+		free(values);
 	}
 	return;
 }
 
 /**
  * Traverses the graph depths-first and applies the callback function to each element
+ *
+ * Every node is visited, a new traversal starts from the first node not visited yet
  */
 void graph_DFS(graph* g, void (*callback)(void*)) {
 
-	if (g && callback) {
+	if (g && callback && g->current_elements > 0) {
+
+		size_t n = g->current_elements;
+		void** values = graph_util_values(g);
+		bool* visited = (bool*)calloc(n, sizeof(bool));
+
+		// The stack holds the path from the first node, along with the next column to look at of each node
+		size_t* nodes = (size_t*)malloc(n * sizeof(size_t));
+		size_t* cursors = (size_t*)malloc(n * sizeof(size_t));
+
+		if (values && visited && nodes && cursors) {
 
-		bool visited[MAX_ELEMENTS] = { false };
-		stack* s = stack_create(sizeof(void*));
+			for (size_t s = 0; s < n; s++) {
 
-		if (s) {
+				if (!visited[s]) {
 
-			void* cur = ll_get_head(g->nodes);
-			stack_push(s, cur);
-			visited[ll_contains(g->nodes, cur) - 1] = true;
+					size_t top = 0;
+					nodes[top] = s;
+					cursors[top] = 0;
+					top++;
+					visited[s] = true;
+					callback(values[s]);
 
-			while (!stack_is_empty(s)) {
+					while (top > 0) {
 
-				cur = stack_pop(s);
-				callback(cur);
-				for (int i = 0; i < ll_get_size(g->nodes); i++) {
+						size_t next = graph_util_next(g, nodes[top - 1], cursors[top - 1]);
 
-					if (g->adjacency_matrix[ll_contains(g->nodes, cur) - 1][i] && !visited[i]) {
+						// Go deeper, or go back if there's nothing left in this row
+						if (next < n) {
 
-						stack_push(s, ll_get_at(g->nodes, i));
-						visited[i] = true;
+							cursors[top - 1] = next + 1;
+							if (!visited[next]) {
+
+								visited[next] = true;
+								callback(values[next]);
+								nodes[top] = next;
+								cursors[top] = 0;
+								top++;
+							}
+						}
+						else top--;
 					}
 				}
 			}
 		}
-
+		free(values);
+		free(visited);
+		free(nodes);
+		free(cursors);
 	}
 	return;
 }
@@ -343,11 +469,101 @@ void graph_clear_arches(graph* g) {
 
 	if(g) {
 
-		for (int i = 0; i < g->current_elements; i++)
-			for (int j = 0; j < g->current_elements; j++)
-				g->adjacency_matrix[i][j] = 0;
+		if (g->weights) {
+
+			for (size_t i = 0; i < g->current_elements; i++) memset(g->weights + i * g->capacity, 0, g->current_elements * sizeof(int));
+		}
+		else if (g->rows) {
+
+			for (size_t i = 0; i < g->current_elements; i++) bitset_unset_full(g->rows[i]);
+		}
 	}
 	return;
 }
 
+/**
+ * Doubles the capacity of the matrix until it has room for min_capacity nodes,
+ * rows and columns added are empty
+ */
+bool graph_util_grow(graph* g, size_t min_capacity) {
+
+	bool grown = false;
+	size_t capacity = g->capacity ? g->capacity : GRAPH_MATRIX_MIN_CAPACITY;
+
+	while (capacity < min_capacity && capacity <= SIZE_MAX / 2) capacity *= 2;
+
+	if (capacity >= min_capacity && capacity <= SIZE_MAX / capacity / sizeof(int)) {
+
+		if (g->flags & IS_WEIGHTED) {
+
+			int* weights = (int*)calloc(capacity * capacity, sizeof(int));
+			if (weights) {
+
+				for (size_t i = 0; i < g->current_elements; i++) memcpy(weights + i * capacity, g->weights + i * g->capacity, g->current_elements * sizeof(int));
+				free(g->weights);
+				g->weights = weights;
+				g->capacity = capacity;
+				grown = true;
+			}
+		}
+		else {
+
+			bitset** rows = (bitset**)realloc(g->rows, capacity * sizeof(bitset*));
+			if (rows) {
+
+				g->rows = rows;
+
+				// New rows are created first, so that a failure leaves the matrix as it was
+				size_t created = g->capacity;
+				while (created < capacity && (rows[created] = bitset_create(capacity))) created++;
+
+				if (created == capacity) {
+
+					for (size_t i = 0; i < g->capacity; i++) bitset_resize(rows[i], capacity);
+					g->capacity = capacity;
+					grown = true;
+				}
+				else {
+
+					while (created > g->capacity) bitset_delete(&rows[--created]);
+				}
+			}
+		}
+	}
+	return grown;
+}
+
+/**
+ * Returns the first node adjacent to i starting from j (included), current_elements if there's none
+ *
+ * Rows of unweighted graphs are scanned a word at a time
+ */
+size_t graph_util_next(graph* g, size_t i, size_t j) {
+
+	size_t next = g->current_elements;
+
+	if (g->weights) {
+
+		while (j < g->current_elements && !g->weights[i * g->capacity + j]) j++;
+		next = j;
+	}
+	else {
+
+		next = bitset_next_set(g->rows[i], j);
+		if (next > g->current_elements) next = g->current_elements;
+	}
+	return next;
+}
+
+/**
+ * Returns an (allocated) array with the values of the nodes, indexed like the matrix
+ */
+void** graph_util_values(graph* g) {
+
+	void** values = (void**)malloc(g->current_elements * sizeof(void*));
+
+	if (values) for (size_t i = 0; i < g->current_elements; i++) values[i] = ll_get_at(g->nodes, i);
+	return values;
+}
+
 #endif
\ No newline at end of file